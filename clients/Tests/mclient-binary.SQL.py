@@ -0,0 +1,87 @@
+import os, sys
+from MonetDBtesting import process
+
+host = os.getenv('HOST', 'localhost')
+port = os.getenv('MAPIPORT', 50000)
+db = os.getenv('TSTDB', 'demo')
+
+# every type that mclient's CSV renderer fetches in binary form, with
+# NULLs and extreme values in each column, and more rows than fit in
+# the reply to the query, so that the rest is fetched in binary chunks
+setup = '''
+create table bintypes (
+ ti tinyint, si smallint, i int, bi bigint, mi interval month,
+ se interval second, d1 decimal(2,1), d2 decimal(4,2), d4 decimal(9,3),
+ d8 decimal(18,6), r real, f double, b boolean, c char(3),
+ v varchar(20), s clob, j json, u url, dt date, tm time,
+ tm3 time(3), ts timestamp, ts0 timestamp(0), id uuid);
+insert into bintypes values
+ (null, null, null, null, null, null, null, null, null, null, null, null,
+  null, null, null, null, null, null, null, null, null, null, null, null),
+ (127, 32767, 2147483647, 9223372036854775807, interval '2147483647' month,
+  interval '86399.999' second, 9.9, 99.99, 999999.999,
+  999999999999.999999, 3.4e38, 1.7976931348623157e308, true, 'abc',
+  'with "quote"', 'tab	and
+newline', '{"a": [1, null]}', 'https://www.monetdb.org/',
+  date '9999-12-31', time '23:59:59', time '23:59:59.999',
+  timestamp '9999-12-31 23:59:59.999999', timestamp '1970-01-01 00:00:00',
+  'ffffffff-ffff-ffff-ffff-ffffffffffff'),
+ (-127, -32767, -2147483647, -9223372036854775807, interval '-1' month,
+  interval '-0.001' second, -9.9, -0.01, -0.001, -0.000001, -1.5e-38,
+  -4.9e-324, false, '', '', 'ĳssel Straße', '[]', '', date '-4712-01-01',
+  time '00:00:00', time '00:00:00.001', timestamp '1582-10-15 00:00:00',
+  timestamp '2000-02-29 12:00:00', '00000000-0000-0000-0000-000000000000');
+insert into bintypes select
+ value % 128, value % 32768, value * 101, value * 1000003,
+ (value % 120) * interval '1' month, value * interval '0.001' second,
+ (value % 100) * 0.1, (value % 10000) * 0.01, value * 0.001,
+ value * 0.000001, value / 7.0, value / 3.0, value % 2 = 0,
+ case when value % 11 = 0 then null else 'c' || value % 10 end,
+ 'v' || value, case when value % 13 = 0 then null else repeat('x', value % 50) end,
+ '{"n": ' || value || '}', 'http://h/' || value,
+ date '2000-01-01' + value * interval '1' day,
+ time '00:00:00' + value * interval '1' second,
+ time '00:00:00' + value * interval '0.001' second,
+ timestamp '2000-01-01 00:00:00' + value * interval '0.123456' second,
+ timestamp '2000-01-01 00:00:00' + value * interval '1' minute,
+ case when value % 17 = 0 then null else cast('12345678-1234-1234-1234-' || lpad(cast(value as varchar(12)), 12, '0') as uuid) end
+ from generate_series(0, 12000);
+'''
+
+queries = '''
+select * from bintypes;
+select ti, d2, tm3, ts, id from bintypes where i is null or i < 0 or i > 1000000;
+select v, count(*) as n, sum(d4), max(ts) from bintypes group by v order by v limit 5;
+select * from bintypes where false;
+'''
+
+def run(binary, sql):
+    with process.client('sql',
+                        dbname=f'monetdb://{host}:{port}/{db}?language=sql&user=monetdb&password=monetdb&binary={binary}',
+                        host='',
+                        port='',
+                        format='csv',
+                        echo=False,
+                        stdin=process.PIPE,
+                        stdout=process.PIPE,
+                        stderr=process.PIPE) as c:
+        out, err = c.communicate(sql)
+    if err:
+        print(err, file=sys.stderr)
+    return out
+
+run('off', setup)
+text = run('off', queries)
+binary = run('on', queries)
+if text != binary:
+    print('output with binary=on differs from binary=off')
+    for t, b in zip(text.splitlines(), binary.splitlines()):
+        if t != b:
+            print(f'off: {t}')
+            print(f'on:  {b}')
+            break
+    else:
+        print(f'{len(text.splitlines())} and {len(binary.splitlines())} lines')
+if len(text.splitlines()) != 12003 + 2102 + 5:
+    print(f'unexpected number of lines: {len(text.splitlines())}')
+run('off', 'drop table bintypes;\n')
@@ -0,0 +1,159 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * For copyright information, see the file debian/copyright.
+ */
+
+/* Send many queries with mapi_query_async before reading any reply,
+ * and check that every reply reaches the handle of its query.  The
+ * reply to the first query is larger than the socket buffers, so the
+ * server blocks writing it, and the other queries together are larger
+ * than the socket buffers as well, so a client that only reads replies
+ * after sending all queries would block forever. */
+
+#ifdef _MSC_VER
+/* suppress deprecation warning for snprintf */
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdbool.h>
+#include <inttypes.h>
+#include <mapi.h>
+
+#define die(dbh,hdl)	do {						\
+				if (hdl)				\
+					mapi_explain_result(hdl,stderr); \
+				else if (dbh)				\
+					mapi_explain(dbh,stderr);	\
+				else					\
+					fprintf(stderr,"command failed\n"); \
+				exit(-1);				\
+			} while (0)
+
+#define NQUERIES	250
+#define NROWS		4000	/* rows of the first query */
+#define ROWLEN		20000	/* length of the strings in those rows */
+#define QUERYLEN	262144	/* length of the other queries */
+#define FAILING		17	/* this query fails */
+
+static int ncallbacks;
+
+static void
+callback(MapiHdl hdl, void *data)
+{
+	(void) hdl;
+	if (*(int *) data != ncallbacks)
+		fprintf(stderr, "callback of query %d, expected %d\n",
+			*(int *) data, ncallbacks);
+	ncallbacks++;
+}
+
+static bool
+check_row(MapiHdl hdl, int i, const char *pad, int n)
+{
+	const char *value = mapi_fetch_field(hdl, 0);
+	const char *s = mapi_fetch_field(hdl, 1);
+
+	if (i == 0)
+		return value != NULL && atoi(value) == n &&
+			s != NULL && strncmp(s, pad, ROWLEN) == 0 &&
+			atoi(s + ROWLEN) == n;
+	return value != NULL && atoi(value) == i &&
+		s != NULL && atoi(s) == QUERYLEN;
+}
+
+int
+main(int argc, char **argv)
+{
+	Mapi dbh;
+	MapiHdl hdl = NULL, hdls[NQUERIES];
+	int ids[NQUERIES];
+	char *query, *pad;
+	size_t qlen = QUERYLEN + 200;
+
+	if (argc != 2) {
+		fprintf(stderr, "usage:%s <port>\n", argv[0]);
+		exit(-1);
+	}
+
+	dbh = mapi_connect("localhost", atoi(argv[1]), "monetdb", "monetdb", "sql", NULL);
+	if (dbh == NULL || mapi_error(dbh))
+		die(dbh, hdl);
+	/* all rows come with the reply */
+	if (mapi_cache_limit(dbh, -1) != MOK)
+		die(dbh, NULL);
+
+	if ((query = malloc(qlen)) == NULL || (pad = malloc(QUERYLEN + 1)) == NULL) {
+		fprintf(stderr, "out of memory\n");
+		exit(-1);
+	}
+	memset(pad, 'x', QUERYLEN);
+	pad[QUERYLEN] = 0;
+
+	for (int i = 0; i < NQUERIES; i++) {
+		ids[i] = i;
+		if (i == 0)
+			snprintf(query, qlen, "select value, '%.*s' || value from generate_series(0, %d)", ROWLEN, pad, NROWS);
+		else if (i == FAILING)
+			snprintf(query, qlen, "select cast('%s' as int)", pad);
+		else
+			snprintf(query, qlen, "select %d, length('%s')", i, pad);
+		if ((hdls[i] = mapi_query_async(dbh, query, callback, &ids[i])) == NULL ||
+		    mapi_error(dbh))
+			die(dbh, hdls[i]);
+	}
+
+	while ((hdl = mapi_poll(dbh)) != NULL) {
+		if (hdl != hdls[ncallbacks - 1])
+			fprintf(stderr, "mapi_poll returned the wrong handle\n");
+	}
+	if (mapi_error(dbh))
+		die(dbh, NULL);
+	if (ncallbacks != NQUERIES)
+		fprintf(stderr, "%d callbacks for %d queries\n", ncallbacks, NQUERIES);
+
+	for (int i = 0; i < NQUERIES; i++) {
+		int n = 0, nrows = i == 0 ? NROWS : 1;
+
+		hdl = hdls[i];
+		if (i == FAILING) {
+			if (mapi_result_error(hdl) == NULL)
+				fprintf(stderr, "query %d should have failed\n", i);
+		} else if (mapi_result_error(hdl) != NULL) {
+			fprintf(stderr, "query %d failed: %s\n", i, mapi_result_error(hdl));
+		} else {
+			while (mapi_fetch_row(hdl)) {
+				if (!check_row(hdl, i, pad, n)) {
+					fprintf(stderr, "wrong row %d of query %d\n", n, i);
+					break;
+				}
+				n++;
+			}
+			if (n != nrows)
+				fprintf(stderr, "query %d: %d rows instead of %d\n", i, n, nrows);
+		}
+		if (mapi_close_handle(hdl) != MOK)
+			die(dbh, hdl);
+	}
+
+	/* the connection is still usable for synchronous queries */
+	if ((hdl = mapi_query(dbh, "select 42")) == NULL || mapi_error(dbh))
+		die(dbh, hdl);
+	if (mapi_fetch_row(hdl) == 0 || strcmp(mapi_fetch_field(hdl, 0), "42") != 0)
+		fprintf(stderr, "wrong result of synchronous query\n");
+	if (mapi_close_handle(hdl) != MOK)
+		die(dbh, hdl);
+
+	free(query);
+	free(pad);
+	mapi_destroy(dbh);
+
+	return 0;
+}
@@ -0,0 +1,190 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * For copyright information, see the file debian/copyright.
+ */
+
+/* Connect over the UNIX domain socket with shared_memory=true and check
+ * that a result larger than the ring for the results, an upload larger
+ * than the ring for the queries, and an interrupted query all work, and
+ * that the connection is still usable afterwards. */
+
+#include "monetdb_config.h"
+#include "stream.h"
+#include "mapi.h"
+
+#define die(dbh,hdl)	do {						\
+				if (hdl)				\
+					mapi_explain_result(hdl,stderr); \
+				else if (dbh)				\
+					mapi_explain(dbh,stderr);	\
+				else					\
+					fprintf(stderr,"command failed\n"); \
+				exit(-1);				\
+			} while (0)
+
+#define NROWS		100000	/* rows of the result, about 11 MB */
+#define ROWLEN		100	/* length of the padding in those rows */
+#define NLINES		400000	/* lines of the upload, about 5 MB */
+
+struct upload {
+	int line;
+	char buf[8192];
+};
+
+static char *
+getfile(void *priv, const char *filename, bool binary, uint64_t offset, size_t *size)
+{
+	struct upload *u = priv;
+	size_t len = 0;
+
+	(void) binary;
+	(void) offset;
+	if (size == NULL)
+		return NULL;
+	if (filename != NULL)
+		u->line = 0;
+	while (u->line < NLINES && len < sizeof(u->buf) - 32) {
+		len += (size_t) snprintf(u->buf + len, sizeof(u->buf) - len,
+					 "%d|line %d\n", u->line, u->line);
+		u->line++;
+	}
+	*size = len;
+	return len > 0 ? u->buf : NULL;
+}
+
+static bool interrupt;
+
+static bool
+interrupted(void *data)
+{
+	Mapi dbh = data;
+
+	if (interrupt) {
+		interrupt = false;
+		mnstr_set_error(mapi_get_from(dbh), MNSTR_INTERRUPT, NULL);
+		return true;
+	}
+	return false;
+}
+
+static void
+query(Mapi dbh, const char *q)
+{
+	MapiHdl hdl;
+
+	if ((hdl = mapi_query(dbh, q)) == NULL || mapi_error(dbh))
+		die(dbh, hdl);
+	if (mapi_result_error(hdl) != NULL)
+		fprintf(stderr, "%s failed: %s\n", q, mapi_result_error(hdl));
+	if (mapi_close_handle(hdl) != MOK)
+		die(dbh, hdl);
+}
+
+static void
+check_value(Mapi dbh, const char *q, const char *expected)
+{
+	MapiHdl hdl;
+	const char *value;
+
+	if ((hdl = mapi_query(dbh, q)) == NULL || mapi_error(dbh))
+		die(dbh, hdl);
+	if (mapi_fetch_row(hdl) == 0 || (value = mapi_fetch_field(hdl, 0)) == NULL)
+		fprintf(stderr, "%s: no result\n", q);
+	else if (strcmp(value, expected) != 0)
+		fprintf(stderr, "%s: %s instead of %s\n", q, value, expected);
+	if (mapi_close_handle(hdl) != MOK)
+		die(dbh, hdl);
+}
+
+int
+main(int argc, char **argv)
+{
+	Mapi dbh;
+	MapiHdl hdl = NULL;
+	char url[1024], pad[ROWLEN + 1];
+	struct upload u;
+	int n = 0;
+
+	if (argc != 4) {
+		fprintf(stderr, "usage:%s <port> <socket directory> <database>\n", argv[0]);
+		exit(-1);
+	}
+
+	snprintf(url, sizeof(url), "monetdb:///%s?sock=%s/.s.monetdb.%s&shared_memory=true",
+		 argv[3], argv[2], argv[1]);
+	dbh = mapi_mapiuri(url, "monetdb", "monetdb", "sql");
+	if (dbh == NULL || mapi_error(dbh) || mapi_reconnect(dbh) != MOK)
+		die(dbh, hdl);
+	/* all rows come with the reply */
+	if (mapi_cache_limit(dbh, -1) != MOK)
+		die(dbh, NULL);
+
+#ifdef __linux__
+	/* the segment must really be there, we don't want to silently
+	 * test the socket */
+	FILE *maps = fopen("/proc/self/maps", "r");
+	bool found = false;
+	if (maps != NULL) {
+		char line[1024];
+		while (!found && fgets(line, sizeof(line), maps) != NULL)
+			found = strstr(line, "monetdb-mapi") != NULL;
+		fclose(maps);
+	}
+	if (!found)
+		fprintf(stderr, "no shared memory segment mapped\n");
+#endif
+
+	/* a result larger than the ring */
+	memset(pad, 'x', ROWLEN);
+	pad[ROWLEN] = 0;
+	snprintf(url, sizeof(url), "select value, repeat('x', %d) || value from generate_series(0, %d)", ROWLEN, NROWS);
+	if ((hdl = mapi_query(dbh, url)) == NULL || mapi_error(dbh))
+		die(dbh, hdl);
+	while (mapi_fetch_row(hdl)) {
+		const char *value = mapi_fetch_field(hdl, 0);
+		const char *s = mapi_fetch_field(hdl, 1);
+		if (value == NULL || atoi(value) != n ||
+		    s == NULL || strncmp(s, pad, ROWLEN) != 0 || atoi(s + ROWLEN) != n) {
+			fprintf(stderr, "wrong row %d\n", n);
+			break;
+		}
+		n++;
+	}
+	if (n != NROWS)
+		fprintf(stderr, "%d rows instead of %d\n", n, NROWS);
+	if (mapi_close_handle(hdl) != MOK)
+		die(dbh, hdl);
+
+	/* an upload larger than the ring */
+	mapi_setfilecallback2(dbh, getfile, NULL, &u);
+	query(dbh, "create temporary table shmupload (i int, s varchar(20)) on commit preserve rows");
+	query(dbh, "copy into shmupload from 'data' on client");
+	check_value(dbh, "select count(*) from shmupload", "400000");
+	check_value(dbh, "select sum(i) from shmupload where s = 'line ' || i", "79999800000");
+	query(dbh, "drop table shmupload");
+
+	/* interrupt a query while it runs */
+	query(dbh, "create or replace function sleep(msecs int) returns int external name alarm.sleep");
+	if (mapi_set_rtimeout(dbh, 100, interrupted, dbh) != MOK)
+		die(dbh, NULL);
+	interrupt = true;
+	if ((hdl = mapi_query(dbh, "select sleep(1000)")) == NULL)
+		die(dbh, hdl);
+	if (mapi_result_error(hdl) == NULL)
+		fprintf(stderr, "the query was not interrupted\n");
+	if (mapi_close_handle(hdl) != MOK)
+		die(dbh, hdl);
+	query(dbh, "drop function sleep");
+
+	/* the connection is still usable */
+	check_value(dbh, "select 42", "42");
+
+	mapi_destroy(dbh);
+
+	return 0;
+}
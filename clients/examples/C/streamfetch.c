@@ -0,0 +1,188 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * For copyright information, see the file debian/copyright.
+ */
+
+/* Fetch result sets that are much larger than a stream buffer once
+ * with and once without streaming, and check that the rows are the
+ * same.  Only plans run by the pipeline engine are streamed, so the
+ * server needs --pipeline, and the queries are unions and semijoins.
+ * The order of the rows of different morsels may differ between runs,
+ * so the rows are compared after sorting them. */
+
+#ifdef _MSC_VER
+/* suppress deprecation warning for snprintf */
+#define _CRT_SECURE_NO_WARNINGS
+#endif
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+#include <mapi.h>
+
+#define die(dbh,hdl)	do {						\
+				if (hdl)				\
+					mapi_explain_result(hdl,stderr); \
+				else if (dbh)				\
+					mapi_explain(dbh,stderr);	\
+				else					\
+					fprintf(stderr,"command failed\n"); \
+				exit(-1);				\
+			} while (0)
+
+struct result {
+	char *buf;
+	size_t len, size;
+	int64_t rows;
+};
+
+static int
+cmpline(const void *a, const void *b)
+{
+	return strcmp(*(char *const *) a, *(char *const *) b);
+}
+
+/* sort the rows of r in place */
+static void
+sortrows(struct result *r)
+{
+	char **lines, *buf, *p;
+	int64_t i;
+
+	if (r->rows == 0)
+		return;
+	if ((lines = malloc(r->rows * sizeof(char *))) == NULL ||
+	    (buf = malloc(r->len + 1)) == NULL) {
+		fprintf(stderr, "out of memory\n");
+		exit(-1);
+	}
+	memcpy(buf, r->buf, r->len);
+	buf[r->len] = 0;
+	for (i = 0, p = buf; i < r->rows; i++) {
+		lines[i] = p;
+		p = strchr(p, '\n');
+		*p++ = 0;
+	}
+	qsort(lines, r->rows, sizeof(char *), cmpline);
+	for (i = 0, p = r->buf; i < r->rows; i++) {
+		size_t l = strlen(lines[i]);
+		memcpy(p, lines[i], l);
+		p += l;
+		*p++ = '\n';
+	}
+	free(lines);
+	free(buf);
+}
+
+static void
+append(struct result *r, const char *s)
+{
+	size_t l = s ? strlen(s) : 4;
+
+	if (r->len + l + 2 > r->size) {
+		r->size = (r->len + l + 2) * 2;
+		if ((r->buf = realloc(r->buf, r->size)) == NULL) {
+			fprintf(stderr, "out of memory\n");
+			exit(-1);
+		}
+	}
+	memcpy(r->buf + r->len, s ? s : "NULL", l);
+	r->len += l;
+}
+
+static struct result
+run(Mapi dbh, const char *query)
+{
+	MapiHdl hdl;
+	struct result r = {0};
+	int fields;
+
+	if ((hdl = mapi_query(dbh, query)) == NULL || mapi_error(dbh))
+		die(dbh, hdl);
+	while ((fields = mapi_fetch_row(hdl)) != 0) {
+		for (int i = 0; i < fields; i++) {
+			append(&r, mapi_fetch_field(hdl, i));
+			append(&r, i < fields - 1 ? "|" : "\n");
+		}
+		r.rows++;
+	}
+	if (mapi_error(dbh))
+		die(dbh, hdl);
+	if (mapi_get_row_count(hdl) != r.rows)
+		fprintf(stderr, "row count %" PRId64 " but %" PRId64 " rows fetched: %s\n",
+			mapi_get_row_count(hdl), r.rows, query);
+	if (mapi_close_handle(hdl) != MOK)
+		die(dbh, hdl);
+	return r;
+}
+
+static const char *queries[] = {
+	"select * from streamfetch union all select * from streamfetch",
+	"select i, s, d * 2, i % 7 = 0 from streamfetch where i in (select i from streamfetch where i % 3 <> 1)",
+	"select s from streamfetch where i < 10 union all select s from streamfetch where i > 299990",
+	"select i from streamfetch where i < 0 union all select i from streamfetch where i < 0",
+};
+
+int
+main(int argc, char **argv)
+{
+	Mapi dbh;
+	MapiHdl hdl = NULL;
+
+	if (argc != 2) {
+		fprintf(stderr, "usage:%s <port>\n", argv[0]);
+		exit(-1);
+	}
+
+	dbh = mapi_connect("localhost", atoi(argv[1]), "monetdb", "monetdb", "sql", NULL);
+	if (dbh == NULL || mapi_error(dbh))
+		die(dbh, hdl);
+
+	if ((hdl = mapi_query(dbh, "create table streamfetch (i int, s varchar(100), d decimal(12,3))")) == NULL || mapi_error(dbh))
+		die(dbh, hdl);
+	if (mapi_close_handle(hdl) != MOK)
+		die(dbh, hdl);
+	if ((hdl = mapi_query(dbh, "insert into streamfetch select value, case when value % 10 = 0 then null else 'row ' || value || repeat('.', value % 40) end, value / 8.0 from generate_series(0, 300000)")) == NULL || mapi_error(dbh))
+		die(dbh, hdl);
+	if (mapi_close_handle(hdl) != MOK)
+		die(dbh, hdl);
+
+	for (size_t q = 0; q < sizeof(queries) / sizeof(queries[0]); q++) {
+		struct result plain, streamed;
+
+		if (mapi_set_streaming(dbh, false) != MOK)
+			die(dbh, NULL);
+		plain = run(dbh, queries[q]);
+		if (mapi_set_streaming(dbh, true) != MOK)
+			die(dbh, NULL);
+		streamed = run(dbh, queries[q]);
+		sortrows(&plain);
+		sortrows(&streamed);
+		if (plain.rows != streamed.rows ||
+		    plain.len != streamed.len ||
+		    (plain.len > 0 && memcmp(plain.buf, streamed.buf, plain.len) != 0))
+			fprintf(stderr, "streamed result differs: %s\n"
+				"%" PRId64 " rows, %zu bytes without streaming, "
+				"%" PRId64 " rows, %zu bytes with\n",
+				queries[q], plain.rows, plain.len,
+				streamed.rows, streamed.len);
+		free(plain.buf);
+		free(streamed.buf);
+	}
+
+	if (mapi_set_streaming(dbh, false) != MOK)
+		die(dbh, NULL);
+	if ((hdl = mapi_query(dbh, "drop table streamfetch")) == NULL || mapi_error(dbh))
+		die(dbh, hdl);
+	if (mapi_close_handle(hdl) != MOK)
+		die(dbh, hdl);
+	mapi_destroy(dbh);
+
+	return 0;
+}
@@ -1728,6 +1728,79 @@ describe_schema(Mapi mid, const char *sname, stream *sqlf)
 	return 0;
 }
 
+/* write one row of table data, either as INSERT statement or as a
+ * line of COPY INTO data */
+static void
+dump_row(stream *datf, MapiHdl hdl, const char *schema, const char *tname,
+		 int cnt, const char **values, const unsigned char *string,
+		 bool useInserts, bool noescape)
+{
+	int i;
+
+	if (useInserts) {
+		mnstr_printf(datf, "INSERT INTO ");
+		dquoted_print(datf, schema, ".");
+		dquoted_print(datf, tname, " VALUES (");
+	}
+
+	for (i = 0; i < cnt; i++) {
+		const char *tp = mapi_get_type(hdl, i);
+		const char *s = values[i];
+		if (s == NULL)
+			mnstr_printf(datf, "NULL");
+		else if (useInserts) {
+			if (strcmp(tp, "day_interval") == 0 || strcmp(tp, "sec_interval") == 0) {
+				const char *p = strchr(s, '.');
+				if (p == NULL)
+					p = s + strlen(s);
+				mnstr_printf(datf, "INTERVAL '%.*s' SECOND", (int) (p - s), s);
+			} else if (strcmp(tp, "month_interval") == 0)
+				mnstr_printf(datf, "INTERVAL '%s' MONTH", s);
+			else if (strcmp(tp, "timestamptz") == 0)
+				mnstr_printf(datf, "TIMESTAMP WITH TIME ZONE '%s'", s);
+			else if (strcmp(tp, "timestamp") == 0)
+				mnstr_printf(datf, "TIMESTAMP '%s'", s);
+			else if (strcmp(tp, "timetz") == 0)
+				mnstr_printf(datf, "TIME WITH TIME ZONE '%s'", s);
+			else if (strcmp(tp, "time") == 0)
+				mnstr_printf(datf, "TIME '%s'", s);
+			else if (strcmp(tp, "date") == 0)
+				mnstr_printf(datf, "DATE '%s'", s);
+			else if (strcmp(tp, "blob") == 0)
+				mnstr_printf(datf, "BINARY LARGE OBJECT '%s'", s);
+			else if (strcmp(tp, "inet") == 0 ||
+				 strcmp(tp, "json") == 0 ||
+				 strcmp(tp, "url") == 0 ||
+				 strcmp(tp, "uuid") == 0 ||
+				 string[i])
+				squoted_print(datf, s, '\'', false);
+			else
+				mnstr_printf(datf, "%s", s);
+		} else if (string[i]) {
+			/* write double-quoted string with
+			   certain characters escaped */
+			squoted_print(datf, s, '"', noescape);
+		} else if (strcmp(tp, "blob") == 0) {
+			/* inside blobs, special characters
+			   don't occur */
+			mnstr_printf(datf, "\"%s\"", s);
+		} else
+			mnstr_printf(datf, "%s", s);
+
+		if (useInserts) {
+			if (i < cnt - 1)
+				mnstr_printf(datf, ", ");
+			else
+				mnstr_printf(datf, ");\n");
+		} else {
+			if (i < cnt - 1)
+				mnstr_write(datf, "\t", 1, 1);
+			else
+				mnstr_write(datf, "\n", 1, 1);
+		}
+	}
+}
+
 static int
 dump_table_data(Mapi mid, const char *schema, const char *tname,
 				stream *sqlf, const char *ddir, const char *ext,
@@ -1739,6 +1812,7 @@ dump_table_data(Mapi mid, const char *schema, const char *tname,
 	char *query = NULL;
 	size_t maxquerylen;
 	unsigned char *string = NULL;
+	const char **values = NULL;
 	char *s, *t;
 	stream *datf = sqlf;
 
@@ -1860,77 +1934,39 @@ dump_table_data(Mapi mid, const char *schema, const char *tname,
 			     strcmp(tp, "url") == 0 ||
 			     strcmp(tp, "xml") == 0);
 	}
-	while (mapi_fetch_row(hdl)) {
-		const char *s;
-
-		if (useInserts) {
-			mnstr_printf(datf, "INSERT INTO ");
-			dquoted_print(datf, schema, ".");
-			dquoted_print(datf, tname, " VALUES (");
-		}
-
-		for (i = 0; i < cnt; i++) {
-			const char *tp = mapi_get_type(hdl, i);
-			s = mapi_fetch_field(hdl, i);
-			if (s == NULL)
-				mnstr_printf(datf, "NULL");
-			else if (useInserts) {
-				if (strcmp(tp, "day_interval") == 0 || strcmp(tp, "sec_interval") == 0) {
-					const char *p = strchr(s, '.');
-					if (p == NULL)
-						p = s + strlen(s);
-					mnstr_printf(datf, "INTERVAL '%.*s' SECOND", (int) (p - s), s);
-				} else if (strcmp(tp, "month_interval") == 0)
-					mnstr_printf(datf, "INTERVAL '%s' MONTH", s);
-				else if (strcmp(tp, "timestamptz") == 0)
-					mnstr_printf(datf, "TIMESTAMP WITH TIME ZONE '%s'", s);
-				else if (strcmp(tp, "timestamp") == 0)
-					mnstr_printf(datf, "TIMESTAMP '%s'", s);
-				else if (strcmp(tp, "timetz") == 0)
-					mnstr_printf(datf, "TIME WITH TIME ZONE '%s'", s);
-				else if (strcmp(tp, "time") == 0)
-					mnstr_printf(datf, "TIME '%s'", s);
-				else if (strcmp(tp, "date") == 0)
-					mnstr_printf(datf, "DATE '%s'", s);
-				else if (strcmp(tp, "blob") == 0)
-					mnstr_printf(datf, "BINARY LARGE OBJECT '%s'", s);
-				else if (strcmp(tp, "inet") == 0 ||
-					 strcmp(tp, "json") == 0 ||
-					 strcmp(tp, "url") == 0 ||
-					 strcmp(tp, "uuid") == 0 ||
-					 string[i])
-					squoted_print(datf, s, '\'', false);
-				else
-					mnstr_printf(datf, "%s", s);
-			} else if (string[i]) {
-				/* write double-quoted string with
-				   certain characters escaped */
-				squoted_print(datf, s, '"', noescape);
-			} else if (strcmp(tp, "blob") == 0) {
-				/* inside blobs, special characters
-				   don't occur */
-				mnstr_printf(datf, "\"%s\"", s);
-			} else
-				mnstr_printf(datf, "%s", s);
-
-			if (useInserts) {
-				if (i < cnt - 1)
-					mnstr_printf(datf, ", ");
-				else
-					mnstr_printf(datf, ");\n");
-			} else {
-				if (i < cnt - 1)
-					mnstr_write(datf, "\t", 1, 1);
-				else
-					mnstr_write(datf, "\n", 1, 1);
+	values = malloc(sizeof(*values) * cnt);
+	if (values == NULL)
+		goto bailout;
+#ifndef COMPILING_MONETDBE
+	if (mapi_can_fetch_columns(hdl)) {
+		/* fetch the data in binary form, which saves the server
+		 * the conversion to text */
+		int64_t n;
+
+		while ((n = mapi_fetch_columns(hdl)) > 0) {
+			for (int64_t r = 0; r < n; r++) {
+				for (i = 0; i < cnt; i++)
+					values[i] = mapi_fetch_column_field(hdl, i, r);
+				dump_row(datf, hdl, schema, tname, cnt, values, string, useInserts, noescape);
+				if (mnstr_errnr(datf) != MNSTR_NO__ERROR)
+					goto bailout;
 			}
 		}
+		if (n < 0)
+			goto bailout;
+	} else
+#endif
+	while (mapi_fetch_row(hdl)) {
+		for (i = 0; i < cnt; i++)
+			values[i] = mapi_fetch_field(hdl, i);
+		dump_row(datf, hdl, schema, tname, cnt, values, string, useInserts, noescape);
 		if (mnstr_errnr(datf) != MNSTR_NO__ERROR)
 			goto bailout;
 	}
 	if (mapi_error(mid))
 		goto bailout;
 	free(string);
+	free(values);
 
   doreturn:
 	if (datf != sqlf)
@@ -1960,6 +1996,8 @@ bailout:
 		free(query);
 	if (string != NULL)
 		free(string);
+	if (values != NULL)
+		free(values);
 	return 1;
 }
 
@@ -793,6 +793,44 @@ EXPANDEDrenderer(MapiHdl hdl)
 	mnstr_flush(toConsole, MNSTR_FLUSH_DATA);
 }
 
+static void
+CSVfield(const char *s, int i, const char *specials)
+{
+	if (!noquote && s != NULL && s[strcspn(s, specials)] != '\0') {
+		mnstr_printf(toConsole, "%s\"",
+			     i == 0 ? "" : separator);
+		while (*s) {
+			switch (*s) {
+			case '\n':
+				mnstr_write(toConsole, "\\n", 1, 2);
+				break;
+			case '\t':
+				mnstr_write(toConsole, "\\t", 1, 2);
+				break;
+			case '\r':
+				mnstr_write(toConsole, "\\r", 1, 2);
+				break;
+			case '\\':
+				mnstr_write(toConsole, "\\\\", 1, 2);
+				break;
+			case '"':
+				mnstr_write(toConsole, "\"\"", 1, 2);
+				break;
+			default:
+				mnstr_write(toConsole, s, 1, 1);
+				break;
+			}
+			s++;
+		}
+		mnstr_write(toConsole, "\"", 1, 1);
+	} else {
+		if (s == NULL)
+			s = nullstring == default_nullstring ? "" : nullstring;
+		mnstr_printf(toConsole, "%s%s",
+			     i == 0 ? "" : separator, s);
+	}
+}
+
 static void
 CSVrenderer(MapiHdl hdl)
 {
@@ -811,43 +849,28 @@ CSVrenderer(MapiHdl hdl)
 		}
 		mnstr_printf(toConsole, "\n");
 	}
-	while (mnstr_errnr(toConsole) == MNSTR_NO__ERROR && (fields = mapi_fetch_row(hdl)) != 0) {
-		for (i = 0; i < fields; i++) {
-			s = mapi_fetch_field(hdl, i);
-			if (!noquote && s != NULL && s[strcspn(s, specials)] != '\0') {
-				mnstr_printf(toConsole, "%s\"",
-					     i == 0 ? "" : separator);
-				while (*s) {
-					switch (*s) {
-					case '\n':
-						mnstr_write(toConsole, "\\n", 1, 2);
-						break;
-					case '\t':
-						mnstr_write(toConsole, "\\t", 1, 2);
-						break;
-					case '\r':
-						mnstr_write(toConsole, "\\r", 1, 2);
-						break;
-					case '\\':
-						mnstr_write(toConsole, "\\\\", 1, 2);
-						break;
-					case '"':
-						mnstr_write(toConsole, "\"\"", 1, 2);
-						break;
-					default:
-						mnstr_write(toConsole, s, 1, 1);
-						break;
-					}
-					s++;
-				}
-				mnstr_write(toConsole, "\"", 1, 1);
-			} else {
-				if (s == NULL)
-					s = nullstring == default_nullstring ? "" : nullstring;
-				mnstr_printf(toConsole, "%s%s",
-					     i == 0 ? "" : separator, s);
+	if (mapi_can_fetch_columns(hdl)) {
+		/* large extracts are typically written as CSV, so avoid
+		 * the text conversion on the server */
+		int64_t rows = 0;
+
+		fields = mapi_get_field_count(hdl);
+		while (mnstr_errnr(toConsole) == MNSTR_NO__ERROR && (rows = mapi_fetch_columns(hdl)) > 0) {
+			for (int64_t r = 0; r < rows && mnstr_errnr(toConsole) == MNSTR_NO__ERROR; r++) {
+				for (i = 0; i < fields; i++)
+					CSVfield(mapi_fetch_column_field(hdl, i, r), i, specials);
+				mnstr_printf(toConsole, "\n");
 			}
 		}
+		if (rows < 0) {
+			mapi_explain_query(hdl, stderr);
+			errseen = true;
+		}
+		return;
+	}
+	while (mnstr_errnr(toConsole) == MNSTR_NO__ERROR && (fields = mapi_fetch_row(hdl)) != 0) {
+		for (i = 0; i < fields; i++)
+			CSVfield(mapi_fetch_field(hdl, i), i, specials);
 		mnstr_printf(toConsole, "\n");
 	}
 }
@@ -3027,7 +3050,7 @@ doFile(Mapi mid, stream *fp, bool useinserts, bool interactive, bool save_histor
 						bool istrash = formatter == TRASHformatter;
 						setFormatter(line);
 						if (mode == SQL)
-							mapi_set_size_header(mid, strcmp(line, "raw") == 0);
+							mapi_set_size_header(mid, strcmp(line, "raw") == 0 || formatter == CSVformatter);
 						if (istrash != (formatter == TRASHformatter)) {
 							mapi_cache_limit(mid, formatter == TRASHformatter ? 100 : CACHELIMIT);
 						}
@@ -3852,7 +3875,7 @@ main(int argc, char **argv)
 	if (output) {
 		setFormatter(output);
 		if (mode == SQL)
-			mapi_set_size_header(mid, strcmp(output, "raw") == 0);
+			mapi_set_size_header(mid, strcmp(output, "raw") == 0 || formatter == CSVformatter);
 		mapi_cache_limit(mid, formatter == TRASHformatter ? 100 : CACHELIMIT);
 	} else {
 		if (mode == SQL) {
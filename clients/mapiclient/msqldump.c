@@ -246,6 +246,8 @@ main(int argc, char **argv)
 		exit(2);
 	}
 	mapi_set_time_zone(mid, 0);
+	/* the type sizes let us fetch table data in binary form */
+	mapi_set_size_header(mid, true);
 	mapi_reconnect(mid);
 	if (mapi_error(mid)) {
 		mapi_explain(mid, stderr);
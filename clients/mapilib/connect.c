@@ -47,7 +47,7 @@ static MapiMsg scan_sockets(Mapi mid);
 static MapiMsg connect_socket(Mapi mid);
 static MapiMsg connect_socket_tcp(Mapi mid);
 static SOCKET connect_socket_tcp_addr(Mapi mid, struct addrinfo *addr);
-static MapiMsg mapi_handshake(Mapi mid);
+static MapiMsg mapi_handshake(Mapi mid, bool proxied);
 
 #ifndef HAVE_OPENSSL
 // The real implementation is in connect_openssl.c.
@@ -128,19 +128,23 @@ establish_connection(Mapi mid)
 	}
 
 	MapiMsg msg = MREDIRECT;
+	bool proxied = false;
 	while (msg == MREDIRECT) {
 		// Generally at this point we need to set up a new TCP or Unix
 		// domain connection.
 		//
 		// The only exception is if mapi_handshake() below has decided
 		// that the handshake must be restarted on the existing
-		// connection.
+		// connection.  In that case monetdbd proxies the connection.
 		if (!mid->connected) {
 			msg = connect_socket(mid);
 			if (msg != MOK)
 				return msg;
+			proxied = false;
+		} else {
+			proxied = true;
 		}
-		msg = mapi_handshake(mid);
+		msg = mapi_handshake(mid, proxied);
 	}
 
 	// Switch from MP_CONNECT_TIMEOUT to MP_REPLY_TIMEOUT
@@ -452,8 +456,42 @@ send_all_clientinfo(Mapi mid)
 	free(free_this);
 }
 
+/* Return whether name occurs in the comma separated list. */
+static bool
+in_list(const char *list, const char *name)
+{
+	size_t len = strlen(name);
+
+	for (const char *p = list; p != NULL; p = strchr(p, ',')) {
+		if (*p == ',')
+			p++;
+		if (strncmp(p, name, len) == 0 && (p[len] == ',' || p[len] == '\0'))
+			return true;
+	}
+	return false;
+}
+
+/* Pick the block compression to ask for, given the wire_compression
+ * setting and the methods offered by the server, or NULL for none. */
+static const char *
+choose_compression(const char *wanted, const char *offered)
+{
+	static const char *const methods[] = { "zstd", "lz4", };
+	int on = msetting_parse_bool(wanted);
+
+	if (*wanted == '\0' || on == 0)
+		return NULL;
+	for (size_t i = 0; i < NELEM(methods); i++) {
+		if ((on == 1 || strcmp(wanted, methods[i]) == 0)
+			&& in_list(block_stream_compressors(), methods[i])
+			&& in_list(offered, methods[i]))
+			return methods[i];
+	}
+	return NULL;
+}
+
 static MapiMsg
-mapi_handshake(Mapi mid)
+mapi_handshake(Mapi mid, bool proxied)
 {
 	char buf[BLOCK];
 	size_t len;
@@ -561,9 +599,19 @@ mapi_handshake(Mapi mid)
 		}
 	}
 
-	/* skip the binary option */
+	/* binary result set chunks are sent in the server's byte order,
+	 * we only ask for them if that is also ours */
 	char *binary = strtok_r(NULL, ":", &strtok_state);
-	(void)binary;
+	int binlevel = 0;
+	if (binary == NULL || sscanf(binary, "BINARY=%d", &binlevel) != 1)
+		binlevel = 0;
+#ifdef WORDS_BIGENDIAN
+	mid->binary = binlevel > 0 && strcmp(byteo, "BIG") == 0;
+#else
+	mid->binary = binlevel > 0 && strcmp(byteo, "LIT") == 0;
+#endif
+	if (msettings_connect_binary(mid->settings) <= 0)
+		mid->binary = false;
 
 	char *oobintr = strtok_r(NULL, ":", &strtok_state);
 	if (oobintr) {
@@ -579,6 +627,29 @@ mapi_handshake(Mapi mid)
 		}
 	}
 
+	char *compress = NULL;
+	bool shm_offered = false;
+	for (char *opt; (opt = strtok_r(NULL, ":", &strtok_state)) != NULL; ) {
+		if (strncmp(opt, "COMPRESS=", 9) == 0)
+			compress = opt + 9;
+		else if (strcmp(opt, "SHM") == 0)
+			shm_offered = true;
+	}
+
+	/* monetdbd unpacks and repacks the blocks it proxies, so it would
+	 * choke on compressed ones, and it is monetdbd and not the server
+	 * at the other end of our socket.  There is no point in
+	 * compressing what goes through shared memory. */
+	bool shm = shm_offered && !proxied &&
+		msetting_bool(mid->settings, MP_SHARED_MEMORY) &&
+		block_stream_shm_possible(mid->to);
+	const char *compression = NULL;
+	if (compress && !proxied && !shm) {
+		compression = choose_compression(
+			msetting_string(mid->settings, MP_WIRE_COMPRESSION),
+			compress);
+	}
+
 	/* hash password, if not already */
 	if (password[0] != '\1') {
 		char *pwdhash = NULL;
@@ -715,6 +786,12 @@ mapi_handshake(Mapi mid)
 	if (mid->handshake_options > 0) {
 		CHECK_SNPRINTF(":");
 	}
+	if (compression) {
+		CHECK_SNPRINTF("COMPRESS=%s:", compression);
+	}
+	if (shm) {
+		CHECK_SNPRINTF("SHM:");
+	}
 	CHECK_SNPRINTF("\n");
 
 	free(hash);
@@ -726,6 +803,31 @@ mapi_handshake(Mapi mid)
 	len = mnstr_flush(mid->to, MNSTR_FLUSH_DATA);
 	check_stream(mid, mid->to, len, "Could not send initial byte sequence", mid->error);
 
+	/* the server switches right after reading our response */
+	if (compression) {
+		if (block_stream_compress(mid->from, compression) < 0 ||
+			block_stream_compress(mid->to, compression) < 0) {
+			close_connection(mid);
+			return mapi_printError(mid, __func__, MERROR,
+					       "cannot enable %s compression", compression);
+		}
+		mapi_log_record(mid, "HANDSHAKE", "Using %s compression", compression);
+	}
+	/* the server answers with the shared memory segment, or without
+	 * one if it could not create it */
+	if (shm) {
+		switch (block_stream_shm_accept(mid->from, mid->to)) {
+		case -1:
+			snprintf(buf, sizeof(buf), "cannot set up shared memory: %s",
+					 mnstr_peek_error(mid->from));
+			close_connection(mid);
+			return mapi_setError(mid, buf, __func__, MERROR);
+		case 1:
+			mapi_log_record(mid, "HANDSHAKE", "Using shared memory");
+			break;
+		}
+	}
+
 	// Clear the redirects before we receive new ones
 	for (char **r = mid->redirects; *r != NULL; r++) {
 		free(*r);
@@ -884,6 +986,11 @@ mapi_handshake(Mapi mid)
 		if (result != MOK)
 			return mid->error;
 	}
+	if (mid->streaming) {
+		MapiMsg result = mapi_Xcommand(mid, "streaming", "1");
+		if (result != MOK)
+			return mid->error;
+	}
 	// There is no if  (mid->handshake_options <= MAPI_HANDSHAKE_COLUMNAR_PROTOCOL && mid->columnar_protocol != MapiStructDefaults.columnar_protocol)
 	// The reason is that columnar_protocol is very new. If it isn't supported in the handshake it isn't supported at
 	// all so sending the Xcommand would just give an error.
@@ -271,6 +271,8 @@
  * @item mapi_explain()	@tab	Display error message and context on stream
  * @item mapi_explain_query()	@tab	Display error message and context on stream
  * @item mapi_fetch_all_rows()	@tab	Fetch all answers from server into cache
+ * @item mapi_fetch_columns()	@tab	Fetch the next chunk of rows in binary columnar form
+ * @item mapi_fetch_column_field()	@tab Format a value of the current chunk
  * @item mapi_fetch_field()	@tab Fetch a field from the current row
  * @item mapi_fetch_field_len()	@tab Fetch the length of a field from the current row
  * @item mapi_fetch_line()	@tab	Retrieve the next line
@@ -295,14 +297,17 @@
  * @item mapi_next_result()	@tab	Go to next result set
  * @item mapi_needmore()	@tab	Return whether more data is needed
  * @item mapi_ping()	@tab	Test server for accessibility
+ * @item mapi_poll()	@tab	Wait for the reply to the oldest query in flight
  * @item mapi_prepare()	@tab	Prepare a query for execution
  * @item mapi_query()	@tab	Send a query for execution
+ * @item mapi_query_async()	@tab	Send a query without waiting for its reply
  * @item mapi_query_handle()	@tab	Send a query for execution
  * @item mapi_quote()	@tab Escape characters
  * @item mapi_reconnect()	@tab Reconnect with a clean session context
  * @item mapi_rows_affected()	@tab Obtain number of rows changed
  * @item mapi_seek_row()	@tab	Move row reader to specific location in cache
  * @item mapi_setAutocommit()	@tab	Set auto-commit flag
+ * @item mapi_set_streaming()	@tab	Receive rows while the server produces them
  * @item mapi_table()	@tab	Get current table name
  * @item mapi_timeout()	@tab	Set timeout for long-running queries[TODO]
  * @item mapi_trace()	@tab	Set trace flag
@@ -440,6 +445,30 @@
  * last query string kept around.  The command response is buffered for
  * consumption, e.g. @code{mapi_fetch_row()}.
  *
+ * @item MapiHdl mapi_query_async(Mapi mid, const char *Command, mapi_async_callback callback, void *data)
+ *
+ * Send the Command to the database server without waiting for its
+ * reply, so that many queries can be in flight on one connection.  The
+ * server answers them in order.  Once the reply has been read, the
+ * query is complete and the callback, if not NULL, is called with the
+ * returned handle and data.  Replies are read by @code{mapi_poll()},
+ * and by any other call that needs to talk to the server, e.g.
+ * @code{mapi_query()} first completes all queries in flight.  Errors
+ * of an asynchronous query are reported by
+ * @code{mapi_result_error()} on its handle.  At most 256 queries, of
+ * together at most 32 KiB, are in flight; sending another one first
+ * completes the oldest ones until it fits, so that a server blocked on
+ * writing a large reply never blocks the client in sending.  Closing
+ * a handle whose query is in flight completes all queries in flight.
+ *
+ * @item MapiHdl mapi_poll(Mapi mid)
+ *
+ * Wait for the reply to the oldest query sent with
+ * @code{mapi_query_async()} that is still in flight, and return its
+ * handle after calling its callback.  Returns NULL if no query is in
+ * flight or the connection failed.  Use @code{mapi_set_timeout()} to
+ * bound the wait.
+ *
  * @item MapiHdl mapi_prepare(Mapi mid, const char *Command)
  *
  * Move the query to a newly allocated query handle (which is returned).
@@ -528,6 +557,38 @@
  *
  * Go to the next result set, discarding the rest of the output of the
  * current result set.
+ *
+ * @item bool mapi_can_fetch_columns(MapiHdl hdl)
+ *
+ * Return whether the current result set can be fetched with
+ * @code{mapi_fetch_columns()}.  This requires a SQL table result
+ * whose columns all have a type with a binary representation, and a
+ * server with the same byte order that offers binary result set
+ * transfer, and streaming to be off.  Decimal, time and timestamp
+ * columns also need the size header, see @code{mapi_set_size_header()}.
+ *
+ * @item int64_t mapi_fetch_columns(MapiHdl hdl)
+ *
+ * Fetch the next chunk of rows of the current result set and decode it
+ * into one array of values per column.  The rows that were sent along
+ * with the query response make up the first chunk, the remaining rows
+ * are requested from the server in its binary format, which saves
+ * converting each value to text and back.  It returns the number of
+ * rows in the chunk, zero at the end of the result set, and -1 on
+ * error.  Do not mix this with @code{mapi_fetch_row()} on the same
+ * result set.
+ *
+ * @item const void *mapi_get_column(MapiHdl hdl, int fnr)
+ *
+ * Return the values of a column of the current chunk.  See
+ * @code{mapi.h} for the C type used for each SQL type.  The array is
+ * valid until the next call of @code{mapi_fetch_columns()}.
+ *
+ * @item const char *mapi_fetch_column_field(MapiHdl hdl, int fnr, int64_t rownr)
+ *
+ * Return a value of the current chunk formatted the way the server
+ * formats it in its text protocol, or zero if the value is NULL.  The
+ * string is valid until the next call for the same column.
  * @end itemize
  *
  * @subsection Errors
@@ -624,6 +685,15 @@
  * when the language is SQL.  In that case, the server commits after each
  * statement sent to the server.
  *
+ * @item MapiMsg mapi_set_streaming(Mapi mid, bool value)
+ *
+ * Ask the server to send the rows of a query evaluated by its pipeline
+ * engine while they are produced, instead of after the whole result
+ * was materialized.  The header of such a result set announces no rows,
+ * all rows follow in the response regardless of the cache limit, and
+ * @code{mapi_get_row_count()} counts them as they arrive.  Binary
+ * column fetches are not used while streaming is on.
+ *
  * @item MapiMsg mapi_cache_limit(Mapi mid, int maxrows)
  *
  * A limited number of tuples are pre-fetched after each @code{execute()}.  If
@@ -696,6 +766,7 @@
 #include "mutils.h"
 
 #include "mapi_intern.h"
+#include <math.h>		/* for isnan */
 
 #ifndef INVALID_SOCKET
 #define INVALID_SOCKET (-1)
@@ -1484,6 +1555,14 @@ close_result(MapiHdl hdl)
 	if( hdl->active == result)
 		return MERROR;
 	//assert(hdl->active != result);
+	if (result->chunk) {
+		for (i = 0; i < result->chunk->ncols; i++)
+			free(result->chunk->cols[i].mem);
+		free(result->chunk->cols);
+		free(result->chunk->buf);
+		free(result->chunk);
+		result->chunk = NULL;
+	}
 	if (result->fields) {
 		for (i = 0; i < result->maxfields; i++) {
 			if (result->fields[i].tablename)
@@ -1660,6 +1739,46 @@ mapi_new_handle(Mapi mid)
 	return hdl;
 }
 
+/* The reply to the oldest query in flight was read.  The next query
+   in flight becomes the active one, since its reply is next on the
+   connection. */
+static void
+inflight_done(MapiHdl hdl)
+{
+	Mapi mid = hdl->mid;
+
+	assert(mid->inflight == hdl);
+	mid->inflight = hdl->next_inflight;
+	if (mid->inflight == NULL)
+		mid->last_inflight = NULL;
+	mid->ninflight--;
+	mid->inflight_size -= hdl->inflight_size;
+	mid->active = mid->inflight;
+	hdl->next_inflight = NULL;
+	hdl->inflight = false;
+	/* errors of an asynchronous query are reported on its handle */
+	if (mid->error == MSERVER)
+		mapi_clrError(mid);
+	if (hdl->callback)
+		hdl->callback(hdl, hdl->callback_data);
+}
+
+/* Read all output the server still has to send before a new command
+   can be sent: the rest of the active reply and the replies to all
+   queries in flight. */
+static MapiMsg
+read_pending(Mapi mid)
+{
+	MapiHdl hdl = NULL;
+
+	while (mid->active && mid->active != hdl) {
+		hdl = mid->active;
+		if (read_into_cache(hdl, 0) != MOK)
+			return MERROR;
+	}
+	return MOK;
+}
+
 /* close all result sets on the handle but don't close the handle itself */
 static MapiMsg
 finish_handle(MapiHdl hdl)
@@ -1670,6 +1789,8 @@ finish_handle(MapiHdl hdl)
 	if (hdl == NULL)
 		return MERROR;
 	mid = hdl->mid;
+	if (hdl->inflight && read_pending(mid) != MOK)
+		return MERROR;
 	if (mid->active == hdl && !hdl->needmore && !mnstr_eof(mid->from) &&
 	    read_into_cache(hdl, 0) != MOK)
 		return MERROR;
@@ -1682,6 +1803,8 @@ finish_handle(MapiHdl hdl)
 			check_stream(mid, mid->to, f, "write error on stream", mid->error);
 			read_into_cache(hdl, 0);
 		}
+		if (hdl->npending_close > 0 && read_pending(mid) != MOK)
+			return MERROR;
 		for (i = 0; i < hdl->npending_close; i++) {
 			char msg[256];
 
@@ -2090,8 +2213,14 @@ close_connection(Mapi mid)
 
 	mid->connected = false;
 	mid->active = NULL;
+	/* queries in flight are dropped without calling back */
+	mid->inflight = mid->last_inflight = NULL;
+	mid->ninflight = 0;
+	mid->inflight_size = 0;
 	for (hdl = mid->first; hdl; hdl = hdl->next) {
 		hdl->active = NULL;
+		hdl->inflight = false;
+		hdl->next_inflight = NULL;
 		for (result = hdl->result; result; result = result->next)
 			result->tableid = -1;
 	}
@@ -2434,7 +2563,7 @@ mapi_Xcommand(Mapi mid, const char *cmdname, const char *cmdvalue)
 	MapiHdl hdl;
 
 	mapi_check(mid);
-	if (mid->active && read_into_cache(mid->active, 0) != MOK)
+	if (read_pending(mid) != MOK)
 		return MERROR;
 	if (mnstr_printf(mid->to, "X" "%s %s\n", cmdname, cmdvalue) < 0 ||
 	    mnstr_flush(mid->to, MNSTR_FLUSH_DATA)) {
@@ -2846,6 +2975,24 @@ mapi_set_size_header(Mapi mid, bool value)
 		return mapi_Xcommand(mid, "sizeheader", "0");
 }
 
+MapiMsg
+mapi_set_streaming(Mapi mid, bool value)
+{
+	if (!msettings_lang_is_sql(mid->settings)) {
+		mapi_setError(mid, "streaming only supported in SQL", __func__, MERROR);
+		return MERROR;
+	}
+	if (mid->streaming == value)
+		return MOK;
+	mid->streaming = value;
+	if (!mid->connected)
+		return MOK;
+	if (value)
+		return mapi_Xcommand(mid, "streaming", "1");
+	else
+		return mapi_Xcommand(mid, "streaming", "0");
+}
+
 MapiMsg
 mapi_release_id(Mapi mid, int id)
 {
@@ -3504,6 +3651,8 @@ read_into_cache(MapiHdl hdl, int lookahead)
 				}
 				continue;
 			}
+			if (hdl->inflight)
+				inflight_done(hdl);
 			return mid->error;
 		case '!':
 			/* start a new result set if we don't have one
@@ -3555,7 +3704,7 @@ mapi_execute_internal(MapiHdl hdl)
 	Mapi mid;
 
 	mid = hdl->mid;
-	if (mid->active && read_into_cache(mid->active, 0) != MOK)
+	if (read_pending(mid) != MOK)
 		return MERROR;
 	assert(mid->active == NULL);
 	finish_handle(hdl);
@@ -3648,6 +3797,76 @@ mapi_read_response(MapiHdl hdl)
 	return read_into_cache(hdl, 1);
 }
 
+/* The server stops reading queries while it is blocked writing a reply
+ * that doesn't fit in the socket buffers.  The queries in flight must
+ * then fit in the socket buffers as well, or else we block in sending
+ * and never read the reply.  A single larger query is only sent when
+ * nothing is in flight, and then the server reads all of it. */
+#define MAX_INFLIGHT		256
+#define MAX_INFLIGHT_SIZE	32768
+
+/* version of mapi_query that returns before the reply arrived, so that
+ * the next query can be sent at once */
+MapiHdl
+mapi_query_async(Mapi mid, const char *cmd, mapi_async_callback callback, void *data)
+{
+	MapiHdl hdl;
+
+	mapi_check0(mid);
+	/* a synchronous reply must be read first */
+	if (mid->active && !mid->active->inflight &&
+	    read_into_cache(mid->active, 0) != MOK)
+		return NULL;
+	/* the size of what mapi_execute_internal sends */
+	size_t size = cmd ? strlen(cmd) + 4 : 0;
+	while (mid->ninflight >= MAX_INFLIGHT ||
+	       (mid->ninflight > 0 &&
+		mid->inflight_size + size > MAX_INFLIGHT_SIZE)) {
+		if (read_into_cache(mid->inflight, 0) != MOK)
+			return NULL;
+	}
+	hdl = prepareQuery(mapi_new_handle(mid), cmd);
+	if (hdl == NULL || mid->error != MOK)
+		return hdl;
+	hdl->callback = callback;
+	hdl->callback_data = data;
+	/* mapi_execute_internal makes the handle active, which the oldest
+	 * query in flight already is */
+	MapiHdl active = mid->active;
+	mid->active = NULL;
+	if (mapi_execute_internal(hdl) != MOK) {
+		if (mid->connected)
+			mid->active = active;
+		return hdl;
+	}
+	mid->active = active ? active : hdl;
+	hdl->inflight = true;
+	hdl->inflight_size = size;
+	if (mid->last_inflight)
+		mid->last_inflight->next_inflight = hdl;
+	else
+		mid->inflight = hdl;
+	mid->last_inflight = hdl;
+	mid->ninflight++;
+	mid->inflight_size += size;
+	return hdl;
+}
+
+/* wait for the reply to the oldest query in flight */
+MapiHdl
+mapi_poll(Mapi mid)
+{
+	MapiHdl hdl = mid->inflight;
+
+	if (hdl == NULL)
+		return NULL;
+	mapi_clrError(mid);
+	assert(mid->active == hdl);
+	if (read_into_cache(hdl, 0) != MOK || hdl->inflight)
+		return NULL;
+	return hdl;
+}
+
 MapiMsg
 mapi_query_handle(MapiHdl hdl, const char *cmd)
 {
@@ -3669,7 +3888,7 @@ MapiHdl
 mapi_query_prep(Mapi mid)
 {
 	mapi_check0(mid);
-	if (mid->active && read_into_cache(mid->active, 0) != MOK)
+	if (read_pending(mid) != MOK)
 		return NULL;
 	assert(mid->active == NULL);
 	if (msettings_lang_is_sql(mid->settings)) {
@@ -3773,8 +3992,7 @@ mapi_cache_limit(Mapi mid, int limit)
 	if (msettings_lang_is_sql(mid->settings)) {
 		MapiHdl hdl;
 
-		if (mid->active)
-			read_into_cache(mid->active, 0);
+		(void) read_pending(mid);
 
 		mapi_log_record(mid, "X", "X" "reply_size %d\n", limit);
 		if (mnstr_printf(mid->to, "X" "reply_size %d\n", limit) < 0 ||
@@ -3908,8 +4126,7 @@ mapi_fetch_line(MapiHdl hdl)
 	    result->cache.first + result->cache.tuplecount < result->row_count) {
 		if (hdl->needmore)	/* escalate */
 			return NULL;
-		if (hdl->mid->active != NULL)
-			read_into_cache(hdl->mid->active, 0);
+		(void) read_pending(hdl->mid);
 		hdl->mid->active = hdl;
 		hdl->active = result;
 		mapi_log_record(hdl->mid, "W", "X" "export %d %" PRId64 "\n",
@@ -4449,6 +4666,773 @@ mapi_fetch_all_rows(MapiHdl hdl)
 	return result ? result->cache.tuplecount : 0;
 }
 
+/*
+ * Binary columnar fetching.  The rows that were sent with the query
+ * response are decoded from the row cache, the remaining rows are
+ * asked for with Xexportbin.  The server responds to that with a
+ * header line like the one of Xexport, followed by the values of each
+ * column aligned to 32 bytes, a table with the start and length of
+ * each column, and the position of that table, all offsets counted
+ * from the start of the header line.
+ */
+
+#define MAPI_CHUNK_SIZE	((size_t) 16 << 20)	/* aim for this many bytes per chunk */
+#define MAPI_CHUNK_MINROWS	1024
+#define MAPI_CHUNK_MAXROWS	((int64_t) 1 << 24)
+
+#ifdef HAVE_HGE
+typedef int128_t colint;
+#else
+typedef int64_t colint;
+#endif
+
+enum colkind {
+	COL_INT,
+	COL_DEC,
+	COL_FLT,
+	COL_BOOL,
+	COL_STR,
+	COL_DATE,
+	COL_TIME,
+	COL_TIMESTAMP,
+	COL_UUID,
+};
+
+static const struct coltype {
+	const char *name;
+	enum colkind kind;
+	int width;		/* 0 for decimals, which depend on the digits */
+} coltypes[] = {
+	{ "tinyint", COL_INT, 1 },
+	{ "smallint", COL_INT, 2 },
+	{ "int", COL_INT, 4 },
+	{ "bigint", COL_INT, 8 },
+#ifdef HAVE_HGE
+	{ "hugeint", COL_INT, 16 },
+#endif
+	{ "month_interval", COL_INT, 4 },
+	{ "sec_interval", COL_DEC, 8 },
+	{ "decimal", COL_DEC, 0 },
+	{ "real", COL_FLT, 4 },
+	{ "double", COL_FLT, 8 },
+	{ "boolean", COL_BOOL, 1 },
+	{ "char", COL_STR, sizeof(char *) },
+	{ "varchar", COL_STR, sizeof(char *) },
+	{ "clob", COL_STR, sizeof(char *) },
+	{ "json", COL_STR, sizeof(char *) },
+	{ "url", COL_STR, sizeof(char *) },
+	{ "date", COL_DATE, sizeof(MapiColumnDate) },
+	{ "time", COL_TIME, sizeof(MapiColumnTime) },
+	{ "timestamp", COL_TIMESTAMP, sizeof(MapiColumnTimestamp) },
+	{ "uuid", COL_UUID, 16 },
+};
+
+/* find out how the values of a column are transferred; returns false
+ * if the column has no binary representation that we know of */
+static bool
+column_layout(const struct MapiColumn *f, struct MapiColumnBuf *c)
+{
+	if (f->columntype == NULL)
+		return false;
+	for (size_t i = 0; i < sizeof(coltypes) / sizeof(coltypes[0]); i++) {
+		if (strcmp(f->columntype, coltypes[i].name) != 0)
+			continue;
+		c->kind = coltypes[i].kind;
+		c->width = coltypes[i].width;
+		c->scale = 0;
+		switch (c->kind) {
+		case COL_DEC:
+			if (c->width == 0) {
+				/* the server uses the smallest integer type
+				 * that can hold all digits; we only know the
+				 * digits if the size header was requested */
+				if (f->digits == 0)
+					return false;
+				c->width = f->digits <= 2 ? 1 : f->digits <= 4 ? 2 : f->digits <= 9 ? 4 : f->digits <= 18 ? 8 : 16;
+				c->scale = f->scale;
+			} else {
+				c->scale = 3;	/* sec_interval */
+			}
+			return c->width <= (int) sizeof(colint);
+		case COL_TIME:
+		case COL_TIMESTAMP:
+			if (f->digits == 0)
+				return false;
+			c->scale = f->digits - 1;
+			return true;
+		default:
+			return true;
+		}
+	}
+	return false;
+}
+
+bool
+mapi_can_fetch_columns(MapiHdl hdl)
+{
+	struct MapiResultSet *result;
+	struct MapiColumnBuf c;
+
+	mapi_hdl_check0(hdl);
+	if (!hdl->mid->binary ||
+	    hdl->mid->streaming ||
+	    !msettings_lang_is_sql(hdl->mid->settings) ||
+	    (result = hdl->result) == NULL ||
+	    result->querytype != Q_TABLE ||
+	    result->tableid < 0 ||
+	    result->errorstr != NULL ||
+	    result->fieldcnt <= 0)
+		return false;
+	for (int i = 0; i < result->fieldcnt; i++)
+		if (!column_layout(&result->fields[i], &c))
+			return false;
+	return true;
+}
+
+static bool
+parse_scaled(const char *s, int scale, colint *v)
+{
+	bool neg = false;
+	int frac = -1;
+	colint r = 0;
+
+	if (*s == '-' || *s == '+')
+		neg = *s++ == '-';
+	if (!isdigit((unsigned char) *s))
+		return false;
+	for (; *s; s++) {
+		if (*s == '.' && frac < 0) {
+			frac = 0;
+			continue;
+		}
+		if (!isdigit((unsigned char) *s))
+			return false;
+		if (frac >= 0) {
+			if (frac == scale)
+				continue;
+			frac++;
+		}
+		r = r * 10 + (*s - '0');
+	}
+	for (frac = frac < 0 ? 0 : frac; frac < scale; frac++)
+		r *= 10;
+	*v = neg ? -r : r;
+	return true;
+}
+
+static bool
+parse_time(const char *s, MapiColumnTime *t)
+{
+	unsigned int h, m, sec, usec = 0;
+	int n = 0;
+
+	if (sscanf(s, "%u:%u:%u%n", &h, &m, &sec, &n) != 3 || h > 23 || m > 59 || sec > 60)
+		return false;
+	s += n;
+	if (*s == '.') {
+		int i;
+		for (i = 0, s++; isdigit((unsigned char) *s); i++, s++)
+			if (i < 6)
+				usec = usec * 10 + (*s - '0');
+		for (; i < 6; i++)
+			usec *= 10;
+	}
+	*t = (MapiColumnTime) {
+		.usec = usec,
+		.seconds = (uint8_t) sec,
+		.minutes = (uint8_t) m,
+		.hours = (uint8_t) h,
+	};
+	return *s == 0;
+}
+
+static bool
+parse_date(const char *s, MapiColumnDate *d, int *np)
+{
+	int y;
+	unsigned int m, day;
+
+	if (sscanf(s, "%d-%u-%u%n", &y, &m, &day, np) != 3 || m < 1 || m > 12 || day < 1 || day > 31)
+		return false;
+	*d = (MapiColumnDate) {
+		.day = (uint8_t) day,
+		.month = (uint8_t) m,
+		.year = (int16_t) y,
+	};
+	return true;
+}
+
+/* convert a value as received in the text protocol to its binary
+ * form; s is NULL for a NULL value */
+static bool
+parse_column_value(const struct MapiColumnBuf *c, const char *s, void *dst)
+{
+	switch (c->kind) {
+	case COL_INT:
+	case COL_DEC: {
+		colint v;
+		switch (c->width) {
+		case 1:
+			if (s == NULL)
+				*(int8_t *) dst = INT8_MIN;
+			else if (parse_scaled(s, c->scale, &v))
+				*(int8_t *) dst = (int8_t) v;
+			else
+				return false;
+			return true;
+		case 2:
+			if (s == NULL)
+				*(int16_t *) dst = INT16_MIN;
+			else if (parse_scaled(s, c->scale, &v))
+				*(int16_t *) dst = (int16_t) v;
+			else
+				return false;
+			return true;
+		case 4:
+			if (s == NULL)
+				*(int32_t *) dst = INT32_MIN;
+			else if (parse_scaled(s, c->scale, &v))
+				*(int32_t *) dst = (int32_t) v;
+			else
+				return false;
+			return true;
+		case 8:
+			if (s == NULL)
+				*(int64_t *) dst = INT64_MIN;
+			else if (parse_scaled(s, c->scale, &v))
+				*(int64_t *) dst = (int64_t) v;
+			else
+				return false;
+			return true;
+#ifdef HAVE_HGE
+		case 16:
+			if (s == NULL)
+				*(int128_t *) dst = (int128_t) 1 << 127;
+			else if (parse_scaled(s, c->scale, &v))
+				*(int128_t *) dst = v;
+			else
+				return false;
+			return true;
+#endif
+		default:
+			return false;
+		}
+	}
+	case COL_FLT:
+		if (c->width == 4)
+			*(float *) dst = s ? strtof(s, NULL) : NAN;
+		else
+			*(double *) dst = s ? strtod(s, NULL) : NAN;
+		return true;
+	case COL_BOOL:
+		if (s == NULL)
+			*(int8_t *) dst = INT8_MIN;
+		else if (strcmp(s, "true") == 0)
+			*(int8_t *) dst = 1;
+		else if (strcmp(s, "false") == 0)
+			*(int8_t *) dst = 0;
+		else
+			return false;
+		return true;
+	case COL_STR:
+		*(const char **) dst = s;
+		return true;
+	case COL_DATE: {
+		int n;
+		if (s == NULL) {
+			memset(dst, 0xFF, sizeof(MapiColumnDate));
+			return true;
+		}
+		return parse_date(s, dst, &n) && s[n] == 0;
+	}
+	case COL_TIME:
+		if (s == NULL) {
+			memset(dst, 0xFF, sizeof(MapiColumnTime));
+			return true;
+		}
+		return parse_time(s, dst);
+	case COL_TIMESTAMP: {
+		MapiColumnTimestamp *ts = dst;
+		int n;
+		if (s == NULL) {
+			memset(dst, 0xFF, sizeof(MapiColumnTimestamp));
+			return true;
+		}
+		return parse_date(s, &ts->date, &n) && s[n] == ' ' && parse_time(s + n + 1, &ts->time);
+	}
+	case COL_UUID: {
+		uint8_t *u = dst;
+		int i = 0;
+		if (s == NULL) {
+			memset(dst, 0, 16);
+			return true;
+		}
+		for (; *s && i < 32; s++) {
+			int d;
+			if (*s == '-')
+				continue;
+			if (*s >= '0' && *s <= '9')
+				d = *s - '0';
+			else if (*s >= 'a' && *s <= 'f')
+				d = *s - 'a' + 10;
+			else if (*s >= 'A' && *s <= 'F')
+				d = *s - 'A' + 10;
+			else
+				return false;
+			if (i % 2 == 0)
+				u[i / 2] = (uint8_t) (d << 4);
+			else
+				u[i / 2] |= (uint8_t) d;
+			i++;
+		}
+		return i == 32 && *s == 0;
+	}
+	}
+	return false;
+}
+
+static bool
+column_mem(struct MapiColumnBuf *c, int64_t rows)
+{
+	size_t size = (size_t) rows * (size_t) c->width;
+
+	if (size > c->memsize) {
+		void *p = realloc(c->mem, size);
+		if (p == NULL)
+			return false;
+		c->mem = p;
+		c->memsize = size;
+	}
+	c->data = c->mem;
+	return true;
+}
+
+/* decode the rows in the row cache */
+static int64_t
+fetch_cached_columns(MapiHdl hdl, struct MapiColumnChunk *chunk)
+{
+	struct MapiResultSet *result = hdl->result;
+	int64_t rows = result->cache.tuplecount;
+
+	for (int i = 0; i < chunk->ncols; i++)
+		if (!column_mem(&chunk->cols[i], rows))
+			return mapi_setError(hdl->mid, "Memory allocation failure", __func__, MERROR);
+	for (int64_t r = 0; r < rows; r++) {
+		int cr = result->cache.line[r].tupleindex;
+
+		if (mapi_slice_row(result, cr) != chunk->ncols)
+			return mapi_setError(hdl->mid, "Unexpected number of fields", __func__, MERROR);
+		for (int i = 0; i < chunk->ncols; i++) {
+			struct MapiColumnBuf *c = &chunk->cols[i];
+			if (!parse_column_value(c, result->cache.line[cr].anchors[i], (char *) c->mem + r * c->width))
+				return mapi_printError(hdl->mid, __func__, MERROR, "Cannot convert value of column %d", i + 1);
+		}
+	}
+	chunk->rows = rows;
+	chunk->next = result->cache.first + rows;
+	return rows;
+}
+
+static MapiMsg
+grow_chunk(Mapi mid, struct MapiColumnChunk *chunk, size_t size)
+{
+	if (size > chunk->lim) {
+		size_t lim = chunk->lim ? chunk->lim : MAPIBLKSIZE;
+		char *p;
+
+		while (lim < size)
+			lim *= 2;
+		if ((p = realloc(chunk->buf, lim)) == NULL)
+			return mapi_setError(mid, "Memory allocation failure", __func__, MERROR);
+		chunk->buf = p;
+		chunk->lim = lim;
+	}
+	return MOK;
+}
+
+/* ask the server for the next chunk in binary form and decode it */
+static MapiMsg
+fetch_binary_columns(MapiHdl hdl, struct MapiColumnChunk *chunk)
+{
+	Mapi mid = hdl->mid;
+	struct MapiResultSet *result = hdl->result;
+	int64_t nrows, offset;
+	int tableid, ncols;
+	char *line;
+	int e;
+
+	if (read_pending(mid) != MOK)
+		return MERROR;
+	assert(mid->active == NULL);
+	mapi_log_record(mid, "W", "X" "exportbin %d %" PRId64 " %" PRId64 "\n",
+			result->tableid, chunk->next, chunk->step);
+	if ((e = mnstr_printf(mid->to, "X" "exportbin %d %" PRId64 " %" PRId64 "\n",
+			      result->tableid, chunk->next, chunk->step)) < 0 ||
+	    (e = mnstr_flush(mid->to, MNSTR_FLUSH_DATA)) < 0)
+		check_stream(mid, mid->to, e, "sending export command", mid->error);
+	mid->active = hdl;
+
+	if ((line = read_line(mid)) == NULL) {
+		mid->active = NULL;
+		if (mid->error == MOK)
+			mapi_setError(mid, "unexpected end of file", __func__, MTIMEOUT);
+		return mid->error;
+	}
+	if (*line == '!' || *line == PROMPTBEG) {
+		/* no chunk, report the (first) error up to the prompt */
+		MapiMsg ret = MERROR;
+		if (*line == '!')
+			ret = mapi_setError(mid, line + 1, __func__, MSERVER);
+		while (*line != PROMPTBEG && (line = read_line(mid)) != NULL)
+			;
+		mid->active = NULL;
+		if (ret != MSERVER)
+			ret = mapi_setError(mid, "Result set chunk not available", __func__, MERROR);
+		return ret;
+	}
+	if (sscanf(line, "&6 %d %d %" SCNd64 " %" SCNd64, &tableid, &ncols, &nrows, &offset) != 4 ||
+	    tableid != result->tableid || ncols != chunk->ncols ||
+	    offset != chunk->next || nrows < 0 || nrows > chunk->step) {
+		close_connection(mid);
+		return mapi_setError(mid, "Invalid binary result set chunk header", __func__, MERROR);
+	}
+
+	/* collect the whole message, starting with the header line */
+	size_t hdrlen = strlen(line) + 1;
+	size_t have = mid->blk.end - mid->blk.nxt;
+	if (grow_chunk(mid, chunk, hdrlen + have + BLOCK) != MOK) {
+		close_connection(mid);
+		return mid->error;
+	}
+	memcpy(chunk->buf, line, hdrlen - 1);
+	chunk->buf[hdrlen - 1] = '\n';
+	memcpy(chunk->buf + hdrlen, mid->blk.buf + mid->blk.nxt, have);
+	chunk->size = hdrlen + have;
+	mid->blk.nxt = mid->blk.end = 0;
+	mid->blk.buf[0] = 0;
+	for (;;) {
+		ssize_t len;
+
+		if (grow_chunk(mid, chunk, chunk->size + BLOCK) != MOK) {
+			close_connection(mid);
+			return mid->error;
+		}
+		len = mnstr_read(mid->from, chunk->buf + chunk->size, 1, chunk->lim - chunk->size);
+		if (len == -1 && mnstr_errnr(mid->from) == MNSTR_INTERRUPT) {
+			mnstr_clearerr(mid->from);
+			if (mid->oobintr && !hdl->aborted) {
+				hdl->aborted = true;
+				mnstr_putoob(mid->to, 1);
+			}
+			continue;
+		}
+		check_stream(mid, mid->from, len, "Connection terminated while reading result set chunk", mid->error);
+		if (len == 0)
+			break;
+		chunk->size += (size_t) len;
+	}
+	mid->active = NULL;
+	mapi_log_record(mid, "RECV", "binary chunk of %" PRId64 " rows, %zu bytes\n", nrows, chunk->size);
+
+	int64_t tocpos;
+	if (chunk->size < hdrlen + (size_t) ncols * 16 + 8)
+		return mapi_setError(mid, "Binary result set chunk too short", __func__, MERROR);
+	memcpy(&tocpos, chunk->buf + chunk->size - 8, 8);
+	if (tocpos < (int64_t) hdrlen ||
+	    (uint64_t) tocpos + (uint64_t) ncols * 16 + 8 != chunk->size)
+		return mapi_setError(mid, "Invalid binary result set chunk", __func__, MERROR);
+	for (int i = 0; i < ncols; i++) {
+		struct MapiColumnBuf *c = &chunk->cols[i];
+		int64_t start, length;
+
+		memcpy(&start, chunk->buf + tocpos + 16 * i, 8);
+		memcpy(&length, chunk->buf + tocpos + 16 * i + 8, 8);
+		if (start < (int64_t) hdrlen || length < 0 || start + length > tocpos)
+			return mapi_setError(mid, "Invalid binary result set chunk", __func__, MERROR);
+		const char *p = chunk->buf + start;
+		if (c->kind == COL_STR) {
+			/* zero-terminated strings, the nil string is "\200" */
+			const char *end = p + length;
+			const char **v;
+
+			if (!column_mem(c, nrows))
+				return mapi_setError(mid, "Memory allocation failure", __func__, MERROR);
+			v = c->mem;
+			for (int64_t r = 0; r < nrows; r++) {
+				const char *z = memchr(p, 0, (size_t) (end - p));
+				if (z == NULL)
+					return mapi_printError(mid, __func__, MERROR, "Invalid strings in column %d", i + 1);
+				v[r] = p[0] == '\200' && p[1] == 0 ? NULL : p;
+				p = z + 1;
+			}
+		} else if (length != nrows * c->width) {
+			return mapi_printError(mid, __func__, MERROR, "Unexpected value size in column %d", i + 1);
+		} else {
+			c->data = p;
+		}
+	}
+	chunk->rows = nrows;
+	chunk->next = nrows > 0 ? offset + nrows : result->row_count;
+
+	/* ask for about MAPI_CHUNK_SIZE bytes next time */
+	if (nrows > 0) {
+		int64_t step = (int64_t) ((double) nrows * MAPI_CHUNK_SIZE / chunk->size);
+		chunk->step = step < MAPI_CHUNK_MINROWS ? MAPI_CHUNK_MINROWS : step > MAPI_CHUNK_MAXROWS ? MAPI_CHUNK_MAXROWS : step;
+	}
+	return MOK;
+}
+
+int64_t
+mapi_fetch_columns(MapiHdl hdl)
+{
+	struct MapiResultSet *result;
+	struct MapiColumnChunk *chunk;
+	Mapi mid;
+
+	mapi_hdl_check(hdl);
+	mid = hdl->mid;
+	if (!mapi_can_fetch_columns(hdl))
+		return mapi_setError(mid, "Result set cannot be fetched in binary form", __func__, MERROR);
+	result = hdl->result;
+	if ((chunk = result->chunk) == NULL) {
+		size_t rowsize = 0;
+
+		chunk = malloc(sizeof(*chunk));
+		if (chunk == NULL)
+			return mapi_setError(mid, "Memory allocation failure", __func__, MERROR);
+		*chunk = (struct MapiColumnChunk) {
+			.ncols = result->fieldcnt,
+		};
+		chunk->cols = calloc(chunk->ncols, sizeof(*chunk->cols));
+		if (chunk->cols == NULL) {
+			free(chunk);
+			return mapi_setError(mid, "Memory allocation failure", __func__, MERROR);
+		}
+		result->chunk = chunk;
+		for (int i = 0; i < chunk->ncols; i++) {
+			column_layout(&result->fields[i], &chunk->cols[i]);
+			/* guess the size of strings */
+			rowsize += chunk->cols[i].kind == COL_STR ? 32 : chunk->cols[i].width;
+		}
+		chunk->step = (int64_t) (MAPI_CHUNK_SIZE / rowsize);
+		if (chunk->step < MAPI_CHUNK_MINROWS)
+			chunk->step = MAPI_CHUNK_MINROWS;
+		else if (chunk->step > MAPI_CHUNK_MAXROWS)
+			chunk->step = MAPI_CHUNK_MAXROWS;
+
+		/* the first chunk is what came with the query response */
+		if (mid->active == hdl && !hdl->needmore &&
+		    read_into_cache(hdl, 0) != MOK)
+			return MERROR;
+		if (result->cache.tuplecount > 0)
+			return fetch_cached_columns(hdl, chunk);
+		chunk->next = result->cache.first;
+	}
+	chunk->rows = 0;
+	if (chunk->next >= result->row_count)
+		return 0;
+	if (fetch_binary_columns(hdl, chunk) != MOK)
+		return MERROR;
+	return chunk->rows;
+}
+
+const void *
+mapi_get_column(MapiHdl hdl, int fnr)
+{
+	struct MapiResultSet *result;
+
+	mapi_hdl_check0(hdl);
+	if ((result = hdl->result) == NULL || result->chunk == NULL ||
+	    fnr < 0 || fnr >= result->chunk->ncols) {
+		mapi_setError(hdl->mid, "Illegal field number", __func__, MERROR);
+		return NULL;
+	}
+	return result->chunk->cols[fnr].data;
+}
+
+/* the formatting functions below produce the same text as the server
+ * does for the text protocol */
+
+static const char *
+format_scaled(char *buf, size_t len, colint v, int scale)
+{
+	char *p = buf + len;
+	bool neg = v < 0;
+
+	*--p = 0;
+	if (neg)
+		v = -v;
+	if (scale > 0) {
+		for (int i = 0; i < scale; i++) {
+			*--p = (char) ('0' + v % 10);
+			v /= 10;
+		}
+		*--p = '.';
+	}
+	do {
+		*--p = (char) ('0' + v % 10);
+		v /= 10;
+	} while (v);
+	if (neg)
+		*--p = '-';
+	return p;
+}
+
+static int
+format_time(char *buf, size_t len, const MapiColumnTime *t, int precision)
+{
+	int usec = (int) t->usec;
+	int n;
+
+	if (precision <= 0)
+		return snprintf(buf, len, "%02d:%02d:%02d", t->hours, t->minutes, t->seconds);
+	if (precision < 6) {
+		for (int i = 6; i > precision; i--)
+			usec /= 10;
+		return snprintf(buf, len, "%02d:%02d:%02d.%0*d", t->hours, t->minutes, t->seconds, precision, usec);
+	}
+	n = snprintf(buf, len, "%02d:%02d:%02d.%06d", t->hours, t->minutes, t->seconds, usec);
+	while (precision-- > 6 && n < (int) len - 1)
+		buf[n++] = '0';
+	buf[n] = 0;
+	return n;
+}
+
+const char *
+mapi_fetch_column_field(MapiHdl hdl, int fnr, int64_t rownr)
+{
+	struct MapiResultSet *result;
+	struct MapiColumnBuf *c;
+	const char *p;
+
+	mapi_hdl_check0(hdl);
+	if ((result = hdl->result) == NULL || result->chunk == NULL ||
+	    fnr < 0 || fnr >= result->chunk->ncols ||
+	    rownr < 0 || rownr >= result->chunk->rows) {
+		mapi_setError(hdl->mid, "Illegal field or row number", __func__, MERROR);
+		return NULL;
+	}
+	c = &result->chunk->cols[fnr];
+	p = (const char *) c->data + rownr * c->width;
+	switch (c->kind) {
+	case COL_STR:
+		return *(const char *const *) p;
+	case COL_INT:
+	case COL_DEC: {
+		colint v;
+		switch (c->width) {
+		case 1:
+			if (*(const int8_t *) p == INT8_MIN)
+				return NULL;
+			v = *(const int8_t *) p;
+			break;
+		case 2:
+			if (*(const int16_t *) p == INT16_MIN)
+				return NULL;
+			v = *(const int16_t *) p;
+			break;
+		case 4:
+			if (*(const int32_t *) p == INT32_MIN)
+				return NULL;
+			v = *(const int32_t *) p;
+			break;
+		case 8:
+			if (*(const int64_t *) p == INT64_MIN)
+				return NULL;
+			v = *(const int64_t *) p;
+			break;
+#ifdef HAVE_HGE
+		case 16:
+			if (*(const int128_t *) p == (int128_t) 1 << 127)
+				return NULL;
+			v = *(const int128_t *) p;
+			break;
+#endif
+		default:
+			return NULL;
+		}
+		return format_scaled(c->text, sizeof(c->text), v, c->scale);
+	}
+	case COL_FLT:
+		/* shortest representation that reads back the same */
+		if (c->width == 4) {
+			float v = *(const float *) p;
+			if (isnan(v))
+				return NULL;
+			if (v <= (float) 9999999 && v >= (float) -9999999 &&
+			    (float) (int) v == v) {
+				snprintf(c->text, sizeof(c->text), "%.0f", v);
+				if (strtof(c->text, NULL) == v)
+					return c->text;
+			}
+			for (int i = 4; i < 10; i++) {
+				snprintf(c->text, sizeof(c->text), "%.*g", i, v);
+				if (strtof(c->text, NULL) == v)
+					break;
+			}
+		} else {
+			double v = *(const double *) p;
+			if (isnan(v))
+				return NULL;
+			if (v <= (double) 999999999999999 && v >= (double) -999999999999999 &&
+			    (double) (int) v == v) {
+				snprintf(c->text, sizeof(c->text), "%.0f", v);
+				if (strtod(c->text, NULL) == v)
+					return c->text;
+			}
+			for (int i = 4; i < 18; i++) {
+				snprintf(c->text, sizeof(c->text), "%.*g", i, v);
+				if (strtod(c->text, NULL) == v)
+					break;
+			}
+		}
+		return c->text;
+	case COL_BOOL:
+		if (*(const int8_t *) p == INT8_MIN)
+			return NULL;
+		return *(const int8_t *) p ? "true" : "false";
+	case COL_DATE: {
+		const MapiColumnDate *d = (const MapiColumnDate *) p;
+		if (d->day == 0xFF)
+			return NULL;
+		snprintf(c->text, sizeof(c->text), "%d-%02d-%02d", d->year, d->month, d->day);
+		return c->text;
+	}
+	case COL_TIME: {
+		const MapiColumnTime *t = (const MapiColumnTime *) p;
+		if (t->hours == 0xFF)
+			return NULL;
+		format_time(c->text, sizeof(c->text), t, c->scale);
+		return c->text;
+	}
+	case COL_TIMESTAMP: {
+		const MapiColumnTimestamp *ts = (const MapiColumnTimestamp *) p;
+		int n;
+		if (ts->date.day == 0xFF)
+			return NULL;
+		n = snprintf(c->text, sizeof(c->text), "%d-%02d-%02d ", ts->date.year, ts->date.month, ts->date.day);
+		format_time(c->text + n, sizeof(c->text) - n, &ts->time, c->scale);
+		return c->text;
+	}
+	case COL_UUID: {
+		static const char hexdigits[] = "0123456789abcdef";
+		const uint8_t *u = (const uint8_t *) p;
+		char *s = c->text;
+		uint8_t any = 0;
+		for (int i = 0; i < 16; i++) {
+			if (i == 4 || i == 6 || i == 8 || i == 10)
+				*s++ = '-';
+			*s++ = hexdigits[u[i] >> 4];
+			*s++ = hexdigits[u[i] & 0xF];
+			any |= u[i];
+		}
+		*s = 0;
+		return any ? c->text : NULL;
+	}
+	}
+	return NULL;
+}
+
 char *
 mapi_fetch_field(MapiHdl hdl, int fnr)
 {
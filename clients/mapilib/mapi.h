@@ -52,6 +52,37 @@ typedef struct MapiStruct *Mapi;
 
 typedef struct MapiStatement *MapiHdl;
 
+/* called by mapi_query_async when the reply to the query arrived */
+typedef void (*mapi_async_callback)(MapiHdl hdl, void *data);
+
+/* Values returned by mapi_get_column are arrays of int8_t (tinyint,
+ * boolean), int16_t (smallint), int32_t (int, month_interval), int64_t
+ * (bigint, sec_interval in milliseconds), 128 bit integers (hugeint),
+ * float (real), double (double), const char * (char, varchar, clob,
+ * json, url), 16 byte arrays (uuid), or the structs below.  Decimals
+ * are integers scaled by 10^scale, stored in 1, 2, 4, 8 or 16 bytes
+ * depending on the number of digits.  A NULL is the smallest value of
+ * an integer type, NaN, a NULL pointer, all zero bytes for uuid, or a
+ * struct with all fields set to all ones. */
+typedef struct {
+	uint8_t day;
+	uint8_t month;
+	int16_t year;
+} MapiColumnDate;
+
+typedef struct {
+	uint32_t usec;		/* microseconds */
+	uint8_t seconds;
+	uint8_t minutes;
+	uint8_t hours;
+	uint8_t padding;
+} MapiColumnTime;
+
+typedef struct {
+	MapiColumnTime time;
+	MapiColumnDate date;
+} MapiColumnTimestamp;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -146,6 +177,8 @@ mapi_export MapiMsg mapi_set_columnar_protocol(Mapi mid, bool columnar_protocol)
 	__attribute__((__nonnull__(1)));
 mapi_export MapiMsg mapi_set_size_header(Mapi mid, bool value)
 	__attribute__((__nonnull__(1)));
+mapi_export MapiMsg mapi_set_streaming(Mapi mid, bool value)
+	__attribute__((__nonnull__(1)));
 mapi_export MapiMsg mapi_release_id(Mapi mid, int id)
 	__attribute__((__nonnull__(1)));
 mapi_export const char *mapi_result_error(MapiHdl hdl);
@@ -203,6 +236,10 @@ mapi_export MapiHdl mapi_send(Mapi mid, const char *cmd)
 	__attribute__((__nonnull__(1)));
 mapi_export MapiMsg mapi_read_response(MapiHdl hdl)
 	__attribute__((__nonnull__(1)));
+mapi_export MapiHdl mapi_query_async(Mapi mid, const char *cmd, mapi_async_callback callback, void *data)
+	__attribute__((__nonnull__(1)));
+mapi_export MapiHdl mapi_poll(Mapi mid)
+	__attribute__((__nonnull__(1)));
 mapi_export MapiMsg mapi_cache_limit(Mapi mid, int limit)
 	__attribute__((__nonnull__(1)));
 mapi_export MapiMsg mapi_cache_freeup(MapiHdl hdl, int percentage)
@@ -220,6 +257,14 @@ mapi_export int mapi_fetch_row(MapiHdl hdl)
 	__attribute__((__nonnull__(1)));
 mapi_export int64_t mapi_fetch_all_rows(MapiHdl hdl)
 	__attribute__((__nonnull__(1)));
+mapi_export bool mapi_can_fetch_columns(MapiHdl hdl)
+	__attribute__((__nonnull__(1)));
+mapi_export int64_t mapi_fetch_columns(MapiHdl hdl)
+	__attribute__((__nonnull__(1)));
+mapi_export const void *mapi_get_column(MapiHdl hdl, int fnr)
+	__attribute__((__nonnull__(1)));
+mapi_export const char *mapi_fetch_column_field(MapiHdl hdl, int fnr, int64_t rownr)
+	__attribute__((__nonnull__(1)));
 mapi_export int mapi_get_field_count(MapiHdl hdl)
 	__attribute__((__nonnull__(1)));
 mapi_export int64_t mapi_get_row_count(MapiHdl hdl)
@@ -171,6 +171,31 @@ struct MapiRowBuf {
 	} *line;
 };
 
+/*
+ * With mapi_fetch_columns() a result set is fetched in chunks of rows
+ * that are decoded into one array of values per column.  The values
+ * either point into the binary message received from the server, or,
+ * for the rows that came with the query response as text, into mem.
+ */
+struct MapiColumnChunk {
+	char *buf;		/* binary message as received */
+	size_t size;		/* number of bytes in buf */
+	size_t lim;		/* allocated size of buf */
+	int64_t rows;		/* number of rows in the chunk */
+	int64_t next;		/* row # of first row of the next chunk */
+	int64_t step;		/* number of rows to ask for */
+	int ncols;
+	struct MapiColumnBuf {
+		int kind;	/* how values are decoded and formatted */
+		int width;	/* bytes per value */
+		int scale;	/* decimal scale or time precision */
+		const void *data;	/* the values of the current chunk */
+		void *mem;	/* decoded values not in buf */
+		size_t memsize;	/* allocated size of mem */
+		char text[64];	/* value formatted by mapi_fetch_column_field */
+	} *cols;
+};
+
 struct MapiResultSet {
 	struct MapiResultSet *next;
 	struct MapiStatement *hdl;
@@ -188,6 +213,7 @@ struct MapiResultSet {
 	char sqlstate[6];	/* the SQL state code */
 	struct MapiColumn *fields;
 	struct MapiRowBuf cache;
+	struct MapiColumnChunk *chunk;	/* for mapi_fetch_columns */
 	bool commentonly;	/* only comments seen so far */
 };
 
@@ -204,6 +230,11 @@ struct MapiStatement {
 	int npending_close;
 	bool needmore;		/* need more input */
 	bool aborted;		/* this query was aborted */
+	bool inflight;		/* sent by mapi_query_async, reply not read yet */
+	size_t inflight_size;	/* bytes sent by mapi_query_async */
+	mapi_async_callback callback;	/* called once the reply was read */
+	void *callback_data;
+	MapiHdl next_inflight;	/* next younger query in flight */
 	MapiHdl prev, next;
 };
 
@@ -246,10 +277,16 @@ struct MapiStruct {
 	int handshake_options;	/* which settings can be sent during challenge/response? */
 	bool columnar_protocol;
 	bool sizeheader;
+	bool streaming;		/* server sends rows while producing them */
 	bool oobintr;
 	bool clientinfo_supported;
+	bool binary;		/* server sends binary result set chunks */
 	MapiHdl first;		/* start of doubly-linked list */
 	MapiHdl active;		/* set when not all rows have been received */
+	MapiHdl inflight;	/* oldest query in flight, also active */
+	MapiHdl last_inflight;	/* youngest query in flight */
+	int ninflight;		/* number of queries in flight */
+	size_t inflight_size;	/* total bytes of the queries in flight */
 
 	int redircnt;		/* redirection count, used to cut of redirect loops */
 	int redirmax;		/* maximum redirects before giving up */
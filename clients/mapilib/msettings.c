@@ -75,6 +75,7 @@ by_name[] = {
 	{ .name="replysize", .parm=MP_REPLYSIZE },
 	{ .name="fetchsize", .parm=MP_REPLYSIZE },
 	{ .name="schema", .parm=MP_SCHEMA },
+	{ .name="shared_memory", .parm=MP_SHARED_MEMORY },
 	{ .name="sock", .parm=MP_SOCK },
 	{ .name="sockdir", .parm=MP_SOCKDIR},
 	{ .name="table", .parm=MP_TABLE },
@@ -82,6 +83,7 @@ by_name[] = {
 	{ .name="timezone", .parm=MP_TIMEZONE },
 	{ .name="tls", .parm=MP_TLS },
 	{ .name="user", .parm=MP_USER },
+	{ .name="wire_compression", .parm=MP_WIRE_COMPRESSION },
 	//
 	{ .name="logfile", .parm=MP_LOGFILE },
 	//
@@ -134,6 +136,7 @@ mparm_name(mparm parm)
 		case MP_REPLY_TIMEOUT: return "reply_timeout";  // underscore present means specific to this client library
 		case MP_REPLYSIZE: return "replysize";  // no underscore means mandatory for all client libraries
 		case MP_SCHEMA: return "schema";
+		case MP_SHARED_MEMORY: return "shared_memory";
 		case MP_SOCK: return "sock";
 		case MP_SOCKDIR: return "sockdir";
 		case MP_TABLE: return "table";
@@ -141,6 +144,7 @@ mparm_name(mparm parm)
 		case MP_TIMEZONE: return "timezone";
 		case MP_TLS: return "tls";
 		case MP_USER: return "user";
+		case MP_WIRE_COMPRESSION: return "wire_compression";
 		default: FATAL();
 	}
 }
@@ -166,6 +170,7 @@ const msettings msettings_default_values = {
 	.tls = false,
 	.autocommit = true,
 	.client_info = true,
+	.shared_memory = false,
 
 	.port = -1 ,
 	.timezone = 0,
@@ -677,6 +682,14 @@ msettings_validate(msettings *mp)
 		return format_error(mp, "clientcert can only be set together with clientkey");
 	}
 
+	// Parameter **wire_compression** must be empty, a boolean or the name
+	// of a compression method.
+	const char *compression = msetting_string(mp, MP_WIRE_COMPRESSION);
+	if (*compression && msetting_parse_bool(compression) < 0
+		&& strcmp(compression, "lz4") != 0 && strcmp(compression, "zstd") != 0) {
+		return format_error(mp, "invalid value '%s' for parameter 'wire_compression'", compression);
+	}
+
 	// compute this here so the getter function can take const msettings*
 	const char *sockdir = msetting_string(mp, MP_SOCKDIR);
 	long effective_port = msettings_connect_port(mp);
@@ -48,6 +48,7 @@ typedef enum mparm {
         MP_TLS = MP__BOOL_START,
         MP_AUTOCOMMIT,
 	MP_CLIENT_INFO,
+	MP_SHARED_MEMORY,
 	// Note: if you change anything about this enum whatsoever, make sure to
 	// make the corresponding change to struct msettings in msettings.c as well.
 
@@ -80,6 +81,7 @@ typedef enum mparm {
 	MP_LOGFILE,
 	MP_CLIENT_APPLICATION,
 	MP_CLIENT_REMARK,
+	MP_WIRE_COMPRESSION,
 	// Note: if you change anything about this enum whatsoever, make sure to
 	// make the corresponding change to struct msettings in msettings.c as well.
 
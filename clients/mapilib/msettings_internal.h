@@ -28,6 +28,7 @@ struct msettings {
 	bool tls;
 	bool autocommit;
 	bool client_info;
+	bool shared_memory;
 	bool dummy_end_bool;
 
 	// Must match EXACTLY the order of enum mparm
@@ -60,6 +61,7 @@ struct msettings {
 	struct string logfile;
 	struct string client_application;
 	struct string client_remark;
+	struct string wire_compression;
 	struct string dummy_end_string;
 
 	bool lang_is_mal;
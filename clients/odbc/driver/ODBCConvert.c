@@ -16,6 +16,8 @@
 #include <strings.h>		/* for strncasecmp */
 #endif
 #include <float.h>		/* for FLT_MAX */
+#include <limits.h>
+#include <math.h>		/* for isnan */
 
 #ifdef HAVE_HGE
 #define MAXBIGNUM10	(((uint128_t) UINT64_C(0x1999999999999999) << 64) | ((uint128_t) UINT64_C(0x9999999999999999)))
@@ -949,22 +951,24 @@ parsesecondintervalstring(char **svalp,
 	return SQL_SUCCESS;
 }
 
-SQLRETURN
-ODBCFetch(ODBCStmt *stmt,
-	  SQLUSMALLINT col,
-	  SQLSMALLINT type,
-	  SQLPOINTER ptr,
-	  SQLLEN buflen,
-	  SQLLEN *lenp,
-	  SQLLEN *nullp,
-	  SQLSMALLINT precision,
-	  SQLSMALLINT scale,
-	  SQLINTEGER datetime_interval_precision,
-	  SQLLEN offset,
-	  SQLULEN row)
+/* Convert the textual value data of column col of the current row
+ * to the requested C type.  data is NULL for a NULL value. */
+static SQLRETURN
+ODBCConvertField(ODBCStmt *stmt,
+		 SQLUSMALLINT col,
+		 char *data,
+		 size_t datalen,
+		 SQLSMALLINT type,
+		 SQLPOINTER ptr,
+		 SQLLEN buflen,
+		 SQLLEN *lenp,
+		 SQLLEN *nullp,
+		 SQLSMALLINT precision,
+		 SQLSMALLINT scale,
+		 SQLINTEGER datetime_interval_precision,
+		 SQLLEN offset,
+		 SQLULEN row)
 {
-	char *data;
-	size_t datalen;
 	SQLSMALLINT sql_type;
 	SQLUINTEGER maxdatetimeval;
 	ODBCDesc *ard, *ird;
@@ -1057,12 +1061,6 @@ ODBCFetch(ODBCStmt *stmt,
 	while (i-- > 0)
 		maxdatetimeval *= 10;
 
-	data = mapi_fetch_field(stmt->hdl, col - 1);
-	if (mapi_error(stmt->Dbc->mid)) {
-		/* General error */
-		addStmtError(stmt, "HY000", mapi_error_str(stmt->Dbc->mid), 0);
-		return SQL_ERROR;
-	}
 	if (nullp)
 		*nullp = SQL_NULL_DATA;
 	if (lenp)
@@ -1075,7 +1073,6 @@ ODBCFetch(ODBCStmt *stmt,
 		}
 		return SQL_SUCCESS;
 	}
-	datalen = mapi_fetch_field_len(stmt->hdl, col - 1);
 
 	/* first convert to internal (binary) format */
 
@@ -2939,6 +2936,316 @@ ODBCFetch(ODBCStmt *stmt,
 	return stmt->Error ? SQL_SUCCESS_WITH_INFO : SQL_SUCCESS;
 }
 
+SQLRETURN
+ODBCFetch(ODBCStmt *stmt,
+	  SQLUSMALLINT col,
+	  SQLSMALLINT type,
+	  SQLPOINTER ptr,
+	  SQLLEN buflen,
+	  SQLLEN *lenp,
+	  SQLLEN *nullp,
+	  SQLSMALLINT precision,
+	  SQLSMALLINT scale,
+	  SQLINTEGER datetime_interval_precision,
+	  SQLLEN offset,
+	  SQLULEN row)
+{
+	char *data;
+	size_t datalen;
+
+	assert(ptr != NULL);
+
+	if (col == 0 || col > stmt->ImplRowDescr->sql_desc_count) {
+		/* Invalid descriptor index */
+		addStmtError(stmt, "07009", NULL, 0);
+		return SQL_ERROR;
+	}
+	if (stmt->bulkFetch > 0 &&
+	    stmt->currentRow > stmt->chunkStart &&
+	    stmt->currentRow <= stmt->chunkStart + stmt->chunkRows) {
+		/* the current row is in the binary column chunk; the
+		 * text is not changed by the conversion */
+		data = (char *) mapi_fetch_column_field(stmt->hdl, col - 1, stmt->currentRow - 1 - stmt->chunkStart);
+		datalen = data ? strlen(data) : 0;
+	} else {
+		data = mapi_fetch_field(stmt->hdl, col - 1);
+		datalen = data ? mapi_fetch_field_len(stmt->hdl, col - 1) : 0;
+	}
+	if (mapi_error(stmt->Dbc->mid)) {
+		/* General error */
+		addStmtError(stmt, "HY000", mapi_error_str(stmt->Dbc->mid), 0);
+		return SQL_ERROR;
+	}
+	return ODBCConvertField(stmt, col, data, datalen, type, ptr, buflen,
+				lenp, nullp, precision, scale,
+				datetime_interval_precision, offset, row);
+}
+
+/* Fill rows row up to row + nrows of the array bound to column col
+ * with the rows first up to first + nrows of the current binary
+ * column chunk of the result set (see mapi_fetch_columns).  Integer,
+ * floating point, boolean and temporal values are copied from the
+ * typed column directly, other values are converted from the text
+ * that libmapi produces for them.  Rows of which the value cannot be
+ * converted are marked in RowStatusArray. */
+void
+ODBCFetchColumn(ODBCStmt *stmt,
+		SQLUSMALLINT col,
+		SQLLEN offset,
+		SQLULEN row,
+		int64_t first,
+		SQLULEN nrows,
+		SQLUSMALLINT *RowStatusArray)
+{
+	ODBCDescRec *ardrec = &stmt->ApplRowDescr->descRec[col];
+	ODBCDescRec *irdrec = &stmt->ImplRowDescr->descRec[col];
+	SQLINTEGER bind_type = stmt->ApplRowDescr->sql_desc_bind_type;
+	SQLSMALLINT sql_type = irdrec->sql_desc_concise_type;
+	SQLSMALLINT type = ardrec->sql_desc_concise_type;
+	const void *values = mapi_get_column(stmt->hdl, col - 1);
+	SQLINTEGER width = 0;	/* size of the C type if copied directly */
+	int64_t minval = 0, maxval = 0;
+
+	if (type == SQL_C_DEFAULT)
+		type = ODBCDefaultType(irdrec);
+
+	switch (type) {
+	case SQL_C_BIT:
+		if (sql_type == SQL_BIT)
+			width = sizeof(unsigned char);
+		break;
+	case SQL_C_STINYINT:
+	case SQL_C_TINYINT:
+		width = sizeof(signed char);
+		minval = SCHAR_MIN;
+		maxval = SCHAR_MAX;
+		break;
+	case SQL_C_SSHORT:
+	case SQL_C_SHORT:
+		width = sizeof(short);
+		minval = SHRT_MIN;
+		maxval = SHRT_MAX;
+		break;
+	case SQL_C_SLONG:
+	case SQL_C_LONG:
+		width = sizeof(int);
+		minval = INT_MIN;
+		maxval = INT_MAX;
+		break;
+	case SQL_C_SBIGINT:
+		width = sizeof(SQLBIGINT);
+		minval = INT64_MIN;
+		maxval = INT64_MAX;
+		break;
+	case SQL_C_FLOAT:
+		width = sizeof(float);
+		break;
+	case SQL_C_DOUBLE:
+		width = sizeof(double);
+		break;
+	case SQL_C_TYPE_DATE:
+		if (sql_type == SQL_TYPE_DATE)
+			width = sizeof(DATE_STRUCT);
+		break;
+	case SQL_C_TYPE_TIME:
+		if (sql_type == SQL_TYPE_TIME)
+			width = sizeof(TIME_STRUCT);
+		break;
+	case SQL_C_TYPE_TIMESTAMP:
+		if (sql_type == SQL_TYPE_TIMESTAMP)
+			width = sizeof(TIMESTAMP_STRUCT);
+		break;
+	}
+	switch (sql_type) {
+	case SQL_BIT:
+	case SQL_TINYINT:
+	case SQL_SMALLINT:
+	case SQL_INTEGER:
+	case SQL_BIGINT:
+	case SQL_REAL:
+	case SQL_DOUBLE:
+		/* numbers can go to any numeric C type we handle */
+		if (type == SQL_C_TYPE_DATE || type == SQL_C_TYPE_TIME ||
+		    type == SQL_C_TYPE_TIMESTAMP)
+			width = 0;
+		else if ((sql_type == SQL_REAL || sql_type == SQL_DOUBLE) &&
+			 type != SQL_C_FLOAT && type != SQL_C_DOUBLE)
+			width = 0;	/* needs rounding rules */
+		break;
+	case SQL_TYPE_DATE:
+	case SQL_TYPE_TIME:
+	case SQL_TYPE_TIMESTAMP:
+		/* only to the C type of the same kind, see above */
+		break;
+	default:
+		width = 0;
+		break;
+	}
+	if (values == NULL)
+		width = 0;
+
+	for (SQLULEN r = 0; r < nrows; r++, row++, first++) {
+		SQLPOINTER ptr = (SQLPOINTER) ((char *) ardrec->sql_desc_data_ptr + offset);
+		SQLLEN *lenp = ardrec->sql_desc_octet_length_ptr;
+		SQLLEN *nullp = ardrec->sql_desc_indicator_ptr;
+		bool isnull = false;
+		int64_t ival = 0;
+		double fval = 0;
+
+		if (width == 0) {
+			const char *data = mapi_fetch_column_field(stmt->hdl, col - 1, first);
+
+			irdrec->already_returned = -1;
+			if (ODBCConvertField(stmt, col, (char *) data,
+					     data ? strlen(data) : 0, type,
+					     ardrec->sql_desc_data_ptr,
+					     ardrec->sql_desc_octet_length,
+					     ardrec->sql_desc_octet_length_ptr,
+					     ardrec->sql_desc_indicator_ptr,
+					     ardrec->sql_desc_precision,
+					     ardrec->sql_desc_scale,
+					     ardrec->sql_desc_datetime_interval_precision,
+					     offset, row) == SQL_ERROR &&
+			    RowStatusArray)
+				WriteValue(&RowStatusArray[row], SQL_ROW_SUCCESS_WITH_INFO);
+			continue;
+		}
+
+		ptr = (SQLPOINTER) ((char *) ptr + row * (bind_type == SQL_BIND_BY_COLUMN ? width : bind_type));
+		if (lenp)
+			lenp = (SQLLEN *) ((char *) lenp + offset + row * (bind_type == SQL_BIND_BY_COLUMN ? (SQLINTEGER) sizeof(*lenp) : bind_type));
+		if (nullp)
+			nullp = (SQLLEN *) ((char *) nullp + offset + row * (bind_type == SQL_BIND_BY_COLUMN ? (SQLINTEGER) sizeof(*nullp) : bind_type));
+
+		/* the NULL representations are described in mapi.h */
+		switch (sql_type) {
+		case SQL_BIT:
+		case SQL_TINYINT:
+			ival = ((const int8_t *) values)[first];
+			isnull = ival == INT8_MIN;
+			break;
+		case SQL_SMALLINT:
+			ival = ((const int16_t *) values)[first];
+			isnull = ival == INT16_MIN;
+			break;
+		case SQL_INTEGER:
+			ival = ((const int32_t *) values)[first];
+			isnull = ival == INT32_MIN;
+			break;
+		case SQL_BIGINT:
+			ival = ((const int64_t *) values)[first];
+			isnull = ival == INT64_MIN;
+			break;
+		case SQL_REAL:
+			fval = ((const float *) values)[first];
+			isnull = isnan(fval);
+			break;
+		case SQL_DOUBLE:
+			fval = ((const double *) values)[first];
+			isnull = isnan(fval);
+			break;
+		case SQL_TYPE_DATE:
+			isnull = ((const MapiColumnDate *) values)[first].month == 0xFF;
+			break;
+		case SQL_TYPE_TIME:
+			isnull = ((const MapiColumnTime *) values)[first].hours == 0xFF;
+			break;
+		case SQL_TYPE_TIMESTAMP:
+			isnull = ((const MapiColumnTimestamp *) values)[first].date.month == 0xFF;
+			break;
+		}
+
+		if (nullp)
+			*nullp = SQL_NULL_DATA;
+		if (lenp)
+			*lenp = SQL_NULL_DATA;
+		if (isnull) {
+			if (nullp == NULL) {
+				/* Indicator variable required but not supplied */
+				addStmtError(stmt, "22002", NULL, 0);
+				if (RowStatusArray)
+					WriteValue(&RowStatusArray[row], SQL_ROW_SUCCESS_WITH_INFO);
+			}
+			continue;
+		}
+
+		switch (type) {
+		case SQL_C_FLOAT:
+		case SQL_C_DOUBLE:
+			if (sql_type != SQL_REAL && sql_type != SQL_DOUBLE)
+				fval = (double) ival;
+			if (type == SQL_C_DOUBLE) {
+				WriteData(ptr, fval, double);
+				break;
+			}
+			if (fval < -FLT_MAX || fval > FLT_MAX) {
+				/* Numeric value out of range */
+				addStmtError(stmt, "22003", NULL, 0);
+				if (RowStatusArray)
+					WriteValue(&RowStatusArray[row], SQL_ROW_SUCCESS_WITH_INFO);
+				continue;
+			}
+			WriteData(ptr, (float) fval, float);
+			break;
+		case SQL_C_TYPE_DATE: {
+			const MapiColumnDate *d = &((const MapiColumnDate *) values)[first];
+			WriteData(ptr, ((DATE_STRUCT) {.year = d->year, .month = d->month, .day = d->day}), DATE_STRUCT);
+			break;
+		}
+		case SQL_C_TYPE_TIME: {
+			const MapiColumnTime *t = &((const MapiColumnTime *) values)[first];
+			WriteData(ptr, ((TIME_STRUCT) {.hour = t->hours, .minute = t->minutes, .second = t->seconds}), TIME_STRUCT);
+			break;
+		}
+		case SQL_C_TYPE_TIMESTAMP: {
+			const MapiColumnTimestamp *ts = &((const MapiColumnTimestamp *) values)[first];
+			WriteData(ptr, ((TIMESTAMP_STRUCT) {
+					.year = ts->date.year,
+					.month = ts->date.month,
+					.day = ts->date.day,
+					.hour = ts->time.hours,
+					.minute = ts->time.minutes,
+					.second = ts->time.seconds,
+					.fraction = ts->time.usec * 1000,
+				}), TIMESTAMP_STRUCT);
+			break;
+		}
+		case SQL_C_BIT:
+			WriteData(ptr, (unsigned char) ival, unsigned char);
+			break;
+		default:
+			/* like ODBCFetch, the length is also set when the
+			 * value does not fit */
+			if (lenp)
+				*lenp = width;
+			if (ival < minval || ival > maxval) {
+				/* Numeric value out of range */
+				addStmtError(stmt, "22003", NULL, 0);
+				if (RowStatusArray)
+					WriteValue(&RowStatusArray[row], SQL_ROW_SUCCESS_WITH_INFO);
+				continue;
+			}
+			switch (width) {
+			case sizeof(signed char):
+				WriteData(ptr, (signed char) ival, signed char);
+				break;
+			case sizeof(short):
+				WriteData(ptr, (short) ival, short);
+				break;
+			case sizeof(int):
+				WriteData(ptr, (int) ival, int);
+				break;
+			default:
+				WriteData(ptr, (SQLBIGINT) ival, SQLBIGINT);
+				break;
+			}
+			break;
+		}
+		if (lenp)
+			*lenp = width;
+	}
+}
+
 #define assign(buf,bufpos,buflen,value,stmt)				\
 	do {								\
 		if (bufpos >= buflen) {					\
@@ -2975,6 +3282,58 @@ ODBCFetch(ODBCStmt *stmt,
 			buf[bufpos++] = (value)[_i];			\
 	} while (0)
 
+/* the size of one value in a column-wise bound array of parameters */
+static SQLLEN
+ODBCParamWidth(ODBCDescRec *apdrec, SQLSMALLINT ctype)
+{
+	switch (ctype) {
+	case SQL_C_BIT:
+	case SQL_C_STINYINT:
+	case SQL_C_UTINYINT:
+		return (SQLLEN) sizeof(unsigned char);
+	case SQL_C_SSHORT:
+	case SQL_C_USHORT:
+		return (SQLLEN) sizeof(short);
+	case SQL_C_SLONG:
+	case SQL_C_ULONG:
+		return (SQLLEN) sizeof(int);
+	case SQL_C_SBIGINT:
+	case SQL_C_UBIGINT:
+		return (SQLLEN) sizeof(SQLBIGINT);
+	case SQL_C_NUMERIC:
+		return (SQLLEN) sizeof(SQL_NUMERIC_STRUCT);
+	case SQL_C_FLOAT:
+		return (SQLLEN) sizeof(float);
+	case SQL_C_DOUBLE:
+		return (SQLLEN) sizeof(double);
+	case SQL_C_TYPE_DATE:
+		return (SQLLEN) sizeof(DATE_STRUCT);
+	case SQL_C_TYPE_TIME:
+		return (SQLLEN) sizeof(TIME_STRUCT);
+	case SQL_C_TYPE_TIMESTAMP:
+		return (SQLLEN) sizeof(TIMESTAMP_STRUCT);
+	case SQL_C_INTERVAL_YEAR:
+	case SQL_C_INTERVAL_MONTH:
+	case SQL_C_INTERVAL_YEAR_TO_MONTH:
+	case SQL_C_INTERVAL_DAY:
+	case SQL_C_INTERVAL_HOUR:
+	case SQL_C_INTERVAL_MINUTE:
+	case SQL_C_INTERVAL_SECOND:
+	case SQL_C_INTERVAL_DAY_TO_HOUR:
+	case SQL_C_INTERVAL_DAY_TO_MINUTE:
+	case SQL_C_INTERVAL_DAY_TO_SECOND:
+	case SQL_C_INTERVAL_HOUR_TO_MINUTE:
+	case SQL_C_INTERVAL_HOUR_TO_SECOND:
+	case SQL_C_INTERVAL_MINUTE_TO_SECOND:
+		return (SQLLEN) sizeof(SQL_INTERVAL_STRUCT);
+	case SQL_C_GUID:
+		return (SQLLEN) sizeof(SQLGUID);
+	default:
+		/* character and binary data: the buffer length */
+		return apdrec->sql_desc_octet_length;
+	}
+}
+
 SQLRETURN
 ODBCStore(ODBCStmt *stmt,
 	  SQLUSMALLINT param,
@@ -3011,20 +3370,6 @@ ODBCStore(ODBCStmt *stmt,
 	ipdrec = stmt->ImplParamDescr->descRec + param;
 	apdrec = stmt->ApplParamDescr->descRec + param;
 
-	bind_type = stmt->ApplParamDescr->sql_desc_bind_type;
-	ptr = apdrec->sql_desc_data_ptr;
-	if (ptr && offset)
-		ptr = (SQLPOINTER) ((char *) ptr + offset + row * (bind_type == SQL_BIND_BY_COLUMN ? (SQLINTEGER) sizeof(SQLPOINTER) : bind_type));
-	strlen_or_ind_ptr = apdrec->sql_desc_indicator_ptr;
-	if (strlen_or_ind_ptr && offset)
-		strlen_or_ind_ptr = (SQLLEN *) ((char *) strlen_or_ind_ptr + offset + row * (bind_type == SQL_BIND_BY_COLUMN ? (SQLINTEGER) sizeof(SQLINTEGER) : bind_type));
-	if (ptr == NULL &&
-	    (strlen_or_ind_ptr == NULL || *strlen_or_ind_ptr != SQL_NULL_DATA)) {
-		/* COUNT field incorrect */
-		addStmtError(stmt, "07002", NULL, 0);
-		return SQL_ERROR;
-	}
-
 	ctype = apdrec->sql_desc_concise_type;
 	sqltype = ipdrec->sql_desc_concise_type;
 	if (ctype == SQL_C_DEFAULT)
@@ -3044,6 +3389,20 @@ ODBCStore(ODBCStmt *stmt,
 		break;
 	}
 
+	bind_type = stmt->ApplParamDescr->sql_desc_bind_type;
+	ptr = apdrec->sql_desc_data_ptr;
+	if (ptr)
+		ptr = (SQLPOINTER) ((char *) ptr + offset + row * (bind_type == SQL_BIND_BY_COLUMN ? ODBCParamWidth(apdrec, ctype) : bind_type));
+	strlen_or_ind_ptr = apdrec->sql_desc_indicator_ptr;
+	if (strlen_or_ind_ptr)
+		strlen_or_ind_ptr = (SQLLEN *) ((char *) strlen_or_ind_ptr + offset + row * (bind_type == SQL_BIND_BY_COLUMN ? (SQLINTEGER) sizeof(*strlen_or_ind_ptr) : bind_type));
+	if (ptr == NULL &&
+	    (strlen_or_ind_ptr == NULL || *strlen_or_ind_ptr != SQL_NULL_DATA)) {
+		/* COUNT field incorrect */
+		addStmtError(stmt, "07002", NULL, 0);
+		return SQL_ERROR;
+	}
+
 	assigns(buf, bufpos, buflen, sep, stmt);
 	*bufp = buf;
 
@@ -3056,8 +3415,8 @@ ODBCStore(ODBCStmt *stmt,
 	}
 
 	strlen_or_ind_ptr = apdrec->sql_desc_octet_length_ptr;
-	if (strlen_or_ind_ptr && offset)
-		strlen_or_ind_ptr = (SQLLEN *) ((char *) strlen_or_ind_ptr + offset + row * (bind_type == SQL_BIND_BY_COLUMN ? (SQLINTEGER) sizeof(SQLINTEGER) : bind_type));
+	if (strlen_or_ind_ptr)
+		strlen_or_ind_ptr = (SQLLEN *) ((char *) strlen_or_ind_ptr + offset + row * (bind_type == SQL_BIND_BY_COLUMN ? (SQLINTEGER) sizeof(*strlen_or_ind_ptr) : bind_type));
 
 	switch (ctype) {
 	case SQL_C_CHAR:
@@ -75,6 +75,14 @@ typedef struct tODBCDRIVERSTMT {
 	SQLLEN startRow;
 	SQLLEN rowSetSize;
 
+	/* bulkFetch tells whether the result set is fetched in binary
+	   column chunks (1), row by row (-1) or not yet decided (0);
+	   chunkStart is the row number of the first row of the current
+	   chunk and chunkRows the number of rows in it */
+	int bulkFetch;
+	SQLLEN chunkStart;
+	SQLLEN chunkRows;
+
 	unsigned int currentCol; /* used by SQLGetData() */
 	SQLINTEGER retrieved;	/* amount of data retrieved */
 	int queryid;		/* the query to be executed */
@@ -180,6 +188,9 @@ SQLRETURN ODBCFetch(ODBCStmt *stmt, SQLUSMALLINT col, SQLSMALLINT type,
 		    SQLLEN *nullp, SQLSMALLINT precision, SQLSMALLINT scale,
 		    SQLINTEGER datetime_interval_precision, SQLLEN offset,
 		    SQLULEN row);
+void ODBCFetchColumn(ODBCStmt *stmt, SQLUSMALLINT col, SQLLEN offset,
+		     SQLULEN row, int64_t first, SQLULEN nrows,
+		     SQLUSMALLINT *RowStatusArray);
 SQLRETURN ODBCStore(ODBCStmt *stmt, SQLUSMALLINT param, SQLLEN offset,
 		    SQLULEN row, char **bufp, size_t *bufposp, size_t *buflenp,
 		    const char *sep);
@@ -119,6 +119,9 @@ ODBCInitResult(ODBCStmt *stmt)
 	stmt->rowSetSize = 0;
 	stmt->retrieved = 0;
 	stmt->currentCol = 0;
+	stmt->bulkFetch = 0;
+	stmt->chunkStart = 0;
+	stmt->chunkRows = 0;
 
       repeat:
 	errstr = mapi_result_error(hdl);
@@ -441,6 +444,8 @@ MNDBExecute(ODBCStmt *stmt)
 	ODBCDesc *desc;
 	SQLLEN offset;
 	long timeout;
+	SQLULEN row, nrows, nsent;
+	SQLUSMALLINT *operations, *status;
 
 	/* check statement cursor state, query should be prepared */
 	if (stmt->State == INITED ||
@@ -486,32 +491,60 @@ MNDBExecute(ODBCStmt *stmt)
 		if (mapi_query_handle(hdl, query) == MOK)
 			stmt->Dbc->qtimeout = stmt->qtimeout;
 	}
-	querypos = snprintf(query, querylen, "execute %d (", stmt->queryid);
-	/* XXX fill in parameter values */
+	querypos = snprintf(query, querylen, "execute %d ", stmt->queryid);
 	if (desc->sql_desc_bind_offset_ptr)
 		offset = *desc->sql_desc_bind_offset_ptr;
 	else
 		offset = 0;
-	sep = "";
-	for (i = 1; i <= stmt->nparams; i++) {
-		if (ODBCStore(stmt, i, offset, 0, &query, &querypos, &querylen, sep) == SQL_ERROR) {
-			if (query)
+	/* an array of parameter sets is sent as a single
+	 * "execute N (...),(...)" which the server runs in one go */
+	nrows = stmt->nparams > 0 && desc->sql_desc_array_size > 1 ? desc->sql_desc_array_size : 1;
+	operations = nrows > 1 ? desc->sql_desc_array_status_ptr : NULL;
+	status = nrows > 1 ? stmt->ImplParamDescr->sql_desc_array_status_ptr : NULL;
+	nsent = 0;
+	for (row = 0; row < nrows; row++) {
+		if (operations && operations[row] == SQL_PARAM_IGNORE) {
+			if (status)
+				status[row] = SQL_PARAM_UNUSED;
+			continue;
+		}
+		sep = nsent > 0 ? ",(" : "(";
+		for (i = 1; i <= stmt->nparams; i++) {
+			if (ODBCStore(stmt, i, offset, row, &query, &querypos, &querylen, sep) == SQL_ERROR) {
+				if (query)
+					free(query);
+				if (status)
+					status[row] = SQL_PARAM_ERROR;
+				return SQL_ERROR;
+			}
+			sep = ",";
+		}
+		if (querypos + 2 >= querylen) {
+			char *q = realloc(query, querylen += 10);
+			if (q == NULL) {
 				free(query);
-			return SQL_ERROR;
+				addStmtError(stmt, "HY001", NULL, 0);
+				return SQL_ERROR;
+			}
+			query = q;
 		}
-		sep = ",";
+		if (stmt->nparams == 0)
+			query[querypos++] = '(';
+		query[querypos++] = ')';
+		query[querypos] = 0;
+		nsent++;
 	}
-	if (querypos + 1 >= querylen) {
-		char *q = realloc(query, querylen += 10);
-		if (q == NULL) {
-			free(query);
-			addStmtError(stmt, "HY001", NULL, 0);
-			return SQL_ERROR;
-		}
-		query = q;
+	if (stmt->ImplParamDescr->sql_desc_rows_processed_ptr)
+		*stmt->ImplParamDescr->sql_desc_rows_processed_ptr = nsent;
+	if (nsent == 0) {
+		/* all parameter sets are ignored */
+		free(query);
+		stmt->State = EXECUTED0;
+		stmt->querytype = Q_UPDATE;
+		stmt->rowcount = 0;
+		setODBCDescRecCount(stmt->ImplRowDescr, 0);
+		return SQL_SUCCESS;
 	}
-	query[querypos++] = ')';
-	query[querypos] = 0;
 
 #ifdef ODBCDEBUG
 	ODBCLOG("SQLExecute %p %s\n", stmt, query);
@@ -531,6 +564,11 @@ MNDBExecute(ODBCStmt *stmt)
 	}
 	msg = mapi_query_handle(hdl, query);
 	free(query);
+	if (status) {
+		for (row = 0; row < nrows; row++)
+			if (operations == NULL || operations[row] != SQL_PARAM_IGNORE)
+				status[row] = msg == MOK ? SQL_PARAM_SUCCESS : SQL_PARAM_ERROR;
+	}
 	switch (msg) {
 	case MOK:
 		break;
@@ -558,6 +596,8 @@ MNDBExecute(ODBCStmt *stmt)
 
 	/* now get the result data and store it to our internal data structure */
 
+	/* the server reports one count of affected rows for all
+	 * parameter sets, see SQL_PARAM_ARRAY_ROW_COUNTS */
 	return ODBCInitResult(stmt);
 }
 
@@ -31,6 +31,92 @@
 #include "ODBCStmt.h"
 #include "ODBCUtil.h"
 
+/* Fetch a rowset into arrays of bound columns from the binary column
+ * chunks of libmapi, one column at a time.  This is only done for
+ * forward-only cursors, since the chunks can only be read in order.
+ * A rowset can span more than one chunk. */
+static SQLRETURN
+MNDBFetchColumns(ODBCStmt *stmt, SQLUSMALLINT *RowStatusArray)
+{
+	ODBCDesc *ard, *ird;
+	ODBCDescRec *rec;
+	int i;
+	SQLULEN row, n;
+	SQLLEN offset, pos;
+	int64_t rows;
+	long timeout;
+
+	ard = stmt->ApplRowDescr;
+	ird = stmt->ImplRowDescr;
+
+	if (stmt->startRow < stmt->chunkStart) {
+		/* Row value out of range */
+		addStmtError(stmt, "HY107", NULL, 0);
+		return SQL_ERROR;
+	}
+
+	stmt->State = FETCHED;
+
+	if (ard->sql_desc_bind_offset_ptr)
+		offset = *ard->sql_desc_bind_offset_ptr;
+	else
+		offset = 0;
+	for (i = 1; i <= ird->sql_desc_count; i++)
+		ird->descRec[i].already_returned = -1;
+	for (row = 0; row < ard->sql_desc_array_size; row += n) {
+		pos = stmt->startRow + (SQLLEN) row;
+		if (pos >= stmt->chunkStart + stmt->chunkRows) {
+			stmt->chunkStart += stmt->chunkRows;
+			stmt->chunkRows = 0;
+			rows = mapi_fetch_columns(stmt->hdl);
+			if (rows < 0) {
+				if (RowStatusArray)
+					WriteValue(&RowStatusArray[row], SQL_ROW_ERROR);
+				if (mapi_error(stmt->Dbc->mid) == MTIMEOUT) {
+					/* Connection timeout expired / Communication link failure */
+					timeout = msetting_long(stmt->Dbc->settings, MP_REPLY_TIMEOUT);
+					addStmtError(stmt, timeout > 0 ? "HYT01" : "08S01", mapi_error_str(stmt->Dbc->mid), 0);
+				} else {
+					/* General error */
+					addStmtError(stmt, "HY000", mapi_error_str(stmt->Dbc->mid), 0);
+				}
+				return SQL_ERROR;
+			}
+			if (rows == 0)
+				break;
+			stmt->chunkRows = (SQLLEN) rows;
+			n = 0;
+			continue;
+		}
+		n = (SQLULEN) (stmt->chunkStart + stmt->chunkRows - pos);
+		if (n > ard->sql_desc_array_size - row)
+			n = ard->sql_desc_array_size - row;
+		if (RowStatusArray)
+			for (SQLULEN r = row; r < row + n; r++)
+				WriteValue(&RowStatusArray[r], SQL_ROW_SUCCESS);
+		for (i = 1; i <= ard->sql_desc_count && i <= ird->sql_desc_count; i++) {
+			rec = &ard->descRec[i];
+			if (rec->sql_desc_data_ptr == NULL)
+				continue;
+			ODBCFetchColumn(stmt, i, offset, row,
+					(int64_t) (pos - stmt->chunkStart), n,
+					RowStatusArray);
+		}
+	}
+	if (row == 0)
+		return SQL_NO_DATA;
+	stmt->rowSetSize = (SQLLEN) row;
+
+	if (ird->sql_desc_rows_processed_ptr)
+		*ird->sql_desc_rows_processed_ptr = (SQLULEN) stmt->rowSetSize;
+
+	if (RowStatusArray)
+		for (; row < ard->sql_desc_array_size; row++)
+			WriteValue(&RowStatusArray[row], SQL_ROW_NOROW);
+
+	return stmt->Error ? SQL_SUCCESS_WITH_INFO : SQL_SUCCESS;
+}
+
 SQLRETURN
 MNDBFetch(ODBCStmt *stmt, SQLUSMALLINT *RowStatusArray)
 {
@@ -52,6 +138,19 @@ MNDBFetch(ODBCStmt *stmt, SQLUSMALLINT *RowStatusArray)
 
 	stmt->rowSetSize = 0;
 	stmt->currentRow = stmt->startRow + 1;
+
+	/* decide at the first fetch whether the result set is read in
+	 * binary column chunks: that saves converting all values to
+	 * text on the server and parsing them again here */
+	if (stmt->bulkFetch == 0)
+		stmt->bulkFetch = stmt->startRow == 0 &&
+			stmt->retrieveData == SQL_RD_ON &&
+			stmt->cursorType == SQL_CURSOR_FORWARD_ONLY &&
+			ard->sql_desc_array_size > 1 &&
+			mapi_can_fetch_columns(stmt->hdl) ? 1 : -1;
+	if (stmt->bulkFetch > 0 && stmt->retrieveData == SQL_RD_ON)
+		return MNDBFetchColumns(stmt, RowStatusArray);
+
 	if (mapi_seek_row(stmt->hdl, stmt->startRow, MAPI_SEEK_SET) != MOK) {
 		/* Row value out of range */
 		addStmtError(stmt, "HY107", mapi_error_str(stmt->Dbc->mid), 0);
@@ -0,0 +1,340 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * For copyright information, see the file debian/copyright.
+ */
+
+/* Fetch a result set into arrays of bound columns with a rowset size
+ * larger than one, which the driver reads in binary column chunks,
+ * and compare every row, indicator and row status with those of
+ * fetching the same result set one row at a time.  The result set is
+ * larger than the rows sent with the query and than one binary chunk,
+ * it has NULLs in every column, and values that are truncated or out
+ * of range for the C type they are bound to. */
+
+#ifdef _MSC_VER
+#include <WTypes.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <inttypes.h>
+
+/**** Define the ODBC Version our ODBC driver complies with ****/
+#define ODBCVER 0x0352		/* Important: this must be defined before include of sql.h and sqlext.h */
+#include <sql.h>
+#include <sqlext.h>
+
+#define NROWS		200000
+#define MAXROWSET	1000
+
+static void
+prerr(SQLSMALLINT tpe, SQLHANDLE hnd, const char *func, const char *pref)
+{
+	SQLCHAR state[SQL_SQLSTATE_SIZE +1];
+	SQLINTEGER errnr;
+	SQLCHAR msg[256];
+	SQLSMALLINT msglen;
+	SQLRETURN ret;
+
+	ret = SQLGetDiagRec(tpe, hnd, 1, state, &errnr, msg, sizeof(msg), &msglen);
+	switch (ret) {
+	case SQL_SUCCESS_WITH_INFO:
+		if (msglen >= (signed int) sizeof(msg))
+			fprintf(stderr, "(message truncated)\n");
+		/* fall through */
+	case SQL_SUCCESS:
+		fprintf(stderr, "%s: %s: SQLstate %s, Errnr %d, Message %s\n", func, pref, (char*)state, (int)errnr, (char*)msg);
+		break;
+	case SQL_INVALID_HANDLE:
+		fprintf(stderr, "%s: %s, invalid handle passed to error function\n", func, pref);
+		break;
+	case SQL_ERROR:
+		fprintf(stderr, "%s: %s, unexpected error from SQLGetDiagRec\n", func, pref);
+		break;
+	case SQL_NO_DATA:
+		break;
+	default:
+		fprintf(stderr, "%s: %s, weird return value from SQLGetDiagRec\n", func, pref);
+		break;
+	}
+}
+
+static void
+check(SQLRETURN ret, SQLSMALLINT tpe, SQLHANDLE hnd, const char *func)
+{
+	switch (ret) {
+	case SQL_SUCCESS:
+		break;
+	case SQL_SUCCESS_WITH_INFO:
+		prerr(tpe, hnd, func, "Info");
+		break;
+	case SQL_ERROR:
+		prerr(tpe, hnd, func, "Error");
+		break;
+	case SQL_NO_DATA:
+		break;
+	case SQL_INVALID_HANDLE:
+		fprintf(stderr, "%s: Error: invalid handle\n", func);
+		break;
+	default:
+		fprintf(stderr, "%s: Unexpected return value\n", func);
+		break;
+	}
+}
+
+static const char *query =
+	"SELECT i, b, s, d, r, t, dt, tm, ts, v, dc, d FROM odbcbulkfetch ORDER BY i";
+
+/* the bound column arrays */
+static SQLINTEGER ic[MAXROWSET];
+static SQLBIGINT bc[MAXROWSET];
+static SQLSMALLINT sc[MAXROWSET];
+static SQLDOUBLE dc[MAXROWSET];
+static SQLREAL rc[MAXROWSET];
+static unsigned char tc[MAXROWSET];
+static DATE_STRUCT dtc[MAXROWSET];
+static TIME_STRUCT tmc[MAXROWSET];
+static TIMESTAMP_STRUCT tsc[MAXROWSET];
+static char vc[MAXROWSET][12];
+static char dcc[MAXROWSET][16];
+static SQLINTEGER d2ic[MAXROWSET];
+static SQLLEN ind[12][MAXROWSET];
+static SQLUSMALLINT status[MAXROWSET];
+
+/* one row of the rowset as text, with values only where the indicator
+ * says there is one */
+static void
+formatRow(char *buf, size_t len, SQLULEN i)
+{
+	size_t pos = 0;
+
+	pos += snprintf(buf + pos, len - pos, "%u", (unsigned) status[i]);
+	if (status[i] == SQL_ROW_ERROR)
+		return;
+	for (int c = 0; c < 12; c++)
+		pos += snprintf(buf + pos, len - pos, "|%ld", (long) ind[c][i]);
+	if (ind[0][i] >= 0)
+		pos += snprintf(buf + pos, len - pos, "|%d", (int) ic[i]);
+	if (ind[1][i] >= 0)
+		pos += snprintf(buf + pos, len - pos, "|%" PRId64, (int64_t) bc[i]);
+	if (ind[2][i] >= 0)
+		pos += snprintf(buf + pos, len - pos, "|%d", (int) sc[i]);
+	if (ind[3][i] >= 0)
+		pos += snprintf(buf + pos, len - pos, "|%.17g", dc[i]);
+	if (ind[4][i] >= 0)
+		pos += snprintf(buf + pos, len - pos, "|%.9g", rc[i]);
+	if (ind[5][i] >= 0)
+		pos += snprintf(buf + pos, len - pos, "|%u", (unsigned) tc[i]);
+	if (ind[6][i] >= 0)
+		pos += snprintf(buf + pos, len - pos, "|%d-%u-%u",
+				(int) dtc[i].year, (unsigned) dtc[i].month,
+				(unsigned) dtc[i].day);
+	if (ind[7][i] >= 0)
+		pos += snprintf(buf + pos, len - pos, "|%u:%u:%u",
+				(unsigned) tmc[i].hour, (unsigned) tmc[i].minute,
+				(unsigned) tmc[i].second);
+	if (ind[8][i] >= 0)
+		pos += snprintf(buf + pos, len - pos, "|%d-%u-%u %u:%u:%u.%u",
+				(int) tsc[i].year, (unsigned) tsc[i].month,
+				(unsigned) tsc[i].day, (unsigned) tsc[i].hour,
+				(unsigned) tsc[i].minute, (unsigned) tsc[i].second,
+				(unsigned) tsc[i].fraction);
+	if (ind[9][i] >= 0)
+		pos += snprintf(buf + pos, len - pos, "|%s", vc[i]);
+	if (ind[10][i] >= 0)
+		pos += snprintf(buf + pos, len - pos, "|%s", dcc[i]);
+	if (ind[11][i] >= 0)
+		snprintf(buf + pos, len - pos, "|%d", (int) d2ic[i]);
+}
+
+static uint64_t
+hashRow(const char *s)
+{
+	uint64_t h = 14695981039346656037ULL;
+
+	while (*s)
+		h = (h ^ (unsigned char) *s++) * 1099511628211ULL;
+	return h;
+}
+
+/* Fetch the result of the query with the given rowset size, with
+ * SQLFetchScroll if scroll is set, else with SQLFetch.  If compare is
+ * set, compare the hash of every row with ref, else store it there.
+ * Returns the number of rows fetched. */
+static SQLULEN
+fetchAll(SQLHANDLE stmt, SQLULEN rowsetsize, int scroll, uint64_t *ref, int compare)
+{
+	SQLRETURN ret;
+	SQLULEN fetched = 0, nrows = 0;
+	char buf[512];
+	int ndiffs = 0;
+
+	ret = SQLSetStmtAttr(stmt, SQL_ATTR_ROW_ARRAY_SIZE, (SQLPOINTER) (uintptr_t) rowsetsize, 0);
+	check(ret, SQL_HANDLE_STMT, stmt, "SQLSetStmtAttr (SQL_ATTR_ROW_ARRAY_SIZE)");
+	ret = SQLSetStmtAttr(stmt, SQL_ATTR_ROW_STATUS_PTR, status, 0);
+	check(ret, SQL_HANDLE_STMT, stmt, "SQLSetStmtAttr (SQL_ATTR_ROW_STATUS_PTR)");
+	ret = SQLSetStmtAttr(stmt, SQL_ATTR_ROWS_FETCHED_PTR, &fetched, 0);
+	check(ret, SQL_HANDLE_STMT, stmt, "SQLSetStmtAttr (SQL_ATTR_ROWS_FETCHED_PTR)");
+
+	ret = SQLExecDirect(stmt, (SQLCHAR *) query, SQL_NTS);
+	check(ret, SQL_HANDLE_STMT, stmt, "SQLExecDirect (select)");
+	if (!SQL_SUCCEEDED(ret))
+		return 0;
+
+	SQLBindCol(stmt, 1, SQL_C_SLONG, ic, 0, ind[0]);
+	SQLBindCol(stmt, 2, SQL_C_SBIGINT, bc, 0, ind[1]);
+	/* int values beyond the range of a smallint */
+	SQLBindCol(stmt, 3, SQL_C_SSHORT, sc, 0, ind[2]);
+	SQLBindCol(stmt, 4, SQL_C_DOUBLE, dc, 0, ind[3]);
+	SQLBindCol(stmt, 5, SQL_C_FLOAT, rc, 0, ind[4]);
+	SQLBindCol(stmt, 6, SQL_C_BIT, tc, 0, ind[5]);
+	SQLBindCol(stmt, 7, SQL_C_TYPE_DATE, dtc, 0, ind[6]);
+	SQLBindCol(stmt, 8, SQL_C_TYPE_TIME, tmc, 0, ind[7]);
+	SQLBindCol(stmt, 9, SQL_C_TYPE_TIMESTAMP, tsc, 0, ind[8]);
+	/* strings longer than the buffer are truncated */
+	SQLBindCol(stmt, 10, SQL_C_CHAR, vc, sizeof(vc[0]), ind[9]);
+	/* decimals are converted from their text */
+	SQLBindCol(stmt, 11, SQL_C_CHAR, dcc, sizeof(dcc[0]), ind[10]);
+	/* doubles with a fraction are truncated to integers */
+	SQLBindCol(stmt, 12, SQL_C_SLONG, d2ic, 0, ind[11]);
+
+	for (;;) {
+		/* values that are out of range are not written, so what is
+		 * left in the buffer must not depend on earlier rows */
+		memset(sc, 0, sizeof(sc));
+		if (scroll)
+			ret = SQLFetchScroll(stmt, SQL_FETCH_NEXT, 0);
+		else
+			ret = SQLFetch(stmt);
+		if (ret == SQL_NO_DATA)
+			break;
+		/* errors in single rows are reported in the row status */
+		if (ret == SQL_ERROR && (rowsetsize > 1 || fetched != 1)) {
+			check(ret, SQL_HANDLE_STMT, stmt, scroll ? "SQLFetchScroll" : "SQLFetch");
+			break;
+		}
+		for (SQLULEN i = 0; i < fetched; i++, nrows++) {
+			if (nrows >= NROWS) {
+				fprintf(stderr, "more than %d rows fetched\n", NROWS);
+				break;
+			}
+			formatRow(buf, sizeof(buf), i);
+			if (!compare)
+				ref[nrows] = hashRow(buf);
+			else if (ref[nrows] != hashRow(buf) && ndiffs++ < 10)
+				fprintf(stderr, "rowset size %lu%s: row %lu differs: %s\n",
+					(unsigned long) rowsetsize,
+					scroll ? " (SQLFetchScroll)" : "",
+					(unsigned long) nrows, buf);
+		}
+	}
+
+	ret = SQLCloseCursor(stmt);
+	check(ret, SQL_HANDLE_STMT, stmt, "SQLCloseCursor");
+	ret = SQLFreeStmt(stmt, SQL_UNBIND);
+	check(ret, SQL_HANDLE_STMT, stmt, "SQLFreeStmt (SQL_UNBIND)");
+	return nrows;
+}
+
+int
+main(int argc, char **argv)
+{
+	SQLRETURN ret;
+	SQLHANDLE env;
+	SQLHANDLE dbc;
+	SQLHANDLE stmt;
+	char *dsn = "MonetDB";
+	char *user = "monetdb";
+	char *pass = "monetdb";
+	uint64_t *ref;
+	SQLULEN n;
+
+	if (argc > 1)
+		dsn = argv[1];
+	if (argc > 2)
+		user = argv[2];
+	if (argc > 3)
+		pass = argv[3];
+	if (argc > 4 || *dsn == '-') {
+		fprintf(stderr, "Wrong arguments. Usage: %s [datasource [user [password]]]\n", argv[0]);
+		exit(1);
+	}
+
+	if ((ref = malloc(NROWS * sizeof(uint64_t))) == NULL) {
+		fprintf(stderr, "Cannot allocate memory\n");
+		exit(1);
+	}
+
+	ret = SQLAllocHandle(SQL_HANDLE_ENV, NULL, &env);
+	if (ret != SQL_SUCCESS) {
+		fprintf(stderr, "Cannot allocate ODBC environment handle!\n");
+		exit(1);
+	}
+
+	ret = SQLSetEnvAttr(env, SQL_ATTR_ODBC_VERSION, (SQLPOINTER) (uintptr_t) SQL_OV_ODBC3, 0);
+	check(ret, SQL_HANDLE_ENV, env, "SQLSetEnvAttr (SQL_ATTR_ODBC_VERSION ODBC3)");
+
+	ret = SQLAllocHandle(SQL_HANDLE_DBC, env, &dbc);
+	check(ret, SQL_HANDLE_ENV, env, "SQLAllocHandle (DBC)");
+
+	ret = SQLConnect(dbc, (SQLCHAR *) dsn, SQL_NTS, (SQLCHAR *) user, SQL_NTS, (SQLCHAR *) pass, SQL_NTS);
+	check(ret, SQL_HANDLE_DBC, dbc, "SQLConnect");
+	if (!SQL_SUCCEEDED(ret))
+		exit(1);
+
+	ret = SQLAllocHandle(SQL_HANDLE_STMT, dbc, &stmt);
+	check(ret, SQL_HANDLE_DBC, dbc, "SQLAllocHandle (STMT)");
+
+	ret = SQLExecDirect(stmt, (SQLCHAR *)
+		"CREATE TABLE odbcbulkfetch (i int, b bigint, s int, d double, r real,"
+		" t boolean, dt date, tm time, ts timestamp(3), v varchar(20),"
+		" dc decimal(12,3))", SQL_NTS);
+	check(ret, SQL_HANDLE_STMT, stmt, "SQLExecDirect (create table)");
+	ret = SQLExecDirect(stmt, (SQLCHAR *)
+		"INSERT INTO odbcbulkfetch SELECT value,"
+		" CASE WHEN value % 11 = 0 THEN NULL ELSE value * 100000007 - 9000000000000 END,"
+		" CASE WHEN value % 13 = 0 THEN NULL ELSE (value * 7) % 50000 - 10000 END,"
+		" CASE WHEN value % 17 = 0 THEN NULL ELSE value / 3.0 - 20000 END,"
+		" CASE WHEN value % 19 = 0 THEN NULL ELSE value / 7.0 END,"
+		" CASE WHEN value % 23 = 0 THEN NULL ELSE value % 2 = 0 END,"
+		" CASE WHEN value % 29 = 0 THEN NULL ELSE date '1900-01-01' + value * interval '1' day END,"
+		" CASE WHEN value % 31 = 0 THEN NULL ELSE time '00:00:00' + value * interval '1' second END,"
+		" CASE WHEN value % 37 = 0 THEN NULL ELSE timestamp '1970-01-01 00:00:00' + value * interval '12345.678' second END,"
+		" CASE WHEN value % 41 = 0 THEN NULL ELSE repeat('v', value % 15) || value END,"
+		" CASE WHEN value % 43 = 0 THEN NULL ELSE value * 1.125 - 100000 END"
+		" FROM generate_series(0, 200000)", SQL_NTS);
+	check(ret, SQL_HANDLE_STMT, stmt, "SQLExecDirect (insert)");
+
+	/* one row at a time, which is converted from the text of the row */
+	if ((n = fetchAll(stmt, 1, 0, ref, 0)) != NROWS)
+		fprintf(stderr, "rowset size 1: %lu rows instead of %d\n", (unsigned long) n, NROWS);
+	/* rowsets that straddle the rows sent with the query and the chunks */
+	if ((n = fetchAll(stmt, 7, 0, ref, 1)) != NROWS)
+		fprintf(stderr, "rowset size 7: %lu rows instead of %d\n", (unsigned long) n, NROWS);
+	if ((n = fetchAll(stmt, MAXROWSET, 1, ref, 1)) != NROWS)
+		fprintf(stderr, "rowset size %d: %lu rows instead of %d\n", MAXROWSET, (unsigned long) n, NROWS);
+
+	ret = SQLExecDirect(stmt, (SQLCHAR *) "DROP TABLE odbcbulkfetch", SQL_NTS);
+	check(ret, SQL_HANDLE_STMT, stmt, "SQLExecDirect (drop table)");
+
+	ret = SQLFreeHandle(SQL_HANDLE_STMT, stmt);
+	check(ret, SQL_HANDLE_STMT, stmt, "SQLFreeHandle (STMT)");
+
+	ret = SQLDisconnect(dbc);
+	check(ret, SQL_HANDLE_DBC, dbc, "SQLDisconnect");
+
+	ret = SQLFreeHandle(SQL_HANDLE_DBC, dbc);
+	check(ret, SQL_HANDLE_DBC, dbc, "SQLFreeHandle (DBC)");
+
+	ret = SQLFreeHandle(SQL_HANDLE_ENV, env);
+	check(ret, SQL_HANDLE_ENV, env, "SQLFreeHandle (ENV)");
+
+	free(ref);
+	return 0;
+}
@@ -20,6 +20,7 @@ function(monetdb_configure_defines)
   find_path(HAVE_GETOPT_H "getopt.h")
   check_include_file("glob.h" HAVE_GLOB_H)
   check_include_file("kvm.h" HAVE_KVM_H)
+  check_include_file("linux/perf_event.h" HAVE_LINUX_PERF_EVENT_H)
   check_include_file("mach/mach_init.h" HAVE_MACH_MACH_INIT_H)
   check_include_file("mach/task.h" HAVE_MACH_TASK_H)
   check_include_file("mach-o/dyld.h" HAVE_MACH_O_DYLD_H)
@@ -85,6 +86,8 @@ function(monetdb_configure_defines)
   check_symbol_exists("madvise" "sys/mman.h" HAVE_MADVISE)
   check_function_exists("malloc_info" HAVE_MALLOC_INFO)
   check_function_exists("mallinfo2" HAVE_MALLINFO2)
+  # Linux specific
+  check_symbol_exists("memfd_create" "sys/mman.h" HAVE_MEMFD_CREATE)
   check_symbol_exists("mremap" "sys/mman.h" HAVE_MREMAP)
   check_function_exists("nanosleep" HAVE_NANOSLEEP)
   check_function_exists("nl_langinfo" HAVE_NL_LANGINFO)
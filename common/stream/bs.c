@@ -19,6 +19,137 @@
  * indicated by an empty block (i.e. just a count of 0).
  */
 
+/* Once compression has been negotiated, the payload of each non-empty
+ * block is compressed before it is written.  The compressor keeps its
+ * history across blocks, so even small blocks compress well, but it
+ * means that the reader must see every compressed block in order.
+ * Compressed blocks have the high bit of the count set; the remaining
+ * bits hold the compressed size shifted left by one plus the flush
+ * bit, as usual.  Uncompressed blocks are still accepted, which is what
+ * an empty flush block always is. */
+#define BS_COMPRESSED	0x8000
+#define BS_MAXCOMPRESSED ((BS_COMPRESSED - 1) >> 1)
+
+/* the LZ4 history: 64KiB of previous blocks plus room for the next one */
+#define BS_RINGSIZE	(64 * 1024 + 2 * BLOCK)
+
+struct bs_codec {
+	enum {
+		BS_LZ4,
+		BS_ZSTD,
+	} method;
+#ifdef HAVE_LIBLZ4
+	LZ4_stream_t *lz4c;
+	LZ4_streamDecode_t *lz4d;
+	char *ring;
+	size_t ringpos;
+#endif
+#ifdef HAVE_ZSTD
+	ZSTD_CCtx *zc;
+	ZSTD_DCtx *zd;
+#endif
+	char cbuf[BS_MAXCOMPRESSED];
+};
+
+static void
+bs_codec_destroy(struct bs_codec *c)
+{
+	if (c == NULL)
+		return;
+#ifdef HAVE_LIBLZ4
+	if (c->lz4c)
+		LZ4_freeStream(c->lz4c);
+	if (c->lz4d)
+		LZ4_freeStreamDecode(c->lz4d);
+	free(c->ring);
+#endif
+#ifdef HAVE_ZSTD
+	if (c->zc)
+		ZSTD_freeCCtx(c->zc);
+	if (c->zd)
+		ZSTD_freeDCtx(c->zd);
+#endif
+	free(c);
+}
+
+/* Compress len bytes from src into c->cbuf, return the compressed size
+ * or -1 on failure. */
+static ssize_t
+bs_compress(struct bs_codec *c, const char *src, size_t len)
+{
+	assert(len <= BLOCK);
+	switch (c->method) {
+#ifdef HAVE_LIBLZ4
+	case BS_LZ4: {
+		/* the compressor refers back to earlier blocks, so they
+		 * have to stay where they are */
+		char *dst = c->ring + c->ringpos;
+		memcpy(dst, src, len);
+		int n = LZ4_compress_fast_continue(c->lz4c, dst, c->cbuf, (int) len,
+										   (int) sizeof(c->cbuf), 1);
+		c->ringpos += len;
+		if (c->ringpos + BLOCK > BS_RINGSIZE)
+			c->ringpos = 0;
+		return n > 0 ? (ssize_t) n : -1;
+	}
+#endif
+#ifdef HAVE_ZSTD
+	case BS_ZSTD: {
+		ZSTD_inBuffer in = { .src = src, .size = len };
+		ZSTD_outBuffer out = { .dst = c->cbuf, .size = sizeof(c->cbuf) };
+		size_t r = ZSTD_compressStream2(c->zc, &out, &in, ZSTD_e_flush);
+		if (ZSTD_isError(r) || r != 0 || in.pos != in.size)
+			return -1;
+		return (ssize_t) out.pos;
+	}
+#endif
+	default:
+		(void) src;
+		(void) len;
+		return -1;
+	}
+}
+
+/* Decompress len bytes from c->cbuf into dst (which can hold BLOCK
+ * bytes), return the decompressed size or -1 on failure. */
+static ssize_t
+bs_decompress(struct bs_codec *c, size_t len, char *dst)
+{
+	switch (c->method) {
+#ifdef HAVE_LIBLZ4
+	case BS_LZ4: {
+		/* mirror the compressor's use of the ring buffer */
+		char *src = c->ring + c->ringpos;
+		int n = LZ4_decompress_safe_continue(c->lz4d, c->cbuf, src,
+											 (int) len, BLOCK);
+		if (n < 0)
+			return -1;
+		memcpy(dst, src, (size_t) n);
+		c->ringpos += (size_t) n;
+		if (c->ringpos + BLOCK > BS_RINGSIZE)
+			c->ringpos = 0;
+		return n;
+	}
+#endif
+#ifdef HAVE_ZSTD
+	case BS_ZSTD: {
+		ZSTD_inBuffer in = { .src = c->cbuf, .size = len };
+		ZSTD_outBuffer out = { .dst = dst, .size = BLOCK };
+		while (in.pos < in.size) {
+			size_t r = ZSTD_decompressStream(c->zd, &out, &in);
+			if (ZSTD_isError(r) || (out.pos == out.size && in.pos < in.size))
+				return -1;
+		}
+		return (ssize_t) out.pos;
+	}
+#endif
+	default:
+		(void) len;
+		(void) dst;
+		return -1;
+	}
+}
+
 static bs *
 bs_create(void)
 {
@@ -36,6 +167,63 @@ bs_create(void)
 	return ns;
 }
 
+/* Write the contents of the internal buffer as a single block to the
+ * underlying stream, compressed if so negotiated.  The low-order bit
+ * of the count tells the receiver whether this is the last block
+ * before a flush. */
+static int
+bs_writeblock(stream *ss, bs *s, bool flush)
+{
+	const char *data = s->buf;
+	size_t len = s->nr;
+	uint16_t blksize;
+
+#ifdef BSTREAM_DEBUG
+	{
+		unsigned i;
+
+		fprintf(stderr, "W %s %u \"", ss->name, s->nr);
+		for (i = 0; i < s->nr; i++)
+			if (' ' <= s->buf[i] && s->buf[i] < 127)
+				putc(s->buf[i], stderr);
+			else
+				fprintf(stderr, "\\%03o", (unsigned char) s->buf[i]);
+		fprintf(stderr, "\"\n");
+	}
+#endif
+	/* since the block is at max BLOCK (8K) - 2 size we can
+	 * store it in a two byte integer */
+	blksize = (uint16_t) (len << 1);
+	if (s->codec && len > 0) {
+		ssize_t n = bs_compress(s->codec, s->buf, len);
+		if (n < 0 || n > BS_MAXCOMPRESSED) {
+			mnstr_set_error(ss, MNSTR_WRITE_ERROR, "block compression failed");
+			s->nr = 0; /* data is lost due to error */
+			return -1;
+		}
+		data = s->codec->cbuf;
+		len = (size_t) n;
+		blksize = (uint16_t) (len << 1 | BS_COMPRESSED);
+	}
+	s->bytes += s->nr;
+	if (flush)
+		blksize |= 1;
+	if (!mnstr_writeSht(ss->inner, (int16_t) blksize) ||
+	    (len > 0 &&
+	     ss->inner->write(ss->inner, data, 1, len) != (ssize_t) len)) {
+		if (mnstr_errnr(ss->inner) != MNSTR_NO__ERROR) {
+			mnstr_copy_error(ss, ss->inner);
+		} else {
+			mnstr_set_error(ss, MNSTR_WRITE_ERROR, "connection closed unexpectedly");
+		}
+		s->nr = 0; /* data is lost due to error */
+		return -1;
+	}
+	s->blks++;
+	s->nr = 0;
+	return 0;
+}
+
 /* Collect data until the internal buffer is filled, then write the
  * filled buffer to the underlying stream.
  * Struct field usage:
@@ -51,7 +239,6 @@ bs_write(stream *restrict ss, const void *restrict buf, size_t elmsize, size_t c
 {
 	bs *s;
 	size_t todo = cnt * elmsize;
-	uint16_t blksize;
 
 	s = (bs *) ss->stream_data.p;
 	if (s == NULL)
@@ -68,42 +255,10 @@ bs_write(stream *restrict ss, const void *restrict buf, size_t elmsize, size_t c
 		todo -= n;
 		buf = ((const char *) buf + n);
 		if (s->nr == sizeof(s->buf)) {
-			/* block is full, write it to the stream */
-#ifdef BSTREAM_DEBUG
-			{
-				unsigned i;
-
-				fprintf(stderr, "W %s %u \"", ss->name, s->nr);
-				for (i = 0; i < s->nr; i++)
-					if (' ' <= s->buf[i] && s->buf[i] < 127)
-						putc(s->buf[i], stderr);
-					else
-						fprintf(stderr, "\\%03o", (unsigned char) s->buf[i]);
-				fprintf(stderr, "\"\n");
-			}
-#endif
-			/* since the block is at max BLOCK (8K) - 2 size we can
-			 * store it in a two byte integer */
-			blksize = (uint16_t) s->nr;
-			s->bytes += s->nr;
-			/* the last bit tells whether a flush is in
-			 * there, it's not at this moment, so shift it
-			 * to the left */
-			blksize <<= 1;
-			if (!mnstr_writeSht(ss->inner, (int16_t) blksize) ||
-			    ss->inner->write(ss->inner, s->buf, 1, s->nr) != (ssize_t) s->nr
-			) {
-				if (mnstr_errnr(ss->inner) != MNSTR_NO__ERROR) {
-					mnstr_copy_error(ss, ss->inner);
-				} else {
-					mnstr_set_error(ss, MNSTR_WRITE_ERROR, "connection closed unexpectedly");
-				}
-
-				s->nr = 0; /* data is lost due to error */
+			/* block is full, write it to the stream; there is
+			 * no flush in there at this moment */
+			if (bs_writeblock(ss, s, false) < 0)
 				return -1;
-			}
-			s->blks++;
-			s->nr = 0;
 		}
 	}
 	return (ssize_t) cnt;
@@ -117,7 +272,6 @@ bs_write(stream *restrict ss, const void *restrict buf, size_t elmsize, size_t c
 static int
 bs_flush(stream *ss, mnstr_flush_level flush_level)
 {
-	uint16_t blksize;
 	bs *s;
 
 	s = (bs *) ss->stream_data.p;
@@ -127,38 +281,15 @@ bs_flush(stream *ss, mnstr_flush_level flush_level)
 	assert(s->nr < sizeof(s->buf));
 	if (!ss->readonly) {
 		/* flush the rest of buffer (if s->nr > 0), then set the
-		 * last bit to 1 to to indicate user-instigated flush */
-#ifdef BSTREAM_DEBUG
-		if (s->nr > 0) {
-			unsigned i;
-
-			fprintf(stderr, "W %s %u \"", ss->name, s->nr);
-			for (i = 0; i < s->nr; i++)
-				if (' ' <= s->buf[i] && s->buf[i] < 127)
-					putc(s->buf[i], stderr);
-				else
-					fprintf(stderr, "\\%03o", (unsigned char) s->buf[i]);
-			fprintf(stderr, "\"\n");
-			fprintf(stderr, "W %s 0\n", ss->name);
-		}
-#endif
-		blksize = (uint16_t) (s->nr << 1);
-		s->bytes += s->nr;
-		/* indicate that this is the last buffer of a block by
-		 * setting the low-order bit */
-		blksize |= 1;
-		/* always flush (even empty blocks) needed for the protocol) */
-		if ((!mnstr_writeSht(ss->inner, (int16_t) blksize) ||
-		     (s->nr > 0 &&
-		      ss->inner->write(ss->inner, s->buf, 1, s->nr) != (ssize_t) s->nr))) {
+		 * last bit to 1 to to indicate user-instigated flush;
+		 * always flush (even empty blocks) needed for the
+		 * protocol */
+		if (bs_writeblock(ss, s, true) < 0)
+			return -1;
+		if (mnstr_flush(ss->inner, flush_level) < 0) {
 			mnstr_copy_error(ss, ss->inner);
-			s->nr = 0; /* data is lost due to error */
 			return -1;
 		}
-		// shouldn't we flush ss->inner too?
-		(void) flush_level;
-		s->blks++;
-		s->nr = 0;
 	}
 	return 0;
 }
@@ -169,18 +300,8 @@ bs_putoob(stream *ss, char val)
 	bs *s = (bs *) ss->stream_data.p;
 	if (s == NULL || ss->inner->putoob == NULL)
 		return -1;
-	if (!ss->readonly && s->nr > 0) {
-		uint16_t blksize = (uint16_t) (s->nr << 1);
-		s->bytes += s->nr;
-		if (!mnstr_writeSht(ss->inner, (int16_t) blksize) ||
-			ss->inner->write(ss->inner, s->buf, 1, s->nr) != (ssize_t) s->nr) {
-			mnstr_copy_error(ss, ss->inner);
-			s->nr = 0; /* data is lost due to error */
-			return -1;
-		}
-		s->blks++;
-		s->nr = 0;
-	}
+	if (!ss->readonly && s->nr > 0 && bs_writeblock(ss, s, false) < 0)
+		return -1;
 	return ss->inner->putoob(ss->inner, val);
 }
 
@@ -269,24 +390,41 @@ bs_read(stream *restrict ss, void *restrict buf, size_t elmsize, size_t cnt)
 			ss->inner->read(ss->inner, &s->oobval, 1, 1);
 			return 0;
 		}
-		if (blksize > (BLOCK << 1 | 1)) {
+		if (blksize & BS_COMPRESSED) {
+			if (s->codec == NULL) {
+				mnstr_set_error(ss, MNSTR_READ_ERROR,
+								"unexpected compressed block");
+				return -1;
+			}
+		} else if (blksize > (BLOCK << 1 | 1)) {
 			mnstr_set_error(ss, MNSTR_READ_ERROR, "invalid block size %"PRIu16,
 							blksize);
 			return -1;
 		}
 		assert(s->nr == 0);
 		s->seenflush = blksize & 1;
-		s->itotal = blksize >> 1;
+		size_t len = (blksize & ~BS_COMPRESSED) >> 1;
+		char *data = blksize & BS_COMPRESSED ? s->codec->cbuf : s->buf;
 		ssize_t m;
 		n = 0;
 		do {
-			m = ss->inner->read(ss->inner, s->buf + n, 1, s->itotal - n);
+			m = ss->inner->read(ss->inner, data + n, 1, len - n);
 			if (m < 0) {
 				mnstr_copy_error(ss, ss->inner);
 				return -1;
 			}
 			n += (size_t) m;
-		} while (n < s->itotal);
+		} while (n < len);
+		if (blksize & BS_COMPRESSED) {
+			m = bs_decompress(s->codec, len, s->buf);
+			if (m < 0) {
+				mnstr_set_error(ss, MNSTR_READ_ERROR,
+								"invalid compressed block");
+				return -1;
+			}
+			n = (size_t) m;
+		}
+		s->itotal = (uint16_t) n;
 		if (n > todo)
 			n = todo;
 		memcpy(buf, s->buf, n);
@@ -327,6 +465,7 @@ bs_destroy(stream *ss)
 	if (s) {
 		if (ss->inner)
 			ss->inner->destroy(ss->inner);
+		bs_codec_destroy(s->codec);
 #if !defined(HAVE_PTHREAD_H) && defined(WIN32)
 		DeleteCriticalSection(&s->lock);
 #else
@@ -344,6 +483,78 @@ bs_clrerr(stream *s)
 		mnstr_clearerr(s->inner);
 }
 
+const char *
+block_stream_compressors(void)
+{
+	/* in order of preference */
+	return ""
+#ifdef HAVE_ZSTD
+		"zstd"
+#ifdef HAVE_LIBLZ4
+		","
+#endif
+#endif
+#ifdef HAVE_LIBLZ4
+		"lz4"
+#endif
+		;
+}
+
+int
+block_stream_compress(stream *ss, const char *method)
+{
+	struct bs_codec *c;
+	bs *s;
+	bool ok = false;
+
+	if (ss == NULL || !isa_block_stream(ss))
+		return -1;
+	s = (bs *) ss->stream_data.p;
+	if (s->codec != NULL) {
+		mnstr_set_error(ss, MNSTR_OPEN_ERROR, "block compression already enabled");
+		return -1;
+	}
+	if ((c = malloc(sizeof(*c))) == NULL) {
+		mnstr_set_error(ss, MNSTR_OPEN_ERROR, "allocation failure");
+		return -1;
+	}
+	*c = (struct bs_codec) {0};
+#ifdef HAVE_LIBLZ4
+	if (strcmp(method, "lz4") == 0) {
+		c->method = BS_LZ4;
+		c->ring = malloc(BS_RINGSIZE);
+		if (ss->readonly)
+			c->lz4d = LZ4_createStreamDecode();
+		else
+			c->lz4c = LZ4_createStream();
+		ok = c->ring != NULL && (c->lz4d != NULL || c->lz4c != NULL);
+	}
+#endif
+#ifdef HAVE_ZSTD
+	if (strcmp(method, "zstd") == 0) {
+		c->method = BS_ZSTD;
+		if (ss->readonly) {
+			c->zd = ZSTD_createDCtx();
+			ok = c->zd != NULL;
+		} else {
+			/* a fast level and a modest window: the server keeps
+			 * one of these per connection */
+			c->zc = ZSTD_createCCtx();
+			ok = c->zc != NULL &&
+				!ZSTD_isError(ZSTD_CCtx_setParameter(c->zc, ZSTD_c_compressionLevel, 1)) &&
+				!ZSTD_isError(ZSTD_CCtx_setParameter(c->zc, ZSTD_c_windowLog, 20));
+		}
+	}
+#endif
+	if (!ok) {
+		bs_codec_destroy(c);
+		mnstr_set_error(ss, MNSTR_OPEN_ERROR, "cannot enable %s block compression", method);
+		return -1;
+	}
+	s->codec = c;
+	return 0;
+}
+
 stream *
 bs_stream(stream *s)
 {
@@ -0,0 +1,612 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * For copyright information, see the file debian/copyright.
+ */
+
+/* Streams working on ring buffers in shared memory.
+ *
+ * A client and a server on the same host that talk over a UNIX domain
+ * socket can move the blocks of the MAPI protocol through a segment
+ * of shared memory instead of through the kernel.  The server creates
+ * the segment (an anonymous memfd) and passes it to the client over
+ * the socket.  The segment holds one ring buffer per direction, each
+ * with a single producer and a single consumer that only communicate
+ * through the head and tail counters.
+ *
+ * The socket stays open.  It is used to wake up a peer that waits for
+ * data or for room in a ring: before going to sleep, a peer sets its
+ * wait flag and checks the ring once more, and the other side sends a
+ * single byte if it finds the flag set after updating the ring.  To
+ * keep the number of system calls down, a waiting consumer is only
+ * woken up once a good part of the ring is filled or the producer
+ * flushes, and a waiting producer once a good part of the ring is
+ * free again.  The socket also tells us when the peer goes away, in
+ * which case we see end-of-file or a hangup.
+ *
+ * The shm streams replace the socket streams underneath the block
+ * streams, so the block structure, flushes and the in-band
+ * "out-of-band" messages that we use on UNIX domain sockets stay the
+ * same. */
+
+#include "monetdb_config.h"
+#include "stream.h"
+#include "stream_internal.h"
+
+#if defined(HAVE_MEMFD_CREATE) && defined(HAVE_SYS_UN_H) && defined(HAVE_SYS_MMAN_H)
+#include <sys/mman.h>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL	0
+#endif
+
+#define SHM_MAGIC	UINT64_C(0x4d6f6e657444424d)
+#define SHM_LINE	64		/* keep the counters on separate cache lines */
+#define SHM_TOCLIENT	(4 * 1024 * 1024) /* ring for the results */
+#define SHM_TOSERVER	(1024 * 1024)	/* ring for queries and uploads */
+#define SHM_NAP		100		/* max ms between checks of the ring */
+#define SHM_BATCH	16		/* wake up the peer per 1/16th of a ring */
+
+#define SHM_OFFER	'S'			/* a segment is attached */
+#define SHM_DECLINE	'N'			/* no segment, stay on the socket */
+
+struct shm_ring {
+	/* updated by the producer */
+	ATOMIC_TYPE head;			/* total number of bytes written */
+	ATOMIC_TYPE wwait;			/* producer waits for room */
+	ATOMIC_TYPE closed;			/* producer is done */
+	char pad1[SHM_LINE - 3 * sizeof(ATOMIC_TYPE)];
+	/* updated by the consumer */
+	ATOMIC_TYPE tail;			/* total number of bytes read */
+	ATOMIC_TYPE rwait;			/* consumer waits for data */
+	char pad2[SHM_LINE - 2 * sizeof(ATOMIC_TYPE)];
+};
+
+/* ring 0 carries data from the server to the client, ring 1 the other
+ * way; the data of the rings follows the header in the same order */
+struct shm_segment {
+	uint64_t magic;
+	uint64_t size[2];			/* sizes of the rings, powers of two */
+	char pad[SHM_LINE - 3 * sizeof(uint64_t)];
+	struct shm_ring ring[2];
+};
+
+/* shared by the read and the write stream of a connection */
+typedef struct shm_conn {
+	struct shm_segment *seg;
+	size_t len;
+	/* our own copy of the sizes of the rings: the peer can write
+	 * the header of the segment at any time, so we only look at it
+	 * once, when the segment is set up */
+	uint64_t size[2];
+	SOCKET sock;				/* for the wakeups, until the read side closes it */
+	ATOMIC_TYPE refs;
+} shm_conn;
+
+/* one direction of a connection */
+typedef struct shm_end {
+	shm_conn *conn;
+	struct shm_ring *ring;
+	unsigned char *data;
+	uint64_t size;
+	uint64_t batch;				/* don't wake up the peer for less */
+	bool closed;
+} shm_end;
+
+static void
+shm_conn_release(shm_conn *c)
+{
+	if (ATOMIC_DEC(&c->refs) == 0) {
+		munmap(c->seg, c->len);
+		free(c);
+	}
+}
+
+/* Wake up the peer if it set the flag we are responsible for. */
+static void
+shm_doorbell(shm_end *e, ATOMIC_TYPE *flag)
+{
+	SOCKET fd = e->conn->sock;
+
+	/* if the socket buffer is full, there are enough wakeups
+	 * pending already */
+	if (ATOMIC_XCG(flag, 0) && fd != INVALID_SOCKET)
+		(void) send(fd, "", 1, MSG_DONTWAIT | MSG_NOSIGNAL);
+}
+
+/* Number of bytes that can be read from (consumer) or written to
+ * (producer) the ring, or -1 if the counters make no sense. */
+static int64_t
+shm_avail(stream *s, shm_end *e)
+{
+	uint64_t head = (uint64_t) ATOMIC_GET(&e->ring->head);
+	uint64_t tail = (uint64_t) ATOMIC_GET(&e->ring->tail);
+
+	if (head - tail > e->size) {
+		mnstr_set_error(s, s->readonly ? MNSTR_READ_ERROR : MNSTR_WRITE_ERROR,
+						"shared memory ring corrupted");
+		return -1;
+	}
+	return (int64_t) (s->readonly ? head - tail : e->size - (head - tail));
+}
+
+/* Wait until the ring has data for the consumer or room for the
+ * producer.  Returns 1 when it does, 0 when the peer went away
+ * instead, and -1 on error or timeout. */
+static int
+shm_wait(stream *s, shm_end *e)
+{
+	ATOMIC_TYPE *flag = s->readonly ? &e->ring->rwait : &e->ring->wwait;
+	SOCKET fd = e->conn->sock;
+	unsigned int waited = 0;
+	int64_t avail;
+
+	for (;;) {
+		ATOMIC_SET(flag, 1);
+		if ((avail = shm_avail(s, e)) != 0 ||
+			(s->readonly && ATOMIC_GET(&e->ring->closed))) {
+			ATOMIC_SET(flag, 0);
+			return avail < 0 ? -1 : avail > 0;
+		}
+		if (fd == INVALID_SOCKET)
+			return 0;
+		/* we also look at the ring every now and then, since the
+		 * other stream of this connection may have taken our wakeup */
+		int ms = SHM_NAP;
+		if (s->timeout > 0 && s->timeout - waited < (unsigned int) ms)
+			ms = (int) (s->timeout - waited);
+		struct pollfd pfd = {
+			.fd = fd,
+			.events = POLLIN,
+		};
+		int ret = poll(&pfd, 1, ms);
+		if (ret == -1) {
+			if (errno == EINTR)
+				continue;
+			mnstr_set_error_errno(s, s->readonly ? MNSTR_READ_ERROR : MNSTR_WRITE_ERROR, "poll error");
+			return -1;
+		}
+		if (ret == 0) {
+			waited += (unsigned int) ms;
+			if (s->timeout > 0 && waited >= s->timeout) {
+				if (s->timeout_func == NULL || s->timeout_func(s->timeout_data)) {
+					mnstr_set_error(s, MNSTR_TIMEOUT, NULL);
+					return -1;
+				}
+				waited = 0;
+			}
+			continue;
+		}
+		char buf[64];
+		ssize_t n = recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+		if (n == 0 ||
+			(n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+			/* hung up, but whatever is in the ring is still
+			 * good */
+			ATOMIC_SET(flag, 0);
+			if ((avail = shm_avail(s, e)) != 0)
+				return avail < 0 ? -1 : 1;
+			return 0;
+		}
+	}
+}
+
+static ssize_t
+shm_write(stream *restrict s, const void *restrict buf, size_t elmsize, size_t cnt)
+{
+	shm_end *e = (shm_end *) s->stream_data.p;
+	size_t size = elmsize * cnt, done = 0;
+
+	if (s->errkind != MNSTR_NO__ERROR)
+		return -1;
+	if (size == 0 || elmsize == 0)
+		return (ssize_t) cnt;
+
+	while (done < size) {
+		int64_t room = shm_avail(s, e);
+		if (room < 0)
+			return -1;
+		if (room == 0) {
+			switch (shm_wait(s, e)) {
+			case -1:
+				return -1;
+			case 0:
+				mnstr_set_error(s, MNSTR_WRITE_ERROR, "connection closed");
+				return -1;
+			}
+			continue;
+		}
+		size_t n = size - done;
+		if (n > (size_t) room)
+			n = (size_t) room;
+		uint64_t head = (uint64_t) ATOMIC_GET(&e->ring->head);
+		size_t pos = (size_t) (head & (e->size - 1));
+		size_t first = e->size - pos;
+		if (first > n)
+			first = n;
+		memcpy(e->data + pos, (const char *) buf + done, first);
+		memcpy(e->data, (const char *) buf + done + first, n - first);
+		ATOMIC_SET(&e->ring->head, head + n);
+		if (e->size - (size_t) room + n >= e->batch)
+			shm_doorbell(e, &e->ring->rwait);
+		done += n;
+	}
+	return (ssize_t) cnt;
+}
+
+/* The block stream flushes us at the end of a message, so the
+ * consumer gets what is there. */
+static int
+shm_flush(stream *s, mnstr_flush_level flush_level)
+{
+	shm_end *e = (shm_end *) s->stream_data.p;
+
+	(void) flush_level;
+	shm_doorbell(e, &e->ring->rwait);
+	return 0;
+}
+
+static ssize_t
+shm_read(stream *restrict s, void *restrict buf, size_t elmsize, size_t cnt)
+{
+	shm_end *e = (shm_end *) s->stream_data.p;
+	size_t size = elmsize * cnt, done = 0;
+
+	if (s->errkind != MNSTR_NO__ERROR)
+		return -1;
+	if (size == 0)
+		return 0;
+
+	/* like the socket streams, return what is there, but only
+	 * complete items */
+	while (done == 0 || done % elmsize != 0) {
+		int64_t avail = shm_avail(s, e);
+		if (avail < 0)
+			return -1;
+		if (avail == 0) {
+			int ret = shm_wait(s, e);
+			if (ret < 0)
+				return -1;
+			if (ret == 0)
+				break;
+			continue;
+		}
+		size_t n = size - done;
+		if (n > (size_t) avail)
+			n = (size_t) avail;
+		uint64_t tail = (uint64_t) ATOMIC_GET(&e->ring->tail);
+		size_t pos = (size_t) (tail & (e->size - 1));
+		size_t first = e->size - pos;
+		if (first > n)
+			first = n;
+		memcpy(buf, e->data + pos, first);
+		memcpy((char *) buf + first, e->data, n - first);
+		ATOMIC_SET(&e->ring->tail, tail + n);
+		if (e->size - (size_t) avail + n >= e->batch)
+			shm_doorbell(e, &e->ring->wwait);
+		buf = (char *) buf + n;
+		done += n;
+	}
+	if (done == 0)
+		s->eof = true;
+	return (ssize_t) (done / elmsize);
+}
+
+/* The interrupt messages are the same as on UNIX domain sockets: two
+ * bytes that cannot start a block header followed by the value. */
+#define OOBMSG0	'\377'
+#define OOBMSG1	'\377'
+
+static int
+shm_getoob(stream *s)
+{
+	shm_end *e = (shm_end *) s->stream_data.p;
+	uint64_t tail = (uint64_t) ATOMIC_GET(&e->ring->tail);
+	uint64_t head = (uint64_t) ATOMIC_GET(&e->ring->head);
+	uint64_t mask = e->size - 1;
+
+	if (head - tail >= 3 && head - tail <= e->size &&
+		e->data[tail & mask] == (unsigned char) OOBMSG0 &&
+		e->data[(tail + 1) & mask] == (unsigned char) OOBMSG1) {
+		unsigned char val = e->data[(tail + 2) & mask];
+		ATOMIC_SET(&e->ring->tail, tail + 3);
+		shm_doorbell(e, &e->ring->wwait);
+		return val;
+	}
+	return 0;
+}
+
+static int
+shm_putoob(stream *s, char val)
+{
+	const char buf[3] = {
+		OOBMSG0,
+		OOBMSG1,
+		val,
+	};
+	if (shm_write(s, buf, 1, 3) != 3)
+		return -1;
+	return shm_flush(s, MNSTR_FLUSH_DATA);
+}
+
+/* The block stream clears the errors of the stream under it, which is
+ * us, so we clear our own, e.g. the timeout with which an interrupt
+ * gets to the client, as well as that of the socket. */
+static void
+shm_clrerr(stream *s)
+{
+	s->errkind = MNSTR_NO__ERROR;
+	s->errmsg[0] = '\0';
+	mnstr_clearerr(s->inner);
+}
+
+static void
+shm_close(stream *s)
+{
+	shm_end *e = (shm_end *) s->stream_data.p;
+
+	if (!e->closed) {
+		e->closed = true;
+		if (s->readonly) {
+			/* the socket stream closes the socket */
+			e->conn->sock = INVALID_SOCKET;
+		} else {
+			ATOMIC_SET(&e->ring->closed, 1);
+			shm_doorbell(e, &e->ring->rwait);
+		}
+	}
+	s->inner->close(s->inner);
+}
+
+static void
+shm_destroy(stream *s)
+{
+	shm_end *e = (shm_end *) s->stream_data.p;
+
+	shm_conn_release(e->conn);
+	free(e);
+	s->inner->destroy(s->inner);
+	destroy_stream(s);
+}
+
+/* Put an shm stream for the given ring between the block stream bs and
+ * its socket stream. */
+static int
+shm_wrap(stream *bs, shm_conn *c, int ring)
+{
+	shm_end *e = malloc(sizeof(*e));
+	stream *s;
+
+	if (e == NULL ||
+		(s = create_wrapper_stream(NULL, bs->inner)) == NULL) {
+		free(e);
+		mnstr_set_error(bs, MNSTR_OPEN_ERROR, "allocation failure");
+		return -1;
+	}
+	*e = (shm_end) {
+		.conn = c,
+		.ring = &c->seg->ring[ring],
+		.data = (unsigned char *) (c->seg + 1) + (ring ? c->size[0] : 0),
+		.size = c->size[ring],
+		.batch = c->size[ring] / SHM_BATCH,
+	};
+	ATOMIC_INC(&c->refs);
+	s->timeout_func = bs->inner->timeout_func;
+	s->timeout_data = bs->inner->timeout_data;
+	s->stream_data.p = e;
+	s->read = bs->readonly ? shm_read : NULL;
+	s->write = bs->readonly ? NULL : shm_write;
+	s->close = shm_close;
+	s->clrerr = shm_clrerr;
+	s->destroy = shm_destroy;
+	s->getoob = bs->readonly ? shm_getoob : NULL;
+	s->putoob = bs->readonly ? NULL : shm_putoob;
+	s->flush = bs->readonly ? NULL : shm_flush;
+	bs->inner = s;
+	return 0;
+}
+
+static int
+shm_switch(stream *in, stream *out, shm_conn *c, bool server)
+{
+	c->sock = in->inner->stream_data.s;
+	ATOMIC_INIT(&c->refs, 1);
+	if (shm_wrap(in, c, server ? 1 : 0) < 0 ||
+		shm_wrap(out, c, server ? 0 : 1) < 0) {
+		shm_conn_release(c);
+		return -1;
+	}
+	shm_conn_release(c);
+	return 1;
+}
+
+bool
+block_stream_shm_possible(const stream *s)
+{
+	return s != NULL && isa_block_stream(s) && socket_is_unix(s->inner);
+}
+
+int
+block_stream_shm_offer(stream *in, stream *out)
+{
+	shm_conn *c = NULL;
+	int fd = -1;
+	char marker = SHM_DECLINE;
+	union {
+		char buf[CMSG_SPACE(sizeof(int))];
+		struct cmsghdr align;
+	} cmsgbuf;
+	struct iovec iov = {
+		.iov_base = &marker,
+		.iov_len = 1,
+	};
+	struct msghdr msg = {
+		.msg_iov = &iov,
+		.msg_iovlen = 1,
+	};
+
+	if (!block_stream_shm_possible(in) || !block_stream_shm_possible(out)) {
+		mnstr_set_error(out, MNSTR_OPEN_ERROR, "not a UNIX domain socket connection");
+		return -1;
+	}
+
+	size_t len = sizeof(struct shm_segment) + SHM_TOCLIENT + SHM_TOSERVER;
+	if ((c = malloc(sizeof(*c))) != NULL &&
+		(fd = memfd_create("monetdb-mapi", MFD_CLOEXEC | MFD_ALLOW_SEALING)) >= 0 &&
+		ftruncate(fd, (off_t) len) == 0 &&
+		/* the client must not be able to make our mapping shrink
+		 * from under us */
+		fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) == 0 &&
+		(c->seg = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) != MAP_FAILED) {
+		c->len = len;
+		c->size[0] = SHM_TOCLIENT;
+		c->size[1] = SHM_TOSERVER;
+		c->seg->magic = SHM_MAGIC;
+		c->seg->size[0] = SHM_TOCLIENT;
+		c->seg->size[1] = SHM_TOSERVER;
+		marker = SHM_OFFER;
+		msg.msg_control = cmsgbuf.buf;
+		msg.msg_controllen = sizeof(cmsgbuf.buf);
+		struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+		cmsg->cmsg_level = SOL_SOCKET;
+		cmsg->cmsg_type = SCM_RIGHTS;
+		cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+		memcpy(CMSG_DATA(cmsg), &fd, sizeof(int));
+	} else {
+		free(c);
+		c = NULL;
+	}
+
+	ssize_t n;
+	do {
+		n = sendmsg(out->inner->stream_data.s, &msg, MSG_NOSIGNAL);
+	} while (n < 0 && errno == EINTR);
+	if (fd >= 0)
+		close(fd);
+	if (n != 1) {
+		mnstr_set_error_errno(out, MNSTR_WRITE_ERROR, "sending shared memory segment");
+		if (c) {
+			munmap(c->seg, c->len);
+			free(c);
+		}
+		return -1;
+	}
+	if (c == NULL)
+		return 0;
+	return shm_switch(in, out, c, true);
+}
+
+int
+block_stream_shm_accept(stream *in, stream *out)
+{
+	char marker = 0;
+	union {
+		char buf[CMSG_SPACE(sizeof(int))];
+		struct cmsghdr align;
+	} cmsgbuf;
+	struct iovec iov = {
+		.iov_base = &marker,
+		.iov_len = 1,
+	};
+	struct msghdr msg = {
+		.msg_iov = &iov,
+		.msg_iovlen = 1,
+		.msg_control = cmsgbuf.buf,
+		.msg_controllen = sizeof(cmsgbuf.buf),
+	};
+	int fd = -1;
+
+	if (!block_stream_shm_possible(in) || !block_stream_shm_possible(out)) {
+		mnstr_set_error(in, MNSTR_OPEN_ERROR, "not a UNIX domain socket connection");
+		return -1;
+	}
+
+	ssize_t n;
+	do {
+		n = recvmsg(in->inner->stream_data.s, &msg, MSG_CMSG_CLOEXEC);
+	} while (n < 0 && errno == EINTR);
+	if (n != 1) {
+		if (n == 0)
+			mnstr_set_error(in, MNSTR_READ_ERROR, "connection closed");
+		else
+			mnstr_set_error_errno(in, MNSTR_READ_ERROR, "receiving shared memory segment");
+		return -1;
+	}
+	for (struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg); cmsg; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+		if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS &&
+			cmsg->cmsg_len == CMSG_LEN(sizeof(int)))
+			memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+	}
+	if (marker == SHM_DECLINE && fd < 0)
+		return 0;
+	if (marker != SHM_OFFER || fd < 0) {
+		if (fd >= 0)
+			close(fd);
+		mnstr_set_error(in, MNSTR_READ_ERROR, "invalid shared memory offer");
+		return -1;
+	}
+
+	struct stat st;
+	shm_conn *c = NULL;
+	struct shm_segment *seg = MAP_FAILED;
+	uint64_t size[2] = {0, 0};
+	if (fstat(fd, &st) == 0 &&
+		(size_t) st.st_size >= sizeof(struct shm_segment) &&
+		(fcntl(fd, F_GET_SEALS) & F_SEAL_SHRINK) != 0 &&
+		(seg = mmap(NULL, (size_t) st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) != MAP_FAILED) {
+		/* read the sizes once, the checks below are on what we
+		 * will use */
+		size[0] = ((volatile uint64_t *) seg->size)[0];
+		size[1] = ((volatile uint64_t *) seg->size)[1];
+	}
+	if (seg == MAP_FAILED ||
+		seg->magic != SHM_MAGIC ||
+		size[0] == 0 || (size[0] & (size[0] - 1)) != 0 ||
+		size[1] == 0 || (size[1] & (size[1] - 1)) != 0 ||
+		size[0] > (uint64_t) st.st_size || size[1] > (uint64_t) st.st_size ||
+		sizeof(struct shm_segment) + size[0] + size[1] != (uint64_t) st.st_size ||
+		(c = malloc(sizeof(*c))) == NULL) {
+		if (seg != MAP_FAILED)
+			munmap(seg, (size_t) st.st_size);
+		close(fd);
+		mnstr_set_error(in, MNSTR_OPEN_ERROR, "cannot use shared memory segment");
+		return -1;
+	}
+	close(fd);
+	c->seg = seg;
+	c->len = (size_t) st.st_size;
+	c->size[0] = size[0];
+	c->size[1] = size[1];
+	return shm_switch(in, out, c, false);
+}
+
+#else
+
+bool
+block_stream_shm_possible(const stream *s)
+{
+	(void) s;
+	return false;
+}
+
+int
+block_stream_shm_offer(stream *in, stream *out)
+{
+	(void) in;
+	mnstr_set_error(out, MNSTR_OPEN_ERROR, "shared memory transport not supported");
+	return -1;
+}
+
+int
+block_stream_shm_accept(stream *in, stream *out)
+{
+	(void) out;
+	mnstr_set_error(in, MNSTR_OPEN_ERROR, "shared memory transport not supported");
+	return -1;
+}
+
+#endif
@@ -544,6 +544,20 @@ socket_isalive(const stream *s)
 #endif
 }
 
+/* Whether s is a socket stream on a UNIX domain socket. */
+bool
+socket_is_unix(const stream *s)
+{
+#ifdef HAVE_SYS_UN_H
+	return s->read == socket_read &&
+		s->putoob == socket_putoob_unix &&
+		s->stream_data.s != INVALID_SOCKET;
+#else
+	(void) s;
+	return false;
+#endif
+}
+
 static stream *
 socket_open(SOCKET sock, const char *name)
 {
@@ -215,6 +215,22 @@ stream_export buffer *mnstr_get_buffer(stream *s);
 stream_export stream *block_stream(stream *s); // mapi.c, mal_mapi.c, client.c, merovingian
 stream_export bool isa_block_stream(const stream *s); // mapi.c, mal_client.c, remote.c, sql_scenario.c/sqlReader, sql_scan.c
 stream_export stream *bs_stream(stream *s); // unused
+/* Compress the payload of every block written to, or expect compressed
+ * blocks when reading from, a block stream.  Both ends of a connection
+ * must switch at the same point in the conversation, typically right
+ * after the handshake. */
+stream_export const char *block_stream_compressors(void); // mapi.c, mal_mapi.c
+stream_export int block_stream_compress(stream *s, const char *method); // mapi.c, mal_mapi.c
+/* Move the blocks of a connection over a UNIX domain socket through
+ * ring buffers in shared memory.  Right after reading the client's
+ * response to the challenge, the server calls block_stream_shm_offer,
+ * which creates the segment and passes it over the socket, while the
+ * client calls block_stream_shm_accept right after sending it.  Both
+ * return 1 if the streams now use shared memory, 0 if the connection
+ * stays on the socket, and -1 on failure. */
+stream_export bool block_stream_shm_possible(const stream *s); // mapi.c, mal_mapi.c
+stream_export int block_stream_shm_offer(stream *in, stream *out); // mal_mapi.c
+stream_export int block_stream_shm_accept(stream *in, stream *out); // mapi.c
 
 typedef enum {
 	PROTOCOL_AUTO = 0, // unused
@@ -60,6 +60,9 @@
 #include <lz4.h>
 #include <lz4frame.h>
 #endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
 #ifdef HAVE_PTHREAD_H
 #include <pthread.h>
 #endif
@@ -213,6 +216,9 @@ ssize_t file_read(stream *restrict s, void *restrict buf, size_t elmsize, size_t
 	__attribute__((__visibility__("hidden")));
 
 
+bool socket_is_unix(const stream *s)
+	__attribute__((__visibility__("hidden")));
+
 stream *open_gzrstream(const char *filename)
 	__attribute__((__visibility__("hidden")));
 stream *open_gzwstream(const char *restrict filename, const char *restrict mode)
@@ -255,6 +261,7 @@ stream *open_lz4wastream(const char *restrict filename, const char *restrict mod
  * Have to look into this but I think it should all be in bs.c only, and
  * bs2.c should be dropped.*/
 typedef struct bs bs;
+struct bs_codec;
 struct bs {
 #if !defined(HAVE_PTHREAD_H) && defined(WIN32)
 	CRITICAL_SECTION lock;
@@ -268,6 +275,7 @@ struct bs {
 	unsigned char oobval;
 	int64_t blks;		/* read/written blocks (possibly partial) */
 	int64_t bytes;		/* read/written bytes */
+	struct bs_codec *codec;	/* block compression, if negotiated */
 	char buf[BLOCK];	/* the buffered data (minus the size of
 						 * size-short */
 };
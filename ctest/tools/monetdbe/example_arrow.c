@@ -0,0 +1,137 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * For copyright information, see the file debian/copyright.
+ */
+
+#include "monetdbe.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#define error(msg) do{fprintf(stderr, "Failure: %s\n", msg); return -1;}while(0)
+
+static const char *formats[] = {
+	"i", "l", "g", "u", "tdD", "ttu", "tsu:", "d:10,2", "b", "w:16", "tiM",
+};
+
+static bool
+is_valid(const struct ArrowArray *a, int64_t i)
+{
+	const uint8_t *bits = a->buffers[0];
+	return bits == NULL || (bits[i >> 3] >> (i & 7)) & 1;
+}
+
+int
+main(void)
+{
+	char* err = NULL;
+	monetdbe_database mdbe = NULL;
+	monetdbe_result* result = NULL;
+	struct ArrowSchema schema;
+	struct ArrowArray array;
+
+	if (monetdbe_open(&mdbe, NULL, NULL))
+		error("Failed to open database");
+	if ((err = monetdbe_query(mdbe, "CREATE TABLE test (i int, l bigint, d double, s string, dt date, t time(3), ts timestamp, n decimal(10,2), b boolean, u uuid, m interval month)", NULL, NULL)) != NULL)
+		error(err);
+	if ((err = monetdbe_query(mdbe, "CREATE TABLE digits (x int)", NULL, NULL)) != NULL)
+		error(err);
+	if ((err = monetdbe_query(mdbe, "INSERT INTO digits VALUES (0), (1), (2), (3), (4), (5), (6), (7), (8), (9)", NULL, NULL)) != NULL)
+		error(err);
+	if ((err = monetdbe_query(mdbe, "INSERT INTO test SELECT value, value * 1000000007, value / 3.0e0, 'str' || value, date '2020-02-28' + value * interval '1' day, time '12:34:56.789' + value * interval '1' second, timestamp '1960-01-01 00:00:00.5' + value * interval '1' hour, value * 1.25, value % 2 = 0, uuid 'a0eebc99-9c0b-4ef8-bb6d-6bb9bd380a11', value * interval '1' month FROM (SELECT a.x * 100 + b.x * 10 + c.x + 1 AS value FROM digits a, digits b, digits c) v", NULL, NULL)) != NULL)
+		error(err);
+	if ((err = monetdbe_query(mdbe, "INSERT INTO test VALUES (NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL)", NULL, NULL)) != NULL)
+		error(err);
+	if ((err = monetdbe_query(mdbe, "CREATE TABLE test2 (i int, l bigint, d double, s string, dt date, t time(3), ts timestamp, n decimal(10,2), b boolean, u uuid, m interval month)", NULL, NULL)) != NULL)
+		error(err);
+
+	if ((err = monetdbe_query(mdbe, "SELECT * FROM test ORDER BY i NULLS LAST", &result, NULL)) != NULL)
+		error(err);
+	if ((err = monetdbe_result_to_arrow(result, &schema, &array)) != NULL)
+		error(err);
+	/* the arrays stay valid after the result set is gone */
+	if ((err = monetdbe_cleanup_result(mdbe, result)) != NULL)
+		error(err);
+
+	if (strcmp(schema.format, "+s") != 0 || schema.n_children != 11 || array.n_children != 11 || array.length != 1001)
+		error("Unexpected struct array");
+	for (int c = 0; c < 11; c++) {
+		const struct ArrowArray *a = array.children[c];
+		if (strcmp(schema.children[c]->format, formats[c]) != 0) {
+			fprintf(stderr, "Column %s has format %s\n", schema.children[c]->name, schema.children[c]->format);
+			error("Unexpected format");
+		}
+		if (a->length != 1001 || a->null_count != 1 || is_valid(a, 1000) || !is_valid(a, 0))
+			error("Unexpected nulls");
+	}
+	if (((const int32_t *) array.children[0]->buffers[1])[41] != 42)
+		error("Unexpected int value");
+	if (((const int64_t *) array.children[1]->buffers[1])[0] != 1000000007)
+		error("Unexpected bigint value");
+	if (strncmp((const char *) array.children[3]->buffers[2] + ((const int32_t *) array.children[3]->buffers[1])[9], "str10", 5) != 0)
+		error("Unexpected string value");
+	if (((const int32_t *) array.children[4]->buffers[1])[0] != 18321)	/* 2020-02-29 */
+		error("Unexpected date value");
+	if (((const int64_t *) array.children[5]->buffers[1])[0] != INT64_C(45297789000))	/* 12:34:57.789 */
+		error("Unexpected time value");
+	if (((const int64_t *) array.children[6]->buffers[1])[0] != INT64_C(-315615599500000))	/* 1960-01-01 01:00:00.5 */
+		error("Unexpected timestamp value");
+	if (((const int64_t *) array.children[7]->buffers[1])[2 * 3] != 500)	/* 5.00 */
+		error("Unexpected decimal value");
+	if ((((const uint8_t *) array.children[8]->buffers[1])[0] & 3) != 2)
+		error("Unexpected boolean value");
+
+	/* and back again */
+	if ((err = monetdbe_append_arrow(mdbe, "sys", "test2", &schema, &array)) != NULL)
+		error(err);
+	schema.release(&schema);
+	array.release(&array);
+
+	/* without nulls the Arrow buffers are appended as they are */
+	if ((err = monetdbe_query(mdbe, "SELECT * FROM test WHERE i IS NOT NULL", &result, NULL)) != NULL)
+		error(err);
+	if ((err = monetdbe_result_to_arrow(result, &schema, &array)) != NULL)
+		error(err);
+	if ((err = monetdbe_cleanup_result(mdbe, result)) != NULL)
+		error(err);
+	if ((err = monetdbe_append_arrow(mdbe, "sys", "test2", &schema, &array)) != NULL)
+		error(err);
+	schema.release(&schema);
+	array.release(&array);
+
+	if ((err = monetdbe_query(mdbe, "SELECT (SELECT COUNT(*) FROM test2), (SELECT COUNT(*) FROM (SELECT * FROM test EXCEPT SELECT * FROM test2) x), (SELECT COUNT(*) FROM test2 WHERE i IS NULL AND s IS NULL AND ts IS NULL)", &result, NULL)) != NULL)
+		error(err);
+	monetdbe_column* rcol[3];
+	for (size_t c = 0; c < 3; c++)
+		if ((err = monetdbe_result_fetch(result, rcol + c, c)) != NULL)
+			error(err);
+	if (((int64_t *) rcol[0]->data)[0] != 2001 || ((int64_t *) rcol[1]->data)[0] != 0 || ((int64_t *) rcol[2]->data)[0] != 1)
+		error("Appended rows differ");
+	if ((err = monetdbe_cleanup_result(mdbe, result)) != NULL)
+		error(err);
+
+	/* a type that does not fit */
+	if ((err = monetdbe_query(mdbe, "SELECT s FROM test", &result, NULL)) != NULL)
+		error(err);
+	if ((err = monetdbe_result_to_arrow(result, &schema, &array)) != NULL)
+		error(err);
+	if ((err = monetdbe_cleanup_result(mdbe, result)) != NULL)
+		error(err);
+	if ((err = monetdbe_query(mdbe, "CREATE TABLE ints (i int)", NULL, NULL)) != NULL)
+		error(err);
+	if ((err = monetdbe_append_arrow(mdbe, "sys", "ints", &schema, &array)) == NULL)
+		error("Appending strings to an int column should fail");
+	schema.release(&schema);
+	array.release(&array);
+
+	printf("Arrow round trip of %d rows done\n", 1001);
+	if (monetdbe_close(mdbe))
+		error("Failed to close database");
+	return 0;
+}
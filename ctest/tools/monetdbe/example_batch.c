@@ -0,0 +1,134 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * For copyright information, see the file debian/copyright.
+ */
+
+#include "monetdbe.h"
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#define error(msg) do{fprintf(stderr, "Failure: %s\n", msg); return -1;}while(0)
+
+#define BATCH 10000
+
+static int64_t
+query_value(monetdbe_database mdbe, char *query)
+{
+	monetdbe_result *result = NULL;
+	monetdbe_column *rcol = NULL;
+	int64_t v = -1;
+
+	if (monetdbe_query(mdbe, query, &result, NULL) != NULL)
+		return -1;
+	if (monetdbe_result_fetch(result, &rcol, 0) == NULL && rcol->type == monetdbe_int64_t)
+		v = ((int64_t *) rcol->data)[0];
+	monetdbe_cleanup_result(mdbe, result);
+	return v;
+}
+
+int
+main(void)
+{
+	char* err = NULL;
+	monetdbe_database mdbe = NULL;
+	monetdbe_statement *stmt = NULL;
+	monetdbe_cnt affected = 0;
+	static int32_t ids[BATCH];
+	static char *strs[BATCH];
+	static char buf[BATCH][8];
+	static monetdbe_data_date dates[BATCH];
+	static double dbls[BATCH];
+
+	if (monetdbe_open(&mdbe, NULL, NULL))
+		error("Failed to open database");
+	if ((err = monetdbe_query(mdbe, "CREATE TABLE test (i int PRIMARY KEY, s string, d date, f double)", NULL, NULL)) != NULL)
+		error(err);
+
+	for (int j = 0; j < BATCH; j++) {
+		ids[j] = j;
+		snprintf(buf[j], sizeof(buf[j]), "s%d", j % 100);
+		strs[j] = j % 10 == 0 ? NULL : buf[j];
+		dates[j] = (monetdbe_data_date) {.year = 2020, .month = 1 + j % 12, .day = 1 + j % 28};
+		dbls[j] = j * 0.5;
+	}
+	dates[3] = *(monetdbe_data_date *) monetdbe_null(mdbe, monetdbe_date);
+
+	/* a single bulk insert */
+	if ((err = monetdbe_prepare(mdbe, "INSERT INTO test VALUES (?, ?, ?, ?)", &stmt, NULL)) != NULL)
+		error(err);
+	if ((err = monetdbe_bind_array(stmt, ids, 0, BATCH)) != NULL ||
+		(err = monetdbe_bind_array(stmt, strs, 1, BATCH)) != NULL ||
+		(err = monetdbe_bind_array(stmt, dates, 2, BATCH)) != NULL ||
+		(err = monetdbe_bind_array(stmt, dbls, 3, BATCH)) != NULL)
+		error(err);
+	if ((err = monetdbe_execute(stmt, NULL, &affected)) != NULL)
+		error(err);
+	if (affected != BATCH)
+		error("Unexpected number of affected rows");
+	if (query_value(mdbe, "SELECT COUNT(*) FROM test") != BATCH ||
+		query_value(mdbe, "SELECT COUNT(s) FROM test") != BATCH - BATCH / 10 ||
+		query_value(mdbe, "SELECT COUNT(*) FROM test WHERE d IS NULL") != 1 ||
+		query_value(mdbe, "SELECT CAST(SUM(f * 2) AS BIGINT) FROM test") != (int64_t) BATCH * (BATCH - 1) / 2 ||
+		query_value(mdbe, "SELECT CAST(i AS BIGINT) FROM test WHERE s = 's42' AND d = DATE '2020-07-15'") != 42)
+		error("Inserted values differ");
+
+	/* a single value for one of the parameters */
+	for (int j = 0; j < 5; j++)
+		ids[j] = BATCH + j;
+	double f = -1;
+	if ((err = monetdbe_bind_array(stmt, ids, 0, 5)) != NULL ||
+		(err = monetdbe_bind_array(stmt, strs, 1, 5)) != NULL ||
+		(err = monetdbe_bind_array(stmt, dates, 2, 5)) != NULL ||
+		(err = monetdbe_bind(stmt, &f, 3)) != NULL)
+		error(err);
+	if ((err = monetdbe_bind_array(stmt, dates, 2, 4)) != NULL)
+		error(err);
+	if ((err = monetdbe_execute(stmt, NULL, &affected)) == NULL)
+		error("Arrays of different lengths should not execute");
+	if ((err = monetdbe_bind_array(stmt, dates, 2, 5)) != NULL)
+		error(err);
+	if ((err = monetdbe_execute(stmt, NULL, &affected)) != NULL)
+		error(err);
+	if (affected != 5 || query_value(mdbe, "SELECT COUNT(*) FROM test WHERE f = -1") != 5)
+		error("Unexpected rows for a single value parameter");
+
+	/* a duplicate key rejects the whole batch */
+	ids[4] = 7;
+	if ((err = monetdbe_bind_array(stmt, dbls, 3, 5)) != NULL)
+		error(err);
+	if ((err = monetdbe_execute(stmt, NULL, &affected)) == NULL)
+		error("Duplicate key should fail");
+	if (query_value(mdbe, "SELECT COUNT(*) FROM test") != BATCH + 5)
+		error("Failed batch left rows behind");
+	if ((err = monetdbe_cleanup_statement(mdbe, stmt)) != NULL)
+		error(err);
+
+	/* statements without a bulk variant run tuple at a time */
+	if ((err = monetdbe_prepare(mdbe, "UPDATE test SET f = ? WHERE i = ?", &stmt, NULL)) != NULL)
+		error(err);
+	for (int j = 0; j < 3; j++) {
+		dbls[j] = -1000 - j;
+		ids[j] = j * 2;
+	}
+	if ((err = monetdbe_bind_array(stmt, dbls, 0, 3)) != NULL ||
+		(err = monetdbe_bind_array(stmt, ids, 1, 3)) != NULL)
+		error(err);
+	if ((err = monetdbe_execute(stmt, NULL, &affected)) != NULL)
+		error(err);
+	if (affected != 3 || query_value(mdbe, "SELECT CAST(SUM(i) AS BIGINT) FROM test WHERE f <= -1000") != 6)
+		error("Unexpected update results");
+	if ((err = monetdbe_cleanup_statement(mdbe, stmt)) != NULL)
+		error(err);
+
+	printf("Batch of %d rows inserted\n", BATCH);
+	if (monetdbe_close(mdbe))
+		error("Failed to close database");
+	return 0;
+}
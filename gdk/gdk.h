@@ -1089,6 +1089,17 @@ gdk_export void MT_thread_setsemawait(MT_Sema *sema);
 gdk_export void MT_thread_setworking(const char *work);
 gdk_export void MT_thread_setalgorithm(const char *algo, const char *func);
 gdk_export const char *MT_thread_getalgorithm(void);
+/* hardware performance counters, in the order returned by
+ * MT_thread_hwcounters */
+enum {
+	MT_HW_CYCLES,
+	MT_HW_INSTRUCTIONS,
+	MT_HW_LLC_MISSES,
+	MT_HW_BRANCH_MISSES,
+	MT_HW_DTLB_MISSES,
+	MT_HW_COUNTERS
+};
+gdk_export bool MT_thread_hwcounters(int64_t counters[MT_HW_COUNTERS]);
 #ifdef LOCK_OWNER
 #define hide_exp(a,b) a ## b	/* hide export from exports test */
 hide_exp(gdk_ex,port) void MT_thread_add_mylock(MT_Lock *lock);
@@ -1120,6 +1131,7 @@ typedef struct MT_Cond {
 gdk_export void MT_cond_init(MT_Cond *cond, const char *name);
 gdk_export void MT_cond_destroy(MT_Cond *cond);
 gdk_export void MT_cond_wait(MT_Cond *cond, MT_Lock *lock);
+gdk_export void MT_cond_timedwait(MT_Cond *cond, MT_Lock *lock, int ms);
 gdk_export void MT_cond_signal(MT_Cond *cond);
 gdk_export void MT_cond_broadcast(MT_Cond *cond);
 
@@ -1558,6 +1570,7 @@ typedef struct BAT {
 	BUN batInserted;	/* start of inserted elements */
 	BUN batCount;		/* tuple count */
 	BUN batCapacity;	/* tuple capacity */
+	ulng batVersion;	/* see BATversion, 0 if not assigned */
 
 	/* dynamic column properties */
 	uint16_t twidth;	/* byte-width of the atom array */
@@ -1590,7 +1603,11 @@ typedef struct BAT {
 	RTree *trtree;		/* rtree geometric index */
 #endif
 	Heap *torderidx;	/* order oid index */
+	Heap *torderidxpend;	/* order index not yet covering appends */
 	Strimps *tstrimps;	/* string imprint index  */
+	Heap *ttrigram;		/* string trigram index */
+	Heap *tfulltext;	/* string full-text index */
+	Heap *tprefix;		/* string prefix heap */
 	PROPrec *tprops;	/* list of dynamic properties stored in the bat descriptor */
 
 	struct pipeline_io *pl_io;
@@ -2840,6 +2857,7 @@ BUNtoid(BAT *b, BUN p)
 gdk_export BUN BATcount_no_nil(BAT *b, BAT *s);
 gdk_export void BATsetcapacity(BAT *b, BUN cnt);
 gdk_export void BATsetcount(BAT *b, BUN cnt);
+gdk_export ulng BATversion(BAT *b);
 gdk_export BUN BATgrows(BAT *b);
 gdk_export gdk_return BATkey(BAT *b, bool onoff);
 gdk_export gdk_return BATmode(BAT *b, bool transient);
@@ -2892,6 +2910,7 @@ gdk_export bool GDKembedded(void);
 gdk_export gdk_return GDKcreatedir(const char *nme);
 
 gdk_export void OIDXdestroy(BAT *b);
+gdk_export void OIDXwait(BAT *b);
 
 gdk_export gdk_return BATprintcolumns(stream *s, int argc, BAT *argv[]);
 gdk_export gdk_return BATprint(stream *s, BAT *b);
@@ -3303,10 +3322,26 @@ gdk_export void STRMPdestroy(BAT *b);
 gdk_export bool BAThasstrimps(BAT *b);
 gdk_export gdk_return BATsetstrimps(BAT *b);
 
+/* Trigram index exported functions */
+gdk_export gdk_return TRGMcreate(BAT *b);
+gdk_export BAT *TRGMselect(BAT *b, BAT *s, const char *pat, const char *esc);
+gdk_export void TRGMdestroy(BAT *b);
+gdk_export bool BAThastrigrams(BAT *b);
+
+/* Full-text index exported functions */
+gdk_export gdk_return FTXTcreate(BAT *b);
+gdk_export BAT *FTXTselect(BAT *b, BAT *s, const char *query, bool anti);
+gdk_export BAT *FTXTscore(BAT *b, BAT *s, BAT *live, const char *query);
+gdk_export gdk_return FTXTmatchvalue(bit *ret, const char *v, const char *query);
+gdk_export gdk_return FTXTscorevalue(dbl *ret, const char *v, const char *query);
+gdk_export void FTXTdestroy(BAT *b);
+gdk_export bool BAThasfulltext(BAT *b);
+
 gdk_export int sketch_populate(BAT* n, BATiter *ni, struct canditer *nci, uint8_t cnting_sketch[BUCKETS][CLZ_BUCKETS]);
 /* gdk_export void sketch_merge(BAT* b, BAT* n); */
 gdk_export double sketch_estimate(uint8_t cnt_sketch[BUCKETS][CLZ_BUCKETS]);
 gdk_export double bat_guess_uniques(BAT *b, BATiter *bi, struct canditer *bci);
+gdk_export gdk_return bat_guess_uniques_multi(BAT **b, int n, double *ndv, double *group);
 
 /* Rtree structure functions */
 #ifdef HAVE_RTREE
@@ -3856,9 +3891,13 @@ gdk_export gdk_return GDKcopyenv(BAT **key, BAT **val, bool writable);
 /* virtual memory defines */
 gdk_export size_t _MT_npages;
 gdk_export size_t _MT_pagesize;
+gdk_export size_t _MT_l2cachesize;
+gdk_export size_t _MT_l3cachesize;
 
 #define MT_pagesize()	_MT_pagesize
 #define MT_npages()	_MT_npages
+#define MT_l2cachesize()	_MT_l2cachesize
+#define MT_l3cachesize()	_MT_l3cachesize
 
 gdk_export size_t GDK_mem_maxsize;	/* max allowed size of committed memory */
 gdk_export size_t GDK_vm_maxsize;	/* max allowed size of reserved vm */
@@ -476,6 +476,9 @@ BATclear(BAT *b, bool force)
 	HASHdestroy(b);
 	OIDXdestroy(b);
 	STRMPdestroy(b);
+	TRGMdestroy(b);
+	FTXTdestroy(b);
+	PFXdestroy(b);
 	RTREEdestroy(b);
 	PROPdestroy(b);
 	TSKdestroy(b);
@@ -533,6 +536,7 @@ BATclear(BAT *b, bool force)
 
 	b->batInserted = 0;
 	b->batCount = 0;
+	b->batVersion = 0;
 	if (b->ttype == TYPE_void)
 		b->batCapacity = 0;
 	b->theap->free = 0;
@@ -570,6 +574,9 @@ BATfree(BAT *b)
 	HASHfree(b);
 	OIDXfree(b);
 	STRMPfree(b);
+	TRGMfree(b);
+	FTXTfree(b);
+	PFXdestroy(b);
 	RTREEfree(b);
 	TSKfree(b);
 	MT_lock_set(&b->theaplock);
@@ -1397,9 +1404,11 @@ BUNappendmulti(BAT *b, const void *values, BUN count, bool force)
 	MT_lock_unset(&b->theaplock);
 	MT_rwlock_wrunlock(&b->thashlock);
 
-	OIDXdestroy(b);
+	if (OIDXdetach(b))
+		OIDXappend(b);
 	STRMPdestroy(b);	/* TODO: use STRMPappendBitstring */
 	RTREEdestroy(b);
+	PFXappend(b, p - count);
 	return GDK_SUCCEED;
 }
 
@@ -1461,6 +1470,7 @@ BUNdelete(BAT *b, oid o)
 		b->tunique_est = (double) nunique;
 	else if (BATcount(b) < gdk_unique_estimate_keep_fraction)
 		b->tunique_est = 0;
+	b->batVersion = 0;
 	if (b->batCount <= 1) {
 		/* some trivial properties */
 		b->tkey = true;
@@ -1474,6 +1484,9 @@ BUNdelete(BAT *b, oid o)
 	MT_lock_unset(&b->theaplock);
 	OIDXdestroy(b);
 	STRMPdestroy(b);
+	TRGMdestroy(b);
+	FTXTdestroy(b);
+	PFXdestroy(b);
 	RTREEdestroy(b);
 	PROPdestroy(b);
 	return GDK_SUCCEED;
@@ -1644,6 +1657,9 @@ BUNinplacemulti(BAT *b, const oid *positions, const void *values, BUN count, boo
 		}
 		OIDXdestroy(b);
 		STRMPdestroy(b);
+		TRGMdestroy(b);
+		FTXTdestroy(b);
+		PFXdestroy(b);
 		RTREEdestroy(b);
 
 		if (b->tvheap && b->ttype) {
@@ -1814,6 +1830,7 @@ BUNinplacemulti(BAT *b, const oid *positions, const void *values, BUN count, boo
 		b->tunique_est = (double) b->batCount;
 	b->tminpos = bi.minpos;
 	b->tmaxpos = bi.maxpos;
+	b->batVersion = 0;
 	b->theap->dirty = true;
 	if (b->tvheap)
 		b->tvheap->dirty = true;
@@ -2056,6 +2073,28 @@ BATsetcapacity(BAT *b, BUN cnt)
 	assert(b->batCount <= cnt);
 }
 
+/* Return a number identifying the current values of b.  The number
+ * stays the same while values are only appended; any other change to
+ * the BAT (replacing or deleting values, shrinking it) makes the next
+ * call return a new number, and numbers are never handed out twice,
+ * also not to different BATs.  This allows other layers to cache
+ * information derived from the first so many values of b.  The
+ * functions that change values reset the version when they are done,
+ * so derived information should be checked against the version both
+ * before and after it was computed. */
+ulng
+BATversion(BAT *b)
+{
+	static ATOMIC_TYPE versions = ATOMIC_VAR_INIT(0);
+	ulng v;
+
+	MT_lock_set(&b->theaplock);
+	if ((v = b->batVersion) == 0)
+		v = b->batVersion = (ulng) ATOMIC_INC(&versions);
+	MT_lock_unset(&b->theaplock);
+	return v;
+}
+
 /* Set the batCount value for the bat and also set some dependent
  * properties.  This function should be called only when it is save from
  * concurrent use (e.g. when theaplock is being held). */
@@ -2066,6 +2105,8 @@ BATsetcount(BAT *b, BUN cnt)
 	assert(!is_oid_nil(b->hseqbase));
 	assert(cnt <= BUN_MAX);
 
+	if (cnt < b->batCount)
+		b->batVersion = 0;
 	b->batCount = cnt;
 	if (b->theap->parentid == b->batCacheid) {
 		b->theap->dirty |= b->ttype != TYPE_void && cnt > 0;
@@ -818,10 +818,13 @@ BATappend2(BAT *b, BAT *n, BAT *s, bool force, bool mayshare)
 	int (*atomcmp) (const void *, const void *) = ATOMcompare(b->ttype);
 	bool (*atomeq) (const void *, const void *) = ATOMequal(b->ttype);
 	bool hlocked = false;
+	bool oidxappend = false;
+	BUN oldcnt;
 
 	if (b == NULL || n == NULL || BATcount(n) == 0) {
 		return GDK_SUCCEED;
 	}
+	oldcnt = BATcount(b);
 	canditer_init(&ci, n, s);
 	if (ci.ncand == 0) {
 		return GDK_SUCCEED;
@@ -863,7 +866,7 @@ BATappend2(BAT *b, BAT *n, BAT *s, bool force, bool mayshare)
 		return GDK_FAIL;
 	}
 
-	OIDXdestroy(b);
+	oidxappend = OIDXdetach(b);
 	STRMPdestroy(b);	/* TODO: use STRMPappendBitString */
 	RTREEdestroy(b);
 	TSKdestroy(b);
@@ -1158,6 +1161,9 @@ BATappend2(BAT *b, BAT *n, BAT *s, bool force, bool mayshare)
 		VALclear(&minprop);
 	if (maxbound)
 		VALclear(&maxprop);
+	PFXappend(b, oldcnt);
+	if (oidxappend)
+		OIDXappend(b);
 	TRC_DEBUG(ALGO, "b=%s,n=" ALGOBATFMT ",s=" ALGOOPTBATFMT
 		  " -> " ALGOBATFMT " (" LLFMT " usec)\n",
 		  buf, ALGOBATPAR(n), ALGOOPTBATPAR(s), ALGOBATPAR(b),
@@ -1167,6 +1173,8 @@ BATappend2(BAT *b, BAT *n, BAT *s, bool force, bool mayshare)
   bailout:
 	if (hlocked)
 		MT_rwlock_wrunlock(&b->thashlock);
+	if (oidxappend)
+		OIDXdestroy(b);
 	if (minbound)
 		VALclear(&minprop);
 	if (maxbound)
@@ -1198,6 +1206,9 @@ BATdel(BAT *b, BAT *d)
 	HASHdestroy(b);
 	PROPdestroy(b);
 	STRMPdestroy(b);
+	TRGMdestroy(b);
+	FTXTdestroy(b);
+	PFXdestroy(b);
 	RTREEdestroy(b);
 	TSKdestroy(b);
 	if (BATtdense(d)) {
@@ -1331,6 +1342,7 @@ BATdel(BAT *b, BAT *d)
 	b->tminpos = BUN_NONE;
 	b->tmaxpos = BUN_NONE;
 	b->tunique_est = 0.0;
+	b->batVersion = 0;
 	MT_lock_unset(&b->theaplock);
 
 	return GDK_SUCCEED;
@@ -1391,6 +1403,9 @@ BATappend_or_update(BAT *b, BAT *p, const oid *positions, BAT *n,
 
 	OIDXdestroy(b);
 	STRMPdestroy(b);
+	TRGMdestroy(b);
+	FTXTdestroy(b);
+	PFXdestroy(b);
 	RTREEdestroy(b);
 	TSKdestroy(b);
 	/* load hash so that we can maintain it */
@@ -2020,6 +2035,7 @@ BATappend_or_update(BAT *b, BAT *p, const oid *positions, BAT *n,
 		b->tunique_est = (double) nunique;
 	b->tminpos = bi.minpos;
 	b->tmaxpos = bi.maxpos;
+	b->batVersion = 0;
 	b->theap->dirty = true;
 	MT_lock_unset(&b->theaplock);
 	TRC_DEBUG(ALGO,
@@ -2591,6 +2607,132 @@ do_sort(void *restrict h, void *restrict t, const void *restrict base,
 	return GDK_SUCCEED;
 }
 
+/* minimum size of a string BAT for which we sort using prefixes */
+#define PFXSORT_MINSIZE	8192
+
+/* Sort the string bat bn in place (and the payload ords along with
+ * it) using the 8 byte prefix of each string (see PFXvalue) as key
+ * for a radix sort.  After that, only runs of values with equal
+ * prefixes that may still differ need to be sorted by looking at the
+ * strings themselves.  If pfx is not NULL, it contains the prefixes
+ * of the values in bn, so that we don't even need to look at the
+ * strings to create the keys. */
+static gdk_return
+do_sort_strprefix(BAT *bn, oid *restrict ords, const uint64_t *restrict pfx,
+		  bool reverse, bool nilslast, bool stable)
+{
+	BUN n = BATcount(bn);
+	uint8_t *restrict vals = (uint8_t *) Tloc(bn, 0);
+	const char *restrict base = bn->tvheap->base;
+	uint16_t width = bn->twidth;
+	/* nil sorts first if reverse == nilslast */
+	const uint64_t nilkey = reverse == nilslast ? 0 : ~(uint64_t) 0;
+	/* GDKrsort sorts native integers as signed values, flipping
+	 * the top bit makes that the same as comparing the prefixes
+	 * as unsigned values */
+	const uint64_t flip = (uint64_t) 1 << 63;
+	Heap kh = {.farmid = 1}, ih = {.farmid = 1}, th = {.farmid = 1};
+	uint64_t *restrict keys;
+	oid *restrict idx;
+	BUN i, j;
+	QryCtx *qry_ctx = MT_thread_get_qry_ctx();
+
+	snprintf(kh.filename, sizeof(kh.filename), "%s%cpfxsort%zuk",
+		 TEMPDIR_NAME, DIR_SEP, (size_t) MT_getpid());
+	snprintf(ih.filename, sizeof(ih.filename), "%s%cpfxsort%zui",
+		 TEMPDIR_NAME, DIR_SEP, (size_t) MT_getpid());
+	snprintf(th.filename, sizeof(th.filename), "%s%cpfxsort%zut",
+		 TEMPDIR_NAME, DIR_SEP, (size_t) MT_getpid());
+	if (HEAPalloc(&kh, n, sizeof(uint64_t)) != GDK_SUCCEED)
+		return GDK_FAIL;
+	if (HEAPalloc(&ih, n, sizeof(oid)) != GDK_SUCCEED) {
+		HEAPfree(&kh, true);
+		return GDK_FAIL;
+	}
+	if (HEAPalloc(&th, n, MAX(width, sizeof(oid))) != GDK_SUCCEED) {
+		HEAPfree(&kh, true);
+		HEAPfree(&ih, true);
+		return GDK_FAIL;
+	}
+	keys = (uint64_t *) kh.base;
+	idx = (oid *) ih.base;
+
+	TIMEOUT_LOOP_IDX(i, n, qry_ctx) {
+		if (pfx && pfx[i] != 0) {
+			keys[i] = pfx[i] ^ flip;
+		} else {
+			/* nil isn't necessarily stored at offset 0, so
+			 * recognize it by its value */
+			var_t off = VarHeapVal(vals, i, width);
+			const char *v = off == 0 ? str_nil : base + off;
+			keys[i] = (strNil(v) ? nilkey : PFXvalue(v)) ^ flip;
+		}
+		idx[i] = (oid) i;
+	}
+	TIMEOUT_CHECK(qry_ctx, GOTO_LABEL_TIMEOUT_HANDLER(bailout, qry_ctx));
+
+	if (GDKrsort(keys, idx, n, sizeof(uint64_t), sizeof(oid), reverse, false) != GDK_SUCCEED)
+		goto bailout;
+
+	/* rearrange the offsets and the payload according to the
+	 * sorted keys */
+	memcpy(th.base, vals, n * width);
+	switch (width) {
+	case 1:
+		for (i = 0; i < n; i++)
+			vals[i] = ((const uint8_t *) th.base)[idx[i]];
+		break;
+	case 2:
+		for (i = 0; i < n; i++)
+			((uint16_t *) vals)[i] = ((const uint16_t *) th.base)[idx[i]];
+		break;
+	case 4:
+		for (i = 0; i < n; i++)
+			((uint32_t *) vals)[i] = ((const uint32_t *) th.base)[idx[i]];
+		break;
+#if SIZEOF_VAR_T == 8
+	case 8:
+		for (i = 0; i < n; i++)
+			((uint64_t *) vals)[i] = ((const uint64_t *) th.base)[idx[i]];
+		break;
+#endif
+	default:
+		MT_UNREACHABLE();
+	}
+	if (ords) {
+		memcpy(th.base, ords, n * sizeof(oid));
+		for (i = 0; i < n; i++)
+			ords[i] = ((const oid *) th.base)[idx[i]];
+	}
+
+	/* sort the runs of equal keys where the strings may differ:
+	 * the prefix is 0 (nil or empty string) or the strings are
+	 * longer than the prefix */
+	for (i = 0; i < n; i = j) {
+		uint64_t k = keys[i];
+		for (j = i + 1; j < n && keys[j] == k; j++)
+			;
+		k ^= flip;
+		if (j - i > 1 &&
+		    (k == 0 || (k & 0xFF) != 0) &&
+		    do_sort(vals + i * width, ords ? ords + i : NULL, base,
+			    j - i, width, ords ? sizeof(oid) : 0, bn->ttype,
+			    reverse, nilslast, stable) != GDK_SUCCEED)
+			goto bailout;
+	}
+
+	HEAPfree(&kh, true);
+	HEAPfree(&ih, true);
+	HEAPfree(&th, true);
+	return GDK_SUCCEED;
+
+  bailout:
+	HEAPfree(&kh, true);
+	HEAPfree(&ih, true);
+	HEAPfree(&th, true);
+	return GDK_FAIL;
+}
+
 /* Sort the bat b according to both o and g.  The stable and reverse
  * parameters indicate whether the sort should be stable or descending
  * respectively.  The parameter b is required, o and g are optional
@@ -2637,6 +2779,8 @@ BATsort(BAT **sorted, BAT **order, BAT **groups,
 	lng t0 = GDKusec();
 	bool mkorderidx, orderidxlock = false;
 	Heap *oidxh = NULL;
+	Heap *pfxh = NULL;
+	const uint64_t *pfx = NULL;
 
 	/* we haven't implemented NILs as largest value for stable
 	 * sort, so NILs come first for ascending and last for
@@ -2773,6 +2917,12 @@ BATsort(BAT **sorted, BAT **order, BAT **groups,
 	}
 	bat_iterator_end(&pbi);
 	pbi = bat_iterator(pb);
+	if (g == NULL && o == NULL && pb != NULL &&
+	    ATOMstorage(b->ttype) == TYPE_str &&
+	    BATcount(b) >= PFXSORT_MINSIZE) {
+		/* use the string prefixes if they're available */
+		pfx = PFXacquire(&pbi, &pfxh);
+	}
 	/* when we will create an order index if it doesn't already exist */
 	mkorderidx = (g == NULL && !reverse && !nilslast && pb != NULL && (order || !pbi.transient));
 	if (g == NULL && !reverse && !nilslast && pb != NULL) {
@@ -2853,6 +3003,8 @@ BATsort(BAT **sorted, BAT **order, BAT **groups,
 			  ALGOOPTBATPAR(on), GDKusec() - t0);
 		if (pb != NULL && pb != b)
 			BBPunfix(pb->batCacheid);
+		if (pfxh)
+			HEAPdecref(pfxh, false);
 		return GDK_SUCCEED;
 	} else if (oidxh) {
 		HEAPdecref(oidxh, false);
@@ -3023,11 +3175,16 @@ BATsort(BAT **sorted, BAT **order, BAT **groups,
 		if ((reverse != nilslast ||
 		     (reverse ? !bn->trevsorted : !bn->tsorted)) &&
 		    (BATmaterialize(bn, BUN_NONE) != GDK_SUCCEED ||
-		     do_sort(Tloc(bn, 0),
-			     ords,
-			     bn->tvheap ? bn->tvheap->base : NULL,
-			     BATcount(bn), bn->twidth, ords ? sizeof(oid) : 0,
-			     bn->ttype, reverse, nilslast, stable) != GDK_SUCCEED)) {
+		     (ATOMstorage(bn->ttype) == TYPE_str &&
+		      BATatoms[bn->ttype].atomCmp == BATatoms[TYPE_str].atomCmp &&
+		      BATcount(bn) >= PFXSORT_MINSIZE
+		      ? do_sort_strprefix(bn, ords, pfx, reverse, nilslast,
+					  stable)
+		      : do_sort(Tloc(bn, 0),
+				ords,
+				bn->tvheap ? bn->tvheap->base : NULL,
+				BATcount(bn), bn->twidth, ords ? sizeof(oid) : 0,
+				bn->ttype, reverse, nilslast, stable)) != GDK_SUCCEED)) {
 			if (m != NULL) {
 				HEAPfree(m, true);
 				GDKfree(m);
@@ -3058,6 +3215,10 @@ BATsort(BAT **sorted, BAT **order, BAT **groups,
 		MT_lock_unset(&pb->batIdxLock);
 		orderidxlock = false;
 	}
+	if (pfxh) {
+		HEAPdecref(pfxh, false);
+		pfxh = NULL;
+	}
 	bn->theap->dirty = true;
 	bn->tnosorted = 0;
 	bn->tnorevsorted = 0;
@@ -3103,6 +3264,8 @@ BATsort(BAT **sorted, BAT **order, BAT **groups,
 		MT_lock_unset(&pb->batIdxLock);
 	if (oidxh)
 		HEAPdecref(oidxh, false);
+	if (pfxh)
+		HEAPdecref(pfxh, false);
 	BBPreclaim(bn);
 	if (pb && pb != b)
 		BBPunfix(pb->batCacheid);
@@ -1222,6 +1222,9 @@ fixhashashbat(BAT *b)
 	OIDXdestroy(b);
 	PROPdestroy(b);
 	STRMPdestroy(b);
+	TRGMdestroy(b);
+	FTXTdestroy(b);
+	PFXdestroy(b);
 	RTREEdestroy(b);
 	TSKdestroy(b);
 
@@ -1447,6 +1450,9 @@ jsonupgradebat(BAT *b, json_storage_conversion fixJSONStorage)
 	OIDXdestroy(b);
 	PROPdestroy(b);
 	STRMPdestroy(b);
+	TRGMdestroy(b);
+	FTXTdestroy(b);
+	PFXdestroy(b);
 	RTREEdestroy(b);
 
 	/* backup the current heaps */
@@ -4584,6 +4590,8 @@ BBPrecover(int farmid)
 			GDKunlink(farmid, dstpath, path, "thashb");
 			GDKunlink(farmid, dstpath, path, "torderidx");
 			GDKunlink(farmid, dstpath, path, "tstrimps");
+			GDKunlink(farmid, dstpath, path, "ttrigram");
+			GDKunlink(farmid, dstpath, path, "tfulltext");
 		}
 	}
 	closedir(dirp);
@@ -4820,6 +4828,19 @@ BBPdiskscan(const char *parent, size_t baseoff)
 				delete = b == NULL;
 				if (!delete)
 					b->tstrimps = (Strimps *)1;
+			} else if (strncmp(p + 1, "ttrigram", 8) == 0) {
+				BAT *b = getdesc(bid);
+				delete = b == NULL;
+				if (!delete)
+					b->ttrigram = (Heap *) 1;
+			} else if (strncmp(p + 1, "tfulltext", 9) == 0) {
+				BAT *b = getdesc(bid);
+				delete = b == NULL;
+				if (!delete)
+					b->tfulltext = (Heap *) 1;
+			} else if (strncmp(p + 1, "tprefix", 7) == 0) {
+				/* prefix heaps are not persistent */
+				delete = true;
 			} else if (strncmp(p + 1, "new", 3) != 0) {
 				ok = false;
 			}
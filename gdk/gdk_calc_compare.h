@@ -18,7 +18,7 @@ op_typeswitchloop(const void *lft, int tp1, bool incr1, const char *hp1, int wd1
 		  oid candoff1, oid candoff2,
 		  bool nonil,
 #ifdef NIL_MATCHES_FLAG
-		  bool nil_matches,
+		  bool nil_matches, bool vkey,
 #endif
 		  const char *func)
 {
@@ -683,6 +683,37 @@ op_typeswitchloop(const void *lft, int tp1, bool incr1, const char *hp1, int wd1
 	case TYPE_str:
 		if (tp1 != tp2)
 			goto unsupported;
+#ifdef NIL_MATCHES_FLAG
+		if (vkey) {
+			/* strings in the shared heap are unique, so we
+			 * can compare the offsets instead of the
+			 * strings; nil is not necessarily at offset 0
+			 * (older heaps), so look at the value */
+			assert(hp1 != NULL && hp1 == hp2);
+			TIMEOUT_LOOP_IDX(k, ncand, qry_ctx) {
+				if (incr1)
+					i = canditer_next(ci1) - candoff1;
+				if (incr2)
+					j = canditer_next(ci2) - candoff2;
+				var_t o1 = VarHeapVal(lft, i, wd1);
+				var_t o2 = VarHeapVal(rgt, j, wd2);
+				bool n1 = o1 == 0 || strNil(hp1 + o1);
+				bool n2 = o2 == 0 || strNil(hp2 + o2);
+				if (n1 || n2) {
+					if (nil_matches) {
+						dst[k] = OP(n1, n2);
+					} else {
+						nils++;
+						dst[k] = TPE_nil;
+					}
+				} else {
+					dst[k] = OP(o1, o2);
+				}
+			}
+			TIMEOUT_CHECK(qry_ctx, TIMEOUT_HANDLER(BUN_NONE, qry_ctx));
+			break;
+		}
+#endif
 		TIMEOUT_LOOP_IDX(k, ncand, qry_ctx) {
 			if (incr1)
 				i = canditer_next(ci1) - candoff1;
@@ -790,7 +821,7 @@ BATcalcop_intern(const void *lft, int tp1, bool incr1, const char *hp1, int wd1,
 		 struct canditer *restrict ci1, struct canditer *restrict ci2,
 		 oid candoff1, oid candoff2, bool nonil, oid seqbase,
 #ifdef NIL_MATCHES_FLAG
-		 bool nil_matches,
+		 bool nil_matches, bool vkey,
 #endif
 		 const char *func)
 {
@@ -809,7 +840,7 @@ BATcalcop_intern(const void *lft, int tp1, bool incr1, const char *hp1, int wd1,
 				 dst, ci1, ci2, candoff1, candoff2,
 				 nonil,
 #ifdef NIL_MATCHES_FLAG
-				 nil_matches,
+				 nil_matches, vkey,
 #endif
 				 func);
 
@@ -883,6 +914,10 @@ BATcalcop(BAT *b1, BAT *b2, BAT *s1, BAT *s2
 				ci1.hseq,
 #ifdef NIL_MATCHES_FLAG
 				nil_matches,
+				/* both sides share a string heap without
+				 * duplicates (e.g. the same ustr parent), so
+				 * equal offsets means equal strings */
+				b1i.vh != NULL && b1i.vh == b2i.vh && b1i.vkey,
 #endif
 				__func__);
 	bat_iterator_end(&b1i);
@@ -922,7 +957,7 @@ BATcalcopcst(BAT *b, const ValRecord *v, BAT *s
 				bi.nonil && !ATOMeq(v->vtype, VALptr(v), ATOMnilptr(v->vtype)),
 				ci.hseq,
 #ifdef NIL_MATCHES_FLAG
-				nil_matches,
+				nil_matches, false,
 #endif
 				__func__);
 	bat_iterator_end(&bi);
@@ -961,7 +996,7 @@ BATcalccstop(const ValRecord *v, BAT *b, BAT *s
 				bi.nonil && !ATOMeq(v->vtype, VALptr(v), ATOMnilptr(v->vtype)),
 				ci.hseq,
 #ifdef NIL_MATCHES_FLAG
-				nil_matches,
+				nil_matches, false,
 #endif
 				__func__);
 	bat_iterator_end(&bi);
@@ -992,7 +1027,7 @@ VARcalcop(ValPtr ret, const ValRecord *lft, const ValRecord *rgt
 			      0, 0,
 			      false,
 #ifdef NIL_MATCHES_FLAG
-			      nil_matches,
+			      nil_matches, false,
 #endif
 			      __func__) == BUN_NONE)
 		return GDK_FAIL;
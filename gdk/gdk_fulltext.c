@@ -0,0 +1,1324 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * For copyright information, see the file debian/copyright.
+ */
+
+/*
+ * Full-text index on string BATs.
+ *
+ * Values are case folded and split into words: maximal sequences of
+ * letters and digits, where any byte of a multi-byte UTF-8 sequence
+ * counts as a letter, except for the Latin-1 and general punctuation
+ * blocks.  There is no stemming and there are no stop words.  A word
+ * is identified by a 64 bit hash of its bytes.
+ *
+ * For each word the index holds the number of rows that contain it,
+ * and the list of those rows together with the number of times the
+ * word occurs in them.  The lists are stored as pairs of varints: the
+ * distance to the previous row and the term frequency.  The index also
+ * keeps the number of words of each row and totals over all rows,
+ * which together is what is needed for BM25 scoring.
+ *
+ * Like the trigram index, the index covers the first so many rows of
+ * the BAT.  Rows that are appended later are looked at directly, and
+ * once there are enough of them, the index is extended.  Any other
+ * update destroys the index.
+ *
+ * The heap consists of a header of FULLTEXTOFF ulngs (version, number
+ * of rows covered, number of words, size of the lists in bytes, total
+ * number of words in all rows, number of non-nil rows), for each word
+ * in order of hash value four ulngs (hash, offset of its list, number
+ * of rows, last row), the number of words of each row (uint32_t), and
+ * finally the lists.
+ */
+
+#include "monetdb_config.h"
+#include "gdk.h"
+#include "gdk_private.h"
+
+#define FULLTEXT_VERSION	((ulng) 1)
+#define FULLTEXTOFF		6
+
+/* BM25 parameters */
+#define FULLTEXT_K1		1.2
+#define FULLTEXT_B		0.75
+
+#define FTXTdict(hp)		((ulng *) (hp)->base + FULLTEXTOFF)
+#define FTXTdoclen(hp)							\
+	((uint32_t *) (FTXTdict(hp) + 4 * ((ulng *) (hp)->base)[2]))
+#define FTXTlists(hp)							\
+	((uint8_t *) (FTXTdoclen(hp) + ((ulng *) (hp)->base)[1]))
+
+static size_t
+FTXTsize(BUN cnt, BUN nterms, BUN nbytes)
+{
+	return (FULLTEXTOFF + 4 * nterms) * sizeof(ulng)
+		+ cnt * sizeof(uint32_t) + nbytes;
+}
+
+/* return the case folded version of s, either s itself or a copy in
+ * *buf; NULL on failure */
+static const uint8_t *
+FTXTfold(allocator *ma, char **buf, size_t *buflen, const char *s)
+{
+	for (const uint8_t *p = (const uint8_t *) s; *p; p++) {
+		if (*p >= 0x80 || (*p >= 'A' && *p <= 'Z')) {
+			if (GDKcasefold(ma, buf, buflen, s) != GDK_SUCCEED)
+				return NULL;
+			return (const uint8_t *) *buf;
+		}
+	}
+	return (const uint8_t *) s;
+}
+
+/* the length of the separator at the start of the case folded string
+ * s, 0 if it starts with a word character */
+static inline int
+FTXTseplen(const uint8_t *s)
+{
+	if (s[0] < 0x80)
+		return !((s[0] >= '0' && s[0] <= '9') || (s[0] >= 'a' && s[0] <= 'z'));
+	/* U+00A0 - U+00BF except for the feminine and masculine
+	 * ordinals, the multiplication sign and the division sign */
+	if ((s[0] == 0xC2 && s[1] >= 0xA0 && s[1] != 0xAA && s[1] != 0xBA) ||
+	    (s[0] == 0xC3 && (s[1] == 0x97 || s[1] == 0xB7)))
+		return 2;
+	/* general punctuation U+2000 - U+206F and CJK punctuation
+	 * U+3000 - U+303F */
+	if (((s[0] == 0xE2 && (s[1] == 0x80 || s[1] == 0x81)) ||
+	     (s[0] == 0xE3 && s[1] == 0x80)) && s[2] != 0)
+		return 3;
+	return 0;
+}
+
+/* find the next word in the case folded string *sp, and store its
+ * hash in *hp; return false if there are no more words */
+static inline bool
+FTXTnext(const uint8_t **sp, ulng *hp)
+{
+	const uint8_t *s = *sp;
+	ulng h = UINT64_C(14695981039346656037);
+	int l;
+
+	while (*s && (l = FTXTseplen(s)) > 0)
+		s += l;
+	if (*s == 0) {
+		*sp = s;
+		return false;
+	}
+	do {
+		h = (h ^ *s++) * UINT64_C(1099511628211);
+	} while (*s && FTXTseplen(s) == 0);
+	*sp = s;
+	*hp = h;
+	return true;
+}
+
+/* the distinct words of a query */
+typedef struct {
+	int n;
+	ulng *h;
+} FTXTquery;
+
+static gdk_return
+FTXTparse(allocator *ma, FTXTquery *q, const char *query)
+{
+	char *buf = NULL;
+	size_t buflen = 0;
+	const uint8_t *s;
+	ulng h;
+
+	q->n = 0;
+	q->h = NULL;
+	if (strNil(query))
+		return GDK_SUCCEED;
+	if ((s = FTXTfold(ma, &buf, &buflen, query)) == NULL ||
+	    (q->h = ma_alloc(ma, (strlen((const char *) s) / 2 + 1) * sizeof(ulng))) == NULL)
+		return GDK_FAIL;
+	while (FTXTnext(&s, &h)) {
+		int i;
+		for (i = 0; i < q->n; i++)
+			if (q->h[i] == h)
+				break;
+		if (i == q->n)
+			q->h[q->n++] = h;
+	}
+	return GDK_SUCCEED;
+}
+
+/* count the words of v and the occurrences of each query word in tf;
+ * return the number of words, or BUN_NONE on failure */
+static BUN
+FTXTcount(allocator *ma, char **buf, size_t *buflen, const char *v,
+	  const FTXTquery *q, uint32_t *tf)
+{
+	const uint8_t *s;
+	BUN dl = 0;
+	ulng h;
+
+	if ((s = FTXTfold(ma, buf, buflen, v)) == NULL)
+		return BUN_NONE;
+	memset(tf, 0, q->n * sizeof(uint32_t));
+	while (FTXTnext(&s, &h)) {
+		dl++;
+		for (int i = 0; i < q->n; i++) {
+			if (q->h[i] == h) {
+				tf[i]++;
+				break;
+			}
+		}
+	}
+	return dl;
+}
+
+static inline dbl
+FTXTbm25(dbl idf, uint32_t tf, BUN dl, dbl avgdl)
+{
+	if (tf == 0)
+		return 0;
+	return idf * (tf * (FULLTEXT_K1 + 1))
+		/ (tf + FULLTEXT_K1 * (1 - FULLTEXT_B + FULLTEXT_B * dl / avgdl));
+}
+
+/* fill in the inverse document frequency of each word of the query in
+ * a collection of ndocs documents of total words in all, and return
+ * the average document length */
+static dbl
+FTXTstats(const FTXTquery *q, ulng ndocs, ulng total, const BUN *df, dbl *idf)
+{
+	for (int k = 0; k < q->n; k++)
+		idf[k] = log(1 + (ndocs - df[k] + 0.5) / (df[k] + 0.5));
+	return ndocs > 0 && total > 0 ? (dbl) total / ndocs : 1;
+}
+
+static inline size_t
+FTXTvarlen(ulng v)
+{
+	size_t n = 1;
+	while (v >= 0x80) {
+		v >>= 7;
+		n++;
+	}
+	return n;
+}
+
+static inline uint8_t *
+FTXTputvar(uint8_t *p, ulng v)
+{
+	while (v >= 0x80) {
+		*p++ = (uint8_t) (v | 0x80);
+		v >>= 7;
+	}
+	*p++ = (uint8_t) v;
+	return p;
+}
+
+static inline ulng
+FTXTgetvar(const uint8_t **pp)
+{
+	const uint8_t *p = *pp;
+	ulng v = 0;
+	int shift = 0;
+
+	while (*p & 0x80) {
+		v |= (ulng) (*p++ & 0x7F) << shift;
+		shift += 7;
+	}
+	v |= (ulng) *p++ << shift;
+	*pp = p;
+	return v;
+}
+
+/* decode the list of df rows starting at p into rows and, if not
+ * NULL, tfs */
+static void
+FTXTdecode(const uint8_t *p, BUN df, uint32_t *restrict rows, uint32_t *restrict tfs)
+{
+	ulng next = 0;
+
+	for (BUN i = 0; i < df; i++) {
+		next += FTXTgetvar(&p);
+		rows[i] = (uint32_t) next++;
+		ulng tf = FTXTgetvar(&p);
+		if (tfs)
+			tfs[i] = (uint32_t) tf;
+	}
+}
+
+/* binary search for the word with hash h in the dictionary of hp;
+ * return its entry or NULL */
+static const ulng *
+FTXTfind(const Heap *hp, ulng h)
+{
+	const ulng *dict = FTXTdict(hp);
+	BUN lo = 0, hi = (BUN) ((const ulng *) hp->base)[2];
+
+	while (lo < hi) {
+		BUN mid = (lo + hi) / 2;
+		if (dict[4 * mid] < h)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo < (BUN) ((const ulng *) hp->base)[2] && dict[4 * lo] == h)
+		return dict + 4 * lo;
+	return NULL;
+}
+
+static void
+FTXTsync(void *arg)
+{
+	BAT *b = arg;
+	Heap *hp;
+	int fd;
+	lng t0 = GDKusec();
+	const char *failed = " failed";
+
+	MT_lock_set(&b->batIdxLock);
+	if ((hp = b->tfulltext) != NULL && hp != (Heap *) 1) {
+		if (HEAPsave(hp, hp->filename, NULL, true, hp->free, NULL) == GDK_SUCCEED) {
+			if (hp->storage == STORE_MEM) {
+				if ((fd = GDKfdlocate(hp->farmid, hp->filename, "rb+", NULL)) >= 0) {
+					((ulng *) hp->base)[0] |= (ulng) 1 << 24;
+					if (write(fd, hp->base, sizeof(ulng)) >= 0) {
+						failed = ""; /* not failed */
+						if (!(ATOMIC_GET(&GDKdebug) & NOSYNCMASK)) {
+#if defined(NATIVE_WIN32)
+							_commit(fd);
+#elif defined(HAVE_FDATASYNC)
+							fdatasync(fd);
+#elif defined(HAVE_FSYNC)
+							fsync(fd);
+#endif
+						}
+					} else {
+						hp->dirty = true;
+						perror("write full-text index");
+					}
+					close(fd);
+				}
+			} else {
+				((ulng *) hp->base)[0] |= (ulng) 1 << 24;
+				if (!(ATOMIC_GET(&GDKdebug) & NOSYNCMASK) &&
+				    MT_msync(hp->base, sizeof(ulng)) < 0) {
+					hp->dirty = true;
+					failed = " sync failed";
+					((ulng *) hp->base)[0] &= ~((ulng) 1 << 24);
+				} else {
+					failed = ""; /* not failed */
+				}
+			}
+			TRC_DEBUG(ACCELERATOR, "FTXTsync(%s): full-text index persisted"
+				  " (" LLFMT " usec)%s\n",
+				  BATgetId(b), GDKusec() - t0, failed);
+		}
+	}
+	MT_lock_unset(&b->batIdxLock);
+	BBPunfix(b->batCacheid);
+}
+
+/* maybe persist the full-text index heap; called with batIdxLock
+ * held */
+static void
+FTXTpersist(BAT *b)
+{
+	if ((BBP_status(b->batCacheid) & BBPEXISTING) &&
+	    b->batInserted == b->batCount &&
+	    !b->theap->dirty &&
+	    !GDKinmemory(b->theap->farmid)) {
+		MT_Id tid;
+		BBPfix(b->batCacheid);
+		char name[MT_NAME_LEN];
+		snprintf(name, sizeof(name), "ftxtsync%d", b->batCacheid);
+		if (MT_create_thread(&tid, FTXTsync, b,
+				     MT_THR_DETACHED, name) < 0)
+			BBPunfix(b->batCacheid);
+	} else
+		TRC_DEBUG(ACCELERATOR, "FTXTpersist(" ALGOBATFMT "): NOT persisting full-text index\n", ALGOBATPAR(b));
+}
+
+/* make sure a persisted full-text index is loaded; called with
+ * batIdxLock held */
+static void
+FTXTload(BAT *b)
+{
+	Heap *hp;
+	const char *nme = BBP_physical(b->batCacheid);
+	int fd;
+
+	if (b->tfulltext != (Heap *) 1)
+		return;
+	assert(!GDKinmemory(b->theap->farmid));
+	b->tfulltext = NULL;
+	if ((hp = GDKzalloc(sizeof(*hp))) != NULL &&
+	    (hp->farmid = BBPselectfarm(b->batRole, b->ttype, fulltextheap)) >= 0) {
+		strtconcat(hp->filename, sizeof(hp->filename),
+			   nme, ".tfulltext", NULL);
+		hp->storage = hp->newstorage = STORE_INVALID;
+
+		/* check whether a persisted full-text index can be found */
+		if ((fd = GDKfdlocate(hp->farmid, nme, "rb+", "tfulltext")) >= 0) {
+			struct stat st;
+			ulng hdata[FULLTEXTOFF];
+
+			if (read(fd, hdata, sizeof(hdata)) == sizeof(hdata) &&
+			    hdata[0] == (((ulng) 1 << 24) | FULLTEXT_VERSION) &&
+			    hdata[1] <= (ulng) BATcount(b) &&
+			    fstat(fd, &st) == 0 &&
+			    st.st_size >= (off_t) (hp->size = hp->free = FTXTsize((BUN) hdata[1], (BUN) hdata[2], (BUN) hdata[3])) &&
+			    HEAPload(hp, nme, "tfulltext", false) == GDK_SUCCEED) {
+				close(fd);
+				ATOMIC_INIT(&hp->refs, 1);
+				hp->hasfile = true;
+				b->tfulltext = hp;
+				TRC_DEBUG(ACCELERATOR, "FTXTload(" ALGOBATFMT "): reusing persisted full-text index\n", ALGOBATPAR(b));
+				return;
+			}
+			close(fd);
+			/* unlink unusable file */
+			GDKunlink(hp->farmid, BATDIR, nme, "tfulltext");
+		}
+	}
+	GDKfree(hp);
+	GDKclrerr();	/* we're not currently interested in errors */
+}
+
+/* the words found while building an index */
+typedef struct {
+	ulng *hash;		/* hash of each word */
+	BUN *cnt;		/* number of rows, later next list position */
+	BUN *start;		/* start of its list */
+	uint32_t *last;		/* one more than the last row containing it */
+	BUN *slot;		/* hash table: word number + 1, 0 if empty */
+	BUN n, max, mask;
+} FTXTwords;
+
+static void
+FTXTwordsfree(FTXTwords *w)
+{
+	GDKfree(w->hash);
+	GDKfree(w->cnt);
+	GDKfree(w->start);
+	GDKfree(w->last);
+	GDKfree(w->slot);
+}
+
+/* return the number of the word with hash h, adding it if needed;
+ * BUN_NONE on failure */
+static BUN
+FTXTword(FTXTwords *w, ulng h)
+{
+	BUN i;
+
+	for (i = (BUN) (h ^ (h >> 32)) & w->mask; w->slot[i]; i = (i + 1) & w->mask)
+		if (w->hash[w->slot[i] - 1] == h)
+			return w->slot[i] - 1;
+	if (w->n == w->max) {
+		BUN max = w->max * 2;
+		ulng *hash;
+		BUN *cnt, *slot;
+		uint32_t *last;
+
+		if ((hash = GDKrealloc(w->hash, max * sizeof(ulng))) == NULL)
+			return BUN_NONE;
+		w->hash = hash;
+		if ((cnt = GDKrealloc(w->cnt, max * sizeof(BUN))) == NULL)
+			return BUN_NONE;
+		w->cnt = cnt;
+		if ((last = GDKrealloc(w->last, max * sizeof(uint32_t))) == NULL)
+			return BUN_NONE;
+		w->last = last;
+		/* the hash table is kept at most half full */
+		if ((slot = GDKzalloc(2 * max * sizeof(BUN))) == NULL)
+			return BUN_NONE;
+		GDKfree(w->slot);
+		w->slot = slot;
+		w->max = max;
+		w->mask = 2 * max - 1;
+		for (BUN j = 0; j < w->n; j++) {
+			BUN k;
+			for (k = (BUN) (w->hash[j] ^ (w->hash[j] >> 32)) & w->mask; slot[k]; k = (k + 1) & w->mask)
+				;
+			slot[k] = j + 1;
+		}
+		for (i = (BUN) (h ^ (h >> 32)) & w->mask; w->slot[i]; i = (i + 1) & w->mask)
+			;
+	}
+	w->hash[w->n] = h;
+	w->cnt[w->n] = 0;
+	w->last[w->n] = 0;
+	w->slot[i] = ++w->n;
+	return w->n - 1;
+}
+
+typedef struct {
+	ulng hash;
+	BUN word;
+} FTXTsorted;
+
+static int
+FTXTcmphash(const void *a, const void *b)
+{
+	const FTXTsorted *x = a, *y = b;
+	return (x->hash > y->hash) - (x->hash < y->hash);
+}
+
+/* build a full-text index on the rows of bi; if old is not NULL, it is
+ * an index on a prefix of those rows which is extended with the rest;
+ * returns NULL on failure */
+static Heap *
+FTXTbuild(BAT *b, BATiter *bi, const Heap *old)
+{
+	BUN cnt = bi->count, ocnt = 0, oterms = 0, nterms, nbytes, npost;
+	FTXTwords w = {0};
+	FTXTsorted *sorted = NULL;
+	uint32_t *prow = NULL, *ptf = NULL, *dl = NULL;
+	const ulng *odict = NULL;
+	const uint8_t *olists = NULL;
+	ulng total = 0, ndocs = 0;
+	Heap *m = NULL;
+	allocator *ta = MT_thread_getallocator();
+	allocator_state ta_state = ma_open(ta);
+	char *buf = NULL;
+	size_t buflen = 0;
+	const uint8_t *s;
+	ulng h;
+	lng t0 = GDKusec();
+
+	if (cnt >= (BUN) UINT32_MAX) {
+		GDKerror("too many rows for a full-text index\n");
+		ma_close(&ta_state);
+		return NULL;
+	}
+	if (old) {
+		ocnt = (BUN) ((const ulng *) old->base)[1];
+		oterms = (BUN) ((const ulng *) old->base)[2];
+		total = ((const ulng *) old->base)[4];
+		ndocs = ((const ulng *) old->base)[5];
+		odict = FTXTdict(old);
+		olists = FTXTlists(old);
+		assert(ocnt <= cnt);
+	}
+
+	w.max = 1024;
+	w.mask = 2 * w.max - 1;
+	if ((w.hash = GDKmalloc(w.max * sizeof(ulng))) == NULL ||
+	    (w.cnt = GDKmalloc(w.max * sizeof(BUN))) == NULL ||
+	    (w.last = GDKmalloc(w.max * sizeof(uint32_t))) == NULL ||
+	    (w.slot = GDKzalloc(2 * w.max * sizeof(BUN))) == NULL ||
+	    (dl = GDKmalloc((cnt - ocnt) * sizeof(uint32_t) + 1)) == NULL)
+		goto bailout;
+
+	/* first pass: collect the words, count the rows they occur in,
+	 * and the number of words in each row */
+	for (BUN i = ocnt; i < cnt; i++) {
+		const char *v = BUNtvar(bi, i);
+		BUN n = 0;
+		if (strNil(v)) {
+			dl[i - ocnt] = 0;
+			continue;
+		}
+		if ((s = FTXTfold(ta, &buf, &buflen, v)) == NULL)
+			goto bailout;
+		while (FTXTnext(&s, &h)) {
+			BUN k = FTXTword(&w, h);
+			if (k == BUN_NONE)
+				goto bailout;
+			if (w.last[k] != (uint32_t) i + 1) {
+				w.last[k] = (uint32_t) i + 1;
+				w.cnt[k]++;
+			}
+			n++;
+		}
+		dl[i - ocnt] = n > UINT32_MAX ? UINT32_MAX : (uint32_t) n;
+		total += n;
+		ndocs++;
+	}
+
+	/* second pass: collect the lists */
+	if ((w.start = GDKmalloc(w.n * sizeof(BUN) + 1)) == NULL)
+		goto bailout;
+	npost = 0;
+	for (BUN k = 0; k < w.n; k++) {
+		w.start[k] = npost;
+		npost += w.cnt[k];
+		w.cnt[k] = w.start[k];
+		w.last[k] = 0;
+	}
+	if ((prow = GDKmalloc(npost * sizeof(uint32_t) + 1)) == NULL ||
+	    (ptf = GDKmalloc(npost * sizeof(uint32_t) + 1)) == NULL)
+		goto bailout;
+	for (BUN i = ocnt; i < cnt; i++) {
+		const char *v = BUNtvar(bi, i);
+		if (strNil(v))
+			continue;
+		if ((s = FTXTfold(ta, &buf, &buflen, v)) == NULL)
+			goto bailout;
+		while (FTXTnext(&s, &h)) {
+			BUN k = FTXTword(&w, h);
+			assert(k != BUN_NONE);
+			if (w.last[k] != (uint32_t) i + 1) {
+				w.last[k] = (uint32_t) i + 1;
+				prow[w.cnt[k]] = (uint32_t) i;
+				ptf[w.cnt[k]++] = 1;
+			} else {
+				ptf[w.cnt[k] - 1]++;
+			}
+		}
+	}
+
+	if ((sorted = GDKmalloc(w.n * sizeof(FTXTsorted) + 1)) == NULL)
+		goto bailout;
+	for (BUN k = 0; k < w.n; k++)
+		sorted[k] = (FTXTsorted) {.hash = w.hash[k], .word = k};
+	qsort(sorted, w.n, sizeof(FTXTsorted), FTXTcmphash);
+
+	/* merge the old and the new dictionary, first to find the size
+	 * of the new index, then to fill it */
+	ulng *dict = NULL;
+	uint8_t *lists = NULL, *p = NULL;
+	for (int pass = 0; pass < 2; pass++) {
+		BUN i = 0, j = 0;
+		nterms = nbytes = 0;
+		while (i < oterms || j < w.n) {
+			ulng hash = 0, off = nbytes, df = 0, last = 0, next = 0;
+			bool isold = i < oterms && (j == w.n || odict[4 * i] <= sorted[j].hash);
+			bool isnew = j < w.n && (i == oterms || sorted[j].hash <= odict[4 * i]);
+			if (isold) {
+				/* copy the old list */
+				BUN len = (i + 1 < oterms ? (BUN) odict[4 * (i + 1) + 1] : (BUN) ((const ulng *) old->base)[3]) - (BUN) odict[4 * i + 1];
+				hash = odict[4 * i];
+				df = odict[4 * i + 2];
+				last = odict[4 * i + 3];
+				next = last + 1;
+				if (p) {
+					memcpy(p, olists + odict[4 * i + 1], len);
+					p += len;
+				}
+				nbytes += len;
+				i++;
+			}
+			if (isnew) {
+				/* add the new list, continuing the old one */
+				BUN k = sorted[j++].word;
+				hash = w.hash[k];
+				for (BUN l = w.start[k]; l < w.cnt[k]; l++) {
+					if (p) {
+						p = FTXTputvar(p, prow[l] - next);
+						p = FTXTputvar(p, ptf[l]);
+					}
+					nbytes += FTXTvarlen(prow[l] - next) + FTXTvarlen(ptf[l]);
+					next = (ulng) prow[l] + 1;
+				}
+				df += w.cnt[k] - w.start[k];
+				last = next - 1;
+			}
+			if (dict) {
+				dict[4 * nterms] = hash;
+				dict[4 * nterms + 1] = off;
+				dict[4 * nterms + 2] = df;
+				dict[4 * nterms + 3] = last;
+			}
+			nterms++;
+		}
+		if (pass == 1)
+			break;
+
+		if ((m = GDKmalloc(sizeof(Heap))) == NULL)
+			goto bailout;
+		*m = (Heap) {
+			.farmid = BBPselectfarm(b->batRole, b->ttype, fulltextheap),
+			.parentid = b->batCacheid,
+			.dirty = true,
+			.refs = ATOMIC_VAR_INIT(1),
+		};
+		strtconcat(m->filename, sizeof(m->filename),
+			   BBP_physical(b->batCacheid), ".tfulltext", NULL);
+		if (m->farmid < 0 ||
+		    HEAPalloc(m, FTXTsize(cnt, nterms, nbytes), 1) != GDK_SUCCEED) {
+			GDKfree(m);
+			m = NULL;
+			goto bailout;
+		}
+		m->free = FTXTsize(cnt, nterms, nbytes);
+		((ulng *) m->base)[0] = FULLTEXT_VERSION;
+		((ulng *) m->base)[1] = (ulng) cnt;
+		((ulng *) m->base)[2] = (ulng) nterms;
+		((ulng *) m->base)[3] = (ulng) nbytes;
+		((ulng *) m->base)[4] = total;
+		((ulng *) m->base)[5] = ndocs;
+		dict = FTXTdict(m);
+		p = lists = FTXTlists(m);
+		if (ocnt > 0)
+			memcpy(FTXTdoclen(m), FTXTdoclen(old), ocnt * sizeof(uint32_t));
+		if (cnt > ocnt)
+			memcpy(FTXTdoclen(m) + ocnt, dl, (cnt - ocnt) * sizeof(uint32_t));
+	}
+	assert(p == lists + nbytes);
+
+	FTXTwordsfree(&w);
+	GDKfree(sorted);
+	GDKfree(prow);
+	GDKfree(ptf);
+	GDKfree(dl);
+	ma_close(&ta_state);
+	TRC_DEBUG(ACCELERATOR, "FTXTbuild(" ALGOBATFMT "): " BUNFMT " rows, "
+		  BUNFMT " words, " BUNFMT " bytes of lists (" LLFMT " usec)\n",
+		  ALGOBATPAR(b), cnt - ocnt, nterms, nbytes, GDKusec() - t0);
+	return m;
+
+  bailout:
+	if (m) {
+		HEAPfree(m, true);
+		GDKfree(m);
+	}
+	FTXTwordsfree(&w);
+	GDKfree(sorted);
+	GDKfree(prow);
+	GDKfree(ptf);
+	GDKfree(dl);
+	ma_close(&ta_state);
+	return NULL;
+}
+
+/* build or extend the full-text index of b; if create is false, no
+ * index is built and an existing index is only extended if more than
+ * an eighth of the rows is not covered; called with batIdxLock held */
+static gdk_return
+FTXTupdate(BAT *b, bool create)
+{
+	Heap *hp, *m;
+
+	FTXTload(b);
+	if ((hp = b->tfulltext) == NULL && !create)
+		return GDK_SUCCEED;
+	BATiter bi = bat_iterator(b);
+	if (hp != NULL) {
+		BUN ocnt = (BUN) ((const ulng *) hp->base)[1];
+		if (ocnt > bi.count) {
+			/* the BAT shrunk, the index is of no use */
+			bat_iterator_end(&bi);
+			return GDK_FAIL;
+		}
+		if (ocnt == bi.count || (!create && bi.count - ocnt <= ocnt / 8)) {
+			bat_iterator_end(&bi);
+			return GDK_SUCCEED;
+		}
+		MT_thread_setalgorithm("extend full-text index", __func__);
+		if (hp->hasfile) {
+			/* whoever still uses the old index may have the
+			 * file mapped, so don't overwrite it but start
+			 * afresh */
+			GDKunlink(hp->farmid, BATDIR, BBP_physical(b->batCacheid), "tfulltext");
+			hp->hasfile = false;
+		}
+	} else {
+		MT_thread_setalgorithm("create full-text index", __func__);
+	}
+	m = FTXTbuild(b, &bi, hp);
+	bat_iterator_end(&bi);
+	if (m == NULL) {
+		if (create)
+			return GDK_FAIL;
+		/* keep using the old index */
+		GDKclrerr();
+		return GDK_SUCCEED;
+	}
+	b->tfulltext = m;
+	if (hp != NULL)
+		HEAPdecref(hp, false);
+	FTXTpersist(b);
+	return GDK_SUCCEED;
+}
+
+/* create a full-text index on (the parent of) b, or bring an existing
+ * one up to date */
+gdk_return
+FTXTcreate(BAT *b)
+{
+	BAT *pb = b;
+	gdk_return rc;
+
+	if (ATOMstorage(b->ttype) != TYPE_str) {
+		GDKerror("Cannot create full-text index for non string bats\n");
+		return GDK_FAIL;
+	}
+	if (VIEWtparent(b)) {
+		pb = BATdescriptor(VIEWtparent(b));
+		if (pb == NULL)
+			return GDK_FAIL;
+	}
+	MT_lock_set(&pb->batIdxLock);
+	if ((rc = FTXTupdate(pb, true)) != GDK_SUCCEED && pb->tfulltext != NULL) {
+		/* the BAT shrunk: replace the index */
+		Heap *hp = pb->tfulltext;
+		pb->tfulltext = NULL;
+		if (hp->hasfile)
+			GDKunlink(hp->farmid, BATDIR, BBP_physical(pb->batCacheid), "tfulltext");
+		HEAPdecref(hp, false);
+		rc = FTXTupdate(pb, true);
+	}
+	MT_lock_unset(&pb->batIdxLock);
+	if (pb != b)
+		BBPunfix(pb->batCacheid);
+	return rc;
+}
+
+bool
+BAThasfulltext(BAT *b)
+{
+	BAT *pb = b;
+	bool ret;
+
+	if (VIEWtparent(b)) {
+		pb = BATdescriptor(VIEWtparent(b));
+		if (pb == NULL)
+			return false;
+	}
+	MT_lock_set(&pb->batIdxLock);
+	ret = pb->tfulltext != NULL;
+	MT_lock_unset(&pb->batIdxLock);
+	if (pb != b)
+		BBPunfix(pb->batCacheid);
+	return ret;
+}
+
+/* get a reference to the up to date full-text index of pb, if any */
+static Heap *
+FTXTget(BAT *pb)
+{
+	Heap *hp = NULL;
+
+	MT_lock_set(&pb->batIdxLock);
+	if (pb->tfulltext != NULL) {
+		if (FTXTupdate(pb, false) != GDK_SUCCEED)
+			GDKclrerr();
+		else if ((hp = pb->tfulltext) != NULL)
+			HEAPincref(hp);
+	}
+	MT_lock_unset(&pb->batIdxLock);
+	return hp;
+}
+
+/* Using the index of the parent pb of b, return a candidate list with
+ * a superset of the rows of b (restricted to s) that contain all words
+ * of the query. */
+static BAT *
+FTXTcandidates(BAT *b, BAT *s, BAT *pb, const Heap *hp, const FTXTquery *q, allocator *ta)
+{
+	BUN boff = b->tbaseoff - pb->tbaseoff, bcnt = BATcount(b);
+	BUN ocnt = (BUN) ((const ulng *) hp->base)[1], n = 0;
+	const ulng **ent;
+	uint32_t *res = NULL, *rows;
+	BAT *r, *bn;
+
+	if ((ent = ma_alloc(ta, q->n * sizeof(ulng *))) == NULL)
+		return NULL;
+	/* the words in order of increasing list length */
+	for (int i = 0; i < q->n; i++) {
+		const ulng *e = FTXTfind(hp, q->h[i]);
+		int j;
+		if (e == NULL) {
+			ent[0] = NULL;
+			break;
+		}
+		for (j = i; j > 0 && ent[j - 1][2] > e[2]; j--)
+			ent[j] = ent[j - 1];
+		ent[j] = e;
+	}
+	if (ent[0] != NULL) {
+		BUN lo, hi;
+		if ((res = ma_alloc(ta, ent[0][2] * sizeof(uint32_t) + 1)) == NULL ||
+		    (rows = ma_alloc(ta, ent[q->n - 1][2] * sizeof(uint32_t) + 1)) == NULL)
+			return NULL;
+		FTXTdecode(FTXTlists(hp) + ent[0][1], (BUN) ent[0][2], res, NULL);
+		/* only the part that falls within the range of the view b */
+		for (lo = 0; lo < ent[0][2] && res[lo] < boff; lo++)
+			;
+		for (hi = ent[0][2]; hi > lo && res[hi - 1] >= boff + bcnt; hi--)
+			;
+		n = hi - lo;
+		memmove(res, res + lo, n * sizeof(uint32_t));
+		for (int i = 1; i < q->n && n > 0; i++) {
+			BUN k = 0, j = 0, m = (BUN) ent[i][2];
+			FTXTdecode(FTXTlists(hp) + ent[i][1], m, rows, NULL);
+			for (BUN l = 0; l < n && j < m; l++) {
+				while (j < m && rows[j] < res[l])
+					j++;
+				if (j < m && rows[j] == res[l])
+					res[k++] = res[l];
+			}
+			n = k;
+		}
+	}
+
+	/* rows not covered by the index can all match */
+	BUN tail = boff + bcnt > ocnt ? boff + bcnt - (ocnt > boff ? ocnt : boff) : 0;
+	if ((r = COLnew(0, TYPE_oid, n + tail, TRANSIENT)) == NULL)
+		return NULL;
+	oid *o = Tloc(r, 0);
+	for (BUN j = 0; j < n; j++)
+		o[j] = b->hseqbase + res[j] - boff;
+	for (BUN j = 0; j < tail; j++)
+		o[n + j] = b->hseqbase + bcnt - tail + j;
+	BATsetcount(r, n + tail);
+	r->tkey = true;
+	r->tsorted = true;
+	r->trevsorted = BATcount(r) <= 1;
+	r->tnil = false;
+	r->tnonil = true;
+	r = virtualize(r);
+	if (r && s) {
+		bn = BATintersectcand(r, s);
+		BBPreclaim(r);
+		r = bn;
+	}
+	TRC_DEBUG(ACCELERATOR, "FTXTcandidates(" ALGOBATFMT "): " BUNFMT
+		  " candidates, " BUNFMT " not indexed\n", ALGOBATPAR(b), n, tail);
+	return r;
+}
+
+/* Return the candidate list of the rows of b (restricted to candidate
+ * list s) that contain all words of the query, or with anti set, that
+ * don't.  Nil values never qualify, nor does anything for a nil
+ * query. */
+BAT *
+FTXTselect(BAT *b, BAT *s, const char *query, bool anti)
+{
+	BAT *pb = b, *c = NULL, *bn = NULL;
+	Heap *hp = NULL;
+	FTXTquery q;
+	allocator *ta = MT_thread_getallocator();
+	allocator_state ta_state = ma_open(ta);
+	char *buf = NULL;
+	size_t buflen = 0;
+	uint32_t *tf;
+	struct canditer ci;
+	lng t0 = GDKusec();
+
+	if (ATOMstorage(b->ttype) != TYPE_str) {
+		GDKerror("Full-text search on non string bat\n");
+		goto bailout;
+	}
+	if (FTXTparse(ta, &q, query) != GDK_SUCCEED ||
+	    (tf = ma_alloc(ta, q.n * sizeof(uint32_t) + 1)) == NULL)
+		goto bailout;
+	if (strNil(query)) {
+		bn = BATdense(0, 0, 0);
+		goto bailout;
+	}
+
+	if (!anti && q.n > 0) {
+		if (VIEWtparent(b)) {
+			pb = BATdescriptor(VIEWtparent(b));
+			if (pb == NULL)
+				goto bailout;
+		}
+		if ((hp = FTXTget(pb)) != NULL) {
+			if ((c = FTXTcandidates(b, s, pb, hp, &q, ta)) == NULL)
+				goto bailout;
+			MT_thread_setalgorithm("full-text index", __func__);
+			s = c;
+		}
+	}
+
+	canditer_init(&ci, b, s);
+	if ((bn = COLnew(0, TYPE_oid, 0, TRANSIENT)) == NULL)
+		goto bailout;
+	BATiter bi = bat_iterator(b);
+	oid *o = NULL;
+	BUN n = 0;
+	for (BUN i = 0; i < ci.ncand; i++) {
+		oid x = canditer_next(&ci);
+		const char *v = BUNtvar(&bi, x - b->hseqbase);
+		bool match = false;
+		if (strNil(v))
+			continue;
+		if (q.n > 0) {
+			if (FTXTcount(ta, &buf, &buflen, v, &q, tf) == BUN_NONE) {
+				bat_iterator_end(&bi);
+				BBPreclaim(bn);
+				bn = NULL;
+				goto bailout;
+			}
+			match = true;
+			for (int k = 0; k < q.n; k++)
+				match &= tf[k] > 0;
+		}
+		if (match != anti) {
+			if (n == BATcapacity(bn) &&
+			    BATextend(bn, BATgrows(bn)) != GDK_SUCCEED) {
+				bat_iterator_end(&bi);
+				BBPreclaim(bn);
+				bn = NULL;
+				goto bailout;
+			}
+			o = Tloc(bn, 0);
+			o[n++] = x;
+		}
+	}
+	bat_iterator_end(&bi);
+	BATsetcount(bn, n);
+	bn->tkey = true;
+	bn->tsorted = true;
+	bn->trevsorted = n <= 1;
+	bn->tnil = false;
+	bn->tnonil = true;
+	bn = virtualize(bn);
+	TRC_DEBUG(ACCELERATOR, "FTXTselect(" ALGOBATFMT ",%s,%d): " BUNFMT
+		  " of " BUNFMT " rows qualify (" LLFMT " usec)\n",
+		  ALGOBATPAR(b), query, anti, n, ci.ncand, GDKusec() - t0);
+
+  bailout:
+	BBPreclaim(c);
+	if (hp)
+		HEAPdecref(hp, false);
+	if (pb != b)
+		BBPunfix(pb->batCacheid);
+	ma_close(&ta_state);
+	return bn;
+}
+
+/* the term frequency of row r in the list (rows, tfs) of length len,
+ * or with tfs NULL, whether r is in the list */
+static inline uint32_t
+FTXTrowtf(const uint32_t *rows, const uint32_t *tfs, BUN len, BUN r)
+{
+	BUN lo = 0, hi = len;
+
+	while (lo < hi) {
+		BUN mid = (lo + hi) / 2;
+		if (rows[mid] < r)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo < len && rows[lo] == r ? tfs ? tfs[lo] : 1 : 0;
+}
+
+/* Count the collection statistics for the query over the non-nil rows
+ * of the column pb that are in the candidate list live (all rows if
+ * live is NULL): the number of documents, the total number of words,
+ * and the document frequency of each word of the query.  For the rows
+ * covered by the index hp, these are the totals of the index minus
+ * what the rows that are not in live contribute, the other rows are
+ * tokenized. */
+static gdk_return
+FTXTcollection(BAT *pb, BAT *live, const Heap *hp, const FTXTquery *q,
+	       uint32_t *const *rows, const BUN *len, allocator *ta,
+	       ulng *ndocsp, ulng *totalp, BUN *df, QryCtx *qry_ctx)
+{
+	BUN ocnt = 0, next = 0;
+	ulng ndocs = 0, total = 0;
+	char *buf = NULL;
+	size_t buflen = 0;
+	uint32_t *tf;
+	struct canditer ci;
+	BATiter pi;
+
+	if ((tf = ma_alloc(ta, q->n * sizeof(uint32_t) + 1)) == NULL)
+		return GDK_FAIL;
+	if (hp) {
+		ocnt = (BUN) ((const ulng *) hp->base)[1];
+		total = ((const ulng *) hp->base)[4];
+		ndocs = ((const ulng *) hp->base)[5];
+		for (int k = 0; k < q->n; k++)
+			df[k] = len[k];
+	}
+	pi = bat_iterator(pb);
+	if (ocnt > pi.count)
+		ocnt = pi.count;
+	canditer_init(&ci, pb, live);
+	TIMEOUT_LOOP_IDX_DECL(i, ci.ncand + 1, qry_ctx) {
+		BUN p = i < ci.ncand ? canditer_next(&ci) - pb->hseqbase : pi.count;
+		const char *v;
+
+		/* the indexed rows that are not in live don't count */
+		for (; next < p && next < ocnt; next++) {
+			if (strNil(BUNtvar(&pi, next)))
+				continue;
+			ndocs--;
+			total -= FTXTdoclen(hp)[next];
+			for (int k = 0; k < q->n; k++)
+				df[k] -= rows[k] && FTXTrowtf(rows[k], NULL, len[k], next);
+		}
+		next = p + 1;
+		if (p >= pi.count || p < ocnt ||
+		    strNil(v = BUNtvar(&pi, p)))
+			continue;
+		BUN dl = FTXTcount(ta, &buf, &buflen, v, q, tf);
+		if (dl == BUN_NONE) {
+			bat_iterator_end(&pi);
+			return GDK_FAIL;
+		}
+		ndocs++;
+		total += dl;
+		for (int k = 0; k < q->n; k++)
+			df[k] += tf[k] > 0;
+	}
+	bat_iterator_end(&pi);
+	TIMEOUT_CHECK(qry_ctx, GOTO_LABEL_TIMEOUT_HANDLER(bailout, qry_ctx));
+	*ndocsp = ndocs;
+	*totalp = total;
+	return GDK_SUCCEED;
+
+  bailout:
+	return GDK_FAIL;
+}
+
+/* Return the BM25 score of the rows of b given by the oids in s (all
+ * rows if s is NULL) for the query.  The collection statistics (number
+ * of documents, document frequencies, average length) are those of the
+ * whole column that b is (a slice of), restricted to the rows in the
+ * candidate list live if given, so that the scores don't depend on
+ * which rows are scored: a filter or the partitioning of the column
+ * doesn't change them.  The full-text index of the column provides
+ * the statistics of the rows it covers, and the length and word counts
+ * of the rows that are scored; without it, the column is tokenized.
+ * Nil values get a nil score and are not part of the collection. */
+BAT *
+FTXTscore(BAT *b, BAT *s, BAT *live, const char *query)
+{
+	BAT *pb = b, *bn = NULL;
+	Heap *hp = NULL;
+	FTXTquery q;
+	allocator *ta = MT_thread_getallocator();
+	allocator_state ta_state = ma_open(ta);
+	char *buf = NULL;
+	size_t buflen = 0;
+	uint32_t *tf, **rows = NULL, **tfs = NULL;
+	BUN *df, *len, boff, ocnt = 0, n;
+	dbl *idf, avgdl = 1;
+	ulng ndocs = 0, total = 0;
+	const oid *sval = NULL;
+	struct canditer ci;
+	bool allnil = false;
+	BATiter bi, si;
+	QryCtx *qry_ctx = MT_thread_get_qry_ctx();
+	lng t0 = GDKusec();
+
+	if (ATOMstorage(b->ttype) != TYPE_str) {
+		GDKerror("Full-text search on non string bat\n");
+		goto bailout;
+	}
+	if (FTXTparse(ta, &q, query) != GDK_SUCCEED ||
+	    (tf = ma_alloc(ta, q.n * sizeof(uint32_t) + 1)) == NULL ||
+	    (df = ma_zalloc(ta, q.n * sizeof(BUN) + 1)) == NULL ||
+	    (len = ma_zalloc(ta, q.n * sizeof(BUN) + 1)) == NULL ||
+	    (idf = ma_alloc(ta, q.n * sizeof(dbl) + 1)) == NULL ||
+	    (rows = ma_zalloc(ta, q.n * sizeof(uint32_t *) + 1)) == NULL ||
+	    (tfs = ma_zalloc(ta, q.n * sizeof(uint32_t *) + 1)) == NULL)
+		goto bailout;
+	if (VIEWtparent(b)) {
+		pb = BATdescriptor(VIEWtparent(b));
+		if (pb == NULL)
+			goto bailout;
+	}
+	boff = b->tbaseoff - pb->tbaseoff;
+
+	if (!strNil(query) && q.n > 0) {
+		if ((hp = FTXTget(pb)) != NULL) {
+			ocnt = (BUN) ((const ulng *) hp->base)[1];
+			for (int k = 0; k < q.n; k++) {
+				const ulng *e = FTXTfind(hp, q.h[k]);
+				if (e == NULL)
+					continue;
+				len[k] = (BUN) e[2];
+				if ((rows[k] = ma_alloc(ta, len[k] * sizeof(uint32_t))) == NULL ||
+				    (tfs[k] = ma_alloc(ta, len[k] * sizeof(uint32_t))) == NULL)
+					goto bailout;
+				FTXTdecode(FTXTlists(hp) + e[1], len[k], rows[k], tfs[k]);
+			}
+			MT_thread_setalgorithm("full-text index", __func__);
+		}
+		if (FTXTcollection(pb, live, hp, &q, rows, len, ta,
+				   &ndocs, &total, df, qry_ctx) != GDK_SUCCEED)
+			goto bailout;
+		avgdl = FTXTstats(&q, ndocs, total, df, idf);
+	}
+
+	bi = bat_iterator(b);
+	si = bat_iterator(s);
+	if (s == NULL) {
+		canditer_init(&ci, b, NULL);
+		n = ci.ncand;
+	} else if (si.type == TYPE_void && is_oid_nil(si.tseq) && !complex_cand(s)) {
+		n = si.count;
+		allnil = true;
+	} else if (si.type == TYPE_oid && !(si.sorted && si.nonil)) {
+		/* not a candidate list: positions in any order, possibly
+		 * nil, as in algebra.projection */
+		n = si.count;
+		sval = (const oid *) si.base;
+	} else {
+		/* a candidate list, which may have exceptions */
+		canditer_init(&ci, NULL, s);
+		n = ci.ncand;
+	}
+	if ((bn = COLnew(s ? s->hseqbase : b->hseqbase, TYPE_dbl, n, TRANSIENT)) == NULL)
+		goto bailout1;
+	dbl *restrict r = Tloc(bn, 0);
+	bool nils = false;
+
+	TIMEOUT_LOOP_IDX_DECL(i, n, qry_ctx) {
+		oid o = allnil ? oid_nil : sval ? sval[i] : canditer_next(&ci);
+		const char *v;
+		BUN p = o - b->hseqbase, dl;
+
+		if (!is_oid_nil(o) && (o < b->hseqbase || p >= bi.count)) {
+			GDKerror("oid out of range\n");
+			goto bailout1;
+		}
+		if (is_oid_nil(o) || strNil(query) ||
+		    strNil(v = BUNtvar(&bi, p))) {
+			r[i] = dbl_nil;
+			nils = true;
+			continue;
+		}
+		if (boff + p < ocnt) {
+			/* look the row up in the lists */
+			dl = FTXTdoclen(hp)[boff + p];
+			for (int k = 0; k < q.n; k++)
+				tf[k] = rows[k] ? FTXTrowtf(rows[k], tfs[k], len[k], boff + p) : 0;
+		} else if ((dl = FTXTcount(ta, &buf, &buflen, v, &q, tf)) == BUN_NONE) {
+			goto bailout1;
+		}
+		r[i] = 0;
+		for (int k = 0; k < q.n; k++)
+			r[i] += FTXTbm25(idf[k], tf[k], dl, avgdl);
+	}
+	TIMEOUT_CHECK(qry_ctx, GOTO_LABEL_TIMEOUT_HANDLER(bailout1, qry_ctx));
+	bat_iterator_end(&bi);
+	bat_iterator_end(&si);
+	BATsetcount(bn, n);
+	bn->tnil = nils;
+	bn->tnonil = !nils;
+	bn->tsorted = bn->trevsorted = n <= 1;
+	bn->tkey = n <= 1;
+	TRC_DEBUG(ACCELERATOR, "FTXTscore(" ALGOBATFMT ",%s): " BUNFMT
+		  " rows scored in a collection of " ULLFMT "%s (" LLFMT " usec)\n",
+		  ALGOBATPAR(b), query, n, ndocs,
+		  hp ? " using full-text index" : "", GDKusec() - t0);
+	goto bailout;
+
+  bailout1:
+	bat_iterator_end(&bi);
+	bat_iterator_end(&si);
+	BBPreclaim(bn);
+	bn = NULL;
+  bailout:
+	if (hp)
+		HEAPdecref(hp, false);
+	if (pb != b)
+		BBPunfix(pb->batCacheid);
+	ma_close(&ta_state);
+	return bn;
+}
+
+/* whether the single value v contains all words of the query; nil if
+ * either is nil */
+gdk_return
+FTXTmatchvalue(bit *ret, const char *v, const char *query)
+{
+	FTXTquery q;
+	allocator *ta = MT_thread_getallocator();
+	allocator_state ta_state = ma_open(ta);
+	char *buf = NULL;
+	size_t buflen = 0;
+	uint32_t *tf;
+	gdk_return rc = GDK_FAIL;
+
+	if (strNil(v) || strNil(query)) {
+		*ret = bit_nil;
+		rc = GDK_SUCCEED;
+	} else if (FTXTparse(ta, &q, query) == GDK_SUCCEED &&
+		   (tf = ma_alloc(ta, q.n * sizeof(uint32_t) + 1)) != NULL &&
+		   FTXTcount(ta, &buf, &buflen, v, &q, tf) != BUN_NONE) {
+		*ret = q.n > 0;
+		for (int k = 0; k < q.n; k++)
+			*ret &= tf[k] > 0;
+		rc = GDK_SUCCEED;
+	}
+	ma_close(&ta_state);
+	return rc;
+}
+
+/* the BM25 score of the single value v for the query; there is no
+ * column, so v is the whole collection, as it is for FTXTscore of a
+ * BAT with just this value; nil if either is nil */
+gdk_return
+FTXTscorevalue(dbl *ret, const char *v, const char *query)
+{
+	FTXTquery q;
+	allocator *ta = MT_thread_getallocator();
+	allocator_state ta_state = ma_open(ta);
+	char *buf = NULL;
+	size_t buflen = 0;
+	uint32_t *tf;
+	BUN dl, *df;
+	dbl *idf;
+	gdk_return rc = GDK_FAIL;
+
+	if (strNil(v) || strNil(query)) {
+		*ret = dbl_nil;
+		rc = GDK_SUCCEED;
+	} else if (FTXTparse(ta, &q, query) == GDK_SUCCEED &&
+		   (tf = ma_alloc(ta, q.n * sizeof(uint32_t) + 1)) != NULL &&
+		   (df = ma_alloc(ta, q.n * sizeof(BUN) + 1)) != NULL &&
+		   (idf = ma_alloc(ta, q.n * sizeof(dbl) + 1)) != NULL &&
+		   (dl = FTXTcount(ta, &buf, &buflen, v, &q, tf)) != BUN_NONE) {
+		for (int k = 0; k < q.n; k++)
+			df[k] = tf[k] > 0;
+		dbl avgdl = FTXTstats(&q, 1, dl, df, idf);
+		*ret = 0;
+		for (int k = 0; k < q.n; k++)
+			*ret += FTXTbm25(idf[k], tf[k], dl, avgdl);
+		rc = GDK_SUCCEED;
+	}
+	ma_close(&ta_state);
+	return rc;
+}
+
+void
+FTXTfree(BAT *b)
+{
+	if (b) {
+		Heap *hp;
+
+		MT_lock_set(&b->batIdxLock);
+		if ((hp = b->tfulltext) != NULL && hp != (Heap *) 1) {
+			if (GDKinmemory(b->theap->farmid) || !hp->hasfile) {
+				b->tfulltext = NULL;
+			} else {
+				b->tfulltext = (Heap *) 1;
+			}
+			HEAPdecref(hp, false);
+		}
+		MT_lock_unset(&b->batIdxLock);
+	}
+}
+
+void
+FTXTdestroy(BAT *b)
+{
+	if (b && b->tfulltext) {
+		Heap *hp;
+
+		MT_lock_set(&b->batIdxLock);
+		hp = b->tfulltext;
+		b->tfulltext = NULL;
+		MT_lock_unset(&b->batIdxLock);
+		if (hp == (Heap *) 1 || (hp != NULL && hp->hasfile))
+			GDKunlink(BBPselectfarm(b->batRole, b->ttype, fulltextheap),
+				  BATDIR,
+				  BBP_physical(b->batCacheid),
+				  "tfulltext");
+		if (hp != NULL && hp != (Heap *) 1)
+			HEAPdecref(hp, false);
+	}
+}
@@ -740,6 +740,297 @@ BAThashsave(BAT *b, bool dosync)
 			      GOTO_LABEL_TIMEOUT_HANDLER(bailout, qry_ctx)); \
 	} while (0)
 
+/* Building the rest of a large hash table in parallel.  In the first
+ * phase the threads compute the bucket of each of the remaining
+ * values, each for a consecutive range of positions.  The bucket is
+ * kept in the link array of the position itself, which is not in use
+ * yet, and each thread counts how many of its values fall in the
+ * range of buckets of each thread.  In the second phase each thread
+ * scatters its positions into one array, grouped by range of buckets
+ * and in position order within a group.  In the third phase each
+ * thread inserts, in position order, the values of its own group.
+ * Since a chain never leaves its bucket, every chain is only touched
+ * by a single thread and the result is exactly the hash table the
+ * serial build produces. */
+
+/* minimum number of values per thread for the parallel build */
+#define PARHASH_MINSIZE	((BUN) 1 << 20)
+
+struct hash_task {
+	BATiter *bi;
+	const struct canditer *ci;
+	Hash *h;
+	uint32_t *order;	/* positions minus p0, grouped by bucket range */
+	BUN *counts;		/* values per bucket range, then offsets */
+	BUN p0;			/* first position to insert */
+	BUN lo, hi;		/* positions (phase 1 and 2) */
+	BUN start, end;		/* group in order (phase 3) */
+	BUN range;		/* number of buckets per thread */
+	bool offsets, hascand;
+	int phase;
+	BUN nheads, nunique;
+	QryCtx *qry_ctx;
+};
+
+/* during the parallel build, store the bucket of position p in its
+ * link; unlike HASHputlink, the value need not be smaller than p */
+static inline void
+parhashsetcode(Hash *h, BUN p, BUN c)
+{
+	switch (h->width) {
+	case BUN4:
+		((BUN4type *) h->Link)[p] = (BUN4type) c;
+		break;
+#ifdef BUN8
+	case BUN8:
+		((BUN8type *) h->Link)[p] = (BUN8type) c;
+		break;
+#endif
+	default:
+		MT_UNREACHABLE();
+	}
+}
+
+#define parhashcodes(TYPE)						\
+	do {								\
+		const TYPE *restrict v = (const TYPE *) BUNtloc(bi, 0);	\
+		TIMEOUT_LOOP_IDX_DECL(q, t->hi - t->lo, qry_ctx) {	\
+			BUN i = (oids ? oids[q + t->lo] : seq + q + t->lo) - hseq; \
+			c = hash_##TYPE(h, v + i);			\
+			parhashsetcode(h, q + t->lo, c);		\
+			t->counts[c / t->range]++;			\
+		}							\
+	} while (0)
+#define parhashlink(TYPE)						\
+	do {								\
+		const TYPE *restrict v = (const TYPE *) BUNtloc(bi, 0);	\
+		TIMEOUT_LOOP_IDX_DECL(q, t->end - t->start, qry_ctx) {	\
+			p = t->p0 + t->order[t->start + q];		\
+			c = HASHgetlink(h, p);				\
+			hget = HASHget(h, c);				\
+			t->nheads += hget == BUN_NONE;			\
+			if (!t->hascand) {				\
+				for (hb = hget;				\
+				     hb != BUN_NONE;			\
+				     hb = HASHgetlink(h, hb)) {		\
+					if (EQ##TYPE(v[p], v[hb]))	\
+						break;			\
+				}					\
+				t->nunique += hb == BUN_NONE;		\
+			}						\
+			HASHputlink(h, p, hget);			\
+			HASHput(h, c, p);				\
+		}							\
+	} while (0)
+
+static void
+hash_worker(void *arg)
+{
+	struct hash_task *t = arg;
+	BATiter *bi = t->bi;
+	Hash *h = t->h;
+	QryCtx *qry_ctx = t->qry_ctx;
+	unsigned int tpe = ATOMbasetype(bi->type);
+	BUN p, c, hget, hb;
+
+	if (t->phase == 1) {
+		const oid *oids = t->ci->tpe == cand_materialized ? t->ci->oids : NULL;
+		oid seq = t->ci->seq;
+		oid hseq = bi->b->hseqbase;
+
+		switch (tpe) {
+		case TYPE_bte:
+			parhashcodes(bte);
+			break;
+		case TYPE_sht:
+			parhashcodes(sht);
+			break;
+		case TYPE_int:
+			parhashcodes(int);
+			break;
+		case TYPE_flt:
+			parhashcodes(flt);
+			break;
+		case TYPE_dbl:
+			parhashcodes(dbl);
+			break;
+		case TYPE_lng:
+			parhashcodes(lng);
+			break;
+#ifdef HAVE_HGE
+		case TYPE_hge:
+			parhashcodes(hge);
+			break;
+#endif
+		case TYPE_uuid:
+			parhashcodes(uuid);
+			break;
+		case TYPE_inet4:
+			parhashcodes(inet4);
+			break;
+		case TYPE_inet6:
+			parhashcodes(inet6);
+			break;
+		default:
+			TIMEOUT_LOOP_IDX_DECL(q, t->hi - t->lo, qry_ctx) {
+				BUN i = (oids ? oids[q + t->lo] : seq + q + t->lo) - hseq;
+				if (t->offsets) {
+					var_t off = VarHeapVal(bi->base, i, bi->width);
+					c = hash_oid(h, &off);
+				} else {
+					c = hash_any(h, BUNtail(bi, i));
+				}
+				parhashsetcode(h, q + t->lo, c);
+				t->counts[c / t->range]++;
+			}
+			break;
+		}
+		return;
+	}
+
+	if (t->phase == 2) {
+		TIMEOUT_LOOP_IDX_DECL(q, t->hi - t->lo, qry_ctx) {
+			p = q + t->lo;
+			c = HASHgetlink(h, p);
+			t->order[t->counts[c / t->range]++] = (uint32_t) (p - t->p0);
+		}
+		return;
+	}
+
+	switch (tpe) {
+	case TYPE_bte:
+		parhashlink(bte);
+		break;
+	case TYPE_sht:
+		parhashlink(sht);
+		break;
+	case TYPE_int:
+		parhashlink(int);
+		break;
+	case TYPE_flt:
+		parhashlink(flt);
+		break;
+	case TYPE_dbl:
+		parhashlink(dbl);
+		break;
+	case TYPE_lng:
+		parhashlink(lng);
+		break;
+#ifdef HAVE_HGE
+	case TYPE_hge:
+		parhashlink(hge);
+		break;
+#endif
+	case TYPE_uuid:
+		parhashlink(uuid);
+		break;
+	case TYPE_inet4:
+		parhashlink(inet4);
+		break;
+	case TYPE_inet6:
+		parhashlink(inet6);
+		break;
+	default: {
+		bool (*atomeq)(const void *, const void *) = ATOMequal(tpe);
+		TIMEOUT_LOOP_IDX_DECL(q, t->end - t->start, qry_ctx) {
+			p = t->p0 + t->order[t->start + q];
+			c = HASHgetlink(h, p);
+			hget = HASHget(h, c);
+			t->nheads += hget == BUN_NONE;
+			if (!t->hascand) {
+				for (hb = hget;
+				     hb != BUN_NONE;
+				     hb = HASHgetlink(h, hb)) {
+					if (t->offsets
+					    ? VarHeapVal(bi->base, p, bi->width) == VarHeapVal(bi->base, hb, bi->width)
+					    : atomeq(BUNtail(bi, p), BUNtail(bi, hb)))
+						break;
+				}
+				t->nunique += hb == BUN_NONE;
+			}
+			HASHputlink(h, p, hget);
+			HASHput(h, c, p);
+		}
+		break;
+	}
+	}
+}
+
+/* insert positions p0 up to ci->ncand into the hash table using
+ * nthreads threads; the candidate iterator must support random
+ * access (dense or materialized), the buckets must fit in the links
+ * and the number of positions in 32 bits */
+static gdk_return
+hash_parallel(BATiter *bi, const struct canditer *ci, Hash *h, BUN p0,
+	      bool offsets, bool hascand, int nthreads, QryCtx *qry_ctx)
+{
+	BUN n = ci->ncand - p0;
+	BUN range = (h->nbucket + nthreads - 1) / nthreads;
+	uint32_t *order = GDKmalloc(n * sizeof(uint32_t));
+	allocator *ta = MT_thread_getallocator();
+	allocator_state ta_state = ma_open(ta);
+	struct hash_task *tasks = ma_zalloc(ta, nthreads * sizeof(*tasks));
+	BUN *counts = ma_zalloc(ta, nthreads * nthreads * sizeof(BUN));
+
+	if (order == NULL || tasks == NULL || counts == NULL) {
+		ma_close(&ta_state);
+		GDKfree(order);
+		return GDK_FAIL;
+	}
+	for (int i = 0; i < nthreads; i++) {
+		tasks[i] = (struct hash_task) {
+			.bi = bi,
+			.ci = ci,
+			.h = h,
+			.order = order,
+			.counts = counts + i * nthreads,
+			.p0 = p0,
+			.lo = p0 + n / nthreads * i,
+			.hi = i == nthreads - 1 ? ci->ncand : p0 + n / nthreads * (i + 1),
+			.range = range,
+			.offsets = offsets,
+			.hascand = hascand,
+			.phase = 1,
+			.qry_ctx = qry_ctx,
+		};
+	}
+	GDKparallel(hash_worker, tasks, sizeof(*tasks), nthreads, "hashXXXX");
+	/* on timeout, the caller checks qry_ctx itself */
+	TIMEOUT_CHECK(qry_ctx, goto bailout);
+
+	/* turn the counts into the offsets where each thread puts its
+	 * positions of each group, the groups in bucket order and
+	 * within a group the threads in position order */
+	BUN off = 0;
+	for (int r = 0; r < nthreads; r++) {
+		tasks[r].start = off;
+		for (int i = 0; i < nthreads; i++) {
+			BUN cnt = tasks[i].counts[r];
+			tasks[i].counts[r] = off;
+			off += cnt;
+		}
+		tasks[r].end = off;
+	}
+	assert(off == n);
+	for (int i = 0; i < nthreads; i++)
+		tasks[i].phase = 2;
+	GDKparallel(hash_worker, tasks, sizeof(*tasks), nthreads, "hashXXXX");
+	TIMEOUT_CHECK(qry_ctx, goto bailout);
+
+	for (int i = 0; i < nthreads; i++)
+		tasks[i].phase = 3;
+	GDKparallel(hash_worker, tasks, sizeof(*tasks), nthreads, "hashXXXX");
+	for (int i = 0; i < nthreads; i++) {
+		h->nheads += tasks[i].nheads;
+		h->nunique += tasks[i].nunique;
+	}
+
+  bailout:
+	ma_close(&ta_state);
+	GDKfree(order);
+	return GDK_SUCCEED;
+}
+
 /* Internal function to create a hash table for the given BAT b.
  * If a candidate list s is also given, the hash table is specific for
  * the combination of the two: only values from b that are referred to
@@ -981,6 +1272,20 @@ BAThash_impl(BATiter *restrict bi, struct canditer *restrict ci,
 	}
 
 	/* finish the hashtable with the current mask */
+	if (GDKnr_threads > 1 &&
+	    ci->ncand - p >= 2 * PARHASH_MINSIZE &&
+	    ci->ncand - p <= (BUN) UINT32_MAX &&
+	    HASHwidth(h->nbucket) <= h->width &&
+	    (ci->tpe == cand_dense || ci->tpe == cand_materialized)) {
+		int nthreads = (int) MIN((BUN) GDKnr_threads,
+					 (ci->ncand - p) / PARHASH_MINSIZE);
+		if (hash_parallel(bi, ci, h, p, offsets, hascand, nthreads,
+				  qry_ctx) != GDK_SUCCEED)
+			goto bailout;
+		TIMEOUT_CHECK(qry_ctx,
+			      GOTO_LABEL_TIMEOUT_HANDLER(bailout, qry_ctx));
+		goto finished;
+	}
 	switch (tpe) {
 	case TYPE_bte:
 		finishhash(bte);
@@ -1066,6 +1371,7 @@ BAThash_impl(BATiter *restrict bi, struct canditer *restrict ci,
 		break;
 	}
 	}
+  finished:
 	TRC_DEBUG_IF(ACCELERATOR) {
 		TRC_DEBUG_ENDIF(ACCELERATOR,
 				"hash construction " LLFMT " usec\n", GDKusec() - t0);
@@ -1644,6 +1644,310 @@ mergejoin_lng(BAT **r1p, BAT **r2p, BAT *l, BAT *r,
 	return GDK_FAIL;
 }
 
+/* Compare row i of the string BAT bi with the string v whose prefix
+ * (see PFXvalue) is vp.  If pfx is not NULL, it holds the prefixes of
+ * the rows of bi, so that the string itself only needs to be looked at
+ * if the prefixes are equal and the strings may still differ. */
+static inline int
+strpfxcmp(const BATiter *bi, const uint64_t *pfx, BUN i,
+	  uint64_t vp, const char *v)
+{
+	const char *s = NULL;
+	uint64_t p;
+
+	if (pfx) {
+		p = pfx[i];
+	} else {
+		s = BUNtvar(bi, i);
+		p = PFXvalue(s);
+	}
+	if (p != vp)
+		return p < vp ? -1 : 1;
+	if (p != 0 && (p & 0xFF) == 0) {
+		/* both strings are shorter than the prefix */
+		return 0;
+	}
+	if (s == NULL)
+		s = BUNtvar(bi, i);
+	if (p == 0) {
+		/* both are nil or the empty string; nil is smaller */
+		return (int) !strNil(s) - (int) !strNil(v);
+	}
+	return strcmp(s, v);
+}
+
+/* return the first position in [lo,hi) of the sorted string BAT bi
+ * where the value is >= v (last == false) or > v (last == true) */
+static BUN
+binsearch_strpfx(const BATiter *bi, const uint64_t *pfx, BUN lo, BUN hi,
+		 uint64_t vp, const char *v, bool last)
+{
+	while (lo < hi) {
+		BUN mid = lo + (hi - lo) / 2;
+		int c = strpfxcmp(bi, pfx, mid, vp, v);
+		if (c < 0 || (last && c == 0))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/* Implementation of mergejoin (see below) for the special case that
+ * the values are strings, at least one side has a prefix heap, and
+ * some more conditions are met.  Values are compared using their
+ * prefixes, and only when the prefixes are equal are the strings
+ * themselves consulted. */
+static gdk_return
+mergejoin_str(BAT **r1p, BAT **r2p, BAT *l, BAT *r,
+	      BATiter *li, BATiter *ri,
+	      const uint64_t *lpfx, const uint64_t *rpfx,
+	      bool nil_matches, BUN estimate, lng t0, bool swapped,
+	      const char *reason)
+{
+	BAT *r1, *r2;
+	BUN lstart, lend, lcnt;
+	BUN rstart, rend;
+	BUN lscan, rscan;	/* opportunistic scan window */
+	BUN maxsize;
+	uint64_t vp;
+	const char *v;
+	BUN nl, nr;
+	oid lv;
+	BUN i;
+
+	assert(ATOMtype(li->type) == ATOMtype(ri->type));
+	assert(ri->sorted || ri->revsorted);
+
+	MT_thread_setalgorithm(__func__, lpfx && rpfx ? "prefixes on both sides" : "prefixes on one side");
+	lstart = rstart = 0;
+	lend = BATcount(l);
+	lcnt = lend - lstart;
+	rend = BATcount(r);
+	size_t counter = 0;
+	QryCtx *qry_ctx = MT_thread_get_qry_ctx();
+
+	/* basic properties will be adjusted if necessary later on,
+	 * they were initially set by joininitresults() */
+
+	if (lend == 0 || rend == 0) {
+		/* there are no matches */
+		return nomatch(r1p, r2p, NULL, l, r,
+			       &(struct canditer) {.tpe = cand_dense, .ncand = lcnt,},
+			       0, false, false, __func__, t0);
+	}
+
+	if ((maxsize = joininitresults(r1p, r2p, NULL, BATcount(l), BATcount(r),
+				       li->key, ri->key, false, false,
+				       false, false, estimate)) == BUN_NONE) {
+		return GDK_FAIL;
+	}
+	r1 = *r1p;
+	r2 = r2p ? *r2p : NULL;
+
+	/* determine opportunistic scan window for l and r */
+	for (nl = lend - lstart, lscan = 4; nl > 0; lscan++)
+		nl >>= 1;
+	for (nr = rend - rstart, rscan = 4; nr > 0; rscan++)
+		nr >>= 1;
+
+	if (!nil_matches) {
+		/* skip over nils at the start of the columns: all
+		 * other values are larger than nil */
+		lstart = binsearch_strpfx(li, lpfx, lstart, lend, 0, str_nil, true);
+		rstart = binsearch_strpfx(ri, rpfx, rstart, rend, 0, str_nil, true);
+	}
+	/* from here on we don't have to worry about nil values */
+
+	while (lstart < lend && rstart < rend) {
+		GDK_CHECK_TIMEOUT(qry_ctx, counter,
+				GOTO_LABEL_TIMEOUT_HANDLER(bailout, qry_ctx));
+
+		v = BUNtvar(ri, rstart);
+		vp = rpfx ? rpfx[rstart] : PFXvalue(v);
+
+		if (lscan < lend - lstart &&
+		    strpfxcmp(li, lpfx, lstart + lscan, vp, v) < 0) {
+			lstart = binsearch_strpfx(li, lpfx, lstart + lscan,
+						  lend, vp, v, false);
+		} else {
+			/* scan l for v */
+			while (lstart < lend &&
+			       strpfxcmp(li, lpfx, lstart, vp, v) < 0)
+				lstart++;
+		}
+		if (lstart >= lend) {
+			/* nothing found */
+			break;
+		}
+
+		/* Here we determine the next value in l that we are
+		 * going to try to match in r, and the number of
+		 * times it occurs in l (see mergejoin_int). */
+		nl = 1;		/* we'll match (at least) one in l */
+		nr = 0;		/* maybe we won't match anything in r */
+		v = BUNtvar(li, lstart);
+		vp = lpfx ? lpfx[lstart] : PFXvalue(v);
+		if (li->key) {
+			/* if l is key, there is a single value */
+			lstart++;
+		} else if (lscan < lend - lstart &&
+			   strpfxcmp(li, lpfx, lstart + lscan, vp, v) == 0) {
+			/* lots of equal values: use binary search to
+			 * find end */
+			nl = binsearch_strpfx(li, lpfx, lstart + lscan,
+					      lend, vp, v, true);
+			nl -= lstart;
+			lstart += nl;
+		} else {
+			/* just scan */
+			while (++lstart < lend &&
+			       strpfxcmp(li, lpfx, lstart, vp, v) == 0)
+				nl++;
+		}
+		/* lstart points one beyond the value we're
+		 * going to match: ready for the next iteration. */
+
+		/* find the first value in r that is >= v, then the
+		 * first value in r that is > v; the difference is the
+		 * number of values equal to v */
+		if (rscan < rend - rstart &&
+		    strpfxcmp(ri, rpfx, rstart + rscan, vp, v) < 0) {
+			/* value too far away in r: use binary
+			 * search */
+			rstart = binsearch_strpfx(ri, rpfx, rstart + rscan,
+						  rend, vp, v, false);
+		} else {
+			/* scan r for v */
+			while (rstart < rend &&
+			       strpfxcmp(ri, rpfx, rstart, vp, v) < 0)
+				rstart++;
+		}
+		if (rstart == rend) {
+			/* nothing found */
+			break;
+		}
+
+		/* now find the end of the sequence of equal values v */
+		if (ri->key) {
+			if (strpfxcmp(ri, rpfx, rstart, vp, v) == 0) {
+				nr = 1;
+				rstart++;
+			}
+		} else if (rscan < rend - rstart &&
+			   strpfxcmp(ri, rpfx, rstart + rscan, vp, v) == 0) {
+			/* range too large: use binary search */
+			nr = binsearch_strpfx(ri, rpfx, rstart + rscan,
+					      rend, vp, v, true);
+			nr -= rstart;
+			rstart += nr;
+		} else {
+			/* scan r for end of range */
+			while (rstart < rend &&
+			       strpfxcmp(ri, rpfx, rstart, vp, v) == 0) {
+				nr++;
+				rstart++;
+			}
+		}
+		/* rstart points to first value > v or end of
+		 * r, and nr is the number of values in r that
+		 * are equal to v */
+		if (nr == 0) {
+			/* no entries in r found */
+			continue;
+		}
+		/* make space: nl values in l match nr values in r, so
+		 * we need to add nl * nr values in the results */
+		if (maybeextend(r1, r2, NULL, nl * nr, lstart, lend, maxsize) != GDK_SUCCEED)
+			goto bailout;
+
+		/* maintain properties (see mergejoin_int) */
+		if (nl > 1) {
+			if (r2) {
+				r2->tkey = false;
+				r2->tseqbase = oid_nil;
+			}
+			r1->trevsorted = false;
+		}
+		if (nr > 1) {
+			r1->tkey = false;
+			r1->tseqbase = oid_nil;
+			if (r2) {
+				r2->trevsorted = false;
+				if (nl > 1)
+					r2->tsorted = false;
+			}
+		}
+		if (BATcount(r1) > 0) {
+			r1->trevsorted = false;
+			if (r2)
+				r2->trevsorted = false;
+			if (BATtdense(r1) &&
+			    ((oid *) r1->theap->base)[r1->batCount - 1] + 1 != l->hseqbase + lstart - nl) {
+				r1->tseqbase = oid_nil;
+			}
+		}
+
+		if (r2 &&
+		    BATcount(r2) > 0 &&
+		    BATtdense(r2) &&
+		    ((oid *) r2->theap->base)[r2->batCount - 1] + 1 != r->hseqbase + rstart - nr) {
+			r2->tseqbase = oid_nil;
+		}
+
+		/* insert values */
+		lv = l->hseqbase + lstart - nl;
+		for (i = 0; i < nl; i++) {
+			BUN j;
+
+			for (j = 0; j < nr; j++) {
+				APPEND(r1, lv);
+			}
+			if (r2) {
+				oid rv = r->hseqbase + rstart - nr;
+
+				for (j = 0; j < nr; j++) {
+					APPEND(r2, rv);
+					rv++;
+				}
+			}
+			lv++;
+		}
+	}
+	/* also set other bits of heap to correct value to indicate size */
+	BATsetcount(r1, BATcount(r1));
+	if (r2) {
+		BATsetcount(r2, BATcount(r2));
+		assert(BATcount(r1) == BATcount(r2));
+	}
+	if (BATcount(r1) > 0) {
+		if (BATtdense(r1))
+			r1->tseqbase = ((oid *) r1->theap->base)[0];
+		if (r2 && BATtdense(r2))
+			r2->tseqbase = ((oid *) r2->theap->base)[0];
+	} else {
+		r1->tseqbase = 0;
+		if (r2) {
+			r2->tseqbase = 0;
+		}
+	}
+	TRC_DEBUG(ALGO, "l=" ALGOBATFMT "," "r=" ALGOBATFMT ","
+		  "nil_matches=%s;%s %s "
+		  "-> " ALGOBATFMT "," ALGOOPTBATFMT " (" LLFMT "usec)\n",
+		  ALGOBATPAR(l), ALGOBATPAR(r),
+		  nil_matches ? "true" : "false",
+		  swapped ? " swapped" : "", reason,
+		  ALGOBATPAR(r1), ALGOOPTBATPAR(r2),
+		  GDKusec() - t0);
+
+	return GDK_SUCCEED;
+
+  bailout:
+	BBPreclaim(r1);
+	BBPreclaim(r2);
+	return GDK_FAIL;
+}
+
 /* Implementation of mergejoin (see below) for the special case that
  * the values are of type oid, and the right-hand side is a candidate
  * list with exception, and some more conditions are met. */
@@ -1991,6 +2295,29 @@ mergejoin(BAT **r1p, BAT **r2p, BAT **r3p, BAT *l, BAT *r,
 		case TYPE_lng:
 			return mergejoin_lng(r1p, r2p, l, r, nil_matches,
 					     estimate, t0, swapped, __func__);
+		case TYPE_str:
+			if (BATatoms[l->ttype].atomCmp == BATatoms[TYPE_str].atomCmp) {
+				BATiter li = bat_iterator(l);
+				BATiter ri = bat_iterator(r);
+				Heap *lh, *rh;
+				const uint64_t *lpfx = PFXget(&li, &lh);
+				const uint64_t *rpfx = PFXget(&ri, &rh);
+				gdk_return rc = GDK_SUCCEED;
+				if (lpfx || rpfx)
+					rc = mergejoin_str(r1p, r2p, l, r, &li, &ri,
+							   lpfx, rpfx, nil_matches,
+							   estimate, t0, swapped,
+							   __func__);
+				if (lh)
+					HEAPdecref(lh, false);
+				if (rh)
+					HEAPdecref(rh, false);
+				bat_iterator_end(&li);
+				bat_iterator_end(&ri);
+				if (lpfx || rpfx)
+					return rc;
+			}
+			break;
 		}
 	}
 
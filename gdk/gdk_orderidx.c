@@ -129,9 +129,10 @@ BATcheckorderidx(BAT *b)
 	return ret;
 }
 
-/* create the heap for an order index; returns NULL on failure */
-Heap *
-createOIDXheap(BAT *b, bool stable)
+/* create the heap for an order index on the first cnt rows of b;
+ * returns NULL on failure */
+static Heap *
+newOIDXheap(BAT *b, BUN cnt, bool stable)
 {
 	Heap *m;
 	oid *restrict mv;
@@ -147,19 +148,26 @@ createOIDXheap(BAT *b, bool stable)
 	strtconcat(m->filename, sizeof(m->filename),
 		   BBP_physical(b->batCacheid), ".torderidx", NULL);
 	if (m->farmid < 0 ||
-	    HEAPalloc(m, BATcount(b) + ORDERIDXOFF, SIZEOF_OID) != GDK_SUCCEED) {
+	    HEAPalloc(m, cnt + ORDERIDXOFF, SIZEOF_OID) != GDK_SUCCEED) {
 		GDKfree(m);
 		return NULL;
 	}
-	m->free = (BATcount(b) + ORDERIDXOFF) * SIZEOF_OID;
+	m->free = (cnt + ORDERIDXOFF) * SIZEOF_OID;
 
 	mv = (oid *) m->base;
 	*mv++ = ORDERIDX_VERSION;
-	*mv++ = (oid) BATcount(b);
+	*mv++ = (oid) cnt;
 	*mv++ = (oid) stable;
 	return m;
 }
 
+/* create the heap for an order index; returns NULL on failure */
+Heap *
+createOIDXheap(BAT *b, bool stable)
+{
+	return newOIDXheap(b, BATcount(b), stable);
+}
+
 /* maybe persist the order index heap */
 void
 persistOIDX(BAT *b)
@@ -511,6 +519,327 @@ GDKmergeidx(BAT *b, BAT**a, int n_ar)
 	return GDK_SUCCEED;
 }
 
+/* Maintenance of the order index when values are appended.
+ *
+ * Before values are appended to a BAT with an order index, the index
+ * is moved aside (OIDXdetach) so that it isn't used for rows it
+ * doesn't cover.  After the append, a background thread (OIDXappend)
+ * sorts the appended rows into a run of their own and merges that
+ * with the old index.  If the BAT grew again in the mean time, the
+ * result becomes the new pending index and the thread repeats the
+ * exercise for the new rows.  Any other kind of update destroys the
+ * pending index, which the thread notices before it installs its
+ * result. */
+
+/* merge the sorted runs p0..q0 and p1..q1 into mv; on equal values
+ * the first run goes first, so if the runs are stable and the rows
+ * of the second run come after those of the first, so is the
+ * result */
+#define RUN_MERGE(TYPE)							\
+	do {								\
+		const TYPE *v = (const TYPE *) bi->base;		\
+		while (p0 < q0 && p1 < q1) {				\
+			if (v[*p1 - hseq] < v[*p0 - hseq])		\
+				*mv++ = *p1++;				\
+			else						\
+				*mv++ = *p0++;				\
+		}							\
+	} while (0)
+
+static void
+OIDXmergeruns(BATiter *bi, oid hseq,
+	      const oid *p0, const oid *q0, const oid *p1, const oid *q1,
+	      oid *restrict mv)
+{
+	switch (ATOMbasetype(bi->type)) {
+	case TYPE_bte: RUN_MERGE(bte); break;
+	case TYPE_sht: RUN_MERGE(sht); break;
+	case TYPE_int: RUN_MERGE(int); break;
+	case TYPE_lng: RUN_MERGE(lng); break;
+#ifdef HAVE_HGE
+	case TYPE_hge: RUN_MERGE(hge); break;
+#endif
+	default: {
+		/* this includes flt and dbl, where nil (NaN) doesn't
+		 * compare with < */
+		int (*cmp)(const void *, const void *) = ATOMcompare(bi->type);
+		while (p0 < q0 && p1 < q1) {
+			if (cmp(BUNtail(bi, *p1 - hseq), BUNtail(bi, *p0 - hseq)) < 0)
+				*mv++ = *p1++;
+			else
+				*mv++ = *p0++;
+		}
+		break;
+	}
+	}
+	while (p0 < q0)
+		*mv++ = *p0++;
+	while (p1 < q1)
+		*mv++ = *p1++;
+}
+
+/* sort rows ocnt and up of bi and merge them with the ocnt entries of
+ * the order index ords; returns a GDKmalloced array of bi->count oids,
+ * or NULL on failure */
+static oid *
+OIDXextend(BAT *b, BATiter *bi, const oid *ords, BUN ocnt, bool stable)
+{
+	BAT *v, *on = NULL;
+	oid *mv, *run = NULL;
+	const oid *p1;
+	BUN n = bi->count - ocnt;
+
+	if ((v = BATslice(b, ocnt, bi->count)) == NULL)
+		return NULL;
+	if (BATsort(NULL, &on, NULL, v, NULL, NULL, false, false, stable) != GDK_SUCCEED) {
+		BBPunfix(v->batCacheid);
+		return NULL;
+	}
+	BBPunfix(v->batCacheid);
+	if ((mv = GDKmalloc(bi->count * sizeof(oid))) == NULL) {
+		BBPunfix(on->batCacheid);
+		return NULL;
+	}
+	if (BATtdense(on)) {
+		/* the appended rows were already sorted */
+		if ((run = GDKmalloc(n * sizeof(oid))) == NULL) {
+			BBPunfix(on->batCacheid);
+			GDKfree(mv);
+			return NULL;
+		}
+		for (BUN i = 0; i < n; i++)
+			run[i] = b->hseqbase + ocnt + i;
+		p1 = run;
+	} else {
+		p1 = (const oid *) Tloc(on, 0);
+	}
+	OIDXmergeruns(bi, b->hseqbase, ords, ords + ocnt, p1, p1 + n, mv);
+	GDKfree(run);
+	BBPunfix(on->batCacheid);
+	return mv;
+}
+
+static void
+OIDXmergeappends(void *arg)
+{
+	BAT *b = arg;
+	Heap *hp, *m;
+	lng t0 = GDKusec();
+	BUN ocnt0 = BUN_NONE;
+
+	MT_thread_setalgorithm("merge appends into order index", __func__);
+	for (;;) {
+		MT_lock_set(&b->batIdxLock);
+		if ((hp = b->torderidxpend) == NULL || GDKexiting()) {
+			MT_lock_unset(&b->batIdxLock);
+			break;
+		}
+		HEAPincref(hp);
+		MT_lock_unset(&b->batIdxLock);
+
+		BATiter bi = bat_iterator(b);
+		BUN ocnt = (BUN) ((const oid *) hp->base)[1];
+		bool stable = ((const oid *) hp->base)[2] != 0;
+		oid *mv = NULL;
+		if (ocnt0 == BUN_NONE)
+			ocnt0 = ocnt;
+		if (bi.count >= ocnt)
+			mv = OIDXextend(b, &bi, (const oid *) hp->base + ORDERIDXOFF,
+					ocnt, stable);
+
+		MT_lock_set(&b->batIdxLock);
+		if (b->torderidxpend != hp) {
+			/* the BAT was updated, the index is gone */
+			MT_lock_unset(&b->batIdxLock);
+			bat_iterator_end(&bi);
+			HEAPdecref(hp, false);
+			GDKfree(mv);
+			break;
+		}
+		b->torderidxpend = NULL;
+		HEAPdecref(hp, true);	/* the BAT's reference */
+		HEAPdecref(hp, true);	/* and ours */
+		if (mv == NULL ||
+		    (m = newOIDXheap(b, bi.count, stable)) == NULL) {
+			MT_lock_unset(&b->batIdxLock);
+			bat_iterator_end(&bi);
+			GDKfree(mv);
+			GDKclrerr();
+			TRC_DEBUG(ACCELERATOR, "OIDXmergeappends(" ALGOBATFMT "): dropped order index\n", ALGOBATPAR(b));
+			break;
+		}
+		memcpy((oid *) m->base + ORDERIDXOFF, mv, bi.count * sizeof(oid));
+		GDKfree(mv);
+		MT_lock_set(&b->theaplock);
+		BUN cnt = BATcount(b);
+		MT_lock_unset(&b->theaplock);
+		if (b->torderidx != NULL || cnt < bi.count) {
+			/* someone else was quicker, or the BAT shrunk */
+			MT_lock_unset(&b->batIdxLock);
+			bat_iterator_end(&bi);
+			HEAPfree(m, true);
+			GDKfree(m);
+			break;
+		}
+		if (cnt > bi.count) {
+			/* more appends, go round again */
+			b->torderidxpend = m;
+			MT_lock_unset(&b->batIdxLock);
+			bat_iterator_end(&bi);
+			continue;
+		}
+		b->torderidx = m;
+		persistOIDX(b);
+		MT_lock_unset(&b->batIdxLock);
+		TRC_DEBUG(ACCELERATOR, "OIDXmergeappends(" ALGOBATFMT "): merged " BUNFMT " appended rows into order index (" LLFMT " usec)\n", ALGOBATPAR(b), bi.count - ocnt0, GDKusec() - t0);
+		bat_iterator_end(&bi);
+		break;
+	}
+	BBPunfix(b->batCacheid);
+}
+
+/* values are about to be appended to b: move its order index out of
+ * the way; returns true if the caller needs to call OIDXappend after
+ * the append */
+bool
+OIDXdetach(BAT *b)
+{
+	Heap *hp, *old;
+
+	if (b->torderidx == NULL || !BATcheckorderidx(b))
+		return false;
+	MT_lock_set(&b->batIdxLock);
+	if ((hp = b->torderidx) == NULL) {
+		MT_lock_unset(&b->batIdxLock);
+		return false;
+	}
+	b->torderidx = NULL;
+	old = b->torderidxpend;
+	b->torderidxpend = hp;
+	MT_lock_unset(&b->batIdxLock);
+	if (old)
+		HEAPdecref(old, true);
+	return true;
+}
+
+/* The merges are done by a single background thread, which takes the
+ * BATs from a queue in the order in which they were appended to.  A
+ * BAT is in the queue at most once: a merge covers all rows appended
+ * by the time it starts, and it repeats itself for later ones. */
+static MT_Lock oidxmergelock = MT_LOCK_INITIALIZER(oidxmergelock);
+static MT_Cond oidxmergecond = MT_COND_INITIALIZER(oidxmergecond);
+static BAT **oidxmergequeue;
+static BAT *oidxmergecur;	/* the BAT being merged */
+static int oidxmergelen, oidxmergesize;
+static bool oidxmergerunning;
+
+static void
+OIDXmerger(void *arg)
+{
+	(void) arg;
+	MT_lock_set(&oidxmergelock);
+	while (!GDKexiting()) {
+		if (oidxmergelen == 0) {
+			/* wake up once in a while to check for exit */
+			MT_cond_timedwait(&oidxmergecond, &oidxmergelock, 1000);
+			continue;
+		}
+		BAT *b = oidxmergequeue[0];
+		oidxmergelen--;
+		memmove(oidxmergequeue, oidxmergequeue + 1,
+			oidxmergelen * sizeof(BAT *));
+		oidxmergecur = b;
+		MT_lock_unset(&oidxmergelock);
+		OIDXmergeappends(b);
+		MT_lock_set(&oidxmergelock);
+		oidxmergecur = NULL;
+		MT_cond_broadcast(&oidxmergecond);
+	}
+	while (oidxmergelen > 0) {
+		BAT *b = oidxmergequeue[--oidxmergelen];
+		OIDXdestroy(b);
+		BBPunfix(b->batCacheid);
+	}
+	oidxmergerunning = false;
+	MT_lock_unset(&oidxmergelock);
+}
+
+/* bring the order index moved aside by OIDXdetach up to date in the
+ * background */
+void
+OIDXappend(BAT *b)
+{
+	MT_lock_set(&oidxmergelock);
+	for (int i = 0; i < oidxmergelen; i++) {
+		if (oidxmergequeue[i] == b) {
+			/* the queued merge will include these rows */
+			MT_lock_unset(&oidxmergelock);
+			return;
+		}
+	}
+	if (oidxmergelen == oidxmergesize) {
+		int size = oidxmergesize == 0 ? 16 : 2 * oidxmergesize;
+		BAT **queue = GDKrealloc(oidxmergequeue, size * sizeof(BAT *));
+		if (queue == NULL) {
+			MT_lock_unset(&oidxmergelock);
+			GDKclrerr();
+			OIDXdestroy(b);
+			return;
+		}
+		oidxmergequeue = queue;
+		oidxmergesize = size;
+	}
+	if (!oidxmergerunning) {
+		MT_Id tid;
+		if (MT_create_thread(&tid, OIDXmerger, NULL,
+				     MT_THR_DETACHED, "oidxmerge") < 0) {
+			MT_lock_unset(&oidxmergelock);
+			GDKclrerr();
+			OIDXdestroy(b);
+			return;
+		}
+		oidxmergerunning = true;
+	}
+	BBPfix(b->batCacheid);
+	oidxmergequeue[oidxmergelen++] = b;
+	MT_cond_broadcast(&oidxmergecond);
+	MT_lock_unset(&oidxmergelock);
+}
+
+/* called by GDKreset once the merger has exited: drop whatever is
+ * still queued, and the queue itself */
+void
+OIDXreset(void)
+{
+	MT_lock_set(&oidxmergelock);
+	while (oidxmergelen > 0) {
+		BAT *b = oidxmergequeue[--oidxmergelen];
+		OIDXdestroy(b);
+		BBPunfix(b->batCacheid);
+	}
+	GDKfree(oidxmergequeue);
+	oidxmergequeue = NULL;
+	oidxmergesize = 0;
+	oidxmergerunning = false;
+	MT_lock_unset(&oidxmergelock);
+}
+
+/* wait until the appends to b have been merged into its order index */
+void
+OIDXwait(BAT *b)
+{
+	MT_lock_set(&oidxmergelock);
+	while (!GDKexiting()) {
+		bool busy = oidxmergecur == b;
+		for (int i = 0; !busy && i < oidxmergelen; i++)
+			busy = oidxmergequeue[i] == b;
+		if (!busy)
+			break;
+		MT_cond_timedwait(&oidxmergecond, &oidxmergelock, 1000);
+	}
+	MT_lock_unset(&oidxmergelock);
+}
+
 void
 OIDXfree(BAT *b)
 {
@@ -527,6 +856,10 @@ OIDXfree(BAT *b)
 				HEAPdecref(hp, false);
 			}
 		}
+		if ((hp = b->torderidxpend) != NULL) {
+			b->torderidxpend = NULL;
+			HEAPdecref(hp, true);
+		}
 		MT_lock_unset(&b->batIdxLock);
 	}
 }
@@ -534,13 +867,17 @@ OIDXfree(BAT *b)
 void
 OIDXdestroy(BAT *b)
 {
-	if (b && b->torderidx) {
-		Heap *hp;
+	if (b && (b->torderidx || b->torderidxpend)) {
+		Heap *hp, *pend;
 
 		MT_lock_set(&b->batIdxLock);
 		hp = b->torderidx;
 		b->torderidx = NULL;
+		pend = b->torderidxpend;
+		b->torderidxpend = NULL;
 		MT_lock_unset(&b->batIdxLock);
+		if (pend)
+			HEAPdecref(pend, true);
 		if (hp == (Heap *) 1) {
 			GDKunlink(BBPselectfarm(b->batRole, b->ttype, orderidxheap),
 				  BATDIR,
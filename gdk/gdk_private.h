@@ -26,6 +26,9 @@ enum heaptype {
 	hashheap,
 	orderidxheap,
 	strimpheap,
+	trigramheap,
+	fulltextheap,
+	prefixheap,
 	dataheap
 };
 
@@ -80,6 +83,9 @@ gdk_return BATsave_iter(BAT *bd, BATiter *bi, BUN size)
 	__attribute__((__visibility__("hidden")));
 void BATsetdims(BAT *b, uint16_t width)
 	__attribute__((__visibility__("hidden")));
+gdk_return BATstrprefix(BAT *b)
+	__attribute__((__warn_unused_result__))
+	__attribute__((__visibility__("hidden")));
 void BBPcacheit(BAT *bn, bool lock)
 	__attribute__((__visibility__("hidden")));
 gdk_return BBPchkfarms(void)
@@ -153,6 +159,8 @@ gdk_return GDKmove(int farmid, const char *dir1, const char *nme1, const char *e
 	__attribute__((__visibility__("hidden")));
 void *GDKmremap(const char *path, int mode, void *old_address, size_t old_size, size_t *new_size)
 	__attribute__((__visibility__("hidden")));
+void GDKparallel(void (*func)(void *), void *args, size_t argsize, int n, const char *name)
+	__attribute__((__visibility__("hidden")));
 gdk_return GDKremovedir(int farmid, const char *nme)
 	__attribute__((__warn_unused_result__))
 	__attribute__((__visibility__("hidden")));
@@ -224,6 +232,10 @@ void STRMPdecref(Strimps *strimps, bool remove)
 	__attribute__((__visibility__("hidden")));
 void STRMPfree(BAT *b)
 	__attribute__((__visibility__("hidden")));
+void TRGMfree(BAT *b)
+	__attribute__((__visibility__("hidden")));
+void FTXTfree(BAT *b)
+	__attribute__((__visibility__("hidden")));
 void MT_init_posix(void)
 	__attribute__((__visibility__("hidden")));
 void *MT_mmap(const char *path, int mode, size_t len)
@@ -234,14 +246,45 @@ int MT_msync(void *p, size_t len)
 	__attribute__((__visibility__("hidden")));
 int MT_munmap(void *p, size_t len)
 	__attribute__((__visibility__("hidden")));
+void OIDXappend(BAT *b)
+	__attribute__((__visibility__("hidden")));
+bool OIDXdetach(BAT *b)
+	__attribute__((__visibility__("hidden")));
 void OIDXfree(BAT *b)
 	__attribute__((__visibility__("hidden")));
+void OIDXreset(void)
+	__attribute__((__visibility__("hidden")));
 #ifdef GDKLIBRARY_USTR
 var_t oldstrnilLocate(Heap *h)
 	__attribute__((__visibility__("hidden")));
 #endif
 void persistOIDX(BAT *b)
 	__attribute__((__visibility__("hidden")));
+const uint64_t *PFXacquire(const BATiter *bi, Heap **hp)
+	__attribute__((__visibility__("hidden")));
+void PFXappend(BAT *b, BUN oldcount)
+	__attribute__((__visibility__("hidden")));
+void PFXdestroy(BAT *b)
+	__attribute__((__visibility__("hidden")));
+const uint64_t *PFXget(const BATiter *bi, Heap **hp)
+	__attribute__((__visibility__("hidden")));
+/* the first 8 bytes of a string as a big-endian unsigned integer, so
+ * that comparing prefixes orders the strings like strcmp; nil is 0 */
+__attribute__((__pure__))
+static inline uint64_t
+PFXvalue(const char *s)
+{
+	uint64_t v = 0;
+
+	if (strNil(s))
+		return 0;
+	for (int i = 0; i < 8; i++) {
+		v <<= 8;
+		if (*s)
+			v |= (uint8_t) *s++;
+	}
+	return v;
+}
 void PROPdestroy(BAT *b)
 	__attribute__((__visibility__("hidden")));
 void PROPdestroy_nolock(BAT *b)
@@ -464,6 +507,9 @@ extern dbl no_hash_select_fraction __attribute__((__visibility__("hidden")));
  * rather than maintaining it in HASHdelete */
 #define HASH_DESTROY_CHAIN_LENGTH		1000
 extern BUN hash_destroy_chain_length __attribute__((__visibility__("hidden")));
+/* string BATs of at least this many rows get a prefix heap when they
+ * are used in a range select or merge join; 0 means never */
+extern BUN strprefix_minsize __attribute__((__visibility__("hidden")));
 
 extern void (*GDKtriggerusr1)(void);
 
@@ -15,51 +15,24 @@
 #define RADIX 8			/* one char at a time */
 #define NBUCKETS (1 << RADIX)
 
-/* bigendian means value is in big-endian byte order, but also that it
+/* Sort the n values of hs bytes in h1 (and the payload of ts bytes in
+ * t1 along with it) using h2 and t2 as scratch space of the same size.
+ * The result ends up in h1 and t1.  counts must be zeroed and have hs
+ * rows.
+ * bigendian means value is in big-endian byte order, but also that it
  * is unsigned */
-gdk_return
-GDKrsort(void *restrict h, void *restrict t, size_t n, size_t hs, size_t ts, bool reverse, bool bigendian)
+static void
+rsort_range(uint8_t *restrict h1, uint8_t *restrict t1,
+	    uint8_t *restrict h2, uint8_t *restrict t2,
+	    size_t n, size_t hs, size_t ts, bool reverse, bool bigendian,
+	    size_t (*counts)[NBUCKETS])
 {
-	allocator *ta = MT_thread_getallocator();
-	allocator_state ta_state = ma_open(ta);
-	size_t (*counts)[NBUCKETS] = ma_zalloc(ta, hs * sizeof(counts[0]));
+	uint8_t *const h = h1;
+	uint8_t *const t = t1;
 	size_t pos[NBUCKETS];
-	uint8_t *h1 = h;
-	uint8_t *h2;
-	uint8_t *t1 = NULL;
-	uint8_t *t2 = NULL;
-	Heap tmph, tmpt;
-
-	if (counts == NULL) {
-		ma_close(&ta_state);
-		return GDK_FAIL;
-	}
-
-	tmph = tmpt = (Heap) {
-		.farmid = 1,
-	};
-
-	snprintf(tmph.filename, sizeof(tmph.filename), "%s%crsort%zuh",
-		 TEMPDIR_NAME, DIR_SEP, (size_t) MT_getpid());
-	if (HEAPalloc(&tmph, n, hs) != GDK_SUCCEED) {
-		ma_close(&ta_state);
-		return GDK_FAIL;
-	}
-	h2 = (uint8_t *) tmph.base;
 
-	if (t) {
-		snprintf(tmpt.filename, sizeof(tmpt.filename), "%s%crsort%zut",
-			 TEMPDIR_NAME, DIR_SEP, (size_t) MT_getpid());
-		if (HEAPalloc(&tmpt, n, ts) != GDK_SUCCEED) {
-			ma_close(&ta_state);
-			HEAPfree(&tmph, true);
-			return GDK_FAIL;
-		}
-		t1 = t;
-		t2 = (uint8_t *) tmpt.base;
-	} else {
+	if (t == NULL)
 		ts = 0;
-	}
 
 #ifndef WORDS_BIGENDIAN
 	if (bigendian /* treat like big-endian */) {
@@ -128,16 +101,15 @@ GDKrsort(void *restrict h, void *restrict t, size_t n, size_t hs, size_t ts, boo
 				memcpy(h2 + hs * pos[v]++, h1 + ho, hs);
 			}
 #endif
-		uint8_t *t = h1;
+		uint8_t *tmp = h1;
 		h1 = h2;
-		h2 = t;
-		t = t1;
+		h2 = tmp;
+		tmp = t1;
 		t1 = t2;
-		t2 = t;
+		t2 = tmp;
 	}
-	ma_close(&ta_state);
 
-	if (h1 != (uint8_t *) h) {
+	if (h1 != h) {
 		/* we need to copy the data back to the correct heap */
 		if (bigendian) {
 			/* no negative values in bigendian, so no shuffling */
@@ -168,8 +140,265 @@ GDKrsort(void *restrict h, void *restrict t, size_t n, size_t hs, size_t ts, boo
 			memcpy(t, t2, n * ts);
 		}
 	} /* else, everything is already in the correct place */
+}
+
+/* Parallel radix sort.  The input is cut into one chunk per thread.
+ * In the first phase each thread counts the byte values of its chunk.
+ * The most significant byte in which the values differ is then used
+ * to partition the data: in the second phase each thread scatters its
+ * chunk to the partitions, keeping the order within a partition
+ * stable.  In the third phase the threads sort the partitions
+ * independently (each partition with the serial radix sort) and copy
+ * them back; since the partitions are already in their final order,
+ * no merge is needed. */
+
+/* minimum number of values per thread for the parallel sort */
+#define PARSORT_MINSIZE	((size_t) 1 << 20)
+
+struct rsort_shared {
+	uint8_t *h, *t;		/* data and payload */
+	uint8_t *h2, *t2;	/* scratch space */
+	size_t n, hs, ts;
+	bool reverse, bigendian;
+	size_t byte;		/* memory offset of the partition byte */
+	size_t bstart[NBUCKETS + 1]; /* partitions, in output order */
+	ATOMIC_TYPE nextbucket;
+	ATOMIC_TYPE failed;
+};
+
+struct rsort_task {
+	struct rsort_shared *sh;
+	int phase;
+	size_t lo, hi;		/* the chunk of this thread */
+	size_t (*counts)[NBUCKETS];
+	size_t pos[NBUCKETS];	/* scatter positions of the chunk */
+};
+
+static void
+rsort_worker(void *arg)
+{
+	struct rsort_task *task = arg;
+	struct rsort_shared *sh = task->sh;
+	const size_t hs = sh->hs, ts = sh->ts;
+
+	switch (task->phase) {
+	case 1:
+		/* count the byte values of the chunk; note that rsort_range
+		 * counts in the same order, by significance */
+		for (size_t i = task->lo; i < task->hi; i++) {
+			const uint8_t *v = sh->h + i * hs;
+#ifndef WORDS_BIGENDIAN
+			if (!sh->bigendian) {
+				for (size_t j = 0; j < hs; j++)
+					task->counts[j][v[j]]++;
+			} else
+#endif
+				for (size_t j = 0, k = hs - 1; j < hs; j++, k--)
+					task->counts[j][v[k]]++;
+		}
+		break;
+	case 2:
+		/* scatter the chunk to the partitions */
+		for (size_t i = task->lo; i < task->hi; i++) {
+			size_t p = task->pos[sh->h[i * hs + sh->byte]]++;
+			if (sh->t)
+				memcpy(sh->t2 + p * ts, sh->t + i * ts, ts);
+			memcpy(sh->h2 + p * hs, sh->h + i * hs, hs);
+		}
+		break;
+	case 3: {
+		/* sort whole partitions and copy them back */
+		allocator *ta = MT_thread_getallocator();
+		allocator_state ta_state = ma_open(ta);
+		size_t (*counts)[NBUCKETS] = ma_alloc(ta, hs * sizeof(counts[0]));
+		if (counts == NULL) {
+			ATOMIC_SET(&sh->failed, 1);
+			ma_close(&ta_state);
+			break;
+		}
+		for (;;) {
+			size_t b = (size_t) ATOMIC_ADD(&sh->nextbucket, 1);
+			if (b >= NBUCKETS)
+				break;
+			size_t lo = sh->bstart[b], cnt = sh->bstart[b + 1] - lo;
+			if (cnt == 0)
+				continue;
+			if (cnt > 1) {
+				memset(counts, 0, hs * sizeof(counts[0]));
+				rsort_range(sh->h2 + lo * hs, sh->t ? sh->t2 + lo * ts : NULL,
+					    sh->h + lo * hs, sh->t ? sh->t + lo * ts : NULL,
+					    cnt, hs, ts, sh->reverse, sh->bigendian, counts);
+			}
+			memcpy(sh->h + lo * hs, sh->h2 + lo * hs, cnt * hs);
+			if (sh->t)
+				memcpy(sh->t + lo * ts, sh->t2 + lo * ts, cnt * ts);
+		}
+		ma_close(&ta_state);
+		break;
+	}
+	default:
+		MT_UNREACHABLE();
+	}
+}
+
+/* run a phase on all tasks */
+static void
+rsort_phase(struct rsort_task *tasks, int nthreads, int phase)
+{
+	for (int i = 0; i < nthreads; i++)
+		tasks[i].phase = phase;
+	GDKparallel(rsort_worker, tasks, sizeof(*tasks), nthreads, "rsortXXXX");
+}
+
+static gdk_return
+rsort_parallel(uint8_t *h, uint8_t *t, uint8_t *h2, uint8_t *t2,
+	       size_t n, size_t hs, size_t ts, bool reverse, bool bigendian,
+	       int nthreads)
+{
+	allocator *ta = MT_thread_getallocator();
+	allocator_state ta_state = ma_open(ta);
+	struct rsort_shared *sh = ma_zalloc(ta, sizeof(*sh));
+	struct rsort_task *tasks = ma_zalloc(ta, nthreads * sizeof(*tasks));
+
+	if (sh == NULL || tasks == NULL) {
+		ma_close(&ta_state);
+		return GDK_FAIL;
+	}
+	*sh = (struct rsort_shared) {
+		.h = h,
+		.t = t,
+		.h2 = h2,
+		.t2 = t2,
+		.n = n,
+		.hs = hs,
+		.ts = ts,
+		.reverse = reverse,
+		.bigendian = bigendian,
+		.nextbucket = ATOMIC_VAR_INIT(0),
+		.failed = ATOMIC_VAR_INIT(0),
+	};
+	for (int i = 0; i < nthreads; i++) {
+		tasks[i].sh = sh;
+		tasks[i].lo = n / nthreads * i;
+		tasks[i].hi = i == nthreads - 1 ? n : n / nthreads * (i + 1);
+		tasks[i].counts = ma_zalloc(ta, hs * sizeof(tasks[i].counts[0]));
+		if (tasks[i].counts == NULL) {
+			ma_close(&ta_state);
+			return GDK_FAIL;
+		}
+	}
+
+	/* phase 1: count */
+	rsort_phase(tasks, nthreads, 1);
+
+	/* find the most significant byte in which the values differ */
+	size_t j = hs;
+	size_t total[NBUCKETS];
+	while (j > 0) {
+		j--;
+		size_t nb = 0;
+		for (int v = 0; v < NBUCKETS; v++) {
+			total[v] = 0;
+			for (int i = 0; i < nthreads; i++)
+				total[v] += tasks[i].counts[j][v];
+			nb += total[v] > 0;
+		}
+		if (nb > 1)
+			break;
+		if (j == 0) {
+			/* all values are equal */
+			ma_close(&ta_state);
+			return GDK_SUCCEED;
+		}
+	}
+#ifndef WORDS_BIGENDIAN
+	sh->byte = bigendian ? hs - 1 - j : j;
+#else
+	sh->byte = hs - 1 - j;
+#endif
+
+	/* the output order of the partitions: the sign bit is in the
+	 * most significant byte of native integers */
+	int order[NBUCKETS];
+	int flip = !bigendian && j == hs - 1 ? NBUCKETS / 2 : 0;
+	for (int b = 0; b < NBUCKETS; b++) {
+		int v = b ^ flip;
+		order[b] = reverse ? (NBUCKETS - 1) ^ v : v;
+	}
+	/* partition b in output order holds the values with byte value
+	 * order[b]; within a partition the chunks are laid out in
+	 * thread order, which keeps the sort stable */
+	size_t p = 0;
+	for (int b = 0; b < NBUCKETS; b++) {
+		int v = order[b];
+		sh->bstart[b] = p;
+		for (int i = 0; i < nthreads; i++) {
+			tasks[i].pos[v] = p;
+			p += tasks[i].counts[j][v];
+		}
+	}
+	sh->bstart[NBUCKETS] = p;
+	assert(p == n);
+
+	/* phase 2: scatter */
+	rsort_phase(tasks, nthreads, 2);
+
+	/* phase 3: sort the partitions */
+	rsort_phase(tasks, nthreads, 3);
+
+	gdk_return rc = ATOMIC_GET(&sh->failed) ? GDK_FAIL : GDK_SUCCEED;
+	ma_close(&ta_state);
+	return rc;
+}
+
+gdk_return
+GDKrsort(void *restrict h, void *restrict t, size_t n, size_t hs, size_t ts, bool reverse, bool bigendian)
+{
+	Heap tmph, tmpt;
+	uint8_t *t2 = NULL;
+	int nthreads = GDKnr_threads;
+	gdk_return rc = GDK_SUCCEED;
+
+	tmph = tmpt = (Heap) {
+		.farmid = 1,
+	};
+
+	snprintf(tmph.filename, sizeof(tmph.filename), "%s%crsort%zuh",
+		 TEMPDIR_NAME, DIR_SEP, (size_t) MT_getpid());
+	if (HEAPalloc(&tmph, n, hs) != GDK_SUCCEED)
+		return GDK_FAIL;
+
+	if (t) {
+		snprintf(tmpt.filename, sizeof(tmpt.filename), "%s%crsort%zut",
+			 TEMPDIR_NAME, DIR_SEP, (size_t) MT_getpid());
+		if (HEAPalloc(&tmpt, n, ts) != GDK_SUCCEED) {
+			HEAPfree(&tmph, true);
+			return GDK_FAIL;
+		}
+		t2 = (uint8_t *) tmpt.base;
+	} else {
+		ts = 0;
+	}
+
+	if ((size_t) nthreads > n / PARSORT_MINSIZE)
+		nthreads = (int) (n / PARSORT_MINSIZE);
+	if (nthreads > 1) {
+		rc = rsort_parallel(h, t, (uint8_t *) tmph.base, t2,
+				    n, hs, ts, reverse, bigendian, nthreads);
+	} else {
+		allocator *ta = MT_thread_getallocator();
+		allocator_state ta_state = ma_open(ta);
+		size_t (*counts)[NBUCKETS] = ma_zalloc(ta, hs * sizeof(counts[0]));
+
+		if (counts == NULL)
+			rc = GDK_FAIL;
+		else
+			rsort_range(h, t, (uint8_t *) tmph.base, t2,
+				    n, hs, ts, reverse, bigendian, counts);
+		ma_close(&ta_state);
+	}
 	HEAPfree(&tmph, true);
 	if (t)
 		HEAPfree(&tmpt, true);
-	return GDK_SUCCEED;
+	return rc;
 }
@@ -617,6 +617,57 @@ fullscan_any(BATiter *bi, struct canditer *restrict ci, BAT *bn,
 	return BUN_NONE;
 }
 
+/* range select on a string BAT using the string prefix heap: only
+ * values whose prefix is equal to the prefix of one of the bounds
+ * need to be compared to the bound itself */
+static BUN
+fullscan_str_prefix(BATiter *bi, struct canditer *restrict ci, BAT *bn,
+		    const uint64_t *restrict pfx,
+		    const char *tl, const char *th,
+		    bool li, bool hi, bool lval, bool hval,
+		    BUN cnt, const oid hseq, oid *restrict dst,
+		    BUN maximum, const char **algo)
+{
+	uint64_t lp = lval ? PFXvalue(tl) : 0;
+	uint64_t hp = hval ? PFXvalue(th) : 0;
+	BUN p, ncand = ci->ncand;
+	oid o;
+	int c;
+	QryCtx *qry_ctx = MT_thread_get_qry_ctx();
+
+	*algo = "fullscan range strprefix";
+	TIMEOUT_LOOP_IDX(p, ncand, qry_ctx) {
+		o = canditer_next(ci);
+		uint64_t v = pfx[o - hseq];
+		if (lval && v < lp)
+			continue;
+		if (hval && v > hp)
+			continue;
+		if (v == 0 || (lval && v == lp) || (hval && v == hp)) {
+			/* need to look at the actual value */
+			const char *s = BUNtvar(bi, o - hseq);
+			if (strNil(s) ||
+			    (lval && ((c = strcmp(tl, s)) > 0 || (!li && c == 0))) ||
+			    (hval && ((c = strcmp(th, s)) < 0 || (!hi && c == 0))))
+				continue;
+		}
+		dst = buninsfix(bn, dst, cnt, o,
+				(BUN) ((dbl) cnt / (dbl) (p == 0 ? 1 : p)
+				       * (dbl) (ncand-p) * 1.1 + 1024),
+				maximum);
+		if (dst == NULL) {
+			BBPreclaim(bn);
+			return BUN_NONE;
+		}
+		cnt++;
+	}
+	TIMEOUT_CHECK(qry_ctx, GOTO_LABEL_TIMEOUT_HANDLER(bailout, qry_ctx));
+	return cnt;
+  bailout:
+	BBPreclaim(bn);
+	return BUN_NONE;
+}
+
 static BUN
 fullscan_str(BATiter *bi, struct canditer *restrict ci, BAT *bn,
 	     const char *tl, const char *th,
@@ -631,6 +682,18 @@ fullscan_str(BATiter *bi, struct canditer *restrict ci, BAT *bn,
 	oid o;
 	QryCtx *qry_ctx = MT_thread_get_qry_ctx();
 
+	if (!equi && !anti &&
+	    BATatoms[bi->type].atomCmp == BATatoms[TYPE_str].atomCmp) {
+		Heap *pfxh;
+		const uint64_t *pfx = PFXget(bi, &pfxh);
+		if (pfx) {
+			cnt = fullscan_str_prefix(bi, ci, bn, pfx, tl, th,
+						  li, hi, lval, hval, cnt,
+						  hseq, dst, maximum, algo);
+			HEAPdecref(pfxh, false);
+			return cnt;
+		}
+	}
 	if (!equi || !bi->vkey) {
 		/* we will need to examine actual values */
 		return fullscan_any(bi, ci, bn, tl, th, li, hi, equi, anti,
@@ -267,3 +267,96 @@ bat_guess_uniques(BAT *b, BATiter *bi, struct canditer *bci)
 		  GDKusec() - t0);
 	return unique_guess;
 }
+
+/* Estimate the number of distinct value combinations of a group of
+ * aligned BATs in a single scan.  For every row the values of all
+ * columns are hashed (nil counts as a value), and separate sketches
+ * are kept for each column, for each pair of columns and for the
+ * group as a whole.  On return ndv[i * n + i] holds the estimate for
+ * column i, ndv[i * n + j] the estimate for the pair (i, j), and
+ * *group the estimate for all n columns together. */
+gdk_return
+bat_guess_uniques_multi(BAT **b, int n, double *ndv, double *group)
+{
+	lng t0 = GDKusec();
+	gdk_return rc = GDK_SUCCEED;
+	QryCtx *qry_ctx = MT_thread_get_qry_ctx();
+	int npairs = n * (n - 1) / 2;
+	uint8_t (*sketches)[BUCKETS][CLZ_BUCKETS];
+	BATiter *bis;
+	uint64_t *hashes, hash;
+	uint8_t bucket;
+	uint8_t clz;
+	uint64_t rng_buf[32];
+	int rng_i = 0;
+	BUN cnt;
+
+	assert(n >= 2);
+	cnt = BATcount(b[0]);
+	for (int i = 1; i < n; i++) {
+		if (BATcount(b[i]) != cnt) {
+			GDKerror("BATs must be aligned\n");
+			return GDK_FAIL;
+		}
+	}
+	sketches = GDKzalloc((size_t) (n + npairs + 1) * sizeof(*sketches));
+	bis = GDKmalloc(n * sizeof(BATiter));
+	hashes = GDKmalloc((n + 1) * sizeof(uint64_t));
+	if (sketches == NULL || bis == NULL || hashes == NULL) {
+		GDKfree(sketches);
+		GDKfree(bis);
+		GDKfree(hashes);
+		return GDK_FAIL;
+	}
+	for (int i = 0; i < n; i++)
+		bis[i] = bat_iterator(b[i]);
+
+	TIMEOUT_LOOP_IDX_DECL(p, cnt, qry_ctx) {
+		for (int i = 0; i < n; i++) {
+			const void *ptr = BUNtail(&bis[i], p);
+			size_t len = bis[i].vh ? ATOMlen(bis[i].type, ptr) : (size_t) bis[i].width;
+			if (ATOMstorage(bis[i].type) == TYPE_str)
+				len = strlen(ptr);
+			hashes[i] = hash = XXH64(ptr, len, HLLSEED);
+			SKETCH_UPDATE(sketches[i], hash);
+		}
+		/* not called k, SKETCH_UPDATE declares its own */
+		int s = n;
+		for (int i = 0; i < n; i++) {
+			for (int j = i + 1; j < n; j++) {
+				uint64_t pair[2] = { hashes[i], hashes[j] };
+				hash = XXH64(pair, sizeof(pair), HLLSEED);
+				SKETCH_UPDATE(sketches[s], hash);
+				s++;
+			}
+		}
+		hash = XXH64(hashes, n * sizeof(uint64_t), HLLSEED);
+		SKETCH_UPDATE(sketches[s], hash);
+	}
+	TIMEOUT_CHECK(qry_ctx, GOTO_LABEL_TIMEOUT_HANDLER(bailout, qry_ctx));
+
+	if (rc == GDK_SUCCEED) {
+		int s = n;
+		for (int i = 0; i < n; i++)
+			ndv[i * n + i] = sketch_estimate(sketches[i]);
+		for (int i = 0; i < n; i++) {
+			for (int j = i + 1; j < n; j++) {
+				ndv[i * n + j] = ndv[j * n + i] = sketch_estimate(sketches[s]);
+				s++;
+			}
+		}
+		*group = sketch_estimate(sketches[s]);
+	}
+	TRC_DEBUG(ALGO, "%d columns, " BUNFMT " rows " LLFMT " usec\n",
+		  n, cnt, GDKusec() - t0);
+	if (0) {
+  bailout:
+		rc = GDK_FAIL;
+	}
+	for (int i = 0; i < n; i++)
+		bat_iterator_end(&bis[i]);
+	GDKfree(sketches);
+	GDKfree(bis);
+	GDKfree(hashes);
+	return rc;
+}
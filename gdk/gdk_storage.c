@@ -881,6 +881,9 @@ BATdelete(BAT *b)
 	OIDXdestroy(b);
 	PROPdestroy_nolock(b);
 	STRMPdestroy(b);
+	TRGMdestroy(b);
+	FTXTdestroy(b);
+	PFXdestroy(b);
 	RTREEdestroy(b);
 	TSKdestroy(b);
 	if (b->theap) {
@@ -0,0 +1,228 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * For copyright information, see the file debian/copyright.
+ */
+
+/*
+ * String prefix heap.
+ *
+ * A string BAT only stores an offset into the string heap for each
+ * row, so any comparison of values has to dereference into the
+ * string heap, which for large BATs means a cache miss per value.
+ * The prefix heap is a companion heap of the tail which contains for
+ * each row the first 8 bytes of the string, NUL padded, as an
+ * unsigned integer with the first byte being the most significant
+ * one (see PFXvalue).  Comparing two such integers gives the same
+ * result as comparing the strings, except when they are equal: only
+ * then do the strings themselves need to be consulted.  Nil and the
+ * empty string both have prefix 0.
+ *
+ * The heap costs 8 bytes per row, so it is not created implicitly
+ * unless asked for: with the setting strprefix_minsize, column BATs
+ * with at least that many rows get one when they are used in a range
+ * select or a merge join (see PFXget).
+ *
+ * The heap is not persistent: it only exists as long as the BAT is
+ * loaded.  It is maintained when values are appended to the BAT and
+ * destroyed on any other update.  Readers get a reference to the heap
+ * (PFXacquire), so when the heap needs to grow, a new heap is
+ * allocated and the old one is released.
+ */
+
+#include "monetdb_config.h"
+#include "gdk.h"
+#include "gdk_private.h"
+
+static ATOMIC_TYPE pfxseq = ATOMIC_VAR_INIT(0);
+
+static Heap *
+PFXcreateheap(BAT *b, BUN cap)
+{
+	Heap *h;
+
+	if ((h = GDKmalloc(sizeof(Heap))) == NULL)
+		return NULL;
+	*h = (Heap) {
+		.farmid = BBPselectfarm(b->batRole, b->ttype, prefixheap),
+		.parentid = b->batCacheid,
+		.dirty = true,
+		.refs = ATOMIC_VAR_INIT(1),
+	};
+	/* each incarnation gets its own name since the previous one
+	 * may still be in use by a reader when the heap grows */
+	snprintf(h->filename, sizeof(h->filename), "%s.tprefix%u",
+		 BBP_physical(b->batCacheid),
+		 (unsigned) ATOMIC_INC(&pfxseq));
+	if (h->farmid < 0 ||
+	    HEAPalloc(h, cap, sizeof(uint64_t)) != GDK_SUCCEED) {
+		GDKfree(h);
+		return NULL;
+	}
+	return h;
+}
+
+static void
+PFXfill(uint64_t *restrict pfx, const BATiter *bi, BUN start, BUN end)
+{
+	for (BUN p = start; p < end; p++)
+		pfx[p] = PFXvalue(BUNtvar(bi, p));
+}
+
+/* create the prefix heap for string BAT b; b must own its tail heap */
+gdk_return
+BATstrprefix(BAT *b)
+{
+	lng t0 = GDKusec();
+
+	if (ATOMstorage(b->ttype) != TYPE_str ||
+	    BATatoms[b->ttype].atomCmp != BATatoms[TYPE_str].atomCmp) {
+		GDKerror("prefix heap only for string bats\n");
+		return GDK_FAIL;
+	}
+	if (VIEWtparent(b) || b->tbaseoff != 0) {
+		GDKerror("no prefix heap on views\n");
+		return GDK_FAIL;
+	}
+	MT_lock_set(&b->batIdxLock);
+	if (b->tprefix != NULL) {
+		MT_lock_unset(&b->batIdxLock);
+		return GDK_SUCCEED;
+	}
+	BATiter bi = bat_iterator(b);
+	Heap *h = PFXcreateheap(b, bi.count);
+	if (h == NULL) {
+		bat_iterator_end(&bi);
+		MT_lock_unset(&b->batIdxLock);
+		return GDK_FAIL;
+	}
+	PFXfill((uint64_t *) h->base, &bi, 0, bi.count);
+	h->free = bi.count * sizeof(uint64_t);
+	b->tprefix = h;
+	bat_iterator_end(&bi);
+	MT_lock_unset(&b->batIdxLock);
+	TRC_DEBUG(ACCELERATOR, "BATstrprefix(" ALGOBATFMT "): created prefix heap (" LLFMT " usec)\n", ALGOBATPAR(b), GDKusec() - t0);
+	return GDK_SUCCEED;
+}
+
+/* extend the prefix heap of b after values were appended; oldcount
+ * is the number of rows before the append */
+void
+PFXappend(BAT *b, BUN oldcount)
+{
+	Heap *h, *nh;
+
+	if (b->tprefix == NULL)
+		return;
+	MT_lock_set(&b->batIdxLock);
+	if ((h = b->tprefix) == NULL) {
+		MT_lock_unset(&b->batIdxLock);
+		return;
+	}
+	BATiter bi = bat_iterator(b);
+	if (h->free != oldcount * sizeof(uint64_t) || bi.count < oldcount) {
+		/* the BAT changed behind our back, give up */
+		b->tprefix = NULL;
+		bat_iterator_end(&bi);
+		MT_lock_unset(&b->batIdxLock);
+		HEAPdecref(h, true);
+		return;
+	}
+	if (bi.count * sizeof(uint64_t) > h->size) {
+		/* readers may be looking at the current heap, so
+		 * copy to a new, larger, heap */
+		nh = PFXcreateheap(b, bi.count + bi.count / 4);
+		if (nh == NULL) {
+			b->tprefix = NULL;
+			bat_iterator_end(&bi);
+			MT_lock_unset(&b->batIdxLock);
+			HEAPdecref(h, true);
+			GDKclrerr();
+			return;
+		}
+		memcpy(nh->base, h->base, h->free);
+		b->tprefix = nh;
+		HEAPdecref(h, true);
+		h = nh;
+	}
+	PFXfill((uint64_t *) h->base, &bi, oldcount, bi.count);
+	h->free = bi.count * sizeof(uint64_t);
+	bat_iterator_end(&bi);
+	MT_lock_unset(&b->batIdxLock);
+}
+
+void
+PFXdestroy(BAT *b)
+{
+	if (b && b->tprefix) {
+		Heap *h;
+
+		MT_lock_set(&b->batIdxLock);
+		h = b->tprefix;
+		b->tprefix = NULL;
+		MT_lock_unset(&b->batIdxLock);
+		if (h)
+			HEAPdecref(h, true);
+	}
+}
+
+/* Return the prefixes for the rows of bi, or NULL if there is no
+ * usable prefix heap.  If not NULL, *hp is set to the heap which the
+ * caller needs to release with HEAPdecref(*hp, false). */
+const uint64_t *
+PFXacquire(const BATiter *bi, Heap **hp)
+{
+	BAT *pb;
+	Heap *h;
+	const uint64_t *pfx = NULL;
+
+	*hp = NULL;
+	if (bi->h == NULL || bi->vh == NULL ||
+	    ATOMstorage(bi->type) != TYPE_str)
+		return NULL;
+	pb = BBP_desc(bi->h->parentid);
+	if (pb == NULL || pb->tprefix == NULL)
+		return NULL;
+	MT_lock_set(&pb->batIdxLock);
+	if ((h = pb->tprefix) != NULL &&
+	    pb->theap == bi->h &&
+	    pb->tbaseoff == 0 &&
+	    h->free >= (bi->baseoff + bi->count) * sizeof(uint64_t)) {
+		HEAPincref(h);
+		*hp = h;
+		pfx = (const uint64_t *) h->base + bi->baseoff;
+	}
+	MT_lock_unset(&pb->batIdxLock);
+	return pfx;
+}
+
+/* Like PFXacquire, but if there is no prefix heap and the parent of
+ * bi is a column BAT with at least strprefix_minsize rows, create
+ * the prefix heap first. */
+const uint64_t *
+PFXget(const BATiter *bi, Heap **hp)
+{
+	const uint64_t *pfx = PFXacquire(bi, hp);
+	BAT *pb;
+
+	if (pfx == NULL &&
+	    strprefix_minsize > 0 &&
+	    bi->h != NULL &&
+	    ATOMstorage(bi->type) == TYPE_str &&
+	    BATatoms[bi->type].atomCmp == BATatoms[TYPE_str].atomCmp &&
+	    (pb = BBP_desc(bi->h->parentid)) != NULL &&
+	    pb->batRole == PERSISTENT &&
+	    BATcount(pb) >= strprefix_minsize) {
+		/* if we're looking at a slice, the heap is created
+		 * for the whole parent */
+		if (BATstrprefix(pb) == GDK_SUCCEED)
+			pfx = PFXacquire(bi, hp);
+		else
+			GDKclrerr();
+	}
+	return pfx;
+}
@@ -51,6 +51,12 @@
 
 #include "mutils.h"
 
+#ifdef HAVE_LINUX_PERF_EVENT_H
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#endif
+
 static ATOMIC_TYPE GDKthreadid = ATOMIC_VAR_INIT(1);
 
 #ifdef LOCK_STATS
@@ -228,6 +234,11 @@ struct mtthread {
 	uintptr_t sp;
 	char gdkerrbuf[GDKMAXERRLEN];
 	struct freebats freebats;
+#ifdef HAVE_LINUX_PERF_EVENT_H
+	int hwstate;		/* 0: not opened, 1: opened, -1: unavailable */
+	int hwfd;		/* group leader of the counters */
+	int hwfds[MT_HW_COUNTERS]; /* counter file descriptors, -1 if absent */
+#endif
 };
 static struct mtthread mainthread = {
 	.threadname = "main-thread",
@@ -363,12 +374,28 @@ dump_threads(void)
 	thread_unlock();
 }
 
+static void
+hwcounters_close(struct mtthread *t)
+{
+#ifdef HAVE_LINUX_PERF_EVENT_H
+	if (t->hwstate == 1) {
+		for (int i = 0; i < MT_HW_COUNTERS; i++)
+			if (t->hwfds[i] >= 0)
+				close(t->hwfds[i]);
+	}
+	t->hwstate = 0;
+#else
+	(void) t;
+#endif
+}
+
 static void
 rm_mtthread(struct mtthread *t)
 {
 	struct mtthread **pt;
 
 	assert(t != &mainthread);
+	hwcounters_close(t);
 	thread_lock();
 	allocator *ta = t->ma;
 	t->ma = NULL;
@@ -764,6 +791,101 @@ MT_thread_getalgorithm(void)
 	return self && self->algorithm[0] ? self->algorithm : NULL;
 }
 
+#ifdef HAVE_LINUX_PERF_EVENT_H
+static bool
+hwcounters_open(struct mtthread *self)
+{
+	static const struct {
+		uint32_t type;
+		uint64_t config;
+	} events[MT_HW_COUNTERS] = {
+		[MT_HW_CYCLES] = {
+			PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES,
+		},
+		[MT_HW_INSTRUCTIONS] = {
+			PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS,
+		},
+		[MT_HW_LLC_MISSES] = {
+			PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES,
+		},
+		[MT_HW_BRANCH_MISSES] = {
+			PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES,
+		},
+		[MT_HW_DTLB_MISSES] = {
+			PERF_TYPE_HW_CACHE,
+			PERF_COUNT_HW_CACHE_DTLB |
+			(PERF_COUNT_HW_CACHE_OP_READ << 8) |
+			(PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+		},
+	};
+
+	self->hwfd = -1;
+	for (int i = 0; i < MT_HW_COUNTERS; i++) {
+		struct perf_event_attr attr = {
+			.size = sizeof(attr),
+			.type = events[i].type,
+			.config = events[i].config,
+			.disabled = self->hwfd < 0,
+			.exclude_kernel = 1,
+			.exclude_hv = 1,
+			.read_format = PERF_FORMAT_GROUP,
+		};
+
+		/* count for this thread on any cpu, the counters that the
+		 * hardware does not have are left out */
+		self->hwfds[i] = (int) syscall(SYS_perf_event_open, &attr, 0, -1,
+					       self->hwfd, 0);
+		if (self->hwfds[i] >= 0 && self->hwfd < 0)
+			self->hwfd = self->hwfds[i];
+	}
+	if (self->hwfd < 0) {
+		self->hwstate = -1;
+		return false;
+	}
+	ioctl(self->hwfd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+	ioctl(self->hwfd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+	self->hwstate = 1;
+	return true;
+}
+#endif
+
+/* Read the hardware performance counters of the calling thread.  The
+ * counters are opened on first use.  Counters that are not available
+ * are returned as -1, if none is available the function returns
+ * false. */
+bool
+MT_thread_hwcounters(int64_t counters[MT_HW_COUNTERS])
+{
+	for (int i = 0; i < MT_HW_COUNTERS; i++)
+		counters[i] = -1;
+#ifdef HAVE_LINUX_PERF_EVENT_H
+	if (!thread_initialized)
+		return false;
+	struct mtthread *self = thread_self();
+	uint64_t values[MT_HW_COUNTERS + 1];
+	ssize_t n;
+
+	if (self == NULL || self->hwstate < 0 ||
+	    (self->hwstate == 0 && !hwcounters_open(self)))
+		return false;
+	/* with PERF_FORMAT_GROUP, the number of values is followed by
+	 * the values in the order the counters were opened */
+	n = read(self->hwfd, values, sizeof(values));
+	if (n < (ssize_t) sizeof(uint64_t))
+		return false;
+	for (int i = 0, j = 1; i < MT_HW_COUNTERS; i++) {
+		if (self->hwfds[i] >= 0) {
+			if ((uint64_t) j > values[0])
+				break;
+			counters[i] = (int64_t) values[j++];
+		}
+	}
+	return true;
+#else
+	return false;
+#endif
+}
+
 bool
 MT_thread_override_limits(void)
 {
@@ -1294,6 +1416,28 @@ MT_cond_wait(MT_Cond *cond, MT_Lock *lock)
 	MT_thread_setcondwait(NULL);
 }
 
+/* like MT_cond_wait, but wake up after at most ms milliseconds */
+void
+MT_cond_timedwait(MT_Cond *cond, MT_Lock *lock, int ms)
+{
+	MT_thread_setcondwait(cond);
+#if !defined(HAVE_PTHREAD_H) && defined(WIN32)
+	SleepConditionVariableCS(&cond->cv, &lock->lock, (DWORD) ms);
+#else
+	struct timespec ts;
+
+	clock_gettime(CLOCK_REALTIME, &ts);
+	ts.tv_sec += ms / 1000;
+	ts.tv_nsec += (long) (ms % 1000) * 1000000;
+	if (ts.tv_nsec >= 1000000000) {
+		ts.tv_sec++;
+		ts.tv_nsec -= 1000000000;
+	}
+	pthread_cond_timedwait(&cond->cv, &lock->lock, &ts);
+#endif
+	MT_thread_setcondwait(NULL);
+}
+
 void
 MT_cond_signal(MT_Cond *cond)
 {
@@ -0,0 +1,660 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * For copyright information, see the file debian/copyright.
+ */
+
+/*
+ * Trigram index on string BATs.
+ *
+ * For each row the index records which trigrams (three consecutive
+ * bytes) occur in the case folded version of the string.  Trigrams
+ * are hashed into a power of two number of buckets, and for each
+ * bucket the index holds the sorted list of positions of the rows
+ * that contain a trigram that hashes to it.  A row can only match a
+ * LIKE pattern if it occurs in the lists of all trigrams of the
+ * literal parts of the pattern.  Because of hash collisions and case
+ * folding this gives a superset of the matching rows, so the caller
+ * still has to check each of them, but for selective patterns that is
+ * only a small fraction of the column.  Since case folding is applied
+ * to the values as well as to the pattern, the same index serves LIKE
+ * and ILIKE.
+ *
+ * The index covers the first so many rows of the BAT.  Rows that are
+ * appended later are not in the index: they are always part of the
+ * result of TRGMselect, and once there are enough of them, the index
+ * is extended.  Any other update destroys the index.
+ *
+ * The heap consists of a header of TRIGRAMOFF oids (version, number of
+ * rows covered, log2 of the number of buckets, number of postings),
+ * the number of buckets + 1 bucket offsets (oids), and the postings
+ * (uint32_t row positions).
+ */
+
+#include "monetdb_config.h"
+#include "gdk.h"
+#include "gdk_private.h"
+
+#define TRIGRAM_VERSION		((oid) 1)
+#define TRIGRAMOFF		4
+#define TRIGRAM_MINBITS		10
+#define TRIGRAM_MAXBITS		20
+
+#define TRGMhash(t, bits)	((BUN) (((t) * UINT32_C(2654435761)) >> (32 - (bits))))
+
+#define TRGMoffsets(hp)		((oid *) (hp)->base + TRIGRAMOFF)
+#define TRGMpostings(hp)						\
+	((uint32_t *) (TRGMoffsets(hp) + ((BUN) 1 << ((oid *) (hp)->base)[2]) + 1))
+
+static size_t
+TRGMsize(int bits, BUN npost)
+{
+	return (TRIGRAMOFF + ((size_t) 1 << bits) + 1) * SIZEOF_OID
+		+ npost * sizeof(uint32_t);
+}
+
+/* return the case folded version of s, either s itself or a copy in
+ * *buf; NULL on failure */
+static const uint8_t *
+TRGMfold(allocator *ma, char **buf, size_t *buflen, const char *s)
+{
+	for (const uint8_t *p = (const uint8_t *) s; *p; p++) {
+		if (*p >= 0x80 || (*p >= 'A' && *p <= 'Z')) {
+			if (GDKcasefold(ma, buf, buflen, s) != GDK_SUCCEED)
+				return NULL;
+			return (const uint8_t *) *buf;
+		}
+	}
+	return (const uint8_t *) s;
+}
+
+static void
+TRGMsync(void *arg)
+{
+	BAT *b = arg;
+	Heap *hp;
+	int fd;
+	lng t0 = GDKusec();
+	const char *failed = " failed";
+
+	MT_lock_set(&b->batIdxLock);
+	if ((hp = b->ttrigram) != NULL && hp != (Heap *) 1) {
+		if (HEAPsave(hp, hp->filename, NULL, true, hp->free, NULL) == GDK_SUCCEED) {
+			if (hp->storage == STORE_MEM) {
+				if ((fd = GDKfdlocate(hp->farmid, hp->filename, "rb+", NULL)) >= 0) {
+					((oid *) hp->base)[0] |= (oid) 1 << 24;
+					if (write(fd, hp->base, SIZEOF_OID) >= 0) {
+						failed = ""; /* not failed */
+						if (!(ATOMIC_GET(&GDKdebug) & NOSYNCMASK)) {
+#if defined(NATIVE_WIN32)
+							_commit(fd);
+#elif defined(HAVE_FDATASYNC)
+							fdatasync(fd);
+#elif defined(HAVE_FSYNC)
+							fsync(fd);
+#endif
+						}
+					} else {
+						hp->dirty = true;
+						perror("write trigram index");
+					}
+					close(fd);
+				}
+			} else {
+				((oid *) hp->base)[0] |= (oid) 1 << 24;
+				if (!(ATOMIC_GET(&GDKdebug) & NOSYNCMASK) &&
+				    MT_msync(hp->base, SIZEOF_OID) < 0) {
+					hp->dirty = true;
+					failed = " sync failed";
+					((oid *) hp->base)[0] &= ~((oid) 1 << 24);
+				} else {
+					failed = ""; /* not failed */
+				}
+			}
+			TRC_DEBUG(ACCELERATOR, "TRGMsync(%s): trigram index persisted"
+				  " (" LLFMT " usec)%s\n",
+				  BATgetId(b), GDKusec() - t0, failed);
+		}
+	}
+	MT_lock_unset(&b->batIdxLock);
+	BBPunfix(b->batCacheid);
+}
+
+/* maybe persist the trigram index heap; called with batIdxLock held */
+static void
+TRGMpersist(BAT *b)
+{
+	if ((BBP_status(b->batCacheid) & BBPEXISTING) &&
+	    b->batInserted == b->batCount &&
+	    !b->theap->dirty &&
+	    !GDKinmemory(b->theap->farmid)) {
+		MT_Id tid;
+		BBPfix(b->batCacheid);
+		char name[MT_NAME_LEN];
+		snprintf(name, sizeof(name), "trgmsync%d", b->batCacheid);
+		if (MT_create_thread(&tid, TRGMsync, b,
+				     MT_THR_DETACHED, name) < 0)
+			BBPunfix(b->batCacheid);
+	} else
+		TRC_DEBUG(ACCELERATOR, "TRGMpersist(" ALGOBATFMT "): NOT persisting trigram index\n", ALGOBATPAR(b));
+}
+
+/* make sure a persisted trigram index is loaded; called with
+ * batIdxLock held */
+static void
+TRGMload(BAT *b)
+{
+	Heap *hp;
+	const char *nme = BBP_physical(b->batCacheid);
+	int fd;
+
+	if (b->ttrigram != (Heap *) 1)
+		return;
+	assert(!GDKinmemory(b->theap->farmid));
+	b->ttrigram = NULL;
+	if ((hp = GDKzalloc(sizeof(*hp))) != NULL &&
+	    (hp->farmid = BBPselectfarm(b->batRole, b->ttype, trigramheap)) >= 0) {
+		strtconcat(hp->filename, sizeof(hp->filename),
+			   nme, ".ttrigram", NULL);
+		hp->storage = hp->newstorage = STORE_INVALID;
+
+		/* check whether a persisted trigram index can be found */
+		if ((fd = GDKfdlocate(hp->farmid, nme, "rb+", "ttrigram")) >= 0) {
+			struct stat st;
+			oid hdata[TRIGRAMOFF];
+
+			if (read(fd, hdata, sizeof(hdata)) == sizeof(hdata) &&
+			    hdata[0] == (((oid) 1 << 24) | TRIGRAM_VERSION) &&
+			    hdata[1] <= (oid) BATcount(b) &&
+			    hdata[2] >= TRIGRAM_MINBITS &&
+			    hdata[2] <= TRIGRAM_MAXBITS &&
+			    fstat(fd, &st) == 0 &&
+			    st.st_size >= (off_t) (hp->size = hp->free = TRGMsize((int) hdata[2], (BUN) hdata[3])) &&
+			    HEAPload(hp, nme, "ttrigram", false) == GDK_SUCCEED) {
+				close(fd);
+				ATOMIC_INIT(&hp->refs, 1);
+				hp->hasfile = true;
+				b->ttrigram = hp;
+				TRC_DEBUG(ACCELERATOR, "TRGMload(" ALGOBATFMT "): reusing persisted trigram index\n", ALGOBATPAR(b));
+				return;
+			}
+			close(fd);
+			/* unlink unusable file */
+			GDKunlink(hp->farmid, BATDIR, nme, "ttrigram");
+		}
+	}
+	GDKfree(hp);
+	GDKclrerr();	/* we're not currently interested in errors */
+}
+
+/* build a trigram index on the rows of bi; if old is not NULL, it is
+ * an index on a prefix of those rows which is extended with the rest;
+ * returns NULL on failure */
+static Heap *
+TRGMbuild(BAT *b, BATiter *bi, const Heap *old)
+{
+	BUN cnt = bi->count, ocnt = 0, nbkt, npost = 0;
+	int bits;
+	oid *restrict cur = NULL, *restrict off;
+	uint32_t *restrict last = NULL, *restrict post;
+	const oid *ooff = NULL;
+	const uint32_t *opost = NULL;
+	Heap *m = NULL;
+	allocator *ta = MT_thread_getallocator();
+	allocator_state ta_state = ma_open(ta);
+	char *buf = NULL;
+	size_t buflen = 0;
+	const uint8_t *s;
+	lng t0 = GDKusec();
+
+	if (cnt >= (BUN) UINT32_MAX) {
+		GDKerror("too many rows for a trigram index\n");
+		ma_close(&ta_state);
+		return NULL;
+	}
+	if (old) {
+		ocnt = (BUN) ((const oid *) old->base)[1];
+		bits = (int) ((const oid *) old->base)[2];
+		ooff = (const oid *) old->base + TRIGRAMOFF;
+		opost = (const uint32_t *) (ooff + ((BUN) 1 << bits) + 1);
+		assert(ocnt <= cnt);
+	} else {
+		for (bits = TRIGRAM_MINBITS;
+		     bits < TRIGRAM_MAXBITS && ((BUN) 1 << bits) < cnt;
+		     bits++)
+			;
+	}
+	nbkt = (BUN) 1 << bits;
+
+	/* cur[h] counts the postings of bucket h, and later is the
+	 * position where its next posting goes; last[h] is one more
+	 * than the last row that was added to bucket h, so that each row
+	 * is added to a bucket only once */
+	if ((cur = GDKmalloc((nbkt + 1) * sizeof(oid))) == NULL ||
+	    (last = GDKzalloc(nbkt * sizeof(uint32_t))) == NULL)
+		goto bailout;
+	for (BUN h = 0; h < nbkt; h++)
+		cur[h] = old ? ooff[h + 1] - ooff[h] : 0;
+
+#define TRGMscan(ADD)							\
+	do {								\
+		for (BUN i = ocnt; i < cnt; i++) {			\
+			const char *v = BUNtvar(bi, i);		\
+			if (strNil(v))					\
+				continue;				\
+			if ((s = TRGMfold(ta, &buf, &buflen, v)) == NULL) \
+				goto bailout;				\
+			uint32_t t = 0;					\
+			for (int n = 0; *s; s++) {			\
+				t = ((t << 8) | *s) & 0xFFFFFF;		\
+				if (++n >= 3) {				\
+					BUN h = TRGMhash(t, bits);	\
+					if (last[h] != (uint32_t) i + 1) { \
+						last[h] = (uint32_t) i + 1; \
+						ADD;			\
+					}				\
+				}					\
+			}						\
+		}							\
+	} while (0)
+
+	TRGMscan(cur[h]++);
+	for (BUN h = 0; h < nbkt; h++)
+		npost += cur[h];
+
+	if ((m = GDKmalloc(sizeof(Heap))) == NULL)
+		goto bailout;
+	*m = (Heap) {
+		.farmid = BBPselectfarm(b->batRole, b->ttype, trigramheap),
+		.parentid = b->batCacheid,
+		.dirty = true,
+		.refs = ATOMIC_VAR_INIT(1),
+	};
+	strtconcat(m->filename, sizeof(m->filename),
+		   BBP_physical(b->batCacheid), ".ttrigram", NULL);
+	if (m->farmid < 0 ||
+	    HEAPalloc(m, TRGMsize(bits, npost), 1) != GDK_SUCCEED) {
+		GDKfree(m);
+		m = NULL;
+		goto bailout;
+	}
+	m->free = TRGMsize(bits, npost);
+	((oid *) m->base)[0] = TRIGRAM_VERSION;
+	((oid *) m->base)[1] = (oid) cnt;
+	((oid *) m->base)[2] = (oid) bits;
+	((oid *) m->base)[3] = (oid) npost;
+	off = TRGMoffsets(m);
+	post = TRGMpostings(m);
+
+	/* turn the counts into offsets, copying the old postings */
+	npost = 0;
+	for (BUN h = 0; h < nbkt; h++) {
+		off[h] = npost;
+		npost += cur[h];
+		cur[h] = off[h];
+		if (old) {
+			BUN n = ooff[h + 1] - ooff[h];
+			if (n > 0)
+				memcpy(post + off[h], opost + ooff[h], n * sizeof(uint32_t));
+			cur[h] += n;
+		}
+	}
+	off[nbkt] = npost;
+
+	memset(last, 0, nbkt * sizeof(uint32_t));
+	TRGMscan(post[cur[h]++] = (uint32_t) i);
+#undef TRGMscan
+
+	GDKfree(cur);
+	GDKfree(last);
+	ma_close(&ta_state);
+	TRC_DEBUG(ACCELERATOR, "TRGMbuild(" ALGOBATFMT "): " BUNFMT " rows, "
+		  BUNFMT " buckets, " BUNFMT " postings (" LLFMT " usec)\n",
+		  ALGOBATPAR(b), cnt - ocnt, nbkt, npost, GDKusec() - t0);
+	return m;
+
+  bailout:
+	if (m) {
+		HEAPfree(m, true);
+		GDKfree(m);
+	}
+	GDKfree(cur);
+	GDKfree(last);
+	ma_close(&ta_state);
+	return NULL;
+}
+
+/* build or extend the trigram index of b; if create is false, no
+ * index is built and an existing index is only extended if more than
+ * an eighth of the rows is not covered; called with batIdxLock held */
+static gdk_return
+TRGMupdate(BAT *b, bool create)
+{
+	Heap *hp, *m;
+
+	TRGMload(b);
+	if ((hp = b->ttrigram) == NULL && !create)
+		return GDK_SUCCEED;
+	BATiter bi = bat_iterator(b);
+	if (hp != NULL) {
+		BUN ocnt = (BUN) ((const oid *) hp->base)[1];
+		if (ocnt > bi.count) {
+			/* the BAT shrunk, the index is of no use */
+			bat_iterator_end(&bi);
+			return GDK_FAIL;
+		}
+		if (ocnt == bi.count || (!create && bi.count - ocnt <= ocnt / 8)) {
+			bat_iterator_end(&bi);
+			return GDK_SUCCEED;
+		}
+		MT_thread_setalgorithm("extend trigram index", __func__);
+		if (hp->hasfile) {
+			/* whoever still uses the old index may have the
+			 * file mapped, so don't overwrite it but start
+			 * afresh */
+			GDKunlink(hp->farmid, BATDIR, BBP_physical(b->batCacheid), "ttrigram");
+			hp->hasfile = false;
+		}
+	} else {
+		MT_thread_setalgorithm("create trigram index", __func__);
+	}
+	m = TRGMbuild(b, &bi, hp);
+	bat_iterator_end(&bi);
+	if (m == NULL) {
+		if (create)
+			return GDK_FAIL;
+		/* keep using the old index */
+		GDKclrerr();
+		return GDK_SUCCEED;
+	}
+	b->ttrigram = m;
+	if (hp != NULL)
+		HEAPdecref(hp, false);
+	TRGMpersist(b);
+	return GDK_SUCCEED;
+}
+
+/* create a trigram index on (the parent of) b, or bring an existing
+ * one up to date */
+gdk_return
+TRGMcreate(BAT *b)
+{
+	BAT *pb = b;
+	gdk_return rc;
+
+	if (ATOMstorage(b->ttype) != TYPE_str) {
+		GDKerror("Cannot create trigram index for non string bats\n");
+		return GDK_FAIL;
+	}
+	if (VIEWtparent(b)) {
+		pb = BATdescriptor(VIEWtparent(b));
+		if (pb == NULL)
+			return GDK_FAIL;
+	}
+	MT_lock_set(&pb->batIdxLock);
+	if ((rc = TRGMupdate(pb, true)) != GDK_SUCCEED && pb->ttrigram != NULL) {
+		/* the BAT shrunk: replace the index */
+		Heap *hp = pb->ttrigram;
+		pb->ttrigram = NULL;
+		if (hp->hasfile)
+			GDKunlink(hp->farmid, BATDIR, BBP_physical(pb->batCacheid), "ttrigram");
+		HEAPdecref(hp, false);
+		rc = TRGMupdate(pb, true);
+	}
+	MT_lock_unset(&pb->batIdxLock);
+	if (pb != b)
+		BBPunfix(pb->batCacheid);
+	return rc;
+}
+
+bool
+BAThastrigrams(BAT *b)
+{
+	BAT *pb = b;
+	bool ret;
+
+	if (VIEWtparent(b)) {
+		pb = BATdescriptor(VIEWtparent(b));
+		if (pb == NULL)
+			return false;
+	}
+	MT_lock_set(&pb->batIdxLock);
+	ret = pb->ttrigram != NULL;
+	MT_lock_unset(&pb->batIdxLock);
+	if (pb != b)
+		BBPunfix(pb->batCacheid);
+	return ret;
+}
+
+static int
+TRGMcmplen(const void *a, const void *b)
+{
+	const BUN *x = a, *y = b;
+	return (x[1] > y[1]) - (x[1] < y[1]);
+}
+
+/* intersect the sorted list r of n positions with the sorted list l
+ * of m positions, leaving the result in r; return its length */
+static BUN
+TRGMintersect(uint32_t *restrict r, BUN n, const uint32_t *restrict l, BUN m)
+{
+	BUN j = 0, k = 0;
+
+	for (BUN i = 0; i < n && j < m; i++) {
+		if (l[j] < r[i]) {
+			/* gallop */
+			BUN step = 1, lo = j, hi;
+			while (lo + step < m && l[lo + step] < r[i]) {
+				lo += step;
+				step <<= 1;
+			}
+			hi = lo + step < m ? lo + step : m;
+			while (lo < hi) {
+				BUN mid = (lo + hi) / 2;
+				if (l[mid] < r[i])
+					lo = mid + 1;
+				else
+					hi = mid;
+			}
+			j = lo;
+		}
+		if (j < m && l[j] == r[i])
+			r[k++] = r[i];
+	}
+	return k;
+}
+
+/* Return a candidate list with a superset of the rows of b (restricted
+ * to candidate list s) that can match the LIKE pattern pat with escape
+ * character esc, be it case sensitive or not.  Returns NULL without
+ * setting an error if the trigram index of b cannot help. */
+BAT *
+TRGMselect(BAT *b, BAT *s, const char *pat, const char *esc)
+{
+	BAT *pb = b, *r = NULL, *bn;
+	Heap *hp = NULL;
+	allocator *ta = MT_thread_getallocator();
+	allocator_state ta_state = ma_open(ta);
+	uint8_t *frag;
+	BUN *lists, nlists = 0, maxlists, n;
+	BUN boff, bcnt = BATcount(b), ocnt;
+	uint32_t *res;
+	const uint8_t *p;
+	uint8_t escc = esc ? (uint8_t) *esc : 0;
+	char *buf = NULL;
+	size_t buflen = 0;
+	lng t0 = GDKusec();
+
+	if (VIEWtparent(b)) {
+		pb = BATdescriptor(VIEWtparent(b));
+		if (pb == NULL)
+			goto bailout;
+	}
+	boff = b->tbaseoff - pb->tbaseoff;
+	MT_lock_set(&pb->batIdxLock);
+	if (pb->ttrigram != NULL) {
+		if (TRGMupdate(pb, false) != GDK_SUCCEED)
+			GDKclrerr();
+		else if ((hp = pb->ttrigram) != NULL)
+			HEAPincref(hp);
+	}
+	MT_lock_unset(&pb->batIdxLock);
+	if (hp == NULL)
+		goto bailout;
+	ocnt = (BUN) ((const oid *) hp->base)[1];
+	int bits = (int) ((const oid *) hp->base)[2];
+	const oid *off = TRGMoffsets(hp);
+	const uint32_t *post = TRGMpostings(hp);
+
+	/* collect the buckets of the trigrams of the literal parts of the
+	 * pattern as (offset, length) pairs */
+	size_t plen = strlen(pat);
+	if ((frag = ma_alloc(ta, plen + 1)) == NULL ||
+	    (lists = ma_alloc(ta, 2 * (maxlists = plen) * sizeof(BUN) + 1)) == NULL)
+		goto bailout;
+	p = (const uint8_t *) pat;
+	for (;;) {
+		size_t flen = 0;
+		for (; *p; p++) {
+			if (*p == escc) {
+				if (*++p == 0)
+					break;
+			} else if (*p == '%' || *p == '_') {
+				p++;
+				break;
+			}
+			frag[flen++] = *p;
+		}
+		if (flen >= 3) {
+			const uint8_t *f;
+			frag[flen] = 0;
+			if ((f = TRGMfold(ta, &buf, &buflen, (const char *) frag)) == NULL)
+				goto bailout;
+			uint32_t t = 0;
+			for (int k = 0; *f; f++) {
+				t = ((t << 8) | *f) & 0xFFFFFF;
+				if (++k >= 3) {
+					BUN h = TRGMhash(t, bits);
+					BUN j;
+					for (j = 0; j < nlists; j++)
+						if (lists[2 * j] == off[h] &&
+						    lists[2 * j + 1] == off[h + 1] - off[h])
+							break;
+					if (j < nlists)
+						continue;
+					if (nlists == maxlists) {
+						/* case folding made the fragment longer */
+						lists = ma_realloc(ta, lists, 4 * maxlists * sizeof(BUN), 2 * maxlists * sizeof(BUN) + 1);
+						if (lists == NULL)
+							goto bailout;
+						maxlists *= 2;
+					}
+					lists[2 * nlists] = off[h];
+					lists[2 * nlists + 1] = off[h + 1] - off[h];
+					nlists++;
+				}
+			}
+		}
+		if (*p == 0)
+			break;
+	}
+	if (nlists == 0)
+		goto bailout;	/* no trigrams in the pattern */
+	qsort(lists, nlists, 2 * sizeof(BUN), TRGMcmplen);
+	if (lists[1] > ocnt / 2)
+		goto bailout;	/* not selective enough */
+
+	/* start with the part of the shortest list that falls within
+	 * the range of the view b, then intersect with the others */
+	const uint32_t *l = post + lists[0];
+	BUN lo = 0, hi = lists[1];
+	while (lo < hi && l[lo] < boff)
+		lo++;
+	while (hi > lo && l[hi - 1] >= boff + bcnt)
+		hi--;
+	if ((res = ma_alloc(ta, (hi - lo) * sizeof(uint32_t) + 1)) == NULL)
+		goto bailout;
+	n = hi - lo;
+	memcpy(res, l + lo, n * sizeof(uint32_t));
+	for (BUN j = 1; j < nlists && n > 0; j++)
+		n = TRGMintersect(res, n, post + lists[2 * j], lists[2 * j + 1]);
+
+	/* rows not covered by the index can all match */
+	BUN tail = boff + bcnt > ocnt ? boff + bcnt - (ocnt > boff ? ocnt : boff) : 0;
+	if ((r = COLnew(0, TYPE_oid, n + tail, TRANSIENT)) == NULL)
+		goto bailout;
+	oid *o = Tloc(r, 0);
+	for (BUN j = 0; j < n; j++)
+		o[j] = b->hseqbase + res[j] - boff;
+	for (BUN j = 0; j < tail; j++)
+		o[n + j] = b->hseqbase + bcnt - tail + j;
+	BATsetcount(r, n + tail);
+	r->tkey = true;
+	r->tsorted = true;
+	r->trevsorted = BATcount(r) <= 1;
+	r->tnil = false;
+	r->tnonil = true;
+	r = virtualize(r);
+	if (r && s) {
+		bn = BATintersectcand(r, s);
+		BBPreclaim(r);
+		r = bn;
+	}
+	TRC_DEBUG(ACCELERATOR, "TRGMselect(" ALGOBATFMT ",%s): " BUNFMT
+		  " trigram buckets, " BUNFMT " candidates, " BUNFMT
+		  " not indexed (" LLFMT " usec)\n", ALGOBATPAR(b), pat,
+		  nlists, n, tail, GDKusec() - t0);
+
+  bailout:
+	if (hp)
+		HEAPdecref(hp, false);
+	if (pb != b)
+		BBPunfix(pb->batCacheid);
+	ma_close(&ta_state);
+	if (r == NULL)
+		GDKclrerr();
+	return r;
+}
+
+void
+TRGMfree(BAT *b)
+{
+	if (b) {
+		Heap *hp;
+
+		MT_lock_set(&b->batIdxLock);
+		if ((hp = b->ttrigram) != NULL && hp != (Heap *) 1) {
+			if (GDKinmemory(b->theap->farmid) || !hp->hasfile) {
+				b->ttrigram = NULL;
+			} else {
+				b->ttrigram = (Heap *) 1;
+			}
+			HEAPdecref(hp, false);
+		}
+		MT_lock_unset(&b->batIdxLock);
+	}
+}
+
+void
+TRGMdestroy(BAT *b)
+{
+	if (b && b->ttrigram) {
+		Heap *hp;
+
+		MT_lock_set(&b->batIdxLock);
+		hp = b->ttrigram;
+		b->ttrigram = NULL;
+		MT_lock_unset(&b->batIdxLock);
+		if (hp == (Heap *) 1 || (hp != NULL && hp->hasfile))
+			GDKunlink(BBPselectfarm(b->batRole, b->ttype, trigramheap),
+				  BATDIR,
+				  BBP_physical(b->batCacheid),
+				  "ttrigram");
+		if (hp != NULL && hp != (Heap *) 1)
+			HEAPdecref(hp, false);
+	}
+}
@@ -76,6 +76,9 @@ dbl no_hash_select_fraction = NO_HASH_SELECT_FRACTION;           /* same here */
 /* if the hash chain is longer than this number, we delete the hash
  * rather than maintaining it in HASHdelete */
 BUN hash_destroy_chain_length = HASH_DESTROY_CHAIN_LENGTH;
+/* string BATs of at least this many rows get a prefix heap when they
+ * are used in a range select or merge join; 0 means never */
+BUN strprefix_minsize = 0;
 
 /*
  * @+ Monet configuration file
@@ -447,6 +450,8 @@ static ATOMIC_TYPE GDK_vm_cursize = ATOMIC_VAR_INIT(0);
 
 size_t _MT_pagesize = 0;	/* variable holding page size */
 size_t _MT_npages = 0;		/* variable holding memory size in pages */
+size_t _MT_l2cachesize = 0;	/* size of the (per core) level 2 cache */
+size_t _MT_l3cachesize = 0;	/* size of the (shared) last level cache */
 
 static lng programepoch;
 
@@ -480,6 +485,41 @@ MT_init(void)
 	if (_MT_pagesize <= 0)
 		_MT_pagesize = 4096;	/* default */
 
+#if defined(HAVE_SYSCONF) && defined(_SC_LEVEL2_CACHE_SIZE)
+	{
+		long size;
+
+		if ((size = sysconf(_SC_LEVEL2_CACHE_SIZE)) > 0)
+			_MT_l2cachesize = (size_t) size;
+# ifdef _SC_LEVEL3_CACHE_SIZE
+		if ((size = sysconf(_SC_LEVEL3_CACHE_SIZE)) > 0)
+			_MT_l3cachesize = (size_t) size;
+# endif
+	}
+#elif defined(BSD) && defined(HW_L2CACHESIZE)
+	{
+		uint64_t size = 0;
+		size_t len = sizeof(size);
+		int mib[2];
+
+		mib[0] = CTL_HW;
+		mib[1] = HW_L2CACHESIZE;
+		if (sysctl(mib, 2, &size, &len, NULL, 0) == 0)
+			_MT_l2cachesize = (size_t) size;
+# ifdef HW_L3CACHESIZE
+		size = 0;
+		len = sizeof(size);
+		mib[1] = HW_L3CACHESIZE;
+		if (sysctl(mib, 2, &size, &len, NULL, 0) == 0)
+			_MT_l3cachesize = (size_t) size;
+# endif
+	}
+#endif
+	if (_MT_l2cachesize == 0)
+		_MT_l2cachesize = 1 << 20;	/* default */
+	if (_MT_l3cachesize < _MT_l2cachesize)
+		_MT_l3cachesize = _MT_l2cachesize;
+
 #ifdef WIN32
 	{
 		MEMORYSTATUSEX memStatEx;
@@ -1168,8 +1208,12 @@ GDKinit(opt *set, int setlen, bool embedded, const char *caller_revision)
 #else
 	GDKL3_size = 16*1024*1024;
 #endif
-	if ((p = GDKgetenv("gdk_l3_size")) != NULL)
+	if ((p = GDKgetenv("gdk_l3_size")) != NULL) {
 		GDKL3_size = (BUN) strtoll(p, NULL, 10);
+		/* also what the optimizers size their partitions by */
+		if (GDKL3_size > 0)
+			_MT_l3cachesize = (size_t) GDKL3_size;
+	}
 
 	if (!GDKinmemory(0)) {
 		if ((p = GDKgetenv("gdk_dbpath")) != NULL &&
@@ -1259,6 +1303,9 @@ GDKinit(opt *set, int setlen, bool embedded, const char *caller_revision)
 		hash_destroy_chain_length = (BUN) strtoll(p, NULL, 10);
 	if (hash_destroy_chain_length == 0)
 		hash_destroy_chain_length = HASH_DESTROY_CHAIN_LENGTH;
+	strprefix_minsize = 0;
+	if ((p = GDKgetenv("strprefix_minsize")) != NULL)
+		strprefix_minsize = (BUN) strtoll(p, NULL, 10);
 
 	return GDK_SUCCEED;
 }
@@ -1267,6 +1314,38 @@ int GDKnr_threads = 0;
 BUN GDKL3_size = 0;
 static ATOMIC_TYPE GDKnrofthreads = ATOMIC_VAR_INIT(0);
 
+/* Call func for each of the n elements (of argsize bytes each) of the
+ * args array, each in a thread of its own.  The calling thread handles
+ * the first element, and any element for which no thread could be
+ * started.  Returns when all calls have finished. */
+void
+GDKparallel(void (*func)(void *), void *args, size_t argsize, int n, const char *name)
+{
+	MT_Id tids[THREADS];
+	char *a = args;
+	int started;
+	char *errbuf = GDKerrbuf;
+	size_t errlen = errbuf ? strlen(errbuf) : 0;
+
+	assert(n <= THREADS);
+	for (started = 1; started < n; started++) {
+		if (MT_create_thread(&tids[started], func, a + started * argsize,
+				     MT_THR_JOINABLE, name) < 0) {
+			/* not an error, we do the work ourselves; only
+			 * drop the message of the failed create, not
+			 * what the caller had pending */
+			if (errbuf)
+				errbuf[errlen] = 0;
+			break;
+		}
+	}
+	for (int i = started; i < n; i++)
+		func(a + i * argsize);
+	func(a);
+	for (int i = 1; i < started; i++)
+		MT_join_thread(tids[i]);
+}
+
 bool
 GDKexiting(void)
 {
@@ -1304,6 +1383,7 @@ GDKreset(int status)
 	}
 
 	join_detached_threads();
+	OIDXreset();
 
 	MT_lock_set(&GDKenvlock);
 	while (orig_value) {
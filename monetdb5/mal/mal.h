@@ -124,7 +124,9 @@ typedef struct VARRECORD {
 		cleanup:1,
 		initialized:1,
 		used:1,
-		disabled:1;
+		disabled:1,
+		sorted:1,				/* bound column is known to be sorted */
+		orderidx:1;				/* bound column has an ordered index */
 	short depth;				/* scope block depth, set to -1 if not used */
 	ValRecord value;
 	int declared;				/* pc index when it was first assigned */
@@ -248,6 +248,7 @@ MCinitClientRecord(Client c, oid user, bstream *fin, stream *fout)
 	strtcpy(c->optimizer, "default_pipe", sizeof(c->optimizer));
 	c->workerlimit = 0;
 	c->memorylimit = 0;
+	c->resgroup = NULL;
 	c->querytimeout = 0;
 	c->sessiontimeout = 0;
 	c->logical_sessiontimeout = 0;
@@ -269,6 +270,7 @@ MCinitClientRecord(Client c, oid user, bstream *fin, stream *fout)
 	c->protocol = PROTOCOL_9;
 
 	c->filetrans = false;
+	c->pooled = false;
 	c->handshake_options = NULL;
 	c->query = NULL;
 	c->ma = create_allocator("MA_Client", false);
@@ -363,6 +365,7 @@ MCcloseClient(Client c)
 	strtcpy(c->optimizer, "default_pipe", sizeof(c->optimizer));
 	c->workerlimit = 0;
 	c->memorylimit = 0;
+	c->resgroup = NULL;
 	c->querytimeout = 0;
 	c->qryctx.endtime = 0;
 	c->sessiontimeout = 0;
@@ -476,6 +479,63 @@ MCactiveClients(void)
 	return active;
 }
 
+/*
+ * A connection that is handed over to another user, e.g. by a
+ * connection pool in front of the server, starts with the session
+ * settings of a fresh connection.  The scenario state is reset by the
+ * caller, the streams and the MAL context stay.
+ */
+void
+MCresetSession(Client c)
+{
+	MT_lock_set(&mal_contextLock);
+	c->user = oid_nil;
+	if (c->username) {
+		ma_free(c->ma, c->username);
+		c->username = NULL;
+	}
+	if (c->client_hostname) {
+		ma_free(c->ma, (char *) c->client_hostname);
+		c->client_hostname = NULL;
+	}
+	if (c->client_application) {
+		ma_free(c->ma, (char *) c->client_application);
+		c->client_application = NULL;
+	}
+	if (c->client_library) {
+		ma_free(c->ma, (char *) c->client_library);
+		c->client_library = NULL;
+	}
+	if (c->client_remark) {
+		ma_free(c->ma, (char *) c->client_remark);
+		c->client_remark = NULL;
+	}
+	c->client_pid = 0;
+	if (c->handshake_options) {
+		ma_free(c->ma, c->handshake_options);
+		c->handshake_options = NULL;
+	}
+	strtcpy(c->optimizer, "default_pipe", sizeof(c->optimizer));
+	c->workerlimit = 0;
+	c->memorylimit = 0;
+	c->querytimeout = 0;
+	c->sessiontimeout = 0;
+	c->logical_sessiontimeout = 0;
+	c->idletimeout = 0;
+	c->qryctx.starttime = 0;
+	c->qryctx.endtime = 0;
+	c->qryctx.maxmem = 0;
+	c->maxmem = 0;
+	c->maxworkers = 0;
+	c->qryctx.oahash_enabled = default_oahash_enabled;
+	c->protocol = PROTOCOL_9;
+	c->filetrans = false;
+	c->idle = 0;
+	c->login = c->lastcmd = time(0);
+	c->session = GDKusec();
+	MT_lock_unset(&mal_contextLock);
+}
+
 str
 MCsuspendClient(int id)
 {
@@ -81,6 +81,7 @@ typedef struct CLIENT {
 	lng idletimeout;			/* idle in active transaction timeout */
 	lng querytimeout;			/* timeout per query in usec, 0 = no limit */
 	QryCtx qryctx;				/* per query limitations */
+	struct RESGROUP *resgroup;	/* resource group the running query is admitted to */
 
 	time_t login;				/* Time when this session started */
 	lng session;				/* usec since start of server */
@@ -179,6 +180,7 @@ typedef struct CLIENT {
 	size_t blocksize;
 	protocol_version protocol;
 	bool filetrans;				/* whether the client can read files for us */
+	bool pooled;				/* monetdbd may log in another user, see Xreauth */
 	char *handshake_options;
 	char *query;				/* string, identify whatever we're working on */
 } *Client, ClientRec;
@@ -192,6 +194,7 @@ mal_export Client MCinitClient(oid user, bstream *fin, stream *fout);
 mal_export void MCstopClients(Client c);
 mal_export int MCactiveClients(void);
 mal_export void MCcloseClient(Client c);
+mal_export void MCresetSession(Client c);
 mal_export str MCsuspendClient(int id);
 mal_export str MCawakeClient(int id);
 mal_export int MCpushClientInput(Client c, bstream *new_input, int listing,
@@ -501,6 +501,8 @@ setVariableType(MalBlkPtr mb, const int n, malType type)
 	assert(n >= 0 && n < mb->vtop);
 	setVarType(mb, n, type);
 	setRowCnt(mb, n, 0);
+	clrVarSorted(mb, n);
+	clrVarOrderIdx(mb, n);
 	clrVarFixed(mb, n);
 	clrVarUsed(mb, n);
 	clrVarInit(mb, n);
@@ -623,6 +625,8 @@ clearVariable(MalBlkPtr mb, int varid)
 	v->cleanup = 0;
 	v->initialized = 0;
 	v->used = 0;
+	v->sorted = 0;
+	v->orderidx = 0;
 	v->rowcnt = 0;
 	v->eolife = 0;
 	v->stc = 0;
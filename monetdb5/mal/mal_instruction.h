@@ -126,6 +126,13 @@ mal_export char *getVarNameIntoBuffer(MalBlkPtr mb, int idx, char *buf)
 #define setRowCnt(M,I,C)	((M)->var[I].rowcnt = (C))
 #define getRowCnt(M,I)		((M)->var[I].rowcnt)
 
+#define clrVarSorted(M,I)	((M)->var[I].sorted = 0)
+#define setVarSorted(M,I)	((M)->var[I].sorted = 1)
+#define isVarSorted(M,I)	((M)->var[I].sorted)
+#define clrVarOrderIdx(M,I)	((M)->var[I].orderidx = 0)
+#define setVarOrderIdx(M,I)	((M)->var[I].orderidx = 1)
+#define isVarOrderIdx(M,I)	((M)->var[I].orderidx)
+
 #define getVarSTC(M,I)		((M)->var[I].stc)
 
 #define getDestVar(P)		((P)->argv[0])
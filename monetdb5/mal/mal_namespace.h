@@ -33,12 +33,14 @@
 	FUNC(bat); \
 	FUNC(batalgebra); \
 	FUNC(batcalc); \
+	FUNC(batjson); \
 	FUNC(batmal); \
 	FUNC(batmkey); \
 	FUNC(batmmath); \
 	FUNC(batmtime); \
 	FUNC(batsql); \
 	FUNC(batstr); \
+	FUNC(battxtsim); \
 	FUNC(bbp); \
 	FUNC(between); \
 	FUNC(bind); \
@@ -106,10 +108,16 @@
 	FUNC(exportOperation); \
 	FUNC(export_table); \
 	FUNC(fetch); \
+	FUNC(filter); \
+	FUNC(filterinteger); \
+	FUNC(filternumber); \
+	FUNC(filtertext); \
 	FUNC(find); \
 	FUNC(firstn); \
 	FUNC(first_value); \
 	FUNC(for); \
+	FUNC(fsst); \
+	FUNC(fulltextscore); \
 	FUNC(generator); \
 	FUNC(get); \
 	FUNC(getVariable); \
@@ -132,12 +140,14 @@
 	FUNC(importRaw); \
 	FUNC(ilockedaggr); \
 	FUNC(int); \
+	FUNC(integer); \
 	FUNC(intersect); \
 	FUNC(intersectcand); \
 	FUNC(io); \
 	FUNC(iterator); \
 	FUNC(join); \
 	FUNC(json); \
+	FUNC(jsonpath); \
 	FUNC(lag); \
 	FUNC(language); \
 	FUNC(last_value); \
@@ -182,6 +192,7 @@
 	FUNC(nth_slice); \
 	FUNC(nth_value); \
 	FUNC(ntile); \
+	FUNC(number); \
 	FUNC(optimizer); \
 	FUNC(outercrossproduct); \
 	FUNC(outerjoin); \
@@ -193,6 +204,7 @@
 	FUNC(percent_rank); \
 	FUNC(pipelines); \
 	FUNC(predicate); \
+	FUNC(prefixselect); \
 	FUNC(print); \
 	FUNC(prod); \
 	FUNC(profiler); \
@@ -217,6 +229,7 @@
 	FUNC(renumber); \
 	FUNC(replace); \
 	FUNC(resultSet); \
+	FUNC(resultStream); \
 	FUNC(revoke); \
 	FUNC(revoke_function); \
 	FUNC(revoke_roles); \
@@ -259,6 +272,7 @@
 	FUNC(subuniform); \
 	FUNC(sum); \
 	FUNC(take); \
+	FUNC(text); \
 	FUNC(thetajoin); \
 	FUNC(thetaselect); \
 	FUNC(tid); \
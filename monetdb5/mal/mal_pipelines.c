@@ -352,7 +352,7 @@ runMALpipelines(Client cntxt, MalBlkPtr mb, int startpc, int stoppc, int maxpart
 
 		for(int i = s->start; i<s->stop; i++) {
 			InstrPtr pci = mb->stmt[i];
-			sqlProfilerEvent(cntxt, mb, stk, pci, clk, pci->ticks);
+			sqlProfilerEvent(cntxt, mb, stk, pci, clk, pci->ticks, NULL);
 		}
 	}
 	GDKfree(s);
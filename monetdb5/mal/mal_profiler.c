@@ -43,6 +43,9 @@
 
 static struct timeval startup_time;
 
+/* collect hardware performance counters in the trace events */
+bool profilerHWCounters = false;
+
 #define LOGLEN 8192
 
 /*
@@ -138,9 +141,17 @@ static str phase_descriptions[] = {
 	[CONFLICT] = "trans_conflict"
 };
 
+static const char *hwcounter_names[MT_HW_COUNTERS] = {
+	[MT_HW_CYCLES] = "cycles",
+	[MT_HW_INSTRUCTIONS] = "instructions",
+	[MT_HW_LLC_MISSES] = "llc_misses",
+	[MT_HW_BRANCH_MISSES] = "branch_misses",
+	[MT_HW_DTLB_MISSES] = "dtlb_misses",
+};
+
 static str
 prepareMalEvent(allocator *ma, Client cntxt, MalBlkPtr mb, MalStkPtr stk,
-				InstrPtr pci, lng clk, lng ticks)
+				InstrPtr pci, lng clk, lng ticks, const int64_t *counters)
 {
 	struct logbuf logbuf = {.ma = ma};
 	uint64_t mclk;
@@ -180,6 +191,12 @@ prepareMalEvent(allocator *ma, Client cntxt, MalBlkPtr mb, MalStkPtr stk,
 		goto cleanup_and_exit;
 	if (algo && !logadd(&logbuf, ",\"algorithm\":\"%s\"", algo))
 		goto cleanup_and_exit;
+	for (int i = 0; counters && i < MT_HW_COUNTERS; i++) {
+		if (counters[i] >= 0
+			&& !logadd(&logbuf, ",\"%s\":%" PRId64, hwcounter_names[i],
+					   counters[i]))
+			goto cleanup_and_exit;
+	}
 	if (!logadd(&logbuf, "}\n"))	// end marker
 		goto cleanup_and_exit;
 	return logbuf.logbuffer;
@@ -368,7 +385,7 @@ clearTrace(Client cntxt)
 
 void
 sqlProfilerEvent(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci,
-				 lng clk, lng ticks)
+				 lng clk, lng ticks, const int64_t *counters)
 {
 	str stmt, c, ev;
 
@@ -387,7 +404,7 @@ sqlProfilerEvent(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci,
 	allocator *ta = MT_thread_getallocator();
 	allocator_state ta_state = ma_open(ta);
 
-	ev = prepareMalEvent(ta, cntxt, mb, stk, pci, clk, ticks);
+	ev = prepareMalEvent(ta, cntxt, mb, stk, pci, clk, ticks, counters);
 	// keep it a short transaction
 	MT_lock_set(&mal_profileLock);
 	if (cntxt->profticks == NULL) {
@@ -460,4 +477,5 @@ void
 initProfiler(void)
 {
 	gettimeofday(&startup_time, NULL);
+	profilerHWCounters = GDKgetenv_istrue("profiler_hwcounters");
 }
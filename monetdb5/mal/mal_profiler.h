@@ -54,6 +54,7 @@ mal_export int TRACEtable(Client cntxt, BAT **r);
 
 #ifdef LIBMONETDB5
 /* only available in monetdb5 */
+extern bool profilerHWCounters;
 extern void initProfiler(void);
 
 extern void MPresetProfiler(stream *fdout);
@@ -21,13 +21,369 @@
 static lng memorypool = 0;		/* memory claimed by concurrent threads */
 
 static MT_Lock admissionLock = MT_LOCK_INITIALIZER(admissionLock);
+static MT_Cond admissionCond = MT_COND_INITIALIZER(admissionCond);
+
+/*
+ * Resource groups divide the server between classes of users.
+ * Users and roles are assigned to a group, which has a weight, a number
+ * of query slots and a memory budget. A query of a group with all its
+ * slots in use waits in the queue of the group until an earlier query
+ * finishes. The queries admitted share the worker threads in proportion
+ * to the weight of their group among the groups with running queries,
+ * and their instructions are delayed when the memory claimed by the
+ * group exceeds its budget.
+ * The groups are protected by the admissionLock, queries waiting for
+ * admission are woken through the admissionCond. The SQL layer keeps the
+ * definitions in the catalog and recreates them when the server starts.
+ */
+typedef struct RESWAITER {
+	Client cntxt;
+	struct RESWAITER *next;
+} *ResWaiter;
+
+typedef struct RESMEMBER {
+	char *name;					/* user or role */
+	ResGroup group;
+	struct RESMEMBER *next;
+} *ResMember;
+
+static ResGroup resgroups = NULL;	/* the active groups */
+static ResGroup resdropped = NULL;	/* dropped, but maybe still referenced */
+static ResMember resmembers = NULL;
+static int resweight = 0;		/* total weight of the groups running queries */
+
+static void
+resgroup_free(ResGroup g)
+{
+	GDKfree(g->name);
+	GDKfree(g);
+}
 
 void
 mal_resource_reset(void)
 {
 	MT_lock_set(&admissionLock);
 	memorypool = (lng) MEMORY_THRESHOLD;
+	while (resmembers) {
+		ResMember m = resmembers;
+		resmembers = m->next;
+		GDKfree(m->name);
+		GDKfree(m);
+	}
+	while (resgroups) {
+		ResGroup g = resgroups;
+		resgroups = g->next;
+		resgroup_free(g);
+	}
+	while (resdropped) {
+		ResGroup g = resdropped;
+		resdropped = g->next;
+		resgroup_free(g);
+	}
+	resweight = 0;
+	MT_lock_unset(&admissionLock);
+}
+
+static ResGroup
+resgroup_find(const char *name)
+{
+	for (ResGroup g = resgroups; g; g = g->next)
+		if (strcmp(g->name, name) == 0)
+			return g;
+	return NULL;
+}
+
+/* Create a resource group or change the settings of an existing one */
+str
+MALresgroup_create(const char *name, int weight, int slots, lng memory)
+{
+	ResGroup g;
+
+	if (weight < 1 || weight > 1000)
+		throw(MAL, "sysmon.create_resource_group", SQLSTATE(42000) "Weight must be between 1 and 1000");
+	if (slots < 0)
+		throw(MAL, "sysmon.create_resource_group", SQLSTATE(42000) "Number of slots cannot be negative");
+	if (memory < 0)
+		throw(MAL, "sysmon.create_resource_group", SQLSTATE(42000) "Memory budget cannot be negative");
+	MT_lock_set(&admissionLock);
+	if ((g = resgroup_find(name)) == NULL) {
+		if ((g = GDKzalloc(sizeof(struct RESGROUP))) == NULL ||
+			(g->name = GDKstrdup(name)) == NULL) {
+			GDKfree(g);
+			MT_lock_unset(&admissionLock);
+			throw(MAL, "sysmon.create_resource_group", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		}
+		g->next = resgroups;
+		resgroups = g;
+	} else if (g->running > 0) {
+		resweight += weight - g->weight;
+	}
+	g->weight = weight;
+	g->slots = slots;
+	g->memory = memory;
+	/* more slots may have become available */
+	MT_cond_broadcast(&admissionCond);
+	MT_lock_unset(&admissionLock);
+	return MAL_SUCCEED;
+}
+
+/* Drop a resource group, its running queries continue without limits
+ * and its waiting queries are admitted */
+str
+MALresgroup_drop(const char *name)
+{
+	MT_lock_set(&admissionLock);
+	for (ResGroup *gp = &resgroups; *gp; gp = &(*gp)->next) {
+		ResGroup g = *gp;
+
+		if (strcmp(g->name, name) == 0) {
+			*gp = g->next;
+			for (ResMember *mp = &resmembers; *mp;) {
+				ResMember m = *mp;
+				if (m->group == g) {
+					*mp = m->next;
+					GDKfree(m->name);
+					GDKfree(m);
+				} else {
+					mp = &m->next;
+				}
+			}
+			if (g->running > 0)
+				resweight -= g->weight;
+			g->dropped = true;
+			/* the waiters leave the queue themselves, they find the
+			 * group dropped when they wake up */
+			g->queue = NULL;
+			g->queued = 0;
+			g->next = resdropped;
+			resdropped = g;
+			MT_cond_broadcast(&admissionCond);
+			MT_lock_unset(&admissionLock);
+			return MAL_SUCCEED;
+		}
+	}
+	MT_lock_unset(&admissionLock);
+	throw(MAL, "sysmon.drop_resource_group", SQLSTATE(42000) "Resource group '%s' does not exist", name);
+}
+
+/* Assign a user or role to a resource group, or remove the assignment
+ * if group is NULL */
+str
+MALresgroup_assign(const char *member, const char *group)
+{
+	ResGroup g = NULL;
+	ResMember m, *mp;
+
+	MT_lock_set(&admissionLock);
+	if (group && (g = resgroup_find(group)) == NULL) {
+		MT_lock_unset(&admissionLock);
+		throw(MAL, "sysmon.assign_resource_group", SQLSTATE(42000) "Resource group '%s' does not exist", group);
+	}
+	for (mp = &resmembers; *mp; mp = &(*mp)->next)
+		if (strcmp((*mp)->name, member) == 0)
+			break;
+	if ((m = *mp) != NULL) {
+		if (g) {
+			m->group = g;
+		} else {
+			*mp = m->next;
+			GDKfree(m->name);
+			GDKfree(m);
+		}
+	} else if (g) {
+		if ((m = GDKmalloc(sizeof(struct RESMEMBER))) == NULL ||
+			(m->name = GDKstrdup(member)) == NULL) {
+			GDKfree(m);
+			MT_lock_unset(&admissionLock);
+			throw(MAL, "sysmon.assign_resource_group", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		}
+		m->group = g;
+		m->next = resmembers;
+		resmembers = m;
+	}
 	MT_lock_unset(&admissionLock);
+	return MAL_SUCCEED;
+}
+
+/* the number of worker threads a query of the group may use */
+static int
+resgroup_workers(ResGroup g)
+{
+	int total = resweight > 0 ? resweight : g->weight;
+	int share = (int) (((lng) GDKnr_threads * g->weight + total - 1) / total);
+
+	if (g->running > 1)
+		share = (share + g->running - 1) / g->running;
+	return share > 0 ? share : 1;
+}
+
+/*
+ * Admit a query of the client to the resource group of the user, or else
+ * of the role. If the group is saturated, the query waits in the queue of
+ * the group, in order of arrival, until it can be admitted or its time is
+ * up. Nested queries of an admitted client are not counted again.
+ */
+static void
+resgroup_unqueue(ResGroup g, ResWaiter w)
+{
+	for (ResWaiter *wp = &g->queue; *wp; wp = &(*wp)->next) {
+		if (*wp == w) {
+			*wp = w->next;
+			g->queued--;
+			break;
+		}
+	}
+	/* the next in line may be admissible now */
+	if (g->queue)
+		MT_cond_broadcast(&admissionCond);
+}
+
+str
+MALresgroup_enter(Client cntxt, const char *role, bool *admitted)
+{
+	ResGroup g = NULL;
+	struct RESWAITER w = { .cntxt = cntxt };
+	lng t0, now;
+
+	*admitted = false;
+	if (cntxt->resgroup)
+		return MAL_SUCCEED;
+	MT_lock_set(&admissionLock);
+	for (ResMember m = resmembers; m && !g; m = m->next)
+		if (cntxt->username && strcmp(m->name, cntxt->username) == 0)
+			g = m->group;
+	for (ResMember m = resmembers; m && !g; m = m->next)
+		if (role && strcmp(m->name, role) == 0)
+			g = m->group;
+	if (g == NULL) {
+		MT_lock_unset(&admissionLock);
+		return MAL_SUCCEED;
+	}
+	/* join the end of the queue */
+	ResWaiter *wp = &g->queue;
+	while (*wp)
+		wp = &(*wp)->next;
+	*wp = &w;
+	g->queued++;
+	t0 = GDKusec();
+	for (;;) {
+		int ms = 1000;
+
+		if (g->dropped) {
+			/* the queue was emptied by MALresgroup_drop */
+			MT_lock_unset(&admissionLock);
+			return MAL_SUCCEED;
+		}
+		if (g->queue == &w &&
+			(g->slots == 0 || g->running < g->slots) &&
+			(g->memory == 0 || g->running == 0 || g->claimed < g->memory))
+			break;
+		now = GDKusec();
+		if (cntxt->qryctx.endtime && now >= cntxt->qryctx.endtime) {
+			resgroup_unqueue(g, &w);
+			MT_lock_unset(&admissionLock);
+			throw(MAL, "mal.admission", SQLSTATE(HYT00) RUNTIME_QRY_TIMEOUT);
+		}
+		if (GDKexiting()) {
+			resgroup_unqueue(g, &w);
+			MT_lock_unset(&admissionLock);
+			throw(MAL, "mal.admission", SQLSTATE(HYT00) "Server is shutting down");
+		}
+		/* wake up in time for the query timeout, and now and then
+		 * to see whether the server is shutting down */
+		if (cntxt->qryctx.endtime && (cntxt->qryctx.endtime - now) / 1000 < ms)
+			ms = (int) ((cntxt->qryctx.endtime - now) / 1000) + 1;
+		MT_cond_timedwait(&admissionCond, &admissionLock, ms);
+	}
+	resgroup_unqueue(g, &w);
+	if (g->running++ == 0)
+		resweight += g->weight;
+	g->admitted++;
+	g->waited += GDKusec() - t0;
+	cntxt->resgroup = g;
+	*admitted = true;
+	MT_lock_unset(&admissionLock);
+	return MAL_SUCCEED;
+}
+
+void
+MALresgroup_leave(Client cntxt)
+{
+	ResGroup g = cntxt->resgroup;
+
+	if (g == NULL)
+		return;
+	MT_lock_set(&admissionLock);
+	if (--g->running == 0 && !g->dropped)
+		resweight -= g->weight;
+	cntxt->resgroup = NULL;
+	if (g->queue)
+		MT_cond_broadcast(&admissionCond);
+	MT_lock_unset(&admissionLock);
+}
+
+/* Copy the state of the groups and the assignments, for inspection */
+int
+MALresgroup_list(struct RESGROUP **groups, char ***members, char ***membergroups, int *nmembers)
+{
+	int n = 0, i;
+
+	*groups = NULL;
+	*members = *membergroups = NULL;
+	*nmembers = 0;
+	MT_lock_set(&admissionLock);
+	for (ResGroup g = resgroups; g; g = g->next)
+		n++;
+	for (ResMember m = resmembers; m; m = m->next)
+		(*nmembers)++;
+	if ((n > 0 && (*groups = GDKzalloc(n * sizeof(struct RESGROUP))) == NULL) ||
+		(*nmembers > 0 && ((*members = GDKzalloc(*nmembers * sizeof(char *))) == NULL ||
+						   (*membergroups = GDKzalloc(*nmembers * sizeof(char *))) == NULL))) {
+		MT_lock_unset(&admissionLock);
+		goto bailout;
+	}
+	i = 0;
+	for (ResGroup g = resgroups; g; g = g->next, i++) {
+		(*groups)[i] = *g;
+		(*groups)[i].workers = g->running > 0 ? resgroup_workers(g) : 0;
+		(*groups)[i].queue = NULL;
+		(*groups)[i].next = NULL;
+		if (((*groups)[i].name = GDKstrdup(g->name)) == NULL) {
+			MT_lock_unset(&admissionLock);
+			goto bailout;
+		}
+	}
+	i = 0;
+	for (ResMember m = resmembers; m; m = m->next, i++)
+		if (((*members)[i] = GDKstrdup(m->name)) == NULL ||
+			((*membergroups)[i] = GDKstrdup(m->group->name)) == NULL) {
+			MT_lock_unset(&admissionLock);
+			goto bailout;
+		}
+	MT_lock_unset(&admissionLock);
+	return n;
+
+  bailout:
+	MALresgroup_list_free(*groups, n, *members, *membergroups, *nmembers);
+	*groups = NULL;
+	*members = *membergroups = NULL;
+	*nmembers = 0;
+	return -1;
+}
+
+void
+MALresgroup_list_free(struct RESGROUP *groups, int ngroups, char **members, char **membergroups, int nmembers)
+{
+	for (int i = 0; groups && i < ngroups; i++)
+		GDKfree(groups[i].name);
+	GDKfree(groups);
+	for (int i = 0; members && i < nmembers; i++) {
+		GDKfree(members[i]);
+		if (membergroups)
+			GDKfree(membergroups[i]);
+	}
+	GDKfree(members);
+	GDKfree(membergroups);
 }
 
 /*
@@ -126,10 +482,25 @@ MALadmission_claim(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci,
 		&& (int) ATOMIC_GET(&cntxt->workers) >= cntxt->workerlimit)
 		return false;
 
-	if (argclaim == 0)
+	MT_lock_set(&admissionLock);
+	/* the queries of a resource group get their share of the worker
+	 * threads, and together stay within the memory budget of the
+	 * group */
+	ResGroup g = cntxt->resgroup;
+	if (g && (int) ATOMIC_GET(&cntxt->workers) >= resgroup_workers(g)) {
+		MT_lock_unset(&admissionLock);
+		return false;
+	}
+	if (argclaim == 0) {
+		MT_lock_unset(&admissionLock);
 		return true;
+	}
+	if (g && g->memory > 0 && g->claimed + argclaim > g->memory
+		&& ATOMIC_GET(&cntxt->workers) > 0) {
+		MT_lock_unset(&admissionLock);
+		return false;
+	}
 
-	MT_lock_set(&admissionLock);
 	/* Determine if the total memory resource is exhausted, because it is overall limitation.  */
 	if (memorypool <= 0) {
 		// we accidentally released too much memory or need to initialize
@@ -151,6 +522,8 @@ MALadmission_claim(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci,
 		}
 		memorypool -= argclaim;
 		stk->memory += argclaim;
+		if (g)
+			g->claimed += argclaim;
 		MT_lock_set(&mal_delayLock);
 		if (mb->memory < stk->memory)
 			mb->memory = stk->memory;
@@ -181,6 +554,13 @@ MALadmission_release(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci,
 	if (memorypool > (lng) MEMORY_THRESHOLD) {
 		memorypool = (lng) MEMORY_THRESHOLD;
 	}
+	if (cntxt->resgroup) {
+		cntxt->resgroup->claimed -= argclaim;
+		if (cntxt->resgroup->claimed < 0)
+			cntxt->resgroup->claimed = 0;
+		if (cntxt->resgroup->queue)
+			MT_cond_broadcast(&admissionCond);
+	}
 	stk->memory -= argclaim;
 	MT_lock_unset(&admissionLock);
 	return;
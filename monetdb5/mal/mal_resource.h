@@ -18,6 +18,31 @@
 #define heapinfo(X,Id)	((X) ? (X)->free : 0)
 #define hashinfo(X,Id) ((X) && (X) != (Hash *) 1 ? heapinfo(&(X)->heaplink, Id) + heapinfo(&(X)->heapbckt, Id) : 0)
 
+/* a resource group, see mal_resource.c */
+typedef struct RESGROUP {
+	char *name;
+	int weight;					/* share of the worker threads */
+	int slots;					/* number of concurrent queries, 0 is unlimited */
+	lng memory;					/* memory budget in bytes, 0 is unlimited */
+	int running;				/* queries admitted */
+	int queued;					/* queries waiting for admission */
+	int workers;				/* worker threads per query, set by MALresgroup_list */
+	lng claimed;				/* memory claimed by the running queries */
+	lng admitted;				/* number of queries admitted so far */
+	lng waited;					/* usec spent waiting for admission so far */
+	bool dropped;
+	struct RESWAITER *queue;
+	struct RESGROUP *next;
+} *ResGroup;
+
+mal_export str MALresgroup_create(const char *name, int weight, int slots, lng memory);
+mal_export str MALresgroup_drop(const char *name);
+mal_export str MALresgroup_assign(const char *member, const char *group);
+mal_export str MALresgroup_enter(Client cntxt, const char *role, bool *admitted);
+mal_export void MALresgroup_leave(Client cntxt);
+mal_export int MALresgroup_list(struct RESGROUP **groups, char ***members, char ***membergroups, int *nmembers);
+mal_export void MALresgroup_list_free(struct RESGROUP *groups, int ngroups, char **members, char **membergroups, int nmembers);
+
 #ifdef LIBMONETDB5
 #define LONGRUNNING  (60 * 1000 * 1000)	/* usec , 60 seconds high priority */
 #define TIMESLICE  (3 * 1000 * 1000)	/* usec , 3 seconds high priority */
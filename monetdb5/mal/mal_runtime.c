@@ -367,6 +367,9 @@ runtimeProfileBegin(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci,
 			break;
 		}
 	}
+	/* hardware counters are only collected for tracing, when asked for */
+	prof->hwcounters = cntxt->sqlprofiler && profilerHWCounters
+		&& MT_thread_hwcounters(prof->counters);
 	prof->ticks = GDKusec();
 }
 
@@ -405,6 +408,16 @@ runtimeProfileExit(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci,
 			}
 		}
 	}
-	if (cntxt->sqlprofiler)
-		sqlProfilerEvent(cntxt, mb, stk, pci, ticks, ticks - prof->ticks);
+	if (cntxt->sqlprofiler) {
+		int64_t counters[MT_HW_COUNTERS];
+
+		if (prof->hwcounters && MT_thread_hwcounters(counters)) {
+			for (int i = 0; i < MT_HW_COUNTERS; i++)
+				counters[i] = counters[i] < 0 || prof->counters[i] < 0 ? -1 : counters[i] - prof->counters[i];
+		} else {
+			prof->hwcounters = false;
+		}
+		sqlProfilerEvent(cntxt, mb, stk, pci, ticks, ticks - prof->ticks,
+						 prof->hwcounters ? counters : NULL);
+	}
 }
@@ -25,6 +25,8 @@
 */
 typedef struct {
 	lng ticks;					/* at start of this profile interval */
+	bool hwcounters;			/* counters were read at the start */
+	int64_t counters[MT_HW_COUNTERS];	/* hardware counters at the start */
 } *RuntimeProfile, RuntimeProfileRecord;
 
 /* The actual running queries are assembled in a queue
@@ -66,7 +68,8 @@ extern void runtimeProfileBegin(Client cntxt, MalBlkPtr mb, MalStkPtr stk,
 extern void runtimeProfileExit(Client cntxt, MalBlkPtr mb, MalStkPtr stk,
 							   InstrPtr pci, RuntimeProfile prof);
 extern void sqlProfilerEvent(Client cntxt, MalBlkPtr mb, MalStkPtr stk,
-							 InstrPtr pci, lng clk, lng ticks);
+							 InstrPtr pci, lng clk, lng ticks,
+							 const int64_t *counters);
 
 extern QueryQueue QRYqueue;
 extern UserStats USRstats;
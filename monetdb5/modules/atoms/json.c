@@ -721,9 +721,8 @@ typedef struct {
 } pattern;
 
 static str
-JSONcompile(Client ctx, const char *expr, pattern terms[])
+JSONcompile(allocator *ma, const char *expr, pattern terms[])
 {
-	allocator *ma = ctx->curprg->def->ma;
 	int t = 0;
 	const char *s, *beg;
 
@@ -946,36 +945,220 @@ JSONmatch(allocator *ma, JSON *jt, int ji, const pattern *terms, int ti, bool ac
 	return res;
 }
 
+/*
+ * Path extraction without building a JSON tree.
+ *
+ * Values of type json are stored validated and normalized (see
+ * JSONstr2json_intern), so for the common path expressions that only
+ * consist of named steps and array indexes the stored text can be
+ * navigated directly: values that are not on the path are skipped by
+ * tracking nesting and strings, no JSON tree is built.  Anything out
+ * of the ordinary makes the scanner give up and the caller falls
+ * back to JSONparse and JSONmatch.
+ */
+
+#define JSON_FALLBACK	((str) -3)
+
+/* can the path expression be handled by JSONscanmatch? */
+static bool
+JSONsimplepath(const pattern *terms)
+{
+	for (int i = 0; i < MAXTERMS && terms[i].token; i++) {
+		switch (terms[i].token) {
+		case ROOT_STEP:
+		case END_STEP:
+			break;
+		case CHILD_STEP:
+			if (terms[i].name
+				? terms[i].name[0] == '*' || terms[i].index != INT_MAX
+				: terms[i].index == INT_MAX)
+				return false;
+			break;
+		default:
+			return false;
+		}
+	}
+	return true;
+}
+
+/* return the end of the (valid) JSON value that starts at j, or NULL */
+static const char *
+JSONskip(const char *j)
+{
+	int depth = 0;
+
+	switch (*j) {
+	case '"':
+		for (j++; *j != '"'; j++) {
+			if (*j == 0 || (*j == '\\' && *++j == 0))
+				return NULL;
+		}
+		return j + 1;
+	case '{':
+	case '[':
+		do {
+			switch (*j++) {
+			case '{':
+			case '[':
+				depth++;
+				break;
+			case '}':
+			case ']':
+				depth--;
+				break;
+			case '"':
+				for (; *j != '"'; j++) {
+					if (*j == 0 || (*j == '\\' && *++j == 0))
+						return NULL;
+				}
+				j++;
+				break;
+			case 0:
+				return NULL;
+			}
+		} while (depth > 0);
+		return j;
+	default: {
+		const char *s = j;
+		while (*j && *j != ',' && *j != '}' && *j != ']' &&
+			   *j != ' ' && *j != '\n' && *j != '\t' && *j != '\r')
+			j++;
+		return j == s ? NULL : j;
+	}
+	}
+}
+
 static str
-JSONfilterInternal(Client ctx, json *ret, const json *js, const char *const *expr, const char *other)
+JSONscanvalue(allocator *ma, const char *j, const char *e)
+{
+	str r = ma_strndup(ma, j, e - j);
+	return r ? r : (str) -1;
+}
+
+/* the JSONmatch equivalent for JSONsimplepath expressions on the
+ * value at j; returns NULL on no match, (str) -1 on allocation
+ * failure, (str) -2 on stack overflow, and JSON_FALLBACK if the value
+ * is not as expected */
+static str
+JSONscanmatch(allocator *ma, const char *j, const pattern *terms, int ti)
+{
+	const char *e;
+	str res = NULL;
+	int cnt;
+
+	if (THRhighwater())
+		return (str) -2;
+	if (ti >= MAXTERMS)
+		return NULL;
+	skipblancs(j);
+	if (terms[ti].token == ROOT_STEP) {
+		if (ti + 1 == MAXTERMS)
+			return NULL;
+		if (terms[ti + 1].token == END_STEP) {
+			if ((e = JSONskip(j)) == NULL)
+				return JSON_FALLBACK;
+			return JSONscanvalue(ma, j, e);
+		}
+		ti++;
+	}
+	if (ti + 1 == MAXTERMS)
+		return NULL;
+
+	switch (*j) {
+	case '[':
+		if (terms[ti].name != NULL)
+			return NULL;
+		j++;
+		skipblancs(j);
+		for (cnt = 0; *j != ']'; cnt++) {
+			if ((e = JSONskip(j)) == NULL)
+				return JSON_FALLBACK;
+			if (cnt == terms[ti].index) {
+				if (terms[ti + 1].token == END_STEP)
+					return JSONscanvalue(ma, j, e);
+				if (*j != '{' && *j != '[')
+					return JSON_FALLBACK; /* JSONmatch oddity */
+				return JSONscanmatch(ma, j, terms, ti + 1);
+			}
+			j = e;
+			skipblancs(j);
+			if (*j == ',') {
+				j++;
+				skipblancs(j);
+			} else if (*j != ']')
+				return JSON_FALLBACK;
+		}
+		return NULL;
+	case '{':
+		if (terms[ti].name == NULL)
+			return JSON_FALLBACK; /* index into an object */
+		j++;
+		skipblancs(j);
+		while (*j != '}') {
+			const char *k = j + 1;
+			if (*j != '"' || (e = JSONskip(j)) == NULL)
+				return JSON_FALLBACK;
+			size_t klen = e - k - 1;
+			j = e;
+			skipblancs(j);
+			if (*j++ != ':')
+				return JSON_FALLBACK;
+			skipblancs(j);
+			if ((e = JSONskip(j)) == NULL)
+				return JSON_FALLBACK;
+			if (klen == terms[ti].namelen &&
+				strncmp(k, terms[ti].name, klen) == 0) {
+				/* on duplicate keys the last one wins, as in
+				 * JSONtoken */
+				if (terms[ti + 1].token == END_STEP)
+					res = JSONscanvalue(ma, j, e);
+				else
+					res = JSONscanmatch(ma, j, terms, ti + 1);
+				if (res == (str) -1 || res == (str) -2 || res == JSON_FALLBACK)
+					return res;
+			}
+			j = e;
+			skipblancs(j);
+			if (*j == ',') {
+				j++;
+				skipblancs(j);
+			} else if (*j != '}')
+				return JSON_FALLBACK;
+		}
+		return res;
+	default:
+		return NULL;
+	}
+}
+
+/* apply the compiled path expression to the (not nil) document j,
+ * the result is allocated with ma */
+static str
+JSONfilterpath(allocator *ma, json *ret, const char *j, const pattern *terms)
 {
-	allocator *ma = ctx->curprg->def->ma;
 	allocator *ta = MT_thread_getallocator();
 	assert(ta);
-	pattern terms[MAXTERMS];
 	int tidx = 0;
-	JSON *jt;
-	str j = *js, msg = MAL_SUCCEED, s;
+	JSON *jt = NULL;
+	str msg = MAL_SUCCEED, s;
 	json result = 0;
 	size_t l;
 
-	(void) other;
-	if (strNil(j)) {
-		*ret = ma_strdup(ma, j);
-		if (*ret == NULL)
-			throw(MAL, "JSONfilterInternal", SQLSTATE(HY013) MAL_MALLOC_FAIL);
-		return MAL_SUCCEED;
-	}
 	allocator_state ta_state = ma_open(ta);
-	jt = JSONparse(ta, j);
-	CHECK_JSON(jt);
-	memset(terms, 0, sizeof(terms));
-	msg = JSONcompile(ctx, *expr, terms);
-	if (msg)
-		goto bailout;
+	bool scan = JSONsimplepath(terms);
+  restart:
+	if (!scan) {
+		jt = JSONparse(ta, j);
+		CHECK_JSON(jt);
+	}
 
+	tidx = 0;
 	bool accumulate = terms[tidx].token == ANY_STEP || (terms[tidx].name && terms[tidx].name[0] == '*');
-	s = JSONmatch(ma, jt, 0, terms, tidx, accumulate);
+	s = scan ? JSONscanmatch(ma, j, terms, tidx) : JSONmatch(ma, jt, 0, terms, tidx, accumulate);
+	if (s == JSON_FALLBACK) {
+		scan = false;
+		goto restart;
+	}
 	if (s == (char *) -1) {
 		msg = createException(MAL, "JSONfilterInternal",
 							  SQLSTATE(HY013) MAL_MALLOC_FAIL);
@@ -995,7 +1178,11 @@ JSONfilterInternal(Client ctx, json *ret, const json *js, const char *const *exp
 			&& terms[tidx + 1].token) {
 			tidx += 1;
 			accumulate = terms[tidx].token == ANY_STEP || (terms[tidx].name && terms[tidx].name[0] == '*');
-			s = JSONmatch(ma, jt, 0, terms, tidx, accumulate);
+			s = scan ? JSONscanmatch(ma, j, terms, tidx) : JSONmatch(ma, jt, 0, terms, tidx, accumulate);
+			if (s == JSON_FALLBACK) {
+				scan = false;
+				goto restart;
+			}
 			if (s == (char *) -1) {
 				msg = createException(MAL, "JSONfilterInternal",
 									  SQLSTATE(HY013) MAL_MALLOC_FAIL);
@@ -1052,6 +1239,27 @@ JSONfilterInternal(Client ctx, json *ret, const json *js, const char *const *exp
 	return msg;
 }
 
+static str
+JSONfilterInternal(Client ctx, json *ret, const json *js, const char *const *expr, const char *other)
+{
+	allocator *ma = ctx->curprg->def->ma;
+	pattern terms[MAXTERMS];
+	str msg;
+
+	(void) other;
+	if (strNil(*js)) {
+		*ret = ma_strdup(ma, *js);
+		if (*ret == NULL)
+			throw(MAL, "JSONfilterInternal", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		return MAL_SUCCEED;
+	}
+	memset(terms, 0, sizeof(terms));
+	msg = JSONcompile(ma, *expr, terms);
+	if (msg)
+		return msg;
+	return JSONfilterpath(ma, ret, *js, terms);
+}
+
 
 static str
 JSONstringParser(const char *j, const char **next)
@@ -1800,29 +2008,28 @@ JSONplaintext(allocator *ma, char **r, size_t *l, size_t *ilen, const JSON *jt,
 }
 
 static str
-JSONjson2textSeparator(Client ctx, str *ret, const json *js, const char *const *sep)
+JSONtextInternal(allocator *ma, str *ret, const char *js, const char *sep)
 {
-	allocator *ma = ctx->curprg->def->ma;
 	allocator *ta = MT_thread_getallocator();
 	assert(ta);
 	size_t l, ilen, sep_len;
 	str s, msg;
 	JSON *jt;
 
-	if (strNil(*js) || strNil(*sep)) {
+	if (strNil(js) || strNil(sep)) {
 		*ret = (char *) str_nil;
 		return MAL_SUCCEED;
 	}
 	allocator_state ta_state = ma_open(ta);
-	jt = JSONparse(ta, *js);
+	jt = JSONparse(ta, js);
 	CHECK_JSON(jt);
-	sep_len = strlen(*sep);
-	ilen = l = strlen(*js) + 1;
+	sep_len = strlen(sep);
+	ilen = l = strlen(js) + 1;
 	if (!(s = ma_alloc(ma, l))) {
 		ma_close(&ta_state);
 		throw(MAL, "json2txt", SQLSTATE(HY013) MAL_MALLOC_FAIL);
 	}
-	msg = JSONplaintext(ma, &s, &l, &ilen, jt, 0, *sep, sep_len);
+	msg = JSONplaintext(ma, &s, &l, &ilen, jt, 0, sep, sep_len);
 	ma_close(&ta_state);
 	if (msg) {
 		return msg;
@@ -1835,6 +2042,12 @@ JSONjson2textSeparator(Client ctx, str *ret, const json *js, const char *const *
 	return MAL_SUCCEED;
 }
 
+static str
+JSONjson2textSeparator(Client ctx, str *ret, const json *js, const char *const *sep)
+{
+	return JSONtextInternal(ctx->curprg->def->ma, ret, *js, *sep);
+}
+
 static str
 JSONjson2text(Client ctx, str *ret, const json *js)
 {
@@ -1954,6 +2167,881 @@ JSONjson2integer(Client ctx, lng *ret, const json *js)
 	return MAL_SUCCEED;
 }
 
+/*
+ * Shredding.
+ *
+ * JSON columns holding telemetry tend to be queried with the same few
+ * path expressions over and over again.  The bulk versions of
+ * json.filter keep track of how often a simple path (see
+ * JSONsimplepath) is extracted from a persistent column.  Once a
+ * path is popular, a background thread samples the column to see
+ * whether the values found at the path have a stable type: integers
+ * or strings without escapes.  If so, the path is extracted from the
+ * whole column into a hidden typed sub-column, which from then on
+ * replaces the parsing of the documents.  batjson.filter turns a
+ * value of the sub-column back into JSON text, batjson.filterinteger,
+ * batjson.filternumber and batjson.filtertext (introduced by the
+ * jsonpath optimizer) read it directly.
+ *
+ * A sub-column is valid as long as the BATversion of its column does
+ * not change, so it survives appends.  Rows appended after the
+ * sub-column was made are extracted on the fly until the background
+ * thread has extended it.  Sub-columns only live in memory.
+ */
+
+#define SHRED_MAX		32		/* column/path pairs tracked */
+#define SHRED_HITS		4		/* bulk extractions before shredding */
+#define SHRED_MINROWS	1024	/* smaller columns are not shredded */
+#define SHRED_SAMPLE	1024	/* rows sampled to determine the type */
+
+static struct shred {
+	bat pid;					/* the persistent json column */
+	char *path;					/* the path expression */
+	ulng version;				/* BATversion of pid for sub (or rejected) */
+	bat sub;					/* typed sub-column (logical reference) */
+	int hits;					/* extractions since last (re)start */
+	bool busy;					/* background thread is working on it */
+	bool rejected;				/* no stable type at this version */
+	ulng lastused;
+} shreds[SHRED_MAX];
+static MT_Lock shredlock = MT_LOCK_INITIALIZER(shredlock);
+static ulng shredclock;
+
+/* can the path expression be served by a sub-column: a single simple
+ * path */
+static bool
+JSONshreddable(const pattern *terms)
+{
+	int i;
+
+	if (!JSONsimplepath(terms))
+		return false;
+	for (i = 0; i < MAXTERMS && terms[i].token != END_STEP; i++)
+		;
+	return i + 1 < MAXTERMS && terms[i + 1].token == 0;
+}
+
+/* the type of a value found by a simple path: TYPE_void if nothing
+ * was found, TYPE_lng or TYPE_str if it survives the round trip
+ * through that type unchanged, TYPE_any otherwise */
+static int
+JSONshredtype(const char *v)
+{
+	const char *s;
+	size_t n;
+
+	if (strcmp(v, "[]") == 0)
+		return TYPE_void;
+	if (*v == '"') {
+		n = strlen(v);
+		if (n >= 2 && v[n - 1] == '"' && strchr(v + 1, '\\') == NULL)
+			return TYPE_str;
+		return TYPE_any;
+	}
+	s = v + (*v == '-');
+	if (*s == '0') {
+		if (s[1] == 0 && s == v)
+			return TYPE_lng;	/* not -0 */
+		return TYPE_any;
+	}
+	n = strspn(s, "0123456789");
+	if (n > 0 && n <= 18 && s[n] == 0)
+		return TYPE_lng;
+	return TYPE_any;
+}
+
+/* append the value v of type JSONshredtype(v) == tpe (or TYPE_void)
+ * to sub-column sub */
+static gdk_return
+JSONshredappend(BAT *sub, const char *v, int tpe)
+{
+	if (tpe == TYPE_void)
+		return BUNappend(sub, ATOMnilptr(sub->ttype), false);
+	if (sub->ttype == TYPE_lng) {
+		lng l = strtoll(v, NULL, 10);
+		return BUNappend(sub, &l, false);
+	}
+	size_t n = strlen(v);
+	char *s = GDKstrndup(v + 1, n - 2);
+	if (s == NULL)
+		return GDK_FAIL;
+	gdk_return rc = BUNappend(sub, s, false);
+	GDKfree(s);
+	return rc;
+}
+
+/* the persistent column whose rows b shows (b itself or a slice of
+ * it), with *off set to the position of b's first row in it */
+static BAT *
+JSONshredcolumn(BAT *b, BUN *off)
+{
+	BATiter bi = bat_iterator(b);
+	BAT *pb = BBP_desc(bi.h->parentid);
+	Heap *h = bi.h;
+	bool ok;
+
+	*off = bi.baseoff;
+	bat_iterator_end(&bi);
+	if (pb == NULL || pb->ttype != b->ttype)
+		return NULL;
+	MT_lock_set(&pb->theaplock);
+	ok = pb->batRole == PERSISTENT && pb->theap == h && pb->tbaseoff == 0;
+	MT_lock_unset(&pb->theaplock);
+	return ok ? pb : NULL;
+}
+
+static void JSONshredbuild(void *arg);
+
+/* Count an extraction of path from b, starting the background thread
+ * if the path is popular enough, and return the sub-column if there is
+ * a valid one (with a physical reference).  *off is set to the
+ * position of the first row of b in the sub-column. */
+static BAT *
+JSONshredlookup(BAT *b, const char *path, BUN *off)
+{
+	struct shred *e = NULL;
+	BAT *pb, *sub = NULL;
+	bool start = false;
+	ulng version;
+	BUN cnt;
+
+	if ((pb = JSONshredcolumn(b, off)) == NULL ||
+		(cnt = BATcount(pb)) < SHRED_MINROWS)
+		return NULL;
+	version = BATversion(pb);
+
+	MT_lock_set(&shredlock);
+	for (int i = 0; i < SHRED_MAX; i++) {
+		if (shreds[i].pid == pb->batCacheid &&
+			strcmp(shreds[i].path, path) == 0) {
+			e = &shreds[i];
+			break;
+		}
+		/* otherwise use the least recently used idle slot (unused
+		 * slots have lastused == 0) */
+		if (!shreds[i].busy && (e == NULL || shreds[i].lastused < e->lastused))
+			e = &shreds[i];
+	}
+	if (e == NULL) {
+		MT_lock_unset(&shredlock);
+		return NULL;
+	}
+	if (e->pid != pb->batCacheid || strcmp(e->path, path) != 0) {
+		char *p = GDKstrdup(path);
+		if (p == NULL) {
+			MT_lock_unset(&shredlock);
+			GDKclrerr();
+			return NULL;
+		}
+		if (e->sub)
+			BBPrelease(e->sub);
+		GDKfree(e->path);
+		*e = (struct shred) {
+			.pid = pb->batCacheid,
+			.path = p,
+		};
+	}
+	e->lastused = ++shredclock;
+	if (e->version != version) {
+		/* values were changed since we last looked */
+		if (e->sub)
+			BBPrelease(e->sub);
+		e->sub = 0;
+		e->rejected = false;
+	}
+	if (e->sub && (sub = BATdescriptor(e->sub)) == NULL)
+		GDKclrerr();
+	if (!e->busy && !e->rejected && ++e->hits >= SHRED_HITS &&
+		(sub == NULL || BATcount(sub) + SHRED_MINROWS <= cnt)) {
+		e->busy = start = true;
+	}
+	MT_lock_unset(&shredlock);
+
+	if (start && GDKgetenv_istrue("json_shred_sync")) {
+		/* for testing: build the sub-column right away, and use it */
+		QryCtx *qc = MT_thread_get_qry_ctx();
+
+		JSONshredbuild(e);
+		MT_thread_set_qry_ctx(qc);
+		BBPreclaim(sub);
+		sub = NULL;
+		MT_lock_set(&shredlock);
+		if (e->pid == pb->batCacheid && e->sub &&
+			(sub = BATdescriptor(e->sub)) == NULL)
+			GDKclrerr();
+		MT_lock_unset(&shredlock);
+	} else if (start) {
+		MT_Id tid;
+		char name[MT_NAME_LEN];
+
+		snprintf(name, sizeof(name), "jsonshred%d", (int) (e - shreds));
+		if (MT_create_thread(&tid, JSONshredbuild, e,
+							 MT_THR_DETACHED, name) < 0) {
+			GDKclrerr();
+			MT_lock_set(&shredlock);
+			e->busy = false;
+			MT_lock_unset(&shredlock);
+		}
+	}
+	return sub;
+}
+
+/* the background thread: create or extend the sub-column of e */
+static void
+JSONshredbuild(void *arg)
+{
+	struct shred *e = arg;
+	/* ma for the path, ra for the values of a single document */
+	allocator *ma = create_allocator("jsonshred", false);
+	allocator *ra = create_allocator("jsonshred", false);
+	pattern terms[MAXTERMS];
+	BAT *pb, *old = NULL, *sub = NULL;
+	BATiter bi;
+	BUN start = 0;
+	char *path;
+	/* exceptions are allocated from the query context's allocator */
+	QryCtx qc = { .errorallocator = ra };
+	ulng version = 0;
+	int tpe = TYPE_any;
+	bool rejected = false;
+	lng t0 = GDKusec();
+
+	MT_thread_set_qry_ctx(&qc);
+	MT_lock_set(&shredlock);
+	path = GDKstrdup(e->path);
+	pb = BATdescriptor(e->pid);
+	if (pb && e->sub) {
+		version = BATversion(pb);
+		if (e->version == version)
+			old = BATdescriptor(e->sub);
+	}
+	MT_lock_unset(&shredlock);
+	if (ma == NULL || ra == NULL || path == NULL || pb == NULL)
+		goto bailout;
+
+	memset(terms, 0, sizeof(terms));
+	if (JSONcompile(ma, path, terms) != MAL_SUCCEED)
+		goto bailout;
+	if (old == NULL)
+		version = BATversion(pb);
+	bi = bat_iterator(pb);
+	if (old) {
+		start = BATcount(old);
+		tpe = old->ttype;
+		sub = COLcopy(old, tpe, true, TRANSIENT);
+	} else {
+		/* determine the type from a sample */
+		BUN step = bi.count / SHRED_SAMPLE;
+		bool stable = true;
+
+		if (step == 0)
+			step = 1;
+		for (BUN p = 0; stable && p < bi.count; p += step) {
+			const char *doc = BUNtvar(&bi, p);
+			json r;
+			int t;
+
+			if (strNil(doc))
+				continue;
+			if (JSONfilterpath(ra, &r, doc, terms) != MAL_SUCCEED) {
+				t = TYPE_any;
+			} else {
+				t = JSONshredtype(r);
+			}
+			if (t == TYPE_any || (t != TYPE_void && tpe != TYPE_any && t != tpe))
+				stable = false;
+			else if (t != TYPE_void)
+				tpe = t;
+		}
+		if (stable && tpe != TYPE_any)
+			sub = COLnew(0, tpe, bi.count, TRANSIENT);
+		else
+			rejected = true;
+	}
+	for (BUN p = start; sub && p < bi.count; p++) {
+		const char *doc = BUNtvar(&bi, p);
+		json r = "[]";
+		int t;
+
+		if ((p & 1023) == 0) {
+			ma_reset(ra);
+			if (GDKexiting()) {
+				BBPreclaim(sub);
+				sub = NULL;
+				break;
+			}
+		}
+		if (!strNil(doc) &&
+			JSONfilterpath(ra, &r, doc, terms) != MAL_SUCCEED) {
+			t = TYPE_any;
+		} else {
+			t = JSONshredtype(r);
+		}
+		if ((t != TYPE_void && t != tpe) ||
+			JSONshredappend(sub, r, t) != GDK_SUCCEED) {
+			BBPreclaim(sub);
+			sub = NULL;
+			/* a value of another type: no longer stable */
+			rejected = t != TYPE_void && t != tpe;
+		}
+	}
+	bat_iterator_end(&bi);
+	GDKclrerr();
+
+  bailout:
+	MT_lock_set(&shredlock);
+	if (pb && BATversion(pb) == version && (sub || rejected)) {
+		if (e->sub)
+			BBPrelease(e->sub);
+		e->sub = 0;
+		if (sub) {
+			BBPretain(sub->batCacheid);
+			e->sub = sub->batCacheid;
+		}
+		e->version = version;
+		e->rejected = rejected;
+		e->hits = 0;
+	}
+	e->busy = false;
+	MT_lock_unset(&shredlock);
+	if (sub)
+		TRC_DEBUG(ACCELERATOR, "JSONshredbuild(%s,%d)=%d (" LLFMT " usec)\n", path, e->pid, sub->batCacheid, GDKusec() - t0);
+	else
+		TRC_DEBUG(ACCELERATOR, "JSONshredbuild(%s): %s\n", path ? path : "", rejected ? "no stable type" : "failed");
+	BBPreclaim(sub);
+	BBPreclaim(old);
+	BBPreclaim(pb);
+	GDKfree(path);
+	MT_thread_set_qry_ctx(NULL);
+	if (ra)
+		ma_destroy(ra);
+	if (ma)
+		ma_destroy(ma);
+}
+
+
+/*
+ * Offset index.
+ *
+ * Without help, every bulk extraction of a simple path scans each
+ * document from its start.  Instead, the documents of a persistent
+ * column are tokenized once into a tape with a node for each value:
+ * the offsets of its key and of the value in the stored text, and the
+ * position just past the nodes of the value's own members.  Arrays of
+ * scalars get no nodes for their elements, and neither do documents
+ * whose nodes would take more memory than their text.  A path is
+ * then looked up by hopping over the members of the containers on the
+ * path, comparing keys only, and the text is only read for the value
+ * that is found.  The first bulk extraction from a column makes the
+ * tape, later ones extend it with the rows appended since, so each
+ * document is tokenized once.  Like a sub-column, a tape is valid as
+ * long as the BATversion of its column does not change.  Tapes only
+ * live in memory.
+ */
+
+#define JTAPE_MAX		8		/* columns with a tape */
+
+struct jnode {
+	uint32_t key;				/* offset of the key text, after the quote */
+	uint32_t klen;				/* length of the key text */
+	uint32_t val;				/* offset of the value */
+	uint32_t end;				/* node after the value's members */
+};
+
+struct jtape {
+	ATOMIC_TYPE refs;
+	BUN cnt;					/* number of rows on the tape */
+	BUN *rows;					/* first node of each row, cnt + 1 of them */
+	struct jnode *nodes;
+	BUN nnodes, size;
+};
+
+static struct jtapeentry {
+	bat pid;					/* the persistent json column */
+	ulng version;				/* BATversion of pid for tape */
+	struct jtape *tape;
+	bool busy;					/* tape is being extended */
+	ulng lastused;
+} jtapes[JTAPE_MAX];
+static MT_Lock jtapelock = MT_LOCK_INITIALIZER(jtapelock);
+static ulng jtapeclock;
+
+static void
+JSONtapefree(struct jtape *t)
+{
+	if (t && ATOMIC_DEC(&t->refs) == 0) {
+		GDKfree(t->rows);
+		GDKfree(t->nodes);
+		GDKfree(t);
+	}
+}
+
+/* add the nodes of the (valid) value at v of document j, with its key
+ * at offset key of length klen, to t; returns the end of the value,
+ * or NULL on failure */
+static const char *
+JSONtapevalue(struct jtape *t, BUN row0, const char *j, const char *v,
+			  uint32_t key, uint32_t klen)
+{
+	BUN i = t->nnodes;
+	const char *e;
+
+	if (THRhighwater())
+		return NULL;
+	if (t->nnodes == t->size) {
+		BUN size = t->size < 1024 ? 1024 : t->size * 2;
+		struct jnode *nodes = GDKrealloc(t->nodes, size * sizeof(struct jnode));
+		if (nodes == NULL)
+			return NULL;
+		t->nodes = nodes;
+		t->size = size;
+	}
+	t->nodes[t->nnodes++] = (struct jnode) {
+		.key = key,
+		.klen = klen,
+		.val = (uint32_t) (v - j),
+	};
+	switch (*v) {
+	case '{':
+		v++;
+		skipblancs(v);
+		while (*v != '}') {
+			const char *k = v;
+			if (*k != '"' || (e = JSONskip(k)) == NULL)
+				return NULL;
+			v = e;
+			skipblancs(v);
+			if (*v++ != ':')
+				return NULL;
+			skipblancs(v);
+			v = JSONtapevalue(t, row0, j, v, (uint32_t) (k + 1 - j),
+							  (uint32_t) (e - k - 2));
+			if (v == NULL)
+				return NULL;
+			skipblancs(v);
+			if (*v == ',') {
+				v++;
+				skipblancs(v);
+			} else if (*v != '}')
+				return NULL;
+		}
+		e = v + 1;
+		break;
+	case '[': {
+		bool scalars = true;
+		v++;
+		skipblancs(v);
+		while (*v != ']') {
+			scalars &= *v != '{' && *v != '[';
+			if ((v = JSONtapevalue(t, row0, j, v, 0, 0)) == NULL)
+				return NULL;
+			skipblancs(v);
+			if (*v == ',') {
+				v++;
+				skipblancs(v);
+			} else if (*v != ']')
+				return NULL;
+		}
+		/* an array of scalars is cheaper to scan than to keep a node
+		 * for each of its elements */
+		if (scalars)
+			t->nnodes = i + 1;
+		e = v + 1;
+		break;
+	}
+	default:
+		if ((e = JSONskip(v)) == NULL)
+			return NULL;
+		break;
+	}
+	t->nodes[i].end = (uint32_t) (t->nnodes - row0);
+	return e;
+}
+
+/* a new tape for all rows of bi, with the rows of old copied */
+static struct jtape *
+JSONtapeextend(const struct jtape *old, BATiter *bi)
+{
+	struct jtape *t = GDKmalloc(sizeof(struct jtape));
+	BUN start = old ? old->cnt : 0;
+
+	if (t == NULL)
+		return NULL;
+	*t = (struct jtape) {
+		.cnt = bi->count,
+		.rows = GDKmalloc((bi->count + 1) * sizeof(BUN)),
+		.nnodes = old ? old->nnodes : 0,
+		.size = old ? old->nnodes + (bi->count - start) * 8 : bi->count * 8,
+	};
+	ATOMIC_INIT(&t->refs, 1);
+	if (t->rows == NULL ||
+		(t->size > 0 &&
+		 (t->nodes = GDKmalloc(t->size * sizeof(struct jnode))) == NULL))
+		goto bailout;
+	if (old) {
+		memcpy(t->rows, old->rows, start * sizeof(BUN));
+		memcpy(t->nodes, old->nodes, old->nnodes * sizeof(struct jnode));
+	}
+	for (BUN p = start; p < bi->count; p++) {
+		const char *doc = BUNtvar(bi, p);
+		size_t len;
+
+		if (GDKexiting())
+			goto bailout;
+		t->rows[p] = t->nnodes;
+		if (strNil(doc) || (len = strlen(doc)) >= UINT32_MAX)
+			continue;
+		skipblancs(doc);
+		if (JSONtapevalue(t, t->rows[p], doc, doc, 0, 0) == NULL) {
+			/* not on the tape, the row is scanned instead */
+			GDKclrerr();
+			t->nnodes = t->rows[p];
+		} else if ((t->nnodes - t->rows[p]) * sizeof(struct jnode) > len) {
+			/* tiny values: the nodes take more memory than the
+			 * text, which is quick to scan anyway */
+			t->nnodes = t->rows[p];
+		}
+	}
+	t->rows[bi->count] = t->nnodes;
+	return t;
+
+  bailout:
+	GDKclrerr();
+	JSONtapefree(t);
+	return NULL;
+}
+
+/* the tape covering (the first rows of) the persistent column that
+ * b shows, extended with the rows appended since it was made; the
+ * caller gets a reference, *off is set to the position of the first
+ * row of b in it */
+static struct jtape *
+JSONtapelookup(BAT *b, BUN *off)
+{
+	struct jtapeentry *e = NULL;
+	struct jtape *tape, *nt;
+	BAT *pb;
+	ulng version;
+	bool extend;
+
+	if ((pb = JSONshredcolumn(b, off)) == NULL ||
+		BATcount(pb) < SHRED_MINROWS)
+		return NULL;
+	version = BATversion(pb);
+
+	MT_lock_set(&jtapelock);
+	for (int i = 0; i < JTAPE_MAX; i++) {
+		if (jtapes[i].pid == pb->batCacheid) {
+			e = &jtapes[i];
+			break;
+		}
+		if (!jtapes[i].busy && (e == NULL || jtapes[i].lastused < e->lastused))
+			e = &jtapes[i];
+	}
+	if (e == NULL) {
+		MT_lock_unset(&jtapelock);
+		return NULL;
+	}
+	if (e->pid != pb->batCacheid || e->version != version) {
+		/* another column, or the values were changed */
+		JSONtapefree(e->tape);
+		*e = (struct jtapeentry) {
+			.pid = pb->batCacheid,
+			.version = version,
+		};
+	}
+	e->lastused = ++jtapeclock;
+	if ((tape = e->tape) != NULL)
+		(void) ATOMIC_INC(&tape->refs);
+	extend = !e->busy && (tape == NULL || tape->cnt < BATcount(pb));
+	if (extend)
+		e->busy = true;
+	MT_lock_unset(&jtapelock);
+
+	if (extend) {
+		lng t0 = GDKusec();
+		BATiter pi = bat_iterator(pb);
+		nt = JSONtapeextend(tape, &pi);
+		bat_iterator_end(&pi);
+
+		MT_lock_set(&jtapelock);
+		if (nt && BATversion(pb) == version) {
+			JSONtapefree(e->tape);
+			(void) ATOMIC_INC(&nt->refs);
+			e->tape = nt;
+			MT_lock_unset(&jtapelock);
+			TRC_DEBUG(ACCELERATOR, "JSONtapelookup(%d): " BUNFMT " rows, " BUNFMT " nodes (" LLFMT " usec)\n", pb->batCacheid, nt->cnt, nt->nnodes, GDKusec() - t0);
+			JSONtapefree(tape);
+			tape = nt;
+			MT_lock_set(&jtapelock);
+		} else {
+			JSONtapefree(nt);
+		}
+		e->busy = false;
+		MT_lock_unset(&jtapelock);
+	}
+	return tape;
+}
+
+/* the JSONscanmatch equivalent on the tape nodes nd of document j,
+ * starting at node ni */
+static str
+JSONtapematch(allocator *ma, const char *j, const struct jnode *nd, uint32_t ni,
+			  const pattern *terms, int ti)
+{
+	const char *e;
+	str res = NULL;
+	int cnt = 0;
+
+	if (ti >= MAXTERMS)
+		return NULL;
+	if (terms[ti].token == ROOT_STEP) {
+		if (ti + 1 == MAXTERMS)
+			return NULL;
+		if (terms[ti + 1].token == END_STEP) {
+			if ((e = JSONskip(j + nd[ni].val)) == NULL)
+				return JSON_FALLBACK;
+			return JSONscanvalue(ma, j + nd[ni].val, e);
+		}
+		ti++;
+	}
+	if (ti + 1 == MAXTERMS)
+		return NULL;
+
+	switch (j[nd[ni].val]) {
+	case '[':
+		if (terms[ti].name != NULL)
+			return NULL;
+		if (nd[ni].end == ni + 1) {
+			/* no nodes for the elements (of an array of scalars) */
+			return JSONscanmatch(ma, j + nd[ni].val, terms, ti);
+		}
+		for (uint32_t c = ni + 1; c < nd[ni].end; c = nd[c].end, cnt++) {
+			if (cnt == terms[ti].index) {
+				if (terms[ti + 1].token == END_STEP) {
+					if ((e = JSONskip(j + nd[c].val)) == NULL)
+						return JSON_FALLBACK;
+					return JSONscanvalue(ma, j + nd[c].val, e);
+				}
+				if (j[nd[c].val] != '{' && j[nd[c].val] != '[')
+					return JSON_FALLBACK; /* JSONmatch oddity */
+				return JSONtapematch(ma, j, nd, c, terms, ti + 1);
+			}
+		}
+		return NULL;
+	case '{':
+		if (terms[ti].name == NULL)
+			return JSON_FALLBACK; /* index into an object */
+		for (uint32_t c = ni + 1; c < nd[ni].end; c = nd[c].end) {
+			if (nd[c].klen == terms[ti].namelen &&
+				strncmp(j + nd[c].key, terms[ti].name, nd[c].klen) == 0) {
+				/* on duplicate keys the last one wins */
+				if (terms[ti + 1].token == END_STEP) {
+					if ((e = JSONskip(j + nd[c].val)) == NULL)
+						return JSON_FALLBACK;
+					res = JSONscanvalue(ma, j + nd[c].val, e);
+				} else {
+					res = JSONtapematch(ma, j, nd, c, terms, ti + 1);
+				}
+				if (res == (str) -1 || res == JSON_FALLBACK)
+					return res;
+			}
+		}
+		return res;
+	default:
+		return NULL;
+	}
+}
+
+/* batjson.filter[integer|number|text](b[, s], pathexpr): the bulk
+ * version of json.filter, and of json.integer, json.number and
+ * json.text applied to json.filter; with s, the result is that of
+ * b's rows selected by s, as in algebra.projection(s, b) */
+static str
+JSONbatfilter(Client ctx, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	bat *ret = getArgReference_bat(stk, pci, 0);
+	bat bid = *getArgReference_bat(stk, pci, 1);
+	bat sid = pci->argc == 4 ? *getArgReference_bat(stk, pci, 2) : bat_nil;
+	const char *expr = *getArgReference_str(stk, pci, pci->argc - 1);
+	int tt = getBatType(getArgType(mb, pci, 0));
+	BAT *b = NULL, *s = NULL, *sub = NULL, *bn = NULL;
+	struct jtape *tape = NULL;
+	BATiter bi, si, ui;
+	allocator *ma = NULL, *ra = NULL;
+	pattern terms[MAXTERMS];
+	str empty = NULL, msg = MAL_SUCCEED;
+	const oid *sval = NULL;
+	struct canditer ci;
+	bool allnil = false;
+	BUN n, off = 0, ucnt = 0, toff = 0;
+	bool nil = strNil(expr);
+	lng l;
+	dbl d;
+	char nbuf[24];
+
+	if ((b = BATdescriptor(bid)) == NULL ||
+		(!is_bat_nil(sid) && (s = BATdescriptor(sid)) == NULL)) {
+		BBPreclaim(b);
+		throw(MAL, "batjson.filter", SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+	}
+	/* ma for the whole call, ra for the values of a single row */
+	if ((ma = create_allocator("batjson", false)) == NULL ||
+		(ra = create_allocator("batjson", false)) == NULL) {
+		msg = createException(MAL, "batjson.filter", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		goto bailout;
+	}
+	memset(terms, 0, sizeof(terms));
+	if (!nil && (msg = JSONcompile(ma, expr, terms)) != MAL_SUCCEED)
+		goto bailout;
+	/* the outcome of json.text when nothing is found */
+	if (tt == TYPE_str && (msg = JSONtextInternal(ma, &empty, "[]", " ")) != MAL_SUCCEED)
+		goto bailout;
+	if (!nil && JSONshreddable(terms)) {
+		sub = JSONshredlookup(b, expr, &off);
+		tape = JSONtapelookup(b, &toff);
+	}
+
+	bi = bat_iterator(b);
+	if (s) {
+		si = bat_iterator(s);
+		if (si.type == TYPE_void && is_oid_nil(si.tseq) && !complex_cand(s)) {
+			n = si.count;
+			allnil = true;
+		} else if (si.type == TYPE_oid && !(si.sorted && si.nonil)) {
+			/* not a candidate list: positions in any order,
+			 * possibly nil, as in algebra.projection */
+			n = si.count;
+			sval = (const oid *) si.base;
+		} else {
+			/* a candidate list, which may have exceptions */
+			canditer_init(&ci, NULL, s);
+			n = ci.ncand;
+		}
+	} else {
+		canditer_init(&ci, b, NULL);
+		n = ci.ncand;
+	}
+	if (sub) {
+		ui = bat_iterator(sub);
+		ucnt = ui.count;
+	}
+	if ((bn = COLnew(s ? s->hseqbase : b->hseqbase, tt, n, TRANSIENT)) == NULL) {
+		msg = createException(MAL, "batjson.filter", GDK_EXCEPTION);
+		goto bailout1;
+	}
+	for (BUN i = 0; i < n; i++) {
+		oid o = allnil ? oid_nil : sval ? sval[i] : canditer_next(&ci);
+		const void *v = ATOMnilptr(tt);
+
+		if (!nil && !is_oid_nil(o)) {
+			BUN p = o - b->hseqbase;
+			const char *doc;
+
+			if (o < b->hseqbase || p >= bi.count) {
+				msg = createException(MAL, "batjson.filter", ILLEGAL_ARGUMENT);
+				goto bailout1;
+			}
+			if (off + p < ucnt && ui.type == TYPE_lng) {
+				l = ((const lng *) ui.base)[off + p];
+				if (tt == TYPE_lng) {
+					v = &l;
+				} else if (tt == TYPE_dbl) {
+					d = is_lng_nil(l) ? dbl_nil : (dbl) l;
+					v = &d;
+				} else if (!strNil(doc = BUNtvar(&bi, p))) {
+					if (is_lng_nil(l)) {
+						v = tt == TYPE_str ? empty : "[]";
+					} else {
+						snprintf(nbuf, sizeof(nbuf), LLFMT, l);
+						v = nbuf;
+					}
+				}
+			} else if (off + p < ucnt) {
+				/* a string sub-column: not a number */
+				if (tt != TYPE_lng && tt != TYPE_dbl &&
+					!strNil(doc = BUNtvar(&bi, p))) {
+					const char *u = BUNtvar(&ui, off + p);
+					if (strNil(u)) {
+						v = tt == TYPE_str ? empty : "[]";
+					} else if (tt == TYPE_str) {
+						v = u;
+					} else {
+						size_t len = strlen(u) + 3;
+						char *t = ma_alloc(ra, len);
+						if (t)
+							snprintf(t, len, "\"%s\"", u);
+						v = t;
+					}
+				}
+			} else if (!strNil(doc = BUNtvar(&bi, p))) {
+				json r = JSON_FALLBACK;
+
+				if (tape && toff + p < tape->cnt &&
+					tape->rows[toff + p] < tape->rows[toff + p + 1]) {
+					r = JSONtapematch(ra, doc, tape->nodes + tape->rows[toff + p],
+									  0, terms, 0);
+					if (r == NULL)
+						r = "[]";
+				}
+				if (r == (str) -1) {
+					msg = createException(MAL, "batjson.filter", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+				} else if (r != JSON_FALLBACK ||
+						   (msg = JSONfilterpath(ra, &r, doc, terms)) == MAL_SUCCEED) {
+					switch (tt) {
+					case TYPE_lng:
+						msg = JSONjson2integer(ctx, &l, &r);
+						v = &l;
+						break;
+					case TYPE_dbl:
+						msg = JSONjson2number(ctx, &d, &r);
+						v = &d;
+						break;
+					case TYPE_str:
+						msg = JSONtextInternal(ra, &r, r, " ");
+						v = r;
+						break;
+					default:
+						v = r;
+						break;
+					}
+				}
+			}
+		}
+		if (msg == MAL_SUCCEED && v == NULL)
+			msg = createException(MAL, "batjson.filter", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		if (msg == MAL_SUCCEED && BUNappend(bn, v, false) != GDK_SUCCEED)
+			msg = createException(MAL, "batjson.filter", GDK_EXCEPTION);
+		if ((i & 1023) == 1023)
+			ma_reset(ra);	/* ra only holds values of rows already done */
+		if (msg)
+			break;
+	}
+
+  bailout1:
+	if (sub)
+		bat_iterator_end(&ui);
+	if (s)
+		bat_iterator_end(&si);
+	bat_iterator_end(&bi);
+  bailout:
+	if (ra)
+		ma_destroy(ra);
+	if (ma)
+		ma_destroy(ma);
+	BBPreclaim(b);
+	BBPreclaim(s);
+	BBPreclaim(sub);
+	JSONtapefree(tape);
+	if (msg) {
+		BBPreclaim(bn);
+		return msg;
+	}
+	*ret = bn->batCacheid;
+	BBPkeepref(bn);
+	return MAL_SUCCEED;
+}
+
 static str
 JSONunfoldContainer(allocator *ma, JSON *jt, int idx, BAT *bo, BAT *bk, BAT *bv, oid *o)
 {
@@ -3164,6 +4252,40 @@ JSONsubjson(Client ctx, bat *retval, const bat *bid, const bat *gid, const bat *
 static mel_atom json_init_atoms[] = {
 	{ .name="json", .basetype="str", .fromstr=JSONfromString, .tostr=JSONtoString },  { .cmp=NULL },
 };
+
+/* the sub-columns and tapes refer to the BATs of this server, forget
+ * them when it stops; the background threads stop early then */
+static str
+JSONepilogue(Client ctx, void *ret)
+{
+	(void) ctx;
+	(void) ret;
+
+	MT_lock_set(&shredlock);
+	for (int i = 0; i < SHRED_MAX; i++) {
+		while (shreds[i].busy) {
+			MT_lock_unset(&shredlock);
+			MT_sleep_ms(1);
+			MT_lock_set(&shredlock);
+		}
+		if (shreds[i].sub)
+			BBPrelease(shreds[i].sub);
+		GDKfree(shreds[i].path);
+		shreds[i] = (struct shred) { 0 };
+	}
+	shredclock = 0;
+	MT_lock_unset(&shredlock);
+
+	MT_lock_set(&jtapelock);
+	for (int i = 0; i < JTAPE_MAX; i++) {
+		JSONtapefree(jtapes[i].tape);
+		jtapes[i] = (struct jtapeentry) { 0 };
+	}
+	jtapeclock = 0;
+	MT_lock_unset(&jtapelock);
+	return MAL_SUCCEED;
+}
+
 static mel_func json_init_funcs[] = {
  command("json", "new", JSONstr2json, false, "Convert string to its JSON. Dealing with escape characters", args(1,2, arg("",json),arg("j",str))),
  command("calc", "json", JSON2json, false, "Convert JSON to JSON", args(1,2, arg("",json),arg("s",json))),
@@ -3187,6 +4309,14 @@ static mel_func json_init_funcs[] = {
  command("json", "filter", JSONfilterArray_hge, false, "", args(1,3, arg("",json),arg("name",json),arg("idx",hge))),
  command("json", "filter", JSONfilterArrayDefault_hge, false, "Extract a single array element", args(1,4, arg("",json),arg("name",json),arg("idx",hge),arg("other",str))),
 #endif
+ pattern("batjson", "filter", JSONbatfilter, false, "Filter all members of the objects by a path expression, returning an array. Non-matching elements are skipped.", args(1,3, batarg("",json),batarg("name",json),arg("pathexpr",str))),
+ pattern("batjson", "filter", JSONbatfilter, false, "Filter all members of the objects selected by s by a path expression", args(1,4, batarg("",json),batarg("name",json),batarg("s",oid),arg("pathexpr",str))),
+ pattern("batjson", "filterinteger", JSONbatfilter, false, "json.integer of json.filter of the objects", args(1,3, batarg("",lng),batarg("name",json),arg("pathexpr",str))),
+ pattern("batjson", "filterinteger", JSONbatfilter, false, "json.integer of json.filter of the objects selected by s", args(1,4, batarg("",lng),batarg("name",json),batarg("s",oid),arg("pathexpr",str))),
+ pattern("batjson", "filternumber", JSONbatfilter, false, "json.number of json.filter of the objects", args(1,3, batarg("",dbl),batarg("name",json),arg("pathexpr",str))),
+ pattern("batjson", "filternumber", JSONbatfilter, false, "json.number of json.filter of the objects selected by s", args(1,4, batarg("",dbl),batarg("name",json),batarg("s",oid),arg("pathexpr",str))),
+ pattern("batjson", "filtertext", JSONbatfilter, false, "json.text of json.filter of the objects", args(1,3, batarg("",str),batarg("name",json),arg("pathexpr",str))),
+ pattern("batjson", "filtertext", JSONbatfilter, false, "json.text of json.filter of the objects selected by s", args(1,4, batarg("",str),batarg("name",json),batarg("s",oid),arg("pathexpr",str))),
  command("json", "isobject", JSONisobject, false, "Validate the string as a valid JSON object", args(1,2, arg("",bit),arg("val",json))),
  command("json", "isarray", JSONisarray, false, "Validate the string as a valid JSON array", args(1,2, arg("",bit),arg("val",json))),
  command("json", "isvalid", JSONisvalid, false, "Validate the string as a valid JSON document", args(1,2, arg("",bit),arg("val",str))),
@@ -3208,6 +4338,7 @@ static mel_func json_init_funcs[] = {
  command("aggr", "subjsonaggr", JSONsubjson, false, "Grouped aggregation of values.", args(1,5, batarg("",str),batarg("val",dbl),batarg("g",oid),batargany("e",1),arg("skip_nils",bit))),
  command("aggr", "subjsonaggr", JSONsubjsoncand, false, "Grouped aggregation of values with candidates list.", args(1,6, batarg("",str),batarg("val",str),batarg("g",oid),batargany("e",1),batarg("s",oid),arg("skip_nils",bit))),
  command("aggr", "subjsonaggr", JSONsubjsoncand, false, "Grouped aggregation of values with candidates list.", args(1,6, batarg("",str),batarg("val",dbl),batarg("g",oid),batargany("e",1),batarg("s",oid),arg("skip_nils",bit))),
+ command("json", "epilogue", JSONepilogue, false, "release the sub-columns and tapes of the json columns", args(1,1, arg("",void))),
  { .imp=NULL }
 };
 #include "mal_import.h"
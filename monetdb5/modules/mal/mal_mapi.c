@@ -39,6 +39,7 @@
 #include "mal_internal.h"
 #include "msabaoth.h"
 #include "mcrypt.h"
+#include "mal_mapi.h"
 #include "stream.h"
 #include "streams.h"			/* for Stream */
 #include <sys/types.h>
@@ -161,6 +162,7 @@ struct challengedata {
 	struct sockaddr_storage peer;
 	socklen_t peerlen;
 	char challenge[13];
+	bool pooled;	/* connection of the connection pool of monetdbd */
 };
 
 static str SERVERsetAlias(Client ctx, void *ret, const int *key, const char *const *dbalias);
@@ -243,13 +245,24 @@ cleanUpScheduleClient(Client c, str *command, str *err)
 	}
 }
 
+/* The compression methods we offer: all that are built in, unless
+ * mapi_compression is set to something other than yes or true */
+static const char *
+offeredCompressors(void)
+{
+	if (GDKgetenv("mapi_compression") != NULL &&
+		!GDKgetenv_istrue("mapi_compression"))
+		return "";
+	return block_stream_compressors();
+}
+
 static void
 MSscheduleClient(str command, str peer, str challenge, bstream *fin, stream *fout,
-				 protocol_version protocol, size_t blocksize)
+				 protocol_version protocol, size_t blocksize, bool pooled)
 {
 	char *user = command, *algo = NULL, *passwd = NULL, *lang = NULL,
 		*handshake_opts = NULL;
-	char *database = NULL, *s;
+	char *database = NULL, *compress = NULL, *s;
 	const char *dbname;
 	str msg = MAL_SUCCEED;
 	bool filetrans = false;
@@ -332,11 +345,41 @@ MSscheduleClient(str command, str peer, str challenge, bstream *fin, stream *fou
 		filetrans = false;
 	}
 
-	if (s && strchr(s, ':') != NULL) {
+	if (s && strncmp(s, "COMPRESS=", 9) != 0 && strncmp(s, "SHM:", 4) != 0 &&
+		strchr(s, ':') != NULL) {
 		handshake_opts = s;
 		s = strchr(s, ':');
 		*s++ = '\0';
 	}
+
+	/* the client asked for compression: everything from here on,
+	 * including any error message, goes through the compressor */
+	if (s && strncmp(s, "COMPRESS=", 9) == 0) {
+		compress = s + 9;
+		s = strchr(compress, ':');
+		if (s)
+			*s++ = '\0';
+		if (*offeredCompressors() == '\0' ||
+			block_stream_compress(fin->s, compress) < 0 ||
+			block_stream_compress(fout, compress) < 0) {
+			mnstr_printf(fout, "!unsupported compression method '%s'\n", compress);
+			exit_streams(fin, fout);
+			GDKfree(command);
+			return;
+		}
+	}
+
+	/* the client asked for shared memory: it waits for the segment
+	 * before it reads anything else */
+	if (s && strncmp(s, "SHM:", 4) == 0) {
+		s += 4;
+		if (block_stream_shm_offer(fin->s, fout) < 0) {
+			TRC_ERROR(MAL_SERVER, "%s\n", mnstr_peek_error(fout));
+			exit_streams(fin, fout);
+			GDKfree(command);
+			return;
+		}
+	}
 	dbname = GDKgetenv("gdk_dbname");
 	if (database != NULL && database[0] != '\0' &&
 		strcmp(database, dbname) != 0) {
@@ -362,6 +405,7 @@ MSscheduleClient(str command, str peer, str challenge, bstream *fin, stream *fou
 			return;
 		}
 		c->filetrans = filetrans;
+		c->pooled = pooled;
 		c->handshake_options = handshake_opts ? ma_strdup(c->ma, handshake_opts) : NULL;
 		/* move this back !! */
 		if (c->usermodule == 0) {
@@ -428,6 +472,39 @@ MSscheduleClient(str command, str peer, str challenge, bstream *fin, stream *fou
 	(void) MSserveClient(c);
 }
 
+/* Send the challenge over the block stream
+ * We can do binary transfers, we can interrupt queries using
+ * out-of-band messages, we can compress the blocks, and local clients
+ * can get them through shared memory */
+static void
+sendChallenge(stream *fdout, const char *challenge, bool negotiate)
+{
+	const char *compressors = negotiate ? offeredCompressors() : "";
+	bool shm = negotiate && block_stream_shm_possible(fdout);
+	mnstr_printf(fdout, "%s:mserver:9:%s:%s:%s:sql=%d:BINARY=1:OOBINTR=1:CLIENTINFO:%s%s%s%s",
+				 challenge, mcrypt_getHashAlgorithms(),
+#ifdef WORDS_BIGENDIAN
+				 "BIG",
+#else
+				 "LIT",
+#endif
+				 MONETDB5_PASSWDHASH, MAPI_HANDSHAKE_OPTIONS_LEVEL,
+				 *compressors ? "COMPRESS=" : "", compressors,
+				 *compressors ? ":" : "",
+				 shm ? "SHM:" : "");
+}
+
+/* Write a fresh challenge for a client that logs in again over an
+ * established connection.  The challenge is returned in 'challenge',
+ * which must have room for 13 bytes.  The streams are already set up,
+ * so neither compression nor shared memory is offered. */
+void
+SERVERchallenge(stream *fdout, char *challenge)
+{
+	generateChallenge(challenge, 8, 12);
+	sendChallenge(fdout, challenge, false);
+}
+
 static void
 doChallenge(void *data)
 {
@@ -436,6 +513,7 @@ doChallenge(void *data)
 	char peerbuf[120] = { '[', 0 };
 	char *peer;
 	char challenge[13];
+	bool pooled = chdata->pooled;
 
 	stream *fdin = chdata->in;
 	stream *fdout = chdata->out;
@@ -483,17 +561,7 @@ doChallenge(void *data)
 		return;
 	}
 
-	/* Send the challenge over the block stream
-	 * We can do binary transfers, and we can interrupt queries using
-	 * out-of-band messages */
-	mnstr_printf(fdout, "%s:mserver:9:%s:%s:%s:sql=%d:BINARY=1:OOBINTR=1:CLIENTINFO:",
-				 challenge, mcrypt_getHashAlgorithms(),
-#ifdef WORDS_BIGENDIAN
-				 "BIG",
-#else
-				 "LIT",
-#endif
-				 MONETDB5_PASSWDHASH, MAPI_HANDSHAKE_OPTIONS_LEVEL);
+	sendChallenge(fdout, challenge, true);
 	mnstr_flush(fdout, MNSTR_FLUSH_DATA);
 	/* get response */
 	if ((len = mnstr_read_block(fdin, buf, 1, BLOCK)) < 0) {
@@ -516,7 +584,7 @@ doChallenge(void *data)
 		return;
 	}
 	bs->eof = true;
-	MSscheduleClient(buf, peer, challenge, bs, fdout, protocol, buflen);
+	MSscheduleClient(buf, peer, challenge, bs, fdout, protocol, buflen, pooled);
 }
 
 static ATOMIC_TYPE nlistener = ATOMIC_VAR_INIT(0);	/* nr of listeners */
@@ -595,6 +663,7 @@ SERVERlistenThread(SOCKET *Sock)
 			continue;
 		}
 		bool isusock = false;
+		bool pooled = false;
 #ifdef HAVE_POLL
 		for (i = 0; i < (int) npfd; i++) {
 			if (pfd[i].revents & POLLIN) {
@@ -649,6 +718,9 @@ SERVERlistenThread(SOCKET *Sock)
 			 * This byte is at this moment defined to contain a character:
 			 *  '0' - there is no ancillary data
 			 *  '1' - ancillary data for passing a file descriptor
+			 *  '2' - no ancillary data, the connection is kept by
+			 *        monetdbd for other clients, who log in over it
+			 *        with Xchallenge and Xreauth
 			 * The future may introduce a state for passing credentials.
 			 * Any unknown character must be interpreted as some unknown
 			 * action, and hence not supported by the server. */
@@ -678,6 +750,9 @@ SERVERlistenThread(SOCKET *Sock)
 			case '0':
 				/* nothing special, nothing to do */
 				break;
+			case '2':
+				pooled = true;
+				break;
 			case '1':
 			{
 				int *c_d;
@@ -717,6 +792,7 @@ SERVERlistenThread(SOCKET *Sock)
 			TRC_ERROR(MAL_SERVER, MAL_MALLOC_FAIL "\n");
 			continue;
 		}
+		data->pooled = pooled;
 		data->peerlen = sizeof(data->peer);
 		if (getpeername(msgsock, (struct sockaddr*)&data->peer, &data->peerlen) < 0)
 			data->peer.ss_family = AF_UNSPEC;
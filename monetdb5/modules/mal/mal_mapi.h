@@ -0,0 +1,18 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * For copyright information, see the file debian/copyright.
+ */
+
+#ifndef _MAL_MAPI_H
+#define _MAL_MAPI_H
+#include "mal.h"
+#include "stream.h"
+
+mal_export void SERVERchallenge(stream *fdout, char *challenge);
+
+#endif /* _MAL_MAPI_H */
@@ -1397,6 +1397,16 @@ PCRElikeselect(Client ctx, bat *ret, const bat *bid, const bat *sid, const char
 			GDKclrerr();
 		}
 	}
+	/* The trigram index also produces a superset of the result, which
+	 * is then checked by the normal pattern matching. */
+	if (!*anti && !with_strimps && BAThastrigrams(b)) {
+		BAT *tmp_s = TRGMselect(b, s, *pat, *esc);
+		if (tmp_s) {
+			MT_thread_setalgorithm("trigram index prefilter", __func__);
+			old_s = s;
+			s = tmp_s;
+		}
+	}
 
 
 	MT_thread_setalgorithm(use_strcmp
@@ -1504,9 +1514,19 @@ PCRElikeselect(Client ctx, bat *ret, const bat *bid, const bat *sid, const char
 			if (!empty) {												\
 				if ((msg = mnre_like_build(ta, &re, vr, false, use_strcmp, (unsigned char) *esc)) != MAL_SUCCEED) \
 					goto bailout;										\
+				ci = &lci;												\
 				canditer_reset(&lci);									\
-				TIMEOUT_LOOP(lci.ncand, qry_ctx) {		\
-					lo = canditer_next(&lci);							\
+				if (tl && (tcand = TRGMselect(tl, sl, vr, esc)) != NULL) { \
+					/* only the rows the trigram index lets	\
+					 * through can match */							\
+					canditer_init(&tci, l, tcand);						\
+					if (!with_trigrams)									\
+						MT_thread_setalgorithm("trigram index prefilter", __func__); \
+					with_trigrams = true;								\
+					ci = &tci;											\
+				}														\
+				TIMEOUT_LOOP(ci->ncand, qry_ctx) {						\
+					lo = canditer_next(ci);								\
 					vl = VALUE(l, lo - lbase);							\
 					if (strNil(vl)) {									\
 						continue;										\
@@ -1554,6 +1574,8 @@ PCRElikeselect(Client ctx, bat *ret, const bat *bid, const bat *sid, const char
 					nl++;												\
 				}														\
 				/*mnre_like_clean(&re);*/										\
+				BBPreclaim(tcand);										\
+				tcand = NULL;											\
 				TIMEOUT_CHECK(qry_ctx,									\
 							  GOTO_LABEL_TIMEOUT_HANDLER(bailout, qry_ctx)); \
 			}															\
@@ -1577,7 +1599,7 @@ static char *
 pcrejoin(BAT *r1, BAT *r2, BAT *l, BAT *r, BAT *sl, BAT *sr, const char *esc,
 		 bit caseignore, bit anti)
 {
-	struct canditer lci, rci;
+	struct canditer lci, rci, tci, *ci;
 	const char *lvals, *rvals, *lvars, *rvars, *vl, *vr;
 	var_t off;
 	int rskipped = 0;			/* whether we skipped values in r */
@@ -1610,6 +1632,14 @@ pcrejoin(BAT *r1, BAT *r2, BAT *l, BAT *r, BAT *sl, BAT *sr, const char *esc,
 		}
 	}
 
+	/* the trigram index gives a superset of the matches of each
+	 * pattern, so it can't be used for NOT LIKE; it folds case itself,
+	 * so it is on the original l */
+	BAT *tl = NULL, *tcand = NULL;
+	bool with_trigrams = false;
+	if (!anti && BAThastrigrams(ol ? ol : l))
+		tl = ol ? ol : l;
+
 	canditer_init(&lci, l, sl);
 	canditer_init(&rci, r, sr);
 
@@ -1718,6 +1748,7 @@ pcrejoin(BAT *r1, BAT *r2, BAT *l, BAT *r, BAT *sl, BAT *sr, const char *esc,
 	return MAL_SUCCEED;
 
   bailout:
+	BBPreclaim(tcand);
 	bat_iterator_end(&li);
 	bat_iterator_end(&ri);
 	assert(msg != MAL_SUCCEED);
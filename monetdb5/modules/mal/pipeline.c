@@ -593,7 +593,6 @@ PPappend(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 		throw(MAL, "bat.append", SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
 	}
 	struct pipeline_resultset *pp_rs = (struct pipeline_resultset*)r->pl_io;
-	(void)pp_rs;
 
 	if (i && (i->ttype == TYPE_msk || mask_cand(i))) {
 		i = BATunmask(i);
@@ -605,7 +604,30 @@ PPappend(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 			throw(MAL, "bat.append", SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
 		}
 	}
-	if (BATcount(i)) {
+	if (BATcount(i) && pp_rs->flush) {
+		/* streamed result, wait for our turn; as the rows are sent
+		 * under the lock, a slow client throttles all workers */
+		Pipeline *p = MT_thread_getdata();
+		for (;;) {
+			MT_lock_set(&pp_rs->l);
+			if (pp_rs->flushed == offset || (p && p->p->error))
+				break;
+			MT_lock_unset(&pp_rs->l);
+			sleep_ns(10);
+		}
+		lng flushed = 0;
+		if (pp_rs->flushed == offset)
+			flushed = pp_rs->flush(pp_rs->flush_data, rb, i);
+		if (flushed > 0)
+			pp_rs->flushed += flushed;
+		MT_lock_unset(&pp_rs->l);
+		if (flushed < 0) {
+			BBPreclaim(b);
+			BBPreclaim(i);
+			BBPreclaim(r);
+			throw(MAL, "bat.append", SQLSTATE(HY002) "failed to send result rows");
+		}
+	} else if (BATcount(i)) {
 		while(BATcount(b) != (BUN)offset) {
 			/* TODO if error or other issue return */
 			sleep_ns(10);
@@ -61,10 +61,19 @@ struct pipeline_concat {
 	BAT *srcs[];
 };
 
+/* Streamed resultsets hand the rows for result column 'col' to this
+ * callback instead of appending them, one morsel at a time and with
+ * the lock held. Returns the number of rows sent, which is zero until
+ * all columns of the morsel arrived, or a negative value on failure. */
+typedef lng (*pipeline_resultset_flush)(void *data, bat col, BAT *b);
+
 struct pipeline_resultset {
 	struct pipeline_io pl_io;
 	ATOMIC_TYPE claimed;
 	MT_Lock l;
+	pipeline_resultset_flush flush;	/* set when the rows are streamed */
+	void *flush_data;
+	lng flushed;	/* rows sent */
 };
 
 extern int BATupgrade(BAT *r, BAT *b, bool locked);
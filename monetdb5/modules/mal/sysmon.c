@@ -14,6 +14,7 @@
 #include "mal_authorize.h"
 #include "mal_client.h"
 #include "mal_runtime.h"
+#include "mal_resource.h"
 #include "gdk_time.h"
 #include "mal_exception.h"
 #include "mal_internal.h"
@@ -498,6 +499,130 @@ SYSMONstop(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 							   " unknown to the user.", tag)));
 }
 
+/* Resource groups, see mal_resource.c */
+static str
+SYSMONresource_groups(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	(void) cntxt;
+	(void) mb;
+	ResGroup groups;
+	char **members, **membergroups;
+	int n, nmembers;
+	BAT *name, *weight, *slots, *memory, *running, *queued, *workers, *claimed, *admitted, *waited;
+	str msg = MAL_SUCCEED;
+
+	if ((n = MALresgroup_list(&groups, &members, &membergroups, &nmembers)) < 0)
+		throw(MAL, "sysmon.resource_groups", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+	name = COLnew(0, TYPE_str, n, TRANSIENT);
+	weight = COLnew(0, TYPE_int, n, TRANSIENT);
+	slots = COLnew(0, TYPE_int, n, TRANSIENT);
+	memory = COLnew(0, TYPE_lng, n, TRANSIENT);
+	running = COLnew(0, TYPE_int, n, TRANSIENT);
+	queued = COLnew(0, TYPE_int, n, TRANSIENT);
+	workers = COLnew(0, TYPE_int, n, TRANSIENT);
+	claimed = COLnew(0, TYPE_lng, n, TRANSIENT);
+	admitted = COLnew(0, TYPE_lng, n, TRANSIENT);
+	waited = COLnew(0, TYPE_lng, n, TRANSIENT);
+	if (name == NULL || weight == NULL || slots == NULL || memory == NULL
+		|| running == NULL || queued == NULL || workers == NULL
+		|| claimed == NULL || admitted == NULL || waited == NULL) {
+		msg = createException(MAL, "sysmon.resource_groups", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		goto bailout;
+	}
+	for (int i = 0; i < n; i++) {
+		lng ms = groups[i].waited / 1000;
+		if (BUNappend(name, groups[i].name, false) != GDK_SUCCEED ||
+			BUNappend(weight, &groups[i].weight, false) != GDK_SUCCEED ||
+			BUNappend(slots, &groups[i].slots, false) != GDK_SUCCEED ||
+			BUNappend(memory, &groups[i].memory, false) != GDK_SUCCEED ||
+			BUNappend(running, &groups[i].running, false) != GDK_SUCCEED ||
+			BUNappend(queued, &groups[i].queued, false) != GDK_SUCCEED ||
+			BUNappend(workers, &groups[i].workers, false) != GDK_SUCCEED ||
+			BUNappend(claimed, &groups[i].claimed, false) != GDK_SUCCEED ||
+			BUNappend(admitted, &groups[i].admitted, false) != GDK_SUCCEED ||
+			BUNappend(waited, &ms, false) != GDK_SUCCEED) {
+			msg = createException(MAL, "sysmon.resource_groups", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+			goto bailout;
+		}
+	}
+	MALresgroup_list_free(groups, n, members, membergroups, nmembers);
+	*getArgReference_bat(stk, pci, 0) = name->batCacheid;
+	BBPkeepref(name);
+	*getArgReference_bat(stk, pci, 1) = weight->batCacheid;
+	BBPkeepref(weight);
+	*getArgReference_bat(stk, pci, 2) = slots->batCacheid;
+	BBPkeepref(slots);
+	*getArgReference_bat(stk, pci, 3) = memory->batCacheid;
+	BBPkeepref(memory);
+	*getArgReference_bat(stk, pci, 4) = running->batCacheid;
+	BBPkeepref(running);
+	*getArgReference_bat(stk, pci, 5) = queued->batCacheid;
+	BBPkeepref(queued);
+	*getArgReference_bat(stk, pci, 6) = workers->batCacheid;
+	BBPkeepref(workers);
+	*getArgReference_bat(stk, pci, 7) = claimed->batCacheid;
+	BBPkeepref(claimed);
+	*getArgReference_bat(stk, pci, 8) = admitted->batCacheid;
+	BBPkeepref(admitted);
+	*getArgReference_bat(stk, pci, 9) = waited->batCacheid;
+	BBPkeepref(waited);
+	return MAL_SUCCEED;
+
+  bailout:
+	MALresgroup_list_free(groups, n, members, membergroups, nmembers);
+	BBPreclaim(name);
+	BBPreclaim(weight);
+	BBPreclaim(slots);
+	BBPreclaim(memory);
+	BBPreclaim(running);
+	BBPreclaim(queued);
+	BBPreclaim(workers);
+	BBPreclaim(claimed);
+	BBPreclaim(admitted);
+	BBPreclaim(waited);
+	return msg;
+}
+
+static str
+SYSMONresource_group_members(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	(void) cntxt;
+	(void) mb;
+	ResGroup groups;
+	char **members, **membergroups;
+	int n, nmembers;
+	BAT *member, *group;
+	str msg = MAL_SUCCEED;
+
+	if ((n = MALresgroup_list(&groups, &members, &membergroups, &nmembers)) < 0)
+		throw(MAL, "sysmon.resource_group_members", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+	member = COLnew(0, TYPE_str, nmembers, TRANSIENT);
+	group = COLnew(0, TYPE_str, nmembers, TRANSIENT);
+	if (member == NULL || group == NULL) {
+		msg = createException(MAL, "sysmon.resource_group_members", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		goto bailout;
+	}
+	for (int i = 0; i < nmembers; i++) {
+		if (BUNappend(member, members[i], false) != GDK_SUCCEED ||
+			BUNappend(group, membergroups[i], false) != GDK_SUCCEED) {
+			msg = createException(MAL, "sysmon.resource_group_members", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+			goto bailout;
+		}
+	}
+	MALresgroup_list_free(groups, n, members, membergroups, nmembers);
+	*getArgReference_bat(stk, pci, 0) = member->batCacheid;
+	BBPkeepref(member);
+	*getArgReference_bat(stk, pci, 1) = group->batCacheid;
+	BBPkeepref(group);
+	return MAL_SUCCEED;
+
+  bailout:
+	MALresgroup_list_free(groups, n, members, membergroups, nmembers);
+	BBPreclaim(member);
+	BBPreclaim(group);
+	return msg;
+}
+
 #include "mel.h"
 static mel_func sysmon_init_funcs[] = {
 	pattern("sysmon", "pause", SYSMONpause, true, "Suspend query execution with OID id", args(0, 1, arg("id", lng))),
@@ -508,6 +633,8 @@ static mel_func sysmon_init_funcs[] = {
 	pattern("sysmon", "stop", SYSMONstop, true, "Sysadmin call, stop query execution with OID id belonging to user", args(0, 2, arg("id", lng), arg("user", str))),
 	pattern("sysmon", "queue", SYSMONqueue, false, "A queue of queries that are currently being executed or recently finished", args(9, 9, batarg("tag", lng), batarg("sessionid", int), batarg("user", str), batarg("started", timestamp), batarg("status", str), batarg("query", str), batarg("finished", timestamp), batarg("workers", int), batarg("memory", int))),
 	pattern("sysmon", "queue", SYSMONqueue, false, "Sysadmin call, to see either the global queue or user queue of queries that are currently being executed or recently finished", args(9, 10, batarg("tag", lng), batarg("sessionid", int), batarg("user", str), batarg("started", timestamp), batarg("status", str), batarg("query", str), batarg("finished", timestamp), batarg("workers", int), batarg("memory", int), arg("user", str))),
+	pattern("sysmon", "resource_groups", SYSMONresource_groups, false, "The resource groups with their settings and current load", args(10, 10, batarg("name", str), batarg("weight", int), batarg("slots", int), batarg("memory", lng), batarg("running", int), batarg("queued", int), batarg("workers", int), batarg("claimed", lng), batarg("admitted", lng), batarg("waited", lng))),
+	pattern("sysmon", "resource_group_members", SYSMONresource_group_members, false, "The users and roles assigned to resource groups", args(2, 2, batarg("member", str), batarg("group", str))),
 	pattern("sysmon", "user_statistics", SYSMONstatistics, false, "", args(7, 7, batarg("user", str), batarg("querycount", lng), batarg("totalticks", lng), batarg("started", timestamp), batarg("finished", timestamp), batarg("maxticks", lng), batarg("maxquery", str))),
 	{ .imp=NULL }
 };
@@ -1518,6 +1518,212 @@ str_2_qgrams(Client ctx, bat *ret, const char *const *val)
 	return MAL_SUCCEED;
 }
 
+/* Full-text search, see gdk_fulltext.c.  A value matches a query if
+ * it contains all words of the query; the score is BM25. */
+
+static str
+TXTSIMfulltextmatch(Client ctx, bit *res, const char *const *x, const char *const *q)
+{
+	(void) ctx;
+	if (FTXTmatchvalue(res, *x, *q) != GDK_SUCCEED)
+		throw(MAL, "txtsim.fulltextmatch", GDK_EXCEPTION);
+	return MAL_SUCCEED;
+}
+
+static str
+BATTXTSIMfulltextmatch(Client ctx, bat *res, const bat *lid, const bat *rid)
+{
+	(void) ctx;
+	BAT *left = NULL, *right = NULL, *bn = NULL;
+	BATiter li, ri;
+	str msg = MAL_SUCCEED;
+	bit *restrict v;
+	bool nils = false;
+	QryCtx *qry_ctx = MT_thread_get_qry_ctx();
+
+	if ((left = BATdescriptor(*lid)) == NULL ||
+		(right = BATdescriptor(*rid)) == NULL) {
+		msg = createException(MAL, "battxtsim.fulltextmatch",
+							  SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+		goto exit;
+	}
+	if (BATcount(left) != BATcount(right)) {
+		msg = createException(MAL, "battxtsim.fulltextmatch",
+							  "Columns must be aligned");
+		goto exit;
+	}
+	if ((bn = COLnew(left->hseqbase, TYPE_bit, BATcount(left), TRANSIENT)) == NULL) {
+		msg = createException(MAL, "battxtsim.fulltextmatch",
+							  SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		goto exit;
+	}
+	v = Tloc(bn, 0);
+	li = bat_iterator(left);
+	ri = bat_iterator(right);
+	TIMEOUT_LOOP_IDX_DECL(p, li.count, qry_ctx) {
+		if (FTXTmatchvalue(&v[p], BUNtvar(&li, p), BUNtvar(&ri, p)) != GDK_SUCCEED) {
+			msg = createException(MAL, "battxtsim.fulltextmatch",
+								  GDK_EXCEPTION);
+			TIMEOUT_LOOP_BREAK;
+		}
+		nils |= is_bit_nil(v[p]);
+	}
+	bat_iterator_end(&li);
+	bat_iterator_end(&ri);
+	if (msg == MAL_SUCCEED)
+		TIMEOUT_CHECK(qry_ctx,
+					  msg = createException(MAL, "battxtsim.fulltextmatch",
+											"%s", TIMEOUT_MESSAGE(qry_ctx)));
+	if (msg == MAL_SUCCEED) {
+		BATsetcount(bn, BATcount(left));
+		bn->tnil = nils;
+		bn->tnonil = !nils;
+		bn->tsorted = bn->trevsorted = BATcount(bn) <= 1;
+		bn->tkey = BATcount(bn) <= 1;
+		*res = bn->batCacheid;
+		BBPkeepref(bn);
+	}
+  exit:
+	BBPreclaim(left);
+	BBPreclaim(right);
+	if (msg != MAL_SUCCEED)
+		BBPreclaim(bn);
+	return msg;
+}
+
+static str
+TXTSIMfulltextmatchselect(Client ctx, bat *res, const bat *bid, const bat *sid,
+						  const char *const *q, const bit *anti)
+{
+	(void) ctx;
+	BAT *b, *s = NULL, *bn;
+
+	if ((b = BATdescriptor(*bid)) == NULL)
+		throw(MAL, "txtsim.fulltextmatchselect",
+			  SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+	if (sid && !is_bat_nil(*sid) && (s = BATdescriptor(*sid)) == NULL) {
+		BBPunfix(b->batCacheid);
+		throw(MAL, "txtsim.fulltextmatchselect",
+			  SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+	}
+	bn = FTXTselect(b, s, *q, *anti);
+	BBPunfix(b->batCacheid);
+	BBPreclaim(s);
+	if (bn == NULL)
+		throw(MAL, "txtsim.fulltextmatchselect", GDK_EXCEPTION);
+	*res = bn->batCacheid;
+	BBPkeepref(bn);
+	return MAL_SUCCEED;
+}
+
+static str
+TXTSIMfulltextmatchjoin(Client ctx, bat *r1, bat *r2, const bat *lid, const bat *rid,
+						const bat *slid, const bat *srid, const bit *nil_matches,
+						const lng *estimate, const bit *anti)
+{
+	(void) ctx;
+	(void) nil_matches;
+	(void) estimate;
+	BAT *bleft = NULL, *bright = NULL, *bcandleft = NULL, *bcandright = NULL,
+		*r1t = NULL, *r2t = NULL, *bn;
+	struct canditer rci;
+	BATiter ri;
+	str msg = MAL_SUCCEED;
+
+	if ((bleft = BATdescriptor(*lid)) == NULL ||
+		(bright = BATdescriptor(*rid)) == NULL ||
+		(*slid != bat_nil && (bcandleft = BATdescriptor(*slid)) == NULL) ||
+		(*srid != bat_nil && (bcandright = BATdescriptor(*srid)) == NULL)) {
+		msg = createException(MAL, "txtsim.fulltextmatchjoin",
+							  SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+		goto exit;
+	}
+	if ((r1t = COLnew(0, TYPE_oid, 0, TRANSIENT)) == NULL ||
+		(r2t = COLnew(0, TYPE_oid, 0, TRANSIENT)) == NULL) {
+		msg = createException(MAL, "txtsim.fulltextmatchjoin",
+							  SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		goto exit;
+	}
+	canditer_init(&rci, bright, bcandright);
+	ri = bat_iterator(bright);
+	/* each query of the right side is a select on the left side, so
+	 * that it can use the full-text index */
+	for (BUN i = 0; i < rci.ncand && msg == MAL_SUCCEED; i++) {
+		oid ro = canditer_next(&rci);
+		if ((bn = FTXTselect(bleft, bcandleft, BUNtvar(&ri, ro - bright->hseqbase), *anti)) == NULL) {
+			msg = createException(MAL, "txtsim.fulltextmatchjoin",
+								  GDK_EXCEPTION);
+			break;
+		}
+		BAT *c = BATconstant(0, TYPE_oid, &ro, BATcount(bn), TRANSIENT);
+		if (c == NULL ||
+			BATappend(r1t, bn, NULL, false) != GDK_SUCCEED ||
+			BATappend(r2t, c, NULL, false) != GDK_SUCCEED)
+			msg = createException(MAL, "txtsim.fulltextmatchjoin",
+								  GDK_EXCEPTION);
+		BBPreclaim(c);
+		BBPreclaim(bn);
+	}
+	bat_iterator_end(&ri);
+	if (msg == MAL_SUCCEED) {
+		*r1 = r1t->batCacheid;
+		*r2 = r2t->batCacheid;
+		BBPkeepref(r1t);
+		BBPkeepref(r2t);
+	}
+  exit:
+	reclaim_bats(4, bleft, bright, bcandleft, bcandright);
+	if (msg != MAL_SUCCEED)
+		reclaim_bats(2, r1t, r2t);
+	return msg;
+}
+
+static str
+TXTSIMfulltextscore(Client ctx, dbl *res, const char *const *x, const char *const *q)
+{
+	(void) ctx;
+	if (FTXTscorevalue(res, *x, *q) != GDK_SUCCEED)
+		throw(MAL, "txtsim.fulltextscore", GDK_EXCEPTION);
+	return MAL_SUCCEED;
+}
+
+/* battxtsim.fulltextscore(b, q), battxtsim.fulltextscore(b, s, q) or
+ * battxtsim.fulltextscore(b, s, live, q), the latter two scoring the
+ * rows of b given by s, the last one with the rows of the column in
+ * live as the collection, see opt_fulltext.c */
+static str
+BATTXTSIMfulltextscore(Client ctx, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	(void) ctx;
+	(void) mb;
+	bat *res = getArgReference_bat(stk, pci, 0);
+	bat bid = *getArgReference_bat(stk, pci, 1);
+	bat sid = pci->argc >= 4 ? *getArgReference_bat(stk, pci, 2) : bat_nil;
+	bat lid = pci->argc == 5 ? *getArgReference_bat(stk, pci, 3) : bat_nil;
+	const char *q = *getArgReference_str(stk, pci, pci->argc - 1);
+	BAT *b, *s = NULL, *l = NULL, *bn;
+
+	if ((b = BATdescriptor(bid)) == NULL)
+		throw(MAL, "battxtsim.fulltextscore",
+			  SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+	if ((!is_bat_nil(sid) && (s = BATdescriptor(sid)) == NULL) ||
+		(!is_bat_nil(lid) && (l = BATdescriptor(lid)) == NULL)) {
+		BBPunfix(b->batCacheid);
+		BBPreclaim(s);
+		throw(MAL, "battxtsim.fulltextscore",
+			  SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+	}
+	bn = FTXTscore(b, s, l, q);
+	BBPunfix(b->batCacheid);
+	BBPreclaim(s);
+	BBPreclaim(l);
+	if (bn == NULL)
+		throw(MAL, "battxtsim.fulltextscore", GDK_EXCEPTION);
+	*res = bn->batCacheid;
+	BBPkeepref(bn);
+	return MAL_SUCCEED;
+}
+
 #include "mel.h"
 static mel_func txtsim_init_funcs[] = {
 	pattern("txtsim", "dameraulevenshtein", TXTSIMdameraulevenshtein, false, "Calculates Damerau-Levenshtein distance between two strings, operation costs (ins/del = 1, replacement = 1, transposition = 2)", args(1,3,arg("",int),arg("x",str),arg("y",str))),
@@ -1540,6 +1746,14 @@ static mel_func txtsim_init_funcs[] = {
 	command("txtsim", "jarowinkler", TXTSIMjarowinkler, false, "Calculate Jaro Winkler similarity", args(1,3, arg("",dbl),arg("x",str),arg("y",str))),
 	command("txtsim", "minjarowinkler", TXTSIMminjarowinkler, false, "", args(1, 4, arg("",bit), arg("l",str),arg("r",str),arg("threshold",dbl))),
 	command("txtsim", "minjarowinklerjoin", TXTSIMminjarowinklerjoin, false, "", args(2, 10, batarg("",oid),batarg("",oid), batarg("l",str),batarg("r",str),batarg("threshold",dbl),batarg("sl",oid),batarg("sr",oid),arg("nil_matches",bit),arg("estimate",lng),arg("anti",bit))),
+	command("txtsim", "fulltextmatch", TXTSIMfulltextmatch, false, "Whether the string contains all words of the query", args(1,3, arg("",bit),arg("x",str),arg("q",str))),
+	command("battxtsim", "fulltextmatch", BATTXTSIMfulltextmatch, false, "Same as fulltextmatch but for BATS", args(1,3, batarg("",bit),batarg("x",str),batarg("q",str))),
+	command("txtsim", "fulltextmatchselect", TXTSIMfulltextmatchselect, false, "Select the rows of b that contain all words of the query, using the full-text index if there is one", args(1,5, batarg("",oid),batarg("b",str),batarg("s",oid),arg("q",str),arg("anti",bit))),
+	command("txtsim", "fulltextmatchjoin", TXTSIMfulltextmatchjoin, false, "Join the strings of l with the queries of r", args(2,9, batarg("",oid),batarg("",oid),batarg("l",str),batarg("r",str),batarg("sl",oid),batarg("sr",oid),arg("nil_matches",bit),arg("estimate",lng),arg("anti",bit))),
+	command("txtsim", "fulltextscore", TXTSIMfulltextscore, false, "BM25 score of the string for the query", args(1,3, arg("",dbl),arg("x",str),arg("q",str))),
+	pattern("battxtsim", "fulltextscore", BATTXTSIMfulltextscore, false, "BM25 score of the strings for the query", args(1,3, batarg("",dbl),batarg("b",str),arg("q",str))),
+	pattern("battxtsim", "fulltextscore", BATTXTSIMfulltextscore, false, "BM25 score of the rows of b given by s for the query", args(1,4, batarg("",dbl),batarg("b",str),batarg("s",oid),arg("q",str))),
+	pattern("battxtsim", "fulltextscore", BATTXTSIMfulltextscore, false, "BM25 score of the rows of b given by s for the query, over the rows of the column in live", args(1,5, batarg("",dbl),batarg("b",str),batarg("s",oid),batarg("live",oid),arg("q",str))),
 	{ .imp=NULL }
 };
 #include "mal_import.h"
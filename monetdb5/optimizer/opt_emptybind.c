@@ -240,15 +240,18 @@ OPTemptybindImplementation(Client ctx, MalBlkPtr mb, MalStkPtr stk,
 				emptyresult(0);
 			}
 		}
-		if ((getModuleId(p) == algebraRef || getModuleId(p) == dictRef)
+		if ((getModuleId(p) == algebraRef || getModuleId(p) == dictRef
+			 || getModuleId(p) == fsstRef)
 			&& (getFunctionId(p) == thetaselectRef
-				|| getFunctionId(p) == selectRef)) {
+				|| getFunctionId(p) == selectRef
+				|| getFunctionId(p) == prefixselectRef)) {
 			if (empty[getArg(p, 1)] || empty[getArg(p, 2)]) {
 				actions++;
 				emptyresult(0);
 			}
 		}
-		if (getModuleId(p) == forRef && getFunctionId(p) == decompressRef) {
+		if ((getModuleId(p) == forRef || getModuleId(p) == fsstRef)
+			&& getFunctionId(p) == decompressRef) {
 			if (empty[getArg(p, 1)]) {
 				actions++;
 				emptyresult(0);
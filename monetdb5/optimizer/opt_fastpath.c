@@ -19,12 +19,15 @@
 #include "opt_dataflow.h"
 #include "opt_deadcode.h"
 #include "opt_dict.h"
+#include "opt_fsst.h"
 #include "opt_for.h"
 #include "opt_emptybind.h"
 #include "opt_evaluate.h"
 #include "opt_garbageCollector.h"
 #include "opt_generator.h"
 #include "opt_inline.h"
+#include "opt_jsonpath.h"
+#include "opt_fulltext.h"
 #include "opt_projectionpath.h"
 #include "opt_matpack.h"
 #include "opt_postfix.h"
@@ -79,6 +82,9 @@ OPTminimalpipeImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk,
 	optcall(OPTdeadcodeImplementation);
 	optcall(OPTforImplementation);
 	optcall(OPTdictImplementation);
+	optcall(OPTfsstImplementation);
+	optcall(OPTjsonpathImplementation);
+	optcall(OPTfulltextImplementation);
 	if (multiplex)
 		optcall(OPTmultiplexImplementation);
 	if (generator)
@@ -134,10 +140,13 @@ OPTdefaultpipeImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk,
 	optcall(OPTaliasesImplementation);
 	optcall(OPTforImplementation);
 	optcall(OPTdictImplementation);
+	optcall(OPTfsstImplementation);
 	if (!no_mitosis) {
 		optcall(OPTmitosisImplementation);
 		optcall(OPTmergetableImplementation); /* depends on mitosis */
 	}
+	optcall(OPTjsonpathImplementation);
+	optcall(OPTfulltextImplementation);
 	optcall(OPTaliasesImplementation);
 	optcall(OPTconstantsImplementation);
 	if (!recursive)
@@ -0,0 +1,279 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * For copyright information, see the file debian/copyright.
+ */
+
+/*
+ * Push fsst.decompress(o, u) down the plan.  Projections and groupings
+ * work on the encoded values directly, equality selects and prefix
+ * LIKE selects are replaced by their fsst counterparts.  Only the
+ * remaining uses get a decompressed column.
+ */
+
+#include "monetdb_config.h"
+#include "opt_fsst.h"
+
+static int
+findPipelines(MalBlkPtr mb)
+{
+	for(int i = 0; i<mb->stop;i++) {
+		InstrPtr p = mb->stmt[i];
+
+		if (blockStart(p) && getModuleId(p) == languageRef && getFunctionId(p) == pipelinesRef)
+			return 1;
+	}
+	return 0;
+}
+
+/* return the prefix of a LIKE pattern of the form 'prefix%', or NULL */
+static const char *
+likePrefix(MalBlkPtr mb, InstrPtr p, allocator *ta)
+{
+	const char *pat, *esc;
+	size_t len;
+
+	if (!isVarConstant(mb, getArg(p, 3)) || !isVarConstant(mb, getArg(p, 4)) ||
+		!isVarConstant(mb, getArg(p, 5)) || getVarConstant(mb, getArg(p, 5)).val.btval)
+		return NULL;			/* ilike */
+	pat = getVarConstant(mb, getArg(p, 3)).val.sval;
+	esc = getVarConstant(mb, getArg(p, 4)).val.sval;
+	if (strNil(pat) || strNil(esc) || (len = strlen(pat)) < 2 || pat[len - 1] != '%')
+		return NULL;
+	for (size_t i = 0; i < len - 1; i++) {
+		if (pat[i] == '%' || pat[i] == '_' || (*esc && pat[i] == *esc))
+			return NULL;
+	}
+	char *prefix = ma_alloc(ta, len);
+	if (prefix == NULL)
+		return NULL;
+	memcpy(prefix, pat, len - 1);
+	prefix[len - 1] = 0;
+	return prefix;
+}
+
+str
+OPTfsstImplementation(Client ctx, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	int i, j, k, limit, slimit;
+	InstrPtr p = NULL, *old = NULL;
+	int actions = 0;
+	int *varisfsst = NULL, *varfsstsyms = NULL;
+	str msg = MAL_SUCCEED;
+	allocator *ta = MT_thread_getallocator();
+
+	(void) stk;
+
+	if (mb->inlineProp || MB_LARGE(mb) || findPipelines(mb))
+		goto wrapup1;
+
+	limit = mb->stop;
+
+	for (i = 0; i < limit; i++) {
+		p = mb->stmt[i];
+		if (p && p->retc == 1 && getModuleId(p) == fsstRef
+			&& getFunctionId(p) == decompressRef) {
+			break;
+		}
+	}
+	if (i == limit)
+		goto wrapup1;			/* nothing to do */
+
+	allocator_state ta_state = ma_open(ta);
+	varisfsst = ma_zalloc(ta, 2 * mb->vtop * sizeof(int));
+	varfsstsyms = ma_zalloc(ta, 2 * mb->vtop * sizeof(int));
+	if (varisfsst == NULL || varfsstsyms == NULL)
+		goto wrapup;
+
+	slimit = mb->ssize;
+	old = mb->stmt;
+	if (newMalBlkStmt(mb, mb->ssize) < 0) {
+		ma_close(&ta_state);
+		throw(MAL, "optimizer.fsst", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+	}
+	/* Consolidate the actual need for variables */
+	for (i = 0; mb->errors == NULL && i < limit; i++) {
+		p = old[i];
+		if (p == NULL)
+			continue;			/* left behind by others? */
+		if (p->retc == 1 && getModuleId(p) == fsstRef
+			&& getFunctionId(p) == decompressRef) {
+			/* remember we have encountered a fsst decompress function */
+			k = getArg(p, 0);
+			varisfsst[k] = getArg(p, 1);
+			varfsstsyms[k] = getArg(p, 2);
+			freeInstruction(mb, p);
+			continue;
+		}
+		int done = 0;
+		for (j = p->retc; j < p->argc; j++) {
+			k = getArg(p, j);
+			if (varisfsst[k]) {	/* maybe we could delay this usage */
+				const char *prefix = NULL;
+
+				if (getModuleId(p) == algebraRef
+					&& getFunctionId(p) == projectionRef) {
+					/* projection(cand, col) with col = fsst.decompress(o,u)
+					 * v1 = projection(cand, o)
+					 * fsst.decompress(v1, u) */
+					InstrPtr r = copyInstruction(mb, p);
+					if (r == NULL) {
+						msg = createException(MAL, "optimizer.fsst",
+											  SQLSTATE(HY013) MAL_MALLOC_FAIL);
+						break;
+					}
+					int tpe = getVarType(mb, varisfsst[k]);
+					int l = getArg(r, 0);
+					getArg(r, 0) = newTmpVariable(mb, tpe);
+					getArg(r, j) = varisfsst[k];
+					varisfsst[l] = getArg(r, 0);
+					varfsstsyms[l] = varfsstsyms[k];
+					pushInstruction(mb, r);
+					freeInstruction(mb, p);
+					done = 1;
+					break;
+				} else if (p->argc == 2 && p->retc == 1
+						   && p->barrier == ASSIGNsymbol) {
+					/* a = b */
+					int l = getArg(p, 0);
+					varisfsst[l] = varisfsst[k];
+					varfsstsyms[l] = varfsstsyms[k];
+					freeInstruction(mb, p);
+					done = 1;
+					break;
+				} else if ((getModuleId(p) == algebraRef
+							&& getFunctionId(p) == subsliceRef)
+						   || (getModuleId(p) == aggrRef
+							   && (getFunctionId(p) == countRef
+								   || getFunctionId(p) == count_no_nilRef))
+						   || (getModuleId(p) == batRef
+							   && getFunctionId(p) == mirrorRef)
+						   || (getModuleId(p) == batcalcRef
+							   && getFunctionId(p) == identityRef)) {
+					/* pos = subslice/count/mirror/identity(col, ...) with col = fsst.decompress(o,u)
+					 * pos = subslice/count/mirror/identity(o, ...), nil stays nil */
+					InstrPtr r = copyInstruction(mb, p);
+					if (r == NULL) {
+						msg = createException(MAL, "optimizer.fsst",
+											  SQLSTATE(HY013) MAL_MALLOC_FAIL);
+						break;
+					}
+					getArg(r, j) = varisfsst[k];
+					pushInstruction(mb, r);
+					freeInstruction(mb, p);
+					done = 1;
+					break;
+				} else if (getModuleId(p) == algebraRef
+						   && getFunctionId(p) == thetaselectRef
+						   && p->argc == 5 && j == 1) {
+					/* pos = thetaselect(col, cand, val, op) with col = fsst.decompress(o,u)
+					 * pos = fsst.thetaselect(o, cand, u, val, op) */
+					InstrPtr r = newInstructionArgs(mb, fsstRef, thetaselectRef, 6);
+					if (r == NULL) {
+						msg = createException(MAL, "optimizer.fsst",
+											  SQLSTATE(HY013) MAL_MALLOC_FAIL);
+						break;
+					}
+					getArg(r, 0) = getArg(p, 0);
+					r = pushArgument(mb, r, varisfsst[k]);
+					r = pushArgument(mb, r, getArg(p, 2));	/* cand */
+					r = pushArgument(mb, r, varfsstsyms[k]);
+					r = pushArgument(mb, r, getArg(p, 3));	/* val */
+					r = pushArgument(mb, r, getArg(p, 4));	/* op */
+					pushInstruction(mb, r);
+					freeInstruction(mb, p);
+					done = 1;
+					break;
+				} else if (getModuleId(p) == algebraRef
+						   && getFunctionId(p) == likeselectRef
+						   && p->argc == 7 && j == 1
+						   && (prefix = likePrefix(mb, p, ta)) != NULL) {
+					/* pos = likeselect(col, cand, 'prefix%', esc, false, anti) with col = fsst.decompress(o,u)
+					 * pos = fsst.prefixselect(o, cand, u, 'prefix', anti) */
+					InstrPtr r = newInstructionArgs(mb, fsstRef, prefixselectRef, 6);
+					if (r == NULL) {
+						msg = createException(MAL, "optimizer.fsst",
+											  SQLSTATE(HY013) MAL_MALLOC_FAIL);
+						break;
+					}
+					getArg(r, 0) = getArg(p, 0);
+					r = pushArgument(mb, r, varisfsst[k]);
+					r = pushArgument(mb, r, getArg(p, 2));	/* cand */
+					r = pushArgument(mb, r, varfsstsyms[k]);
+					r = pushStr(mb, r, prefix);
+					r = pushArgument(mb, r, getArg(p, 6));	/* anti */
+					pushInstruction(mb, r);
+					freeInstruction(mb, p);
+					done = 1;
+					break;
+				} else if (getModuleId(p) == groupRef
+						   && (getFunctionId(p) == subgroupRef
+							   || getFunctionId(p) == subgroupdoneRef
+							   || getFunctionId(p) == groupRef
+							   || getFunctionId(p) == groupdoneRef)
+						   && j == p->retc) {
+					/* group.group[done](col) | group.subgroup[done](col, grp) with col = fsst.decompress(o,u)
+					 * v1 = group.group[done](o) | group.subgroup[done](o, grp)
+					 * equal strings have equal encodings */
+					InstrPtr r = copyInstruction(mb, p);
+					if (r == NULL) {
+						msg = createException(MAL, "optimizer.fsst",
+											  SQLSTATE(HY013) MAL_MALLOC_FAIL);
+						break;
+					}
+					getArg(r, j) = varisfsst[k];
+					pushInstruction(mb, r);
+					freeInstruction(mb, p);
+					done = 1;
+					break;
+				} else {
+					/* need to decompress */
+					int tpe = getArgType(mb, p, j);
+					InstrPtr r = newInstructionArgs(mb, fsstRef, decompressRef, 3);
+					if (r == NULL) {
+						msg = createException(MAL, "optimizer.fsst",
+											  SQLSTATE(HY013) MAL_MALLOC_FAIL);
+						break;
+					}
+					getArg(r, 0) = newTmpVariable(mb, tpe);
+					r = pushArgument(mb, r, varisfsst[k]);
+					r = pushArgument(mb, r, varfsstsyms[k]);
+					pushInstruction(mb, r);
+
+					getArg(p, j) = getArg(r, 0);
+					actions++;
+				}
+			}
+		}
+		if (msg)
+			break;
+		if (done)
+			actions++;
+		else
+			pushInstruction(mb, p);
+	}
+
+	for (; i < slimit; i++)
+		if (old[i])
+			freeInstruction(mb, old[i]);
+	/* Defense line against incorrect plans */
+	if (msg == MAL_SUCCEED && actions > 0) {
+		msg = chkTypes(ctx->usermodule, mb, FALSE);
+		if (!msg)
+			msg = chkFlow(mb);
+		if (!msg)
+			msg = chkDeclarations(mb);
+	}
+	/* keep all actions taken as a post block comment */
+  wrapup:
+	ma_close(&ta_state);
+  wrapup1:
+	/* keep actions taken as a fake argument */
+	(void) pushInt(mb, pci, actions);
+
+	return msg;
+}
@@ -0,0 +1,21 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * For copyright information, see the file debian/copyright.
+ */
+
+#ifndef _OPT_FSST_
+#define _OPT_FSST_
+#include "opt_support.h"
+#include "mal_interpreter.h"
+#include "mal_instruction.h"
+#include "mal_function.h"
+
+extern str OPTfsstImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk,
+								 InstrPtr pci);
+
+#endif
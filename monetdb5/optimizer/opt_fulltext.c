@@ -0,0 +1,154 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * For copyright information, see the file debian/copyright.
+ */
+
+/*
+ * Let battxtsim.fulltextscore see the stored string column.  A
+ * projection of the column followed by scoring becomes a single
+ * battxtsim.fulltextscore(col, cand, query), so that the word counts
+ * of the rows can be taken from the full-text index of the column
+ * rather than from tokenizing the projected values.  If the column
+ * comes from sql.bind, the live rows of the whole table are passed as
+ * well, so that the collection statistics are those of the column and
+ * not of the rows that are scored, or of a partition of the column.
+ */
+
+#include "monetdb_config.h"
+#include "opt_fulltext.h"
+
+str
+OPTfulltextImplementation(Client ctx, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	int i, limit, slimit;
+	InstrPtr p, *old = NULL, *defs = NULL;
+	int actions = 0;
+	str msg = MAL_SUCCEED;
+	allocator *ta = MT_thread_getallocator();
+
+	(void) stk;
+
+	if (mb->inlineProp || MB_LARGE(mb))
+		goto wrapup1;
+
+	limit = mb->stop;
+	slimit = mb->ssize;
+	for (i = 0; i < limit; i++) {
+		p = mb->stmt[i];
+		if (p && getModuleId(p) == battxtsimRef && getFunctionId(p) == fulltextscoreRef)
+			break;
+	}
+	if (i == limit)
+		goto wrapup1;			/* nothing to do */
+
+	allocator_state ta_state = ma_open(ta);
+	/* the projection or sql.bind that assigned each variable, if any */
+	defs = ma_zalloc(ta, mb->vtop * sizeof(InstrPtr));
+	if (defs == NULL) {
+		msg = createException(MAL, "optimizer.fulltext",
+							  SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		goto wrapup;
+	}
+	old = mb->stmt;
+	if (newMalBlkStmt(mb, mb->ssize) < 0) {
+		msg = createException(MAL, "optimizer.fulltext",
+							  SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		old = NULL;
+		goto wrapup;
+	}
+
+	for (i = 0; mb->errors == NULL && i < limit; i++) {
+		p = old[i];
+		if (p == NULL)
+			continue;
+		old[i] = NULL;
+		if (getModuleId(p) == algebraRef && getFunctionId(p) == projectionRef
+			&& p->retc == 1 && p->argc == 3
+			&& getArgType(mb, p, 0) == getArgType(mb, p, 2)) {
+			defs[getArg(p, 0)] = p;
+		} else if (getModuleId(p) == sqlRef && getFunctionId(p) == bindRef
+				   && p->retc == 1 && (p->argc == 6 || p->argc == 8)
+				   && isVarConstant(mb, getArg(p, 5))
+				   && getVarConstant(mb, getArg(p, 5)).val.ival == 0) {
+			defs[getArg(p, 0)] = p;
+		} else if (getModuleId(p) == battxtsimRef && getFunctionId(p) == fulltextscoreRef
+				   && p->retc == 1 && (p->argc == 3 || p->argc == 4)) {
+			InstrPtr q = defs[getArg(p, 1)];
+			int col = -1, cand = -1;
+
+			if (p->argc == 3 && q != NULL && getFunctionId(q) == projectionRef) {
+				/* Y := algebra.projection(X, C); Z := battxtsim.fulltextscore(Y, q)
+				 * Z := battxtsim.fulltextscore(C, X, q) */
+				col = getArg(q, 2);
+				cand = getArg(q, 1);
+			} else if (p->argc == 4 && (q = defs[getArg(p, 1)]) != NULL
+					   && getFunctionId(q) == bindRef) {
+				col = getArg(p, 1);
+				cand = getArg(p, 2);
+			}
+			if (col >= 0) {
+				InstrPtr b = defs[col], t = NULL, r;
+				if (b != NULL && getFunctionId(b) == bindRef) {
+					/* L := sql.tid(mvc, sch, tab), the live rows of
+					 * the whole table, also when b is a partition */
+					t = newStmtArgs(mb, sqlRef, tidRef, 4);
+					if (t == NULL) {
+						msg = createException(MAL, "optimizer.fulltext",
+											  SQLSTATE(HY013) MAL_MALLOC_FAIL);
+						pushInstruction(mb, p);
+						i++;
+						break;
+					}
+					setVarType(mb, getArg(t, 0), newBatType(TYPE_oid));
+					t = pushArgument(mb, t, getArg(b, 1));
+					t = pushArgument(mb, t, getArg(b, 2));
+					t = pushArgument(mb, t, getArg(b, 3));
+					pushInstruction(mb, t);
+				}
+				/* Z := battxtsim.fulltextscore(C, X, L, q) */
+				r = newInstructionArgs(mb, battxtsimRef, fulltextscoreRef, t ? 5 : 4);
+				if (r == NULL) {
+					msg = createException(MAL, "optimizer.fulltext",
+										  SQLSTATE(HY013) MAL_MALLOC_FAIL);
+					pushInstruction(mb, p);
+					i++;
+					break;
+				}
+				getArg(r, 0) = getArg(p, 0);
+				r = pushArgument(mb, r, col);
+				r = pushArgument(mb, r, cand);
+				if (t)
+					r = pushArgument(mb, r, getArg(t, 0));
+				r = pushArgument(mb, r, getArg(p, p->argc - 1));
+				freeInstruction(mb, p);
+				p = r;
+				actions++;
+			}
+		}
+		pushInstruction(mb, p);
+	}
+	for (; i < slimit; i++)
+		if (old[i])
+			pushInstruction(mb, old[i]);
+
+	/* Defense line against incorrect plans */
+	if (msg == MAL_SUCCEED && actions > 0) {
+		msg = chkTypes(ctx->usermodule, mb, FALSE);
+		if (!msg)
+			msg = chkFlow(mb);
+		if (!msg)
+			msg = chkDeclarations(mb);
+	}
+  wrapup:
+	ma_close(&ta_state);
+  wrapup1:
+	/* keep actions taken as a fake argument */
+	(void) pushInt(mb, pci, actions);
+
+	return msg;
+}
@@ -0,0 +1,160 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * For copyright information, see the file debian/copyright.
+ */
+
+/*
+ * Let batjson.filter see the stored json column.  A projection of the
+ * column followed by a path extraction becomes a single
+ * batjson.filter(col, cand, path), and json.integer, json.number and
+ * json.text of the extraction are folded into it.  That way the json
+ * module can answer popular paths from its shredded sub-columns
+ * instead of parsing every document.
+ */
+
+#include "monetdb_config.h"
+#include "opt_jsonpath.h"
+
+static int
+findPipelines(MalBlkPtr mb)
+{
+	for(int i = 0; i<mb->stop;i++) {
+		InstrPtr p = mb->stmt[i];
+
+		if (blockStart(p) && getModuleId(p) == languageRef && getFunctionId(p) == pipelinesRef)
+			return 1;
+	}
+	return 0;
+}
+
+/* the batjson function replacing json.<fcn>(batjson.filter(...)) */
+static const char *
+foldedFunction(MalBlkPtr mb, InstrPtr p)
+{
+	const char *mod, *fcn;
+
+	if (getModuleId(p) != malRef || getFunctionId(p) != multiplexRef
+		|| p->retc != 1 || p->argc != 4
+		|| !isVarConstant(mb, getArg(p, 1)) || !isVarConstant(mb, getArg(p, 2)))
+		return NULL;
+	mod = getVarConstant(mb, getArg(p, 1)).val.sval;
+	fcn = getVarConstant(mb, getArg(p, 2)).val.sval;
+	if (strNil(mod) || strNil(fcn) || strcmp(mod, jsonRef) != 0)
+		return NULL;
+	switch (getBatType(getArgType(mb, p, 0))) {
+	case TYPE_lng:
+		return strcmp(fcn, integerRef) == 0 ? filterintegerRef : NULL;
+	case TYPE_dbl:
+		return strcmp(fcn, numberRef) == 0 ? filternumberRef : NULL;
+	case TYPE_str:
+		return strcmp(fcn, textRef) == 0 ? filtertextRef : NULL;
+	default:
+		return NULL;
+	}
+}
+
+str
+OPTjsonpathImplementation(Client ctx, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	int i, limit;
+	InstrPtr p, *defs = NULL;
+	int actions = 0;
+	str msg = MAL_SUCCEED;
+	allocator *ta = MT_thread_getallocator();
+
+	(void) stk;
+
+	if (mb->inlineProp || MB_LARGE(mb) || findPipelines(mb))
+		goto wrapup1;
+
+	limit = mb->stop;
+	for (i = 0; i < limit; i++) {
+		p = mb->stmt[i];
+		if (p && getModuleId(p) == batjsonRef && getFunctionId(p) == filterRef)
+			break;
+	}
+	if (i == limit)
+		goto wrapup1;			/* nothing to do */
+
+	allocator_state ta_state = ma_open(ta);
+	/* the instruction that assigned each variable, if interesting */
+	defs = ma_zalloc(ta, mb->vtop * sizeof(InstrPtr));
+	if (defs == NULL)
+		goto wrapup;
+
+	for (i = 0; mb->errors == NULL && i < limit; i++) {
+		p = mb->stmt[i];
+		if (p == NULL)
+			continue;
+		if (getModuleId(p) == algebraRef && getFunctionId(p) == projectionRef
+			&& p->retc == 1 && p->argc == 3
+			&& getArgType(mb, p, 0) == getArgType(mb, p, 2)) {
+			defs[getArg(p, 0)] = p;
+		} else if (getModuleId(p) == batjsonRef && getFunctionId(p) == filterRef
+				   && p->retc == 1 && isVarConstant(mb, getArg(p, p->argc - 1))) {
+			InstrPtr q = defs[getArg(p, 1)];
+
+			if (p->argc == 3 && q != NULL) {
+				/* Y := algebra.projection(C, X); Z := batjson.filter(Y, path)
+				 * Z := batjson.filter(X, C, path) */
+				InstrPtr r = newInstructionArgs(mb, batjsonRef, filterRef, 4);
+				if (r == NULL) {
+					msg = createException(MAL, "optimizer.jsonpath",
+										  SQLSTATE(HY013) MAL_MALLOC_FAIL);
+					break;
+				}
+				getArg(r, 0) = getArg(p, 0);
+				r = pushArgument(mb, r, getArg(q, 2));
+				r = pushArgument(mb, r, getArg(q, 1));
+				r = pushArgument(mb, r, getArg(p, 2));
+				mb->stmt[i] = r;
+				freeInstruction(mb, p);
+				p = r;
+				actions++;
+			}
+			defs[getArg(p, 0)] = p;
+		} else {
+			const char *fcn = foldedFunction(mb, p);
+			InstrPtr q;
+
+			if (fcn != NULL && (q = defs[getArg(p, 3)]) != NULL
+				&& getModuleId(q) == batjsonRef && getFunctionId(q) == filterRef) {
+				/* Z := batjson.filter(X, C, path); R := mal.multiplex("json", "integer", Z)
+				 * R := batjson.filterinteger(X, C, path) */
+				InstrPtr r = newInstructionArgs(mb, batjsonRef, fcn, q->argc);
+				if (r == NULL) {
+					msg = createException(MAL, "optimizer.jsonpath",
+										  SQLSTATE(HY013) MAL_MALLOC_FAIL);
+					break;
+				}
+				getArg(r, 0) = getArg(p, 0);
+				for (int j = q->retc; j < q->argc; j++)
+					r = pushArgument(mb, r, getArg(q, j));
+				mb->stmt[i] = r;
+				freeInstruction(mb, p);
+				actions++;
+			}
+		}
+	}
+
+	/* Defense line against incorrect plans */
+	if (msg == MAL_SUCCEED && actions > 0) {
+		msg = chkTypes(ctx->usermodule, mb, FALSE);
+		if (!msg)
+			msg = chkFlow(mb);
+		if (!msg)
+			msg = chkDeclarations(mb);
+	}
+  wrapup:
+	ma_close(&ta_state);
+  wrapup1:
+	/* keep actions taken as a fake argument */
+	(void) pushInt(mb, pci, actions);
+
+	return msg;
+}
@@ -2687,7 +2687,8 @@ OPTmergetableImplementation(Client ctx, MalBlkPtr mb, MalStkPtr stk,
 		if (match > 0
 			&&
 			((getModuleId(p) == algebraRef && getFunctionId(p) == projectionRef)
-			 || ((getModuleId(p) == dictRef || getModuleId(p) == forRef)
+			 || ((getModuleId(p) == dictRef || getModuleId(p) == forRef
+				  || getModuleId(p) == fsstRef)
 				 && getFunctionId(p) == decompressRef))
 			&& (m = is_a_mat(getArg(p, 1), &ml)) >= 0) {
 			n = is_a_mat(getArg(p, 2), &ml);
@@ -2805,9 +2806,9 @@ OPTmergetableImplementation(Client ctx, MalBlkPtr mb, MalStkPtr stk,
 			continue;
 		}
 
-		/* handle dict select */
+		/* handle dict and fsst select */
 		if ((match == 1 || match == bats - 1) && p->retc == 1 && isSelect(p)
-			&& getModuleId(p) == dictRef) {
+			&& (getModuleId(p) == dictRef || getModuleId(p) == fsstRef)) {
 			if (mat_apply(ta, mb, p, &ml, match)) {
 				msg = createException(MAL, "optimizer.mergetable",
 									  SQLSTATE(HY013) MAL_MALLOC_FAIL);
@@ -14,6 +14,8 @@
 #include "mal_interpreter.h"
 
 #define MIN_PART_SIZE 100000	/* minimal record count per partition */
+#define MIN_PART_ROWS 16384		/* minimal record count per partition of wide tables */
+#define MAX_PART_ROWS (8 * MIN_PART_SIZE)	/* minimal record count per partition of narrow tables */
 #define MAX_PARTS2THREADS_RATIO 4	/* There should be at most this multiple more of partitions than threads */
 
 
@@ -22,10 +24,12 @@ OPTmitosisImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk,
 						 InstrPtr pci)
 {
 	int i, j, limit, slimit, pieces = 1, mito_parts = 0,
-		mito_size = 0, row_size = 0, mt = -1, nr_cols = 0, nr_aggrs = 0,
-		nr_maps = 0;
+		mito_size = 0, row_size = 0, row_width = 0, mt = -1, nr_cols = 0,
+		nr_aggrs = 0, nr_maps = 0;
 	str schema = 0, table = 0;
 	BUN r = 0, rowcnt = 0;		/* table should be sizeable to consider parallel execution */
+	BUN minrows, sorted_rows = 0, oidx_rows = 0;
+	size_t cache;
 	InstrPtr p, q, *old, target = 0;
 	size_t argsize = 6 * sizeof(lng), m = 0;
 	/*       estimate size per operator estimate:   4 args + 2 res */
@@ -105,6 +109,19 @@ OPTmitosisImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk,
 			goto bailout;
 		}
 
+		/* remember selections on ordered columns */
+		if (getModuleId(p) == algebraRef
+			&& (getFunctionId(p) == selectRef
+				|| getFunctionId(p) == thetaselectRef)
+			&& p->argc > p->retc) {
+			int a = getArg(p, p->retc);
+
+			if (isVarOrderIdx(mb, a) && getRowCnt(mb, a) > oidx_rows)
+				oidx_rows = getRowCnt(mb, a);
+			else if (isVarSorted(mb, a) && getRowCnt(mb, a) > sorted_rows)
+				sorted_rows = getRowCnt(mb, a);
+		}
+
 		/* locate the largest non-partitioned table */
 		if (getModuleId(p) != sqlRef
 			|| (getFunctionId(p) != bindRef
@@ -124,11 +141,14 @@ OPTmitosisImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk,
 		 * single subplan should ideally fit together.
 		 */
 		r = getRowCnt(mb, getArg(p, 0));
-		if (r == rowcnt)
+		if (r == rowcnt) {
 			nr_cols++;
+			row_width += ATOMsize(getBatType(getArgType(mb, p, 0)));
+		}
 		if (r > rowcnt) {
 			/* the rowsize depends on the column types */
 			row_size = ATOMsize(getBatType(getArgType(mb, p, 0)));
+			row_width = row_size;
 			rowcnt = r;
 			nr_cols = 1;
 			target = p;
@@ -154,9 +174,10 @@ OPTmitosisImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk,
 	 * because all user together are responsible for resource contentions
 	 */
 
-	/* improve memory usage estimation */
+	/* improve memory usage estimation, the columns of the table take
+	 * their own width, aggregates and maps produce at most a lng per row */
 	if (nr_cols > 1 || nr_aggrs > 1 || nr_maps > 1)
-		argsize = (nr_cols + nr_aggrs + nr_maps) * sizeof(lng);
+		argsize = row_width + (nr_aggrs + nr_maps) * sizeof(lng);
 	/* We haven't assigned the number of pieces.
 	 * Determine the memory available for this client
 	 */
@@ -188,17 +209,48 @@ OPTmitosisImplementation(Client cntxt, MalBlkPtr mb, MalStkPtr stk,
 		pieces = ((int) ceil((double) rowcnt / (m / threads)));
 		if (pieces <= threads)
 			pieces = threads;
-	} else if (rowcnt > MIN_PART_SIZE) {
+	} else {
 		/* exploit parallelism, but ensure minimal partition size to
-		 * limit overhead */
-		pieces = MIN((int) ceil((double) rowcnt / MIN_PART_SIZE),
-					 MAX_PARTS2THREADS_RATIO * threads);
+		 * limit overhead.  A partition should fill the share of the
+		 * cache of the thread working on it, which means fewer rows for
+		 * wide tables and more rows for narrow ones */
+		cache = MT_l3cachesize() / MAX(MT_check_nr_cores(), threads);
+		if (cache < MT_l2cachesize())
+			cache = MT_l2cachesize();
+		minrows = (BUN) (cache / (row_width > 0 ? row_width : 1));
+		if (minrows < MIN_PART_ROWS)
+			minrows = MIN_PART_ROWS;
+		else if (minrows > MAX_PART_ROWS)
+			minrows = MAX_PART_ROWS;
+		if (rowcnt > minrows)
+			pieces = MIN((int) ceil((double) rowcnt / minrows),
+						 MAX_PARTS2THREADS_RATIO * threads);
 	}
 
 	/* when testing, always aim for full parallelism, but avoid
 	 * empty pieces */
 	FORCEMITODEBUG if (pieces < threads)
 		 pieces = (int) MIN((BUN) threads, rowcnt);
+
+	if (pieces > 1) {
+		if (oidx_rows == rowcnt) {
+			/* each piece selects using the ordered index of the whole
+			 * column, more pieces than threads repeat that work */
+			if (pieces > threads)
+				pieces = threads;
+		} else if (sorted_rows == rowcnt && pieces < 2 * threads) {
+			/* a range selection on a sorted column concentrates its
+			 * result in a few pieces, smaller pieces spread the work
+			 * over the threads */
+			pieces = MAX(pieces,
+						 (int) MIN((BUN) (2 * threads), rowcnt / MIN_PART_ROWS));
+		}
+		/* complete the last round of pieces over the threads, to
+		 * avoid threads waiting for a single straggling piece */
+		if (pieces > threads && pieces % threads != 0)
+			pieces += threads - pieces % threads;
+	}
+
 	/* prevent plan explosion */
 	if (pieces > maxparts)
 		pieces = maxparts;
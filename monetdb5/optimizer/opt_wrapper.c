@@ -35,11 +35,14 @@
 #include "opt_garbageCollector.h"
 #include "opt_generator.h"
 #include "opt_inline.h"
+#include "opt_jsonpath.h"
+#include "opt_fulltext.h"
 #include "opt_projectionpath.h"
 #include "opt_matpack.h"
 #include "opt_postfix.h"
 #include "opt_for.h"
 #include "opt_dict.h"
+#include "opt_fsst.h"
 #include "opt_mergetable.h"
 #include "opt_mitosis.h"
 #include "opt_multiplex.h"
@@ -78,9 +81,12 @@ static const struct {
 	{"emptybind", &OPTemptybindImplementation},
 	{"evaluate", &OPTevaluateImplementation},
 	{"for", &OPTforImplementation},
+	{"fsst", &OPTfsstImplementation},
+	{"fulltext", &OPTfulltextImplementation},
 	{"garbageCollector", &OPTgarbageCollectorImplementation},
 	{"generator", &OPTgeneratorImplementation},
 	{"inline", &OPTinlineImplementation},
+	{"jsonpath", &OPTjsonpathImplementation},
 	{"matpack", &OPTmatpackImplementation},
 	{"mergetable", &OPTmergetableImplementation},
 	{"mitosis", &OPTmitosisImplementation},
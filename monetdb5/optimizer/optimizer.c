@@ -84,6 +84,9 @@ static mel_func optimizer_init_funcs[] = {
 	optwrapper_pattern("strimps", "Use strimps index if appropriate"),
 	optwrapper_pattern("for", "Push for decompress down"),
 	optwrapper_pattern("dict", "Push dict decompress down"),
+	optwrapper_pattern("fsst", "Push fsst decompress down"),
+	optwrapper_pattern("jsonpath", "Use bulk json path extraction"),
+	optwrapper_pattern("fulltext", "Score full-text search on the stored column"),
 	{.imp = NULL}
 };
 
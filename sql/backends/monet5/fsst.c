@@ -0,0 +1,784 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * For copyright information, see the file debian/copyright.
+ */
+
+/*
+ * FSST (fast static symbol table) compression of string columns.
+ *
+ * A compressed column consists of two string BATs: the encoded values
+ * (the column's main BAT) and the symbol table (the column's extra
+ * BAT, like the dictionary of a DICT compressed column).  The symbol
+ * table holds up to 126 symbols of 1 to 8 ASCII characters which are
+ * learned from a sample of the column.  A value is encoded by greedily
+ * replacing the longest matching symbol by its code, the bytes 1 to
+ * 126.  ASCII characters which are not covered by a symbol are escaped
+ * with byte 127, bytes of multibyte UTF-8 characters are copied as is.
+ * The encoded values are therefore valid UTF-8 strings without NUL
+ * bytes and are stored in an ordinary string heap, including its
+ * duplicate elimination.  Nil stays nil.
+ *
+ * Since the encoding is deterministic and can be reversed, two values
+ * are equal if and only if their encodings are, so equality selects
+ * and grouping are done on the encoded values.  Prefix matches (LIKE
+ * 'abc%') are evaluated by walking the codes of the encoded value
+ * without materializing the decoded string.  Only values which are
+ * projected into a result are decompressed.
+ */
+
+#include "monetdb_config.h"
+#include "sql_monet_backend.h"
+#include "mal.h"
+#include "mal_client.h"
+
+#include "fsst.h"
+
+#define FSST_ESC		0x7F	/* next byte is a literal */
+#define FSST_MAXSYMBOLS	126		/* codes 1 .. 126 */
+#define FSST_SYMLEN		8
+#define FSST_SAMPLEROWS	16384
+#define FSST_SAMPLESIZE	(1 << 18)	/* bytes of text in the sample */
+#define FSST_ROUNDS		5
+
+typedef struct {
+	int nsymbols;
+	uint64_t symbol[FSST_MAXSYMBOLS];	/* symbol bytes, NUL padded */
+	uint8_t len[FSST_MAXSYMBOLS];
+	uint8_t order[FSST_MAXSYMBOLS];		/* by first byte, longest first */
+	uint8_t start[129];			/* first byte -> range in order */
+} fsst_table;
+
+static sql_column *
+get_newcolumn(sql_trans *tr, sql_column *c)
+{
+	sql_table *t = find_sql_table_id(tr, c->t->s, c->t->base.id);
+	if (t)
+		return find_sql_column(t, c->base.name);
+	return NULL;
+}
+
+/* group the symbols on their first byte, longest symbols first, so
+ * that the encoder finds the longest match first */
+static void
+fsst_table_finish(fsst_table *t)
+{
+	int cnt[129] = {0};
+
+	for (int i = 0; i < t->nsymbols; i++)
+		cnt[((const unsigned char *) &t->symbol[i])[0] + 1]++;
+	t->start[0] = 0;
+	for (int c = 1; c <= 128; c++)
+		t->start[c] = (uint8_t) (t->start[c - 1] + cnt[c]);
+	for (int c = 0; c < 128; c++)
+		cnt[c] = t->start[c];
+	for (int l = FSST_SYMLEN; l > 0; l--) {
+		for (int i = 0; i < t->nsymbols; i++) {
+			if (t->len[i] == l)
+				t->order[cnt[((const unsigned char *) &t->symbol[i])[0]]++] = (uint8_t) i;
+		}
+	}
+}
+
+static gdk_return
+fsst_table_load(fsst_table *t, BAT *u)
+{
+	BATiter ui = bat_iterator(u);
+
+	if (ui.count > FSST_MAXSYMBOLS) {
+		bat_iterator_end(&ui);
+		GDKerror("too many symbols\n");
+		return GDK_FAIL;
+	}
+	t->nsymbols = (int) ui.count;
+	for (int i = 0; i < t->nsymbols; i++) {
+		const char *s = BUNtvar(&ui, i);
+		size_t l = strlen(s);
+
+		if (l == 0 || l > FSST_SYMLEN || (s[0] & 0x80)) {
+			bat_iterator_end(&ui);
+			GDKerror("invalid symbol\n");
+			return GDK_FAIL;
+		}
+		t->symbol[i] = 0;
+		memcpy(&t->symbol[i], s, l);
+		t->len[i] = (uint8_t) l;
+	}
+	bat_iterator_end(&ui);
+	fsst_table_finish(t);
+	return GDK_SUCCEED;
+}
+
+/* code of the longest symbol which is a prefix of s, or -1 */
+static inline int
+fsst_match(const fsst_table *t, const unsigned char *s, size_t rem)
+{
+	unsigned char c = s[0];
+
+	for (int k = t->start[c]; k < t->start[c + 1]; k++) {
+		int code = t->order[k];
+		if (t->len[code] <= rem &&
+			memcmp(&t->symbol[code], s, t->len[code]) == 0)
+			return code;
+	}
+	return -1;
+}
+
+/* encode s into dst, which needs room for 2 * len + 1 bytes */
+static size_t
+fsst_encode(const fsst_table *t, const unsigned char *s, size_t len, unsigned char *dst)
+{
+	unsigned char *d = dst;
+
+	for (size_t i = 0; i < len; ) {
+		unsigned char c = s[i];
+		if (c & 0x80) {
+			*d++ = c;
+			i++;
+		} else {
+			int code = fsst_match(t, s + i, len - i);
+			if (code >= 0) {
+				*d++ = (unsigned char) (code + 1);
+				i += t->len[code];
+			} else {
+				*d++ = FSST_ESC;
+				*d++ = c;
+				i++;
+			}
+		}
+	}
+	*d = 0;
+	return (size_t) (d - dst);
+}
+
+/* decode e into dst, which needs room for 8 * strlen(e) + 8 bytes */
+static size_t
+fsst_decode(const fsst_table *t, const unsigned char *e, unsigned char *dst)
+{
+	unsigned char *d = dst;
+	unsigned char c;
+
+	while ((c = *e++) != 0) {
+		if (c & 0x80) {
+			*d++ = c;
+		} else if (c == FSST_ESC) {
+			*d++ = *e++;
+		} else {
+			memcpy(d, &t->symbol[c - 1], FSST_SYMLEN);
+			d += t->len[c - 1];
+		}
+	}
+	*d = 0;
+	return (size_t) (d - dst);
+}
+
+/* does the value encoded as e start with p? */
+static bool
+fsst_hasprefix(const fsst_table *t, const unsigned char *e, const unsigned char *p, size_t plen)
+{
+	while (plen > 0) {
+		unsigned char c = *e++;
+
+		if (c == 0)
+			return false;
+		if (c == FSST_ESC || (c & 0x80)) {
+			if (c == FSST_ESC)
+				c = *e++;
+			if (c != *p)
+				return false;
+			p++;
+			plen--;
+		} else {
+			size_t l = t->len[c - 1];
+			if (l > plen)
+				l = plen;
+			if (memcmp(&t->symbol[c - 1], p, l) != 0)
+				return false;
+			p += l;
+			plen -= l;
+		}
+	}
+	return true;
+}
+
+/*
+ * Symbol table construction.  Starting with an empty table, the sample
+ * is encoded a number of times.  Each round counts how often every
+ * symbol and every escaped character is used, and how often each pair
+ * of them occurs next to each other.  The next table consists of the
+ * symbols and concatenated pairs which cover the most bytes.  The ids
+ * used for counting are the codes (< 128) and 128 + the character for
+ * escaped characters.
+ */
+typedef struct {
+	uint64_t symbol;
+	lng gain;
+	uint8_t len;
+} fsst_cand;
+
+static int
+fsst_cand_symcmp(const void *a, const void *b)
+{
+	const fsst_cand *x = a, *y = b;
+
+	if (x->len != y->len)
+		return x->len < y->len ? -1 : 1;
+	return memcmp(&x->symbol, &y->symbol, FSST_SYMLEN);
+}
+
+static int
+fsst_cand_gaincmp(const void *a, const void *b)
+{
+	const fsst_cand *x = a, *y = b;
+
+	if (x->gain != y->gain)
+		return x->gain > y->gain ? -1 : 1;
+	return fsst_cand_symcmp(a, b);
+}
+
+static inline uint8_t
+fsst_id2symbol(const fsst_table *t, int id, uint64_t *symbol)
+{
+	if (id < 128) {
+		*symbol = t->symbol[id];
+		return t->len[id];
+	}
+	*symbol = 0;
+	*(unsigned char *) symbol = (unsigned char) (id - 128);
+	return 1;
+}
+
+static void
+fsst_count(const fsst_table *t, const unsigned char *s, size_t len, lng *count1, lng *count2)
+{
+	int prev = -1;
+
+	for (size_t i = 0; i < len; ) {
+		int id;
+		if (s[i] & 0x80) {
+			prev = -1;
+			i++;
+			continue;
+		}
+		if ((id = fsst_match(t, s + i, len - i)) >= 0) {
+			i += t->len[id];
+		} else {
+			id = 128 + s[i];
+			i++;
+		}
+		count1[id]++;
+		if (prev >= 0)
+			count2[prev * 256 + id]++;
+		prev = id;
+	}
+}
+
+static gdk_return
+fsst_build(fsst_table *t, BATiter *bi)
+{
+	BUN step = bi->count / FSST_SAMPLEROWS + 1;
+	lng *count1 = GDKmalloc(256 * sizeof(lng));
+	lng *count2 = GDKmalloc(256 * 256 * sizeof(lng));
+	fsst_cand *cand = GDKmalloc((256 + 256 * 256) * sizeof(fsst_cand));
+
+	if (count1 == NULL || count2 == NULL || cand == NULL) {
+		GDKfree(count1);
+		GDKfree(count2);
+		GDKfree(cand);
+		return GDK_FAIL;
+	}
+	t->nsymbols = 0;
+	fsst_table_finish(t);
+	for (int round = 0; round < FSST_ROUNDS; round++) {
+		size_t sampled = 0;
+		int ncand = 0;
+
+		memset(count1, 0, 256 * sizeof(lng));
+		memset(count2, 0, 256 * 256 * sizeof(lng));
+		for (BUN p = 0; p < bi->count && sampled < FSST_SAMPLESIZE; p += step) {
+			const char *s = BUNtvar(bi, p);
+			if (strNil(s))
+				continue;
+			size_t len = strlen(s);
+			fsst_count(t, (const unsigned char *) s, len, count1, count2);
+			sampled += len;
+		}
+		for (int a = 0; a < 256; a++) {
+			uint64_t sa, sb;
+			uint8_t la, lb;
+
+			if (count1[a] == 0)
+				continue;
+			la = fsst_id2symbol(t, a, &sa);
+			cand[ncand++] = (fsst_cand) {
+				.symbol = sa,
+				.len = la,
+				.gain = count1[a] * la,
+			};
+			for (int b = 0; b < 256; b++) {
+				if (count2[a * 256 + b] == 0)
+					continue;
+				lb = fsst_id2symbol(t, b, &sb);
+				if (la + lb > FSST_SYMLEN)
+					continue;
+				cand[ncand] = (fsst_cand) {
+					.symbol = sa,
+					.len = la + lb,
+					.gain = count2[a * 256 + b] * (la + lb),
+				};
+				memcpy((unsigned char *) &cand[ncand].symbol + la, &sb, lb);
+				ncand++;
+			}
+		}
+		/* merge duplicate candidates */
+		qsort(cand, ncand, sizeof(fsst_cand), fsst_cand_symcmp);
+		int n = 0;
+		for (int i = 0; i < ncand; i++) {
+			if (n > 0 && fsst_cand_symcmp(&cand[n - 1], &cand[i]) == 0)
+				cand[n - 1].gain += cand[i].gain;
+			else
+				cand[n++] = cand[i];
+		}
+		qsort(cand, n, sizeof(fsst_cand), fsst_cand_gaincmp);
+		t->nsymbols = n < FSST_MAXSYMBOLS ? n : FSST_MAXSYMBOLS;
+		for (int i = 0; i < t->nsymbols; i++) {
+			t->symbol[i] = cand[i].symbol;
+			t->len[i] = cand[i].len;
+		}
+		fsst_table_finish(t);
+	}
+	GDKfree(count1);
+	GDKfree(count2);
+	GDKfree(cand);
+	return GDK_SUCCEED;
+}
+
+static BAT *
+fsst_table_bat(const fsst_table *t, role_t role)
+{
+	BAT *u = COLnew(0, TYPE_str, t->nsymbols, role);
+
+	if (u == NULL)
+		return NULL;
+	for (int i = 0; i < t->nsymbols; i++) {
+		char buf[FSST_SYMLEN + 1] = {0};
+
+		memcpy(buf, &t->symbol[i], t->len[i]);
+		if (BUNappend(u, buf, false) != GDK_SUCCEED) {
+			bat_destroy(u);
+			return NULL;
+		}
+	}
+	return u;
+}
+
+static BAT *
+FSSTcompress_(BAT *b, const fsst_table *t, role_t role)
+{
+	BAT *o = COLnew(b->hseqbase, TYPE_str, BATcount(b), role);
+	size_t buflen = 0;
+	unsigned char *buf = NULL;
+	bool nils = false;
+
+	if (o == NULL)
+		return NULL;
+	BATiter bi = bat_iterator(b);
+	for (BUN p = 0; p < bi.count; p++) {
+		const char *v = BUNtvar(&bi, p);
+
+		if (strNil(v)) {
+			nils = true;
+		} else {
+			size_t len = strlen(v);
+			if (2 * len + 1 > buflen) {
+				unsigned char *nbuf;
+				buflen = 2 * len + 1024;
+				if ((nbuf = GDKrealloc(buf, buflen)) == NULL)
+					goto bailout;
+				buf = nbuf;
+			}
+			fsst_encode(t, (const unsigned char *) v, len, buf);
+			v = (const char *) buf;
+		}
+		if (tfastins_nocheckVAR(o, p, v) != GDK_SUCCEED)
+			goto bailout;
+	}
+	BATsetcount(o, bi.count);
+	BATnegateprops(o);
+	o->tnil = nils;
+	o->tnonil = !nils;
+	o->tkey = bi.key;
+	bat_iterator_end(&bi);
+	GDKfree(buf);
+	return o;
+
+  bailout:
+	bat_iterator_end(&bi);
+	GDKfree(buf);
+	bat_destroy(o);
+	return NULL;
+}
+
+static BAT *
+FSSTdecompress_(BAT *o, BAT *u, role_t role)
+{
+	fsst_table t;
+	size_t buflen = 0;
+	unsigned char *buf = NULL;
+	bool nils = false;
+	BAT *b;
+
+	if (fsst_table_load(&t, u) != GDK_SUCCEED ||
+		(b = COLnew(o->hseqbase, TYPE_str, BATcount(o), role)) == NULL)
+		return NULL;
+	BATiter oi = bat_iterator(o);
+	for (BUN p = 0; p < oi.count; p++) {
+		const char *v = BUNtvar(&oi, p);
+
+		if (strNil(v)) {
+			nils = true;
+		} else {
+			size_t len = strlen(v);
+			if (FSST_SYMLEN * (len + 1) > buflen) {
+				unsigned char *nbuf;
+				buflen = FSST_SYMLEN * (len + 1) + 1024;
+				if ((nbuf = GDKrealloc(buf, buflen)) == NULL)
+					goto bailout;
+				buf = nbuf;
+			}
+			fsst_decode(&t, (const unsigned char *) v, buf);
+			v = (const char *) buf;
+		}
+		if (tfastins_nocheckVAR(b, p, v) != GDK_SUCCEED)
+			goto bailout;
+	}
+	BATsetcount(b, oi.count);
+	BATnegateprops(b);
+	b->tnil = nils;
+	b->tnonil = !nils;
+	b->tkey = oi.key;
+	bat_iterator_end(&oi);
+	GDKfree(buf);
+	return b;
+
+  bailout:
+	bat_iterator_end(&oi);
+	GDKfree(buf);
+	bat_destroy(b);
+	return NULL;
+}
+
+str
+FSSTcompress_col(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	(void)mb;
+	str msg = MAL_SUCCEED;
+	const char *sname = *getArgReference_str(stk, pci, 1);
+	const char *tname = *getArgReference_str(stk, pci, 2);
+	const char *cname = *getArgReference_str(stk, pci, 3);
+	backend *be = NULL;
+	sql_trans *tr = NULL;
+
+	if (!sname || !tname || !cname)
+		throw(SQL, "fsst.compress", SQLSTATE(3F000) "fsst compress: invalid column name");
+	if (strNil(sname))
+		throw(SQL, "fsst.compress", SQLSTATE(42000) "Schema name cannot be NULL");
+	if (strNil(tname))
+		throw(SQL, "fsst.compress", SQLSTATE(42000) "Table name cannot be NULL");
+	if (strNil(cname))
+		throw(SQL, "fsst.compress", SQLSTATE(42000) "Column name cannot be NULL");
+	if ((msg = getBackendContext(cntxt, &be)) != MAL_SUCCEED)
+		return msg;
+	tr = be->mvc->session->tr;
+
+	sql_schema *s = find_sql_schema(tr, sname);
+	if (!s)
+		throw(SQL, "fsst.compress", SQLSTATE(3F000) "schema '%s' unknown", sname);
+	sql_table *t = find_sql_table(tr, s, tname);
+	if (!t)
+		throw(SQL, "fsst.compress", SQLSTATE(3F000) "table '%s.%s' unknown", sname, tname);
+	if (!isTable(t))
+		throw(SQL, "fsst.compress", SQLSTATE(42000) "%s '%s' is not persistent",
+			  TABLE_TYPE_DESCRIPTION(t->type, t->properties), t->base.name);
+	if (isTempTable(t))
+		throw(SQL, "fsst.compress", SQLSTATE(42000) "columns from temporary tables cannot be compressed");
+	if (t->system)
+		throw(SQL, "fsst.compress", SQLSTATE(42000) "columns from system tables cannot be compressed");
+	sql_column *c = find_sql_column(t, cname);
+	if (!c)
+		throw(SQL, "fsst.compress", SQLSTATE(3F000) "column '%s.%s.%s' unknown", sname, tname, cname);
+	if (c->type.type->localtype != TYPE_str)
+		throw(SQL, "fsst.compress", SQLSTATE(3F000) "fsst compress: only string columns can be compressed");
+	if (c->storage_type)
+		throw(SQL, "fsst.compress", SQLSTATE(3F000) "column '%s.%s.%s' already compressed", sname, tname, cname);
+
+	sqlstore *store = tr->store;
+	BAT *b = store->storage_api.bind_col(tr, c, RDONLY), *o = NULL, *u = NULL;
+	if (b == NULL)
+		throw(SQL, "fsst.compress", SQLSTATE(HY005) "Cannot access column descriptor");
+	if (BATcount(b) == 0) {
+		bat_destroy(b);
+		throw(SQL, "fsst.compress", SQLSTATE(42000) "fsst compress: cannot build a symbol table for an empty column");
+	}
+
+	fsst_table ft;
+	BATiter bi = bat_iterator(b);
+	gdk_return rc = fsst_build(&ft, &bi);
+	bat_iterator_end(&bi);
+	if (rc != GDK_SUCCEED ||
+		(o = FSSTcompress_(b, &ft, PERSISTENT)) == NULL ||
+		(u = fsst_table_bat(&ft, PERSISTENT)) == NULL) {
+		bat_destroy(b);
+		bat_destroy(o);
+		throw(SQL, "fsst.compress", GDK_EXCEPTION);
+	}
+	bat_destroy(b);
+
+	switch (sql_trans_alter_storage(tr, c, "FSST")) {
+		case -1:
+			msg = createException(SQL, "fsst.compress", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+			break;
+		case -2:
+		case -3:
+			msg = createException(SQL, "fsst.compress", SQLSTATE(42000) "transaction conflict detected");
+			break;
+		default:
+			break;
+	}
+	if (msg == MAL_SUCCEED && !(c = get_newcolumn(tr, c)))
+		msg = createException(SQL, "fsst.compress", SQLSTATE(HY013) "alter_storage failed");
+	if (msg == MAL_SUCCEED) {
+		switch (store->storage_api.col_compress(tr, c, ST_FSST, o, u)) {
+			case -1:
+				msg = createException(SQL, "fsst.compress", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+				break;
+			case -2:
+			case -3:
+				msg = createException(SQL, "fsst.compress", SQLSTATE(42000) "transaction conflict detected");
+				break;
+			default:
+				break;
+		}
+	}
+	bat_destroy(u);
+	bat_destroy(o);
+	return msg;
+}
+
+str
+FSSTdecompress(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	(void)cntxt;
+	(void)mb;
+	bat *r = getArgReference_bat(stk, pci, 0);
+	bat O = *getArgReference_bat(stk, pci, 1);
+	bat U = *getArgReference_bat(stk, pci, 2);
+
+	BAT *o = BATdescriptor(O);
+	BAT *u = BATdescriptor(U);
+	if (!o || !u) {
+		bat_destroy(o);
+		bat_destroy(u);
+		throw(SQL, "fsst.decompress", SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+	}
+	BAT *b = FSSTdecompress_(o, u, TRANSIENT);
+	bat_destroy(o);
+	bat_destroy(u);
+	if (!b)
+		throw(SQL, "fsst.decompress", GDK_EXCEPTION);
+	*r = b->batCacheid;
+	BBPkeepref(b);
+	return MAL_SUCCEED;
+}
+
+/* equality is evaluated on the encoded values, anything else on the
+ * decompressed ones */
+str
+FSSTthetaselect(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	(void)cntxt;
+	(void)mb;
+	bat *R0 = getArgReference_bat(stk, pci, 0);
+	bat O = *getArgReference_bat(stk, pci, 1);
+	bat S = *getArgReference_bat(stk, pci, 2);
+	bat U = *getArgReference_bat(stk, pci, 3);
+	const char *v = *getArgReference_str(stk, pci, 4);
+	const char *op = *getArgReference_str(stk, pci, 5);
+	BAT *o, *s = NULL, *u, *bn = NULL;
+
+	o = BATdescriptor(O);
+	u = BATdescriptor(U);
+	if (!is_bat_nil(S))
+		s = BATdescriptor(S);
+	if (!o || !u || (!is_bat_nil(S) && !s)) {
+		bat_destroy(o);
+		bat_destroy(u);
+		bat_destroy(s);
+		throw(SQL, "fsst.thetaselect", SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+	}
+	if (strNil(v)) {
+		bn = BATthetaselect(o, s, v, op);
+	} else if (op[0] == '=' || op[0] == '!' || (op[0] == '<' && op[1] == '>')) {
+		fsst_table t;
+		size_t len = strlen(v);
+		unsigned char *e = GDKmalloc(2 * len + 1);
+
+		if (e != NULL && fsst_table_load(&t, u) == GDK_SUCCEED) {
+			fsst_encode(&t, (const unsigned char *) v, len, e);
+			bn = BATthetaselect(o, s, e, op);
+		}
+		GDKfree(e);
+	} else {
+		BAT *b = FSSTdecompress_(o, u, TRANSIENT);
+
+		if (b) {
+			bn = BATthetaselect(b, s, v, op);
+			bat_destroy(b);
+		}
+	}
+	bat_destroy(o);
+	bat_destroy(u);
+	bat_destroy(s);
+	if (bn == NULL)
+		throw(SQL, "fsst.thetaselect", GDK_EXCEPTION);
+	*R0 = bn->batCacheid;
+	BBPkeepref(bn);
+	return MAL_SUCCEED;
+}
+
+/* select the values which start with prefix (LIKE 'prefix%') */
+str
+FSSTprefixselect(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	(void)cntxt;
+	(void)mb;
+	bat *R0 = getArgReference_bat(stk, pci, 0);
+	bat O = *getArgReference_bat(stk, pci, 1);
+	bat S = *getArgReference_bat(stk, pci, 2);
+	bat U = *getArgReference_bat(stk, pci, 3);
+	const char *prefix = *getArgReference_str(stk, pci, 4);
+	bit anti = *getArgReference_bit(stk, pci, 5);
+	BAT *o, *s = NULL, *u, *bn;
+	fsst_table t;
+	struct canditer ci;
+
+	if (strNil(prefix)) {
+		if ((bn = BATdense(0, 0, 0)) == NULL)
+			throw(SQL, "fsst.prefixselect", GDK_EXCEPTION);
+		*R0 = bn->batCacheid;
+		BBPkeepref(bn);
+		return MAL_SUCCEED;
+	}
+	o = BATdescriptor(O);
+	u = BATdescriptor(U);
+	if (!is_bat_nil(S))
+		s = BATdescriptor(S);
+	if (!o || !u || (!is_bat_nil(S) && !s)) {
+		bat_destroy(o);
+		bat_destroy(u);
+		bat_destroy(s);
+		throw(SQL, "fsst.prefixselect", SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+	}
+	if (fsst_table_load(&t, u) != GDK_SUCCEED) {
+		bat_destroy(o);
+		bat_destroy(u);
+		bat_destroy(s);
+		throw(SQL, "fsst.prefixselect", GDK_EXCEPTION);
+	}
+	bat_destroy(u);
+
+	canditer_init(&ci, o, s);
+	BUN cnt = ci.ncand, r = 0;
+	if ((bn = COLnew(0, TYPE_oid, cnt, TRANSIENT)) == NULL) {
+		bat_destroy(o);
+		bat_destroy(s);
+		throw(SQL, "fsst.prefixselect", GDK_EXCEPTION);
+	}
+	oid *restrict rp = Tloc(bn, 0);
+	size_t plen = strlen(prefix);
+	BATiter oi = bat_iterator(o);
+	for (BUN i = 0; i < cnt; i++) {
+		oid x = canditer_next(&ci);
+		const char *v = BUNtvar(&oi, x - oi.b->hseqbase);
+
+		if (!strNil(v) &&
+			fsst_hasprefix(&t, (const unsigned char *) v, (const unsigned char *) prefix, plen) != anti)
+			rp[r++] = x;
+	}
+	bat_iterator_end(&oi);
+	bat_destroy(o);
+	bat_destroy(s);
+	BATsetcount(bn, r);
+	bn->tsorted = true;
+	bn->trevsorted = r <= 1;
+	bn->tkey = true;
+	bn->tnil = false;
+	bn->tnonil = true;
+	bn->tseqbase = r == 0 ? 0 : r == 1 ? rp[0] : oid_nil;
+	*R0 = bn->batCacheid;
+	BBPkeepref(bn);
+	return MAL_SUCCEED;
+}
+
+int
+FSSTprepare4append(BAT **noffsets, BAT *vals, BAT *symbols)
+{
+	fsst_table t;
+
+	*noffsets = NULL;
+	if (fsst_table_load(&t, symbols) != GDK_SUCCEED ||
+		(*noffsets = FSSTcompress_(vals, &t, TRANSIENT)) == NULL)
+		return -1;
+	return 0;
+}
+
+/* encode an array of cnt string pointers; the result is a single
+ * allocation holding the new pointers followed by the encoded values */
+int
+FSSTprepare4append_vals(void **noffsets, void *vals, BUN cnt, BAT *symbols)
+{
+	fsst_table t;
+	const char **v = vals;
+	size_t sz = cnt * sizeof(char *);
+
+	*noffsets = NULL;
+	if (fsst_table_load(&t, symbols) != GDK_SUCCEED)
+		return -1;
+	for (BUN i = 0; i < cnt; i++)
+		if (!strNil(v[i]))
+			sz += 2 * strlen(v[i]) + 1;
+	const char **n = GDKmalloc(sz);
+	if (n == NULL)
+		return -1;
+	unsigned char *e = (unsigned char *) (n + cnt);
+	for (BUN i = 0; i < cnt; i++) {
+		if (strNil(v[i])) {
+			n[i] = str_nil;
+		} else {
+			n[i] = (const char *) e;
+			e += fsst_encode(&t, (const unsigned char *) v[i], strlen(v[i]), e) + 1;
+		}
+	}
+	*noffsets = n;
+	return 0;
+}
+
+char *
+FSSTencode_val(const char *val, BAT *symbols)
+{
+	fsst_table t;
+	char *e;
+
+	if (strNil(val))
+		return GDKstrdup(str_nil);
+	size_t len = strlen(val);
+	if (fsst_table_load(&t, symbols) != GDK_SUCCEED ||
+		(e = GDKmalloc(2 * len + 1)) == NULL)
+		return NULL;
+	fsst_encode(&t, (const unsigned char *) val, len, (unsigned char *) e);
+	return e;
+}
@@ -0,0 +1,21 @@
+/*
+ * SPDX-License-Identifier: MPL-2.0
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0.  If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/.
+ *
+ * For copyright information, see the file debian/copyright.
+ */
+
+#ifndef _FSST_H
+#define _FSST_H
+
+#include "sql_monet_backend.h"
+
+extern str FSSTcompress_col(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci);
+extern str FSSTdecompress(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci);
+extern str FSSTthetaselect(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci);
+extern str FSSTprefixselect(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci);
+
+#endif /* _FSST_H */
@@ -53,9 +53,12 @@ typedef struct backend {
 	lng 	reloptimizer;	/* timer for optimizer phase */
 
 	bool sizeheader:1,	/* print size header in result set */
+		 streaming:1,	/* send pipelined result rows while they are produced */
 		 no_mitosis:1,	/* run query without mitosis */
 		 need_pipeline:1,	/* flag to indicate we need to start a pipeline */
 		 console:1,
+		 bulk_params:1,	/* the parameters of the plan being generated are columns */
+		 batch:1,	/* the calls of a batched EXEC report the affected rows once, in batchrows */
 		 silent:1; /* on some occasions we don't want to output the result set or the number of affected rows */
 	cq 	*q;		/* pointer to the cached query */
 
@@ -73,9 +76,12 @@ typedef struct backend {
 
 	int result_id;
 	res_table *results;
+	struct res_stream *rstream;	/* result set being streamed */
 	lng last_id;
 	lng rowcnt;
+	lng batchrows;	/* total of the affected rows of a batched EXEC, -1 if none */
 	subbackend *subbackend;
+	char challenge[13];	/* for a new login over this connection, see Xchallenge */
 	str fimp; /* for recursive functions keep the to be generated MAL function name here */
 } backend;
 
@@ -1726,6 +1726,10 @@ exp_bin(backend *be, sql_exp *e, stmt *left, stmt *right, stmt *grp, stmt *ext,
 				t = a->type.type?&a->type:NULL;
 			}
 			s = stmt_varnr(be, e->flag, t);
+			if (s && be->bulk_params) {	/* a batch of parameter tuples */
+				s->nrcols = 1;
+				s->key = 0;
+			}
 		}
 	}	break;
 	case e_convert: {
@@ -2226,6 +2230,9 @@ stmt_col(backend *be, sql_column *c, stmt *del, int part)
 		if (c->storage_type && c->storage_type[0] == 'D') {
 			stmt *v = stmt_bat(be, c, RD_EXT, part);
 			sc = stmt_dict(be, sc, v);
+		} else if (c->storage_type && strcmp(c->storage_type, "FSST") == 0) {
+			stmt *v = stmt_bat(be, c, RD_EXT, part);
+			sc = stmt_fsst(be, sc, v);
 		} else if (c->storage_type && c->storage_type[0] == 'F') {
 			sc = stmt_for(be, sc, stmt_atom(be, atom_general(be->mvc->sa, &c->type, c->storage_type+4/*skip FOR-*/, be->mvc->timezone)));
 		}
@@ -8125,6 +8132,27 @@ rel2bin_materialize(backend *be, sql_rel *rel, list *refs, bool top)
 		/* append results (later first claim position, then append)*/
 		list *res = sa_list(be->mvc->sa), *sub = s->op4.lval;
 
+		if (top && !be->silent && be->mvc->type == Q_TABLE) {
+			/* the client may want the rows while they are produced,
+			 * then the header goes out before the pipeline starts */
+			list *hdr = sa_list(be->mvc->sa);
+			for(node *n = shared->h, *o = sharedproject->exps->h; n && o; n = n->next, o = o->next) {
+				stmt *r = n->data;
+				sql_exp *e = o->data;
+
+				stmt *s = stmt_none(be);
+				s->op4.typeval = *exp_subtype(e);
+				s->nr = r->nr;
+				s = stmt_alias(be, s, e->alias.label, exp_find_rel_name(e), exp_name(e));
+				append(hdr, s);
+			}
+			int pc = be->mb->stop;
+			if ((prs = stmt_output_stream(be, prs, stmt_list(be, hdr))) < 0)
+				return NULL;
+			for (; pc < be->mb->stop; pc++)
+				moveInstruction(be->mb, pc, be->pp_pc++);
+		}
+
 		sql_subfunc *cnt = sql_bind_func(be->mvc, "sys", "count", sql_fetch_localtype(TYPE_void), NULL, F_AGGR, true, true);
 		stmt *i = sub->h->data;
 		/* count of bat */
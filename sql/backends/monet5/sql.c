@@ -168,6 +168,9 @@ int
 sqlcleanup(backend *be, int err)
 {
 	sql_destroy_params(be->mvc);
+	/* a failed query may leave its streamed result set behind */
+	if (be->rstream)
+		(void) mvc_export_stream_end(be);
 
 	/* some statements dynamically disable caching */
 	be->mvc->sym = NULL;
@@ -2464,37 +2467,32 @@ SQLtid(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 	return msg;
 }
 
-/* unsafe pattern resultSet(tbl:bat[:str], attr:bat[:str], tpe:bat[:str], len:bat[:int],scale:bat[:int], cols:bat[:any]...) :int */
-/* New result set rendering infrastructure */
-
+/* build the result table from the meta data bats at argument 'first'
+ * onwards, followed by the columns */
 static str
-mvc_result_set_wrap( Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+result_set_create(backend *be, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci, int first, int *res_id)
 {
-	int *res_id =getArgReference_int(stk,pci,0);
-	bat tblId= *getArgReference_bat(stk, pci,1);
-	bat atrId= *getArgReference_bat(stk, pci,2);
-	bat tpeId= *getArgReference_bat(stk, pci,3);
-	bat lenId= *getArgReference_bat(stk, pci,4);
-	bat scaleId= *getArgReference_bat(stk, pci,5);
+	bat tblId= *getArgReference_bat(stk, pci,first);
+	bat atrId= *getArgReference_bat(stk, pci,first + 1);
+	bat tpeId= *getArgReference_bat(stk, pci,first + 2);
+	bat lenId= *getArgReference_bat(stk, pci,first + 3);
+	bat scaleId= *getArgReference_bat(stk, pci,first + 4);
 	bat bid;
-	int i, res, ok;
+	int i, res;
 	const char *tblname, *colname, *tpename;
 	str msg= MAL_SUCCEED;
 	int *digits, *scaledigits;
 	oid o = 0;
 	BATiter itertbl,iteratr,itertpe,iterdig,iterscl;
-	backend *be = NULL;
 	BAT *b = NULL, *tbl = NULL, *atr = NULL, *tpe = NULL,*len = NULL,*scale = NULL;
 
-	if ((msg = getBackendContext(cntxt, &be)) != NULL)
-		return msg;
-	bid = *getArgReference_bat(stk,pci,6);
+	bid = *getArgReference_bat(stk,pci,first + 5);
 	b = BATdescriptor(bid);
 	if ( b == NULL) {
 		msg = createException(SQL, "sql.resultSet", SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
 		goto wrapup_result_set;
 	}
-	res = *res_id = mvc_result_table(be, mb->tag, pci->argc - (pci->retc + 5), Q_TABLE);
+	res = *res_id = mvc_result_table(be, mb->tag, pci->argc - (first + 5), Q_TABLE);
 	BBPunfix(b->batCacheid);
 	if (res < 0) {
 		msg = createException(SQL, "sql.resultSet", SQLSTATE(HY013) MAL_MALLOC_FAIL);
@@ -2517,7 +2515,7 @@ mvc_result_set_wrap( Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 	digits = (int*) iterdig.base;
 	scaledigits = (int*) iterscl.base;
 
-	for( i = 6; msg == MAL_SUCCEED && i< pci->argc; i++, o++){
+	for( i = first + 5; msg == MAL_SUCCEED && i< pci->argc; i++, o++){
 		bid = *getArgReference_bat(stk,pci,i);
 		tblname = BUNtvar(&itertbl,o);
 		colname = BUNtvar(&iteratr,o);
@@ -2535,15 +2533,7 @@ mvc_result_set_wrap( Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 	bat_iterator_end(&itertpe);
 	bat_iterator_end(&iterdig);
 	bat_iterator_end(&iterscl);
-	/* now send it to the channel cntxt->fdout */
-	if (bstream_getoob(cntxt->fdin))
-		msg = createException(SQL, "sql.resultSet", SQLSTATE(HY000) "Query aboted");
-	else if (!msg && (ok = mvc_export_result(be, cntxt->fdout, res, true, cntxt->qryctx.starttime, mb->optimize)) < 0)
-		msg = createException(SQL, "sql.resultSet", SQLSTATE(45000) "Result set construction failed: %s", mvc_export_error(be, cntxt->fdout, ok));
   wrapup_result_set:
-	cntxt->qryctx.starttime = 0;
-	cntxt->qryctx.endtime = 0;
-	mb->optimize = 0;
 	if( tbl) BBPunfix(tblId);
 	if( atr) BBPunfix(atrId);
 	if( tpe) BBPunfix(tpeId);
@@ -2552,6 +2542,71 @@ mvc_result_set_wrap( Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 	return msg;
 }
 
+/* unsafe pattern resultSet(tbl:bat[:str], attr:bat[:str], tpe:bat[:str], len:bat[:int],scale:bat[:int], cols:bat[:any]...) :int */
+/* New result set rendering infrastructure */
+
+static str
+mvc_result_set_wrap( Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	int *res_id =getArgReference_int(stk,pci,0);
+	int ok;
+	str msg= MAL_SUCCEED;
+	backend *be = NULL;
+
+	if ((msg = getBackendContext(cntxt, &be)) != NULL)
+		return msg;
+	if (be->rstream) {
+		/* the rows were sent while the pipeline produced them */
+		*res_id = 0;
+		if ((ok = mvc_export_stream_end(be)) < 0)
+			msg = createException(SQL, "sql.resultSet", SQLSTATE(45000) "Result set construction failed: %s", mvc_export_error(be, cntxt->fdout, ok));
+	} else if ((msg = result_set_create(be, mb, stk, pci, 1, res_id)) == MAL_SUCCEED) {
+		/* now send it to the channel cntxt->fdout */
+		if (bstream_getoob(cntxt->fdin))
+			msg = createException(SQL, "sql.resultSet", SQLSTATE(HY000) "Query aboted");
+		else if ((ok = mvc_export_result(be, cntxt->fdout, *res_id, true, cntxt->qryctx.starttime, mb->optimize)) < 0)
+			msg = createException(SQL, "sql.resultSet", SQLSTATE(45000) "Result set construction failed: %s", mvc_export_error(be, cntxt->fdout, ok));
+	}
+	cntxt->qryctx.starttime = 0;
+	cntxt->qryctx.endtime = 0;
+	mb->optimize = 0;
+	return msg;
+}
+
+/* unsafe pattern resultStream(sink:bat[:bte], tbl:bat[:str], ..., cols:bat[:any]...) :bat[:bte]
+ * On request of the client, sends the header of the result set of a
+ * pipelined query up front and lets the pipeline send the rows of
+ * each morsel as soon as it has them; the result columns stay empty. */
+static str
+mvc_result_stream_wrap(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	bat *res = getArgReference_bat(stk, pci, 0);
+	bat sink = *getArgReference_bat(stk, pci, 1);
+	int res_id, ok;
+	str msg = MAL_SUCCEED;
+	backend *be = NULL;
+	BAT *b;
+
+	if ((msg = getBackendContext(cntxt, &be)) != NULL)
+		return msg;
+	if ((b = BATdescriptor(sink)) == NULL)
+		throw(SQL, "sql.resultStream", SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+	if (be->streaming && be->rstream == NULL &&
+		be->output_format == OFMT_CSV && cntxt->protocol != PROTOCOL_COLUMNAR) {
+		if ((msg = result_set_create(be, mb, stk, pci, 2, &res_id)) == MAL_SUCCEED &&
+			(ok = mvc_export_stream_begin(be, cntxt->fdout, res_id, cntxt->qryctx.starttime, mb->optimize)) < 0)
+			msg = createException(SQL, "sql.resultStream", SQLSTATE(45000) "Result set construction failed: %s", mvc_export_error(be, cntxt->fdout, ok));
+		if (msg == MAL_SUCCEED && be->rstream) {
+			struct pipeline_resultset *prs = (struct pipeline_resultset *) b->pl_io;
+			prs->flush_data = be->rstream;
+			prs->flush = &mvc_export_stream_put;
+		}
+	}
+	if (msg == MAL_SUCCEED)
+		BBPretain(*res = sink);
+	BBPunfix(sink);
+	return msg;
+}
 
 str
 wrap_onclient_compression(stream **inner, str context, int nr, bool binary)
@@ -3021,6 +3076,11 @@ mvc_affected_rows_wrap(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 	assert(mtype == TYPE_lng);
 	nr = *getArgReference_lng(stk, pci, 2);
 	b = cntxt->sqlcontext;
+	if (b->batch) {
+		/* sent once the whole batch ran */
+		b->batchrows = b->batchrows < 0 ? nr : b->batchrows + nr;
+		return MAL_SUCCEED;
+	}
 	ok = mvc_export_affrows(b, b->out, nr, "", mb->tag, cntxt->qryctx.starttime, mb->optimize);
 	cntxt->qryctx.starttime = 0;
 	cntxt->qryctx.endtime = 0;
@@ -4307,6 +4367,7 @@ sql_storage_appendrow(BAT *bs, const char *sname, const char *tname, const char
 	if (BUNappend(key, &bitval, false) != GDK_SUCCEED)
 		goto bailout1;
 
+	OIDXwait(bs);
 	MT_lock_set(&bs->batIdxLock);
 	sz = bs->torderidx && bs->torderidx != (Heap *) 1 ? bs->torderidx->free : 0;
 	MT_lock_unset(&bs->batIdxLock);
@@ -5531,6 +5592,7 @@ SQLstr_stop_vacuum(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 #include "sql_transaction.h"
 #include "for.h"
 #include "dict.h"
+#include "fsst.h"
 #include "mel.h"
 
 
@@ -5826,6 +5888,7 @@ static mel_func sql_init_funcs[] = {
  pattern("sql", "resultSet", mvc_scalar_value_wrap, true, "Prepare a table result set for the client front-end.", args(1,8, arg("",int),arg("tbl",str),arg("attr",str),arg("tpe",str),arg("len",int),arg("scale",int),arg("eclass",int),argany("val",0))),
  pattern("sql", "resultSet", mvc_row_result_wrap, true, "Prepare a table result set for the client front-end", args(1,7, arg("",int),batarg("tbl",str),batarg("attr",str),batarg("tpe",str),batarg("len",int),batarg("scale",int),varargany("cols",0))),
  pattern("sql", "resultSet", mvc_table_result_wrap, true, "Prepare a table result set for the client in default CSV format", args(1,7, arg("",int),batarg("tbl",str),batarg("attr",str),batarg("tpe",str),batarg("len",int),batarg("scale",int),batvarargany("cols",0))),
+ pattern("sql", "resultStream", mvc_result_stream_wrap, true, "Send the header of a pipelined result set and let the pipeline send the rows, when the client asked for streaming", args(1,8, batarg("",bte),batarg("sink",bte),batarg("tbl",str),batarg("attr",str),batarg("tpe",str),batarg("len",int),batarg("scale",int),batvarargany("cols",0))),
  pattern("sql", "export_table", mvc_export_row_wrap, true, "Prepare a table result set for the COPY INTO stream", args(1,14, arg("",int),arg("fname",str),arg("fmt",str),arg("colsep",str),arg("recsep",str),arg("qout",str),arg("nullrep",str),arg("onclient",int),batarg("tbl",str),batarg("attr",str),batarg("tpe",str),batarg("len",int),batarg("scale",int),varargany("cols",0))),
  pattern("sql", "export_table", mvc_export_table_wrap, true, "Prepare a table result set for the COPY INTO stream", args(1,14, arg("",int),arg("fname",str),arg("fmt",str),arg("colsep",str),arg("recsep",str),arg("qout",str),arg("nullrep",str),arg("onclient",int),batarg("tbl",str),batarg("attr",str),batarg("tpe",str),batarg("len",int),batarg("scale",int),batvarargany("cols",0))),
  pattern("sql", "exportHead", mvc_export_head_wrap, true, "Export a result (in order) to stream s", args(1,3, arg("",void),arg("s",streams),arg("res_id",int))),
@@ -5860,6 +5923,7 @@ static mel_func sql_init_funcs[] = {
  pattern("sql", "analyze", sql_analyze, true, "Update statistics for schema", args(1,2, arg("",void),arg("sch",str))),
  pattern("sql", "analyze", sql_analyze, true, "Update statistics for table", args(1,3, arg("",void),arg("sch",str),arg("tbl",str))),
  pattern("sql", "analyze", sql_analyze, true, "Update statistics for column", args(1,4, arg("",void),arg("sch",str),arg("tbl",str),arg("col",str))),
+ pattern("sql", "analyze_group", sql_analyze_group, true, "Update the distinct counts of a group of columns", args(1,4, arg("",void),arg("sch",str),arg("tbl",str),vararg("col",str))),
  pattern("sql", "set_count_distinct", sql_set_count_distinct, true, "Set count distinct for column", args(1,5, arg("",void),arg("sch",str),arg("tbl",str),arg("col",str),arg("val",lng))),
  pattern("sql", "set_min", sql_set_min, true, "Set min for column", args(1,5, arg("",void),arg("sch",str),arg("tbl",str),arg("col",str),argany("val",1))),
  pattern("sql", "set_max", sql_set_max, true, "Set max for column", args(1,5, arg("",void),arg("sch",str),arg("tbl",str),arg("col",str),argany("val",1))),
@@ -5873,6 +5937,10 @@ static mel_func sql_init_funcs[] = {
  pattern("sql", "storage", sql_storage, false, "return a table with storage information for a particular column", args(17,20, batarg("schema",str),batarg("table",str),batarg("column",str),batarg("type",str),batarg("mode",str),batarg("location",str),batarg("count",lng),batarg("atomwidth",int),batarg("columnsize",lng),batarg("heap",lng),batarg("hashes",lng),batarg("phash",bit),batarg("imprints",lng),batarg("sorted",bit),batarg("revsorted",bit),batarg("key",bit),batarg("orderidx",lng),arg("sname",str),arg("tname",str),arg("cname",str))),
  pattern("sql", "createorderindex", sql_createorderindex, true, "Instantiate the order index on a column", args(0,3, arg("sch",str),arg("tbl",str),arg("col",str))),
  pattern("sql", "droporderindex", sql_droporderindex, true, "Drop the order index on a column", args(0,3, arg("sch",str),arg("tbl",str),arg("col",str))),
+ pattern("sql", "createtrigramindex", sql_createtrigramindex, true, "Instantiate the trigram index on a string column", args(0,3, arg("sch",str),arg("tbl",str),arg("col",str))),
+ pattern("sql", "droptrigramindex", sql_droptrigramindex, true, "Drop the trigram index on a string column", args(0,3, arg("sch",str),arg("tbl",str),arg("col",str))),
+ pattern("sql", "createfulltextindex", sql_createfulltextindex, true, "Instantiate the full-text index on a string column", args(0,3, arg("sch",str),arg("tbl",str),arg("col",str))),
+ pattern("sql", "dropfulltextindex", sql_dropfulltextindex, true, "Drop the full-text index on a string column", args(0,3, arg("sch",str),arg("tbl",str),arg("col",str))),
  command("calc", "identity", SQLidentity, false, "Returns a unique row identitfier.", args(1,2, arg("",oid),argany("",0))),
  command("batcalc", "identity", BATSQLidentity, false, "Returns the unique row identitfiers.", args(1,2, batarg("",oid),batargany("b",0))),
  pattern("batcalc", "identity", PBATSQLidentity, false, "Returns the unique row identitfiers.", args(2,4, batarg("resb",oid),arg("ns",oid),batargany("b",0),arg("s",oid))),
@@ -5898,6 +5966,10 @@ static mel_func sql_init_funcs[] = {
  pattern("dict", "thetaselect", DICTthetaselect, false, "thetaselect on a dictionary", args(1, 6, batarg("r0", oid), batargany("lo", 0), batarg("lc", oid), batargany("lv", 1), argany("val",1), arg("op", str))),
  pattern("dict", "renumber", DICTrenumber, false, "renumber offsets", args(1, 3, batargany("n", 1), batargany("o", 1), batargany("r", 1))),
  pattern("dict", "select", DICTselect, false, "value - range select on a dictionary", args(1, 10, batarg("r0", oid), batargany("lo", 0), batarg("lc", oid), batargany("lv", 1), argany("l", 1), argany("h", 1), arg("li", bit), arg("hi", bit), arg("anti", bit),  arg("unknown", bit))),
+ pattern("fsst", "compress", FSSTcompress_col, false, "fsst compress a sql string column", args(0, 3, arg("schema", str), arg("table", str), arg("column", str))),
+ pattern("fsst", "decompress", FSSTdecompress, false, "decompress a fsst compressed (sub)column", args(1, 3, batarg("", str), batarg("o", str), batarg("u", str))),
+ pattern("fsst", "thetaselect", FSSTthetaselect, false, "thetaselect on a fsst compressed column", args(1, 6, batarg("r0", oid), batarg("o", str), batarg("lc", oid), batarg("u", str), arg("val", str), arg("op", str))),
+ pattern("fsst", "prefixselect", FSSTprefixselect, false, "select the values of a fsst compressed column starting with prefix", args(1, 6, batarg("r0", oid), batarg("o", str), batarg("lc", oid), batarg("u", str), arg("prefix", str), arg("anti", bit))),
  command("calc", "dec_round", bte_dec_round_wrap, false, "round off the value v to nearests multiple of r", args(1,3, arg("",bte),arg("v",bte),arg("r",bte))),
  pattern("batcalc", "dec_round", bte_bat_dec_round_wrap, false, "round off the value v to nearests multiple of r", args(1,3, batarg("",bte),batarg("v",bte),arg("r",bte))),
  pattern("batcalc", "dec_round", bte_bat_dec_round_wrap, false, "round off the value v to nearests multiple of r", args(1,4, batarg("",bte),batarg("v",bte),arg("r",bte),batarg("s",oid))),
@@ -6540,6 +6612,9 @@ static mel_func sql_init_funcs[] = {
  pattern("sqlcatalog", "rename_column", SQLrename_column, false, "Catalog operation rename_column", args(0,4, arg("sname",str),arg("tname",str),arg("cname",str),arg("newnme",str))),
  pattern("sqlcatalog", "create_ustr", SQLcreate_ustr, false, "Catalog operation create_ustr", args(0, 3, arg("sname",str),arg("uname",str),arg("ifnotexists",int))),
  pattern("sqlcatalog", "drop_ustr", SQLdrop_ustr, false, "Catalog operation drop_ustr", args(0, 4, arg("sname",str),arg("uname",str),arg("action",int),arg("ifexists",int))),
+ pattern("sql", "create_resource_group", SQLcreate_resource_group, true, "Create a resource group or change its weight, query slots and memory budget", args(0,4, arg("name",str),arg("weight",int),arg("slots",int),arg("memory",lng))),
+ pattern("sql", "drop_resource_group", SQLdrop_resource_group, true, "Drop a resource group", args(0,1, arg("name",str))),
+ pattern("sql", "assign_resource_group", SQLassign_resource_group, true, "Assign a user or role to a resource group, or remove the assignment when the group is nil", args(0,2, arg("member",str),arg("group",str))),
  /* sql_transaction */
  pattern("sql", "transaction_release", SQLtransaction_release, true, "A transaction statement (type can be commit,release,rollback or start)", args(1,3, arg("",void),arg("chain",int),arg("name",str))),
  pattern("sql", "transaction_commit", SQLtransaction_commit, true, "A transaction statement (type can be commit,release,rollback or start)", args(1,3, arg("",void),arg("chain",int),arg("name",str))),
@@ -21,6 +21,7 @@
 #include "sql_bincopyconvert.h"
 #include "copybinary.h"
 #include "copybinary_support.h"
+#include "mutils.h"
 
 
 #define bailout(...) do { \
@@ -258,6 +259,149 @@ load_column(type_record_t *rec, const char *name, BAT *bat, stream *s, int width
 		return msg;
 }
 
+/* Mapped files are decoded in ranges of at least this many bytes, by
+ * up to GDKnr_threads threads. */
+#define MAPPED_RANGE_SIZE (1 << 23)
+
+struct mapped_range {
+	MT_Id tid;
+	bool started;
+	QryCtx *qc;
+	bincopy_decoder_t decoder;	/* NULL means copy as is */
+	bincopy_validate_t validate;
+	const char *filename;
+	int width;
+	bool byteswap;
+	const char *src;
+	void *dst;
+	size_t count;
+	size_t record_size;
+	str msg;
+};
+
+static void
+load_mapped_range(void *arg)
+{
+	struct mapped_range *r = arg;
+
+	MT_thread_set_qry_ctx(r->qc);
+	if (r->decoder)
+		r->msg = r->decoder(r->dst, (void *) r->src, r->count, r->byteswap);
+	else
+		memcpy(r->dst, r->src, r->count * r->record_size);
+	if (r->msg == MAL_SUCCEED && r->validate)
+		r->msg = r->validate(r->dst, r->count, r->width, r->filename);
+}
+
+// Load a local file of fixed width records by mapping it into memory
+// and decoding ranges of it in parallel. Sets *mapped to false if the
+// file must be read through a stream instead, because it is compressed
+// or cannot be mapped.
+static str
+load_mapped_column(type_record_t *rec, const char *path, BAT *bat, int width, bool byteswap, BUN rows_estimate, bool *mapped)
+{
+	static const char mal_operator[] = "sql.importColumn";
+	str msg = MAL_SUCCEED;
+	const char *ext = strrchr(path, '.');
+	struct stat st;
+	char *data = NULL;
+	size_t size = 0;
+	struct mapped_range *ranges = NULL;
+	int nranges = 0;
+
+	bincopy_decoder_t decoder = rec->decoder;
+	if (rec->trivial_if_no_byteswap && !byteswap)
+		decoder = NULL;
+	size_t record_size = rec->record_size;
+	if (record_size == 0)
+		record_size = (size_t) ATOMsize(BATttype(bat));
+
+	*mapped = false;
+	if (ext != NULL && (strcmp(ext, ".gz") == 0 || strcmp(ext, ".bz2") == 0 ||
+						strcmp(ext, ".xz") == 0 || strcmp(ext, ".lz4") == 0))
+		return MAL_SUCCEED;
+	if (MT_stat(path, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0)
+		return MAL_SUCCEED;
+	size = (size_t) st.st_size;
+	if ((data = GDKmmap(path, MMAP_READ, size)) == NULL) {
+		GDKclrerr();
+		return MAL_SUCCEED;
+	}
+	*mapped = true;
+
+	if (size % record_size != 0)
+		bailout("final item incomplete in %s: %zu bytes instead of %zu", path, size % record_size, record_size);
+	BUN count = (BUN) (size / record_size);
+	if (rows_estimate != 0 && rows_estimate != count)
+		bailout(
+			"inconsistent row count in %s: expected "BUNFMT", got "BUNFMT,
+			path,
+			rows_estimate, count);
+	if (BATextend(bat, count) != GDK_SUCCEED)
+		bailout("%s", GDK_EXCEPTION);
+
+	nranges = GDKnr_threads;
+	if ((size_t) nranges > size / MAPPED_RANGE_SIZE)
+		nranges = (int) (size / MAPPED_RANGE_SIZE);
+	if (nranges < 1)
+		nranges = 1;
+	ranges = GDKzalloc(nranges * sizeof(struct mapped_range));
+	if (ranges == NULL) {
+		msg = createException(SQL, "sql", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		goto end;
+	}
+	BUN start = 0;
+	for (int i = 0; i < nranges; i++) {
+		BUN n = count / nranges + ((BUN) i < count % nranges);
+		ranges[i] = (struct mapped_range) {
+			.qc = MT_thread_get_qry_ctx(),
+			.decoder = decoder,
+			.validate = rec->validate,
+			.filename = path,
+			.width = width,
+			.byteswap = byteswap,
+			.src = data + start * record_size,
+			.dst = Tloc(bat, start),
+			.count = n,
+			.record_size = record_size,
+		};
+		start += n;
+	}
+	// The first range is done by this thread, and so are those for
+	// which no thread could be started.
+	for (int i = 1; i < nranges; i++) {
+		char name[MT_NAME_LEN];
+		snprintf(name, sizeof(name), "bincopy%d", i);
+		ranges[i].started = MT_create_thread(&ranges[i].tid, load_mapped_range, &ranges[i], MT_THR_JOINABLE, name) == 0;
+		if (!ranges[i].started)
+			load_mapped_range(&ranges[i]);
+	}
+	load_mapped_range(&ranges[0]);
+	for (int i = 0; i < nranges; i++) {
+		if (ranges[i].started)
+			MT_join_thread(ranges[i].tid);
+		if (msg == MAL_SUCCEED)
+			msg = ranges[i].msg;
+	}
+	if (msg != MAL_SUCCEED)
+		goto end;
+
+	BATsetcount(bat, count);
+	bat->tseqbase = oid_nil;
+	bat->tnonil = false;
+	bat->tnil = false;
+	bat->tsorted = count <= 1;
+	bat->trevsorted = count <= 1;
+	bat->tkey = count <= 1;
+	bat->tascii = false;
+
+end:
+	GDKfree(ranges);
+	if (data != NULL)
+		GDKmunmap(data, MMAP_READ, size);
+	return msg;
+}
+
 /* Import a single file into a new BAT.
  */
 static str
@@ -292,6 +436,14 @@ import_column(backend *be, bat *ret, BUN *retcnt, str method, int width, bool by
 	if (bat == NULL)
 		bailout("%s", GDK_EXCEPTION);
 
+	// Local files of fixed width records are mapped into memory
+	if (!onclient && rec->loader == NULL) {
+		bool mapped;
+		msg = load_mapped_column(rec, path, bat, width, byteswap, nrows, &mapped);
+		if (mapped)
+			goto end;
+	}
+
 	// Open the input stream
 	if (onclient) {
 		s = mapi_request_upload(path, true, be->mvc->scanner.rs, be->mvc->scanner.ws);
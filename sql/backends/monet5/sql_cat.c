@@ -34,6 +34,7 @@
 #include "rel_dump.h"
 #include "orderidx.h"
 #include "sql_user.h"
+#include "mal_resource.h"
 
 #define initcontext()													\
 	do {																\
@@ -2434,3 +2435,204 @@ SQLdrop_ustr(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 	}
 	return NULL;
 }
+
+/*
+ * Resource groups are enforced by the MAL admission control, see
+ * mal_resource.c. Their definitions and the assignment of users and roles
+ * are also kept in sys.db_resource_groups and sys.db_resource_group_members
+ * to recreate them when the server restarts.
+ */
+static str
+resgroup_tables(mvc *sql, const char *mcmd, sql_table **groups, sql_table **members)
+{
+	sql_trans *tr = sql->session->tr;
+	sql_schema *sys = find_sql_schema(tr, "sys");
+
+	if ((*groups = find_sql_table(tr, sys, "db_resource_groups")) == NULL ||
+		(*members = find_sql_table(tr, sys, "db_resource_group_members")) == NULL)
+		throw(SQL, mcmd, SQLSTATE(42000) "Resource groups are not available, the database needs an upgrade");
+	return MAL_SUCCEED;
+}
+
+str
+SQLcreate_resource_group(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	mvc *sql = NULL;
+	str msg = MAL_SUCCEED;
+	const char *name = *getArgReference_str(stk, pci, 1);
+	int weight = *getArgReference_int(stk, pci, 2);
+	int slots = *getArgReference_int(stk, pci, 3);
+	lng memory = *getArgReference_lng(stk, pci, 4);
+	static const char mcmd[] = "sql.create_resource_group";
+	sql_table *groups, *members;
+	int res;
+
+	initcontext();
+	if (strNil(name) || *name == 0)
+		throw(SQL, mcmd, SQLSTATE(42000) "Resource group name cannot be NULL");
+	if (is_int_nil(weight) || is_int_nil(slots) || is_lng_nil(memory))
+		throw(SQL, mcmd, SQLSTATE(42000) "Resource group settings cannot be NULL");
+	if (weight < 1 || weight > 1000)
+		throw(SQL, mcmd, SQLSTATE(42000) "Weight must be between 1 and 1000");
+	if (slots < 0)
+		throw(SQL, mcmd, SQLSTATE(42000) "Number of slots cannot be negative");
+	if (memory < 0)
+		throw(SQL, mcmd, SQLSTATE(42000) "Memory budget cannot be negative");
+	if ((msg = resgroup_tables(sql, mcmd, &groups, &members)) != MAL_SUCCEED)
+		return msg;
+
+	sql_trans *tr = sql->session->tr;
+	sqlstore *store = tr->store;
+	oid rid = store->table_api.column_find_row(tr, find_sql_column(groups, "name"), name, NULL);
+	if (is_oid_nil(rid)) {
+		res = store->table_api.table_insert(tr, groups, &name, &weight, &slots, &memory);
+	} else if ((res = store->table_api.column_update_value(tr, find_sql_column(groups, "weight"), rid, &weight)) == LOG_OK &&
+			   (res = store->table_api.column_update_value(tr, find_sql_column(groups, "slots"), rid, &slots)) == LOG_OK) {
+		res = store->table_api.column_update_value(tr, find_sql_column(groups, "max_memory"), rid, &memory);
+	}
+	if (res != LOG_OK)
+		throw(SQL, mcmd, SQLSTATE(42000) "Create resource group failed%s", res == LOG_CONFLICT ? " due to conflict with another transaction" : "");
+	/* the admission control follows the catalog once the transaction
+	 * has ended, see SQLautocommit */
+	sql->resgroups_changed = true;
+	return MAL_SUCCEED;
+}
+
+str
+SQLdrop_resource_group(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	mvc *sql = NULL;
+	str msg = MAL_SUCCEED;
+	const char *name = *getArgReference_str(stk, pci, 1);
+	static const char mcmd[] = "sql.drop_resource_group";
+	sql_table *groups, *members;
+	int res = LOG_OK;
+
+	initcontext();
+	if (strNil(name))
+		throw(SQL, mcmd, SQLSTATE(42000) "Resource group name cannot be NULL");
+	if ((msg = resgroup_tables(sql, mcmd, &groups, &members)) != MAL_SUCCEED)
+		return msg;
+
+	sql_trans *tr = sql->session->tr;
+	sqlstore *store = tr->store;
+	oid rid = store->table_api.column_find_row(tr, find_sql_column(groups, "name"), name, NULL);
+	if (is_oid_nil(rid))
+		throw(SQL, mcmd, SQLSTATE(42000) "Resource group '%s' does not exist", name);
+	res = store->table_api.table_delete(tr, groups, rid);
+	rids *r = store->table_api.rids_select(tr, find_sql_column(members, "groupname"), name, name, NULL);
+	if (r == NULL)
+		throw(SQL, mcmd, SQLSTATE(HY013) MAL_MALLOC_FAIL);
+	for (rid = store->table_api.rids_next(r); res == LOG_OK && !is_oid_nil(rid); rid = store->table_api.rids_next(r))
+		res = store->table_api.table_delete(tr, members, rid);
+	store->table_api.rids_destroy(r);
+	if (res != LOG_OK)
+		throw(SQL, mcmd, SQLSTATE(42000) "Drop resource group failed%s", res == LOG_CONFLICT ? " due to conflict with another transaction" : "");
+	sql->resgroups_changed = true;
+	return MAL_SUCCEED;
+}
+
+str
+SQLassign_resource_group(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	mvc *sql = NULL;
+	str msg = MAL_SUCCEED;
+	const char *member = *getArgReference_str(stk, pci, 1);
+	const char *group = *getArgReference_str(stk, pci, 2);
+	static const char mcmd[] = "sql.assign_resource_group";
+	sql_table *groups, *members;
+	int res = LOG_OK;
+
+	initcontext();
+	if (strNil(member))
+		throw(SQL, mcmd, SQLSTATE(42000) "User or role name cannot be NULL");
+	if ((msg = resgroup_tables(sql, mcmd, &groups, &members)) != MAL_SUCCEED)
+		return msg;
+
+	sql_trans *tr = sql->session->tr;
+	sqlstore *store = tr->store;
+	sql_table *auths = find_sql_table(tr, find_sql_schema(tr, "sys"), "auths");
+	if (is_oid_nil(store->table_api.column_find_row(tr, find_sql_column(auths, "name"), member, NULL)))
+		throw(SQL, mcmd, SQLSTATE(42M32) "User or role '%s' does not exist", member);
+	if (strNil(group)) {
+		group = NULL;
+	} else if (is_oid_nil(store->table_api.column_find_row(tr, find_sql_column(groups, "name"), group, NULL))) {
+		throw(SQL, mcmd, SQLSTATE(42000) "Resource group '%s' does not exist", group);
+	}
+	oid rid = store->table_api.column_find_row(tr, find_sql_column(members, "name"), member, NULL);
+	if (group == NULL) {
+		if (!is_oid_nil(rid))
+			res = store->table_api.table_delete(tr, members, rid);
+	} else if (is_oid_nil(rid)) {
+		res = store->table_api.table_insert(tr, members, &member, &group);
+	} else {
+		res = store->table_api.column_update_value(tr, find_sql_column(members, "groupname"), rid, (void *) group);
+	}
+	if (res != LOG_OK)
+		throw(SQL, mcmd, SQLSTATE(42000) "Assign resource group failed%s", res == LOG_CONFLICT ? " due to conflict with another transaction" : "");
+	sql->resgroups_changed = true;
+	return MAL_SUCCEED;
+}
+
+/* Bring the resource groups in line with the catalog, when the server
+ * starts and after a transaction that changed them */
+str
+SQLload_resource_groups(mvc *sql)
+{
+	sql_trans *tr = sql->session->tr;
+	sqlstore *store = tr->store;
+	sql_table *groups, *members;
+	str msg = MAL_SUCCEED;
+	rids *r;
+	ResGroup glist;
+	char **mlist, **mglist;
+	int n, nmembers;
+
+	sql_schema *sys = find_sql_schema(tr, "sys");
+	if ((groups = find_sql_table(tr, sys, "db_resource_groups")) == NULL ||
+		(members = find_sql_table(tr, sys, "db_resource_group_members")) == NULL)
+		return MAL_SUCCEED;		/* not upgraded yet */
+	/* forget what is no longer in the catalog */
+	if ((n = MALresgroup_list(&glist, &mlist, &mglist, &nmembers)) < 0)
+		throw(SQL, "sql.load_resource_groups", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+	for (int i = 0; i < nmembers && msg == MAL_SUCCEED; i++)
+		if (is_oid_nil(store->table_api.column_find_row(tr, find_sql_column(members, "name"), mlist[i], NULL)))
+			msg = MALresgroup_assign(mlist[i], NULL);
+	for (int i = 0; i < n && msg == MAL_SUCCEED; i++)
+		if (is_oid_nil(store->table_api.column_find_row(tr, find_sql_column(groups, "name"), glist[i].name, NULL)))
+			msg = MALresgroup_drop(glist[i].name);
+	MALresgroup_list_free(glist, n, mlist, mglist, nmembers);
+	if (msg)
+		return msg;
+	if ((r = store->table_api.rids_select(tr, find_sql_column(groups, "name"), NULL, NULL)) == NULL)
+		throw(SQL, "sql.load_resource_groups", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+	for (oid rid = store->table_api.rids_next(r); msg == MAL_SUCCEED && !is_oid_nil(rid); rid = store->table_api.rids_next(r)) {
+		char *name = store->table_api.column_find_value(tr, find_sql_column(groups, "name"), rid);
+		if (name == NULL) {
+			msg = createException(SQL, "sql.load_resource_groups", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+			break;
+		}
+		msg = MALresgroup_create(name,
+								 store->table_api.column_find_int(tr, find_sql_column(groups, "weight"), rid),
+								 store->table_api.column_find_int(tr, find_sql_column(groups, "slots"), rid),
+								 store->table_api.column_find_lng(tr, find_sql_column(groups, "max_memory"), rid));
+		_DELETE(name);
+	}
+	store->table_api.rids_destroy(r);
+	if (msg)
+		return msg;
+	if ((r = store->table_api.rids_select(tr, find_sql_column(members, "name"), NULL, NULL)) == NULL)
+		throw(SQL, "sql.load_resource_groups", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+	for (oid rid = store->table_api.rids_next(r); msg == MAL_SUCCEED && !is_oid_nil(rid); rid = store->table_api.rids_next(r)) {
+		char *member = store->table_api.column_find_value(tr, find_sql_column(members, "name"), rid);
+		char *group = store->table_api.column_find_value(tr, find_sql_column(members, "groupname"), rid);
+		if (member == NULL || group == NULL)
+			msg = createException(SQL, "sql.load_resource_groups", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		else
+			msg = MALresgroup_assign(member, group);
+		_DELETE(member);
+		_DELETE(group);
+	}
+	store->table_api.rids_destroy(r);
+	return msg;
+}
@@ -66,5 +66,9 @@ extern str SQLrename_table(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr p
 extern str SQLrename_column(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci);
 extern str SQLcreate_ustr(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci);
 extern str SQLdrop_ustr(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci);
+extern str SQLcreate_resource_group(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci);
+extern str SQLdrop_resource_group(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci);
+extern str SQLassign_resource_group(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci);
+extern str SQLload_resource_groups(mvc *sql);
 
 #endif /* _SQL_CATALOG_H */
@@ -34,6 +34,7 @@
 #include "rel_dump.h"
 #include "optimizer.h"
 #include "opt_inline.h"
+#include "mal_resource.h"
 #include <unistd.h>
 
 /* #define _SQL_COMPILE */
@@ -52,6 +53,7 @@ SQLrun(Client c, backend *be)
 	mvc *m = be->mvc;
 	str msg = MAL_SUCCEED;
 	MalBlkPtr mb = c->curprg->def;
+	bool admitted = false;
 
 	assert(!*m->errstr);
 
@@ -61,7 +63,8 @@ SQLrun(Client c, backend *be)
 	if (m->emod == mod_explain_phys) {
 		if (c->curprg->def)
 			printFunction(c->fdout, mb, 0, LIST_MAL_NAME | LIST_MAL_VALUE  | LIST_MAL_TYPE |  LIST_MAL_MAPI);
-	} else {
+	} else if ((msg = MALresgroup_enter(c, get_string_global_var(m, "current_role"), &admitted)) == MAL_SUCCEED) {
+		/* admitted by the resource group of the user or role, if any */
 		if (m->trace){
 			if ((msg = startTrace(c)) == MAL_SUCCEED) {
 				setVariableScope(mb);
@@ -78,6 +81,8 @@ SQLrun(Client c, backend *be)
 			MT_lock_unset(&mal_contextLock);
 			msg = runMAL(c, mb, 0, 0);
 		}
+		if (admitted)
+			MALresgroup_leave(c);
 		if (msg == MAL_SUCCEED) {
 			msg = resetMalBlk(&c->curprg->def);
 			be->mb = NULL;
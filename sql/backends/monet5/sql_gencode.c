@@ -1076,7 +1076,7 @@ backend_dumpstmt(backend *be, MalBlkPtr mb, sql_rel *r, int top, int add_end, co
 
 /* SQL procedures, functions and PREPARE statements are compiled into a parameterised plan */
 static int
-backend_dumpproc_body(backend *be, Client c, sql_rel *r)
+backend_dumpproc_body(backend *be, Client c, sql_rel *r, bool bulk)
 {
 	mvc *m = be->mvc;
 	MalBlkPtr mb = 0;
@@ -1085,6 +1085,7 @@ backend_dumpproc_body(backend *be, Client c, sql_rel *r)
 	int res = -1, added_to_cache = 0;
 
 	backend_reset(be);
+	be->bulk_params = bulk;
 
 	mb = c->curprg->def;
 	curInstr = getInstrPtr(mb, 0);
@@ -1102,7 +1103,7 @@ backend_dumpproc_body(backend *be, Client c, sql_rel *r)
 				sql_error(m, 10, SQLSTATE(42000) "Could not determine type for argument number %d", argc+1);
 				goto cleanup;
 			}
-			type = tpe->localtype;
+			type = bulk ? newBatType(tpe->localtype) : tpe->localtype;
 			snprintf(arg, sizeof(arg), "A%d", argc);
 			if ((varid = newVariable(mb, arg,strlen(arg), type)) < 0) {
 				sql_error(m, 10, SQLSTATE(42000) "Internal error while compiling statement: variable id too long");
@@ -1146,8 +1147,8 @@ cleanup:
 	return res;
 }
 
-int
-backend_dumpproc(backend *be, Client c, cq *cq, sql_rel *r)
+static int
+_backend_dumpproc(backend *be, Client c, const char *name, sql_rel *r, bool bulk)
 {
 	mvc *m = be->mvc;
 	Symbol symbackup = c->curprg;
@@ -1160,8 +1161,7 @@ backend_dumpproc(backend *be, Client c, cq *cq, sql_rel *r)
 		argc += list_length(m->params);
 	if (argc < MAXARG)
 		argc = MAXARG;
-	assert(cq && strlen(cq->name) < IDLENGTH);
-	c->curprg = newFunctionArgs(sql_private_module, cq->name = putName(cq->name), FUNCTIONsymbol, argc);
+	c->curprg = newFunctionArgs(sql_private_module, name, FUNCTIONsymbol, argc);
 	if (c->curprg == NULL) {
 		sql_error(m, 10, SQLSTATE(HY013) MAL_MALLOC_FAIL);
 		goto bailout;
@@ -1169,7 +1169,7 @@ backend_dumpproc(backend *be, Client c, cq *cq, sql_rel *r)
 		sql_error(m, 10, "%s", ma_get_eb(m->sa)->msg);
 		freeSymbol(c->curprg);
 		goto bailout;
-	} else if (backend_dumpproc_body(be, c, r) < 0) {
+	} else if (backend_dumpproc_body(be, c, r, bulk) < 0) {
 		goto bailout;
 	}
 	*be = bebackup;
@@ -1183,6 +1183,137 @@ backend_dumpproc(backend *be, Client c, cq *cq, sql_rel *r)
 	return -1;
 }
 
+int
+backend_dumpproc(backend *be, Client c, cq *cq, sql_rel *r)
+{
+	assert(cq && strlen(cq->name) < IDLENGTH);
+	cq->name = putName(cq->name);
+	return _backend_dumpproc(be, c, cq->name, r, false);
+}
+
+/* The values of a prepared INSERT INTO .. VALUES (..) may only depend on
+ * the parameters and on constants, for a batch of parameter tuples to give
+ * the same rows as the separate executions */
+static bool
+exp_batchable(sql_exp *e, bool columns, int *nparams)
+{
+	switch (e->type) {
+	case e_atom:
+		if (e->f || e->r)	/* values lists and variables */
+			return false;
+		if (!e->l)
+			(*nparams)++;
+		return true;
+	case e_column:	/* computed by the projection underneath */
+		return columns;
+	case e_convert:
+		return exp_batchable(e->l, columns, nparams);
+	case e_func: {
+		sql_subfunc *f = e->f;
+		list *args = e->l;
+
+		if (f->func->type != F_FUNC || f->func->side_effect)
+			return false;
+		if (args)
+			for (node *n = args->h; n; n = n->next)
+				if (!exp_batchable(n->data, columns, nparams))
+					return false;
+		return true;
+	}
+	default:
+		return false;
+	}
+}
+
+static bool
+rel_batchable(sql_rel *r)
+{
+	sql_rel *tr, *vr;
+	sql_table *t;
+	int nparams = 0;
+
+	/* without RETURNING an INSERT INTO counts the affected rows */
+	if (!r || !is_groupby(r->op) || !list_empty(r->r) || !(r = r->l) || r->op != op_insert)
+		return false;
+	tr = r->l;
+	if (!tr || tr->op != op_basetable || !r->r)
+		return false;
+	t = tr->l;
+	/* statement level triggers would fire once instead of once per tuple */
+	if (!isTable(t) || ol_length(t->triggers) > 0)
+		return false;
+	/* the values, possibly with the index columns projected on top */
+	for (vr = r->r; vr; vr = vr->l) {
+		if (vr->op != op_project || vr->r || need_distinct(vr))
+			return false;
+		for (node *n = vr->exps->h; n; n = n->next)
+			if (!exp_batchable(n->data, vr->l != NULL, &nparams))
+				return false;
+	}
+	return nparams > 0;
+}
+
+/* Compile the variant of a prepared statement which executes a whole batch of
+ * parameter tuples at once, each parameter being passed as a BAT. Returns 0
+ * without compiling anything when the statement does not allow that. */
+int
+backend_dumpproc_bulk(backend *be, Client c, cq *cq, sql_rel *r)
+{
+	char name[IDLENGTH];
+	sql_func *f;
+
+	if (!rel_batchable(r))
+		return 0;
+	if (snprintf(name, sizeof(name), "%s_bulk", cq->name) >= (int) sizeof(name) ||
+		(f = SA_NEW(cq->sa, sql_func)) == NULL)
+		return -1;
+	*f = *cq->f;
+	if ((f->imp = ma_strdup(cq->sa, name)) == NULL)
+		return -1;
+	f->base.name = f->imp;
+	/* generating the first plan may have changed the statement type */
+	be->mvc->type = cq->type;
+	if (_backend_dumpproc(be, c, putName(name), r, true) < 0)
+		return -1;
+	f->instantiated = true;
+	cq->bulk = f;
+	return 0;
+}
+
+/* A restart of the query cache drops the code of the bulk variant, like that
+ * of the plan itself (see cq_restart). Compile it again from the statement,
+ * as it may have to change with the catalog. The variant is dropped if that
+ * fails or if the statement no longer allows it. */
+int
+backend_rebuild_bulk(backend *be, Client c, cq *cq)
+{
+	mvc *m = be->mvc;
+	allocator *sa = m->sa;
+	list *params = m->params;
+	char emode = m->emode;
+	mapi_query_t type = m->type;
+	sql_rel *r;
+	int res = -1;
+
+	cq->bulk = NULL;
+	m->sa = cq->sa;
+	r = rel_parse(m, cq->f->s, cq->f->query, m_prepare);
+	if (r) {
+		r = sql_processrelation(m, r, 0, 1, 1, 0);
+		r = rel_physical(m, r);
+	}
+	if (r) {
+		m->params = cq->f->ops;
+		m->emode = m_prepare;
+		res = backend_dumpproc_bulk(be, c, cq, r);
+	}
+	m->sa = sa;
+	m->params = params;
+	m->emode = emode;
+	m->type = type;
+	return res;
+}
+
 int
 monet5_has_module(ptr M, char *module)
 {
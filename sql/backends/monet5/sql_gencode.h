@@ -20,6 +20,8 @@
 #include "mal_function.h"
 
 extern int backend_dumpproc(backend *be, Client c, cq *q, sql_rel *r);
+extern int backend_dumpproc_bulk(backend *be, Client c, cq *q, sql_rel *r);
+extern int backend_rebuild_bulk(backend *be, Client c, cq *q);
 extern int backend_dumpstmt(backend *be, MalBlkPtr mb, sql_rel *r, int top, int addend, const char *query);
 extern int monet5_has_module(ptr M, char *module);
 extern void monet5_freecode(const char *mod, int clientid, const char *name);
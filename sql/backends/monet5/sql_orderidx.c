@@ -9,7 +9,8 @@
  */
 
 /* (c) M.L. Kersten
- * The order index interface routines are defined here.
+ * The order index, trigram index and full-text index interface routines
+ * are defined here.
 */
 #include "monetdb_config.h"
 #include "mal_backend.h"
@@ -119,3 +120,108 @@ sql_droporderindex(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 	BBPunfix(b->batCacheid);
 	return msg;
 }
+
+/* bind the string column given by the arguments of the trigram and
+ * full-text index procedures, or rather its parent */
+static str
+string_column(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci, const char *fcn, BAT **bp)
+{
+	mvc *m = NULL;
+	str msg = getSQLContext(cntxt, mb, &m, NULL);
+	str sch,tbl,col;
+	sql_schema *s;
+	sql_table *t;
+	sql_column *c;
+	BAT *b = NULL, *nb = NULL;
+
+	if (msg != MAL_SUCCEED || (msg = checkSQLContext(cntxt)) != NULL)
+		return msg;
+
+	sch = *getArgReference_str(stk, pci, 1);
+	tbl = *getArgReference_str(stk, pci, 2);
+	col = *getArgReference_str(stk, pci, 3);
+	if (strNil(sch))
+		throw(SQL, fcn, SQLSTATE(42000) "Schema name cannot be NULL");
+	if (strNil(tbl))
+		throw(SQL, fcn, SQLSTATE(42000) "Table name cannot be NULL");
+	if (strNil(col))
+		throw(SQL, fcn, SQLSTATE(42000) "Column name cannot be NULL");
+
+	if (!(s = mvc_bind_schema(m, sch)))
+		throw(SQL, fcn, SQLSTATE(3FOOO) "Unknown schema %s", sch);
+	if (!mvc_schema_privs(m, s))
+		throw(SQL, fcn, SQLSTATE(42000) "Access denied for %s to schema '%s'", get_string_global_var(m, "current_user"), s->base.name);
+	if (!(t = mvc_bind_table(m, s, tbl)))
+		throw(SQL, fcn, SQLSTATE(42S02) "Unknown table %s.%s", sch, tbl);
+	if (!isTable(t))
+		throw(SQL, fcn, SQLSTATE(42000) "%s '%s' is not persistent", TABLE_TYPE_DESCRIPTION(t->type, t->properties), t->base.name);
+	if (!(c = mvc_bind_column(m, t, col)))
+		throw(SQL, fcn, SQLSTATE(38000) "Unknown column %s.%s.%s", sch, tbl, col);
+	if (c->type.type->localtype != TYPE_str)
+		throw(SQL, fcn, SQLSTATE(42000) "Column %s.%s.%s is not a string column", sch, tbl, col);
+	sqlstore *store = m->session->tr->store;
+	if (!(b = store->storage_api.bind_col(m->session->tr, c, RDONLY)))
+		throw(SQL, fcn, SQLSTATE(HY005) "Column can not be accessed");
+	if (VIEWtparent(b)) {
+		nb = BBP_desc(VIEWtparent(b));
+		BBPunfix(b->batCacheid);
+		if (!(b = BATdescriptor(nb->batCacheid)))
+			throw(SQL, fcn, SQLSTATE(HY005) "Column can not be accessed");
+	}
+	*bp = b;
+	return MAL_SUCCEED;
+}
+
+str
+sql_createtrigramindex(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	BAT *b = NULL;
+	str msg = string_column(cntxt, mb, stk, pci, "sql.createtrigramindex", &b);
+
+	if (msg != MAL_SUCCEED)
+		return msg;
+	if (TRGMcreate(b) != GDK_SUCCEED)
+		msg = createException(SQL, "sql.createtrigramindex", GDK_EXCEPTION);
+	BBPunfix(b->batCacheid);
+	return msg;
+}
+
+str
+sql_droptrigramindex(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	BAT *b = NULL;
+	str msg = string_column(cntxt, mb, stk, pci, "sql.droptrigramindex", &b);
+
+	if (msg != MAL_SUCCEED)
+		return msg;
+	TRGMdestroy(b);
+	BBPunfix(b->batCacheid);
+	return msg;
+}
+
+str
+sql_createfulltextindex(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	BAT *b = NULL;
+	str msg = string_column(cntxt, mb, stk, pci, "sql.createfulltextindex", &b);
+
+	if (msg != MAL_SUCCEED)
+		return msg;
+	if (FTXTcreate(b) != GDK_SUCCEED)
+		msg = createException(SQL, "sql.createfulltextindex", GDK_EXCEPTION);
+	BBPunfix(b->batCacheid);
+	return msg;
+}
+
+str
+sql_dropfulltextindex(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	BAT *b = NULL;
+	str msg = string_column(cntxt, mb, stk, pci, "sql.dropfulltextindex", &b);
+
+	if (msg != MAL_SUCCEED)
+		return msg;
+	FTXTdestroy(b);
+	BBPunfix(b->batCacheid);
+	return msg;
+}
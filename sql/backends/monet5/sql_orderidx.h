@@ -16,5 +16,9 @@
 
 extern str sql_createorderindex(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci);
 extern str sql_droporderindex(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci);
+extern str sql_createtrigramindex(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci);
+extern str sql_droptrigramindex(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci);
+extern str sql_createfulltextindex(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci);
+extern str sql_dropfulltextindex(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci);
 
 #endif /* _SQL_ORDERIDX_DEF */
@@ -1917,6 +1917,105 @@ mvc_export_chunk(backend *b, stream *s, int res_id, BUN offset, BUN nr)
 	return res;
 }
 
+/* A result set whose rows are sent while the pipeline producing them
+ * runs. The header goes out first, announcing no rows; the rows of
+ * each morsel follow as soon as all its columns arrived. The client
+ * learns the row count from the rows themselves. */
+struct res_stream {
+	stream *s;
+	mvc *m;
+	res_table *t;
+	BAT **morsel;		/* current morsel, per column */
+	int have;			/* number of columns in morsel */
+	lng sent;
+};
+
+int
+mvc_export_stream_begin(backend *b, stream *s, int res_id, lng starttime, lng maloptimizer)
+{
+	res_table *t = res_tables_find(b->results, res_id);
+	struct res_stream *rs;
+	int res;
+
+	if (!s || !t)
+		return 0;
+	assert(b->rstream == NULL);
+	if ((res = mvc_export_head(b, s, res_id, true, starttime, maloptimizer)) < 0)
+		return res;
+	if ((rs = GDKzalloc(sizeof(struct res_stream))) == NULL ||
+		(rs->morsel = GDKzalloc(sizeof(BAT *) * t->nr_cols)) == NULL) {
+		GDKfree(rs);
+		return -1;
+	}
+	rs->s = s;
+	rs->m = b->mvc;
+	rs->t = t;
+	b->rstream = rs;
+	return 0;
+}
+
+/* called by the pipeline instead of appending to result column 'col';
+ * returns the number of rows sent */
+lng
+mvc_export_stream_put(void *data, bat col, BAT *b)
+{
+	struct res_stream *rs = data;
+	res_table *t = rs->t;
+	int i, res;
+
+	for (i = 0; i < t->nr_cols && t->cols[i].b != col; i++)
+		;
+	if (i == t->nr_cols || rs->morsel[i])
+		return -2;
+	/* the columns of a morsel need not share their head */
+	if ((rs->morsel[i] = VIEWcreate(0, b, 0, BUN_MAX)) == NULL)
+		return -3;
+	if (++rs->have < t->nr_cols)
+		return 0;
+
+	BUN cnt = BATcount(rs->morsel[0]);
+	/* runs on the pipeline worker that completed the morsel */
+	allocator *ta = MT_thread_getallocator();
+	allocator_state ta_state = ma_open(ta);
+	res_table mt = *t;
+	if ((mt.cols = ma_alloc(ta, sizeof(res_col) * t->nr_cols)) == NULL) {
+		res = -1;
+	} else {
+		for (i = 0; i < t->nr_cols; i++) {
+			mt.cols[i] = t->cols[i];
+			mt.cols[i].b = rs->morsel[i]->batCacheid;
+		}
+		res = mvc_export_table_(ta, rs->m, OFMT_CSV, rs->s, &mt, 0, cnt, "[ ", ",\t", "\t]\n", "\"", "NULL");
+	}
+	ma_close(&ta_state);
+	for (i = 0; i < t->nr_cols; i++) {
+		BBPreclaim(rs->morsel[i]);
+		rs->morsel[i] = NULL;
+	}
+	rs->have = 0;
+	if (res < 0)
+		return res;
+	rs->sent += cnt;
+	return (lng) cnt;
+}
+
+int
+mvc_export_stream_end(backend *b)
+{
+	struct res_stream *rs = b->rstream;
+	int res = rs->have ? -2 : 0;	/* incomplete morsel */
+
+	b->rstream = NULL;
+	for (int i = 0; i < rs->t->nr_cols; i++)
+		BBPreclaim(rs->morsel[i]);
+	b->rowcnt = rs->sent;
+	sqlvar_set_number(find_global_var(b->mvc, mvc_bind_schema(b->mvc, "sys"), "rowcnt"), b->rowcnt);
+	b->results = res_tables_remove(b->results, rs->t);
+	GDKfree(rs->morsel);
+	GDKfree(rs);
+	return res;
+}
+
 int
 mvc_result_table(backend *be, oid query_id, int nr_cols, mapi_query_t type)
 {
@@ -33,6 +33,12 @@ extern int mvc_export_chunk(backend *b, stream *s, int res_id, BUN offset, BUN n
 	__attribute__((__visibility__("hidden")));
 extern int mvc_export_bin_chunk(backend *b, stream *s, int res_id, BUN offset, BUN nr)
 	__attribute__((__visibility__("hidden")));
+extern int mvc_export_stream_begin(backend *b, stream *s, int res_id, lng starttime, lng maloptimizer)
+	__attribute__((__visibility__("hidden")));
+extern lng mvc_export_stream_put(void *data, bat col, BAT *b)
+	__attribute__((__visibility__("hidden")));
+extern int mvc_export_stream_end(backend *b)
+	__attribute__((__visibility__("hidden")));
 
 extern int mvc_export_prepare(backend *b, stream *s)
 	__attribute__((__visibility__("hidden")));
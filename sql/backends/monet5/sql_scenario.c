@@ -29,6 +29,8 @@
 #include "sql_env.h"
 #include "sql_mvc.h"
 #include "sql_user.h"
+#include "sql_cat.h"
+#include "sql_statistics.h"
 #include "sql_datetime.h"
 #include "sql_import.h"
 #include "mal.h"
@@ -40,6 +42,7 @@
 #include "mal_linker.h"
 #include "mal_scenario.h"
 #include "mal_authorize.h"
+#include "mal_mapi.h"
 #include "mcrypt.h"
 #include "mutils.h"
 #include "bat5.h"
@@ -631,6 +634,16 @@ SQLresetClient(Client c)
 		}
 		if (m->session->tr->active)
 			other = mvc_rollback(m, 0, NULL, false);
+		if (m->resgroups_changed) {
+			str err = SQLtrans(m);
+			if (m->session->tr->active) {
+				str rerr = mvc_rollback(m, 0, NULL, false);
+				if (err == MAL_SUCCEED)
+					err = rerr;
+			}
+			if (other == MAL_SUCCEED)
+				other = err;
+		}
 
 		res_tables_destroy(be->results);
 		be->results = NULL;
@@ -831,6 +844,15 @@ SQLinit(Client c, const char *initpasswd)
 		}
 		maybeupgrade = 0;
 	}
+	/* recreate the resource groups and histograms kept in the catalog */
+	if (!msg && (msg = SQLtrans(m)) == MAL_SUCCEED) {
+		msg = SQLload_resource_groups(m);
+		if (!msg)
+			msg = sql_load_histograms(m);
+		other = mvc_rollback(m, 0, NULL, false);
+		if (other && !msg)
+			msg = other;
+	}
 	fflush(stdout);
 	fflush(stderr);
 
@@ -909,6 +931,17 @@ SQLautocommit(mvc *m)
 			msg = mvc_commit(m, 0, NULL, false);
 		}
 	}
+	/* changes of the resource groups take effect when the transaction
+	 * that made them has been committed, read them back in a
+	 * transaction of our own */
+	if (msg == MAL_SUCCEED && m->resgroups_changed && !m->session->tr->active) {
+		msg = SQLtrans(m);
+		if (m->session->tr->active) {
+			str other = mvc_rollback(m, 0, NULL, false);
+			if (other && !msg)
+				msg = other;
+		}
+	}
 	return msg;
 }
 
@@ -947,6 +980,12 @@ SQLtrans(mvc *m)
 				throw(SQL, "sql.trans", SQLSTATE(42000) "The session's schema was not found, this session is going to terminate");
 			}
 		}
+		if (m->resgroups_changed) {
+			/* the transaction that changed the resource groups has
+			 * ended, committed or not */
+			m->resgroups_changed = false;
+			return SQLload_resource_groups(m);
+		}
 	} else {
 		m->session->tr->cnr++;
 	}
@@ -1265,6 +1304,84 @@ SQLreader(Client c, backend *be)
 	return msg;
 }
 
+/*
+ * Log in again over an established connection, as a connection pool
+ * does when it hands the connection to its next client.  The response
+ * has the same form as that on the challenge of a new connection and
+ * answers the challenge sent by Xchallenge, which is good for one
+ * attempt only.  The session is reset completely, failure ends the
+ * connection.
+ */
+static str
+SQLreauthClient(Client c, backend *be, char *resp)
+{
+	char challenge[sizeof(be->challenge)];
+	char *user = resp, *algo, *passwd, *lang, *database, *opts = NULL, *s;
+	const char *dbname = GDKgetenv("gdk_dbname");
+	bool filetrans = false;
+	str msg;
+
+	strcpy(challenge, be->challenge);
+	be->challenge[0] = 0;
+	c->mode = FINISHCLIENT;
+	if (*challenge == 0)
+		throw(SQL, "SQLreauth", SQLSTATE(42000) "no outstanding challenge");
+
+	/* BIG/LIT:user:{algo}hash:lang:database:[FILETRANS]:[options:] */
+	if ((s = strchr(user, ':')) == NULL)
+		throw(SQL, "SQLreauth", SQLSTATE(42000) "incomplete challenge");
+	user = s + 1;
+	if ((s = strchr(user, ':')) == NULL || s[1] != '{')
+		throw(SQL, "SQLreauth", SQLSTATE(42000) "invalid password entry");
+	*s = 0;
+	algo = s + 2;
+	if ((s = strchr(algo, '}')) == NULL)
+		throw(SQL, "SQLreauth", SQLSTATE(42000) "invalid password entry");
+	*s = 0;
+	passwd = s + 1;
+	if ((s = strchr(passwd, ':')) == NULL)
+		throw(SQL, "SQLreauth", SQLSTATE(42000) "incomplete challenge, missing language");
+	*s = 0;
+	lang = s + 1;
+	if ((s = strchr(lang, ':')) == NULL)
+		throw(SQL, "SQLreauth", SQLSTATE(42000) "incomplete challenge, missing database");
+	*s = 0;
+	database = s + 1;
+	if ((s = strchr(database, ':')) != NULL) {
+		*s++ = 0;
+		if (strncmp(s, "FILETRANS:", 10) == 0) {
+			filetrans = true;
+			s += 10;
+		} else if (*s == ':') {
+			s++;
+		}
+		if (strncmp(s, "COMPRESS=", 9) != 0 && (opts = strchr(s, ':')) != NULL) {
+			*opts = 0;
+			opts = s;
+		}
+	}
+	if (strcmp(lang, "sql") != 0)
+		throw(SQL, "SQLreauth", SQLSTATE(42000) "only sql sessions can be taken over");
+	if (*database && strcmp(database, dbname) != 0)
+		throw(SQL, "SQLreauth", SQLSTATE(42000) "request for database '%s', but this is database '%s'", database, dbname);
+
+	MT_lock_set(&sql_contextLock);
+	msg = SQLresetClient(c);
+	MT_lock_unset(&sql_contextLock);
+	if (msg)
+		return msg;
+	MCresetSession(c);
+	c->username = ma_strdup(c->ma, user);
+	c->handshake_options = opts ? ma_strdup(c->ma, opts) : NULL;
+	if (c->username == NULL || (opts && c->handshake_options == NULL))
+		throw(SQL, "SQLreauth", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+	c->filetrans = filetrans;
+	if ((msg = SQLinitClient(c, passwd, challenge, algo)) != MAL_SUCCEED)
+		return msg;
+	c->mode = RUNCLIENT;
+	return MAL_SUCCEED;
+}
+
 static str
 SQLchannelcmd(Client c, backend *be)
 {
@@ -1364,6 +1481,12 @@ SQLchannelcmd(Client c, backend *be)
 		in->pos = in->len;	/* HACK: should use parsed length */
 		return MAL_SUCCEED;
 	}
+	if (strncmp(in->buf + in->pos, "streaming ", 10) == 0) {
+		v = (int) strtol(in->buf + in->pos + 10, NULL, 10);
+		be->streaming = v != 0;
+		in->pos = in->len;	/* HACK: should use parsed length */
+		return MAL_SUCCEED;
+	}
 	if (strncmp(in->buf + in->pos, "clientinfo ", 11) == 0) {
 		in->pos += 11;
 		char *end = in->buf + in->len;
@@ -1384,6 +1507,32 @@ SQLchannelcmd(Client c, backend *be)
 		in->pos = in->len;
 		return MAL_SUCCEED;
 	}
+	/* only monetdbd hands a connection to another user, and it marks
+	 * such connections when it connects */
+	if (c->pooled && strncmp(in->buf + in->pos, "challenge ", 10) == 0) {
+		/* echo the tag, so the caller can find the challenge behind
+		 * the results of any earlier queries */
+		char *tag = in->buf + in->pos + 10;
+		size_t taglen = in->len - in->pos - 10;
+		char *end = memchr(tag, '\n', taglen);
+		if (end)
+			taglen = (size_t) (end - tag);
+		in->pos = in->len;	/* HACK: should use parsed length */
+		mnstr_printf(out, "%.*s\n", (int) taglen, tag);
+		SERVERchallenge(out, be->challenge);
+		return MAL_SUCCEED;
+	}
+	if (c->pooled && strncmp(in->buf + in->pos, "reauth ", 7) == 0) {
+		char *resp = GDKstrndup(in->buf + in->pos + 7, in->len - in->pos - 7);
+		in->pos = in->len;	/* HACK: should use parsed length */
+		if (resp == NULL) {
+			c->mode = FINISHCLIENT;
+			throw(SQL, "SQLparser", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		}
+		msg = SQLreauthClient(c, be, resp);
+		GDKfree(resp);
+		return msg;
+	}
 	if (strncmp(in->buf + in->pos, "quit", 4) == 0) {
 		c->mode = FINISHCLIENT;
 		in->pos = in->len;	/* HACK: should use parsed length */
@@ -1395,13 +1544,40 @@ SQLchannelcmd(Client c, backend *be)
 	return msg;
 }
 
+/* EXEC nr (..), (..), .. of a prepared statement of which a restart of the
+ * query cache dropped the bulk variant compiles that again first, else
+ * rel_exec_batch would run the batch tuple at a time */
+static void
+exec_batch_rebuild(Client c, backend *be, symbol *sym)
+{
+	mvc *m = be->mvc;
+	cq *q;
+
+	if (!(m->emod & mod_exec) || sym->token != SQL_CALL || sym->type == type_list ||
+		dlist_length(sym->data.sym->data.lval) <= 3 ||
+		(q = qc_find(m->qc, sym->data.sym->data.lval->h->data.i_val)) == NULL ||
+		!q->bulk || q->bulk->instantiated)
+		return;
+	if (backend_rebuild_bulk(be, c, q) < 0) {
+		/* the batch then runs tuple at a time */
+		m->errstr[0] = '\0';
+		m->session->status = 0;
+	}
+}
+
 static char *
 parse_execute(Client c, backend *be, symbol *sym)
 {
 	mvc *m = be->mvc;
 	int err = 0, pstatus = m->session->status;
-	sql_rel *r = sql_symbol2relation(be, sym);
+	sql_rel *r;
 	char *msg = NULL;
+	bool batch;
+
+	exec_batch_rebuild(c, be, sym);
+	r = sql_symbol2relation(be, sym);
+	/* the calls of a batched EXEC, see rel_exec_batch */
+	batch = r && (m->emod & mod_exec) && r->op == op_ddl && r->flag == ddl_psm && list_length(r->exps) > 1;
 
 	if (!r || (err = mvc_status(m) && m->type != Q_TRANS && *m->errstr)) {
 		if (strlen(m->errstr) > 6 && m->errstr[5] == '!')
@@ -1529,6 +1705,10 @@ parse_execute(Client c, backend *be, symbol *sym)
 		if (be->q && backend_dumpproc(be, c, be->q, r) < 0) {
 			msg = handle_error(m, 0, msg);
 			err = 1;
+		} else if (be->q && backend_dumpproc_bulk(be, c, be->q, r) < 0) {
+			/* batches then run tuple at a time */
+			m->errstr[0] = '\0';
+			m->session->status = 0;
 		}
 
 		/* passed over to query cache, used during dumpproc */
@@ -1565,7 +1745,19 @@ parse_execute(Client c, backend *be, symbol *sym)
 	assert (m->emode != m_deallocate && m->emode != m_prepare);
 	assert (c->curprg->def->stop > 2);
 
+	be->batch = batch;
+	be->batchrows = -1;
 	msg = SQLrun(c, be);
+	be->batch = false;
+	if (msg == MAL_SUCCEED && be->batchrows >= 0) {
+		/* one count for all tuples of the batch */
+		int res = mvc_export_affrows(be, be->out, be->batchrows, "", c->curprg->def->tag, c->qryctx.starttime, c->curprg->def->optimize);
+
+		c->qryctx.starttime = 0;
+		c->qryctx.endtime = 0;
+		if (res < 0)
+			msg = createException(SQL, "sql.affectedRows", SQLSTATE(45000) "Result set construction failed: %s", mvc_export_error(be, be->out, res));
+	}
 	if (m->type == Q_SCHEMA && m->qc != NULL)
 		qc_clean(m->qc);
 	be->q = NULL;
@@ -774,6 +774,20 @@ stmt_bat(backend *be, sql_column *c, int access, int partition)
 		if (c && isTable(c->t)) {
 			BUN rows = (BUN) store->storage_api.count_col(tr, c, RDONLY);
 			setRowCnt(mb,getArg(q,0),rows);
+			/* the ordering helps mitosis to choose the partition size */
+			if (store->storage_api.sorted_col(tr, c))
+				setVarSorted(mb,getArg(q,0));
+			if (c->t->idxs) {
+				for (node *n = ol_first_node(c->t->idxs); n; n = n->next) {
+					sql_idx *i = n->data;
+
+					if (i->type == ordered_idx && list_length(i->columns) == 1 &&
+						((sql_kc *) i->columns->h->data)->c == c) {
+						setVarOrderIdx(mb,getArg(q,0));
+						break;
+					}
+				}
+			}
 		}
 	}
 
@@ -2958,6 +2972,48 @@ stmt_for(backend *be, stmt *op1, stmt *min_val)
 	return NULL;
 }
 
+stmt *
+stmt_fsst(backend *be, stmt *op1, stmt *symbols)
+{
+	MalBlkPtr mb = be->mb;
+	InstrPtr q = NULL;
+
+	if (op1 == NULL || symbols == NULL || op1->nr < 0 || symbols->nr < 0)
+		return NULL;
+
+	q = newStmt(mb, fsstRef, decompressRef);
+	if (q == NULL)
+		goto bailout;
+	q = pushArgument(mb, q, op1->nr);
+	q = pushArgument(mb, q, symbols->nr);
+
+	bool enabled = ma_get_eb(be->mvc->sa)->enabled;
+	ma_get_eb(be->mvc->sa)->enabled = false;
+	stmt *s = stmt_create(be->mvc->sa, st_join);
+	ma_get_eb(be->mvc->sa)->enabled = enabled;
+	if (s == NULL) {
+		freeInstruction(be->mb, q);
+		return NULL;
+	}
+
+	s->op1 = op1;
+	s->op2 = symbols;
+	s->flag = cmp_project;
+	s->key = 0;
+	s->nrcols = op1->nrcols;
+	s->nr = getDestVar(q);
+	s->q = q;
+	s->tname = op1->tname;
+	s->cname = op1->cname;
+	pushInstruction(mb, q);
+	return s;
+
+  bailout:
+	if (ma_get_eb(be->mvc->sa)->enabled)
+		eb_error(ma_get_eb(be->mvc->sa), be->mvc->errstr[0] ? be->mvc->errstr : mb->errors ? mb->errors : *GDKerrbuf ? GDKerrbuf : "out of memory", 1000);
+	return NULL;
+}
+
 stmt *
 stmt_join2(backend *be, stmt *l, stmt *ra, stmt *rb, int cmp, int anti, int symmetric, int swapped)
 {
@@ -3438,8 +3494,9 @@ stmt_list(backend *be, list *l)
 	return s;
 }
 
+/* sql.resultSet, or with a sink sql.resultStream */
 static InstrPtr
-dump_header(mvc *sql, MalBlkPtr mb, list *l)
+dump_header(mvc *sql, MalBlkPtr mb, list *l, int sink)
 {
 	node *n;
 	// gather the meta information
@@ -3448,13 +3505,18 @@ dump_header(mvc *sql, MalBlkPtr mb, list *l)
 	InstrPtr list;
 	InstrPtr tblPtr, nmePtr, tpePtr, lenPtr, scalePtr;
 
-	args = list_length(l) + 1;
+	args = list_length(l) + 1 + (sink >= 0);
 
-	list = newInstructionArgs(mb,sqlRef, resultSetRef, args + 5);
+	list = newInstructionArgs(mb,sqlRef, sink >= 0 ? resultStreamRef : resultSetRef, args + 5);
 	if(!list) {
 		return NULL;
 	}
-	getArg(list,0) = newTmpVariable(mb,TYPE_int);
+	if (sink >= 0) {
+		getArg(list,0) = newTmpVariable(mb,newBatType(TYPE_bte));
+		list = pushArgument(mb, list, sink);
+	} else {
+		getArg(list,0) = newTmpVariable(mb,TYPE_int);
+	}
 	meta(tblPtr, tblId, TYPE_str, args);
 	meta(nmePtr, nmeId, TYPE_str, args);
 	meta(tpePtr, tpeId, TYPE_str, args);
@@ -3555,12 +3617,21 @@ stmt_output(backend *be, stmt *lst)
 		if (!ok)
 			return -1;
 	} else {
-		if ((q = dump_header(be->mvc, mb, l)) == NULL)
+		if ((q = dump_header(be->mvc, mb, l, -1)) == NULL)
 			return -1;
 	}
 	return 0;
 }
 
+/* returns the sink variable to append the rows to */
+int
+stmt_output_stream(backend *be, int sink, stmt *lst)
+{
+	InstrPtr q = dump_header(be->mvc, be->mb, lst->op4.lval, sink);
+
+	return q ? getDestVar(q) : -1;
+}
+
 int
 stmt_affected_rows(backend *be, int lastnr)
 {
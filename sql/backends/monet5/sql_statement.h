@@ -226,6 +226,7 @@ extern stmt *stmt_project_delta(backend *be, stmt *col, stmt *upd);
 extern stmt *stmt_left_project(backend *be, stmt *op1, stmt *op2, stmt *op3);
 extern stmt *stmt_dict(backend *be, stmt *op1, stmt *op2);
 extern stmt *stmt_for(backend *be, stmt *op1, stmt *minval);
+extern stmt *stmt_fsst(backend *be, stmt *op1, stmt *symbols);
 
 sql_export stmt *stmt_list(backend *be, list *l);
 extern void stmt_set_nrcols(stmt *s);
@@ -267,6 +268,7 @@ sql_export stmt *stmt_alias(backend *be, stmt *op1, int label, const char *tname
 extern stmt *stmt_as(backend *be, stmt *s, stmt *org);
 
 extern int stmt_output(backend *be, stmt *l);
+extern int stmt_output_stream(backend *be, int sink, stmt *l);
 extern int stmt_affected_rows(backend *be, int lastnr);
 
 /* flow control statements */
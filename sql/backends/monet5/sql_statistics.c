@@ -75,6 +75,330 @@ sql_set_max(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 	return sql_set_stats(cntxt, mb, stk, pci, 2);
 }
 
+#define HIST_SAMPLE_SIZE 30000	/* number of rows sampled to build a histogram */
+#define HIST_BUCKETS 100		/* maximum number of equi-depth buckets */
+#define HIST_MCVS 100			/* maximum number of most common values */
+
+typedef struct hist_run {
+	BUN pos;	/* first position of the value in the sorted sample */
+	BUN cnt;	/* number of occurrences of the value */
+} hist_run;
+
+static int
+hist_run_cnt_cmp(const void *a, const void *b)
+{
+	const hist_run *ra = a, *rb = b;
+	if (ra->cnt != rb->cnt)
+		return ra->cnt < rb->cnt ? 1 : -1;
+	return ra->pos < rb->pos ? -1 : ra->pos > rb->pos;
+}
+
+static int
+hist_run_pos_cmp(const void *a, const void *b)
+{
+	const hist_run *ra = a, *rb = b;
+	return ra->pos < rb->pos ? -1 : ra->pos > rb->pos;
+}
+
+static void *
+hist_value(int type, const void *v)
+{
+	size_t len = ATOMlen(type, v);
+	void *nv = GDKmalloc(len);
+
+	if (nv)
+		memcpy(nv, v, len);
+	return nv;
+}
+
+/* Build an equi-depth histogram and a most common values list for the
+ * values of b, on a sample of at most HIST_SAMPLE_SIZE rows. Values which
+ * occur clearly more often than average in the sample become the most
+ * common values, the remaining values are divided over the buckets. */
+static sql_histogram *
+sql_column_histogram(BAT *b, double unique_est)
+{
+	BAT *s = NULL, *v = NULL, *o = NULL;
+	hist_run *runs = NULL;
+	sql_histogram *h = NULL;
+	BUN cnt = BATcount(b), n, nnils = 0, nruns = 0, nmcv = 0, m = 0;
+	int tpe = b->ttype;
+
+	if (cnt == 0 || tpe == TYPE_void || tpe == TYPE_msk || !ATOMlinear(tpe))
+		return NULL;
+	if (cnt > HIST_SAMPLE_SIZE) {
+		if (!(s = BATsample(b, HIST_SAMPLE_SIZE)) || !(v = BATproject(s, b)))
+			goto bailout;
+		BBPreclaim(s);
+		s = NULL;
+	}
+	if (BATsort(&o, NULL, NULL, v ? v : b, NULL, NULL, false, false, false) != GDK_SUCCEED)
+		goto bailout;
+	BBPreclaim(v);
+	v = NULL;
+
+	BATiter oi = bat_iterator(o);
+	int (*cmp)(const void *, const void *) = ATOMcompare(tpe);
+	const void *nil = ATOMnilptr(tpe);
+	n = oi.count;
+	if (!(runs = GDKmalloc(n * sizeof(hist_run))) || !(h = ZNEW(sql_histogram))) {
+		bat_iterator_end(&oi);
+		goto bailout;
+	}
+	/* collect the runs of equal values in the sorted sample */
+	for (BUN i = 0; i < n; ) {
+		const void *val = BUNtail(&oi, i);
+		BUN j = i + 1;
+
+		while (j < n && cmp(val, BUNtail(&oi, j)) == 0)
+			j++;
+		if (cmp(val, nil) == 0)
+			nnils += j - i;
+		else
+			runs[nruns++] = (hist_run) {.pos = i, .cnt = j - i};
+		i = j;
+	}
+	h->type = tpe;
+	h->nullfrac = (dbl) nnils / (dbl) n;
+	h->ndistinct = unique_est > 0 ? unique_est : (dbl) nruns;
+
+	if (nruns > 0) {
+		dbl avg = (dbl) (n - nnils) / (dbl) nruns;
+
+		/* most frequent first, values occurring above average become common values */
+		qsort(runs, nruns, sizeof(hist_run), hist_run_cnt_cmp);
+		while (nmcv < nruns && nmcv < HIST_MCVS && runs[nmcv].cnt > 1 && (dbl) runs[nmcv].cnt >= 1.25 * avg)
+			nmcv++;
+		qsort(runs, nmcv, sizeof(hist_run), hist_run_pos_cmp);
+		qsort(runs + nmcv, nruns - nmcv, sizeof(hist_run), hist_run_pos_cmp);
+	}
+	if (nmcv > 0) {
+		if (!(h->mcv = ZNEW_ARRAY(void *, nmcv)) || !(h->mcvfreq = NEW_ARRAY(dbl, nmcv))) {
+			bat_iterator_end(&oi);
+			goto bailout;
+		}
+		h->nmcv = (int) nmcv;
+		for (BUN i = 0; i < nmcv; i++) {
+			if (!(h->mcv[i] = hist_value(tpe, BUNtail(&oi, runs[i].pos)))) {
+				bat_iterator_end(&oi);
+				goto bailout;
+			}
+			h->mcvfreq[i] = (dbl) runs[i].cnt / (dbl) n;
+			h->mcvfrac += h->mcvfreq[i];
+		}
+	}
+	for (BUN i = nmcv; i < nruns; i++)
+		m += runs[i].cnt;
+	if (m > 1) {
+		/* equi-depth, bound k is the value at rank k*(m-1)/nbuckets of the remaining values */
+		int nbuckets = (int) MIN(m - 1, HIST_BUCKETS);
+		BUN r = nmcv, seen = 0;
+
+		if (!(h->bounds = ZNEW_ARRAY(void *, nbuckets + 1))) {
+			bat_iterator_end(&oi);
+			goto bailout;
+		}
+		h->nbuckets = nbuckets;
+		for (int k = 0; k <= nbuckets; k++) {
+			BUN rank = (BUN) ((dbl) k * (dbl) (m - 1) / (dbl) nbuckets);
+
+			while (seen + runs[r].cnt <= rank)
+				seen += runs[r++].cnt;
+			if (!(h->bounds[k] = hist_value(tpe, BUNtail(&oi, runs[r].pos)))) {
+				bat_iterator_end(&oi);
+				goto bailout;
+			}
+		}
+	}
+	bat_iterator_end(&oi);
+	BBPreclaim(o);
+	GDKfree(runs);
+	return h;
+  bailout:
+	BBPreclaim(s);
+	BBPreclaim(v);
+	BBPreclaim(o);
+	GDKfree(runs);
+	sql_histogram_destroy(h);
+	return NULL;
+}
+
+/* Keep the histogram of a column in sys.column_histograms, in place of
+ * the one of an earlier analyze, so the optimizer still has it after a
+ * restart. A column without histogram keeps no rows. */
+static str
+sql_store_histogram(mvc *m, sql_column *c, sql_histogram *h)
+{
+	sql_trans *tr = m->session->tr;
+	sqlstore *store = tr->store;
+	sql_table *hists = find_sql_table(tr, find_sql_schema(tr, "sys"), "column_histograms");
+	const char *kind, *nil = str_nil;
+	dbl dnil = dbl_nil;
+	int res, nr = 0;
+
+	if (hists == NULL || isTempTable(c->t) || store_readonly(store))
+		return MAL_SUCCEED;
+	if ((res = sql_trans_drop_histogram(tr, c->base.id)) == LOG_OK && h) {
+		ssize_t (*tostr)(allocator *, str *, size_t *, const void *, bool) = BATatoms[h->type].atomToStr;
+		allocator *ta = MT_thread_getallocator();
+		allocator_state ta_state = ma_open(ta);
+
+		kind = "nulls";
+		res = store->table_api.table_insert(tr, hists, &c->base.id, &kind, &nr, &nil, &h->nullfrac);
+		kind = "distinct";
+		if (res == LOG_OK)
+			res = store->table_api.table_insert(tr, hists, &c->base.id, &kind, &nr, &nil, &h->ndistinct);
+		kind = "bound";
+		for (nr = 0; res == LOG_OK && h->nbuckets && nr <= h->nbuckets; nr++) {
+			char *buf = NULL;
+			size_t len = 0;
+
+			if (tostr(ta, &buf, &len, h->bounds[nr], false) < 0)
+				res = LOG_ERR;
+			else
+				res = store->table_api.table_insert(tr, hists, &c->base.id, &kind, &nr, &buf, &dnil);
+		}
+		kind = "common";
+		for (nr = 0; res == LOG_OK && nr < h->nmcv; nr++) {
+			char *buf = NULL;
+			size_t len = 0;
+
+			if (tostr(ta, &buf, &len, h->mcv[nr], false) < 0)
+				res = LOG_ERR;
+			else
+				res = store->table_api.table_insert(tr, hists, &c->base.id, &kind, &nr, &buf, &h->mcvfreq[nr]);
+		}
+		ma_close(&ta_state);
+	}
+	if (res != LOG_OK)
+		throw(SQL, "sql.analyze", SQLSTATE(42000) "Storing the histogram of column '%s' failed%s", c->base.name, res == LOG_CONFLICT ? " due to conflict with another transaction" : "");
+	return MAL_SUCCEED;
+}
+
+static void *
+hist_value_fromstr(int tpe, const char *s)
+{
+	allocator *ta = MT_thread_getallocator();
+	allocator_state ta_state = ma_open(ta);
+	void *p = NULL, *v = NULL;
+	size_t len = 0;
+
+	if (!strNil(s) && ATOMfromstr(ta, tpe, &p, &len, s, false) >= 0 && ATOMcmp(tpe, p, ATOMnilptr(tpe)) != 0)
+		v = hist_value(tpe, p);
+	ma_close(&ta_state);
+	return v;
+}
+
+/* Rebuild the histogram of a column from its rows first..last-1 of the
+ * ordered sys.column_histograms; NULL if they don't fit the column */
+static sql_histogram *
+hist_from_rows(sqlstore *store, res_table *rt, sql_table *hists, BUN first, BUN last, int tpe, int nbounds, int nmcv)
+{
+	sql_column *hkind = find_sql_column(hists, "kind");
+	sql_column *hnr = find_sql_column(hists, "nr");
+	sql_column *hvalue = find_sql_column(hists, "value");
+	sql_column *hest = find_sql_column(hists, "estimate");
+	sql_histogram *h;
+
+	if (nbounds == 1 || !(h = ZNEW(sql_histogram)))
+		return NULL;
+	h->type = tpe;
+	if (nbounds > 1) {
+		if (!(h->bounds = ZNEW_ARRAY(void *, nbounds)))
+			goto bailout;
+		h->nbuckets = nbounds - 1;
+	}
+	if (nmcv > 0) {
+		if (!(h->mcv = ZNEW_ARRAY(void *, nmcv)) || !(h->mcvfreq = NEW_ARRAY(dbl, nmcv)))
+			goto bailout;
+		h->nmcv = nmcv;
+	}
+	for (rt->cur_row = first; rt->cur_row < last; rt->cur_row++) {
+		const char *kind = store->table_api.table_fetch_value(rt, hkind);
+		int nr = *(const int *) store->table_api.table_fetch_value(rt, hnr);
+		const char *value = store->table_api.table_fetch_value(rt, hvalue);
+		dbl est = *(const dbl *) store->table_api.table_fetch_value(rt, hest);
+
+		if (strcmp(kind, "nulls") == 0) {
+			h->nullfrac = est;
+		} else if (strcmp(kind, "distinct") == 0) {
+			h->ndistinct = est;
+		} else if (strcmp(kind, "bound") == 0) {
+			if (nr < 0 || nr >= nbounds || h->bounds[nr] ||
+				!(h->bounds[nr] = hist_value_fromstr(tpe, value)))
+				goto bailout;
+		} else if (strcmp(kind, "common") == 0) {
+			if (nr < 0 || nr >= nmcv || h->mcv[nr] || is_dbl_nil(est) ||
+				!(h->mcv[nr] = hist_value_fromstr(tpe, value)))
+				goto bailout;
+			h->mcvfreq[nr] = est;
+			h->mcvfrac += est;
+		}
+	}
+	return h;
+  bailout:
+	sql_histogram_destroy(h);
+	return NULL;
+}
+
+static sql_column *
+hist_find_column(sql_trans *tr, sql_table *cols, sqlid id)
+{
+	sqlstore *store = tr->store;
+	oid rid = store->table_api.column_find_row(tr, find_sql_column(cols, "id"), &id, NULL);
+	sql_table *t;
+	node *n;
+
+	if (is_oid_nil(rid) ||
+		!(t = sql_trans_find_table(tr, store->table_api.column_find_sqlid(tr, find_sql_column(cols, "table_id"), rid))) ||
+		!(n = ol_find_id(t->columns, id)))
+		return NULL;
+	return n->data;
+}
+
+/* Give the columns back the histograms kept in sys.column_histograms,
+ * when the server starts */
+str
+sql_load_histograms(mvc *m)
+{
+	sql_trans *tr = m->session->tr;
+	sqlstore *store = tr->store;
+	sql_schema *sys = find_sql_schema(tr, "sys");
+	sql_table *hists = find_sql_table(tr, sys, "column_histograms");
+	sql_table *cols = find_sql_table(tr, sys, "_columns");
+	sql_column *hcol, *hkind;
+	res_table *rt;
+
+	if (hists == NULL)
+		return MAL_SUCCEED;		/* not upgraded yet */
+	hcol = find_sql_column(hists, "column_id");
+	hkind = find_sql_column(hists, "kind");
+	if ((rt = store->table_api.table_orderby(tr, hists, NULL, NULL, NULL, NULL, hcol, hkind, find_sql_column(hists, "nr"), NULL)) == NULL)
+		throw(SQL, "sql.load_histograms", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+	while (rt->cur_row < rt->nr_rows) {
+		sqlid id = *(const sqlid *) store->table_api.table_fetch_value(rt, hcol);
+		BUN first = rt->cur_row;
+		int nbounds = 0, nmcv = 0;
+
+		/* the rows of a column follow each other */
+		for (; rt->cur_row < rt->nr_rows && *(const sqlid *) store->table_api.table_fetch_value(rt, hcol) == id; rt->cur_row++) {
+			const char *kind = store->table_api.table_fetch_value(rt, hkind);
+			nbounds += strcmp(kind, "bound") == 0;
+			nmcv += strcmp(kind, "common") == 0;
+		}
+		BUN last = rt->cur_row;
+		sql_column *c = hist_find_column(tr, cols, id);
+		if (c && isTable(c->t) && ATOMlinear(c->type.type->localtype)) {
+			sql_histogram *h = hist_from_rows(store, rt, hists, first, last, c->type.type->localtype, nbounds, nmcv);
+			if (h)
+				store->storage_api.set_hist_col(tr, c, h);
+		}
+		rt->cur_row = last;
+	}
+	store->table_api.table_result_destroy(rt);
+	return MAL_SUCCEED;
+}
+
 str
 sql_analyze(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 {
@@ -214,6 +538,18 @@ sql_analyze(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 					GDKfree(mn);
 					mx = BATmax(b, NULL);
 					GDKfree(mx);
+
+					/* Build the value distribution, not on the dictionary of compressed columns */
+					if (access == RDONLY && !(c->storage_type && c->storage_type[0] == 'F')) {
+						sql_histogram *h = sql_column_histogram(b, unique_est);
+
+						if ((msg = sql_store_histogram(m, c, h)) != MAL_SUCCEED) {
+							sql_histogram_destroy(h);
+							BBPunfix(b->batCacheid);
+							return msg;
+						}
+						store->storage_api.set_hist_col(tr, c, h);
+					}
 					BBPunfix(b->batCacheid);
 
 					/* if (unique_est > 0) */
@@ -271,6 +607,103 @@ sql_analyze(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 	return MAL_SUCCEED;
 }
 
+#define GROUP_MAX_COLUMNS 8
+
+/* Estimate the number of distinct combinations of a group of columns of
+ * a table, and the functional dependencies between pairs of them, for
+ * the optimizer to correct its independence assumption. */
+str
+sql_analyze_group(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
+{
+	mvc *m = NULL;
+	sql_trans *tr = NULL;
+	str sch = NULL, tbl = NULL, msg = MAL_SUCCEED;
+	int ncols = pci->argc - 3;
+	sql_column *cols[GROUP_MAX_COLUMNS];
+	BAT *bats[GROUP_MAX_COLUMNS] = {0};
+	double ndv[GROUP_MAX_COLUMNS * GROUP_MAX_COLUMNS], group;
+	sql_colgroup *g = NULL;
+
+	if ((msg = getSQLContext(cntxt, mb, &m, NULL)) != NULL)
+		return msg;
+	if ((msg = checkSQLContext(cntxt)) != NULL)
+		return msg;
+
+	tr = m->session->tr;
+	sch = *getArgReference_str(stk, pci, 1);
+	tbl = *getArgReference_str(stk, pci, 2);
+	if (strNil(sch))
+		throw(SQL, "sql.analyze_group", SQLSTATE(42000) "Schema name cannot be NULL");
+	if (strNil(tbl))
+		throw(SQL, "sql.analyze_group", SQLSTATE(42000) "Table name cannot be NULL");
+	if (ncols < 2 || ncols > GROUP_MAX_COLUMNS)
+		throw(SQL, "sql.analyze_group", SQLSTATE(42000) "A column group must have between 2 and %d columns", GROUP_MAX_COLUMNS);
+
+	TRC_DEBUG(SQL_PARSER, "analyze group %s.%s\n", sch, tbl);
+
+	sql_schema *s = mvc_bind_schema(m, sch);
+	if (!s)
+		throw(SQL, "sql.analyze_group", SQLSTATE(3F000) "Schema '%s' does not exist", sch);
+	sql_table *t = mvc_bind_table(m, s, tbl);
+	if (!t)
+		throw(SQL, "sql.analyze_group", SQLSTATE(42S02) "Table '%s' does not exist", tbl);
+	if (!isTable(t))
+		throw(SQL, "sql.analyze_group", SQLSTATE(42S02) "%s '%s' is not persistent", TABLE_TYPE_DESCRIPTION(t->type, t->properties), t->base.name);
+	bool allowed = table_privs(m, t, PRIV_SELECT);
+	for (int i = 0; i < ncols; i++) {
+		str col = *getArgReference_str(stk, pci, i + 3);
+
+		if (strNil(col))
+			throw(SQL, "sql.analyze_group", SQLSTATE(42000) "Column name cannot be NULL");
+		if (!(cols[i] = mvc_bind_column(m, t, col)) || (!allowed && !column_privs(m, cols[i], PRIV_SELECT)))
+			throw(SQL, "sql.analyze_group", SQLSTATE(38000) "Column '%s' does not exist", col);
+		for (int j = 0; j < i; j++)
+			if (cols[j] == cols[i])
+				throw(SQL, "sql.analyze_group", SQLSTATE(42000) "Column '%s' appears more than once in the group", col);
+	}
+
+	/* the offsets of dictionary and frame of reference compressed
+	 * columns map one to one onto the values, so their distinct
+	 * combinations are the same */
+	sqlstore *store = tr->store;
+	for (int i = 0; i < ncols; i++) {
+		if (!(bats[i] = store->storage_api.bind_col(tr, cols[i], RDONLY))) {
+			msg = createException(SQL, "sql.analyze_group", SQLSTATE(HY005) "Cannot access column descriptor");
+			goto bailout;
+		}
+	}
+	if (bat_guess_uniques_multi(bats, ncols, ndv, &group) != GDK_SUCCEED) {
+		msg = createException(SQL, "sql.analyze_group", GDK_EXCEPTION);
+		goto bailout;
+	}
+
+	if (!(g = ZNEW(sql_colgroup)) ||
+		!(g->cols = NEW_ARRAY(sqlid, ncols)) ||
+		!(g->dependency = NEW_ARRAY(dbl, ncols * ncols))) {
+		sql_colgroup_destroy(g);
+		msg = createException(SQL, "sql.analyze_group", SQLSTATE(HY013) MAL_MALLOC_FAIL);
+		goto bailout;
+	}
+	g->ncols = ncols;
+	/* the estimate for the group cannot exceed the number of rows */
+	g->ndistinct = MIN(group, (dbl) BATcount(bats[0]));
+	for (int i = 0; i < ncols; i++) {
+		g->cols[i] = cols[i]->base.id;
+		for (int j = 0; j < ncols; j++) {
+			/* column i determines column j to the degree the pair
+			 * has no more combinations than i has values */
+			dbl d = i == j || ndv[i * ncols + j] <= 0 ? 1 : ndv[i * ncols + i] / ndv[i * ncols + j];
+			g->dependency[i * ncols + j] = d > 1 ? 1 : d;
+		}
+	}
+	store->storage_api.set_colgroup_tab(tr, t, g);
+
+  bailout:
+	for (int i = 0; i < ncols; i++)
+		BBPreclaim(bats[i]);
+	return msg;
+}
+
 str
 sql_statistics(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 {
@@ -405,7 +838,7 @@ sql_statistics(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 							continue;
 						int w;
 						lng cnt;
-						bit un, hnils, issorted, isrevsorted, dict;
+						bit un, hnils, issorted, isrevsorted, dict, fsst;
 						BAT *qd = NULL, *fb = NULL, *re = NULL;
 
 						if (cname && strcmp(c->base.name, cname))
@@ -441,10 +874,14 @@ sql_statistics(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci)
 							posi = bat_iterator_copy(&rei);
 							bat_iterator_end(&rei);
 						} else {
-							issorted = qdi.sorted;
-							isrevsorted = qdi.revsorted;
+							/* the order of fsst encoded values says nothing about the strings */
+							fsst = c->storage_type && strcmp(c->storage_type, "FSST") == 0;
+							issorted = qdi.sorted && !fsst;
+							isrevsorted = qdi.revsorted && !fsst;
 							hnils = !qdi.nonil || qdi.nil;
 							posi = bat_iterator_copy(&qdi);
+							if (fsst)
+								posi.minpos = posi.maxpos = BUN_NONE;
 						}
 
 						w = qdi.width;
@@ -18,6 +18,8 @@ extern str sql_set_count_distinct(Client cntxt, MalBlkPtr mb, MalStkPtr stk, Ins
 extern str sql_set_min(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci);
 extern str sql_set_max(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci);
 extern str sql_analyze(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci);
+extern str sql_analyze_group(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci);
 extern str sql_statistics(Client cntxt, MalBlkPtr mb, MalStkPtr stk, InstrPtr pci);
+extern str sql_load_histograms(mvc *m);
 
 #endif /* _SQL_STATISTICS_DEF */
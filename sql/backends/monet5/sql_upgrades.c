@@ -5661,6 +5661,86 @@ sql_update_default(Client c, mvc *sql, sql_schema *s)
 		printf("Running database upgrade commands:\n%s\n", query);
 		fflush(stdout);
 		err = SQLstatementIntern(c, query, "update", true, false, NULL);
+		if (err)
+			return err;
+	}
+
+	if (!sql_bind_func(sql, s->base.name, "resource_groups", NULL, NULL, F_UNION, true, true)) {
+		sql->session->status = 0; /* if the function was not found clean the error */
+		sql->errstr[0] = '\0';
+		static const char query[] =
+			"create table sys.db_resource_groups(\"name\" varchar(1024) not null, \"weight\" int not null, \"slots\" int not null, \"max_memory\" bigint not null);\n"
+			"create table sys.db_resource_group_members(\"name\" varchar(1024) not null, \"groupname\" varchar(1024) not null);\n"
+			"update sys._tables set system = true where system <> true and schema_id = 2000 and name in ('db_resource_groups', 'db_resource_group_members');\n"
+			"create procedure sys.create_resource_group(groupname string, weight int, slots int, max_memory bigint)\n"
+			"external name sql.create_resource_group;\n"
+			"create procedure sys.drop_resource_group(groupname string)\n"
+			"external name sql.drop_resource_group;\n"
+			"create procedure sys.assign_resource_group(member string, groupname string)\n"
+			"external name sql.assign_resource_group;\n"
+			"create function sys.resource_groups()\n"
+			"returns table(\"groupname\" string, \"weight\" int, \"slots\" int, \"max_memory\" bigint, \"running\" int, \"queued\" int, \"workers\" int, \"memory\" bigint, \"admitted\" bigint, \"waited\" bigint)\n"
+			"external name sysmon.resource_groups;\n"
+			"create function sys.resource_group_members()\n"
+			"returns table(\"member\" string, \"groupname\" string)\n"
+			"external name sysmon.resource_group_members;\n"
+			"update sys.functions set system = true where system <> true and schema_id = 2000 and name in ('create_resource_group', 'drop_resource_group', 'assign_resource_group', 'resource_groups', 'resource_group_members');\n";
+		printf("Running database upgrade commands:\n%s\n", query);
+		fflush(stdout);
+		err = SQLstatementIntern(c, query, "update", true, false, NULL);
+		if (err)
+			return err;
+	}
+
+	sql_subtype tp;
+	sql_find_subtype(&tp, "varchar", 0, 0);
+	if (!sql_bind_func3(sql, s->base.name, "createtrigramindex", &tp, &tp, &tp, F_PROC, true)) {
+		sql->session->status = 0; /* if the function was not found clean the error */
+		sql->errstr[0] = '\0';
+		static const char query[] =
+			"create procedure sys.createtrigramindex(sys string, tab string, col string)\n"
+			"external name sql.createtrigramindex;\n"
+			"create procedure sys.droptrigramindex(sys string, tab string, col string)\n"
+			"external name sql.droptrigramindex;\n"
+			"update sys.functions set system = true where system <> true and schema_id = 2000 and name in ('createtrigramindex', 'droptrigramindex');\n";
+		printf("Running database upgrade commands:\n%s\n", query);
+		fflush(stdout);
+		err = SQLstatementIntern(c, query, "update", true, false, NULL);
+		if (err)
+			return err;
+	}
+
+	if (!sql_bind_func3(sql, s->base.name, "createfulltextindex", &tp, &tp, &tp, F_PROC, true)) {
+		sql->session->status = 0; /* if the function was not found clean the error */
+		sql->errstr[0] = '\0';
+		static const char query[] =
+			"create procedure sys.createfulltextindex(sys string, tab string, col string)\n"
+			"external name sql.createfulltextindex;\n"
+			"create procedure sys.dropfulltextindex(sys string, tab string, col string)\n"
+			"external name sql.dropfulltextindex;\n"
+			"create filter function sys.fulltext_match(x string, q string)\n"
+			"external name txtsim.fulltextmatch;\n"
+			"grant execute on filter function fulltext_match(string, string) to public;\n"
+			"create function sys.fulltext_score(x string, q string)\n"
+			"returns double external name txtsim.fulltextscore;\n"
+			"grant execute on function fulltext_score(string, string) to public;\n"
+			"update sys.functions set system = true where system <> true and schema_id = 2000 and name in ('createfulltextindex', 'dropfulltextindex', 'fulltext_match', 'fulltext_score');\n";
+		printf("Running database upgrade commands:\n%s\n", query);
+		fflush(stdout);
+		err = SQLstatementIntern(c, query, "update", true, false, NULL);
+		if (err)
+			return err;
+	}
+
+	if (mvc_bind_table(sql, s, "column_histograms") == NULL) {
+		sql->session->status = 0; /* if the table was not found clean the error */
+		sql->errstr[0] = '\0';
+		static const char query[] =
+			"create table sys.column_histograms(\"column_id\" integer not null, \"kind\" varchar(8) not null, \"nr\" integer not null, \"value\" string, \"estimate\" double);\n"
+			"update sys._tables set system = true where system <> true and schema_id = 2000 and name = 'column_histograms';\n";
+		printf("Running database upgrade commands:\n%s\n", query);
+		fflush(stdout);
+		err = SQLstatementIntern(c, query, "update", true, false, NULL);
 	}
 
 	return err;
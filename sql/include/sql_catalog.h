@@ -640,6 +640,28 @@ typedef struct sql_sequence {
 	MT_Lock lock;		/* lock protecting concurrent writes to the changes list */
 } sql_sequence;
 
+/* value distribution of a column as collected by ANALYZE on a sample */
+typedef struct sql_histogram {
+	int type;		/* type of the values */
+	int nbuckets;		/* number of equi-depth buckets, ie nbuckets+1 bounds */
+	int nmcv;		/* number of most common values */
+	dbl nullfrac;		/* fraction of nil values */
+	dbl mcvfrac;		/* combined fraction of the most common values */
+	dbl ndistinct;		/* estimated number of distinct values */
+	void **bounds;		/* bucket boundaries, ascending, excluding the mcvs */
+	void **mcv;		/* most common values, ascending */
+	dbl *mcvfreq;		/* fraction of the rows holding each mcv */
+} sql_histogram;
+
+/* distinct counts of a group of columns as collected by ANALYZE ... GROUP */
+typedef struct sql_colgroup {
+	int ncols;		/* number of columns in the group */
+	sqlid *cols;		/* ids of the columns */
+	dbl ndistinct;		/* estimated number of distinct combinations */
+	dbl *dependency;	/* ncols x ncols, degree to which column i determines column j */
+	struct sql_colgroup *next;
+} sql_colgroup;
+
 typedef struct sql_column {
 	sql_base base;
 	sql_subtype type;
@@ -652,6 +674,7 @@ typedef struct sql_column {
 	size_t dcount;
 	void *min;
 	void *max;
+	sql_histogram *hist;	/* value distribution, set by analyze */
 
 	struct sql_table *t;
 	MT_Lock lock;		/* lock protecting concurrent writes to the changes list */
@@ -741,6 +764,7 @@ typedef struct sql_table {
 	objlist *triggers;
 	list *members;		/* member tables of merge/replica tables */
 	int drop_action;	/* only needed for alter drop table */
+	sql_colgroup *colgroups; /* column group statistics, set by analyze */
 
 	MT_Lock lock;		/* lock protecting concurrent writes to the changes list */
 	ATOMIC_PTR_TYPE data;
@@ -27,6 +27,8 @@ typedef enum prop_kind {
 	PROP_GROUPINGS, /* used by ROLLUP/CUBE/GROUPING SETS, value contains the list of sets */
 	PROP_UNNESTING,	/* used by unnesting rewriter */
 	PROP_SELECTIVITY,	/* selectivity estimate for predicates (dbl, 0.0-1.0) */
+	PROP_HISTOGRAM,	/* value distribution of a column (sql_histogram) */
+	PROP_COLGROUPS,	/* id = column id, p = list of sql_colgroup statistics including the column */
 	PROP_HASH,		/* an hash for the relational sub graph */
 } prop_kind;
 
@@ -0,0 +1,5 @@
+@echo off
+
+prompt # $t $g
+
+ODBCbulkfetch.exe
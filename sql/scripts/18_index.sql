@@ -14,4 +14,20 @@ create procedure sys.createorderindex(sys string, tab string, col string)
 create procedure sys.droporderindex(sys string, tab string, col string)
 	external name sql.droporderindex;
 
+-- Trigram index to speed up LIKE and ILIKE on string columns
+
+create procedure sys.createtrigramindex(sys string, tab string, col string)
+	external name sql.createtrigramindex;
+
+create procedure sys.droptrigramindex(sys string, tab string, col string)
+	external name sql.droptrigramindex;
+
+-- Full-text index for sys.fulltext_match and sys.fulltext_score
+
+create procedure sys.createfulltextindex(sys string, tab string, col string)
+	external name sql.createfulltextindex;
+
+create procedure sys.dropfulltextindex(sys string, tab string, col string)
+	external name sql.dropfulltextindex;
+
 
@@ -58,6 +58,47 @@ external name sysmon.resume;
 create procedure sys.stop(tag bigint, username string)
 external name sysmon.stop;
 
+-- sysadmin operations to divide the server between classes of users:
+-- queries of a resource group wait when all its slots are in use, and
+-- share the worker threads in proportion to the weight of the group;
+-- the definitions are kept in the two tables and restored on restart
+create table sys.db_resource_groups(
+	"name" varchar(1024) not null,
+	"weight" int not null,
+	"slots" int not null,
+	"max_memory" bigint not null
+);
+create table sys.db_resource_group_members(
+	"name" varchar(1024) not null,	-- user or role
+	"groupname" varchar(1024) not null
+);
+create procedure sys.create_resource_group(groupname string, weight int, slots int, max_memory bigint)
+external name sql.create_resource_group;
+create procedure sys.drop_resource_group(groupname string)
+external name sql.drop_resource_group;
+create procedure sys.assign_resource_group(member string, groupname string)
+external name sql.assign_resource_group;
+create function sys.resource_groups()
+returns table(
+	"groupname" string,
+	"weight" int,
+	"slots" int,		-- maximum number of concurrent queries, 0 is unlimited
+	"max_memory" bigint,	-- memory budget in bytes, 0 is unlimited
+	"running" int,
+	"queued" int,
+	"workers" int,		-- worker threads per running query
+	"memory" bigint,	-- memory claimed by the running queries
+	"admitted" bigint,
+	"waited" bigint		-- milliseconds spent waiting for admission
+)
+external name sysmon.resource_groups;
+create function sys.resource_group_members()
+returns table(
+	"member" string,	-- user or role
+	"groupname" string
+)
+external name sysmon.resource_group_members;
+
 -- we collect some aggregated user information
 create function sys.user_statistics()
 returns table(
@@ -78,3 +78,14 @@ grant execute on function difference(string, string) to public;
 create function sys.qgramnormalize(x string)
 returns string external name txtsim.qgramnormalize;
 grant execute on function qgramnormalize(string) to public;
+
+-- Full-text search: whether x contains all words of the query q,
+-- served by the full-text index of x if there is one
+create filter function sys.fulltext_match(x string, q string)
+external name txtsim.fulltextmatch;
+grant execute on filter function fulltext_match(string, string) to public;
+
+-- BM25 score of x for the words of the query q
+create function sys.fulltext_score(x string, q string)
+returns double external name txtsim.fulltextscore;
+grant execute on function fulltext_score(string, string) to public;
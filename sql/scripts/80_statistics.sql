@@ -26,6 +26,16 @@ create procedure sys."analyze"("sname" varchar(1024), "tname" varchar(1024), "cn
 external name sql."analyze";
 grant execute on procedure sys."analyze"(varchar(1024),varchar(1024),varchar(1024)) to public;
 
+-- the value distribution analyze collects on a column, kept for the
+-- optimizer across restarts
+create table sys.column_histograms(
+	"column_id" integer not null,
+	"kind" varchar(8) not null,	-- 'nulls', 'distinct', 'bound' or 'common'
+	"nr" integer not null,		-- position of the bound or common value
+	"value" string,			-- the bound or common value
+	"estimate" double		-- fraction of the rows, or number of distinct values
+);
+
 create function sys."statistics"()
 returns table (
 	"column_id" integer,
@@ -16,6 +16,7 @@
 #include "rel_rel.h"
 #include "rel_basetable.h"
 #include "rel_prop.h"
+#include "rel_statistics.h"
 
 sql_subtype*
 first_arg_subtype(sql_exp *e)
@@ -4356,7 +4357,9 @@ exp_estimate_selectivity(mvc *sql, sql_exp *e)
 		return 0.1;
 	case e_cmp: {
 		sql_exp *l = (sql_exp *) e->l, *r = (sql_exp *) e->r;
-		if (e->flag <= cmp_lte && e->f) {
+		if (exp_histogram_selectivity(e, &sel)) {
+			break;
+		} else if (e->flag <= cmp_lte && e->f) {
 			sel = 0.50;
 		} else {
 			switch (e->flag) {
@@ -116,6 +116,8 @@ propkind2string( prop *p)
 		PT(MAX);
 		PT(UNNESTING);
 		PT(SELECTIVITY);
+		PT(HISTOGRAM);
+		PT(COLGROUPS);
 		PT(HASH);
 	}
 	return "UNKNOWN";
@@ -616,7 +616,7 @@ has_return( list *l )
 }
 
 static list *
-psm_analyze(sql_query *query, dlist *qname, dlist *columns)
+psm_analyze(sql_query *query, dlist *qname, dlist *columns, bool group)
 {
 	mvc *sql = query->sql;
 	const char *sname = qname_schema(qname), *tname = qname_schema_object(qname);
@@ -652,6 +652,21 @@ psm_analyze(sql_query *query, dlist *qname, dlist *columns)
 		if (columns)
 			list_append(tl, exp_subtype(tname_exp));
 	}
+	if (group) {
+		/* call analyze_group(sname, tname, cname, ...) */
+		if (!sname || !tname)
+			return sql_error(sql, ERR_NOTFOUND, SQLSTATE(42000) "Analyze schema or table name missing");
+		for(dnode *n = columns->h->next; n; n = n->next)
+			list_append(tl, exp_subtype(list_fetch(exps, 1)));
+		if (!(f = sql_bind_func_(sql, "sys", "analyze_group", tl, F_PROC, true, false)))
+			return sql_error(sql, ERR_NOTFOUND, SQLSTATE(42000) "Analyze group procedure missing");
+		if (!execute_priv(sql, f->func))
+			return sql_error(sql, 02, SQLSTATE(42000) "No privilege to call analyze group procedure");
+		for(dnode *n = columns->h; n; n = n->next)
+			list_append(exps, exp_atom_str(sql->sa, n->data.sval, &tpe));
+		list_append(analyze_calls, exp_op(sql->sa, exps, f));
+		return analyze_calls;
+	}
 	if (!(f = sql_bind_func_(sql, "sys", "analyze", tl, F_PROC, true, false)))
 		return sql_error(sql, ERR_NOTFOUND, SQLSTATE(42000) "Analyze procedure missing");
 	if (!execute_priv(sql, f->func))
@@ -718,7 +733,7 @@ sequential_block(sql_query *query, sql_subtype *restype, list *restypelist, dlis
 		case SQL_ANALYZE: {
 			dlist *l = s->data.lval;
 
-			reslist = psm_analyze(query, l->h->data.lval /* qualified table name */, l->h->next->data.lval /* opt list of column */);
+			reslist = psm_analyze(query, l->h->data.lval /* qualified table name */, l->h->next->data.lval /* opt list of column */, l->h->next->next->data.i_val /* column group */);
 		} 	break;
 		case SQL_CALL:
 			assert(s->type == type_symbol);
@@ -1573,6 +1588,8 @@ rel_psm(sql_query *query, symbol *s)
 			if (ret)
 				ret = rel_psm_stmt(sql->sa, rel_psm_call(query, s->data.lval->h->next->data.sym));
 			ret = rel_list(sql->sa, query->last_rel, ret);
+		} else if ((sql->emod & mod_exec) && dlist_length(s->data.sym->data.lval) > 3) {
+			ret = rel_psm_block(sql->sa, rel_exec_batch(query, s->data.sym));
 		} else
 			ret = rel_psm_stmt(sql->sa, rel_psm_call(query, s->data.sym));
 		break;
@@ -1597,7 +1614,7 @@ rel_psm(sql_query *query, symbol *s)
 		dlist *l = s->data.lval;
 
 		/* Jan2022 update: The 'sample' and 'minmax' parameters are now ignored because they are no longer used in the backend */
-		list *calls = psm_analyze(query, l->h->data.lval /* qualified table name */, l->h->next->data.lval /* opt list of column */);
+		list *calls = psm_analyze(query, l->h->data.lval /* qualified table name */, l->h->next->data.lval /* opt list of column */, l->h->next->next->data.i_val /* column group */);
 		ret = rel_psm_block(sql->sa, calls);
 		sql->type = Q_UPDATE;
 	} 	break;
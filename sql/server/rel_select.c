@@ -3369,6 +3369,88 @@ reorder_args(mvc *sql, list *exps, list *names, list *params)
 	return nexps;
 }
 
+static list *
+exec_check_args(mvc *sql, list *ops, list *exps, list *nexps)
+{
+	for (node *n = exps->h, *m = ops->h; n && m; n = n->next, m = m->next) {
+		sql_arg *a = m->data;
+		sql_exp *e = n->data;
+		sql_subtype *ntp = &a->type;
+
+		if (ntp && ntp->type)
+			e = exp_check_type(sql, ntp, NULL, e, type_equal);
+		else
+			a->type = *exp_subtype(e);
+		if (!e)
+			return NULL;
+		append(nexps, e);
+	}
+	return nexps;
+}
+
+/* EXEC nr (..), (..), .. runs a prepared statement for a batch of parameter
+ * tuples. Statements with a bulk variant get a single call, with a column of
+ * values per parameter, the others a call per tuple. */
+list *
+rel_exec_batch(sql_query *query, symbol *se)
+{
+	mvc *sql = query->sql;
+	dnode *l = se->data.lval->h;
+	dnode *row = l->next->next;
+	exp_kind iek = {type_value, card_column, FALSE};
+	list *calls = sa_list(sql->sa), *cols = NULL;
+	cq *q = qc_find(sql->qc, l->data.i_val);
+
+	if (!q)
+		return sql_error(sql, 02, SQLSTATE(42000) "EXEC: PREPARED Statement missing '%d'", l->data.i_val);
+	if (q->bulk) {
+		cols = sa_list(sql->sa);
+		for (node *n = q->f->ops->h; n; n = n->next)
+			append(cols, sa_list(sql->sa));
+	}
+	for (int first = 1; row; first = 0) {
+		dnode *ops = row->data.lval ? row->data.lval->h : NULL;
+		list *exps = sa_list(sql->sa), *nexps = new_exp_list(sql->sa);
+
+		for (; ops; ops = ops->next) {
+			sql_rel *r = NULL;
+			sql_exp *e = rel_value_exp(query, &r, ops->data.sym, sql_sel | psm_call | sql_farg, iek);
+
+			if (!e)
+				return NULL;
+			if (r)
+				return sql_error(sql, 02, SQLSTATE(42000) "EXEC: parameter values cannot be queries");
+			append(exps, e);
+		}
+		if (list_length(q->f->ops) != list_length(exps))
+			return sql_error(sql, 02, SQLSTATE(42000) "EXEC called with wrong number of arguments: expected %d, got %d", list_length(q->f->ops), list_length(exps));
+		if (exps->h && !exec_check_args(sql, q->f->ops, exps, nexps))
+			return NULL;
+		if (cols) {
+			for (node *n = nexps->h, *m = cols->h; n && m; n = n->next, m = m->next)
+				append(m->data, n->data);
+		} else {
+			append(calls, exp_op(sql->sa, list_empty(nexps) ? NULL : nexps, sql_dup_subfunc(sql->sa, q->f, NULL, NULL)));
+		}
+		/* the first tuple is followed by the list of the others */
+		row = first ? (row->next ? row->next->data.lval->h : NULL) : row->next;
+	}
+	if (cols) {
+		list *args = new_exp_list(sql->sa);
+
+		for (node *n = cols->h, *m = q->f->ops->h; n && m; n = n->next, m = m->next) {
+			sql_arg *a = m->data;
+			sql_exp *v = exp_values(sql->sa, n->data);
+
+			v->tpe = a->type;
+			append(args, v);
+		}
+		append(calls, exp_op(sql->sa, args, sql_dup_subfunc(sql->sa, q->bulk, NULL, NULL)));
+	}
+	sql->type = q->type;
+	return calls;
+}
+
 static sql_exp *
 rel_nop(sql_query *query, sql_rel **rel, symbol *se, int fs, exp_kind ek)
 {
@@ -3433,21 +3515,8 @@ rel_nop(sql_query *query, sql_rel **rel, symbol *se, int fs, exp_kind ek)
 				if (!exps)
 					return sql_error(sql, 02, SQLSTATE(42000) "EXEC called with wrong arguments");
 			}
-			if (exps->h && ops) {
-				for (node *n = exps->h, *m = ops->h; n && m; n = n->next, m = m->next) {
-					sql_arg *a = m->data;
-					sql_exp *e = n->data;
-					sql_subtype *ntp = &a->type;
-
-					if (ntp && ntp->type)
-						e = exp_check_type(sql, ntp, NULL, e, type_equal);
-					else
-						a->type = *exp_subtype(e);
-					if (!e)
-						return NULL;
-					append(nexps, e);
-				}
-			}
+			if (exps->h && ops && !exec_check_args(sql, ops, exps, nexps))
+				return NULL;
 			assert(f->type == F_PROC);
 
 			if (q)
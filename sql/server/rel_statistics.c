@@ -200,6 +200,11 @@ rel_propagate_column_ref_statistics(mvc *sql, sql_rel *rel, sql_exp *e)
 						set_minmax_property(sql, e, PROP_MAX, fval);
 					if ((fval = find_prop_and_get(found->p, PROP_MIN)))
 						set_minmax_property(sql, e, PROP_MIN, fval);
+					if ((is_base(rel->op) || is_simple_project(rel->op)) && !find_prop(e->p, PROP_HISTOGRAM) &&
+						(est = find_prop(found->p, PROP_HISTOGRAM))) {
+						prop *p = e->p = prop_create(sql->sa, PROP_HISTOGRAM, e->p);
+						p->value.pval = est->value.pval;
+					}
 					if (!has_nil(found))
 						set_has_no_nil(e);
 					if (is_unique(found) || (need_distinct(rel) && list_length(rel->exps) == 1) ||
@@ -215,6 +220,12 @@ rel_propagate_column_ref_statistics(mvc *sql, sql_rel *rel, sql_exp *e)
 						prop *p = e->p = prop_create(sql->sa, PROP_NUNIQUES, e->p);
 						p->value.dval = est->value.dval;
 					}
+					if ((is_base(rel->op) || is_simple_project(rel->op) || (is_groupby(rel->op) && exps_find_exp(rel->r, e))) &&
+						(est = find_prop(found->p, PROP_COLGROUPS)) && !find_prop(e->p, PROP_COLGROUPS)) {
+						prop *p = e->p = prop_create(sql->sa, PROP_COLGROUPS, e->p);
+						p->id = est->id;
+						p->value.pval = est->value.pval;
+					}
 				}
 				return e;
 			}
@@ -257,6 +268,17 @@ sql_column_get_statistics(mvc *sql, sql_column *c, sql_exp *e)
 		prop *p = e->p = prop_create(sql->sa, PROP_NUNIQUES, e->p);
 		p->value.dval = unique_est;
 	}
+	sql_histogram *h = mvc_col_hist(sql, c);
+	if (h) {
+		prop *p = e->p = prop_create(sql->sa, PROP_HISTOGRAM, e->p);
+		p->value.pval = h;
+	}
+	list *groups = mvc_col_groups(sql, c);
+	if (!list_empty(groups)) {
+		prop *p = e->p = prop_create(sql->sa, PROP_COLGROUPS, e->p);
+		p->id = c->base.id;
+		p->value.pval = groups;
+	}
 	unsigned int digits = 0;
 	sql_subtype *et = exp_subtype(e);
 	if (et->type->eclass == EC_DEC || et->type->eclass == EC_NUM)
@@ -295,6 +317,184 @@ sql_column_get_statistics(mvc *sql, sql_column *c, sql_exp *e)
 		et->digits = et->scale + 1;
 }
 
+static bool
+hist_value2dbl(int type, const void *v, dbl *d)
+{
+	switch (ATOMbasetype(type)) {
+	case TYPE_bte:
+		*d = (dbl) *(const bte *) v;
+		return true;
+	case TYPE_sht:
+		*d = (dbl) *(const sht *) v;
+		return true;
+	case TYPE_int:
+		*d = (dbl) *(const int *) v;
+		return true;
+	case TYPE_lng:
+		*d = (dbl) *(const lng *) v;
+		return true;
+#ifdef HAVE_HGE
+	case TYPE_hge:
+		*d = (dbl) *(const hge *) v;
+		return true;
+#endif
+	case TYPE_flt:
+		*d = (dbl) *(const flt *) v;
+		return true;
+	case TYPE_dbl:
+		*d = *(const dbl *) v;
+		return true;
+	default:
+		return false;
+	}
+}
+
+/* fraction of the rows with a value below v, or up to v if inclusive */
+static dbl
+hist_fraction_below(sql_histogram *h, const void *v, bool inclusive)
+{
+	int (*cmp)(const void *, const void *) = ATOMcompare(h->type);
+	dbl frac = 0.0, rest = 1.0 - h->nullfrac - h->mcvfrac;
+
+	for (int i = 0; i < h->nmcv; i++) {
+		int c = cmp(h->mcv[i], v);
+		if (c < 0 || (inclusive && c == 0))
+			frac += h->mcvfreq[i];
+	}
+	if (h->nbuckets == 0 || rest <= 0)
+		return frac;
+	if (cmp(v, h->bounds[0]) < 0)
+		return frac;
+	if (cmp(v, h->bounds[h->nbuckets]) >= 0)
+		return frac + rest;
+	/* find the bucket with bounds[lo] <= v < bounds[lo + 1] */
+	int lo = 0, hi = h->nbuckets;
+	while (hi - lo > 1) {
+		int mid = (lo + hi) / 2;
+		if (cmp(h->bounds[mid], v) <= 0)
+			lo = mid;
+		else
+			hi = mid;
+	}
+	/* within the bucket interpolate linearly on numbers, else take the middle */
+	dbl pos = 0.5, vl, vh, vv;
+	if (hist_value2dbl(h->type, h->bounds[lo], &vl) && hist_value2dbl(h->type, h->bounds[lo + 1], &vh) &&
+		hist_value2dbl(h->type, v, &vv) && vh > vl)
+		pos = (vv - vl) / (vh - vl);
+	return frac + rest * ((dbl) lo + pos) / (dbl) h->nbuckets;
+}
+
+static dbl
+hist_fraction_equal(sql_histogram *h, const void *v, dbl nuniques)
+{
+	int (*cmp)(const void *, const void *) = ATOMcompare(h->type);
+	dbl rest = 1.0 - h->nullfrac - h->mcvfrac;
+
+	for (int i = 0; i < h->nmcv; i++) {
+		if (cmp(h->mcv[i], v) == 0)
+			return h->mcvfreq[i];
+	}
+	/* not a common value, spread the remainder evenly over the other distinct values */
+	dbl nd = (nuniques > 0 ? nuniques : h->ndistinct) - h->nmcv;
+	if (nd < 1)
+		nd = 1;
+	if (rest <= 0) /* all sampled values were common ones */
+		return h->nmcv ? h->mcvfreq[h->nmcv - 1] / 2 : 0.0;
+	return rest / nd;
+}
+
+static const void *
+hist_atom_value(sql_histogram *h, sql_exp *e)
+{
+	atom *a;
+
+	if (e->type != e_atom || !(a = e->l) || a->isnull || a->data.vtype != h->type)
+		return NULL;
+	return VALptr(&a->data);
+}
+
+/* Estimate the selectivity of a comparison between a column and constants
+ * using the equi-depth histogram and the most common values collected by
+ * analyze. Returns false if no estimate could be made. */
+bool
+exp_histogram_selectivity(sql_exp *e, dbl *sel)
+{
+	sql_exp *l = e->l, *r = e->r, *f = e->f, *c = NULL, *a = NULL;
+	sql_histogram *h = NULL;
+	prop *p = NULL;
+	const void *v, *w;
+	dbl s = 0.0, nuniques = 0.0;
+	int flag = e->flag;
+
+	if (e->type != e_cmp || is_semantics(e))
+		return false;
+	if (flag == cmp_in || flag == cmp_notin) {
+		c = l;
+	} else if (flag <= cmp_notequal) {
+		if (l->type == e_column && r->type == e_atom) {
+			c = l;
+			a = r;
+		} else if (r->type == e_column && l->type == e_atom && !f) {
+			c = r;
+			a = l;
+			/* swap the comparison, ie 10 < col becomes col > 10 */
+			flag = swap_compare((comp_type) flag);
+		}
+	}
+	if (!c || c->type != e_column || !(p = find_prop(c->p, PROP_HISTOGRAM)) || !(h = p->value.pval))
+		return false;
+	if ((p = find_prop(c->p, PROP_NUNIQUES)))
+		nuniques = p->value.dval;
+
+	if (flag == cmp_in || flag == cmp_notin) {
+		list *vals = e->r;
+		for (node *n = vals->h; n; n = n->next) {
+			if (!(v = hist_atom_value(h, n->data)))
+				return false;
+			s += hist_fraction_equal(h, v, nuniques);
+		}
+		if (flag == cmp_notin)
+			s = 1.0 - h->nullfrac - s;
+	} else if (!(v = hist_atom_value(h, a))) {
+		return false;
+	} else if (f) { /* range, the flag holds whether the bounds are inclusive */
+		if (!(w = hist_atom_value(h, f)) || is_symmetric(e))
+			return false;
+		s = hist_fraction_below(h, w, (flag & 2) != 0) - hist_fraction_below(h, v, (flag & 1) == 0);
+	} else {
+		switch (flag) {
+		case cmp_equal:
+			s = hist_fraction_equal(h, v, nuniques);
+			break;
+		case cmp_notequal:
+			s = 1.0 - h->nullfrac - hist_fraction_equal(h, v, nuniques);
+			break;
+		case cmp_lt:
+			s = hist_fraction_below(h, v, false);
+			break;
+		case cmp_lte:
+			s = hist_fraction_below(h, v, true);
+			break;
+		case cmp_gt:
+			s = 1.0 - h->nullfrac - hist_fraction_below(h, v, true);
+			break;
+		case cmp_gte:
+			s = 1.0 - h->nullfrac - hist_fraction_below(h, v, false);
+			break;
+		default:
+			return false;
+		}
+	}
+	if (is_anti(e))
+		s = 1.0 - h->nullfrac - s;
+	if (s < 0.0)
+		s = 0.0;
+	if (s > 1.0)
+		s = 1.0;
+	*sel = s;
+	return true;
+}
+
 static void
 rel_basetable_column_get_statistics(mvc *sql, sql_rel *rel, sql_exp *e)
 {
@@ -719,6 +919,144 @@ trivial_project_exp_card(sql_exp *e)
 	return e->type == e_atom && e->f ? (BUN) list_length(e->f) : 1;
 }
 
+/* the group statistics of the column of an equality comparison with a constant */
+static prop *
+exp_equality_colgroups(sql_exp *e)
+{
+	sql_exp *l = e->l, *r = e->r, *c = NULL;
+
+	if (e->type != e_cmp || e->flag != cmp_equal || is_anti(e) || is_semantics(e) || e->f)
+		return NULL;
+	if (l->type == e_column && r->type == e_atom)
+		c = l;
+	else if (r->type == e_column && l->type == e_atom)
+		c = r;
+	return c ? find_prop(c->p, PROP_COLGROUPS) : NULL;
+}
+
+/* the highest degree to which column 'a' determines column 'b' over the groups including both */
+static dbl
+colgroups_dependency(prop *a, prop *b)
+{
+	dbl d = 0.0;
+
+	for (node *n = ((list *) a->value.pval)->h; n; n = n->next) {
+		sql_colgroup *g = n->data;
+		int ia = -1, ib = -1;
+
+		for (int i = 0; i < g->ncols; i++) {
+			if (g->cols[i] == a->id)
+				ia = i;
+			if (g->cols[i] == b->id)
+				ib = i;
+		}
+		if (ia >= 0 && ib >= 0)
+			d = MAX(d, g->dependency[ia * g->ncols + ib]);
+	}
+	return d;
+}
+
+/* Equality predicates on columns analyzed as a group are not independent.
+ * When column a determines column b to degree d, the predicate on b only
+ * filters the rows not determined by a: sel(a and b) = sel(a) * (d + (1 - d) * sel(b)).
+ * The predicates are visited from the most selective one on, and each one
+ * is corrected for the strongest dependency on a predicate visited before.
+ * Returns the corrected selectivity of the conjunction 'sel'. */
+static dbl
+exps_dependent_selectivity(mvc *sql, list *exps, dbl sel)
+{
+	int n = list_length(exps), i = 0, ndep = 0;
+	prop **cg;
+	dbl *s;
+	bool *done;
+
+	if (n < 2 || !(cg = SA_ZNEW_ARRAY(sql->sa, prop *, n)) || !(s = SA_NEW_ARRAY(sql->sa, dbl, n)) ||
+		!(done = SA_ZNEW_ARRAY(sql->sa, bool, n)))
+		return sel;
+	for (node *m = exps->h; m; m = m->next, i++) {
+		sql_exp *e = m->data;
+		prop *p = find_prop(e->p, PROP_SELECTIVITY);
+
+		s[i] = p ? p->value.dval : 1.0;
+		if ((cg[i] = exp_equality_colgroups(e)))
+			ndep++;
+	}
+	if (ndep < 2)
+		return sel;
+	sel = 1.0;
+	for (int k = 0; k < n; k++) {
+		int next = -1;
+		dbl d = 0.0;
+
+		for (i = 0; i < n; i++)
+			if (!done[i] && (next < 0 || s[i] < s[next]))
+				next = i;
+		for (i = 0; cg[next] && i < n; i++)
+			if (done[i] && cg[i] && cg[i]->id != cg[next]->id)
+				d = MAX(d, colgroups_dependency(cg[i], cg[next]));
+		sel *= d + (1 - d) * s[next];
+		done[next] = true;
+	}
+	return sel;
+}
+
+/* find an expression, not yet covered, on the given column with group statistics */
+static int
+exps_find_colgroup_column(list *exps, bool *covered, sqlid id)
+{
+	int i = 0;
+
+	for (node *n = exps->h; n; n = n->next, i++) {
+		sql_exp *e = n->data;
+		prop *p = find_prop(e->p, PROP_COLGROUPS);
+
+		if (!covered[i] && p && p->id == id)
+			return i;
+	}
+	return -1;
+}
+
+/* Greedily pick the largest analyzed column groups fully covered by the
+ * expressions, mark those expressions as covered and return the product
+ * of the distinct counts of the groups used. */
+static BUN
+exps_colgroups_nuniques(list *exps, bool *covered)
+{
+	BUN nuniques = 1;
+
+	for (;;) {
+		sql_colgroup *best = NULL;
+		int i = 0;
+
+		for (node *n = exps->h; n; n = n->next, i++) {
+			sql_exp *e = n->data;
+			prop *p = find_prop(e->p, PROP_COLGROUPS);
+
+			if (covered[i] || !p)
+				continue;
+			for (node *m = ((list *) p->value.pval)->h; m; m = m->next) {
+				sql_colgroup *g = m->data;
+				int j = 0;
+
+				if (best && g->ncols <= best->ncols)
+					continue;
+				for (j = 0; j < g->ncols && exps_find_colgroup_column(exps, covered, g->cols[j]) >= 0; j++)
+					;
+				if (j == g->ncols)
+					best = g;
+			}
+		}
+		if (!best)
+			return nuniques;
+		for (int j = 0; j < best->ncols; j++)
+			covered[exps_find_colgroup_column(exps, covered, best->cols[j])] = true;
+		BUN guniques = (BUN) MAX(best->ndistinct, 1);
+		if (nuniques >= BUN_MAX/guniques)
+			return BUN_NONE;
+		nuniques *= guniques;
+	}
+}
+
 static BUN
 rel_calc_nuniques(mvc *sql, sql_rel *l, list *exps)
 {
@@ -728,8 +1066,14 @@ rel_calc_nuniques(mvc *sql, sql_rel *l, list *exps)
 		return 0;
 	if (!list_empty(exps)) {
 		BUN nuniques = 1;
+		bool *covered = NULL;
+		int i = 0;
+
+		/* columns analyzed as a group count for their combined number of distinct values */
+		if (list_length(exps) > 1 && (covered = SA_ZNEW_ARRAY(sql->sa, bool, list_length(exps))))
+			nuniques = exps_colgroups_nuniques(exps, covered);
 		/* compute the highest number of unique values */
-		for (node *n = exps->h ; n && nuniques != BUN_NONE ; n = n->next) {
+		for (node *n = exps->h ; n && nuniques != BUN_NONE ; n = n->next, i++) {
 			sql_exp *e = n->data;
 			sql_rel *bt = NULL;
 			prop *p = NULL;
@@ -738,6 +1082,8 @@ rel_calc_nuniques(mvc *sql, sql_rel *l, list *exps)
 			sql_subtype *tp = exp_subtype(e);
 			sql_class ec = tp ? tp->type->eclass : EC_STRING; /* if 'e' has no type (eg parameter), use a non-number type to fail condition */
 
+			if (covered && covered[i])
+				continue;
 			if ((p = find_prop(e->p, PROP_NUNIQUES))) {
 				euniques = (BUN) p->value.dval;
 			} else if (e->type == e_column && e->nid && rel_find_exp_and_corresponding_rel(l, e, false, &bt, NULL) && bt && (p = find_prop(bt->p, PROP_COUNT))) {
@@ -1122,6 +1468,7 @@ rel_get_statistics_(visitor *v, sql_rel *rel)
 						e->p = sp;
 						sel *= s;
 					}
+					sel = exps_dependent_selectivity(v->sql, rel->exps, sel);
 					BUN est = cnt == 0 ? 0 : (BUN)((dbl)cnt * sel);
 					if (est > cnt)
 						est = cnt;
@@ -832,6 +832,7 @@ mvc_create(sql_store *store, allocator *pa, int clientid, int debug, bstream *rs
 	m->schema_path_has_sys = true;
 	m->schema_path_has_tmp = false;
 	m->no_int128 = false;
+	m->resgroups_changed = false;
 	m->store = store;
 
 	m->session = sql_session_create(m->store, m->pa, 1 /*autocommit on*/);
@@ -1589,6 +1590,20 @@ mvc_col_stats(mvc *m, sql_column *col, bool *nonil, bool *unique, double *unique
 	return sql_trans_col_stats(m->session->tr, col, nonil, unique, unique_est, min, max);
 }
 
+sql_histogram *
+mvc_col_hist(mvc *m, sql_column *col)
+{
+	TRC_DEBUG(SQL_TRANS, "Retrieving column histogram for: %s\n", col->base.name);
+	return sql_trans_col_hist(m->session->tr, col, m->sa);
+}
+
+list *
+mvc_col_groups(mvc *m, sql_column *col)
+{
+	TRC_DEBUG(SQL_TRANS, "Retrieving column group statistics for: %s\n", col->base.name);
+	return sql_trans_col_groups(m->session->tr, col, m->sa);
+}
+
 int
 mvc_copy_column(mvc *m, sql_table *t, sql_column *c, sql_column **cres)
 {
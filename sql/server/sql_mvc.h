@@ -152,7 +152,8 @@ typedef struct mvc {
 	bool use_views:1,
 		schema_path_has_sys:1,  /* speed up object search */
 		schema_path_has_tmp:1,
-		no_int128:1;
+		no_int128:1,
+		resgroups_changed:1;	/* sync the resource groups after the transaction */
 	struct qc *qc;
 	int clientid;		        /* id of the owner */
 
@@ -261,6 +262,8 @@ extern int mvc_is_sorted_idx(mvc *c, sql_idx *idx);
 extern int mvc_is_unique(mvc *m, sql_column *col);
 extern int mvc_is_duplicate_eliminated(mvc *c, sql_column *col);
 extern int mvc_col_stats(mvc *m, sql_column *col, bool *nonil, bool *unique, double *unique_est, ValPtr min, ValPtr max);
+extern sql_histogram *mvc_col_hist(mvc *m, sql_column *col);
+extern list *mvc_col_groups(mvc *m, sql_column *col);
 
 extern int mvc_create_ukey(sql_key **kres, mvc *m, sql_table *t, const char *name, key_type kt, const char* check);
 extern int mvc_create_fkey(sql_fkey **kres, mvc *m, sql_table *t, const char *name, key_type kt, sql_key *rkey, int on_delete, int on_update);
@@ -431,6 +431,7 @@ int yydebug=1;
 	column_ref
 	column_ref_commalist
 	end_field
+	exec_arg_rows
 	external_function_name
 	filter_arg_list
 	filter_args
@@ -1041,6 +1042,15 @@ analyze_statement:
 			dlist *l = L();
 			append_list(l, $2);
 			append_list(l, $3);
+			append_int(l, FALSE);
+			$$ = _symbol_create_list(SQL_ANALYZE, l);
+		}
+	|	ANALYZE qname sqlGROUP column_commalist_parens
+		{
+			dlist *l = L();
+			append_list(l, $2);
+			append_list(l, $4);
+			append_int(l, TRUE);
 			$$ = _symbol_create_list(SQL_ANALYZE, l);
 		}
 	;
@@ -7054,6 +7064,17 @@ dealloc:
 
 exec_ref:
 		posint arg_list_ref { $$ = $2; $$->data.lval->h->data.i_val = $1; }
+	|	posint arg_list_ref ',' exec_arg_rows
+		{
+			$$ = $2;
+			$$->data.lval->h->data.i_val = $1;
+			append_list($$->data.lval, $4);
+		}
+	;
+
+exec_arg_rows:
+		'(' expr_list ')'	{ $$ = append_list(L(), $2); }
+	|	exec_arg_rows ',' '(' expr_list ')'	{ $$ = append_list($1, $4); }
 	;
 
 arg_list_ref:
@@ -34,6 +34,8 @@ cq_delete(int clientid, cq *q)
 {
 	if (q->name && q->f && q->f->instantiated)
 		backend_freecode(NULL, clientid, q->name);
+	if (q->bulk && q->bulk->instantiated)
+		backend_freecode(NULL, clientid, q->bulk->imp);
 	/* q, params and name are allocated using sa, ie need to be delete last */
 	if (q->sa)
 		ma_destroy(q->sa);
@@ -45,6 +47,11 @@ cq_restart(int clientid, cq *q)
 	if (q->f && q->f->imp && q->f->instantiated)
 		backend_freecode(NULL, clientid, q->f->imp);
 	q->f->instantiated = false;
+	/* the batch variant is compiled again by the next batch */
+	if (q->bulk && q->bulk->instantiated)
+		backend_freecode(NULL, clientid, q->bulk->imp);
+	if (q->bulk)
+		q->bulk->instantiated = false;
 }
 
 void
@@ -31,6 +31,7 @@ typedef struct cq {
 	int count;			/* number of times the query is matched */
 	timestamp created;	/* when the query was created */
 	sql_func *f;
+	sql_func *bulk;		/* variant taking a batch of parameter tuples, if any */
 } cq;
 
 typedef struct qc {
@@ -1316,6 +1316,21 @@ for_append_bat(column_storage *cs, BAT *i, char *storage_type)
 	return i;
 }
 
+static BAT *
+fsst_append_bat(column_storage *cs, BAT *i)
+{
+	BAT *newoffsets = NULL;
+	BAT *u = temp_descriptor(cs->ebid);
+
+	if (!u)
+		return NULL;
+	/* the symbol table is static, so the new values are only encoded */
+	if (FSSTprepare4append(&newoffsets, i, u) < 0)
+		newoffsets = NULL;
+	bat_destroy(u);
+	return newoffsets;
+}
+
 /*
  * Returns LOG_OK, LOG_ERR or LOG_CONFLICT
  */
@@ -1364,6 +1379,16 @@ cs_update_bat( sql_trans *tr, sql_delta **batp, sql_table *t, BAT *tids, BAT *up
 				bat_destroy(tids);
 			return LOG_ERR;
 		}
+	} else if (cs->st == ST_FSST) {
+		BAT *nupdates = fsst_append_bat(cs, updates);
+		if (oupdates != updates)
+			bat_destroy(updates);
+		updates = nupdates;
+		if (!updates) {
+			if (otids != tids)
+				bat_destroy(tids);
+			return LOG_ERR;
+		}
 	}
 
 	/* When we go to smaller grained update structures we should check for concurrent updates on this column ! */
@@ -1915,6 +1940,20 @@ for_append_val(column_storage *cs, void *i, BUN cnt, char *storage_type, int tt)
 	return i;
 }
 
+static void *
+fsst_append_val(column_storage *cs, void *i, BUN cnt)
+{
+	void *newoffsets = NULL;
+	BAT *u = temp_descriptor(cs->ebid);
+
+	if (!u)
+		return NULL;
+	if (FSSTprepare4append_vals(&newoffsets, i, cnt, u) < 0)
+		newoffsets = NULL;
+	bat_destroy(u);
+	return newoffsets;
+}
+
 static int
 cs_update_val( sql_trans *tr, sql_delta **batp, sql_table *t, oid rid, void *upd, int is_new)
 {
@@ -1932,6 +1971,15 @@ cs_update_val( sql_trans *tr, sql_delta **batp, sql_table *t, oid rid, void *upd
 		cs = &bat->cs;
 		if (!upd)
 			return LOG_ERR;
+	} else if (cs->st == ST_FSST) {
+		BAT *u = temp_descriptor(cs->ebid);
+
+		if (!u)
+			return LOG_ERR;
+		upd = FSSTencode_val(upd, u);
+		bat_destroy(u);
+		if (!upd)
+			return LOG_ERR;
 	}
 
 	/* check if rid is insert ? */
@@ -2256,6 +2304,15 @@ delta_append_bat(sql_trans *tr, sql_delta **batp, BUN offset, BAT *offsets, BAT
 			return LOG_ERR;
 		}
 	}
+	if (bat->cs.st == ST_FSST) {
+		BAT *ni = fsst_append_bat(&bat->cs, oi);
+		if (oi != i) /* oi will be replaced, so destroy possible unmask reference */
+			bat_destroy(oi);
+		oi = ni;
+		if (!oi) {
+			return LOG_ERR;
+		}
+	}
 
 	b = temp_descriptor(bat->cs.bid);
 	if (b == NULL) {
@@ -2332,6 +2389,13 @@ delta_append_val(sql_trans *tr, sql_delta **batp, BUN offset, BAT *offsets, void
 			return LOG_ERR;
 		}
 	}
+	if (bat->cs.st == ST_FSST) {
+		/* a new array is returned */
+		i = fsst_append_val(&bat->cs, i, cnt);
+		if (!i) {
+			return LOG_ERR;
+		}
+	}
 
 	b = temp_descriptor(bat->cs.bid);
 	if (b == NULL) {
@@ -2437,7 +2501,7 @@ append_col(sql_trans *tr, sql_column *c, BUN offset, BAT *offsets, void *data, B
 	if ((delta = bind_col_data(tr, c, NULL, NULL)) == NULL)
 		return LOG_ERR;
 
-	assert(delta->cs.st == ST_DEFAULT || delta->cs.st == ST_DICT || delta->cs.st == ST_FOR || delta->cs.st == ST_USTR);
+	assert(delta->cs.st == ST_DEFAULT || delta->cs.st == ST_DICT || delta->cs.st == ST_FOR || delta->cs.st == ST_USTR || delta->cs.st == ST_FSST);
 
 	if ((res = append_col_execute(tr, &delta, c, offset, offsets, data, cnt, isbat, tpe, c->storage_type)) != LOG_OK)
 		return res;
@@ -2812,7 +2876,7 @@ set_stats_col(sql_trans *tr, sql_column *c, double *unique_est, char *min, char
 	lock_column(tr->store, c);
 	if (unique_est) {
 		sql_delta *d;
-		if ((d = ATOMIC_PTR_GET(&c->data)) && (d->cs.st == ST_DEFAULT || d->cs.st == ST_USTR)) {
+		if ((d = ATOMIC_PTR_GET(&c->data)) && (d->cs.st == ST_DEFAULT || d->cs.st == ST_USTR || d->cs.st == ST_FSST)) {
 			BAT *b;
 			if ((b = bind_col_no_view(tr, c, RDONLY))) {
 				MT_lock_set(&b->theaplock);
@@ -2842,6 +2906,132 @@ set_stats_col(sql_trans *tr, sql_column *c, double *unique_est, char *min, char
 	return ok;
 }
 
+static int
+set_hist_col(sql_trans *tr, sql_column *c, sql_histogram *h)
+{
+	assert(tr->active);
+	if (!c || !ATOMIC_PTR_GET(&c->data) || !isTable(c->t) || !c->t->s) {
+		sql_histogram_destroy(h);
+		return 0;
+	}
+	lock_column(tr->store, c);
+	sql_histogram_destroy(c->hist);
+	c->hist = h;
+	unlock_column(tr->store, c);
+	return 1;
+}
+
+static void *
+hist_value_copy(allocator *sa, int type, const void *v)
+{
+	size_t len = ATOMlen(type, v);
+	void *nv = ma_alloc(sa, len);
+
+	if (nv)
+		memcpy(nv, v, len);
+	return nv;
+}
+
+/* copy the histogram into the allocator, so the optimizer can use it
+ * while a concurrent analyze replaces the one of the column */
+static sql_histogram *
+hist_col(sql_trans *tr, sql_column *c, allocator *sa)
+{
+	sql_histogram *h = NULL, *nh = NULL;
+
+	assert(tr->active);
+	if (!c || !isTable(c->t) || !c->t->s)
+		return NULL;
+	lock_column(tr->store, c);
+	if ((h = c->hist) != NULL && (nh = SA_NEW(sa, sql_histogram)) != NULL) {
+		*nh = *h;
+		nh->bounds = h->nbuckets ? SA_NEW_ARRAY(sa, void *, h->nbuckets + 1) : NULL;
+		nh->mcv = h->nmcv ? SA_NEW_ARRAY(sa, void *, h->nmcv) : NULL;
+		nh->mcvfreq = h->nmcv ? SA_NEW_ARRAY(sa, dbl, h->nmcv) : NULL;
+		if ((h->nbuckets && !nh->bounds) || (h->nmcv && (!nh->mcv || !nh->mcvfreq))) {
+			nh = NULL;
+		} else {
+			for (int i = 0; nh && h->nbuckets && i <= h->nbuckets; i++)
+				if (!(nh->bounds[i] = hist_value_copy(sa, h->type, h->bounds[i])))
+					nh = NULL;
+			for (int i = 0; nh && i < h->nmcv; i++) {
+				if (!(nh->mcv[i] = hist_value_copy(sa, h->type, h->mcv[i])))
+					nh = NULL;
+				else
+					nh->mcvfreq[i] = h->mcvfreq[i];
+			}
+		}
+	}
+	unlock_column(tr->store, c);
+	return nh;
+}
+
+/* add the group statistics to the table, replacing those of an earlier
+ * analyze of the same columns */
+static int
+set_colgroup_tab(sql_trans *tr, sql_table *t, sql_colgroup *g)
+{
+	assert(tr->active);
+	if (!t || !isTable(t) || !t->s) {
+		sql_colgroup_destroy(g);
+		return 0;
+	}
+	lock_table(tr->store, t);
+	for (sql_colgroup **p = &t->colgroups; *p; p = &(*p)->next) {
+		sql_colgroup *o = *p;
+		bool same = o->ncols == g->ncols;
+
+		for (int i = 0; same && i < g->ncols; i++)
+			same = o->cols[i] == g->cols[i];
+		if (same) {
+			*p = o->next;
+			sql_colgroup_destroy(o);
+			break;
+		}
+	}
+	g->next = t->colgroups;
+	t->colgroups = g;
+	unlock_table(tr->store, t);
+	return 1;
+}
+
+/* copy the groups of the table which include the column into the allocator */
+static list *
+colgroups_col(sql_trans *tr, sql_column *c, allocator *sa)
+{
+	list *res = NULL;
+
+	assert(tr->active);
+	if (!c || !isTable(c->t) || !c->t->s)
+		return NULL;
+	lock_table(tr->store, c->t);
+	for (sql_colgroup *g = c->t->colgroups; g; g = g->next) {
+		int i;
+		sql_colgroup *ng;
+
+		for (i = 0; i < g->ncols && g->cols[i] != c->base.id; i++)
+			;
+		if (i == g->ncols)
+			continue;
+		if (!res && !(res = sa_list(sa)))
+			break;
+		if (!(ng = SA_NEW(sa, sql_colgroup)) ||
+			!(ng->cols = SA_NEW_ARRAY(sa, sqlid, g->ncols)) ||
+			!(ng->dependency = SA_NEW_ARRAY(sa, dbl, g->ncols * g->ncols))) {
+			res = NULL;
+			break;
+		}
+		ng->ncols = g->ncols;
+		ng->ndistinct = g->ndistinct;
+		ng->next = NULL;
+		memcpy(ng->cols, g->cols, g->ncols * sizeof(sqlid));
+		memcpy(ng->dependency, g->dependency, g->ncols * g->ncols * sizeof(dbl));
+		list_append(res, ng);
+	}
+	unlock_table(tr->store, c->t);
+	return res;
+}
+
 static int
 min_max_col(sql_trans *tr, sql_column *c)
 {
@@ -2855,7 +3045,7 @@ min_max_col(sql_trans *tr, sql_column *c)
 	if (c->min && c->max)
 		return 1;
 	if ((d = ATOMIC_PTR_GET(&c->data))) {
-		if (d->cs.st == ST_FOR)
+		if (d->cs.st == ST_FOR || d->cs.st == ST_FSST)
 			return 0;
 		int access = d->cs.st == ST_DICT ? RD_EXT : RDONLY;
 		lock_column(tr->store, c);
@@ -3032,8 +3222,9 @@ col_stats(sql_trans *tr, sql_column *c, bool *nonil, bool *unique, double *uniqu
 			BATiter bi = bat_iterator(b);
 			*nonil = bi.nonil && !bi.nil;
 
+			/* the order of fsst encoded values differs from the order of the strings */
 			if ((EC_NUMBER(eclass) || EC_VARCHAR(eclass) || EC_TEMP_NOFRAC(eclass) || eclass == EC_DATE) &&
-				d->cs.ucnt == 0) {
+				d->cs.st != ST_FSST && d->cs.ucnt == 0) {
 				if (c->min && VALinit(NULL, min, bi.type, c->min))
 					ok |= 1;
 				else if (bi.minpos != BUN_NONE && VALinit(NULL, min, bi.type, BUNtail(&bi, bi.minpos)))
@@ -3044,7 +3235,7 @@ col_stats(sql_trans *tr, sql_column *c, bool *nonil, bool *unique, double *uniqu
 					ok |= 2;
 			}
 			if (d->cs.ucnt == 0) {
-				if (d->cs.st == ST_DEFAULT || d->cs.st == ST_USTR) {
+				if (d->cs.st == ST_DEFAULT || d->cs.st == ST_USTR || d->cs.st == ST_FSST) {
 					*unique = bi.key;
 					*unique_est = bi.unique_est;
 					if (*unique_est == 0) {
@@ -3301,6 +3492,13 @@ create_col(sql_trans *tr, sql_column *c)
 					return LOG_ERR;
 				bat->cs.ebid = temp_dup(bid);
 				bat->cs.st = ST_DICT;
+			} else if (strcmp(c->storage_type, "FSST") == 0) {
+				sqlstore *store = tr->store;
+				int bid = log_find_bat(store->logger, -c->base.id);
+				if (bid <= 0)
+					return LOG_ERR;
+				bat->cs.ebid = temp_dup(bid);
+				bat->cs.st = ST_FSST;
 			} else if (strncmp(c->storage_type, "FOR", 3) == 0) {
 				bat->cs.st = ST_FOR;
 			} else if (strncmp(c->storage_type, "USTR", 4) == 0) {
@@ -3941,7 +4139,7 @@ clear_cs(sql_trans *tr, column_storage *cs, bool renew, bool temp)
 	BUN sz = 0;
 
 	(void)tr;
-	assert(cs->st == ST_DEFAULT || cs->st == ST_DICT || cs->st == ST_FOR || cs->st == ST_USTR);
+	assert(cs->st == ST_DEFAULT || cs->st == ST_DICT || cs->st == ST_FOR || cs->st == ST_USTR || cs->st == ST_FSST);
 	if (cs->bid && renew) {
 		b = quick_descriptor(cs->bid);
 		if (b) {
@@ -5447,6 +5645,10 @@ bat_storage_init( store_functions *sf)
 	sf->dcount_col = &dcount_col;
 	sf->min_max_col = &min_max_col;
 	sf->set_stats_col = &set_stats_col;
+	sf->set_hist_col = &set_hist_col;
+	sf->hist_col = &hist_col;
+	sf->set_colgroup_tab = &set_colgroup_tab;
+	sf->colgroups_col = &colgroups_col;
 	sf->sorted_col = &sorted_col;
 	sf->sorted_idx = &sorted_idx;
 	sf->unique_col = &unique_col;
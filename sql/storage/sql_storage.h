@@ -149,6 +149,10 @@ typedef size_t (*count_idx_fptr) (sql_trans *tr, sql_idx *i, int access);
 typedef size_t (*dcount_col_fptr) (sql_trans *tr, sql_column *c);
 typedef int (*min_max_col_fptr) (sql_trans *tr, sql_column *c);
 typedef int (*set_stats_col_fptr) (sql_trans *tr, sql_column *c, double *unique_est, char *min, char *max);
+typedef int (*set_hist_col_fptr) (sql_trans *tr, sql_column *c, sql_histogram *h);
+typedef sql_histogram *(*hist_col_fptr) (sql_trans *tr, sql_column *c, allocator *sa);
+typedef int (*set_colgroup_tab_fptr) (sql_trans *tr, sql_table *t, sql_colgroup *g);
+typedef list *(*colgroups_col_fptr) (sql_trans *tr, sql_column *c, allocator *sa);
 typedef int (*prop_col_fptr) (sql_trans *tr, sql_column *c);
 typedef int (*prop_idx_fptr) (sql_trans *tr, sql_idx *i);
 typedef int (*proprec_col_fptr) (sql_trans *tr, sql_column *c, bool *nonil, bool *unique, double *unique_est, ValPtr min, ValPtr max);
@@ -208,6 +212,7 @@ typedef enum storage_type {
 	ST_DICT,
 	ST_FOR,
 	ST_USTR,
+	ST_FSST,
 } storage_type;
 
 typedef int (*col_compress_fptr) (sql_trans *tr, sql_column *c, storage_type st, BAT *offsets, BAT *vals);
@@ -244,6 +249,10 @@ typedef struct store_functions {
 	dcount_col_fptr dcount_col;
 	min_max_col_fptr min_max_col;
 	set_stats_col_fptr set_stats_col;
+	set_hist_col_fptr set_hist_col;
+	hist_col_fptr hist_col;
+	set_colgroup_tab_fptr set_colgroup_tab;
+	colgroups_col_fptr colgroups_col;
 	prop_col_fptr sorted_col;
 	prop_idx_fptr sorted_idx;
 	prop_col_fptr unique_col;
@@ -422,6 +431,12 @@ extern int sql_trans_is_unique(sql_trans *tr, sql_column *col);
 extern int sql_trans_is_duplicate_eliminated(sql_trans *tr, sql_column *col);
 extern int sql_trans_col_stats(sql_trans *tr, sql_column *col, bool *nonil, bool *unique, double *unique_est, ValPtr min, ValPtr max);
 extern size_t sql_trans_dist_count(sql_trans *tr, sql_column *col);
+extern sql_histogram *sql_trans_col_hist(sql_trans *tr, sql_column *col, allocator *sa);
+extern void sql_histogram_destroy(sql_histogram *h);
+extern sql_histogram *sql_histogram_dup(sql_histogram *h);
+extern int sql_trans_drop_histogram(sql_trans *tr, sqlid id);
+extern list *sql_trans_col_groups(sql_trans *tr, sql_column *col, allocator *sa);
+extern void sql_colgroup_destroy(sql_colgroup *g);
 extern int sql_trans_ranges(sql_trans *tr, sql_column *col, void **min, void **max);
 
 extern void column_destroy(struct sqlstore *store, sql_column *c);
@@ -576,6 +591,10 @@ extern BAT *FORdecompress_(BAT *o, lng minval, int tt, role_t role);
 extern int FORprepare4append(BAT **noffsets, BAT *vals, lng minval, int tt);
 extern int FORprepare4append_vals(void **noffsets, void *vals, BUN cnt, lng minval, int vtype, int ft);
 
+extern int FSSTprepare4append(BAT **noffsets, BAT *vals, BAT *symbols);
+extern int FSSTprepare4append_vals(void **noffsets, void *vals, BUN cnt, BAT *symbols);
+extern char *FSSTencode_val(const char *val, BAT *symbols);
+
 extern void store_printinfo(sqlstore *store);
 
 #endif /*SQL_STORAGE_H */
@@ -229,6 +229,7 @@ column_destroy(sqlstore *store, sql_column *c)
 		store->storage_api.destroy_col(store, c);
 	_DELETE(c->min);
 	_DELETE(c->max);
+	sql_histogram_destroy(c->hist);
 	_DELETE(c->def);
 	_DELETE(c->storage_type);
 	_DELETE(c->base.name);
@@ -257,6 +258,10 @@ table_destroy(sqlstore *store, sql_table *t)
 	ol_destroy(t->keys, store);
 	ol_destroy(t->triggers, store);
 	ol_destroy(t->columns, store);
+	for (sql_colgroup *g = t->colgroups, *n; g; g = n) {
+		n = g->next;
+		sql_colgroup_destroy(g);
+	}
 	if (isPartitionedByExpressionTable(t)) {
 		if (t->part.pexp->cols)
 			list_destroy2(t->part.pexp->cols, store);
@@ -3352,6 +3357,10 @@ column_dup(sql_trans *tr, sql_column *oc, sql_table *t, sql_column **cres)
 	if (oc->storage_type)
 		c->storage_type =_STRDUP(oc->storage_type);
 	ATOMIC_PTR_INIT(&c->data, NULL);
+	/* the statistics collected by analyze stay with the new version */
+	MT_lock_set(&oc->lock);
+	c->hist = sql_histogram_dup(oc->hist);
+	MT_lock_unset(&oc->lock);
 
 	obj_lock_init(&c->lock, 'c', c->base.id);
 	if (isTable(c->t)) {
@@ -4723,6 +4732,27 @@ sql_trans_drop_any_comment(sql_trans *tr, sqlid id)
 	return 0;
 }
 
+int
+sql_trans_drop_histogram(sql_trans *tr, sqlid id)
+{
+	sqlstore *store = tr->store;
+	sql_table *hists;
+	rids *rs;
+	int res = LOG_OK;
+
+	hists = find_sql_table(tr, find_sql_schema(tr, "sys"), "column_histograms");
+	if (!hists) /* for example during upgrades */
+		return res;
+
+	rs = store->table_api.rids_select(tr, find_sql_column(hists, "column_id"), &id, &id, NULL);
+	if (rs == NULL)
+		return LOG_ERR;
+	for (oid rid = store->table_api.rids_next(rs); res == LOG_OK && !is_oid_nil(rid); rid = store->table_api.rids_next(rs))
+		res = store->table_api.table_delete(tr, hists, rid);
+	store->table_api.rids_destroy(rs);
+	return res;
+}
+
 static int
 sys_drop_idx(sql_trans *tr, sql_idx * i, int drop_action)
 {
@@ -5013,6 +5043,8 @@ sys_drop_column(sql_trans *tr, sql_column *col, int drop_action)
 		return res;
 	if ((res = sql_trans_drop_any_comment(tr, col->base.id)))
 		return res;
+	if (isGlobal(col->t) && (res = sql_trans_drop_histogram(tr, col->base.id)))
+		return res;
 	if ((res = sql_trans_drop_obj_priv(tr, col->base.id)))
 		return res;
 	if ((res = sys_drop_default_object(tr, col, drop_action)))
@@ -6958,6 +6990,11 @@ sql_trans_alter_type(sql_trans *tr, sql_column *col, sql_subtype *t)
 			return res;
 		store->storage_api.col_subtype(tr, dup, t);
 		dup->type = *t;
+		/* the bounds and common values are of the old type */
+		sql_histogram_destroy(dup->hist);
+		dup->hist = NULL;
+		if (isGlobal(col->t) && (res = sql_trans_drop_histogram(tr, col->base.id)))
+			return res;
 	}
 	return res;
 }
@@ -7020,6 +7057,98 @@ sql_trans_dist_count( sql_trans *tr, sql_column *col )
 	return 0;
 }
 
+void
+sql_histogram_destroy(sql_histogram *h)
+{
+	if (!h)
+		return;
+	if (h->bounds) {
+		for (int i = 0; i <= h->nbuckets; i++)
+			_DELETE(h->bounds[i]);
+		_DELETE(h->bounds);
+	}
+	if (h->mcv) {
+		for (int i = 0; i < h->nmcv; i++)
+			_DELETE(h->mcv[i]);
+		_DELETE(h->mcv);
+	}
+	_DELETE(h->mcvfreq);
+	_DELETE(h);
+}
+
+static void *
+hist_value_dup(int type, const void *v)
+{
+	size_t len = ATOMlen(type, v);
+	void *nv = GDKmalloc(len);
+
+	if (nv)
+		memcpy(nv, v, len);
+	return nv;
+}
+
+sql_histogram *
+sql_histogram_dup(sql_histogram *h)
+{
+	sql_histogram *nh;
+
+	if (!h || !(nh = ZNEW(sql_histogram)))
+		return NULL;
+	*nh = *h;
+	nh->bounds = NULL;
+	nh->mcv = NULL;
+	nh->mcvfreq = NULL;
+	if ((h->nbuckets && !(nh->bounds = ZNEW_ARRAY(void *, h->nbuckets + 1))) ||
+		(h->nmcv && (!(nh->mcv = ZNEW_ARRAY(void *, h->nmcv)) || !(nh->mcvfreq = NEW_ARRAY(dbl, h->nmcv))))) {
+		sql_histogram_destroy(nh);
+		return NULL;
+	}
+	for (int i = 0; h->nbuckets && i <= h->nbuckets; i++) {
+		if (!(nh->bounds[i] = hist_value_dup(h->type, h->bounds[i]))) {
+			sql_histogram_destroy(nh);
+			return NULL;
+		}
+	}
+	for (int i = 0; i < h->nmcv; i++) {
+		if (!(nh->mcv[i] = hist_value_dup(h->type, h->mcv[i]))) {
+			sql_histogram_destroy(nh);
+			return NULL;
+		}
+		nh->mcvfreq[i] = h->mcvfreq[i];
+	}
+	return nh;
+}
+
+sql_histogram *
+sql_trans_col_hist( sql_trans *tr, sql_column *col, allocator *sa )
+{
+	sqlstore *store = tr->store;
+
+	if (col && isTable(col->t) && col->hist && store->storage_api.hist_col)
+		return store->storage_api.hist_col(tr, col, sa);
+	return NULL;
+}
+
+void
+sql_colgroup_destroy(sql_colgroup *g)
+{
+	if (!g)
+		return;
+	_DELETE(g->cols);
+	_DELETE(g->dependency);
+	_DELETE(g);
+}
+
+list *
+sql_trans_col_groups( sql_trans *tr, sql_column *col, allocator *sa )
+{
+	sqlstore *store = tr->store;
+
+	if (col && isTable(col->t) && col->t->colgroups && store->storage_api.colgroups_col)
+		return store->storage_api.colgroups_col(tr, col, sa);
+	return NULL;
+}
+
 int
 sql_trans_ranges( sql_trans *tr, sql_column *col, void **min, void **max )
 {
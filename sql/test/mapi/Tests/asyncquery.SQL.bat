@@ -0,0 +1,3 @@
+@echo off
+
+asyncquery.exe %MAPIPORT%
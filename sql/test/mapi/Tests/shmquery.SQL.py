@@ -0,0 +1,17 @@
+import os
+import subprocess
+import sys
+
+TSTDB = os.environ['TSTDB']
+MAPIPORT = os.environ['MAPIPORT']
+MAPIHOST = os.getenv('MAPIHOST', '/tmp')
+
+# the shared memory transport is only used on UNIX domain sockets
+if os.name != 'nt' and os.path.exists(f'{MAPIHOST}/.s.monetdb.{MAPIPORT}'):
+    p = subprocess.run(['shmquery', MAPIPORT, MAPIHOST, TSTDB],
+                       stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                       encoding='utf-8')
+    if p.returncode != 0 or p.stdout:
+        print(f"Test program failed with the following output:\n------", file=sys.stderr)
+        print(f"{p.stdout}-----", file=sys.stderr)
+        sys.exit('TEST FAILED')
@@ -0,0 +1,3 @@
+@echo off
+
+streamfetch.exe %MAPIPORT%
@@ -0,0 +1,110 @@
+import os
+import subprocess
+import sys
+import tempfile
+import urllib.parse
+try:
+    from MonetDBtesting import process
+except ImportError:
+    import process
+
+TSTDB = os.environ['TSTDB']
+MAPIPORT = os.environ['MAPIPORT']
+
+NROWS = 20000
+
+# an upload and a result that are both larger than a block
+SCRIPT = f"""\
+create temporary table wire (i int, s varchar(120)) on commit preserve rows;
+copy {NROWS} records into wire from stdin;
+""" + ''.join(f'{i}|{"x" * 100}{i}\n' for i in range(NROWS)) + """\
+select count(*), sum(i) from wire where s = repeat('x', 100) || i;
+select value, repeat('y', 100) || value from generate_series(0, 20000);
+drop table wire;
+"""
+
+def run_mclient(port, dbname, **extra_args):
+    url = f'monetdb://localhost:{port}/{dbname}'
+    if extra_args:
+        url += '?' + urllib.parse.urlencode(extra_args)
+    with tempfile.TemporaryDirectory() as tmpdir:
+        logfile = os.path.join(tmpdir, 'mclient.log')
+        cmd = [ 'mclient', '-d', url, '-fcsv', f'--log={logfile}' ]
+        out = subprocess.check_output(cmd, input=SCRIPT, encoding='utf-8')
+        with open(logfile, encoding='utf-8', errors='replace') as f:
+            log = f.read()
+    return out, log
+
+def offered(log):
+    # the methods the server put in its challenge
+    for line in log.splitlines():
+        if ':mserver:' in line:
+            for field in line.split(':'):
+                if field.startswith('COMPRESS='):
+                    return field[9:].split(',')
+    return []
+
+def used(log):
+    for line in log.splitlines():
+        if line.startswith('Using ') and line.endswith(' compression'):
+            return line[6:-12]
+    return None
+
+def check(port, dbname, expected, **extra_args):
+    out, log = run_mclient(port, dbname, **extra_args)
+    assert out == expected,\
+        f'Different output with {extra_args!r}'
+    return offered(log), used(log)
+
+
+#######################################################################
+# Without compression
+
+expected, log = run_mclient(MAPIPORT, TSTDB, wire_compression='off')
+
+assert expected.startswith(f'{NROWS},{NROWS * (NROWS - 1) // 2}\n'),\
+    f'Found {expected.splitlines()[0]!r}'
+
+assert used(log) is None,\
+    f'Found {used(log)!r}'
+
+
+#######################################################################
+# Each method the server offers is used when asked for, and the others
+# fall back to none
+
+for method in ('lz4', 'zstd'):
+    methods, method_used = check(MAPIPORT, TSTDB, expected, wire_compression=method)
+    if method in methods:
+        assert method_used == method,\
+            f'Found {method_used!r} for {method!r}'
+    else:
+        assert method_used is None,\
+            f'Found {method_used!r} for {method!r}, offered {methods!r}'
+
+
+#######################################################################
+# wire_compression=on picks the first method offered
+
+methods, method_used = check(MAPIPORT, TSTDB, expected, wire_compression='on')
+assert method_used == (methods[0] if methods else None),\
+    f'Found {method_used!r}, offered {methods!r}'
+
+
+#######################################################################
+# A server that doesn't offer compression: the client falls back to none
+
+with tempfile.TemporaryDirectory() as farm_dir:
+    os.mkdir(os.path.join(farm_dir, 'db1'))
+    with process.server(args=['--set', 'mapi_compression=no'],
+                        mapiport='0', dbname='db1',
+                        dbfarm=os.path.join(farm_dir, 'db1'),
+                        stdin=process.PIPE,
+                        stdout=process.PIPE, stderr=process.PIPE) as s:
+        for method in ('on', 'lz4', 'zstd'):
+            methods, method_used = check(s.dbport, 'db1', expected, wire_compression=method)
+            assert methods == [],\
+                f'Found {methods!r}'
+            assert method_used is None,\
+                f'Found {method_used!r} for {method!r}'
+        s.communicate()
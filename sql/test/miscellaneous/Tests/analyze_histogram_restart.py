@@ -0,0 +1,73 @@
+import os, re, sys, tempfile
+try:
+    from MonetDBtesting import process
+except ImportError:
+    import process
+
+# the estimates are only shown in the plans when not testing
+TESTINGMASK = 256
+
+def sql(s, query):
+    with process.client('sql', server=s, format='csv', echo=False,
+                        stdin=process.PIPE,
+                        stdout=process.PIPE, stderr=process.PIPE) as c:
+        out, err = c.communicate(query)
+    if err:
+        sys.stderr.write(err)
+    return out
+
+def show_estimates(s):
+    flags = int(sql(s, 'select sys.debug(0);\n'))
+    sql(s, f'select sys.debug({flags & ~TESTINGMASK});\n')
+
+def estimate(s, pred):
+    plan = sql(s, f'explain show details select city from skewed where {pred};\n')
+    m = re.search(r'SELECTIVITY [0-9.]+ COUNT ([0-9]+)', plan)
+    if m is None:
+        sys.stderr.write(f'No estimate for {pred!r} in\n{plan}\n')
+        return None
+    return int(m.group(1))
+
+def estimates(s):
+    return {pred: estimate(s, pred) for pred in PREDICATES}
+
+def check(s, when, expected):
+    found = estimates(s)
+    if found != expected:
+        sys.stderr.write(f'{when}: expected estimates {expected}, got {found}\n')
+
+def server(farm_dir):
+    return process.server(mapiport='0', dbname='db1',
+                          dbfarm=os.path.join(farm_dir, 'db1'),
+                          stdin=process.PIPE,
+                          stdout=process.PIPE, stderr=process.PIPE)
+
+# eight in ten rows have region 1, the others are spread over 20 regions
+PREDICATES = ('region = 1', 'region <> 1', 'region > 50')
+
+with tempfile.TemporaryDirectory() as farm_dir:
+    os.mkdir(os.path.join(farm_dir, 'db1'))
+    with server(farm_dir) as s:
+        show_estimates(s)
+        sql(s, "CREATE TABLE skewed (region int, city varchar(20));\n"
+            "INSERT INTO skewed SELECT CASE WHEN value % 10 < 8 THEN 1 ELSE value % 100 END, 'city' || (value % 5) FROM generate_series(0, 10000);\n")
+        before = estimates(s)
+        sql(s, "ANALYZE sys.skewed;\n")
+        analyzed = estimates(s)
+        if analyzed['region = 1'] != 8000 or analyzed == before:
+            sys.stderr.write(f'Expected other estimates after analyze than {before}, got {analyzed}\n')
+        # the columns are copied when the table changes
+        sql(s, "ALTER TABLE skewed ADD COLUMN extra int;\n")
+        check(s, 'After alter table', analyzed)
+        s.communicate()
+    with server(farm_dir) as s:
+        show_estimates(s)
+        check(s, 'After restart', analyzed)
+        # the bounds and common values of the old type are dropped
+        sql(s, "ALTER TABLE skewed ALTER COLUMN region bigint;\n")
+        check(s, 'After changing the type', before)
+        out = sql(s, "SELECT count(*) FROM sys.column_histograms h, sys._columns c, sys._tables t WHERE h.column_id = c.id AND c.table_id = t.id AND t.name = 'skewed' AND c.name = 'region';\n")
+        if out.strip() != '0':
+            sys.stderr.write(f'Expected the histogram of region to be dropped, found {out.strip()} rows\n')
+        sql(s, "DROP TABLE skewed;\n")
+        s.communicate()
@@ -0,0 +1,78 @@
+import multiprocessing as mp
+import time
+from pymonetdb.exceptions import OperationalError
+from MonetDBtesting.sqltest import SQLTestCase
+
+init    =   ''' create or replace function sleep(msecs int) returns int external name alarm.sleep;
+            create user rgu with password \'rgu\' name \'rgu\' schema sys;
+            create user rgv with password \'rgv\' name \'rgv\' schema sys;
+            grant execute on function sleep(int) to rgu;
+            create role rg_qrole;
+            grant rg_qrole to rgv;
+            call sys.create_resource_group(\'rg_q\', 1, 1, 0);
+            call sys.assign_resource_group(\'rgu\', \'rg_q\');
+            call sys.assign_resource_group(\'rg_qrole\', \'rg_q\'); '''
+
+load = 'select running, queued from sys.resource_groups() where groupname = \'rg_q\';'
+
+def execute_qry(qry):
+    with SQLTestCase() as client:
+        client.connect(username = 'rgu', password = 'rgu')
+        try:
+            client.execute(qry)
+        except OperationalError as e:
+            print(e)
+            exit(1)
+
+# the role of rgv puts the query in the group after the timeout is set
+def execute_timeout():
+    with SQLTestCase() as client:
+        client.connect(username = 'rgv', password = 'rgv')
+        client.execute('call sys.setquerytimeout(1);').assertSucceeded()
+        client.execute('set role rg_qrole;').assertSucceeded()
+        client.execute('select 43;').assertFailed(err_code='HYT00', err_message='Query aborted due to timeout')
+
+if __name__ == '__main__':
+    with SQLTestCase() as mdb:
+        mdb.connect(username='monetdb', password='monetdb')
+        mdb.execute(init).assertSucceeded()
+
+        # the single slot is taken, the next query of the group waits
+        client_proc1 = mp.Process(target=execute_qry, args=('select sleep(3000);',))
+        client_proc1.start()
+        time.sleep(1)
+        client_proc2 = mp.Process(target=execute_qry, args=('select 42;',))
+        client_proc2.start()
+        time.sleep(0.5)
+        mdb.execute(load).assertSucceeded().assertDataResultMatch([(1, 1)])
+
+        # and so does the next, until its query timeout expires
+        client_proc3 = mp.Process(target=execute_timeout)
+        client_proc3.start()
+        time.sleep(0.5)
+        mdb.execute(load).assertSucceeded().assertDataResultMatch([(1, 2)])
+        client_proc3.join()
+        mdb.execute(load).assertSucceeded().assertDataResultMatch([(1, 1)])
+        client_proc1.join()
+        client_proc2.join()
+        mdb.execute('select running, queued, admitted >= 2 from sys.resource_groups() where groupname = \'rg_q\';').assertSucceeded().assertDataResultMatch([(0, 0, True)])
+
+        # dropping the group admits the waiting queries
+        client_proc1 = mp.Process(target=execute_qry, args=('select sleep(3000);',))
+        client_proc1.start()
+        time.sleep(1)
+        client_proc2 = mp.Process(target=execute_qry, args=('select 42;',))
+        client_proc2.start()
+        time.sleep(0.5)
+        mdb.execute(load).assertSucceeded().assertDataResultMatch([(1, 1)])
+        mdb.execute('call sys.drop_resource_group(\'rg_q\');').assertSucceeded()
+        client_proc2.join(timeout=1)
+        if client_proc2.exitcode != 0:
+            print('query of a dropped group was not admitted')
+            exit(1)
+        client_proc1.join()
+
+        mdb.execute('drop function sleep;').assertSucceeded()
+        mdb.execute('drop user rgu;').assertSucceeded()
+        mdb.execute('drop user rgv;').assertSucceeded()
+        mdb.execute('drop role rg_qrole;').assertSucceeded()
@@ -0,0 +1,148 @@
+#!/usr/bin/env python3
+
+import hashlib
+import os
+import socket
+import subprocess
+import tempfile
+import time
+
+from monetdbd import MonetDBD, Runner
+
+# the UNIX socket of the databases must fit in a sockaddr_un, else
+# monetdbd connects over TCP and doesn't pool
+farmdir = os.path.join(tempfile.gettempdir(), f'monetdbd-pool-{os.getpid()}')
+
+class MapiSocket:
+    """Just enough of the MAPI protocol to log in directly on the UNIX
+    socket of an mserver and to send it commands."""
+
+    def __init__(self, path, user, password, database):
+        self.sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        self.sock.connect(path)
+        self.sock.sendall(b'0')
+        salt, _, _, hashes, _, pwhash = self.read().split(':')[:6]
+        assert 'SHA512' in hashes.split(',') and pwhash == 'SHA512'
+        pw = hashlib.sha512(password.encode()).hexdigest()
+        h = hashlib.sha512((pw + salt).encode()).hexdigest()
+        reply = self.cmd(f'LIT:{user}:{{SHA512}}{h}:sql:{database}:')
+        assert reply == '', reply
+
+    def recv(self, n):
+        data = b''
+        while len(data) < n:
+            r = self.sock.recv(n - len(data))
+            if not r:
+                raise ConnectionError('connection closed by the server')
+            data += r
+        return data
+
+    def read(self):
+        msg = b''
+        while True:
+            n = int.from_bytes(self.recv(2), 'little')
+            msg += self.recv(n >> 1)
+            if n & 1:
+                return msg.decode()
+
+    def cmd(self, msg):
+        data = msg.encode()
+        assert len(data) < 8190
+        self.sock.sendall(((len(data) << 1) | 1).to_bytes(2, 'little') + data)
+        return self.read()
+
+    def close(self):
+        self.sock.close()
+
+with Runner(False, timeout=100) as run:
+
+    def header(text):
+        run.print()
+        run.print('-- ', text)
+
+    def note(*args, **kwargs):
+        run.print('NOTE ', sep='', end='')
+        run.print(*args, **kwargs)
+
+    header('CREATE FARM')
+    with MonetDBD(run, farmdir) as m:
+
+        def mclient(sql, user='monetdb', password='monetdb'):
+            url = f'monetdb://localhost:{m.port}/foo1?user={user}&password={password}'
+            return run.run_command(['mclient', '-d', url, '-fcsv', '-s', sql], output=True)
+
+        def reused():
+            out = m.run_monetdbd('get', 'logfile', output=True)
+            logfile = out.split('\n')[1][7:].strip()
+            with open(os.path.join(farmdir, logfile)) as f:
+                return f.read().count('reusing pooled connection')
+
+        def disconnected():
+            # the connection goes back into the pool once the server
+            # sent a new challenge
+            time.sleep(1)
+
+        header('ENABLE POOLING')
+        m.run_monetdbd('set', 'pool=2')
+        m.run_monetdbd('set', 'loglevel=debug')
+        mclient("create user alice with password 'alicepw' name 'Alice' schema sys;"
+                "create schema alice_s authorization alice;"
+                "alter user alice set schema alice_s;"
+                "grant select on t to alice")
+        disconnected()
+        fresh = mclient('select current_timezone').strip()
+        disconnected()
+
+        header('REAUTH AS ANOTHER USER')
+        before = reused()
+        mclient("set schema alice_s;"
+                "set optimizer = 'minimal_pipe';"
+                "set time zone interval '+05:00' hour to minute;"
+                "create local temporary table tmp_t (i int);"
+                "start transaction;"
+                "insert into sys.t values ('uncommitted')")
+        disconnected()
+        out = mclient("select current_user, current_schema, optimizer, current_timezone,"
+                      " (select count(*) from sys.t),"
+                      " (select count(*) from sys.tables where name = 'tmp_t')",
+                      user='alice', password='alicepw')
+        run.print(' -->', repr(out))
+        assert out.strip() == f'alice,alice_s,default_pipe,{fresh},1,0'
+        note("""session of monetdb was reset for alice""")
+        assert reused() == before + 2
+        note("""both logins used a pooled connection""")
+        disconnected()
+
+        header('FAILED REAUTH')
+        before = reused()
+        try:
+            mclient('select 1', user='alice', password='wrong')
+            note("should have failed")
+            assert False
+        except subprocess.CalledProcessError:
+            note("failed as expected")
+        assert reused() == before + 1
+        note("""the failed login used a pooled connection""")
+        out = mclient('select current_user', user='alice', password='alicepw')
+        assert out.strip() == 'alice'
+        note("""next login succeeds""")
+        disconnected()
+
+        header('XREAUTH FROM A DIRECT CLIENT')
+        c = MapiSocket(os.path.join(farmdir, 'foo1', '.mapi.sock'),
+                       'monetdb', 'monetdb', 'foo1')
+        reply = c.cmd('Xchallenge tag\n')
+        run.print(' -->', repr(reply))
+        assert reply.startswith('!') and 'Unrecognized X command' in reply
+        note("""Xchallenge refused""")
+        reply = c.cmd('Xreauth LIT:alice:{SHA512}00:sql:foo1:')
+        run.print(' -->', repr(reply))
+        assert reply.startswith('!') and 'Unrecognized X command' in reply
+        note("""Xreauth refused""")
+        reply = c.cmd('sselect current_user;\n')
+        run.print(' -->', repr(reply))
+        assert 'monetdb' in reply
+        note("""connection is still logged in as monetdb""")
+        c.close()
+
+        header('DONE')
@@ -408,9 +408,17 @@ handleClient(void *data)
 		/* flush redirect */
 		mnstr_flush(fout, MNSTR_FLUSH_DATA);
 
+		/* only sql sessions of local databases can be taken over by
+		 * the next client */
+		const char *pooldb = NULL;
+		if (getConfNum(_mero_props, "pool") > 0 &&
+			strcmp(lang, "sql") == 0 &&
+			redirs[0].dbname != redirs[0].path)
+			pooldb = redirs[0].dbname;
+
 		/* wait for input, or disconnect in a proxy runner */
 		if ((e = startProxy(sock, fdin, fout,
-						redirs[0].conns->val, host)) != NO_ERR)
+						redirs[0].conns->val, host, pooldb)) != NO_ERR)
 		{
 			/* we need to let the client login in order not to violate
 			 * the protocol */
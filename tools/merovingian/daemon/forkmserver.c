@@ -28,6 +28,7 @@
 #include "discoveryrunner.h" /* remotedb */
 #include "multiplex-funnel.h" /* multiplexInit */
 #include "forkmserver.h"
+#include "proxy.h" /* dropPooledSessions */
 
 #ifndef S_ISDIR
 #define S_ISDIR(mode)	(((mode) & _S_IFMT) == _S_IFDIR)
@@ -123,6 +124,7 @@ terminateProcess(char *dbname, pid_t pid, mtype type)
 	}
 
 	/* ok, once we get here, we'll be shutting down the server */
+	dropPooledSessions(dbname);
 	Mlevelfprintf(WARNING, stdout, "sending process %lld (database '%s') the "
 			 "TERM signal\n", (long long int)pid, dbname);
 	if (kill(pid, SIGTERM) < 0) {
@@ -471,6 +471,7 @@ main(int argc, char *argv[])
 		{"snapshotcompression", strdup(".tar"),            0,               STR},
 #endif
 		{"keepalive",           strdup("60"),              60,              INT},
+		{"pool",                strdup("0"),               0,               INT},
 		{ NULL,                 NULL,                      0,               INVALID}
 	};
 	confkeyval *kv;
@@ -17,7 +17,9 @@
 #include <netdb.h>
 #include <netinet/in.h>
 #include <fcntl.h>
+#include <poll.h>
 #include <string.h> /* strerror */
+#include <time.h> /* clock_gettime */
 #ifdef HAVE_SYS_UIO_H
 # include <sys/uio.h>
 #endif
@@ -25,6 +27,7 @@
 #include "mstring.h"
 #include "stream.h"
 #include "stream_socket.h"
+#include "utils/utils.h" /* generateSalt */
 
 #include "merovingian.h"
 #include "proxy.h"
@@ -94,9 +97,496 @@ proxyThread(void *d)
 	return NULL;
 }
 
+/* Connections to a local mserver can be kept open after the client
+ * disconnected, and be handed out to the next client of the same
+ * database.  Instead of a new connection, which costs a thread and a
+ * full session setup in the server, the next client then only logs in
+ * again over the existing one.  When the client disconnects, the proxy
+ * asks the server for a new challenge (Xchallenge), which also tells
+ * when the server is done with the queries of the client.  The
+ * challenge is what the next client gets as greeting, its response is
+ * passed on as Xreauth, after which the server has reset the session
+ * and logged in the new user.  The "pool" property limits the number
+ * of idle connections per database. */
+
+#define POOL_DRAIN_TIMEOUT 10	/* seconds to wait for a new challenge */
+
+typedef struct _pooled_session {
+	char *dbname;
+	int sock;
+	stream *in;      /* from the server */
+	stream *out;     /* to the server */
+	char greeting[1024];  /* challenge for the next client */
+	struct _pooled_session *next;
+} pooled_session;
+
+typedef struct _pooled_proxy {
+	pooled_session *s;
+	int csock;
+	stream *cin;     /* from the client */
+	stream *cout;    /* to the client */
+	char *name;      /* a description to log when the client leaves */
+	char tag[34];    /* identifies the reply to Xchallenge */
+	pthread_t stoc;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	bool draining;   /* client is gone, waiting for the challenge */
+	bool done;       /* stoc stopped reading from the server */
+	bool ready;      /* a new challenge arrived, can be pooled */
+} pooled_proxy;
+
+static pthread_mutex_t _mero_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pooled_session *_mero_pool = NULL;
+
+static void
+destroyPooledSession(pooled_session *s)
+{
+	close_stream(s->out);
+	close_stream(s->in);
+	free(s->dbname);
+	free(s);
+}
+
+/* returns an idle connection to database dbname, if there is a usable
+ * one */
+static pooled_session *
+takePooledSession(const char *dbname)
+{
+	pooled_session *s, **sp;
+
+	pthread_mutex_lock(&_mero_pool_lock);
+	for (sp = &_mero_pool; (s = *sp) != NULL; ) {
+		if (strcmp(s->dbname, dbname) != 0) {
+			sp = &s->next;
+			continue;
+		}
+		*sp = s->next;
+		/* an idle server has nothing to say, if the connection is
+		 * readable it was closed */
+		struct pollfd pfd = (struct pollfd) {.fd = s->sock, .events = POLLIN};
+		if (poll(&pfd, 1, 0) == 0)
+			break;
+		Mlevelfprintf(DEBUG, stdout, "dropping closed pooled connection "
+				"to database '%s'\n", dbname);
+		destroyPooledSession(s);
+	}
+	pthread_mutex_unlock(&_mero_pool_lock);
+	return s;
+}
+
+static void
+returnPooledSession(pooled_session *s)
+{
+	pooled_session *t;
+	int n = 0;
+
+	pthread_mutex_lock(&_mero_pool_lock);
+	for (t = _mero_pool; t != NULL; t = t->next)
+		if (strcmp(t->dbname, s->dbname) == 0)
+			n++;
+	if (n < getConfNum(_mero_props, "pool")) {
+		s->next = _mero_pool;
+		_mero_pool = s;
+		s = NULL;
+	}
+	pthread_mutex_unlock(&_mero_pool_lock);
+	if (s != NULL)
+		destroyPooledSession(s);
+}
+
+void
+dropPooledSessions(const char *dbname)
+{
+	pooled_session *s, **sp, *drop = NULL;
+
+	pthread_mutex_lock(&_mero_pool_lock);
+	for (sp = &_mero_pool; (s = *sp) != NULL; ) {
+		if (strcmp(s->dbname, dbname) == 0) {
+			*sp = s->next;
+			s->next = drop;
+			drop = s;
+		} else {
+			sp = &s->next;
+		}
+	}
+	pthread_mutex_unlock(&_mero_pool_lock);
+	while ((s = drop) != NULL) {
+		drop = s->next;
+		destroyPooledSession(s);
+	}
+}
+
+/* server to client, until the client is gone and the server sent the
+ * reply to Xchallenge */
+static void *
+pooledServerThread(void *d)
+{
+	pooled_proxy *p = (pooled_proxy *)d;
+	pooled_session *s = p->s;
+	ssize_t len;
+	char data[8 * 1024];
+	bool start = true, forward = true, skip = false, cgone = false;
+	size_t taglen = 0, matched = 0, glen = 0;
+
+#ifdef HAVE_PTHREAD_SETNAME_NP
+	pthread_setname_np(
+#ifndef __APPLE__
+		pthread_self(),
+#endif
+		__func__);
+#endif
+
+	while ((len = mnstr_read(s->in, data, 1, sizeof(data))) >= 0) {
+		if (len == 0 && mnstr_eof(s->in)) {
+			len = -1;
+			break;
+		}
+		if (start && len > 0) {
+			/* whether a message is for the client is decided by its
+			 * start, the challenge is only asked for after the
+			 * client left */
+			pthread_mutex_lock(&p->lock);
+			forward = !p->draining;
+			taglen = strlen(p->tag);
+			pthread_mutex_unlock(&p->lock);
+			skip = false;
+			matched = glen = 0;
+			start = false;
+		}
+		if (forward) {
+			if (cgone)
+				;
+			else if (len > 0 && mnstr_write(p->cout, data, len, 1) != 1)
+				cgone = true;
+			else if (len == 0 && mnstr_flush(p->cout, MNSTR_FLUSH_DATA) == -1)
+				cgone = true;
+		} else if (len == 0) {
+			if (!skip && matched == taglen) {
+				s->greeting[glen] = '\0';
+				break;
+			}
+		} else if (!skip) {
+			char *b = data;
+			size_t n = (size_t) len;
+			if (matched < taglen) {
+				size_t m = taglen - matched;
+				if (n < m)
+					m = n;
+				if (memcmp(b, p->tag + matched, m) != 0) {
+					skip = true;
+					continue;
+				}
+				matched += m;
+				b += m;
+				n -= m;
+			}
+			if (glen + n >= sizeof(s->greeting)) {
+				skip = true;
+			} else {
+				memcpy(s->greeting + glen, b, n);
+				glen += n;
+			}
+		}
+		if (len == 0)
+			start = true;
+	}
+
+	pthread_mutex_lock(&p->lock);
+	p->ready = len >= 0;
+	p->done = true;
+	pthread_cond_signal(&p->cond);
+	pthread_mutex_unlock(&p->lock);
+	if (!p->ready) {
+		/* the server is gone, make the client thread stop too */
+		shutdown(p->csock, SHUT_RDWR);
+	}
+	return NULL;
+}
+
+/* client to server, and when the client is gone, get the connection
+ * ready for the next client */
+static void *
+pooledClientThread(void *d)
+{
+	pooled_proxy *p = (pooled_proxy *)d;
+	pooled_session *s = p->s;
+	ssize_t len;
+	char data[8 * 1024];
+	bool boundary = true;
+
+#ifdef HAVE_PTHREAD_SETNAME_NP
+	pthread_setname_np(
+#ifndef __APPLE__
+		pthread_self(),
+#endif
+		__func__);
+#endif
+
+	while ((len = mnstr_read(p->cin, data, 1, sizeof(data))) >= 0) {
+		if (len == 0 && mnstr_eof(p->cin))
+			break;
+		if (len > 0 && mnstr_write(s->out, data, len, 1) != 1)
+			break;
+		if (len == 0 && mnstr_flush(s->out, MNSTR_FLUSH_DATA) == -1)
+			break;
+		boundary = len == 0;
+	}
+	Mlevelfprintf(DEBUG, stdout, "client %s has disconnected from proxy\n",
+			p->name);
+
+	pthread_mutex_lock(&p->lock);
+	/* only a connection that was left between two messages can be
+	 * used again */
+	if (len >= 0 && boundary && !p->done) {
+		generateSalt(p->tag, 32);
+		strcat(p->tag, "\n");
+		p->draining = true;
+		pthread_mutex_unlock(&p->lock);
+		if (mnstr_printf(s->out, "Xchallenge %s", p->tag) < 0 ||
+			mnstr_flush(s->out, MNSTR_FLUSH_DATA) == -1) {
+			shutdown(s->sock, SHUT_RDWR);
+		} else {
+			struct timespec ts;
+			clock_gettime(CLOCK_REALTIME, &ts);
+			ts.tv_sec += POOL_DRAIN_TIMEOUT;
+			pthread_mutex_lock(&p->lock);
+			while (!p->done) {
+				if (pthread_cond_timedwait(&p->cond, &p->lock, &ts) == ETIMEDOUT)
+					break;
+			}
+			if (!p->done) {
+				/* still busy with the client's queries, give up */
+				Mlevelfprintf(DEBUG, stdout, "connection to database '%s' "
+						"is still busy, closing it\n", s->dbname);
+				shutdown(s->sock, SHUT_RDWR);
+			}
+			pthread_mutex_unlock(&p->lock);
+		}
+	} else {
+		pthread_mutex_unlock(&p->lock);
+		shutdown(s->sock, SHUT_RDWR);
+	}
+
+	pthread_join(p->stoc, NULL);
+	close_stream(p->cout);
+	close_stream(p->cin);
+	if (p->ready)
+		returnPooledSession(s);
+	else
+		destroyPooledSession(s);
+	pthread_mutex_destroy(&p->lock);
+	pthread_cond_destroy(&p->cond);
+	free(p->name);
+	free(p);
+	return NULL;
+}
+
+/* reads a message of at most len - 1 bytes, as a string */
+static ssize_t
+readMessage(stream *in, char *buf, size_t len)
+{
+	ssize_t n = mnstr_read_block(in, buf, 1, len - 1);
+	if (n < 0)
+		return -1;
+	buf[n] = '\0';
+	return n;
+}
+
+/* the login is successful if the server does not reply with an error
+ * or a redirect */
+static bool
+loginSucceeded(const char *reply)
+{
+	for (const char *l = reply; *l; ) {
+		if (*l == '!' || *l == '^')
+			return false;
+		if ((l = strchr(l, '\n')) == NULL)
+			break;
+		l++;
+	}
+	return true;
+}
+
+/* lets the client log in over a pooled connection */
+static err
+reusePooledSession(pooled_session *s, stream *cfdin, stream *cfout,
+				   const char *client)
+{
+	char buf[8096];
+	ssize_t len;
+
+	Mlevelfprintf(DEBUG, stdout, "reusing pooled connection to database '%s' "
+			"for client %s\n", s->dbname, client);
+	if (mnstr_write(cfout, s->greeting, strlen(s->greeting), 1) != 1 ||
+		mnstr_flush(cfout, MNSTR_FLUSH_DATA) == -1 ||
+		(len = readMessage(cfdin, buf, sizeof(buf))) < 0)
+		return newErr("client %s left during login", client);
+	if (mnstr_printf(s->out, "Xreauth %s", buf) < 0 ||
+		mnstr_flush(s->out, MNSTR_FLUSH_DATA) == -1 ||
+		(len = readMessage(s->in, buf, sizeof(buf))) < 0) {
+		mnstr_printf(cfout, "!monetdbd: lost the connection to the "
+				"database server, please try again\n");
+		mnstr_flush(cfout, MNSTR_FLUSH_DATA);
+		return newErr("pooled connection to database '%s' failed: %s",
+				s->dbname, mnstr_peek_error(s->in));
+	}
+	if (mnstr_write(cfout, buf, len, 1) != 1 ||
+		mnstr_flush(cfout, MNSTR_FLUSH_DATA) == -1)
+		return newErr("client %s left during login", client);
+	if (!loginSucceeded(buf))
+		return newErr("client %s failed to log in", client);
+	return NO_ERR;
+}
+
+/* removes the challenge field that starts with opt */
+static void
+stripChallengeField(char *buf, const char *opt)
+{
+	char *p, *q;
+
+	if ((p = strstr(buf, opt)) != NULL) {
+		if ((q = strchr(p + 1, ':')) != NULL)
+			memmove(p + 1, q + 1, strlen(q + 1) + 1);
+		else
+			p[1] = '\0';
+	}
+}
+
+/* passes the login of the client through, without offering
+ * compression, since the proxy needs to read what the server says,
+ * or shared memory, since the proxy holds the server's socket */
+static err
+loginPooledSession(pooled_session *s, stream *cfdin, stream *cfout,
+				   const char *client)
+{
+	char buf[8096];
+	ssize_t len;
+
+	if ((len = readMessage(s->in, buf, sizeof(buf))) < 0)
+		return newErr("no challenge from database '%s': %s",
+				s->dbname, mnstr_peek_error(s->in));
+	stripChallengeField(buf, ":COMPRESS=");
+	stripChallengeField(buf, ":SHM:");
+	if (mnstr_write(cfout, buf, strlen(buf), 1) != 1 ||
+		mnstr_flush(cfout, MNSTR_FLUSH_DATA) == -1 ||
+		(len = readMessage(cfdin, buf, sizeof(buf))) < 0)
+		return newErr("client %s left during login", client);
+	if (mnstr_write(s->out, buf, len, 1) != 1 ||
+		mnstr_flush(s->out, MNSTR_FLUSH_DATA) == -1 ||
+		(len = readMessage(s->in, buf, sizeof(buf))) < 0) {
+		mnstr_printf(cfout, "!monetdbd: lost the connection to the "
+				"database server, please try again\n");
+		mnstr_flush(cfout, MNSTR_FLUSH_DATA);
+		return newErr("connection to database '%s' failed: %s",
+				s->dbname, mnstr_peek_error(s->in));
+	}
+	if (mnstr_write(cfout, buf, len, 1) != 1 ||
+		mnstr_flush(cfout, MNSTR_FLUSH_DATA) == -1)
+		return newErr("client %s left during login", client);
+	if (!loginSucceeded(buf))
+		return newErr("client %s failed to log in", client);
+	return NO_ERR;
+}
+
+static err
+startPooledProxy(pooled_session *s, bool reuse, int psock,
+				 stream *cfdin, stream *cfout, const char *client)
+{
+	pooled_proxy *p;
+	pthread_t ptid;
+	pthread_attr_t detachattr;
+	int thret;
+	err e;
+
+	e = reuse ? reusePooledSession(s, cfdin, cfout, client)
+		: loginPooledSession(s, cfdin, cfout, client);
+	if (e != NO_ERR) {
+		/* the client got its answer already */
+		Mlevelfprintf(DEBUG, stdout, "%s\n", e);
+		free(e);
+		destroyPooledSession(s);
+		close_stream(cfout);
+		close_stream(cfdin);
+		return(NO_ERR);
+	}
+
+	p = malloc(sizeof(pooled_proxy));
+	if (p == NULL) {
+		destroyPooledSession(s);
+		close_stream(cfout);
+		close_stream(cfdin);
+		return(newErr("%s", strerror(errno)));
+	}
+	*p = (pooled_proxy) {
+		.s = s,
+		.csock = psock,
+		.cin = cfdin,
+		.cout = cfout,
+		.name = strdup(client),
+	};
+	pthread_mutex_init(&p->lock, NULL);
+	pthread_cond_init(&p->cond, NULL);
+
+	if ((thret = pthread_create(&p->stoc, NULL,
+				pooledServerThread, (void *)p)) != 0)
+		goto bailout;
+	pthread_attr_init(&detachattr);
+	pthread_attr_setdetachstate(&detachattr, PTHREAD_CREATE_DETACHED);
+	if ((thret = pthread_create(&ptid, &detachattr,
+				pooledClientThread, (void *)p)) != 0) {
+		shutdown(s->sock, SHUT_RDWR);
+		pthread_join(p->stoc, NULL);
+		goto bailout;
+	}
+	return(NO_ERR);
+
+  bailout:
+	destroyPooledSession(s);
+	close_stream(cfout);
+	close_stream(cfdin);
+	pthread_mutex_destroy(&p->lock);
+	pthread_cond_destroy(&p->cond);
+	free(p->name);
+	free(p);
+	Mlevelfprintf(ERROR, stdout, "failed to create proxy thread: %s\n",
+			strerror(thret));
+	return(NO_ERR);
+}
+
+static err
+connectUnixSocket(const char *usock, int *sock)
+{
+	struct sockaddr_un server;
+	int ssock;
+
+	server = (struct sockaddr_un) {
+		.sun_family = AF_UNIX,
+	};
+	strtcpy(server.sun_path, usock, sizeof(server.sun_path));
+	if ((ssock = socket(PF_UNIX, SOCK_STREAM
+#ifdef SOCK_CLOEXEC
+						| SOCK_CLOEXEC
+#endif
+						, 0)) == -1) {
+		return(newErr("cannot open socket: %s", strerror(errno)));
+	}
+#if !defined(SOCK_CLOEXEC) && defined(HAVE_FCNTL)
+	(void) fcntl(ssock, F_SETFD, FD_CLOEXEC);
+#endif
+	if (connect(ssock, (struct sockaddr *) &server, sizeof(struct sockaddr_un)) == -1) {
+		closesocket(ssock);
+		return(newErr("cannot connect: %s", strerror(errno)));
+	}
+	*sock = ssock;
+	return(NO_ERR);
+}
+
+/* connects the client to the server at url; if dbname is set, the
+ * connection to the server goes into the pool of that database when
+ * the client leaves */
 err
 startProxy(int psock, stream *cfdin, stream *cfout,
-		   const char *url, const char *client)
+		   const char *url, const char *client, const char *dbname)
 {
 	int ssock = -1;
 	char *port, *t, *conn = NULL, *endipv6;
@@ -107,6 +597,7 @@ startProxy(int psock, stream *cfdin, stream *cfout,
 	pthread_t ptid;
 	pthread_attr_t detachattr;
 	int thret;
+	pooled_session *ps;
 
 	/* quick 'n' dirty parsing */
 	if (strncmp(url, "mapi:monetdb://", 15) == 0) {
@@ -152,35 +643,39 @@ startProxy(int psock, stream *cfdin, stream *cfout,
 		return(newErr("unsupported protocol/scheme in redirect: %s", url));
 	}
 
-	if (usock != NULL) {
+	/* the server only lets us log in other users over connections that
+	 * we marked with the initial byte on its UNIX socket */
+	if (usock == NULL)
+		dbname = NULL;
+	if (dbname != NULL && (ps = takePooledSession(dbname)) != NULL) {
+		free(conn);
+		return(startPooledProxy(ps, true, psock, cfdin, cfout, client));
+	}
+
+	if (usock != NULL && dbname != NULL) {
+		/* UNIX socket connect, proxy so that the connection can be
+		 * pooled */
+		err e = connectUnixSocket(usock, &ssock);
+		free(conn);
+		if (e != NO_ERR)
+			return(e);
+		if (send(ssock, "2", 1, 0) < 0) {
+			closesocket(ssock);
+			return(newErr("could not send initial byte: %s", strerror(errno)));
+		}
+	} else if (usock != NULL) {
 		/* UNIX socket connect, don't proxy, but pass socket fd */
-		struct sockaddr_un server;
 		struct msghdr msg;
 		char ccmsg[CMSG_SPACE(sizeof(ssock))];
 		struct cmsghdr *cmsg;
 		struct iovec vec;
 		char buf[1];
 		int *c_d;
+		err e = connectUnixSocket(usock, &ssock);
 
-		server = (struct sockaddr_un) {
-			.sun_family = AF_UNIX,
-		};
-		strtcpy(server.sun_path, usock, sizeof(server.sun_path));
 		free(conn);
-		if ((ssock = socket(PF_UNIX, SOCK_STREAM
-#ifdef SOCK_CLOEXEC
-							| SOCK_CLOEXEC
-#endif
-							, 0)) == -1) {
-			return(newErr("cannot open socket: %s", strerror(errno)));
-		}
-#if !defined(SOCK_CLOEXEC) && defined(HAVE_FCNTL)
-		(void) fcntl(ssock, F_SETFD, FD_CLOEXEC);
-#endif
-		if (connect(ssock, (struct sockaddr *) &server, sizeof(struct sockaddr_un)) == -1) {
-			closesocket(ssock);
-			return(newErr("cannot connect: %s", strerror(errno)));
-		}
+		if (e != NO_ERR)
+			return(e);
 
 		/* send first byte, nothing special to happen */
 		msg.msg_name = NULL;
@@ -278,6 +773,25 @@ startProxy(int psock, stream *cfdin, stream *cfout,
 		return(newErr("merovingian-server inputstream or outputstream problems: %s", mnstr_peek_error(NULL)));
 	}
 
+	if (dbname != NULL) {
+		if ((ps = malloc(sizeof(pooled_session))) == NULL) {
+			close_stream(sfout);
+			close_stream(sfdin);
+			return(newErr("%s", strerror(errno)));
+		}
+		*ps = (pooled_session) {
+			.dbname = strdup(dbname),
+			.sock = ssock,
+			.in = sfdin,
+			.out = sfout,
+		};
+		if (ps->dbname == NULL) {
+			destroyPooledSession(ps);
+			return(newErr("%s", strerror(errno)));
+		}
+		return(startPooledProxy(ps, false, psock, cfdin, cfout, client));
+	}
+
 	/* our proxy schematically looks like this:
 	 *
 	 *                  A___>___B
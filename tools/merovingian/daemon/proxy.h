@@ -13,6 +13,7 @@
 
 #include "merovingian.h"
 
-err startProxy(int psock, stream *cfdin, stream *cfout, const char *url, const char *client);
+err startProxy(int psock, stream *cfdin, stream *cfout, const char *url, const char *client, const char *dbname);
+void dropPooledSessions(const char *dbname);
 
 #endif
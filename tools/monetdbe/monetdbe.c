@@ -112,6 +112,8 @@ typedef struct {
 	int retc;
 	monetdbe_database_internal *mdbe;
 	cq *q;
+	void **arrays;	/* parameters bound to an array of values */
+	size_t *counts;	/* and the number of values in it */
 } monetdbe_stmt_internal;
 
 static MT_Lock embedded_lock = MT_LOCK_INITIALIZER(embedded_lock);
@@ -1627,8 +1629,10 @@ monetdbe_prepare(monetdbe_database dbhdl, char* query, monetdbe_statement **stmt
 			stmt_internal->res.nparam = list_length(q->f->ops);
 			stmt_internal->args = (ValPtr*)GDKmalloc(sizeof(ValPtr) * (stmt_internal->res.nparam + stmt_internal->retc));
 			stmt_internal->data = (ValRecord*)GDKzalloc(sizeof(ValRecord) * (stmt_internal->res.nparam+1));
+			stmt_internal->arrays = (void**)GDKzalloc(sizeof(void*) * (stmt_internal->res.nparam+1));
+			stmt_internal->counts = (size_t*)GDKzalloc(sizeof(size_t) * (stmt_internal->res.nparam+1));
 			stmt_internal->res.type = (monetdbe_types*)GDKmalloc(sizeof(monetdbe_types) * (stmt_internal->res.nparam+1));
-			if (!stmt_internal->res.type || !stmt_internal->data || !stmt_internal->args) {
+			if (!stmt_internal->res.type || !stmt_internal->data || !stmt_internal->args || !stmt_internal->arrays || !stmt_internal->counts) {
 				set_error(mdbe, createException(MAL, "monetdbe.monetdbe_prepare", MAL_MALLOC_FAIL));
 			} else if (q->f->ops) {
 				int i = 0;
@@ -1646,6 +1650,8 @@ monetdbe_prepare(monetdbe_database dbhdl, char* query, monetdbe_statement **stmt
 			*stmt = (monetdbe_statement*)stmt_internal;
 		else if (stmt_internal) {
 			GDKfree(stmt_internal->data);
+			GDKfree(stmt_internal->arrays);
+			GDKfree(stmt_internal->counts);
 			GDKfree(stmt_internal->args);
 			GDKfree(stmt_internal->res.type);
 			GDKfree(stmt_internal);
@@ -1667,6 +1673,7 @@ monetdbe_bind(monetdbe_statement *stmt, void *data, size_t i)
 	assert(a);
 	int tpe = a->type.type->localtype;
 	stmt_internal->data[i].vtype = tpe;
+	stmt_internal->arrays[i] = NULL;
 
 	const void* nil = (tpe>=0)?ATOMnilptr(tpe):NULL;
 	if (!data) {
@@ -1721,6 +1728,199 @@ monetdbe_bind(monetdbe_statement *stmt, void *data, size_t i)
 	return MAL_SUCCEED;
 }
 
+char*
+monetdbe_bind_array(monetdbe_statement *stmt, void *data, size_t i, size_t count)
+{
+	monetdbe_stmt_internal *stmt_internal = (monetdbe_stmt_internal*)stmt;
+
+	if (i >= stmt->nparam)
+		return createException(MAL, "monetdbe.monetdbe_bind_array", "Parameter %zu not bound to a value", i);
+	if (!data || count == 0)
+		return createException(MAL, "monetdbe.monetdbe_bind_array", "Parameter %zu bound to an empty array", i);
+	sql_arg *a = (sql_arg*)list_fetch(stmt_internal->q->f->ops, (int) i);
+	assert(a);
+	VALclear(&stmt_internal->data[i]);
+	stmt_internal->data[i].vtype = a->type.type->localtype;
+	stmt_internal->arrays[i] = data;
+	stmt_internal->counts[i] = count;
+	return MAL_SUCCEED;
+}
+
+/* The values of parameter i for a batch, in a BAT of the parameter's type */
+static BAT *
+monetdbe_param_bat(monetdbe_stmt_internal *stmt_internal, size_t i, size_t cnt)
+{
+	monetdbe_database_internal *mdbe = stmt_internal->mdbe;
+	ValPtr v = &stmt_internal->data[i];
+	int tpe = v->vtype;
+	char *data = stmt_internal->arrays[i];
+	BAT *b;
+
+	if (!data) {	/* a single value for all of them */
+		if ((b = BATconstant(0, tpe, VALptr(v), cnt, TRANSIENT)) == NULL)
+			set_error(mdbe, createException(MAL, "monetdbe.monetdbe_execute", GDK_EXCEPTION));
+		return b;
+	}
+	if ((b = COLnew(0, tpe, cnt, TRANSIENT)) == NULL) {
+		set_error(mdbe, createException(MAL, "monetdbe.monetdbe_execute", GDK_EXCEPTION));
+		return NULL;
+	}
+	if (tpe == TYPE_timestamp || tpe == TYPE_date || tpe == TYPE_daytime) {
+		for (size_t j = 0; j < cnt; j++) {
+			timestamp ts;
+			date d;
+			daytime t;
+			const void *p;
+
+			if (tpe == TYPE_timestamp) {
+				monetdbe_data_timestamp *e = (monetdbe_data_timestamp*)data + j;
+				ts = timestamp_is_null(e) ? timestamp_nil : timestamp_from_data(e);
+				p = &ts;
+			} else if (tpe == TYPE_date) {
+				monetdbe_data_date *e = (monetdbe_data_date*)data + j;
+				d = date_is_null(e) ? date_nil : date_from_data(e);
+				p = &d;
+			} else {
+				monetdbe_data_time *e = (monetdbe_data_time*)data + j;
+				t = time_is_null(e) ? daytime_nil : time_from_data(e);
+				p = &t;
+			}
+			if (BUNappend(b, p, false) != GDK_SUCCEED)
+				goto bailout;
+		}
+	} else if (tpe == TYPE_blob) {
+		monetdbe_data_blob *e = (monetdbe_data_blob*)data;
+
+		for (size_t j = 0; j < cnt; j++) {
+			blob *bl = (blob*) ATOMnilptr(TYPE_blob);
+
+			if (!blob_is_null(e + j)) {
+				if ((bl = GDKmalloc(blobsize(e[j].size))) == NULL)
+					goto bailout;
+				bl->nitems = e[j].size;
+				memcpy(bl->data, e[j].data, e[j].size);
+			}
+			gdk_return rc = BUNappend(b, bl, false);
+			if (!blob_is_null(e + j))
+				GDKfree(bl);
+			if (rc != GDK_SUCCEED)
+				goto bailout;
+		}
+	} else if (ATOMstorage(tpe) == TYPE_str) {
+		char **e = (char**)data;
+
+		for (size_t j = 0; j < cnt; j++) {
+			if (e[j] && !checkUTF8(e[j], NULL)) {
+				BBPreclaim(b);
+				set_error(mdbe, createException(MAL, "monetdbe.monetdbe_execute", "Incorrectly encoded UTF-8"));
+				return NULL;
+			}
+			if (BUNappend(b, e[j] ? e[j] : str_nil, false) != GDK_SUCCEED)
+				goto bailout;
+		}
+	} else if (!ATOMvarsized(tpe)) {
+		/* same layout as the monetdbe column of this type */
+		memcpy(Tloc(b, 0), data, cnt * ATOMsize(tpe));
+		BATsetcount(b, cnt);
+		BATnegateprops(b);
+		BATsettrivprop(b);
+	} else {
+		BBPreclaim(b);
+		set_error(mdbe, createException(MAL, "monetdbe.monetdbe_execute", "The internal type '%s' is not supported for parameter arrays", ATOMname(tpe)));
+		return NULL;
+	}
+	return b;
+  bailout:
+	BBPreclaim(b);
+	set_error(mdbe, createException(MAL, "monetdbe.monetdbe_execute", MAL_MALLOC_FAIL));
+	return NULL;
+}
+
+/* Execute a statement for a batch of parameter values. Prepared inserts
+ * which have a bulk variant take all of them in a single call, the others
+ * are executed for one tuple after the other, within the same transaction */
+static char *
+monetdbe_execute_batch(monetdbe_stmt_internal *stmt_internal, size_t cnt, monetdbe_cnt *affected_rows)
+{
+	monetdbe_database_internal *mdbe = stmt_internal->mdbe;
+	backend *b = (backend *) mdbe->c->sqlcontext;
+	cq *q = stmt_internal->q;
+	size_t nparam = stmt_internal->res.nparam;
+	int retc = stmt_internal->retc;
+	BAT **bats = GDKzalloc(sizeof(BAT*) * nparam);
+	ValRecord *vals = GDKzalloc(sizeof(ValRecord) * nparam);
+	ValPtr *args = GDKzalloc(sizeof(ValPtr) * (nparam + retc));
+	MalStkPtr glb = NULL;
+	Symbol s = NULL;
+	lng rows = 0;
+
+	if (!bats || !vals || !args) {
+		set_error(mdbe, createException(MAL, "monetdbe.monetdbe_execute", MAL_MALLOC_FAIL));
+		goto cleanup;
+	}
+	if (q->type == Q_TABLE) {
+		set_error(mdbe, createException(MAL, "monetdbe.monetdbe_execute", "Parameter arrays are not supported for queries"));
+		goto cleanup;
+	}
+	for (size_t i = 0; i < nparam; i++) {
+		if ((bats[i] = monetdbe_param_bat(stmt_internal, i, cnt)) == NULL)
+			goto cleanup;
+		args[i + retc] = &vals[i];
+	}
+	/* the bulk variant is gone once the cache was restarted */
+	if (q->bulk)
+		s = findSymbolInModule(mdbe->c->usermodule, q->bulk->imp);
+	if (s) {
+		for (size_t i = 0; i < nparam; i++)
+			vals[i] = (ValRecord) {
+				.vtype = bats[i]->ttype,
+				.bat = true,
+				.val.bval = bats[i]->batCacheid,
+			};
+		if ((mdbe->msg = callMAL(mdbe->c, s->def, &glb, args)) != MAL_SUCCEED)
+			goto cleanup;
+		rows = b->rowcnt;
+	} else {
+		BATiter *bi = GDKmalloc(sizeof(BATiter) * nparam);
+
+		if (!bi) {
+			set_error(mdbe, createException(MAL, "monetdbe.monetdbe_execute", MAL_MALLOC_FAIL));
+			goto cleanup;
+		}
+		if ((s = findSymbolInModule(mdbe->c->usermodule, q->f->imp)) == NULL) {
+			GDKfree(bi);
+			set_error(mdbe, createException(MAL, "monetdbe.monetdbe_execute", "Prepared statement is no longer valid"));
+			goto cleanup;
+		}
+		for (size_t i = 0; i < nparam; i++)
+			bi[i] = bat_iterator(bats[i]);
+		for (size_t j = 0; j < cnt && mdbe->msg == MAL_SUCCEED; j++) {
+			for (size_t i = 0; i < nparam; i++)
+				VALset(&vals[i], bats[i]->ttype, (ptr) BUNtail(&bi[i], j));
+			/* the stack of the first call is reused */
+			if ((mdbe->msg = callMAL(mdbe->c, s->def, &glb, args)) == MAL_SUCCEED && b->rowcnt > 0)
+				rows += b->rowcnt;
+		}
+		for (size_t i = 0; i < nparam; i++)
+			bat_iterator_end(&bi[i]);
+		GDKfree(bi);
+		if (mdbe->msg != MAL_SUCCEED)
+			goto cleanup;
+	}
+	b->rowcnt = rows;
+	if (affected_rows)
+		*affected_rows = rows;
+
+  cleanup:
+	if (bats)
+		for (size_t i = 0; i < nparam; i++)
+			BBPreclaim(bats[i]);
+	GDKfree(bats);
+	GDKfree(vals);
+	GDKfree(args);
+	return mdbe->msg;
+}
+
 char*
 monetdbe_execute(monetdbe_statement *stmt, monetdbe_result **result, monetdbe_cnt *affected_rows)
 {
@@ -1732,9 +1932,22 @@ monetdbe_execute(monetdbe_statement *stmt, monetdbe_result **result, monetdbe_cn
 	MalStkPtr glb = NULL;
 	cq *q = stmt_internal->q;
 	Symbol s = NULL;
+	bool batch = false;
+	size_t cnt = 0;
 
 	assert(mdbe->c);
 	MT_thread_set_qry_ctx(&mdbe->c->qryctx);
+	/* all parameter arrays must have the same length */
+	for (size_t i = 0; i < stmt->nparam; i++) {
+		if (!stmt_internal->arrays[i])
+			continue;
+		if (batch && stmt_internal->counts[i] != cnt) {
+			set_error(mdbe, createException(MAL, "monetdbe.monetdbe_execute", "Parameter %zu bound to %zu values, but an earlier one to %zu", i, stmt_internal->counts[i], cnt));
+			return mdbe->msg;
+		}
+		cnt = stmt_internal->counts[i];
+		batch = true;
+	}
 	if ((mdbe->msg = SQLtrans(m)) != MAL_SUCCEED)
 		return mdbe->msg;
 
@@ -1746,12 +1959,20 @@ monetdbe_execute(monetdbe_statement *stmt, monetdbe_result **result, monetdbe_cn
 		}
 	}
 
-	s = findSymbolInModule(mdbe->c->usermodule, q->f->imp);
-	if ((mdbe->msg = callMAL(mdbe->c, s->def, &glb, stmt_internal->args)) != MAL_SUCCEED)
-		goto cleanup;
+	if (batch) {
+		if (monetdbe_execute_batch(stmt_internal, cnt, affected_rows) != MAL_SUCCEED)
+			goto cleanup;
+	} else {
+		if ((s = findSymbolInModule(mdbe->c->usermodule, q->f->imp)) == NULL) {
+			set_error(mdbe, createException(MAL, "monetdbe.monetdbe_execute", "Prepared statement is no longer valid"));
+			goto cleanup;
+		}
+		if ((mdbe->msg = callMAL(mdbe->c, s->def, &glb, stmt_internal->args)) != MAL_SUCCEED)
+			goto cleanup;
 
-	if (b->rowcnt >= 0 && affected_rows)
-		*affected_rows = b->rowcnt;
+		if (b->rowcnt >= 0 && affected_rows)
+			*affected_rows = b->rowcnt;
+	}
 
 	if (result) {
 		if ((mdbe->msg = monetdbe_get_results(result, mdbe)) != MAL_SUCCEED) {
@@ -1789,6 +2010,8 @@ monetdbe_cleanup_statement(monetdbe_database dbhdl, monetdbe_statement *stmt)
 	}
 
 	GDKfree(stmt_internal->data);
+	GDKfree(stmt_internal->arrays);
+	GDKfree(stmt_internal->counts);
 	GDKfree(stmt_internal->args);
 	GDKfree(stmt_internal->res.type);
 	GDKfree(stmt_internal);
@@ -1983,6 +2206,1051 @@ cleanup:
 	return mdbe->msg;
 }
 
+/* find the local table to append to and check that appending to it
+ * bypassing the SQL layer is safe */
+static sql_table *
+append_local_table(monetdbe_database_internal *mdbe, mvc *m, const char *schema, const char *table, const char *fcn)
+{
+	char call[64];
+	sql_table *t;
+	sql_part *pt = NULL;
+
+	snprintf(call, sizeof(call), "monetdbe.%s", fcn);
+	if (!(t = find_table_or_view_on_scope(m, NULL, schema, table, "CATALOG", false))) {
+		set_error(mdbe, createException(SQL, call, "%s", m->errstr + 6)); /* Skip error code */
+		return NULL;
+	}
+	if (!insert_allowed(m, t, t->base.name, "APPEND", "append")) {
+		set_error(mdbe, createException(SQL, call, "%s", m->errstr + 6)); /* Skip error code */
+		return NULL;
+	}
+	if ((t->s && t->s->parts && (pt = partition_find_part(m->session->tr, t, NULL))) || isRangePartitionTable(t) || isListPartitionTable(t)) {
+		set_error(mdbe, createException(SQL, call, "Appending to a table from a merge table hierarchy via '%s' is not possible at the moment", fcn));
+		return NULL;
+	}
+	if (t->idxs) {
+		for (node *n = ol_first_node(t->idxs); n; n = n->next) {
+			sql_idx *i = n->data;
+
+			if (i->key) {
+				set_error(mdbe, createException(SQL, call,
+							"Appending to a table with key constraints via '%s' is not possible at the moment", fcn));
+				return NULL;
+			} else if (hash_index(i->type) && list_length(i->columns) > 1) {
+				set_error(mdbe, createException(SQL, call,
+							"Appending to a table with hash indexes referring to more than one column via '%s' is not possible at the moment", fcn));
+				return NULL;
+			} else if (i->type == join_idx) {
+				set_error(mdbe, createException(SQL, call,
+							"Appending to a table with join indexes via '%s' is not possible at the moment", fcn));
+				return NULL;
+			}
+		}
+	}
+	if (t->triggers) {
+		for (node *n = ol_first_node(t->triggers); n; n = n->next) {
+			sql_trigger *trigger = n->data;
+
+			if (trigger->event == 0) { /* insert event */
+				set_error(mdbe, createException(SQL, call,
+							"Appending to a table with triggers at the insert event via '%s' is not possible at the moment", fcn));
+				return NULL;
+			}
+		}
+	}
+	return t;
+}
+
+/* Arrow C data interface
+ *
+ * A result set is exported as a struct array with one child array per
+ * column.  Where the Arrow layout of a column is the layout of its BAT
+ * (integers, floating point, hugeint and decimals stored as hugeint,
+ * time, intervals and uuid) the child array points into the BAT heap
+ * and holds a physical reference to the BAT until the consumer
+ * releases it.  Other columns are converted.  Nil values are marked
+ * in a validity bitmap, which is omitted if the column has no nils. */
+
+typedef struct {
+	char format[32];
+	char *name;
+	struct ArrowSchema **children;
+} arrow_schema_private;
+
+typedef struct {
+	bat bid;					/* BAT whose heap we share, or 0 */
+	void *mem[3];				/* buffers we allocated */
+	const void *buffers[3];
+	struct ArrowArray **children;
+} arrow_array_private;
+
+static void
+arrow_release_schema(struct ArrowSchema *schema)
+{
+	arrow_schema_private *sp = schema->private_data;
+
+	for (int64_t i = 0; i < schema->n_children; i++) {
+		if (sp->children[i]->release)
+			sp->children[i]->release(sp->children[i]);
+		GDKfree(sp->children[i]);
+	}
+	GDKfree(sp->children);
+	GDKfree(sp->name);
+	GDKfree(sp);
+	schema->release = NULL;
+}
+
+static void
+arrow_release_array(struct ArrowArray *array)
+{
+	arrow_array_private *ap = array->private_data;
+
+	for (int64_t i = 0; i < array->n_children; i++) {
+		if (ap->children[i]->release)
+			ap->children[i]->release(ap->children[i]);
+		GDKfree(ap->children[i]);
+	}
+	for (int i = 0; i < 3; i++)
+		GDKfree(ap->mem[i]);
+	if (ap->bid)
+		BBPunfix(ap->bid);
+	GDKfree(ap->children);
+	GDKfree(ap);
+	array->release = NULL;
+}
+
+static arrow_schema_private *
+arrow_init_schema(struct ArrowSchema *schema, const char *name, size_t nchildren)
+{
+	arrow_schema_private *sp = GDKzalloc(sizeof(arrow_schema_private));
+
+	if (sp == NULL)
+		return NULL;
+	if ((sp->name = GDKstrdup(name ? name : "")) == NULL ||
+		(nchildren > 0 && (sp->children = GDKzalloc(nchildren * sizeof(struct ArrowSchema *))) == NULL)) {
+		GDKfree(sp->name);
+		GDKfree(sp);
+		return NULL;
+	}
+	*schema = (struct ArrowSchema) {
+		.format = sp->format,
+		.name = sp->name,
+		.flags = ARROW_FLAG_NULLABLE,
+		.children = sp->children,
+		.release = arrow_release_schema,
+		.private_data = sp,
+	};
+	return sp;
+}
+
+static arrow_array_private *
+arrow_init_array(struct ArrowArray *array, int64_t length, int64_t nbuffers, size_t nchildren)
+{
+	arrow_array_private *ap = GDKzalloc(sizeof(arrow_array_private));
+
+	if (ap == NULL)
+		return NULL;
+	if (nchildren > 0 && (ap->children = GDKzalloc(nchildren * sizeof(struct ArrowArray *))) == NULL) {
+		GDKfree(ap);
+		return NULL;
+	}
+	*array = (struct ArrowArray) {
+		.length = length,
+		.n_buffers = nbuffers,
+		.buffers = ap->buffers,
+		.children = ap->children,
+		.release = arrow_release_array,
+		.private_data = ap,
+	};
+	return ap;
+}
+
+/* can the consumer keep pointing at the heap of the BAT: not if it is
+ * (a view of) a persistent column, which may be updated in place */
+static bool
+arrow_shareable(BAT *b)
+{
+	bat p = VIEWtparent(b);
+
+	return b->ttype != TYPE_void && b->batRole != PERSISTENT &&
+		(p == 0 || BBP_desc(p)->batRole != PERSISTENT);
+}
+
+#define ARROW_VALIDITY(TYPE)											\
+	do {																\
+		const TYPE *v = (const TYPE *) bi->base;						\
+		for (BUN i = 0; i < n; i++) {									\
+			if (is_##TYPE##_nil(v[i]))									\
+				nulls++;												\
+			else														\
+				bits[i >> 3] |= 1 << (i & 7);							\
+		}																\
+	} while (0)
+
+static char *
+arrow_validity(BATiter *bi, arrow_array_private *ap, struct ArrowArray *array)
+{
+	BUN n = bi->count;
+	int64_t nulls = 0;
+	uint8_t *bits;
+
+	if (bi->nonil || n == 0 || bi->type == TYPE_void)
+		return MAL_SUCCEED;
+	if ((bits = GDKzalloc((n + 7) / 8)) == NULL)
+		return createException(MAL, "monetdbe.monetdbe_result_to_arrow", MAL_MALLOC_FAIL);
+	switch (ATOMstorage(bi->type)) {
+	case TYPE_bte:
+		ARROW_VALIDITY(bte);
+		break;
+	case TYPE_sht:
+		ARROW_VALIDITY(sht);
+		break;
+	case TYPE_int:
+		ARROW_VALIDITY(int);
+		break;
+	case TYPE_lng:
+		ARROW_VALIDITY(lng);
+		break;
+#ifdef HAVE_HGE
+	case TYPE_hge:
+		ARROW_VALIDITY(hge);
+		break;
+#endif
+	case TYPE_flt:
+		ARROW_VALIDITY(flt);
+		break;
+	case TYPE_dbl:
+		ARROW_VALIDITY(dbl);
+		break;
+	case TYPE_uuid:
+		ARROW_VALIDITY(uuid);
+		break;
+	default: {
+		const void *nil = ATOMnilptr(bi->type);
+		int (*cmp)(const void *, const void *) = ATOMcompare(bi->type);
+
+		for (BUN i = 0; i < n; i++) {
+			if (cmp(BUNtail(bi, i), nil) == 0)
+				nulls++;
+			else
+				bits[i >> 3] |= 1 << (i & 7);
+		}
+		break;
+	}
+	}
+	if (nulls == 0) {
+		GDKfree(bits);
+		return MAL_SUCCEED;
+	}
+	ap->mem[0] = bits;
+	ap->buffers[0] = bits;
+	array->null_count = nulls;
+	return MAL_SUCCEED;
+}
+
+/* allocate buffer i of the array */
+static void *
+arrow_buffer(arrow_array_private *ap, int i, size_t size)
+{
+	if ((ap->mem[i] = GDKmalloc(size ? size : 1)) != NULL)
+		ap->buffers[i] = ap->mem[i];
+	return ap->mem[i];
+}
+
+/* values in the layout of the BAT: share or copy the heap */
+static char *
+arrow_fixed(BAT *b, BATiter *bi, arrow_array_private *ap)
+{
+	if (arrow_shareable(b)) {
+		if (BBPfix(b->batCacheid) <= 0)
+			return createException(MAL, "monetdbe.monetdbe_result_to_arrow", SQLSTATE(HY002) RUNTIME_OBJECT_MISSING);
+		ap->bid = b->batCacheid;
+		ap->buffers[1] = bi->base;
+		return MAL_SUCCEED;
+	}
+	if (arrow_buffer(ap, 1, bi->count * bi->width) == NULL)
+		return createException(MAL, "monetdbe.monetdbe_result_to_arrow", MAL_MALLOC_FAIL);
+	memcpy(ap->mem[1], bi->base, bi->count * bi->width);
+	return MAL_SUCCEED;
+}
+
+#ifdef WORDS_BIGENDIAN
+#define ARROW_DEC128(d, i, v)	((d)[2 * (i)] = (v) < 0 ? -1 : 0, (d)[2 * (i) + 1] = (v))
+#else
+#define ARROW_DEC128(d, i, v)	((d)[2 * (i)] = (v), (d)[2 * (i) + 1] = (v) < 0 ? -1 : 0)
+#endif
+
+#define ARROW_WIDEN(TYPE)												\
+	do {																\
+		const TYPE *v = (const TYPE *) bi.base;						\
+		for (BUN i = 0; i < n; i++)										\
+			ARROW_DEC128(d, i, is_##TYPE##_nil(v[i]) ? 0 : (int64_t) v[i]); \
+	} while (0)
+
+/* variable sized values: strings, blobs and anything we convert to
+ * its string representation */
+static char *
+arrow_varsized(mvc *m, BATiter *bi, arrow_array_private *ap, char *format)
+{
+	BUN n = bi->count;
+	int64_t *offsets;
+	char *data = NULL, *buf = NULL;
+	size_t datalen = 0, datasize = 0, buflen = 0;
+	int tpe = bi->type;
+	const void *nil = ATOMnilptr(tpe);
+	int (*cmp)(const void *, const void *) = ATOMcompare(tpe);
+
+	if ((offsets = arrow_buffer(ap, 1, (n + 1) * sizeof(int64_t))) == NULL)
+		return createException(MAL, "monetdbe.monetdbe_result_to_arrow", MAL_MALLOC_FAIL);
+	offsets[0] = 0;
+	for (BUN i = 0; i < n; i++) {
+		const void *v = BUNtail(bi, i);
+		const char *s = NULL;
+		size_t len = 0;
+
+		if (cmp(v, nil) == 0) {
+			/* empty */
+		} else if (ATOMstorage(tpe) == TYPE_str) {
+			s = v;
+			len = strlen(s);
+		} else if (tpe == TYPE_blob) {
+			s = (const char *) ((const blob *) v)->data;
+			len = ((const blob *) v)->nitems;
+		} else {
+			ssize_t l = BATatoms[tpe].atomToStr(m->sa, &buf, &buflen, v, true);
+			if (l < 0)
+				return createException(MAL, "monetdbe.monetdbe_result_to_arrow", "Failed to convert element to string");
+			s = buf;
+			len = (size_t) l;
+		}
+		if (datalen + len > datasize) {
+			size_t nsize = MAX(datasize * 2, datalen + len + 1024);
+			char *ndata = GDKrealloc(data, nsize);
+			if (ndata == NULL)
+				return createException(MAL, "monetdbe.monetdbe_result_to_arrow", MAL_MALLOC_FAIL);
+			ap->mem[2] = data = ndata;
+			ap->buffers[2] = data;
+			datasize = nsize;
+		}
+		if (len > 0)
+			memcpy(data + datalen, s, len);
+		datalen += len;
+		offsets[i + 1] = (int64_t) datalen;
+	}
+	if (data == NULL && arrow_buffer(ap, 2, 0) == NULL)
+		return createException(MAL, "monetdbe.monetdbe_result_to_arrow", MAL_MALLOC_FAIL);
+	if (datalen <= INT32_MAX) {
+		/* small enough for 32 bit offsets, compact them in place */
+		int32_t *o32 = (int32_t *) offsets;
+		for (BUN i = 0; i <= n; i++)
+			o32[i] = (int32_t) offsets[i];
+		strcpy(format, tpe == TYPE_blob ? "z" : "u");
+	} else {
+		strcpy(format, tpe == TYPE_blob ? "Z" : "U");
+	}
+	return MAL_SUCCEED;
+}
+
+static char *
+arrow_export_column(mvc *m, BAT *b, sql_subtype *tpe, struct ArrowSchema *schema, struct ArrowArray *array)
+{
+	arrow_schema_private *sp = schema->private_data;
+	arrow_array_private *ap = array->private_data;
+	BATiter bi = bat_iterator(b);
+	BUN n = bi.count;
+	char *msg;
+
+	array->length = (int64_t) n;
+	if ((msg = arrow_validity(&bi, ap, array)) != MAL_SUCCEED)
+		goto bailout;
+#ifdef HAVE_HGE
+	if (tpe->type->eclass == EC_DEC || bi.type == TYPE_hge) {
+#else
+	if (tpe->type->eclass == EC_DEC) {
+#endif
+		/* decimal128, which is also the closest to a hugeint */
+		int64_t *d;
+
+		if (tpe->type->eclass == EC_DEC)
+			snprintf(sp->format, sizeof(sp->format), "d:%u,%u", tpe->digits, tpe->scale);
+		else
+			strcpy(sp->format, "d:38,0");
+#ifdef HAVE_HGE
+		if (bi.type == TYPE_hge) {
+			msg = arrow_fixed(b, &bi, ap);
+			goto bailout;
+		}
+#endif
+		if ((d = arrow_buffer(ap, 1, n * 2 * sizeof(int64_t))) == NULL) {
+			msg = createException(MAL, "monetdbe.monetdbe_result_to_arrow", MAL_MALLOC_FAIL);
+			goto bailout;
+		}
+		switch (bi.type) {
+		case TYPE_bte:
+			ARROW_WIDEN(bte);
+			break;
+		case TYPE_sht:
+			ARROW_WIDEN(sht);
+			break;
+		case TYPE_int:
+			ARROW_WIDEN(int);
+			break;
+		case TYPE_lng:
+			ARROW_WIDEN(lng);
+			break;
+		default:
+			msg = createException(MAL, "monetdbe.monetdbe_result_to_arrow", "Unexpected decimal storage type");
+			break;
+		}
+		goto bailout;
+	}
+	switch (bi.type) {
+	case TYPE_bit: {
+		const bit *v = (const bit *) bi.base;
+		uint8_t *bits;
+
+		strcpy(sp->format, "b");
+		if ((bits = arrow_buffer(ap, 1, (n + 7) / 8)) == NULL) {
+			msg = createException(MAL, "monetdbe.monetdbe_result_to_arrow", MAL_MALLOC_FAIL);
+			break;
+		}
+		memset(bits, 0, (n + 7) / 8);
+		for (BUN i = 0; i < n; i++)
+			if (v[i] == 1)
+				bits[i >> 3] |= 1 << (i & 7);
+		break;
+	}
+	case TYPE_bte:
+	case TYPE_sht:
+	case TYPE_int:
+	case TYPE_lng:
+		if (tpe->type->eclass == EC_MONTH)
+			strcpy(sp->format, "tiM");
+		else if (tpe->type->eclass == EC_SEC)
+			strcpy(sp->format, "tDm");
+		else
+			strcpy(sp->format, bi.type == TYPE_bte ? "c" : bi.type == TYPE_sht ? "s" : bi.type == TYPE_int ? "i" : "l");
+		msg = arrow_fixed(b, &bi, ap);
+		break;
+	case TYPE_flt:
+	case TYPE_dbl:
+		strcpy(sp->format, bi.type == TYPE_flt ? "f" : "g");
+		msg = arrow_fixed(b, &bi, ap);
+		break;
+	case TYPE_void:
+	case TYPE_oid:
+		strcpy(sp->format, "L");
+		if (bi.type == TYPE_oid) {
+			msg = arrow_fixed(b, &bi, ap);
+		} else {
+			uint64_t *d = arrow_buffer(ap, 1, n * sizeof(uint64_t));
+			if (d == NULL) {
+				msg = createException(MAL, "monetdbe.monetdbe_result_to_arrow", MAL_MALLOC_FAIL);
+				break;
+			}
+			for (BUN i = 0; i < n; i++)
+				d[i] = (uint64_t) BUNtoid(b, i);
+		}
+		break;
+	case TYPE_daytime:
+		/* microseconds since midnight */
+		strcpy(sp->format, "ttu");
+		msg = arrow_fixed(b, &bi, ap);
+		break;
+	case TYPE_uuid:
+		strcpy(sp->format, "w:16");
+		msg = arrow_fixed(b, &bi, ap);
+		break;
+	case TYPE_date: {
+		const date *v = (const date *) bi.base;
+		date epoch = date_create(1970, 1, 1);
+		int32_t *d;
+
+		strcpy(sp->format, "tdD");
+		if ((d = arrow_buffer(ap, 1, n * sizeof(int32_t))) == NULL) {
+			msg = createException(MAL, "monetdbe.monetdbe_result_to_arrow", MAL_MALLOC_FAIL);
+			break;
+		}
+		for (BUN i = 0; i < n; i++)
+			d[i] = is_date_nil(v[i]) ? 0 : date_diff(v[i], epoch);
+		break;
+	}
+	case TYPE_timestamp: {
+		const timestamp *v = (const timestamp *) bi.base;
+		int64_t *d;
+
+		strcpy(sp->format, type_has_tz(tpe) ? "tsu:UTC" : "tsu:");
+		if ((d = arrow_buffer(ap, 1, n * sizeof(int64_t))) == NULL) {
+			msg = createException(MAL, "monetdbe.monetdbe_result_to_arrow", MAL_MALLOC_FAIL);
+			break;
+		}
+		for (BUN i = 0; i < n; i++)
+			d[i] = is_timestamp_nil(v[i]) ? 0 : timestamp_diff(v[i], unixepoch);
+		break;
+	}
+	default:
+		array->n_buffers = 3;
+		msg = arrow_varsized(m, &bi, ap, sp->format);
+		break;
+	}
+  bailout:
+	bat_iterator_end(&bi);
+	return msg;
+}
+
+char*
+monetdbe_result_to_arrow(monetdbe_result *mres, struct ArrowSchema *schema, struct ArrowArray *array)
+{
+	monetdbe_result_internal* result = (monetdbe_result_internal*) mres;
+	monetdbe_database_internal *mdbe = result->mdbe;
+	mvc *m = NULL;
+	arrow_schema_private *sp;
+	arrow_array_private *ap;
+
+	if ((mdbe->msg = validate_database_handle(mdbe, "monetdbe.monetdbe_result_to_arrow")) != MAL_SUCCEED)
+		return mdbe->msg;
+	if ((mdbe->msg = getSQLContext(mdbe->c, NULL, &m, NULL)) != MAL_SUCCEED)
+		return mdbe->msg;
+	if (!schema || !array) {
+		set_error(mdbe, createException(MAL, "monetdbe.monetdbe_result_to_arrow", "Parameter schema or array is NULL"));
+		goto cleanup;
+	}
+	schema->release = NULL;
+	array->release = NULL;
+	if ((sp = arrow_init_schema(schema, "", mres->ncols)) == NULL ||
+		(ap = arrow_init_array(array, mres->nrows, 1, mres->ncols)) == NULL) {
+		set_error(mdbe, createException(MAL, "monetdbe.monetdbe_result_to_arrow", MAL_MALLOC_FAIL));
+		goto cleanup;
+	}
+	strcpy(sp->format, "+s");
+	for (size_t i = 0; i < mres->ncols; i++) {
+		res_col *col = result->monetdbe_resultset->cols + i;
+		struct ArrowSchema *cs;
+		struct ArrowArray *ca;
+		BAT *b;
+
+		if ((cs = GDKzalloc(sizeof(struct ArrowSchema))) == NULL) {
+			set_error(mdbe, createException(MAL, "monetdbe.monetdbe_result_to_arrow", MAL_MALLOC_FAIL));
+			goto cleanup;
+		}
+		sp->children[schema->n_children++] = cs;
+		if ((ca = GDKzalloc(sizeof(struct ArrowArray))) == NULL) {
+			set_error(mdbe, createException(MAL, "monetdbe.monetdbe_result_to_arrow", MAL_MALLOC_FAIL));
+			goto cleanup;
+		}
+		ap->children[array->n_children++] = ca;
+		if (arrow_init_schema(cs, col->name, 0) == NULL ||
+			arrow_init_array(ca, 0, 2, 0) == NULL) {
+			set_error(mdbe, createException(MAL, "monetdbe.monetdbe_result_to_arrow", MAL_MALLOC_FAIL));
+			goto cleanup;
+		}
+		if ((b = BATdescriptor(col->b)) == NULL) {
+			set_error(mdbe, createException(MAL, "monetdbe.monetdbe_result_to_arrow", SQLSTATE(HY002) RUNTIME_OBJECT_MISSING));
+			goto cleanup;
+		}
+		set_error(mdbe, arrow_export_column(m, b, &col->type, cs, ca));
+		BBPunfix(b->batCacheid);
+		if (mdbe->msg)
+			goto cleanup;
+	}
+cleanup:
+	if (mdbe->msg) {
+		if (schema && schema->release)
+			schema->release(schema);
+		if (array && array->release)
+			array->release(array);
+	}
+	mdbe->msg = commit_action(m, mdbe, NULL, NULL);
+	return mdbe->msg;
+}
+
+/* Appending an Arrow struct array
+ *
+ * Each child array is handed to the storage layer as an array of values
+ * of the type of the table column.  If its Arrow layout is the layout
+ * of that type and it has no nulls, that is the Arrow buffer itself,
+ * otherwise the values are converted first. */
+
+#ifdef HAVE_HGE
+typedef hge arrow_int;
+#define ARROW_INT_MAX GDK_hge_max
+#else
+typedef lng arrow_int;
+#define ARROW_INT_MAX GDK_lng_max
+#endif
+
+typedef struct {
+	char kind;		/* 'i'nteger, 'd'ecimal, 'D'ate, 't'ime, 'T'imestamp, 'I'nterval, 'M'onths */
+	bool uns;		/* unsigned integer */
+	int width;		/* bytes per value */
+	int scale;		/* of decimals */
+	int64_t unit;	/* units per second (per day for dates) of temporal values */
+} arrow_numeric;
+
+/* parse the format of an Arrow array whose values are integers */
+static bool
+arrow_parse_numeric(const char *f, arrow_numeric *an)
+{
+	static const char units[] = "smun";
+	const char *u;
+
+	*an = (arrow_numeric) {0};
+	if (f[0] && f[1] == 0 && strchr("cCsSiIlL", f[0])) {
+		an->kind = 'i';
+		an->uns = isupper((unsigned char) f[0]);
+		switch (tolower((unsigned char) f[0])) {
+		case 'c': an->width = 1; break;
+		case 's': an->width = 2; break;
+		case 'i': an->width = 4; break;
+		default: an->width = 8; break;
+		}
+		return true;
+	}
+	if (strncmp(f, "d:", 2) == 0) {
+		int precision, bitwidth = 128;
+
+		if (sscanf(f, "d:%d,%d,%d", &precision, &an->scale, &bitwidth) < 2 ||
+			an->scale < 0 ||
+			(bitwidth != 32 && bitwidth != 64 && bitwidth != 128))
+			return false;
+		an->kind = 'd';
+		an->width = bitwidth / 8;
+		return true;
+	}
+	if (strcmp(f, "tdD") == 0 || strcmp(f, "tdm") == 0) {
+		an->kind = 'D';
+		an->width = f[2] == 'D' ? 4 : 8;
+		an->unit = f[2] == 'D' ? 1 : DAY_USEC / 1000;
+		return true;
+	}
+	if (strcmp(f, "tiM") == 0) {
+		an->kind = 'M';
+		an->width = 4;
+		return true;
+	}
+	if (f[0] != 't' || f[1] == 0 || f[2] == 0 || (u = strchr(units, f[2])) == NULL)
+		return false;
+	an->unit = 1;
+	for (const char *p = units; p < u; p++)
+		an->unit *= 1000;
+	switch (f[1]) {
+	case 't':
+		an->kind = 't';
+		an->width = an->unit <= 1000 ? 4 : 8;
+		return f[3] == 0;
+	case 's':
+		an->kind = 'T';
+		an->width = 8;
+		return f[3] == ':';
+	case 'D':
+		an->kind = 'I';
+		an->width = 8;
+		return f[3] == 0;
+	default:
+		return false;
+	}
+}
+
+static inline bool
+arrow_valid(const uint8_t *bits, int64_t j)
+{
+	return bits == NULL || (bits[j >> 3] >> (j & 7)) & 1;
+}
+
+/* value j of an array of integers */
+static bool
+arrow_get_int(const void *buf, const arrow_numeric *an, int64_t j, arrow_int *v)
+{
+	switch (an->width) {
+	case 1:
+		*v = an->uns ? (arrow_int) ((const uint8_t *) buf)[j] : (arrow_int) ((const int8_t *) buf)[j];
+		return true;
+	case 2:
+		*v = an->uns ? (arrow_int) ((const uint16_t *) buf)[j] : (arrow_int) ((const int16_t *) buf)[j];
+		return true;
+	case 4:
+		*v = an->uns ? (arrow_int) ((const uint32_t *) buf)[j] : (arrow_int) ((const int32_t *) buf)[j];
+		return true;
+	case 8:
+		if (an->uns) {
+			uint64_t u = ((const uint64_t *) buf)[j];
+#ifndef HAVE_HGE
+			if (u > (uint64_t) GDK_lng_max)
+				return false;
+#endif
+			*v = (arrow_int) u;
+		} else {
+			*v = ((const int64_t *) buf)[j];
+		}
+		return true;
+	default: {
+		const int64_t *d = (const int64_t *) buf + 2 * j;
+#ifdef WORDS_BIGENDIAN
+		int64_t hi = d[0];
+		uint64_t lo = (uint64_t) d[1];
+#else
+		int64_t hi = d[1];
+		uint64_t lo = (uint64_t) d[0];
+#endif
+#ifdef HAVE_HGE
+		*v = (hge) hi * ((hge) 1 << 64) + (hge) lo;
+		return true;
+#else
+		if (hi != ((int64_t) lo < 0 ? -1 : 0))
+			return false;
+		*v = (lng) lo;
+		return true;
+#endif
+	}
+	}
+}
+
+/* multiply by a power of 10, checking for overflow */
+static bool
+arrow_upscale(arrow_int *v, int digits)
+{
+	for (; digits > 0; digits--) {
+		if (*v > ARROW_INT_MAX / 10 || *v < -ARROW_INT_MAX / 10)
+			return false;
+		*v *= 10;
+	}
+	return true;
+}
+
+/* store value i in an array of type tpe, excluding the nil value */
+static bool
+arrow_put_int(void *dst, int tpe, BUN i, arrow_int v)
+{
+	switch (ATOMstorage(tpe)) {
+	case TYPE_bte:
+		if (v < GDK_bte_min || v > GDK_bte_max)
+			return false;
+		((bte *) dst)[i] = (bte) v;
+		return true;
+	case TYPE_sht:
+		if (v < GDK_sht_min || v > GDK_sht_max)
+			return false;
+		((sht *) dst)[i] = (sht) v;
+		return true;
+	case TYPE_int:
+		if (v < GDK_int_min || v > GDK_int_max)
+			return false;
+		((int *) dst)[i] = (int) v;
+		return true;
+	case TYPE_lng:
+		if (v < GDK_lng_min || v > GDK_lng_max)
+			return false;
+		((lng *) dst)[i] = (lng) v;
+		return true;
+#ifdef HAVE_HGE
+	case TYPE_hge:
+		if (is_hge_nil(v))
+			return false;
+		((hge *) dst)[i] = v;
+		return true;
+#endif
+	default:
+		return false;
+	}
+}
+
+/* is the Arrow layout the layout of the column type */
+static bool
+arrow_same_layout(sql_column *c, const char *f)
+{
+	sql_class ec = c->type.type->eclass;
+
+	switch (c->type.type->localtype) {
+	case TYPE_bte:
+		return ec != EC_DEC && strcmp(f, "c") == 0;
+	case TYPE_sht:
+		return ec != EC_DEC && strcmp(f, "s") == 0;
+	case TYPE_int:
+		return ec == EC_MONTH ? strcmp(f, "tiM") == 0 : ec != EC_DEC && strcmp(f, "i") == 0;
+	case TYPE_lng:
+		return ec == EC_SEC ? strcmp(f, "tDm") == 0 : ec != EC_DEC && strcmp(f, "l") == 0;
+#ifdef HAVE_HGE
+	case TYPE_hge: {
+		arrow_numeric an;
+		return arrow_parse_numeric(f, &an) && an.kind == 'd' && an.width == 16 &&
+			an.scale == (ec == EC_DEC ? (int) c->type.scale : 0);
+	}
+#endif
+	case TYPE_flt:
+		return strcmp(f, "f") == 0;
+	case TYPE_dbl:
+		return strcmp(f, "g") == 0;
+	default:
+		if (c->type.type->localtype == TYPE_daytime)
+			return strcmp(f, "ttu") == 0;
+		if (c->type.type->localtype == TYPE_uuid)
+			return strcmp(f, "w:16") == 0;
+		return false;
+	}
+}
+
+/* convert values of an Arrow array stored as integers */
+static char *
+arrow_import_numeric(sql_column *c, const arrow_numeric *an, const struct ArrowArray *a, int64_t o, BUN cnt, void *d)
+{
+	const uint8_t *bits = a->buffers[0];
+	const void *buf = a->buffers[1];
+	int mtype = c->type.type->localtype;
+	sql_class ec = c->type.type->eclass;
+	const void *nil = ATOMnilptr(mtype);
+	size_t width = ATOMsize(mtype);
+	date epoch = date_create(1970, 1, 1);
+
+	if (mtype == TYPE_date ? an->kind != 'D' :
+		mtype == TYPE_daytime ? an->kind != 't' :
+		mtype == TYPE_timestamp ? an->kind != 'T' :
+		ec == EC_MONTH ? an->kind != 'M' && an->kind != 'i' :
+		ec == EC_SEC ? an->kind != 'I' :
+		an->kind != 'i' && an->kind != 'd')
+		return createException(SQL, "monetdbe.monetdbe_append_arrow", "Cannot append Arrow values into column '%s'", c->base.name);
+	if (an->kind == 'd' && an->scale > (ec == EC_DEC ? (int) c->type.scale : 0))
+		return createException(SQL, "monetdbe.monetdbe_append_arrow", "Cannot append Arrow decimals with scale %d into column '%s'", an->scale, c->base.name);
+
+	for (BUN i = 0; i < cnt; i++) {
+		int64_t j = o + (int64_t) i;
+		arrow_int v;
+		bool ok = true;
+
+		if (!arrow_valid(bits, j)) {
+			memcpy((char *) d + i * width, nil, width);
+			continue;
+		}
+		if (!arrow_get_int(buf, an, j, &v))
+			ok = false;
+		else if (mtype == TYPE_date) {
+			/* days since the epoch */
+			lng days = (lng) (v / an->unit - (v % an->unit < 0));
+			date dt = days < -GDK_int_max || days > GDK_int_max ? date_nil : date_add_day(epoch, (int) days);
+			ok = !is_date_nil(dt);
+			((date *) d)[i] = dt;
+		} else if (mtype == TYPE_daytime) {
+			v = v * 1000000 / an->unit;
+			ok = v >= 0 && v < DAY_USEC;
+			((daytime *) d)[i] = (daytime) v;
+		} else if (mtype == TYPE_timestamp) {
+			/* microseconds since the epoch */
+			timestamp ts = timestamp_nil;
+			if (an->unit > 1000000)
+				v = v / 1000 - (v % 1000 < 0);
+			else
+				ok = arrow_upscale(&v, an->unit == 1 ? 6 : an->unit == 1000 ? 3 : 0);
+			if (ok && v >= GDK_lng_min && v <= GDK_lng_max)
+				ts = timestamp_add_usec(unixepoch, (lng) v);
+			ok = !is_timestamp_nil(ts);
+			((timestamp *) d)[i] = ts;
+		} else if (ec == EC_SEC) {
+			/* milliseconds */
+			if (an->unit > 1000)
+				v /= an->unit / 1000;
+			else
+				ok = arrow_upscale(&v, an->unit == 1 ? 3 : 0);
+			ok = ok && arrow_put_int(d, mtype, i, v);
+		} else {
+			ok = arrow_upscale(&v, (ec == EC_DEC ? (int) c->type.scale : 0) - an->scale) &&
+				arrow_put_int(d, mtype, i, v);
+		}
+		if (!ok)
+			return createException(SQL, "monetdbe.monetdbe_append_arrow", "Value out of range for column '%s'", c->base.name);
+	}
+	return MAL_SUCCEED;
+}
+
+/* the values of child array a for column c as an array that can be
+ * passed to the storage layer; anything we allocate is put in mem */
+static char *
+arrow_import_column(sql_column *c, const struct ArrowSchema *s, const struct ArrowArray *a, int64_t offset, BUN cnt, const void **vals, void **mem)
+{
+	int mtype = c->type.type->localtype;
+	const char *f = s->format;
+	const uint8_t *bits = a->buffers[0];
+	int64_t o = offset + a->offset;
+	const void *nil = ATOMnilptr(mtype);
+	arrow_numeric an;
+
+	if (a->length < offset + (int64_t) cnt)
+		return createException(SQL, "monetdbe.monetdbe_append_arrow", "Number of values don't match between columns");
+	if (a->null_count == 0)
+		bits = NULL;
+	if (bits == NULL && arrow_same_layout(c, f)) {
+		/* no conversion needed */
+		*vals = (const char *) a->buffers[1] + o * ATOMsize(mtype);
+		return MAL_SUCCEED;
+	}
+	if (mtype == TYPE_str || mtype == TYPE_blob) {
+		const char *data = a->buffers[2];
+		bool large = f[0] == 'U' || f[0] == 'Z';
+		char *buf, **ptrs;
+		size_t len = 0;
+
+		if (strcmp(f, mtype == TYPE_str ? "u" : "z") != 0 && strcmp(f, mtype == TYPE_str ? "U" : "Z") != 0)
+			return createException(SQL, "monetdbe.monetdbe_append_arrow", "Cannot append Arrow values into column '%s'", c->base.name);
+#define OFFSET(j)	(large ? ((const int64_t *) a->buffers[1])[j] : (int64_t) ((const int32_t *) a->buffers[1])[j])
+		/* room for the strings with their terminating NUL or for
+		 * the blobs with their size, suitably aligned */
+		for (BUN i = 0; i < cnt; i++)
+			if (arrow_valid(bits, o + (int64_t) i))
+				len += mtype == TYPE_str ? (size_t) (OFFSET(o + i + 1) - OFFSET(o + i)) + 1 :
+					(blobsize((size_t) (OFFSET(o + i + 1) - OFFSET(o + i))) + 7) & ~(size_t) 7;
+		if ((mem[0] = ptrs = GDKmalloc(cnt * sizeof(char *))) == NULL ||
+			(mem[1] = buf = GDKmalloc(len ? len : 1)) == NULL)
+			return createException(MAL, "monetdbe.monetdbe_append_arrow", MAL_MALLOC_FAIL);
+		for (BUN i = 0; i < cnt; i++) {
+			int64_t j = o + (int64_t) i;
+			size_t l;
+
+			if (!arrow_valid(bits, j)) {
+				ptrs[i] = (char *) nil;
+				continue;
+			}
+			l = (size_t) (OFFSET(j + 1) - OFFSET(j));
+			if (mtype == TYPE_str) {
+				memcpy(buf, data + OFFSET(j), l);
+				buf[l] = 0;
+				if (!checkUTF8(buf, NULL))
+					return createException(SQL, "monetdbe.monetdbe_append_arrow", "Incorrectly encoded UTF-8");
+				ptrs[i] = buf;
+				buf += l + 1;
+			} else {
+				blob *b = (blob *) buf;
+				b->nitems = l;
+				memcpy(b->data, data + OFFSET(j), l);
+				ptrs[i] = buf;
+				buf += (blobsize(l) + 7) & ~(size_t) 7;
+			}
+		}
+#undef OFFSET
+		*vals = ptrs;
+		return MAL_SUCCEED;
+	}
+
+	size_t width = ATOMsize(mtype);
+	void *d;
+
+	if ((mem[0] = d = GDKmalloc(cnt ? cnt * width : 1)) == NULL)
+		return createException(MAL, "monetdbe.monetdbe_append_arrow", MAL_MALLOC_FAIL);
+	*vals = d;
+	if (mtype == TYPE_bit && strcmp(f, "b") == 0) {
+		for (BUN i = 0; i < cnt; i++) {
+			int64_t j = o + (int64_t) i;
+			((bit *) d)[i] = arrow_valid(bits, j) ? arrow_valid(a->buffers[1], j) : bit_nil;
+		}
+		return MAL_SUCCEED;
+	}
+	if ((mtype == TYPE_flt || mtype == TYPE_dbl) && (strcmp(f, "f") == 0 || strcmp(f, "g") == 0)) {
+		for (BUN i = 0; i < cnt; i++) {
+			int64_t j = o + (int64_t) i;
+			dbl v = f[0] == 'f' ? ((const flt *) a->buffers[1])[j] : ((const dbl *) a->buffers[1])[j];
+			if (!arrow_valid(bits, j))
+				v = dbl_nil;
+			if (mtype == TYPE_flt)
+				((flt *) d)[i] = is_dbl_nil(v) ? flt_nil : (flt) v;
+			else
+				((dbl *) d)[i] = v;
+		}
+		return MAL_SUCCEED;
+	}
+	if (arrow_same_layout(c, f)) {
+		/* same layout, but the nulls need their nil values */
+		for (BUN i = 0; i < cnt; i++) {
+			int64_t j = o + (int64_t) i;
+			memcpy((char *) d + i * width, arrow_valid(bits, j) ? (const char *) a->buffers[1] + j * width : nil, width);
+		}
+		return MAL_SUCCEED;
+	}
+	if (mtype != TYPE_bit && mtype != TYPE_flt && mtype != TYPE_dbl && mtype != TYPE_uuid &&
+		arrow_parse_numeric(f, &an))
+		return arrow_import_numeric(c, &an, a, o, cnt, d);
+	return createException(SQL, "monetdbe.monetdbe_append_arrow", "Cannot append Arrow values of format '%s' into column '%s'", f, c->base.name);
+}
+
+char*
+monetdbe_append_arrow(monetdbe_database dbhdl, const char *schema, const char *table, struct ArrowSchema *aschema, struct ArrowArray *array)
+{
+	monetdbe_database_internal *mdbe = (monetdbe_database_internal*)dbhdl;
+	mvc *m = NULL;
+	sql_table *t = NULL;
+	size_t i;
+	BUN cnt, offset;
+	node *n;
+	BAT *pos = NULL;
+
+	if ((mdbe->msg = validate_database_handle(mdbe, "monetdbe.monetdbe_append_arrow")) != MAL_SUCCEED)
+		return mdbe->msg;
+	if ((mdbe->msg = getSQLContext(mdbe->c, NULL, &m, NULL)) != MAL_SUCCEED)
+		return mdbe->msg;
+	sqlstore *store = m->session->tr->store;
+
+	if (table == NULL) {
+		set_error(mdbe, createException(MAL, "monetdbe.monetdbe_append_arrow", "table parameter is NULL"));
+		goto cleanup;
+	}
+	if (aschema == NULL || array == NULL || aschema->release == NULL || array->release == NULL) {
+		set_error(mdbe, createException(MAL, "monetdbe.monetdbe_append_arrow", "schema or array parameter is NULL or released"));
+		goto cleanup;
+	}
+	if (strcmp(aschema->format, "+s") != 0 || aschema->n_children != array->n_children) {
+		set_error(mdbe, createException(MAL, "monetdbe.monetdbe_append_arrow", "Array must be a struct array"));
+		goto cleanup;
+	}
+	if (array->null_count != 0 && array->buffers[0] != NULL) {
+		set_error(mdbe, createException(MAL, "monetdbe.monetdbe_append_arrow", "Array must not contain null rows"));
+		goto cleanup;
+	}
+	if (mdbe->mid) {
+		set_error(mdbe, createException(MAL, "monetdbe.monetdbe_append_arrow", "Appending Arrow arrays to a remote database is not supported"));
+		goto cleanup;
+	}
+	if ((mdbe->msg = SQLtrans(m)) != MAL_SUCCEED)
+		goto cleanup;
+	if ((t = append_local_table(mdbe, m, schema, table, "monetdbe_append_arrow")) == NULL)
+		goto cleanup;
+	/* for now no default values, ie user should supply all columns */
+	if (aschema->n_children != ol_length(t->columns)) {
+		set_error(mdbe, createException(SQL, "monetdbe.monetdbe_append_arrow", "Incorrect number of columns"));
+		goto cleanup;
+	}
+
+	cnt = (BUN) array->length;
+	if (store->storage_api.claim_tab(m->session->tr, t, cnt, &offset, &pos) != LOG_OK) {
+		set_error(mdbe, createException(MAL, "monetdbe.monetdbe_append_arrow", "Claim failed"));
+		goto cleanup;
+	}
+	/* signal an insert was made on the table */
+	if (!isNew(t) && isGlobal(t) && !isGlobalTemp(t) && sql_trans_add_dependency_change(m->session->tr, t->base.id, dml) != LOG_OK) {
+		set_error(mdbe, createException(SQL, "monetdbe.monetdbe_append_arrow", MAL_MALLOC_FAIL));
+		goto cleanup;
+	}
+
+	for (i = 0, n = ol_first_node(t->columns); n; i++, n = n->next) {
+		sql_column *c = n->data;
+		const void *vals = NULL;
+		void *mem[2] = {NULL, NULL};
+		char *msg;
+
+		msg = arrow_import_column(c, aschema->children[i], array->children[i], array->offset, cnt, &vals, mem);
+		if (msg == MAL_SUCCEED &&
+			store->storage_api.append_col(m->session->tr, c, offset, pos, (void *) vals, cnt, false, c->type.type->localtype) != 0)
+			msg = createException(SQL, "monetdbe.monetdbe_append_arrow", "Cannot append values");
+		GDKfree(mem[0]);
+		GDKfree(mem[1]);
+		if (msg) {
+			set_error(mdbe, msg);
+			goto cleanup;
+		}
+	}
+
+cleanup:
+	if (pos)
+		BBPreclaim(pos);
+	mdbe->msg = commit_action(m, mdbe, NULL, NULL);
+	return mdbe->msg;
+}
+
 #define GENERATE_BASE_HEADERS(type, tpename) \
 	static int tpename##_is_null(type *value)
 
@@ -2261,52 +3529,10 @@ remote_cleanup:
 	} else {
 		// !mdbe->mid
 		// inserting into existing local table.
-		sql_part *pt = NULL;
-
 		if ((mdbe->msg = SQLtrans(m)) != MAL_SUCCEED)
 			goto cleanup;
-		if (!(t = find_table_or_view_on_scope(m, NULL, schema, table, "CATALOG", false))) {
-			set_error(mdbe, createException(SQL, "monetdbe.monetdbe_append", "%s", m->errstr + 6)); /* Skip error code */
+		if ((t = append_local_table(mdbe, m, schema, table, "monetdbe_append")) == NULL)
 			goto cleanup;
-		}
-		if (!insert_allowed(m, t, t->base.name, "APPEND", "append")) {
-			set_error(mdbe, createException(SQL, "monetdbe.monetdbe_append", "%s", m->errstr + 6)); /* Skip error code */
-			goto cleanup;
-		}
-		if ((t->s && t->s->parts && (pt = partition_find_part(m->session->tr, t, NULL))) || isRangePartitionTable(t) || isListPartitionTable(t)) {
-			set_error(mdbe, createException(SQL, "monetdbe.monetdbe_append", "Appending to a table from a merge table hierarchy via 'monetdbe_append' is not possible at the moment"));
-			goto cleanup;
-		}
-		if (t->idxs) {
-			for (node *n = ol_first_node(t->idxs); n; n = n->next) {
-				sql_idx *i = n->data;
-
-				if (i->key) {
-					set_error(mdbe, createException(SQL, "monetdbe.monetdbe_append",
-								"Appending to a table with key constraints via 'monetdbe_append' is not possible at the moment"));
-					goto cleanup;
-				} else if (hash_index(i->type) && list_length(i->columns) > 1) {
-					set_error(mdbe, createException(SQL, "monetdbe.monetdbe_append",
-								"Appending to a table with hash indexes referring to more than one column via 'monetdbe_append' is not possible at the moment"));
-					goto cleanup;
-				} else if (i->type == join_idx) {
-					set_error(mdbe, createException(SQL, "monetdbe.monetdbe_append",
-								"Appending to a table with join indexes via 'monetdbe_append' is not possible at the moment"));
-					goto cleanup;
-				}
-			}
-		}
-		if (t->triggers) {
-			for (n = ol_first_node(t->triggers); n; n = n->next) {
-				sql_trigger *trigger = n->data;
-
-				if (trigger->event == 0) { /* insert event */
-					set_error(mdbe, createException(SQL, "monetdbe.monetdbe_append",
-								"Appending to a table with triggers at the insert event via 'monetdbe_append' is not possible at the moment"));
-					goto cleanup;
-				}
-			}
-		}
 	}
 
 	/* for now no default values, ie user should supply all columns */
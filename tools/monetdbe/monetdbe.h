@@ -155,6 +155,50 @@ DEFAULT_STRUCT_DEFINITION(monetdbe_data_time, time);
 DEFAULT_STRUCT_DEFINITION(monetdbe_data_timestamp, timestamp);
 // UUID, INET, XML ?
 
+/* Apache Arrow C data interface, see
+ * https://arrow.apache.org/docs/format/CDataInterface.html */
+#ifndef ARROW_C_DATA_INTERFACE
+#define ARROW_C_DATA_INTERFACE
+
+#define ARROW_FLAG_DICTIONARY_ORDERED 1
+#define ARROW_FLAG_NULLABLE 2
+#define ARROW_FLAG_MAP_KEYS_SORTED 4
+
+struct ArrowSchema {
+	// Array type description
+	const char *format;
+	const char *name;
+	const char *metadata;
+	int64_t flags;
+	int64_t n_children;
+	struct ArrowSchema **children;
+	struct ArrowSchema *dictionary;
+
+	// Release callback
+	void (*release)(struct ArrowSchema *);
+	// Opaque producer-specific data
+	void *private_data;
+};
+
+struct ArrowArray {
+	// Array data description
+	int64_t length;
+	int64_t null_count;
+	int64_t offset;
+	int64_t n_buffers;
+	int64_t n_children;
+	const void **buffers;
+	struct ArrowArray **children;
+	struct ArrowArray *dictionary;
+
+	// Release callback
+	void (*release)(struct ArrowArray *);
+	// Opaque producer-specific data
+	void *private_data;
+};
+
+#endif	// ARROW_C_DATA_INTERFACE
+
 monetdbe_export const char *monetdbe_version(void);
 
 monetdbe_export int   monetdbe_open(monetdbe_database *db, char *url, monetdbe_options *opts);
@@ -173,12 +217,27 @@ monetdbe_export char* monetdbe_cleanup_result(monetdbe_database dbhdl, monetdbe_
 
 monetdbe_export char* monetdbe_prepare(monetdbe_database dbhdl, char *query, monetdbe_statement **stmt, monetdbe_result** result);
 monetdbe_export char* monetdbe_bind(monetdbe_statement *stmt, void *data, size_t parameter_nr);
+/* Bind a parameter to an array of count values, laid out as the data of a
+ * monetdbe_column of the parameter's type. The statement then executes for
+ * every tuple of values; parameters bound to a single value keep it for all
+ * of them, and all arrays must have the same length. Prepared
+ * INSERT INTO .. VALUES statements insert the whole batch at once. */
+monetdbe_export char* monetdbe_bind_array(monetdbe_statement *stmt, void *data, size_t parameter_nr, size_t count);
 monetdbe_export char* monetdbe_execute(monetdbe_statement *stmt, monetdbe_result **result, monetdbe_cnt* affected_rows);
 monetdbe_export char* monetdbe_cleanup_statement(monetdbe_database dbhdl, monetdbe_statement *stmt);
 
 monetdbe_export char* monetdbe_append(monetdbe_database dbhdl, const char* schema, const char* table, monetdbe_column **input, size_t column_count);
 monetdbe_export const void* monetdbe_null(monetdbe_database dbhdl, monetdbe_types t);
 
+/* Export a result set as an Arrow struct array with one child per
+ * column.  Columns whose layout equals the Arrow layout are not copied;
+ * the arrays keep the underlying storage alive until they are released,
+ * which must happen before the database is closed. */
+monetdbe_export char* monetdbe_result_to_arrow(monetdbe_result *mres, struct ArrowSchema *schema, struct ArrowArray *array);
+/* Append an Arrow struct array to a table.  The caller keeps ownership
+ * of the array and releases it afterwards. */
+monetdbe_export char* monetdbe_append_arrow(monetdbe_database dbhdl, const char *schema, const char *table, struct ArrowSchema *aschema, struct ArrowArray *array);
+
 monetdbe_export char* monetdbe_get_columns(monetdbe_database dbhdl, const char* schema_name, const char *table_name, size_t *column_count, monetdbe_column **columns);
 
 monetdbe_export char* monetdbe_load_extension(monetdbe_database dbhdl, const char *file);